@@ -12,6 +12,11 @@ TARGET = CuteSdr
 TEMPLATE = app
 
 SOURCES += gui/main.cpp \
+	bench/rdsbatchmain.cpp \
+	bench/cwbench.cpp \
+	bench/fskbench.cpp \
+	bench/precbench.cpp \
+	bench/streamclient.cpp \
     gui/sounddlg.cpp \
     gui/sdrsetupdlg.cpp \
     gui/sdrdiscoverdlg.cpp \
@@ -39,6 +44,13 @@ SOURCES += gui/main.cpp \
 	interface/dataprocess.cpp \
 	interface/wavefilewriter.cpp \
 	interface/wavefilereader.cpp \
+	interface/audiosink.cpp \
+	interface/audiostreamer.cpp \
+	interface/rdsthread.cpp \
+	interface/rdsbatch.cpp \
+	interface/multipskdemod.cpp \
+	interface/cwskimmerthread.cpp \
+	interface/multifskdemod.cpp \
 	dsp/fractresampler.cpp \
     dsp/fastfir.cpp \
     dsp/downconvert.cpp \
@@ -51,17 +63,27 @@ SOURCES += gui/main.cpp \
 	dsp/smeter.cpp \
     dsp/fmdemod.cpp \
 	dsp/fir.cpp \
+	dsp/polyphasefir.cpp \
+	dsp/audiocodec.cpp \
+	dsp/rdsdecoder.cpp \
     dsp/iir.cpp \
 	dsp/noiseproc.cpp \
+	dsp/noisereduce.cpp \
+	dsp/autonotch.cpp \
+	dsp/scratcharena.cpp \
     dsp/wfmdemod.cpp \
 	dsp/wfmmod.cpp \
     dsp/pskmod.cpp \
     dsp/pskdemod.cpp \
+	dsp/multipsk.cpp \
+	dsp/cwskimmer.cpp \
+	dsp/multifsk.cpp \
     dsp/fskmod.cpp \
     dsp/fskdemod.cpp \
     dsp/datamodifier.cpp
 
 HEADERS  += gui/mainwindow.h \
+	bench/bench.h \
 	gui/sounddlg.h \
     gui/sdrsetupdlg.h \
     gui/sdrdiscoverdlg.h \
@@ -88,6 +110,15 @@ HEADERS  += gui/mainwindow.h \
 	interface/ascpmsg.h \
 	interface/perform.h \
 	interface/threadwrapper.h \
+	interface/spscring.h \
+	interface/audiosink.h \
+	interface/audiostreamer.h \
+	interface/rdsthread.h \
+	interface/rdsbatch.h \
+	interface/multipskdemod.h \
+	interface/cwskimmerthread.h \
+	interface/multifskdemod.h \
+	interface/mpscqueue.h \
 	interface/dataprocess.h \
 	interface/wavefilewriter.h \
 	interface/wavefilereader.h \
@@ -105,12 +136,23 @@ HEADERS  += gui/mainwindow.h \
 	dsp/smeter.h \
     dsp/fmdemod.h \
 	dsp/fir.h \
+	dsp/polyphasefir.h \
+	dsp/audiocodec.h \
+	dsp/rdsdecoder.h \
+	dsp/simdops.h \
     dsp/iir.h \
 	dsp/noiseproc.h \
+	dsp/noisereduce.h \
+	dsp/autonotch.h \
+	dsp/paramsnapshot.h \
+	dsp/scratcharena.h \
     dsp/wfmdemod.h \
 	dsp/wfmmod.h \
 	dsp/pskmod.h \
 	dsp/pskdemod.h \
+	dsp/multipsk.h \
+	dsp/cwskimmer.h \
+	dsp/multifsk.h \
 	dsp/psktables.h \
     dsp/rbdsconstants.h \
     dsp/fskmod.h \
@@ -0,0 +1,237 @@
+/////////////////////////////////////////////////////////////////////
+// cwbench.cpp: command line CW skimmer benchmark.
+//
+// History:
+//	2026-10-18  Moved out of main.cpp
+/////////////////////////////////////////////////////////////////////
+//==========================================================================================
+// + + +   This Software is released under the "Simplified BSD License"  + + +
+//Copyright 2010 Moe Wheatley. All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification, are
+//permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice, this list of
+//	  conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice, this list
+//	  of conditions and the following disclaimer in the documentation and/or other materials
+//	  provided with the distribution.
+//
+//THIS SOFTWARE IS PROVIDED BY Moe Wheatley ``AS IS'' AND ANY EXPRESS OR IMPLIED
+//WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+//FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Moe Wheatley OR
+//CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+//ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+//ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//The views and conclusions contained in the software and documentation are those of the
+//authors and should not be interpreted as representing official policies, either expressed
+//or implied, of Moe Wheatley.
+//==========================================================================================
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include "bench/bench.h"
+#include "dsp/cwskimmer.h"
+
+//keyed carrier that repeats a line of Morse for the CW benchmark
+class CCwKeyer
+{
+public:
+	void Init(const char* pText, TYPEREAL Wpm, TYPEREAL Freq, TYPEREAL Amp, TYPEREAL SampleRate)
+	{	//build on/off string with one entry per dot time
+		m_Bits[0] = 0;
+		for(const char* p=pText; *p; p++)
+		{
+			const char* pCode = CCwDecoder::GetMorse(*p);
+			if(!pCode)
+			{
+				strcat(m_Bits, "0000");	//plus char gap makes a 7 dot word gap
+				continue;
+			}
+			for( ; *pCode; pCode++)
+				strcat(m_Bits, ('.' == *pCode) ? "10" : "1110");
+			strcat(m_Bits, "00");
+		}
+		m_NumBits = strlen(m_Bits);
+		m_UnitLen = 1.2*SampleRate/Wpm;
+		m_Pos = 0;
+		m_Amp = Amp;
+		m_Env = 0.0;
+		m_EnvK = 1.0/(0.002*SampleRate);	//2mSec rise and fall so there are no key clicks
+		m_Step.re = cos(K_2PI*Freq/SampleRate);
+		m_Step.im = sin(K_2PI*Freq/SampleRate);
+		m_Osc.re = 1.0;
+		m_Osc.im = 0.0;
+	}
+	void AddData(int Length, TYPECPX* pData)
+	{
+		for(int i=0; i<Length; i++)
+		{
+			TYPEREAL key = ('1' == m_Bits[(int)(m_Pos++/m_UnitLen) % m_NumBits]) ? m_Amp : 0.0;
+			m_Env += m_EnvK*(key - m_Env);
+			pData[i].re += m_Env*m_Osc.re;
+			pData[i].im += m_Env*m_Osc.im;
+			TYPEREAL tmp = m_Osc.re*m_Step.re - m_Osc.im*m_Step.im;
+			m_Osc.im = m_Osc.re*m_Step.im + m_Osc.im*m_Step.re;
+			m_Osc.re = tmp;
+		}
+		TYPEREAL gain = 1.5 - 0.5*(m_Osc.re*m_Osc.re + m_Osc.im*m_Osc.im);
+		m_Osc.re *= gain;
+		m_Osc.im *= gain;
+	}
+private:
+	char m_Bits[1024];
+	int m_NumBits;
+	qint64 m_Pos;
+	TYPEREAL m_UnitLen;
+	TYPEREAL m_Amp;
+	TYPEREAL m_Env;
+	TYPEREAL m_EnvK;
+	TYPECPX m_Osc;
+	TYPECPX m_Step;
+};
+
+//command line CW skimmer benchmark on synthetic keyed carriers:
+//	CuteSdr -cwbench [samplerate] [carriers] [seconds]
+//Times the channelizer and CWSK_MAX_CHANNELS decoders on one core and
+//prints the spots so the decode can be checked.
+int CwBenchMain(int argc, char *argv[])
+{
+	QCoreApplication a(argc, argv);
+	TYPEREAL SampleRate = (argc > 2) ? atof(argv[2]) : 192000.0;
+	int NumCarriers = (argc > 3) ? atoi(argv[3]) : 32;
+	TYPEREAL Seconds = (argc > 4) ? atof(argv[4]) : 10.0;
+	if( (SampleRate < 8000.0) || (NumCarriers < 1) || (Seconds < 2.0) )
+	{
+		fprintf(stderr, "usage: CuteSdr -cwbench [samplerate] [carriers] [seconds]\n");
+		return 1;
+	}
+	if(NumCarriers > CWSK_MAX_CHANNELS)
+		NumCarriers = CWSK_MAX_CHANNELS;
+	static CCwChannelizer Channelizer;
+	static CCwCarrierDetect Detect;
+	static CCwDecoder Decoders[CWSK_MAX_CHANNELS];
+	static CCwKeyer Keyers[CWSK_MAX_CHANNELS];
+	static TYPEREAL Frames[16][CWSK_MAX_CHANNELS];
+	static TYPEREAL Power[16];
+	static char Calls[CWSK_MAX_CHANNELS][16];
+	static int ChanBin[CWSK_MAX_CHANNELS];
+	static TYPEREAL Carriers[CWSK_MAX_CHANNELS];
+	quint8 Chars[16];
+
+	Channelizer.Init(SampleRate);
+	TYPEREAL FrameRate = Channelizer.GetFrameRate();
+	Detect.Init(Channelizer.GetFirstBin(), Channelizer.GetLastBin(), FrameRate,
+				Channelizer.GetBinWidth());
+	//spread the carriers over the searched band at 15 to 39 WPM
+	TYPEREAL Span = SampleRate*CWSK_USABLE_BW*0.9;
+	for(int i=0; i<NumCarriers; i++)
+	{
+		char Text[64];
+		sprintf(Calls[i], "K%dA%c%c", i%10, 'A' + (i/10)%26, 'A' + (i*7)%26);
+		sprintf(Text, "CQ CQ DE %s %s K   ", Calls[i], Calls[i]);
+		Keyers[i].Init(Text, 15 + (i*5)%25, -Span/2.0 + Span*(i + 0.5)/NumCarriers,
+						0.02*(1 + i%3), SampleRate);
+	}
+	for(int c=0; c<CWSK_MAX_CHANNELS; c++)
+		Decoders[c].Init(FrameRate);
+
+	int hop = Channelizer.GetHopSize();
+	TYPECPX* pBuf = new TYPECPX[hop];
+	int NumFrames = (int)(Seconds*FrameRate);
+	int NumChans = 0;
+	int Block = 0;
+	int NumSpots = 0;
+	int NumGood = 0;
+	qint64 ChanTime = 0;
+	qint64 DecTime = 0;
+	char Words[CWSK_MAX_CHANNELS][CWSK_MAX_WORD+1];
+	int WordLen[CWSK_MAX_CHANNELS];
+	QElapsedTimer Timer;
+	srand(1);
+	for(int f=0; f<NumFrames; f++)
+	{
+		for(int i=0; i<hop; i++)
+		{	//white noise
+			pBuf[i].re = 0.002*(rand()/(TYPEREAL)RAND_MAX - 0.5);
+			pBuf[i].im = 0.002*(rand()/(TYPEREAL)RAND_MAX - 0.5);
+		}
+		for(int i=0; i<NumCarriers; i++)
+			Keyers[i].AddData(hop, pBuf);
+
+		Timer.start();
+		const TYPEREAL* pPower = Channelizer.ProcessFrame(pBuf);
+		if( Detect.ProcessFrame(pPower) && (0 == NumChans) )
+		{	//use the first carrier list and repeat it over every channel
+			int n = Detect.GetCarriers(Carriers, CWSK_MAX_CHANNELS);
+			for(int c=0; (c<CWSK_MAX_CHANNELS) && (n>0); c++)
+			{
+				ChanBin[c] = (int)(Carriers[c%n] + 0.5);
+				WordLen[c] = 0;
+			}
+			NumChans = (n > 0) ? CWSK_MAX_CHANNELS : 0;
+			printf("Carriers found: %d of %d\n", n, NumCarriers);
+		}
+		for(int c=0; c<NumChans; c++)
+			Frames[Block][c] = pPower[ChanBin[c]];
+		ChanTime += Timer.nsecsElapsed();
+		if( (0 == NumChans) || (++Block < 16) )
+			continue;
+
+		Block = 0;
+		for(int c=0; c<NumChans; c++)
+		{
+			Timer.start();
+			for(int i=0; i<16; i++)
+				Power[i] = Frames[i][c];
+			int n = Decoders[c].ProcessData(16, Power, Chars);
+			DecTime += Timer.nsecsElapsed();
+			for(int i=0; i<n; i++)
+			{
+				if(' ' != Chars[i])
+				{
+					if(WordLen[c] < CWSK_MAX_WORD)
+						Words[c][WordLen[c]++] = Chars[i];
+					continue;
+				}
+				Words[c][WordLen[c]] = 0;
+				WordLen[c] = 0;
+				//only print the first set of channels, the rest are copies
+				if( (c >= NumCarriers) || !CCwDecoder::IsCallSign(Words[c]) )
+					continue;
+				NumSpots++;
+				for(int k=0; k<NumCarriers; k++)
+				{
+					if(0 == strcmp(Calls[k], Words[c]))
+						NumGood++;
+				}
+				printf("%10.1f Hz  %-10s %2d WPM\n",
+						Channelizer.GetBinFreq(ChanBin[c]), Words[c], Decoders[c].GetWpm());
+			}
+		}
+	}
+	delete [] pBuf;
+	TYPEREAL ChanSec = ChanTime*1e-9;
+	TYPEREAL DecSec = DecTime*1e-9;
+	printf("Spots: %d(%d correct calls)\n", NumSpots, NumGood);
+	printf("Channelizer: %d point FFT, %.1f Hz channels, %.1f frames/Sec\n",
+			Channelizer.GetFftSize(), Channelizer.GetBinWidth(), FrameRate);
+	printf("  %.3f Sec CPU for %.1f Sec of I/Q at %.0f sps = %.1f%% of one core\n",
+			ChanSec, Seconds, SampleRate, 100.0*ChanSec/Seconds);
+	if(NumChans > 0)
+	{
+		TYPEREAL DecSeconds = Seconds - CWSK_DETECT_TIME;
+		printf("Decoders: %d channels\n", NumChans);
+		printf("  %.3f Sec CPU for %.1f Sec = %.0f channels per core\n",
+				DecSec, DecSeconds, (DecSec > 0.0) ? NumChans*DecSeconds/DecSec : 0.0);
+	}
+	return 0;
+}
@@ -0,0 +1,180 @@
+/////////////////////////////////////////////////////////////////////
+// fskbench.cpp: command line multi-channel DSC benchmark.
+//
+// History:
+//	2026-10-18  Moved out of main.cpp
+/////////////////////////////////////////////////////////////////////
+//==========================================================================================
+// + + +   This Software is released under the "Simplified BSD License"  + + +
+//Copyright 2010 Moe Wheatley. All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification, are
+//permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice, this list of
+//	  conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice, this list
+//	  of conditions and the following disclaimer in the documentation and/or other materials
+//	  provided with the distribution.
+//
+//THIS SOFTWARE IS PROVIDED BY Moe Wheatley ``AS IS'' AND ANY EXPRESS OR IMPLIED
+//WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+//FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Moe Wheatley OR
+//CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+//ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+//ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//The views and conclusions contained in the software and documentation are those of the
+//authors and should not be interpreted as representing official policies, either expressed
+//or implied, of Moe Wheatley.
+//==========================================================================================
+#include <stdio.h>
+#include <stdlib.h>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include "bench/bench.h"
+#include "dsp/multifsk.h"
+#include "dsp/fskmod.h"
+
+//command line multi-channel DSC benchmark on synthetic CFskMod signals:
+//	CuteSdr -fskbench [samplerate] [signals] [seconds]
+//Runs the pair search and starts a correlator and DSC decoder channel on
+//each new pair. The rest of the MFSK_MAX_CHANNELS channels repeat them to
+//load one core and only the channels found print their messages.
+int FskBenchMain(int argc, char *argv[])
+{
+	QCoreApplication a(argc, argv);
+	TYPEREAL SampleRate = (argc > 2) ? atof(argv[2]) : 12000.0;
+	int NumSignals = (argc > 3) ? atoi(argv[3]) : 6;
+	TYPEREAL Seconds = (argc > 4) ? atof(argv[4]) : 40.0;
+	int MaxSignals = (int)((MFSK_HICUT - MFSK_LOWCUT - 200.0)/400.0);
+	if( (SampleRate < 2.0*MFSK_HICUT) || (SampleRate > 100.0*FSK_MAX_INTEGRATOR) ||
+		(NumSignals < 1) || (Seconds < 2.0) )
+	{
+		fprintf(stderr, "usage: CuteSdr -fskbench [samplerate] [signals] [seconds]\n");
+		return 1;
+	}
+	if(NumSignals > MaxSignals)
+		NumSignals = MaxSignals;
+	static CFskMod Mods[MFSK_MAX_CHANNELS];
+	static tFSK_CORR Corr[MFSK_MAX_CHANNELS];
+	static tDSC_DECODE Dsc[MFSK_MAX_CHANNELS];
+	static tFSK_BLOCK Block;
+	static CFskPairDetect Detect;
+	TYPEREAL Pairs[MFSK_MAX_CHANNELS];
+	TYPEREAL ChanFreq[MFSK_MAX_CHANNELS];
+	TYPECPX Buf[FSK_BLOCK];
+	TYPECPX Sig[FSK_BLOCK];
+	quint8 Bits[FSK_BLOCK];
+	char Msg[FSK_MAX_MSG*4+32];
+
+	//signals every 400Hz from 400Hz above the bottom of the passband
+	for(int i=0; i<NumSignals; i++)
+		Mods[i].SetSampleRate(SampleRate, MFSK_LOWCUT + 400.0*(i+1));
+	Detect.Init(SampleRate);
+	CFskDemod::InitBlock(&Block, SampleRate);
+
+	int NumBlocks = (int)(Seconds*SampleRate/FSK_BLOCK);
+	int NumChans = 0;
+	int NumFound = 0;
+	int NumValid = 0;
+	int NumBad = 0;
+	qint64 DetTime = 0;
+	qint64 DecTime = 0;
+	qint64 DecSamples = 0;
+	QElapsedTimer Timer;
+	srand(1);
+	for(int b=0; b<NumBlocks; b++)
+	{
+		for(int i=0; i<FSK_BLOCK; i++)
+		{	//white noise
+			Buf[i].re = 0.5*(rand()/(TYPEREAL)RAND_MAX - 0.5);
+			Buf[i].im = 0.5*(rand()/(TYPEREAL)RAND_MAX - 0.5);
+		}
+		for(int s=0; s<NumSignals; s++)
+		{
+			Mods[s].GenerateData(FSK_BLOCK, 0.1*(2 + s%3), Sig);
+			for(int i=0; i<FSK_BLOCK; i++)
+			{
+				Buf[i].re += Sig[i].re;
+				Buf[i].im += Sig[i].im;
+			}
+		}
+
+		Timer.start();
+		if( Detect.ProcessData(FSK_BLOCK, Buf) && (NumFound < NumSignals) )
+		{	//start a channel on every new pair
+			int n = Detect.GetPairs(Pairs, MFSK_MAX_CHANNELS);
+			int LastFound = NumFound;
+			for(int p=0; (p<n) && (NumFound<MFSK_MAX_CHANNELS); p++)
+			{
+				bool New = true;
+				for(int c=0; c<NumFound; c++)
+				{
+					if( MFABS(ChanFreq[c] - Pairs[p]) < FSK_SHIFT_FREQ/2.0 )
+						New = false;
+				}
+				if(!New)
+					continue;
+				printf("Pair found at %7.1f Hz at %.1f Sec\n", Pairs[p], b*FSK_BLOCK/SampleRate);
+				ChanFreq[NumFound] = Pairs[p];
+				CFskDemod::InitCorrelator(&Corr[NumFound], SampleRate, Pairs[p]);
+				CFskDemod::InitDecoder(&Dsc[NumFound]);
+				NumFound++;
+			}
+			//the remaining channels repeat the ones found
+			for(int c=NumFound; (c<MFSK_MAX_CHANNELS) && (NumFound>LastFound); c++)
+			{
+				ChanFreq[c] = ChanFreq[c%NumFound];
+				CFskDemod::InitCorrelator(&Corr[c], SampleRate, ChanFreq[c]);
+				CFskDemod::InitDecoder(&Dsc[c]);
+			}
+			if(NumFound > 0)
+				NumChans = MFSK_MAX_CHANNELS;
+		}
+		DetTime += Timer.nsecsElapsed();
+		if(0 == NumChans)
+			continue;
+
+		Timer.start();
+		CFskDemod::StartBlock(&Block, FSK_BLOCK);
+		for(int c=0; c<NumChans; c++)
+		{
+			int NumBits = CFskDemod::Correlate(&Corr[c], &Block, FSK_BLOCK, Buf, Bits);
+			for(int i=0; i<NumBits; i++)
+			{
+				int Status = CFskDemod::DecodeBit(&Dsc[c], Bits[i]);
+				if(FSK_MSG_NONE == Status)
+					continue;
+				CFskDemod::ResetBitSync(&Corr[c]);
+				if(c >= NumFound)
+					continue;	//only print the channels found, the rest are copies
+				if(FSK_MSG_VALID == Status)
+					NumValid++;
+				else
+					NumBad++;
+				CFskDemod::FormatMsg(&Dsc[c], Status, Msg);
+				printf("%6.1f Sec %7.1f Hz  %s\n", b*FSK_BLOCK/SampleRate, ChanFreq[c], Msg);
+			}
+		}
+		DecTime += Timer.nsecsElapsed();
+		DecSamples += FSK_BLOCK;
+	}
+	TYPEREAL DetSec = DetTime*1e-9;
+	TYPEREAL DecSec = DecTime*1e-9;
+	printf("Messages: %d valid, %d bad\n", NumValid, NumBad);
+	printf("Pair search: %.3f Sec CPU for %.1f Sec at %.0f sps = %.2f%% of one core\n",
+			DetSec, Seconds, SampleRate, 100.0*DetSec/Seconds);
+	if(NumChans > 0)
+	{
+		TYPEREAL DecSeconds = DecSamples/SampleRate;
+		printf("Decoders: %d channels\n", NumChans);
+		printf("  %.3f Sec CPU for %.1f Sec = %.0f channels per core\n",
+				DecSec, DecSeconds, (DecSec > 0.0) ? NumChans*DecSeconds/DecSec : 0.0);
+	}
+	return 0;
+}
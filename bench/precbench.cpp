@@ -0,0 +1,376 @@
+/////////////////////////////////////////////////////////////////////
+// precbench.cpp: command line float against double benchmark.
+//
+// History:
+//	2026-10-18  Moved out of main.cpp
+//	2026-10-18  Added float against double run of the full receive chain
+/////////////////////////////////////////////////////////////////////
+//==========================================================================================
+// + + +   This Software is released under the "Simplified BSD License"  + + +
+//Copyright 2010 Moe Wheatley. All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification, are
+//permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice, this list of
+//	  conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice, this list
+//	  of conditions and the following disclaimer in the documentation and/or other materials
+//	  provided with the distribution.
+//
+//THIS SOFTWARE IS PROVIDED BY Moe Wheatley ``AS IS'' AND ANY EXPRESS OR IMPLIED
+//WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+//FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Moe Wheatley OR
+//CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+//ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+//ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//The views and conclusions contained in the software and documentation are those of the
+//authors and should not be interpreted as representing official policies, either expressed
+//or implied, of Moe Wheatley.
+//==========================================================================================
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include "bench/bench.h"
+#include "dsp/fir.h"
+#include "dsp/iir.h"
+#include "dsp/downconvert.h"
+#include "dsp/fastfir.h"
+#include "dsp/agc.h"
+#include "dsp/fractresampler.h"
+
+#define PRECBENCH_BLOCK 4096
+
+#define CHAIN_BLOCK 16384			//I/Q samples per block into the receive chain
+#define CHAIN_BUFSIZE (4*CHAIN_BLOCK)	//room for each stage's output
+#define CHAIN_STAGES 4
+#define CHAIN_INRATE 1000000.0
+#define CHAIN_TUNE 100000.0			//tuning frequency of the test signal
+#define CHAIN_TONE 1000.0			//tone offset from CHAIN_TUNE
+#define CHAIN_BW 10000.0			//down converter alias free bandwidth
+#define CHAIN_AUDIORATE 48000.0
+#define CHAIN_AMPLITUDE 1000.0
+#define CHAIN_NOISE 100.0
+
+//runs Blocks copies of pIn through a complex low pass FIR and a real
+//low pass biquad of precision T. Returns the ns per sample of each in
+//pNs[0] and pNs[1] and leaves the last filtered block in pFirOut and pIirOut.
+template <typename T>
+static void PrecBenchRun(int Taps, int Blocks, const tDComplex* pIn,
+						 tDComplex* pFirOut, tDReal* pIirOut, TYPEREAL* pNs)
+{
+	typedef typename tPrecision<T>::Cpx Cpx;
+	static Cpx CpxBuf[PRECBENCH_BLOCK];
+	static T RealBuf[PRECBENCH_BLOCK];
+	static CFirT<T> Fir;
+	CIirT<T> Iir;
+	Fir.InitLPFilter(Taps, 1.0, 80.0, 0.1, 0.15, 1.0);
+	Iir.InitLP(0.0005, 0.707, 1.0);		//low corner where float coefficients lose accuracy
+	QElapsedTimer Timer;
+	qint64 FirTime = 0;
+	qint64 IirTime = 0;
+	for(int b=0; b<Blocks; b++)
+	{
+		for(int i=0; i<PRECBENCH_BLOCK; i++)
+		{
+			CpxBuf[i].re = pIn[i].re;
+			CpxBuf[i].im = pIn[i].im;
+			RealBuf[i] = pIn[i].re;
+		}
+		Timer.start();
+		Fir.ProcessFilter(PRECBENCH_BLOCK, CpxBuf, CpxBuf);
+		FirTime += Timer.nsecsElapsed();
+		Timer.start();
+		Iir.ProcessFilter(PRECBENCH_BLOCK, RealBuf, RealBuf);
+		IirTime += Timer.nsecsElapsed();
+	}
+	for(int i=0; i<PRECBENCH_BLOCK; i++)
+	{
+		pFirOut[i].re = CpxBuf[i].re;
+		pFirOut[i].im = CpxBuf[i].im;
+		pIirOut[i] = RealBuf[i];
+	}
+	pNs[0] = (TYPEREAL)FirTime/((TYPEREAL)Blocks*PRECBENCH_BLOCK);
+	pNs[1] = (TYPEREAL)IirTime/((TYPEREAL)Blocks*PRECBENCH_BLOCK);
+}
+
+static const char* CHAIN_NAMES[CHAIN_STAGES] =
+{
+	"Down converter",
+	"Fast FIR",
+	"AGC",
+	"Resampler"
+};
+
+//the receive chain the demodulators use, CDownConvert then CFastFIR then CAgc
+//then CFractResampler, all of precision T. Process() keeps every stage's
+//output so the float and double chains can be compared stage by stage.
+template <typename T>
+class CPrecBenchChain
+{
+public:
+	typedef typename tPrecision<T>::Cpx Cpx;
+	T Init()
+	{
+		m_OutRate = m_DownConvert.SetDataRate(CHAIN_INRATE, CHAIN_BW);
+		m_DownConvert.SetFrequency(-CHAIN_TUNE);	//shift the test signal down to baseband
+		m_Filter.SetupParameters(100.0, 2800.0, 0.0, m_OutRate);
+		m_Agc.SetParameters(true, false, -100, 30, 0, 200, m_OutRate);
+		m_Resampler.Init(CHAIN_BUFSIZE);
+		for(int s=0; s<CHAIN_STAGES; s++)
+			m_Ns[s] = 0;
+		return m_OutRate;
+	}
+	void Process(const tDComplex* pIn)
+	{
+		QElapsedTimer Timer;
+		for(int i=0; i<CHAIN_BLOCK; i++)
+		{
+			m_In[i].re = pIn[i].re;
+			m_In[i].im = pIn[i].im;
+		}
+		Timer.start();
+		m_Length[0] = m_DownConvert.ProcessData(CHAIN_BLOCK, m_In, m_Out[0]);
+		m_Ns[0] += Timer.nsecsElapsed();
+		Timer.start();
+		m_Length[1] = m_Filter.ProcessData(m_Length[0], m_Out[0], m_Out[1]);
+		m_Ns[1] += Timer.nsecsElapsed();
+		Timer.start();
+		m_Agc.ProcessData(m_Length[1], m_Out[1], m_Out[2]);
+		m_Length[2] = m_Length[1];
+		m_Ns[2] += Timer.nsecsElapsed();
+		Timer.start();
+		m_Length[3] = m_Resampler.Resample(m_Length[2], m_OutRate/CHAIN_AUDIORATE, m_Out[2], m_Out[3]);
+		m_Ns[3] += Timer.nsecsElapsed();
+	}
+	T m_OutRate;
+	qint64 m_Ns[CHAIN_STAGES];
+	int m_Length[CHAIN_STAGES];
+	Cpx m_Out[CHAIN_STAGES][CHAIN_BUFSIZE];
+private:
+	Cpx m_In[CHAIN_BLOCK];
+	CDownConvertT<T> m_DownConvert;
+	CFastFIRT<T> m_Filter;
+	CAgcT<T> m_Agc;
+	CFractResamplerT<T> m_Resampler;
+};
+
+//lines up a float and a double output stream by sample index and sums the
+//error and signal power. A stage may return a different number of samples
+//per block in float than in double (the resampler's time accumulator drifts)
+//so the surplus of the longer stream is held until the other catches up.
+//Also tracks the phase of the float stream against the double one so a
+//frequency offset (the float NCO's rounded phase step) can be told apart
+//from noise, as its error grows with the run length.
+class CPrecBenchCompare
+{
+public:
+	CPrecBenchCompare() : m_FloatLength(0), m_DoubleLength(0), m_Drift(0),
+		m_Compared(0), m_FirstLength(0), m_Err(1e-300), m_Pwr(1e-300), m_Phase(0.0), m_LastPhase(0.0) {}
+	template <typename F, typename D>
+	void Add(const F* pFloat, int FloatLength, const D* pDouble, int DoubleLength)
+	{
+		for(int i=0; i<FloatLength; i++)
+		{
+			m_Float[m_FloatLength + i].re = pFloat[i].re;
+			m_Float[m_FloatLength + i].im = pFloat[i].im;
+		}
+		for(int i=0; i<DoubleLength; i++)
+		{
+			m_Double[m_DoubleLength + i].re = pDouble[i].re;
+			m_Double[m_DoubleLength + i].im = pDouble[i].im;
+		}
+		m_FloatLength += FloatLength;
+		m_DoubleLength += DoubleLength;
+		m_Drift += FloatLength - DoubleLength;
+		int n = (m_FloatLength < m_DoubleLength) ? m_FloatLength : m_DoubleLength;
+		tDComplex Cross = {0.0, 0.0};
+		for(int i=0; i<n; i++)
+		{
+			tDReal dre = m_Float[i].re - m_Double[i].re;
+			tDReal dim = m_Float[i].im - m_Double[i].im;
+			m_Err += dre*dre + dim*dim;
+			m_Pwr += m_Double[i].re*m_Double[i].re + m_Double[i].im*m_Double[i].im;
+			Cross.re += m_Float[i].re*m_Double[i].re + m_Float[i].im*m_Double[i].im;
+			Cross.im += m_Float[i].im*m_Double[i].re - m_Float[i].re*m_Double[i].im;
+		}
+		if(n > 0)
+		{	//unwrap the block to block phase change
+			tDReal Phase = atan2(Cross.im, Cross.re);
+			tDReal dPhase = Phase - m_LastPhase;
+			if(dPhase > K_PI)
+				dPhase -= K_2PI;
+			else if(dPhase < -K_PI)
+				dPhase += K_2PI;
+			if(m_Compared > 0)
+				m_Phase += dPhase;
+			else
+				m_FirstLength = n;
+			m_LastPhase = Phase;
+			m_Compared += n;
+		}
+		m_FloatLength -= n;
+		m_DoubleLength -= n;
+		memmove(m_Float, &m_Float[n], m_FloatLength*sizeof(tDComplex));
+		memmove(m_Double, &m_Double[n], m_DoubleLength*sizeof(tDComplex));
+	}
+	//true if one stream has run too far ahead to hold another block
+	bool Overrun() const
+	{
+		return (m_FloatLength > CHAIN_BUFSIZE) || (m_DoubleLength > CHAIN_BUFSIZE);
+	}
+	tDReal ErrordB() const {return 10.0*log10(m_Err/m_Pwr);}
+	int Drift() const {return m_Drift;}
+	//frequency of the float stream against the double one at sample rate Rate
+	tDReal OffsetHz(tDReal Rate) const
+	{
+		if(m_Compared <= m_FirstLength)
+			return 0.0;
+		return m_Phase*Rate/(K_2PI*(m_Compared - m_FirstLength));
+	}
+private:
+	int m_FloatLength;
+	int m_DoubleLength;
+	int m_Drift;
+	int m_Compared;
+	int m_FirstLength;
+	tDReal m_Err;
+	tDReal m_Pwr;
+	tDReal m_Phase;
+	tDReal m_LastPhase;
+	tDComplex m_Float[2*CHAIN_BUFSIZE];
+	tDComplex m_Double[2*CHAIN_BUFSIZE];
+};
+
+//runs Blocks blocks of a tone plus noise through the float and double
+//receive chains and prints each stage's time per input sample and the
+//error of the float output against the double output after that stage.
+//Returns false if the two chains cannot be lined up.
+static bool PrecBenchChain(int Blocks)
+{
+	CPrecBenchChain<tSReal>* pFloat = new CPrecBenchChain<tSReal>;
+	CPrecBenchChain<tDReal>* pDouble = new CPrecBenchChain<tDReal>;
+	CPrecBenchCompare* pCompare = new CPrecBenchCompare[CHAIN_STAGES];
+	static tDComplex In[CHAIN_BLOCK];
+	bool Ok = true;
+	tSReal FloatRate = pFloat->Init();
+	tDReal DoubleRate = pDouble->Init();
+	if(FloatRate != DoubleRate)
+	{
+		fprintf(stderr, "float chain rate %g does not match double chain rate %g\n", FloatRate, DoubleRate);
+		Ok = false;
+	}
+	tDReal Phase = 0.0;
+	tDReal PhaseInc = K_2PI*(CHAIN_TUNE + CHAIN_TONE)/CHAIN_INRATE;
+	srand(1);
+	for(int b=0; Ok && (b<Blocks); b++)
+	{
+		for(int i=0; i<CHAIN_BLOCK; i++)
+		{
+			In[i].re = CHAIN_AMPLITUDE*cos(Phase) + CHAIN_NOISE*(rand()/(tDReal)RAND_MAX - 0.5);
+			In[i].im = CHAIN_AMPLITUDE*sin(Phase) + CHAIN_NOISE*(rand()/(tDReal)RAND_MAX - 0.5);
+			Phase = fmod(Phase + PhaseInc, K_2PI);
+		}
+		pFloat->Process(In);
+		pDouble->Process(In);
+		for(int s=0; s<CHAIN_STAGES; s++)
+		{
+			pCompare[s].Add(pFloat->m_Out[s], pFloat->m_Length[s], pDouble->m_Out[s], pDouble->m_Length[s]);
+			if(pCompare[s].Overrun())
+			{
+				fprintf(stderr, "%s float and double outputs drifted %d samples apart\n",
+						CHAIN_NAMES[s], pCompare[s].Drift());
+				Ok = false;
+			}
+		}
+	}
+	if(Ok)
+	{
+		tDReal Samples = (tDReal)Blocks*CHAIN_BLOCK;
+		tDReal FloatTotal = 0.0;
+		tDReal DoubleTotal = 0.0;
+		printf("Receive chain %.0f sps in, %.0f sps decimated, %.0f sps out, %d blocks of %d samples\n",
+				CHAIN_INRATE, DoubleRate, CHAIN_AUDIORATE, Blocks, CHAIN_BLOCK);
+		for(int s=0; s<CHAIN_STAGES; s++)
+		{
+			FloatTotal += pFloat->m_Ns[s];
+			DoubleTotal += pDouble->m_Ns[s];
+			tDReal Rate = (s == (CHAIN_STAGES-1)) ? CHAIN_AUDIORATE : DoubleRate;
+			printf("  %-15s float %6.2f ns/sample  double %6.2f ns/sample  float error %6.1f dB  offset %8.1e Hz",
+					CHAIN_NAMES[s], pFloat->m_Ns[s]/Samples, pDouble->m_Ns[s]/Samples,
+					pCompare[s].ErrordB(), pCompare[s].OffsetHz(Rate));
+			if(pCompare[s].Drift())
+				printf("  drift %d samples", pCompare[s].Drift());
+			printf("\n");
+		}
+		printf("  %-15s float %6.2f ns/sample  double %6.2f ns/sample\n",
+				"Total", FloatTotal/Samples, DoubleTotal/Samples);
+	}
+	delete pFloat;
+	delete pDouble;
+	delete [] pCompare;
+	return Ok;
+}
+
+//returns the power of pA-pB relative to pB in dB
+static TYPEREAL PrecBenchError(const tDReal* pA, const tDReal* pB, int Length)
+{
+	tDReal Err = 1e-300;
+	tDReal Pwr = 1e-300;
+	for(int i=0; i<Length; i++)
+	{
+		Err += (pA[i]-pB[i])*(pA[i]-pB[i]);
+		Pwr += pB[i]*pB[i];
+	}
+	return 10.0*log10(Err/Pwr);
+}
+
+//command line float against double benchmark of the templated filters:
+//	CuteSdr -precbench [taps] [blocks]
+//Filters the same white noise with the float and double versions of CFirT
+//and CIirT and prints the time per sample and the float error. Then runs
+//the same number of input samples through the float and double receive
+//chains. Returns non zero if the two chains do not line up.
+int PrecBenchMain(int argc, char *argv[])
+{
+	QCoreApplication a(argc, argv);
+	int Taps = (argc > 2) ? atoi(argv[2]) : 63;
+	int Blocks = (argc > 3) ? atoi(argv[3]) : 500;
+	if( (Taps < 3) || (Taps > MAX_NUMCOEF) || (Blocks < 1) )
+	{
+		fprintf(stderr, "usage: CuteSdr -precbench [taps(3-%d)] [blocks]\n", MAX_NUMCOEF);
+		return 1;
+	}
+	static tDComplex In[PRECBENCH_BLOCK];
+	static tDComplex FirOut[2][PRECBENCH_BLOCK];
+	static tDReal IirOut[2][PRECBENCH_BLOCK];
+	TYPEREAL FloatNs[2];
+	TYPEREAL DoubleNs[2];
+	srand(1);
+	for(int i=0; i<PRECBENCH_BLOCK; i++)
+	{	//white noise
+		In[i].re = rand()/(tDReal)RAND_MAX - 0.5;
+		In[i].im = rand()/(tDReal)RAND_MAX - 0.5;
+	}
+	PrecBenchRun<tSReal>(Taps, Blocks, In, FirOut[0], IirOut[0], FloatNs);
+	PrecBenchRun<tDReal>(Taps, Blocks, In, FirOut[1], IirOut[1], DoubleNs);
+	TYPEREAL FirErr = PrecBenchError((tDReal*)FirOut[0], (tDReal*)FirOut[1], 2*PRECBENCH_BLOCK);
+	TYPEREAL IirErr = PrecBenchError(IirOut[0], IirOut[1], PRECBENCH_BLOCK);
+	printf("%d blocks of %d samples\n", Blocks, PRECBENCH_BLOCK);
+	printf("Complex FIR %d taps: float %6.2f ns/sample  double %6.2f ns/sample  float error %6.1f dB\n",
+			Taps, FloatNs[0], DoubleNs[0], FirErr);
+	printf("Real biquad LP:      float %6.2f ns/sample  double %6.2f ns/sample  float error %6.1f dB\n",
+			FloatNs[1], DoubleNs[1], IirErr);
+	int ChainBlocks = (Blocks*PRECBENCH_BLOCK)/CHAIN_BLOCK;
+	if(ChainBlocks < 1)
+		ChainBlocks = 1;
+	return PrecBenchChain(ChainBlocks) ? 0 : 1;
+}
@@ -0,0 +1,71 @@
+/////////////////////////////////////////////////////////////////////
+// rdsbatchmain.cpp: command line batch RDS decoder.
+//
+// History:
+//	2026-10-18  Moved out of main.cpp
+/////////////////////////////////////////////////////////////////////
+//==========================================================================================
+// + + +   This Software is released under the "Simplified BSD License"  + + +
+//Copyright 2010 Moe Wheatley. All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification, are
+//permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice, this list of
+//	  conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice, this list
+//	  of conditions and the following disclaimer in the documentation and/or other materials
+//	  provided with the distribution.
+//
+//THIS SOFTWARE IS PROVIDED BY Moe Wheatley ``AS IS'' AND ANY EXPRESS OR IMPLIED
+//WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+//FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Moe Wheatley OR
+//CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+//ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+//ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//The views and conclusions contained in the software and documentation are those of the
+//authors and should not be interpreted as representing official policies, either expressed
+//or implied, of Moe Wheatley.
+//==========================================================================================
+#include <stdio.h>
+#include <stdlib.h>
+#include <QCoreApplication>
+#include "bench/bench.h"
+#include "interface/rdsbatch.h"
+
+//prints batch decoded RDS groups to stdout
+class CRdsGroupPrinter : public CRdsBatchSink
+{
+public:
+	void PutGroup(const tRDS_BATCH_GROUP& Grp)
+	{
+		printf("%12.6f %12lld  %04X %04X %04X %04X  %2d%c\n",
+				Grp.Time, (long long)Grp.SamplePos,
+				Grp.Group.BlockA, Grp.Group.BlockB, Grp.Group.BlockC, Grp.Group.BlockD,
+				(Grp.Group.BlockB>>12) & 0x0F, (Grp.Group.BlockB & 0x0800) ? 'B' : 'A');
+	}
+};
+
+//command line RDS decode of a WFM I/Q wave file:
+//	CuteSdr -rdsbatch file.wav [threads]
+int RdsBatchMain(int argc, char *argv[])
+{
+	QCoreApplication a(argc, argv);
+	CRdsBatchDecoder Decoder;
+	CRdsGroupPrinter Printer;
+	int NumThreads = (argc > 3) ? atoi(argv[3]) : 0;
+	printf("#     Time(s)       Sample  BlkA BlkB BlkC BlkD  Grp\n");
+	qint64 NumGroups = Decoder.DecodeFile(QString::fromLocal8Bit(argv[2]), &Printer, NumThreads);
+	if(NumGroups < 0)
+	{
+		fprintf(stderr, "Cannot read I/Q wave file %s\n", argv[2]);
+		return 1;
+	}
+	fprintf(stderr, "%lld RDS groups decoded\n", (long long)NumGroups);
+	return 0;
+}
@@ -0,0 +1,340 @@
+/////////////////////////////////////////////////////////////////////
+// streamclient.cpp: loopback client test of the audio stream server.
+//
+//	A CAudioStreamServer is run in this process and fed a tone as if
+// from the DSP thread. One TCP client and one UDP(ASUB subscribe)
+// client receive the frames, check the header and sequence numbers and
+// decode them with CImaAdpcm or MuLawDecode().  The decoded audio is
+// least squares fitted to the source tone, so the SNR includes the
+// server decimator and the codec and does not need the delay lined up.
+// History:
+//	2026-10-18  Initial creation
+//	2026-10-18  Frame headers and subscriptions are little endian on any host
+/////////////////////////////////////////////////////////////////////
+//==========================================================================================
+// + + +   This Software is released under the "Simplified BSD License"  + + +
+//Copyright 2010 Moe Wheatley. All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification, are
+//permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice, this list of
+//	  conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice, this list
+//	  of conditions and the following disclaimer in the documentation and/or other materials
+//	  provided with the distribution.
+//
+//THIS SOFTWARE IS PROVIDED BY Moe Wheatley ``AS IS'' AND ANY EXPRESS OR IMPLIED
+//WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+//FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Moe Wheatley OR
+//CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+//ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+//ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//The views and conclusions contained in the software and documentation are those of the
+//authors and should not be interpreted as representing official policies, either expressed
+//or implied, of Moe Wheatley.
+//==========================================================================================
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QTcpSocket>
+#include <QUdpSocket>
+#include <QThread>
+#include <QtEndian>
+#include "bench/bench.h"
+#include "interface/audiostreamer.h"
+
+#define STREAMCLIENT_PORT 50101
+#define STREAMCLIENT_SRC_RATE 48000		//rate of the stereo tone fed to the server
+#define STREAMCLIENT_TONE 1000.0
+#define STREAMCLIENT_AMPLITUDE 8192.0	//-12 dBFS
+#define STREAMCLIENT_CHUNK 960			//most frames written per Write() call
+#define STREAMCLIENT_POLL_MS 5
+#define STREAMCLIENT_SUBSCRIBE_MS 1000	//UDP subscribe repeat time
+#define STREAMCLIENT_DRAIN_MS 500		//time to keep reading after the tone stops
+#define STREAMCLIENT_SETTLE_FRAMES 10	//frames left out of the SNR while the decimator settles
+#define STREAMCLIENT_MIN_SNR 20.0		//lowest decoded SNR that passes
+
+//copies the little endian header at the start of pFrame to Hdr in host order
+static void GetHeader(const char* pFrame, tAudioStreamHeader& Hdr)
+{
+	memcpy(&Hdr, pFrame, sizeof(Hdr));
+	Hdr.Magic = qFromLittleEndian<quint32>(Hdr.Magic);
+	Hdr.SeqNum = qFromLittleEndian<quint32>(Hdr.SeqNum);
+	Hdr.SampleRate = qFromLittleEndian<quint32>(Hdr.SampleRate);
+	Hdr.NumSamples = qFromLittleEndian<quint16>(Hdr.NumSamples);
+	Hdr.PayloadLength = qFromLittleEndian<quint16>(Hdr.PayloadLength);
+	Hdr.AdpcmPredict = qFromLittleEndian<qint16>(Hdr.AdpcmPredict);
+}
+
+//checks the frames one client receives and fits the decoded audio to
+//the source tone
+class CStreamCheck
+{
+public:
+	CStreamCheck(int Codec, TYPEREAL ToneFreq);
+	void PutFrame(const char* pFrame, int Length);
+	//prints the results and returns true if every frame arrived in order
+	// and the SNR is at least STREAMCLIENT_MIN_SNR
+	bool Report(const char* pName);
+
+private:
+	int m_Codec;
+	TYPEREAL m_ToneFreq;
+	int m_Rate;
+	quint32 m_FirstSeq;
+	quint32 m_NextSeq;
+	qint64 m_Frames;
+	qint64 m_LostFrames;
+	qint64 m_OldFrames;		//repeated or out of order
+	qint64 m_BadFrames;		//bad header or length
+	CImaAdpcm m_Adpcm;
+	qint16 m_Audio[STREAM_MAX_FRAME_SAMPLES];
+	//least squares sums for x = a*sin() + b*cos()
+	tDReal m_Sss;
+	tDReal m_Scc;
+	tDReal m_Ssc;
+	tDReal m_Sxs;
+	tDReal m_Sxc;
+	tDReal m_Sxx;
+};
+
+CStreamCheck::CStreamCheck(int Codec, TYPEREAL ToneFreq)
+{
+	m_Codec = Codec;
+	m_ToneFreq = ToneFreq;
+	m_Rate = 0;
+	m_FirstSeq = 0;
+	m_NextSeq = 0;
+	m_Frames = 0;
+	m_LostFrames = 0;
+	m_OldFrames = 0;
+	m_BadFrames = 0;
+	m_Sss = 0.0;
+	m_Scc = 0.0;
+	m_Ssc = 0.0;
+	m_Sxs = 0.0;
+	m_Sxc = 0.0;
+	m_Sxx = 0.0;
+}
+
+/////////////////////////////////////////////////////////////////////
+// Checks and decodes one frame. Each frame carries the ADPCM decoder
+//state so it decodes on its own and a lost frame only leaves a gap.
+/////////////////////////////////////////////////////////////////////
+void CStreamCheck::PutFrame(const char* pFrame, int Length)
+{
+tAudioStreamHeader Hdr;
+	if(Length < (int)sizeof(Hdr))
+	{
+		m_BadFrames++;
+		return;
+	}
+	GetHeader(pFrame, Hdr);
+	int PayloadLength = (STREAM_CODEC_ULAW == m_Codec) ? MULAW_BYTES(Hdr.NumSamples) : ADPCM_BYTES(Hdr.NumSamples);
+	if( (STREAM_MAGIC != Hdr.Magic) || (m_Codec != Hdr.Codec) || (0 == Hdr.SampleRate) ||
+		(Hdr.NumSamples > STREAM_MAX_FRAME_SAMPLES) || (PayloadLength != Hdr.PayloadLength) ||
+		(Length != (int)sizeof(Hdr) + PayloadLength) )
+	{
+		m_BadFrames++;
+		return;
+	}
+	if(0 == m_Frames)
+	{
+		m_FirstSeq = Hdr.SeqNum;
+	}
+	else if(Hdr.SeqNum != m_NextSeq)
+	{
+		if( (qint32)(Hdr.SeqNum - m_NextSeq) < 0 )
+		{
+			m_OldFrames++;
+			return;
+		}
+		m_LostFrames += Hdr.SeqNum - m_NextSeq;
+	}
+	m_NextSeq = Hdr.SeqNum + 1;
+	m_Frames++;
+	m_Rate = Hdr.SampleRate;
+
+	const quint8* pPayload = (const quint8*)&pFrame[sizeof(Hdr)];
+	if(STREAM_CODEC_ULAW == m_Codec)
+	{
+		MuLawDecode(pPayload, Hdr.NumSamples, m_Audio);
+	}
+	else
+	{
+		m_Adpcm.SetState(Hdr.AdpcmPredict, Hdr.AdpcmIndex);
+		m_Adpcm.Decode(pPayload, Hdr.NumSamples, m_Audio);
+	}
+	if(Hdr.SeqNum < STREAMCLIENT_SETTLE_FRAMES)
+		return;
+	//every frame has the same length so the sequence number gives the time
+	tDReal w = K_2PI*m_ToneFreq/m_Rate;
+	qint64 t = (qint64)(Hdr.SeqNum - m_FirstSeq)*Hdr.NumSamples;
+	for(int i=0; i<Hdr.NumSamples; i++)
+	{
+		tDReal s = sin(w*(t+i));
+		tDReal c = cos(w*(t+i));
+		tDReal x = m_Audio[i];
+		m_Sss += s*s;
+		m_Scc += c*c;
+		m_Ssc += s*c;
+		m_Sxs += x*s;
+		m_Sxc += x*c;
+		m_Sxx += x*x;
+	}
+}
+
+bool CStreamCheck::Report(const char* pName)
+{
+	tDReal Snr = 0.0;
+	tDReal Det = m_Sss*m_Scc - m_Ssc*m_Ssc;
+	if(Det > 0.0)
+	{	//power of the fitted tone against what is left over
+		tDReal a = (m_Sxs*m_Scc - m_Sxc*m_Ssc)/Det;
+		tDReal b = (m_Sxc*m_Sss - m_Sxs*m_Ssc)/Det;
+		tDReal Sig = a*m_Sxs + b*m_Sxc;
+		tDReal Noise = m_Sxx - Sig;
+		if(Noise < 1e-30)
+			Noise = 1e-30;
+		Snr = 10.0*log10(Sig/Noise);
+	}
+	bool Pass = (m_Frames > 0) && (0 == m_LostFrames) && (0 == m_OldFrames) &&
+				(0 == m_BadFrames) && (Snr >= STREAMCLIENT_MIN_SNR);
+	printf("%s: %lld frames(seq %u to %u) %lld lost %lld out of order %lld bad  %d sps  SNR %.1f dB  %s\n",
+			pName, (long long)m_Frames, m_FirstSeq, m_NextSeq-1, (long long)m_LostFrames,
+			(long long)m_OldFrames, (long long)m_BadFrames, m_Rate, Snr, Pass ? "PASS" : "FAIL");
+	return Pass;
+}
+
+//command line loopback test of the compressed audio stream server:
+//	CuteSdr -streamclient [adpcm|ulaw] [rate] [seconds] [port]
+//Returns 0 if both the TCP and the UDP client pass.
+int StreamClientMain(int argc, char *argv[])
+{
+	QCoreApplication a(argc, argv);
+	int Codec = STREAM_CODEC_ADPCM;
+	if(argc > 2)
+	{
+		if(0 == strcmp(argv[2], "ulaw"))
+			Codec = STREAM_CODEC_ULAW;
+		else if(0 != strcmp(argv[2], "adpcm"))
+			Codec = 0;
+	}
+	int Rate = (argc > 3) ? atoi(argv[3]) : STREAM_DEF_RATE;
+	TYPEREAL Seconds = (argc > 4) ? atof(argv[4]) : 5.0;
+	int Port = (argc > 5) ? atoi(argv[5]) : STREAMCLIENT_PORT;
+	if( (0 == Codec) || (Rate <= 2*STREAMCLIENT_TONE) || (STREAMCLIENT_SRC_RATE % Rate) ||
+		(Seconds < 1.0) || (Port <= 0) || (Port > 65535) )
+	{
+		fprintf(stderr, "usage: CuteSdr -streamclient [adpcm|ulaw] [rate(divides %d)] [seconds] [port]\n",
+				STREAMCLIENT_SRC_RATE);
+		return 1;
+	}
+	CAudioStreamServer* pServer = new CAudioStreamServer(Port, Codec, Rate);
+	CStreamCheck TcpCheck(Codec, STREAMCLIENT_TONE);
+	CStreamCheck UdpCheck(Codec, STREAMCLIENT_TONE);
+
+	//the server starts listening once its thread runs
+	QTcpSocket Tcp;
+	for(int i=0; (i<20) && (QAbstractSocket::ConnectedState != Tcp.state()); i++)
+	{
+		Tcp.connectToHost(QHostAddress::LocalHost, Port);
+		if( !Tcp.waitForConnected(100) )
+		{
+			Tcp.abort();
+			QThread::msleep(50);
+		}
+	}
+	if(QAbstractSocket::ConnectedState != Tcp.state())
+		fprintf(stderr, "TCP connect to port %d failed\n", Port);
+	QUdpSocket Udp;
+	Udp.bind(QHostAddress::LocalHost, 0);
+	tAudioStreamSubscribe Sub;
+	Sub.Magic = qToLittleEndian<quint32>(STREAM_SUBSCRIBE_MAGIC);
+	Sub.JitterFrames = 0;
+	Sub.Reserved = 0;
+
+	static qint16 Tone[2*STREAMCLIENT_CHUNK];
+	static char Datagram[STREAM_MAX_FRAME_BYTES + 1];
+	QByteArray TcpBuf;
+	qint64 TcpSkipped = 0;
+	qint64 NumFrames = (qint64)(Seconds*STREAMCLIENT_SRC_RATE);
+	qint64 SrcPos = 0;
+	qint64 LastSubscribe = -STREAMCLIENT_SUBSCRIBE_MS;
+	QElapsedTimer Clock;
+	Clock.start();
+	while(Clock.elapsed() < Seconds*1000 + STREAMCLIENT_DRAIN_MS)
+	{
+		if( (Clock.elapsed() - LastSubscribe) >= STREAMCLIENT_SUBSCRIBE_MS )
+		{
+			LastSubscribe = Clock.elapsed();
+			Udp.writeDatagram((const char*)&Sub, sizeof(Sub), QHostAddress::LocalHost, Port);
+		}
+		//write the tone in real time as the DSP thread would
+		qint64 Due = (Clock.nsecsElapsed()*STREAMCLIENT_SRC_RATE)/1000000000;
+		if(Due > NumFrames)
+			Due = NumFrames;
+		while(SrcPos < Due)
+		{
+			int n = (Due - SrcPos > STREAMCLIENT_CHUNK) ? STREAMCLIENT_CHUNK : (int)(Due - SrcPos);
+			for(int i=0; i<n; i++)
+			{
+				qint16 x = (qint16)(STREAMCLIENT_AMPLITUDE*sin(K_2PI*STREAMCLIENT_TONE*(SrcPos+i)/STREAMCLIENT_SRC_RATE));
+				Tone[2*i] = x;
+				Tone[2*i+1] = x;
+			}
+			pServer->Write(Tone, n, 2, STREAMCLIENT_SRC_RATE);
+			SrcPos += n;
+		}
+
+		if(QAbstractSocket::ConnectedState == Tcp.state())
+		{	//TCP frames are back to back so split them on the header
+			Tcp.waitForReadyRead(STREAMCLIENT_POLL_MS);
+			TcpBuf.append(Tcp.readAll());
+			while(TcpBuf.size() >= (int)sizeof(tAudioStreamHeader))
+			{
+				tAudioStreamHeader Hdr;
+				GetHeader(TcpBuf.constData(), Hdr);
+				if(STREAM_MAGIC != Hdr.Magic)
+				{	//lost the frame boundary so resync on the next magic
+					TcpBuf.remove(0, 1);
+					TcpSkipped++;
+					continue;
+				}
+				int Length = sizeof(Hdr) + Hdr.PayloadLength;
+				if(TcpBuf.size() < Length)
+					break;
+				TcpCheck.PutFrame(TcpBuf.constData(), Length);
+				TcpBuf.remove(0, Length);
+			}
+		}
+		else
+		{
+			QThread::msleep(STREAMCLIENT_POLL_MS);
+		}
+		while(Udp.hasPendingDatagrams())
+		{
+			qint64 Length = Udp.readDatagram(Datagram, sizeof(Datagram));
+			if(Length > 0)
+				UdpCheck.PutFrame(Datagram, (int)Length);
+		}
+	}
+	delete pServer;
+
+	printf("%s at %d sps, %.0f Hz tone for %.1f Sec\n",
+			(STREAM_CODEC_ULAW == Codec) ? "mu-law" : "IMA ADPCM", Rate, STREAMCLIENT_TONE, Seconds);
+	bool Pass = TcpCheck.Report("TCP");
+	if(TcpSkipped)
+		printf("TCP: %lld bytes skipped to find a frame header\n", (long long)TcpSkipped);
+	Pass = UdpCheck.Report("UDP") && Pass && (0 == TcpSkipped);
+	return Pass ? 0 : 1;
+}
@@ -7,6 +7,10 @@
 //	2010-09-15  Initial creation MSW
 //	2011-03-27  Initial release
 //	2013-07-28  Added single/double precision math macros
+//	2026-10-18  Block processing with sliding max deque and fast log2/exp2
+//	2026-10-18  Added ResetDelay() for squelch gated restarts
+//	2026-10-18  Removed the mutex, CDemodulator serializes all calls
+//	2026-10-18  CAgc is CAgcT<TYPEREAL>, float and double versions are built
 //////////////////////////////////////////////////////////////////////
 //==========================================================================================
 // + + +   This Software is released under the "Simplified BSD License"  + + +
@@ -38,6 +42,7 @@
 //==========================================================================================
 
 #include "dsp/agc.h"
+#include "dsp/simdops.h"
 #include "gui/testbench.h"
 #include <QDebug>
 //#include <math.h>
@@ -73,12 +78,16 @@
 #define MIN_CONSTANT 3.2767e-4	//const for calc log() so that a value of 0 magnitude == -8
 								//corresponding to -160dB.
 								//K = 10^( -8 + log(32767) )
+#define LOG10_MAX_AMPLITUDE 4.51543668	//log10(MAX_AMPLITUDE)
+#define K_LOG10_2 0.30102999566	//log10(2)
+#define K_LOG2_10 3.32192809489	//log2(10)
 
 //////////////////////////////////////////////////////////////////////
 // Construction/Destruction
 //////////////////////////////////////////////////////////////////////
 
-CAgc::CAgc()
+template <typename T>
+CAgcT<T>::CAgcT()
 {
 	m_AgcOn = true;
 	m_UseHang = false;
@@ -87,9 +96,15 @@ CAgc::CAgc()
 	m_SlopeFactor = 0;
 	m_Decay = 0;
 	m_SampleRate = 100.0;
+	m_SigDelayPtr = 0;
+	m_DelaySamples = 1;
+	m_PeakHead = 0;
+	m_PeakCount = 0;
+	m_SampleCount = 0;
 }
 
-CAgc::~CAgc()
+template <typename T>
+CAgcT<T>::~CAgcT()
 {
 }
 
@@ -102,8 +117,9 @@ CAgc::~CAgc()
 //  "Decay" is AGC decay value in milliseconds ( nominal range 20 to 5000 milliSeconds)
 //  ""SampleRate" is current sample rate of AGC data
 ////////////////////////////////////////////////////////////////////////////////
-void CAgc::SetParameters(bool AgcOn,  bool UseHang, int Threshold, int ManualGain,
-						 int SlopeFactor, int Decay, TYPEREAL SampleRate)
+template <typename T>
+void CAgcT<T>::SetParameters(bool AgcOn,  bool UseHang, int Threshold, int ManualGain,
+						 int SlopeFactor, int Decay, T SampleRate)
 {
 	if(	(AgcOn == m_AgcOn) && (UseHang == m_UseHang) &&
 		(Threshold == m_Threshold) && (ManualGain == m_ManualGain) &&
@@ -112,7 +128,6 @@ void CAgc::SetParameters(bool AgcOn,  bool UseHang, int Threshold, int ManualGai
 	{
 		return;		//just return if no parameter changed
 	}
-	m_Mutex.lock();
 	m_AgcOn = AgcOn;
 	m_UseHang = UseHang;
 	m_Threshold = Threshold;
@@ -126,153 +141,165 @@ void CAgc::SetParameters(bool AgcOn,  bool UseHang, int Threshold, int ManualGai
 		{
 			m_SigDelayBuf[i].re = 0.0;
 			m_SigDelayBuf[i].im = 0.0;
-			m_MagBuf[i] = -16.0;
 		}
 		m_SigDelayPtr = 0;
 		m_HangTimer = 0;
-		m_Peak = -16.0;
 		m_DecayAve = -5.0;
 		m_AttackAve = -5.0;
-		m_MagBufPos = 0;
+		m_PeakHead = 0;
+		m_PeakCount = 0;
+		m_SampleCount = 0;
 	}
 
 	//convert m_ThreshGain to linear manual gain value
-	m_ManualAgcGain = MAX_MANUAL_AMPLITUDE*MPOW(10.0, -(100-(TYPEREAL)m_ManualGain)/20.0);
+	m_ManualAgcGain = MAX_MANUAL_AMPLITUDE*Prec::Pow(10.0, -(100-(T)m_ManualGain)/20.0);
 
 	//calculate parameters for AGC gain as a function of input magnitude
-	m_Knee = (TYPEREAL)m_Threshold/20.0;
+	m_Knee = (T)m_Threshold/20.0;
 	m_GainSlope = m_SlopeFactor/(100.0);
-	m_FixedGain = AGC_OUTSCALE * MPOW(10.0, m_Knee*(m_GainSlope - 1.0) );	//fixed gain value used below knee threshold
+	m_FixedGain = AGC_OUTSCALE * Prec::Pow(10.0, m_Knee*(m_GainSlope - 1.0) );	//fixed gain value used below knee threshold
+	m_GainExp = (m_GainSlope - 1.0)*K_LOG2_10;	//10^(mag*(slope-1)) == 2^(mag*m_GainExp)
 //qDebug()<<"m_Knee = "<<m_Knee<<" m_GainSlope = "<<m_GainSlope<< "m_FixedGain = "<<m_FixedGain;
 
-	m_HangTime = (int)(m_SampleRate * (TYPEREAL)m_Decay * .001);
+	m_HangTime = (int)(m_SampleRate * (T)m_Decay * .001);
 
 	//calculate fast and slow filter values.
-	m_AttackRiseAlpha = (1.0-MEXP(-1.0/(m_SampleRate*ATTACK_RISE_TIMECONST)) );
-	m_AttackFallAlpha = (1.0-MEXP(-1.0/(m_SampleRate*ATTACK_FALL_TIMECONST)) );
-	m_DecayRiseAlpha = (1.0-MEXP(-1.0/(m_SampleRate * (TYPEREAL)m_Decay*.001*DECAY_RISEFALL_RATIO)) );	//make rise time DECAY_RISEFALL_RATIO of fall
+	m_AttackRiseAlpha = (1.0-Prec::Exp(-1.0/(m_SampleRate*ATTACK_RISE_TIMECONST)) );
+	m_AttackFallAlpha = (1.0-Prec::Exp(-1.0/(m_SampleRate*ATTACK_FALL_TIMECONST)) );
+	m_DecayRiseAlpha = (1.0-Prec::Exp(-1.0/(m_SampleRate * (T)m_Decay*.001*DECAY_RISEFALL_RATIO)) );	//make rise time DECAY_RISEFALL_RATIO of fall
 	if(m_UseHang)
-		m_DecayFallAlpha = (1.0-MEXP(-1.0/(m_SampleRate * RELEASE_TIMECONST)) );
+		m_DecayFallAlpha = (1.0-Prec::Exp(-1.0/(m_SampleRate * RELEASE_TIMECONST)) );
 	else
-		m_DecayFallAlpha = (1.0-MEXP(-1.0/(m_SampleRate * (TYPEREAL)m_Decay *.001)) );
+		m_DecayFallAlpha = (1.0-Prec::Exp(-1.0/(m_SampleRate * (T)m_Decay *.001)) );
 	m_DelaySamples = (int)(m_SampleRate*DELAY_TIMECONST);
 	m_WindowSamples = (int)(m_SampleRate*WINDOW_TIMECONST);
 
-	//clamp Delay samples within buffer limit
+	//clamp Delay and window samples within buffer limit
 	if(m_DelaySamples >= MAX_DELAY_BUF-1)
 		m_DelaySamples = MAX_DELAY_BUF-1;
+	if(m_WindowSamples > MAX_DELAY_BUF)
+		m_WindowSamples = MAX_DELAY_BUF;
+	if(m_WindowSamples < 1)
+		m_WindowSamples = 1;
+}
+
+
 
-	m_Mutex.unlock();
+//////////////////////////////////////////////////////////////////////
+// Clears the signal delay line and peak window so old data is not
+//output when processing restarts after a gap.
+//////////////////////////////////////////////////////////////////////
+template <typename T>
+void CAgcT<T>::ResetDelay()
+{
+	for(int i=0; i<MAX_DELAY_BUF; i++)
+	{
+		m_SigDelayBuf[i].re = 0.0;
+		m_SigDelayBuf[i].im = 0.0;
+	}
+	m_SigDelayPtr = 0;
+	m_PeakHead = 0;
+	m_PeakCount = 0;
 }
 
+//////////////////////////////////////////////////////////////////////
+// Runs the peak detector and attack/decay averagers over the Length
+//log2 magnitudes in m_MagBuf and replaces them with the gain for each
+//sample. Only the averagers are serial, the log and exp are done a
+//block at a time.
+//////////////////////////////////////////////////////////////////////
+template <typename T>
+void CAgcT<T>::CalcGain(int Length)
+{
+T mag;
+	for(int i=0; i<Length; i++)
+	{
+		mag = m_MagBuf[i]*K_LOG10_2 - LOG10_MAX_AMPLITUDE;		//0==max  -8 is min==-160dB
+
+		//create a sliding window of 'm_WindowSamples' magnitudes and output the peak value within the sliding window.
+		//Magnitudes not larger than the new one can never be the peak again so drop them from the tail.
+		while( (m_PeakCount > 0) && (m_PeakMag[(m_PeakHead + m_PeakCount - 1)&(MAX_DELAY_BUF-1)] <= mag) )
+			m_PeakCount--;
+		int tail = (m_PeakHead + m_PeakCount)&(MAX_DELAY_BUF-1);
+		m_PeakMag[tail] = mag;
+		m_PeakTime[tail] = m_SampleCount;
+		m_PeakCount++;
+		if( (m_SampleCount - m_PeakTime[m_PeakHead]) >= (quint32)m_WindowSamples )
+		{	//oldest peak has left the window
+			m_PeakHead = (m_PeakHead + 1)&(MAX_DELAY_BUF-1);
+			m_PeakCount--;
+		}
+		m_SampleCount++;
+		T peak = m_PeakMag[m_PeakHead];
+
+		// perform average of magnitude using 2 averagers each with separate rise and fall time constants
+		if(peak>m_AttackAve)	//if magnitude is rising (use m_AttackRiseAlpha time constant)
+			m_AttackAve = (1.0-m_AttackRiseAlpha)*m_AttackAve + m_AttackRiseAlpha*peak;
+		else					//else magnitude is falling (use  m_AttackFallAlpha time constant)
+			m_AttackAve = (1.0-m_AttackFallAlpha)*m_AttackAve + m_AttackFallAlpha*peak;
+
+		if(peak>m_DecayAve)	//if magnitude is rising (use m_DecayRiseAlpha time constant)
+		{
+			m_DecayAve = (1.0-m_DecayRiseAlpha)*m_DecayAve + m_DecayRiseAlpha*peak;
+			m_HangTimer = 0;	//reset hang timer
+		}
+		else if(m_UseHang && (m_HangTimer<m_HangTime))
+		{	//decreasing signal in hang timer mode
+			m_HangTimer++;	//just inc and hold current m_DecayAve
+		}
+		else	//else decay with m_DecayFallAlpha (RELEASE_TIMECONST in hang mode)
+		{
+			m_DecayAve = (1.0-m_DecayFallAlpha)*m_DecayAve + m_DecayFallAlpha*peak;
+		}
 
+		//use greater magnitude of attack or Decay Averager
+		mag = (m_AttackAve>m_DecayAve) ? m_AttackAve : m_DecayAve;
+		if(mag<m_Knee)		//use fixed gain if below knee
+			mag = m_Knee;
+		m_MagBuf[i] = mag*m_GainExp;
+	}
+	//gain = AGC_OUTSCALE * 10^(mag*(m_GainSlope - 1.0))
+	SimdExp2(m_MagBuf, m_MagBuf, Length);
+	for(int i=0; i<Length; i++)
+		m_MagBuf[i] *= AGC_OUTSCALE;
+}
 
 //////////////////////////////////////////////////////////////////////
 // Automatic Gain Control calculator for COMPLEX data
 //////////////////////////////////////////////////////////////////////
-void CAgc::ProcessData(int Length, TYPECPX* pInData, TYPECPX* pOutData)
+template <typename T>
+void CAgcT<T>::ProcessData(int Length, Cpx* pInData, Cpx* pOutData)
 {
-TYPEREAL gain;
-TYPEREAL mag;
-TYPECPX delayedin;
-	m_Mutex.lock();
 	if(m_AgcOn)
 	{
-		for(int i=0; i<Length; i++)
+		for(int k=0; k<Length; k+=AGC_BLOCK)
 		{
-			TYPECPX in = pInData[i];	//get latest input sample
-			//Get delayed sample of input signal
-			delayedin = m_SigDelayBuf[m_SigDelayPtr];
-			//put new input sample into signal delay buffer
-			m_SigDelayBuf[m_SigDelayPtr++] = in;
-			if( m_SigDelayPtr >= m_DelaySamples)	//deal with delay buffer wrap around
-				m_SigDelayPtr = 0;
-			mag = MFABS(in.re);
-			TYPEREAL mim = MFABS(in.im);
-			if(mim>mag)
-				mag = mim;
-			mag = MLOG10( mag + MIN_CONSTANT ) - MLOG10(MAX_AMPLITUDE);		//0==max  -8 is min==-160dB
-
-//pOutData[i].re = 3000*mag;
-
-//pOutData[i].re = 1500*MLOG10( ((delayedin.re*delayedin.re)+(delayedin.im*delayedin.im))/(MAX_AMPLITUDE*MAX_AMPLITUDE) + 1e-16);;
-
-			//create a sliding window of 'm_WindowSamples' magnitudes and output the peak value within the sliding window
-			TYPEREAL tmp = m_MagBuf[m_MagBufPos];	//get oldest mag sample from buffer into tmp
-			m_MagBuf[m_MagBufPos++] = mag;			//put latest mag sample in buffer;
-			if( m_MagBufPos >= m_WindowSamples)		//deal with magnitude buffer wrap around
-				m_MagBufPos = 0;
-			if(mag > m_Peak)
+			int n = Length - k;
+			if(n > AGC_BLOCK)
+				n = AGC_BLOCK;
+			const Cpx* pIn = pInData + k;
+			Cpx* pOut = pOutData + k;
+			//log of the larger of |I| and |Q|
+			for(int i=0; i<n; i++)
 			{
-				m_Peak = mag;	//if new sample is larger than current peak then use it, no need to look at buffer values
+				T mag = Prec::Fabs(pIn[i].re);
+				T mim = Prec::Fabs(pIn[i].im);
+				m_MagBuf[i] = ( (mim>mag) ? mim : mag ) + MIN_CONSTANT;
 			}
-			else
+			SimdLog2(m_MagBuf, m_MagBuf, n);
+			CalcGain(n);
+			for(int i=0; i<n; i++)
 			{
-				if(tmp == m_Peak)		//tmp is oldest sample pulled out of buffer
-				{	//if oldest sample pulled out was last peak then need to find next highest peak in buffer
-					m_Peak = -8.0;		//set to lowest value to find next max peak
-					//search all buffer for maximum value and set as new peak
-					for(int i=0; i<m_WindowSamples; i++)
-					{
-						tmp = m_MagBuf[i];
-						if(tmp > m_Peak)
-							m_Peak = tmp;
-					}
-				}
-			}
-
-//pOutData[i].im = 3000*m_Peak;
-
-			if(m_UseHang)
-			{	//using hang timer mode
-				if(m_Peak>m_AttackAve)	//if power is rising (use m_AttackRiseAlpha time constant)
-					m_AttackAve = (1.0-m_AttackRiseAlpha)*m_AttackAve + m_AttackRiseAlpha*m_Peak;
-				else					//else magnitude is falling (use  m_AttackFallAlpha time constant)
-					m_AttackAve = (1.0-m_AttackFallAlpha)*m_AttackAve + m_AttackFallAlpha*m_Peak;
-
-				if(m_Peak>m_DecayAve)	//if magnitude is rising (use m_DecayRiseAlpha time constant)
-				{
-					m_DecayAve = (1.0-m_DecayRiseAlpha)*m_DecayAve + m_DecayRiseAlpha*m_Peak;
-					m_HangTimer = 0;	//reset hang timer
-				}
-				else
-				{	//here if decreasing signal
-					if(m_HangTimer<m_HangTime)
-						m_HangTimer++;	//just inc and hold current m_DecayAve
-					else	//else decay with m_DecayFallAlpha which is RELEASE_TIMECONST
-						m_DecayAve = (1.0-m_DecayFallAlpha)*m_DecayAve + m_DecayFallAlpha*m_Peak;
-				}
+				Cpx in = pIn[i];	//get latest input sample
+				//Get delayed sample of input signal
+				Cpx delayedin = m_SigDelayBuf[m_SigDelayPtr];
+				//put new input sample into signal delay buffer
+				m_SigDelayBuf[m_SigDelayPtr++] = in;
+				if( m_SigDelayPtr >= m_DelaySamples)	//deal with delay buffer wrap around
+					m_SigDelayPtr = 0;
+				pOut[i].re = delayedin.re * m_MagBuf[i];
+				pOut[i].im = delayedin.im * m_MagBuf[i];
 			}
-			else
-			{	//using exponential decay mode
-				// perform average of magnitude using 2 averagers each with separate rise and fall time constants
-				if(m_Peak>m_AttackAve)	//if magnitude is rising (use m_AttackRiseAlpha time constant)
-					m_AttackAve = (1.0-m_AttackRiseAlpha)*m_AttackAve + m_AttackRiseAlpha*m_Peak;
-				else					//else magnitude is falling (use  m_AttackFallAlpha time constant)
-					m_AttackAve = (1.0-m_AttackFallAlpha)*m_AttackAve + m_AttackFallAlpha*m_Peak;
-
-//pOutData[i].im = 3000*m_AttackAve;
-				if(m_Peak>m_DecayAve)	//if magnitude is rising (use m_DecayRiseAlpha time constant)
-					m_DecayAve = (1.0-m_DecayRiseAlpha)*m_DecayAve + m_DecayRiseAlpha*(m_Peak);
-				else					//else magnitude is falling (use m_DecayFallAlpha time constant)
-					m_DecayAve = (1.0-m_DecayFallAlpha)*m_DecayAve + m_DecayFallAlpha*(m_Peak);
-//pOutData[i].im = 3000*m_DecayAve;
-			}
-			//use greater magnitude of attack or Decay Averager
-			if(m_AttackAve>m_DecayAve)
-				mag = m_AttackAve;
-			else
-				mag = m_DecayAve;
-
-//pOutData[i].im = 3000*mag;
-			//calc gain depending on which side of knee the magnitude is on
-			if(mag<=m_Knee)		//use fixed gain if below knee
-				gain = m_FixedGain;
-			else				//use variable gain if above knee
-				gain = AGC_OUTSCALE * MPOW(10.0, mag*(m_GainSlope - 1.0) );
-//pOutData[i].re = .5*gain;
-			pOutData[i].re = delayedin.re * gain;
-			pOutData[i].im = delayedin.im * gain;
 		}
 	}
 	else
@@ -283,104 +310,39 @@ TYPECPX delayedin;
 			pOutData[i].im = m_ManualAgcGain * pInData[i].im;
 		}
 	}
-	m_Mutex.unlock();
 }
 
 //////////////////////////////////////////////////////////////////////
 // Automatic Gain Control calculator for REAL data
 //////////////////////////////////////////////////////////////////////
-void CAgc::ProcessData(int Length, TYPEREAL* pInData, TYPEREAL* pOutData)
+template <typename T>
+void CAgcT<T>::ProcessData(int Length, T* pInData, T* pOutData)
 {
-TYPEREAL gain;
-TYPEREAL mag;
-TYPEREAL delayedin;
-	m_Mutex.lock();
 	if(m_AgcOn)
 	{
-		for(int i=0; i<Length; i++)
+		for(int k=0; k<Length; k+=AGC_BLOCK)
 		{
-			TYPEREAL in = pInData[i];	//get latest input sample
-
-			//Get delayed sample of input signal
-			delayedin = m_SigDelayBuf[m_SigDelayPtr].re;
-			//put new input sample into signal delay buffer
-			m_SigDelayBuf[m_SigDelayPtr++].re = in;
-			if( m_SigDelayPtr >= m_DelaySamples)	//deal with delay buffer wrap around
-				m_SigDelayPtr = 0;
-
+			int n = Length - k;
+			if(n > AGC_BLOCK)
+				n = AGC_BLOCK;
+			const T* pIn = pInData + k;
+			T* pOut = pOutData + k;
 			//convert |mag| to log |mag|
-			mag = MLOG10( MFABS(in) + MIN_CONSTANT ) - MLOG10(MAX_AMPLITUDE);		//0==max  -8 is min==-160dB
-
-			//create a sliding window of 'm_WindowSamples' magnitudes and output the peak value within the sliding window
-			TYPEREAL tmp = m_MagBuf[m_MagBufPos];	//get oldest mag sample from buffer into tmp
-			m_MagBuf[m_MagBufPos++] = mag;			//put latest mag sample in buffer;
-			if( m_MagBufPos >= m_WindowSamples)		//deal with magnitude buffer wrap around
-				m_MagBufPos = 0;
-			if(mag > m_Peak)
-			{
-				m_Peak = mag;	//if new sample is larger than current peak then use it, no need to look at buffer values
-			}
-			else
+			for(int i=0; i<n; i++)
+				m_MagBuf[i] = Prec::Fabs(pIn[i]) + MIN_CONSTANT;
+			SimdLog2(m_MagBuf, m_MagBuf, n);
+			CalcGain(n);
+			for(int i=0; i<n; i++)
 			{
-				if(tmp == m_Peak)		//tmp is oldest sample pulled out of buffer
-				{	//if oldest sample pulled out was last peak then need to find next highest peak in buffer
-					m_Peak = -8.0;		//set to lowest value to find next max peak
-					//search all buffer for maximum value and set as new peak
-					for(int i=0; i<m_WindowSamples; i++)
-					{
-						tmp = m_MagBuf[i];
-						if(tmp > m_Peak)
-							m_Peak = tmp;
-					}
-				}
-			}
-
-			if(m_UseHang)
-			{	//using hang timer mode
-				if(m_Peak>m_AttackAve)	//if magnitude is rising (use m_AttackRiseAlpha time constant)
-					m_AttackAve = (1.0-m_AttackRiseAlpha)*m_AttackAve + m_AttackRiseAlpha*m_Peak;
-				else					//else magnitude is falling (use  m_AttackFallAlpha time constant)
-					m_AttackAve = (1.0-m_AttackFallAlpha)*m_AttackAve + m_AttackFallAlpha*m_Peak;
-
-				if(m_Peak>m_DecayAve)	//if magnitude is rising (use m_DecayRiseAlpha time constant)
-				{
-					m_DecayAve = (1.0-m_DecayRiseAlpha)*m_DecayAve + m_DecayRiseAlpha*m_Peak;
-					m_HangTimer = 0;	//reset hang timer
-				}
-				else
-				{	//here if decreasing signal
-					if(m_HangTimer<m_HangTime)
-						m_HangTimer++;	//just inc and hold current m_DecayAve
-					else	//else decay with m_DecayFallAlpha which is RELEASE_TIMECONST
-						m_DecayAve = (1.0-m_DecayFallAlpha)*m_DecayAve + m_DecayFallAlpha*m_Peak;
-				}
+				T in = pIn[i];	//get latest input sample
+				//Get delayed sample of input signal
+				T delayedin = m_SigDelayBuf[m_SigDelayPtr].re;
+				//put new input sample into signal delay buffer
+				m_SigDelayBuf[m_SigDelayPtr++].re = in;
+				if( m_SigDelayPtr >= m_DelaySamples)	//deal with delay buffer wrap around
+					m_SigDelayPtr = 0;
+				pOut[i] = delayedin * m_MagBuf[i];
 			}
-			else
-			{	//using exponential decay mode
-				// perform average of magnitude using 2 averagers each with separate rise and fall time constants
-				if(m_Peak>m_AttackAve)	//if magnitude is rising (use m_AttackRiseAlpha time constant)
-					m_AttackAve = (1.0-m_AttackRiseAlpha)*m_AttackAve + m_AttackRiseAlpha*m_Peak;
-				else					//else magnitude is falling (use  m_AttackFallAlpha time constant)
-					m_AttackAve = (1.0-m_AttackFallAlpha)*m_AttackAve + m_AttackFallAlpha*m_Peak;
-
-				if(m_Peak>m_DecayAve)	//if magnitude is rising (use m_DecayRiseAlpha time constant)
-					m_DecayAve = (1.0-m_DecayRiseAlpha)*m_DecayAve + m_DecayRiseAlpha*(m_Peak);
-				else					//else magnitude is falling (use m_DecayFallAlpha time constant)
-					m_DecayAve = (1.0-m_DecayFallAlpha)*m_DecayAve + m_DecayFallAlpha*(m_Peak);
-			}
-
-			//use greater magnitude of attack or Decay Averager
-			if(m_AttackAve>m_DecayAve)
-				mag = m_AttackAve;
-			else
-				mag = m_DecayAve;
-
-			//calc gain depending on which side of knee the magnitude is on
-			if(mag<=m_Knee)		//use fixed gain if below knee
-				gain = m_FixedGain;
-			else				//use variable gain if above knee
-				gain = AGC_OUTSCALE * MPOW(10.0, mag*(m_GainSlope - 1.0) );
-			pOutData[i] = delayedin * gain;
 		}
 	}
 	else
@@ -388,5 +350,9 @@ TYPEREAL delayedin;
 		for(int i=0; i<Length; i++)
 			pOutData[i] = m_ManualAgcGain * pInData[i];
 	}
-	m_Mutex.unlock();
 }
+
+
+//float and double versions of the AGC
+template class CAgcT<tSReal>;
+template class CAgcT<tDReal>;
@@ -6,6 +6,10 @@
 // History:
 //	2010-09-15  Initial creation MSW
 //	2011-03-27  Initial release
+//	2026-10-18  Block processing with sliding max deque and fast log2/exp2
+//	2026-10-18  Added ResetDelay() for squelch gated restarts
+//	2026-10-18  Removed the mutex, CDemodulator serializes all calls
+//	2026-10-18  CAgc is CAgcT<TYPEREAL>, float and double versions are built
 //////////////////////////////////////////////////////////////////////
 //==========================================================================================
 // + + +   This Software is released under the "Simplified BSD License"  + + +
@@ -39,52 +43,71 @@
 #define AGCX_H
 
 #include "dsp/datatypes.h"
-#include <QMutex>
 
-#define MAX_DELAY_BUF 2048
+#define MAX_DELAY_BUF 2048	//must be a power of 2
+#define AGC_BLOCK 512		//samples processed at a time
 
-class CAgc
+//Not thread safe. The owner must keep SetParameters() and ResetDelay()
+// from running at the same time as ProcessData().
+//T is the sample type, tSReal or tDReal. CAgc uses the build precision TYPEREAL.
+template <typename T>
+class CAgcT
 {
 public:
-	CAgc();
-	virtual ~CAgc();
-	void SetParameters(bool AgcOn, bool UseHang, int Threshold, int ManualGain, int Slope, int Decay, TYPEREAL SampleRate);
-	void ProcessData(int Length, TYPECPX* pInData, TYPECPX* pOutData);
-	void ProcessData(int Length, TYPEREAL* pInData, TYPEREAL* pOutData);
+	typedef typename tPrecision<T>::Cpx Cpx;
+	CAgcT();
+	virtual ~CAgcT();
+	void SetParameters(bool AgcOn, bool UseHang, int Threshold, int ManualGain, int Slope, int Decay, T SampleRate);
+	void ProcessData(int Length, Cpx* pInData, Cpx* pOutData);
+	void ProcessData(int Length, T* pInData, T* pOutData);
+	//clears the signal delay line and peak window but keeps the gain
+	// averagers so processing can restart after a gap in the data
+	void ResetDelay();
 
 private:
+	typedef tPrecision<T> Prec;
+	void CalcGain(int Length);
 	bool m_AgcOn;				//internal copy of AGC settings parameters
 	bool m_UseHang;
 	int m_Threshold;
 	int m_ManualGain;
 	int m_Decay;
-	TYPEREAL m_SampleRate;
+	T m_SampleRate;
 
-	TYPEREAL m_SlopeFactor;
-	TYPEREAL m_ManualAgcGain;
+	T m_SlopeFactor;
+	T m_ManualAgcGain;
 
-	TYPEREAL m_DecayAve;
-	TYPEREAL m_AttackAve;
+	T m_DecayAve;
+	T m_AttackAve;
 
-	TYPEREAL m_AttackRiseAlpha;
-	TYPEREAL m_AttackFallAlpha;
-	TYPEREAL m_DecayRiseAlpha;
-	TYPEREAL m_DecayFallAlpha;
+	T m_AttackRiseAlpha;
+	T m_AttackFallAlpha;
+	T m_DecayRiseAlpha;
+	T m_DecayFallAlpha;
 
-	TYPEREAL m_FixedGain;
-	TYPEREAL m_Knee;
-	TYPEREAL m_GainSlope;
-	TYPEREAL m_Peak;
+	T m_FixedGain;
+	T m_Knee;
+	T m_GainSlope;
+	T m_GainExp;		//converts log10 magnitude to a log2 gain exponent
 
 	int m_SigDelayPtr;
-	int m_MagBufPos;
 	int m_DelaySamples;
 	int m_WindowSamples;
 	int m_HangTime;
 	int m_HangTimer;
 
-	QMutex m_Mutex;		//for keeping threads from stomping on each other
-	TYPECPX m_SigDelayBuf[MAX_DELAY_BUF];
-	TYPEREAL m_MagBuf[MAX_DELAY_BUF];
+	//sliding window peak detector. A ring used as a deque of the
+	// decreasing magnitudes in the window so the peak is at the head
+	int m_PeakHead;
+	int m_PeakCount;
+	quint32 m_SampleCount;
+	T m_PeakMag[MAX_DELAY_BUF];
+	quint32 m_PeakTime[MAX_DELAY_BUF];
+
+	Cpx m_SigDelayBuf[MAX_DELAY_BUF];
+	T m_MagBuf[AGC_BLOCK];		//log magnitude then gain of each sample in a block
 };
+
+typedef CAgcT<TYPEREAL> CAgc;
+
 #endif //  AGCX_H
@@ -7,6 +7,7 @@
 //	2011-03-27  Initial release
 //	2011-08-07  Modified FIR filter initialization call
 //	2013-07-28  Added single/double precision math macros
+//	2026-10-18  Added Init() so one instance can be reused
 //////////////////////////////////////////////////////////////////////
 //==========================================================================================
 // + + +   This Software is released under the "Simplified BSD License"  + + +
@@ -49,8 +50,17 @@
 /////////////////////////////////////////////////////////////////////////////////
 //	Construct AM demod object
 /////////////////////////////////////////////////////////////////////////////////
-CAmDemod::CAmDemod(TYPEREAL samplerate) : m_SampleRate(samplerate)
+CAmDemod::CAmDemod(TYPEREAL samplerate)
 {
+	Init(samplerate);
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//	Sets the sample rate and clears the demod state
+/////////////////////////////////////////////////////////////////////////////////
+void CAmDemod::Init(TYPEREAL samplerate)
+{
+	m_SampleRate = samplerate;
 	m_z1 = 0.0;
 	m_Fir.InitLPFilter(0, 1.0, 50.0, 10000, 10000*1.8, m_SampleRate);//initialize LP FIR filter
 }
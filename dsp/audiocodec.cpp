@@ -0,0 +1,224 @@
+//////////////////////////////////////////////////////////////////////
+// audiocodec.cpp: implementation of the IMA ADPCM and mu-law codecs.
+//
+//  These are the standard IMA/DVI ADPCM step tables and the G.711
+// mu-law companding rule. They cost a few integer operations per sample
+// so the streaming server can encode on its own thread with no
+// external library.
+//
+// History:
+//	2026-10-18  Initial creation
+//////////////////////////////////////////////////////////////////////
+//==========================================================================================
+// + + +   This Software is released under the "Simplified BSD License"  + + +
+//Copyright 2010 Moe Wheatley. All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification, are
+//permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice, this list of
+//	  conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice, this list
+//	  of conditions and the following disclaimer in the documentation and/or other materials
+//	  provided with the distribution.
+//
+//THIS SOFTWARE IS PROVIDED BY Moe Wheatley ``AS IS'' AND ANY EXPRESS OR IMPLIED
+//WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+//FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Moe Wheatley OR
+//CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+//ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+//ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//The views and conclusions contained in the software and documentation are those of the
+//authors and should not be interpreted as representing official policies, either expressed
+//or implied, of Moe Wheatley.
+//==========================================================================================
+#include "dsp/audiocodec.h"
+
+//////////////////////////////////////////////////////////////////////
+// Local Defines
+//////////////////////////////////////////////////////////////////////
+#define MULAW_BIAS 0x84
+#define MULAW_CLIP 32635
+
+static const int ADPCM_INDEX_TABLE[16] =
+{
+	-1, -1, -1, -1, 2, 4, 6, 8,
+	-1, -1, -1, -1, 2, 4, 6, 8
+};
+
+static const int ADPCM_STEP_TABLE[89] =
+{
+	7, 8, 9, 10, 11, 12, 13, 14, 16, 17,
+	19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+	50, 55, 60, 66, 73, 80, 88, 97, 107, 118,
+	130, 143, 157, 173, 190, 209, 230, 253, 279, 307,
+	337, 371, 408, 449, 494, 544, 598, 658, 724, 796,
+	876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066,
+	2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358,
+	5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899,
+	15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+};
+
+//////////////////////////////////////////////////////////////////////
+// Sets the decoder state from the values sent with a frame
+//////////////////////////////////////////////////////////////////////
+void CImaAdpcm::SetState(qint16 Predict, quint8 Index)
+{
+	m_Predict = Predict;
+	m_Index = (Index > 88) ? 88 : Index;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Encodes one sample into a 4 bit code and updates the predictor
+//exactly the way the decoder will.
+//////////////////////////////////////////////////////////////////////
+inline quint8 CImaAdpcm::EncodeSample(int Sample)
+{
+int step = ADPCM_STEP_TABLE[m_Index];
+int diff = Sample - m_Predict;
+quint8 code = 0;
+	if(diff < 0)
+	{
+		code = 8;
+		diff = -diff;
+	}
+	//successive approximation of diff/step in 3 bits
+	int delta = step >> 3;
+	if(diff >= step)
+	{
+		code |= 4;
+		diff -= step;
+		delta += step;
+	}
+	step >>= 1;
+	if(diff >= step)
+	{
+		code |= 2;
+		diff -= step;
+		delta += step;
+	}
+	step >>= 1;
+	if(diff >= step)
+	{
+		code |= 1;
+		delta += step;
+	}
+	if(code & 8)
+		m_Predict -= delta;
+	else
+		m_Predict += delta;
+	if(m_Predict > 32767)
+		m_Predict = 32767;
+	else if(m_Predict < -32768)
+		m_Predict = -32768;
+	m_Index += ADPCM_INDEX_TABLE[code];
+	if(m_Index < 0)
+		m_Index = 0;
+	else if(m_Index > 88)
+		m_Index = 88;
+	return code;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Decodes one 4 bit code into a sample
+//////////////////////////////////////////////////////////////////////
+inline qint16 CImaAdpcm::DecodeSample(quint8 Code)
+{
+int step = ADPCM_STEP_TABLE[m_Index];
+int delta = step >> 3;
+	if(Code & 4)
+		delta += step;
+	if(Code & 2)
+		delta += (step >> 1);
+	if(Code & 1)
+		delta += (step >> 2);
+	if(Code & 8)
+		m_Predict -= delta;
+	else
+		m_Predict += delta;
+	if(m_Predict > 32767)
+		m_Predict = 32767;
+	else if(m_Predict < -32768)
+		m_Predict = -32768;
+	m_Index += ADPCM_INDEX_TABLE[Code];
+	if(m_Index < 0)
+		m_Index = 0;
+	else if(m_Index > 88)
+		m_Index = 88;
+	return (qint16)m_Predict;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Encodes NumSamples samples two per byte. An odd last sample is
+//padded with a zero code.
+//////////////////////////////////////////////////////////////////////
+int CImaAdpcm::Encode(const qint16* pIn, int NumSamples, quint8* pOut)
+{
+int i;
+	for(i=0; i<NumSamples-1; i+=2)
+	{
+		quint8 lo = EncodeSample(pIn[i]);
+		*pOut++ = lo | (EncodeSample(pIn[i+1]) << 4);
+	}
+	if(i < NumSamples)
+		*pOut = EncodeSample(pIn[i]);
+	return ADPCM_BYTES(NumSamples);
+}
+
+int CImaAdpcm::Decode(const quint8* pIn, int NumSamples, qint16* pOut)
+{
+	for(int i=0; i<NumSamples; i++)
+	{
+		quint8 code = (i & 1) ? (pIn[i>>1] >> 4) : (pIn[i>>1] & 0x0F);
+		pOut[i] = DecodeSample(code);
+	}
+	return NumSamples;
+}
+
+// *&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*
+
+//////////////////////////////////////////////////////////////////////
+// G.711 mu-law encoder
+//////////////////////////////////////////////////////////////////////
+int MuLawEncode(const qint16* pIn, int NumSamples, quint8* pOut)
+{
+	for(int i=0; i<NumSamples; i++)
+	{
+		int x = pIn[i];
+		int sign = 0;
+		if(x < 0)
+		{
+			x = -x;
+			sign = 0x80;
+		}
+		if(x > MULAW_CLIP)
+			x = MULAW_CLIP;
+		x += MULAW_BIAS;
+		int exponent = 7;
+		for(int mask = 0x4000; !(x & mask) && (exponent > 0); mask >>= 1)
+			exponent--;
+		int mantissa = (x >> (exponent + 3)) & 0x0F;
+		pOut[i] = ~(sign | (exponent << 4) | mantissa);
+	}
+	return NumSamples;
+}
+
+//////////////////////////////////////////////////////////////////////
+// G.711 mu-law decoder
+//////////////////////////////////////////////////////////////////////
+int MuLawDecode(const quint8* pIn, int NumSamples, qint16* pOut)
+{
+	for(int i=0; i<NumSamples; i++)
+	{
+		int u = ~pIn[i] & 0xFF;
+		int x = ( ((u & 0x0F) << 3) + MULAW_BIAS ) << ((u & 0x70) >> 4);
+		x -= MULAW_BIAS;
+		pOut[i] = (u & 0x80) ? -x : x;
+	}
+	return NumSamples;
+}
@@ -0,0 +1,83 @@
+//////////////////////////////////////////////////////////////////////
+// audiocodec.h: interface for the simple audio codecs used by the
+//  network audio streaming server.
+//
+//  CImaAdpcm  IMA/DVI ADPCM, 4 bits per sample(4:1 compression).
+//  MuLawEncode() MuLawDecode()  G.711 mu-law, 8 bits per sample.
+//
+// Both are sample at a time codecs with no look ahead so a frame of any
+//length can be encoded. The ADPCM state at the start of a frame can be
+//sent with the frame so a receiver can start decoding at any frame.
+//
+// History:
+//	2026-10-18  Initial creation
+//////////////////////////////////////////////////////////////////////
+//==========================================================================================
+// + + +   This Software is released under the "Simplified BSD License"  + + +
+//Copyright 2010 Moe Wheatley. All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification, are
+//permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice, this list of
+//	  conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice, this list
+//	  of conditions and the following disclaimer in the documentation and/or other materials
+//	  provided with the distribution.
+//
+//THIS SOFTWARE IS PROVIDED BY Moe Wheatley ``AS IS'' AND ANY EXPRESS OR IMPLIED
+//WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+//FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Moe Wheatley OR
+//CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+//ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+//ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//The views and conclusions contained in the software and documentation are those of the
+//authors and should not be interpreted as representing official policies, either expressed
+//or implied, of Moe Wheatley.
+//=============================================================================
+#ifndef AUDIOCODEC_H
+#define AUDIOCODEC_H
+
+#include <QtGlobal>
+
+//number of bytes needed to hold N encoded samples
+#define ADPCM_BYTES(N) (((N)+1)/2)
+#define MULAW_BYTES(N) (N)
+
+////////////
+//class for IMA ADPCM encoding and decoding
+////////////
+class CImaAdpcm
+{
+public:
+	CImaAdpcm(){Reset();}
+
+	void Reset(){m_Predict = 0; m_Index = 0;}
+	//state a decoder needs to start at the next sample
+	qint16 GetPredictor(){return (qint16)m_Predict;}
+	quint8 GetStepIndex(){return (quint8)m_Index;}
+	void SetState(qint16 Predict, quint8 Index);
+
+	//packs two samples per byte, first sample in the low nibble.
+	// Returns the number of bytes written
+	int Encode(const qint16* pIn, int NumSamples, quint8* pOut);
+	//NumSamples is the number of samples to decode, not the number of bytes
+	int Decode(const quint8* pIn, int NumSamples, qint16* pOut);
+
+private:
+	inline quint8 EncodeSample(int Sample);
+	inline qint16 DecodeSample(quint8 Code);
+	int m_Predict;
+	int m_Index;
+};
+
+//G.711 mu-law block encode/decode. Returns number of bytes or samples
+int MuLawEncode(const qint16* pIn, int NumSamples, quint8* pOut);
+int MuLawDecode(const quint8* pIn, int NumSamples, qint16* pOut);
+
+#endif // AUDIOCODEC_H
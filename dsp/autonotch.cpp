@@ -0,0 +1,158 @@
+//////////////////////////////////////////////////////////////////////
+// autonotch.cpp: implementation of the CAutoNotch class.
+//
+//  Normalized LMS adaptive line enhancer used as an automatic notch.
+//
+// History:
+//	2026-10-18  Initial creation
+//////////////////////////////////////////////////////////////////////
+//==========================================================================================
+// + + +   This Software is released under the "Simplified BSD License"  + + +
+//Copyright 2010 Moe Wheatley. All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification, are
+//permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice, this list of
+//	  conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice, this list
+//	  of conditions and the following disclaimer in the documentation and/or other materials
+//	  provided with the distribution.
+//
+//THIS SOFTWARE IS PROVIDED BY Moe Wheatley ``AS IS'' AND ANY EXPRESS OR IMPLIED
+//WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+//FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Moe Wheatley OR
+//CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+//ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+//ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//The views and conclusions contained in the software and documentation are those of the
+//authors and should not be interpreted as representing official policies, either expressed
+//or implied, of Moe Wheatley.
+//==========================================================================================
+#include "dsp/autonotch.h"
+#include "dsp/simdops.h"
+#include <string.h>
+
+#define ANOTCH_MU 0.01			//normalized step size
+#define ANOTCH_LEAK 0.99995		//weight leakage so notches fade when a tone goes away
+#define ANOTCH_EPS 1e-10
+
+//////////////////////////////////////////////////////////////////////
+// Construction/Destruction
+//////////////////////////////////////////////////////////////////////
+CAutoNotch::CAutoNotch()
+{
+	m_On = false;
+	m_NumTaps = 0;
+	m_SampleRate = 0.0;
+	Setup(false, ANOTCH_TAPS, 8000.0);
+}
+
+//////////////////////////////////////////////////////////////////////
+//	Sets the notch parameters. The filter is cleared if anything changes.
+//////////////////////////////////////////////////////////////////////
+void CAutoNotch::Setup(bool On, int NumTaps, TYPEREAL SampleRate)
+{
+	if(NumTaps < 4)
+		NumTaps = 4;
+	else if(NumTaps > ANOTCH_MAX_TAPS)
+		NumTaps = ANOTCH_MAX_TAPS;
+	if( (On == m_On) && (NumTaps == m_NumTaps) && (SampleRate == m_SampleRate) )
+		return;
+	m_On = On;
+	m_NumTaps = NumTaps;
+	m_SampleRate = SampleRate;
+	m_Delay = (int)(ANOTCH_DELAY_TIME*m_SampleRate + 0.5);
+	if(m_Delay < 1)
+		m_Delay = 1;
+	else if(m_Delay > ANOTCH_MAX_DELAY)
+		m_Delay = ANOTCH_MAX_DELAY;
+	m_PowerAlpha = 1.0/m_NumTaps;
+	Reset();
+}
+
+//////////////////////////////////////////////////////////////////////
+//	Clears the weights and history
+//////////////////////////////////////////////////////////////////////
+void CAutoNotch::Reset()
+{
+	memset(m_DelayBuf, 0, sizeof(m_DelayBuf));
+	memset(m_HistRe, 0, sizeof(m_HistRe));
+	memset(m_HistIm, 0, sizeof(m_HistIm));
+	memset(m_WRe, 0, sizeof(m_WRe));
+	memset(m_WIm, 0, sizeof(m_WIm));
+	m_DelayPos = 0;
+	m_HistPos = 0;
+	m_Power = 0.0;
+}
+
+//////////////////////////////////////////////////////////////////////
+//	Process real audio in place
+//////////////////////////////////////////////////////////////////////
+void CAutoNotch::ProcessData(int InLength, TYPEREAL* pData)
+{
+	if(!m_On)
+		return;
+	const int L = m_NumTaps;
+	for(int i=0; i<InLength; i++)
+	{
+		TYPEREAL x = pData[i];
+		//delayed input goes into both copies of the history ring
+		int dpos = (m_DelayPos - m_Delay) & (ANOTCH_MAX_DELAY-1);
+		TYPEREAL xd = m_DelayBuf[dpos].re;
+		m_DelayBuf[m_DelayPos].re = x;
+		m_DelayPos = (m_DelayPos + 1) & (ANOTCH_MAX_DELAY-1);
+		m_HistRe[m_HistPos] = xd;
+		m_HistRe[m_HistPos+L] = xd;
+		if(++m_HistPos >= L)
+			m_HistPos = 0;
+		const TYPEREAL* pX = &m_HistRe[m_HistPos];	//oldest to newest
+
+		m_Power += m_PowerAlpha*(xd*xd - m_Power);
+		TYPEREAL e = x - SimdDotProduct(pX, m_WRe, L);
+		TYPEREAL g = ANOTCH_MU/(L*m_Power + ANOTCH_EPS);
+		SimdLmsUpdate(m_WRe, pX, L, g*e, ANOTCH_LEAK);
+		pData[i] = e;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+//	Process complex data in place
+//////////////////////////////////////////////////////////////////////
+void CAutoNotch::ProcessData(int InLength, TYPECPX* pData)
+{
+	if(!m_On)
+		return;
+	const int L = m_NumTaps;
+	for(int i=0; i<InLength; i++)
+	{
+		TYPECPX x = pData[i];
+		int dpos = (m_DelayPos - m_Delay) & (ANOTCH_MAX_DELAY-1);
+		TYPECPX xd = m_DelayBuf[dpos];
+		m_DelayBuf[m_DelayPos] = x;
+		m_DelayPos = (m_DelayPos + 1) & (ANOTCH_MAX_DELAY-1);
+		m_HistRe[m_HistPos] = xd.re;
+		m_HistRe[m_HistPos+L] = xd.re;
+		m_HistIm[m_HistPos] = xd.im;
+		m_HistIm[m_HistPos+L] = xd.im;
+		if(++m_HistPos >= L)
+			m_HistPos = 0;
+		const TYPEREAL* pXRe = &m_HistRe[m_HistPos];
+		const TYPEREAL* pXIm = &m_HistIm[m_HistPos];
+
+		m_Power += m_PowerAlpha*(xd.re*xd.re + xd.im*xd.im - m_Power);
+		TYPECPX y;
+		SimdCpxDotProduct(pXRe, pXIm, m_WRe, m_WIm, L, y.re, y.im);
+		TYPECPX e;
+		e.re = x.re - y.re;
+		e.im = x.im - y.im;
+		TYPEREAL g = ANOTCH_MU/(L*m_Power + ANOTCH_EPS);
+		SimdCpxLmsUpdate(m_WRe, m_WIm, pXRe, pXIm, L, g*e.re, g*e.im, ANOTCH_LEAK);
+		pData[i] = e;
+	}
+}
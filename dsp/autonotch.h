@@ -0,0 +1,89 @@
+//////////////////////////////////////////////////////////////////////
+// autonotch.h: interface for the CAutoNotch class.
+//
+//  Automatic notch for carriers and heterodynes. It is an adaptive line
+// enhancer, a normalized LMS filter that predicts the input from a copy
+// delayed by about ANOTCH_DELAY_TIME. Noise and speech do not correlate
+// over the delay but steady tones do, so the prediction holds only the
+// tones and the prediction error is the output. It has no delay.
+//
+//  Complex baseband data uses complex weights so a tone needs only one
+// notch and the filter can remove tones above and below the center
+// independently. Real audio uses real weights.
+//
+//  The history is kept as separate I and Q planes written twice into a
+// ring of 2*NumTaps so the filter window is always contiguous for the
+// SIMD dot product and weight update kernels. Each sample costs two
+// passes over NumTaps taps.
+//
+// History:
+//	2026-10-18  Initial creation
+//////////////////////////////////////////////////////////////////////
+//==========================================================================================
+// + + +   This Software is released under the "Simplified BSD License"  + + +
+//Copyright 2010 Moe Wheatley. All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification, are
+//permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice, this list of
+//	  conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice, this list
+//	  of conditions and the following disclaimer in the documentation and/or other materials
+//	  provided with the distribution.
+//
+//THIS SOFTWARE IS PROVIDED BY Moe Wheatley ``AS IS'' AND ANY EXPRESS OR IMPLIED
+//WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+//FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Moe Wheatley OR
+//CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+//ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+//ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//The views and conclusions contained in the software and documentation are those of the
+//authors and should not be interpreted as representing official policies, either expressed
+//or implied, of Moe Wheatley.
+//==========================================================================================
+#ifndef AUTONOTCH_H
+#define AUTONOTCH_H
+
+#include "dsp/datatypes.h"
+
+#define ANOTCH_TAPS 64				//default filter length
+#define ANOTCH_MAX_TAPS 256
+#define ANOTCH_MAX_DELAY 64			//must be a power of 2
+#define ANOTCH_DELAY_TIME .0005		//decorrelation delay in seconds
+
+class CAutoNotch
+{
+public:
+	CAutoNotch();
+
+	void Setup(bool On, int NumTaps, TYPEREAL SampleRate);
+	bool IsOn(){return m_On;}
+	void Reset();
+
+	//process InLength samples in place
+	void ProcessData(int InLength, TYPEREAL* pData);
+	void ProcessData(int InLength, TYPECPX* pData);
+
+private:
+	bool m_On;
+	int m_NumTaps;
+	int m_Delay;
+	int m_DelayPos;
+	int m_HistPos;			//start of the filter window in m_HistRe/m_HistIm
+	TYPEREAL m_SampleRate;
+	TYPEREAL m_Power;		//average power of the delayed input
+	TYPEREAL m_PowerAlpha;
+	TYPECPX m_DelayBuf[ANOTCH_MAX_DELAY];
+	TYPEREAL m_HistRe[ANOTCH_MAX_TAPS*2];
+	TYPEREAL m_HistIm[ANOTCH_MAX_TAPS*2];
+	TYPEREAL m_WRe[ANOTCH_MAX_TAPS];
+	TYPEREAL m_WIm[ANOTCH_MAX_TAPS];
+};
+
+#endif // AUTONOTCH_H
@@ -0,0 +1,606 @@
+/////////////////////////////////////////////////////////////////////
+// cwskimmer.cpp: implementation of the CCwChannelizer, CCwCarrierDetect
+//  and CCwDecoder classes.
+//
+//	The channelizer is a Hann windowed FFT stepped by a quarter of its
+// length so each bin is a ~40Hz channel sampled about four times per
+// bin width, fast enough for 50 WPM dots. A carrier is a bin whose peak
+// power over a second is well above the median bin power and whose
+// average is well below its peak so steady carriers are not decoded.
+// Peaks far below a strong carrier close by are its keying sidebands.
+// The decoder tracks signal and noise levels for its keying threshold and
+// gets the speed from the two groups(dots and dashes) of recent marks.
+// The window stretches marks and shortens gaps by about the same amount
+// so the WPM reported uses the mark plus gap period which is unaffected.
+// History:
+//	2026-10-18  Initial creation
+/////////////////////////////////////////////////////////////////////
+//==========================================================================================
+// + + +   This Software is released under the "Simplified BSD License"  + + +
+//Copyright 2010 Moe Wheatley. All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification, are
+//permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice, this list of
+//	  conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice, this list
+//	  of conditions and the following disclaimer in the documentation and/or other materials
+//	  provided with the distribution.
+//
+//THIS SOFTWARE IS PROVIDED BY Moe Wheatley ``AS IS'' AND ANY EXPRESS OR IMPLIED
+//WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+//FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Moe Wheatley OR
+//CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+//ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+//ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//The views and conclusions contained in the software and documentation are those of the
+//authors and should not be interpreted as representing official policies, either expressed
+//or implied, of Moe Wheatley.
+//==========================================================================================
+#include "dsp/cwskimmer.h"
+#include <string.h>
+#include <algorithm>
+#include <QDebug>
+
+#define DEC_ATTACK 0.2			//level tracking fast time constant in frames
+#define DEC_SIG_DECAY 1.5		//signal level decay time in seconds
+#define DEC_NOISE_RISE 3.0		//noise level rise time in seconds
+#define DEC_MIN_SNR 2.5			//signal to noise amplitude ratio needed to key
+#define DEC_START_WPM 20.0
+#define DEC_MIN_WPM 5.0
+#define DEC_MAX_WPM 60.0
+
+static const struct
+{
+	char Ch;
+	const char* pCode;
+}MORSE_TABLE[] =
+{
+	{'A', ".-"}, {'B', "-..."}, {'C', "-.-."}, {'D', "-.."}, {'E', "."},
+	{'F', "..-."}, {'G', "--."}, {'H', "...."}, {'I', ".."}, {'J', ".---"},
+	{'K', "-.-"}, {'L', ".-.."}, {'M', "--"}, {'N', "-."}, {'O', "---"},
+	{'P', ".--."}, {'Q', "--.-"}, {'R', ".-."}, {'S', "..."}, {'T', "-"},
+	{'U', "..-"}, {'V', "...-"}, {'W', ".--"}, {'X', "-..-"}, {'Y', "-.--"},
+	{'Z', "--.."},
+	{'0', "-----"}, {'1', ".----"}, {'2', "..---"}, {'3', "...--"}, {'4', "....-"},
+	{'5', "....."}, {'6', "-...."}, {'7', "--..."}, {'8', "---.."}, {'9', "----."},
+	{'/', "-..-."}, {'?', "..--.."}, {'=', "-...-"}, {'.', ".-.-.-"}, {',', "--..--"},
+	{'+', ".-.-."}
+};
+#define MORSE_TABLE_SIZE (int)(sizeof(MORSE_TABLE)/sizeof(MORSE_TABLE[0]))
+
+/////////////////////////////////////////////////////////////////////////////////
+//	Construct channelizer object
+/////////////////////////////////////////////////////////////////////////////////
+CCwChannelizer::CCwChannelizer()
+{
+	m_SampleRate = 1.0;
+	m_FftSize = 0;
+	m_HopSize = 1;
+	m_FirstBin = 0;
+	m_LastBin = -1;
+	m_pWindow = NULL;
+	m_pPower = NULL;
+	m_pHistory = NULL;
+	m_pFftBuf = NULL;
+}
+
+CCwChannelizer::~CCwChannelizer()
+{
+	FreeMemory();
+}
+
+void CCwChannelizer::FreeMemory()
+{
+	if(m_pWindow)
+		delete [] m_pWindow;
+	if(m_pPower)
+		delete [] m_pPower;
+	if(m_pHistory)
+		delete [] m_pHistory;
+	if(m_pFftBuf)
+		delete [] m_pFftBuf;
+	m_pWindow = NULL;
+	m_pPower = NULL;
+	m_pHistory = NULL;
+	m_pFftBuf = NULL;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//	Pick the power of 2 FFT size closest to CWSK_BIN_WIDTH bins and
+//allocate the buffers for it
+/////////////////////////////////////////////////////////////////////////////////
+void CCwChannelizer::Init(TYPEREAL SampleRate)
+{
+	m_SampleRate = SampleRate;
+	int size = MIN_FFT_SIZE;
+	while( (size < MAX_FFT_SIZE) && (SampleRate/size > CWSK_BIN_WIDTH*1.414) )
+		size *= 2;
+	if(size != m_FftSize)
+	{
+		FreeMemory();
+		m_FftSize = size;
+		m_pWindow = new TYPEREAL[m_FftSize];
+		m_pPower = new TYPEREAL[m_FftSize];
+		m_pHistory = new TYPECPX[m_FftSize];
+		m_pFftBuf = new TYPECPX[m_FftSize];
+	}
+	m_HopSize = m_FftSize/CWSK_OVERLAP;
+	int half = (int)(m_FftSize*CWSK_USABLE_BW/2.0);
+	m_FirstBin = m_FftSize/2 - half;
+	m_LastBin = m_FftSize/2 + half;
+	m_Fft.SetFFTParams(m_FftSize, false, 0.0, SampleRate);
+	for(int i=0; i<m_FftSize; i++)
+	{	//Hann window
+		m_pWindow[i] = 0.5 - 0.5*MCOS( (K_2PI*i)/(m_FftSize-1) );
+		m_pPower[i] = 0.0;
+		m_pHistory[i].re = 0.0;
+		m_pHistory[i].im = 0.0;
+	}
+qDebug()<<"CW channelizer FFT size="<<m_FftSize<<" Bin width="<<GetBinWidth()<<" Frame rate="<<GetFrameRate();
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//	Shift in a hop of new samples and calculate the channel powers
+/////////////////////////////////////////////////////////////////////////////////
+const TYPEREAL* CCwChannelizer::ProcessFrame(const TYPECPX* pInData)
+{
+	int keep = m_FftSize - m_HopSize;
+	memmove(m_pHistory, &m_pHistory[m_HopSize], keep*sizeof(TYPECPX));
+	memcpy(&m_pHistory[keep], pInData, m_HopSize*sizeof(TYPECPX));
+	for(int i=0; i<m_FftSize; i++)
+	{
+		m_pFftBuf[i].re = m_pHistory[i].re*m_pWindow[i];
+		m_pFftBuf[i].im = m_pHistory[i].im*m_pWindow[i];
+	}
+	m_Fft.FwdFFT(m_pFftBuf);
+	//CFft puts positive frequency k in bin N-k so flip it here with
+	//-SampleRate/2 at index 0
+	int mask = m_FftSize - 1;
+	for(int j=m_FirstBin; j<=m_LastBin; j++)
+	{
+		const TYPECPX& x = m_pFftBuf[(m_FftSize + m_FftSize/2 - j) & mask];
+		m_pPower[j] = x.re*x.re + x.im*x.im;
+	}
+	return m_pPower;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//	Construct carrier detector object
+/////////////////////////////////////////////////////////////////////////////////
+CCwCarrierDetect::CCwCarrierDetect()
+{
+	m_FirstBin = 0;
+	m_LastBin = -1;
+	m_NumFrames = 0;
+	m_FrameLimit = 1;
+	m_MaskBins = 1;
+	m_NumCarriers = 0;
+	m_pAve = NULL;
+	m_pPeak = NULL;
+	m_pSorted = NULL;
+}
+
+CCwCarrierDetect::~CCwCarrierDetect()
+{
+	FreeMemory();
+}
+
+void CCwCarrierDetect::FreeMemory()
+{
+	if(m_pAve)
+		delete [] m_pAve;
+	if(m_pPeak)
+		delete [] m_pPeak;
+	if(m_pSorted)
+		delete [] m_pSorted;
+	m_pAve = NULL;
+	m_pPeak = NULL;
+	m_pSorted = NULL;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//	Set the channelizer bins searched and clear the averages
+/////////////////////////////////////////////////////////////////////////////////
+void CCwCarrierDetect::Init(int FirstBin, int LastBin, TYPEREAL FrameRate, TYPEREAL BinWidth)
+{
+	FreeMemory();
+	m_FirstBin = FirstBin;
+	m_LastBin = LastBin;
+	int n = m_LastBin - m_FirstBin + 1;
+	m_pAve = new TYPEREAL[n];
+	m_pPeak = new TYPEREAL[n];
+	m_pSorted = new TYPEREAL[n];
+	for(int k=0; k<n; k++)
+	{
+		m_pAve[k] = 0.0;
+		m_pPeak[k] = 0.0;
+	}
+	m_MaskBins = (int)(CWSK_MASK_BW/BinWidth + 0.5);
+	m_FrameLimit = (int)(CWSK_DETECT_TIME*FrameRate + 0.5);
+	if(m_FrameLimit < 1)
+		m_FrameLimit = 1;
+	m_NumFrames = 0;
+	m_NumCarriers = 0;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//	Accumulate average and peak channel power and search for carriers
+//every CWSK_DETECT_TIME
+/////////////////////////////////////////////////////////////////////////////////
+bool CCwCarrierDetect::ProcessFrame(const TYPEREAL* pPower)
+{
+	int n = m_LastBin - m_FirstBin + 1;
+	const TYPEREAL* pIn = &pPower[m_FirstBin];
+	for(int k=0; k<n; k++)
+	{
+		TYPEREAL p = pIn[k];
+		m_pAve[k] += p;
+		if(p > m_pPeak[k])
+			m_pPeak[k] = p;
+	}
+	if(++m_NumFrames < m_FrameLimit)
+		return false;
+	FindCarriers();
+	for(int k=0; k<n; k++)
+	{
+		m_pAve[k] = 0.0;
+		m_pPeak[k] = 0.0;
+	}
+	m_NumFrames = 0;
+	return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//	Pick the keyed carriers that are well above the noise
+/////////////////////////////////////////////////////////////////////////////////
+void CCwCarrierDetect::FindCarriers()
+{
+	int n = m_LastBin - m_FirstBin + 1;
+	m_NumCarriers = 0;
+	if(n < 8)
+		return;
+	for(int k=0; k<n; k++)
+	{
+		m_pAve[k] /= m_NumFrames;
+		m_pSorted[k] = m_pAve[k];
+	}
+	//noise floor is the median channel power
+	std::nth_element(m_pSorted, m_pSorted + n/2, m_pSorted + n);
+	TYPEREAL Threshold = m_pSorted[n/2]*MPOW(10.0, CWSK_DETECT_SNR/10.0);
+	TYPEREAL MaskRatio = MPOW(10.0, CWSK_MASK_DB/10.0);
+
+	for(int k=2; k<n-2; k++)
+	{
+		TYPEREAL pwr = m_pPeak[k];
+		if( (pwr <= Threshold) || (m_pAve[k] > CWSK_MAX_DUTY*pwr) )
+			continue;
+		//must be the largest peak within +/- 2 bins(Hann window main lobe)
+		bool peak = true;
+		for(int j=k-2; j<=k+2 && peak; j++)
+		{
+			if(j == k)
+				continue;
+			if( (m_pPeak[j] > pwr) || ((j < k) && (m_pPeak[j] == pwr)) )
+				peak = false;
+		}
+		if(!peak)
+			continue;
+		//skip if it is a sideband of a much stronger carrier
+		int jmin = (k - m_MaskBins < 0) ? 0 : k - m_MaskBins;
+		int jmax = (k + m_MaskBins > n-1) ? n-1 : k + m_MaskBins;
+		for(int j=jmin; j<=jmax && peak; j++)
+		{
+			if(m_pPeak[j] > MaskRatio*pwr)
+				peak = false;
+		}
+		if(!peak)
+			continue;
+		//parabolic interpolation of the peak position
+		TYPEREAL a = m_pPeak[k-1];
+		TYPEREAL c = m_pPeak[k+1];
+		TYPEREAL den = a - 2.0*pwr + c;
+		TYPEREAL delta = (den < 0.0) ? 0.5*(a - c)/den : 0.0;
+		if(delta > 0.5)
+			delta = 0.5;
+		else if(delta < -0.5)
+			delta = -0.5;
+		//insert in list sorted by power, dropping the weakest if full
+		int pos = m_NumCarriers;
+		while( (pos > 0) && (m_CarrierPwr[pos-1] < pwr) )
+			pos--;
+		if(pos >= CWSK_MAX_CHANNELS)
+			continue;
+		int last = (m_NumCarriers < CWSK_MAX_CHANNELS) ? m_NumCarriers : CWSK_MAX_CHANNELS-1;
+		for(int i=last; i>pos; i--)
+		{
+			m_Carriers[i] = m_Carriers[i-1];
+			m_CarrierPwr[i] = m_CarrierPwr[i-1];
+		}
+		m_Carriers[pos] = m_FirstBin + k + delta;
+		m_CarrierPwr[pos] = pwr;
+		if(m_NumCarriers < CWSK_MAX_CHANNELS)
+			m_NumCarriers++;
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//	Get the carriers found by the last search
+/////////////////////////////////////////////////////////////////////////////////
+int CCwCarrierDetect::GetCarriers(TYPEREAL* pBins, int MaxCarriers)
+{
+	int n = m_NumCarriers;
+	if(n > MaxCarriers)
+		n = MaxCarriers;
+	for(int i=0; i<n; i++)
+		pBins[i] = m_Carriers[i];
+	return n;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//	Construct Morse decoder object
+/////////////////////////////////////////////////////////////////////////////////
+CCwDecoder::CCwDecoder()
+{
+	Init(100.0);
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//	Reset the decoder for a new signal
+/////////////////////////////////////////////////////////////////////////////////
+void CCwDecoder::Init(TYPEREAL FrameRate)
+{
+	m_FrameRate = FrameRate;
+	m_SigLevel = 0.0;
+	m_NoiseLevel = 0.0;
+	m_SigDecay = 1.0/(DEC_SIG_DECAY*FrameRate);
+	m_NoiseRise = 1.0/(DEC_NOISE_RISE*FrameRate);
+	//dot length in seconds is 1.2/WPM
+	m_DotLen = 1.2*FrameRate/DEC_START_WPM;
+	m_UnitLen = m_DotLen;
+	m_LastMark = 0.0;
+	m_LastWasDot = true;
+	m_MinDotLen = 1.2*FrameRate/DEC_MAX_WPM;
+	m_MaxDotLen = 1.2*FrameRate/DEC_MIN_WPM;
+	m_PendingMark = 0.0;
+	m_KeyDown = false;
+	m_WordPending = false;
+	m_Count = 0;
+	m_IdleCount = 0;
+	m_LossLimit = (int)(CWSK_LOSS_TIME*FrameRate);
+	m_NumMarks = 0;
+	m_MarkPos = 0;
+	m_NumElements = 0;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//	Key the channel power and turn the mark and space lengths into
+//characters
+/////////////////////////////////////////////////////////////////////////////////
+int CCwDecoder::ProcessData(int Length, const TYPEREAL* pPower, quint8* pChars)
+{
+int NumChars = 0;
+	for(int i=0; i<Length; i++)
+	{
+		TYPEREAL a = MSQRT(pPower[i]);
+		if( (0.0 == m_SigLevel) && (0.0 == m_NoiseLevel) )
+		{	//first sample
+			m_SigLevel = a;
+			m_NoiseLevel = a;
+		}
+		//signal level has fast attack slow decay, noise level fast decay slow rise
+		if(a > m_SigLevel)
+			m_SigLevel += DEC_ATTACK*(a - m_SigLevel);
+		else
+			m_SigLevel += m_SigDecay*(a - m_SigLevel);
+		if(a < m_NoiseLevel)
+			m_NoiseLevel += DEC_ATTACK*(a - m_NoiseLevel);
+		else
+			m_NoiseLevel += m_NoiseRise*(a - m_NoiseLevel);
+		bool valid = m_SigLevel > DEC_MIN_SNR*m_NoiseLevel;
+		TYPEREAL span = m_SigLevel - m_NoiseLevel;
+
+		m_Count++;
+		if(m_KeyDown)
+		{
+			if( !valid || (a < m_NoiseLevel + 0.4*span) )
+			{	//key up
+				m_KeyDown = false;
+				m_PendingMark = m_Count;
+				m_Count = 0;
+			}
+			continue;
+		}
+		if( valid && (a > m_NoiseLevel + 0.6*span) )
+		{	//key down
+			m_KeyDown = true;
+			m_IdleCount = 0;
+			if(m_PendingMark > 0.0)
+			{	//gap was too short to be real so join it to the last mark
+				m_Count += m_PendingMark;
+				m_PendingMark = 0.0;
+			}
+			else
+			{
+				if(m_NumElements > 0)
+				{	//element period is 2 dots after a dot and 4 after a dash
+					TYPEREAL unit = (m_LastMark + m_Count)/(m_LastWasDot ? 2.0 : 4.0);
+					m_UnitLen += 0.2*(unit - m_UnitLen);
+				}
+				m_Count = 1;
+			}
+			continue;
+		}
+		m_IdleCount++;
+		if( (m_PendingMark > 0.0) && (m_Count > 0.25*m_DotLen) )
+		{
+			AddMark(m_PendingMark);
+			m_PendingMark = 0.0;
+		}
+		if( (m_NumElements > 0) && (0.0 == m_PendingMark) && (m_Count > 2.0*m_DotLen) )
+		{	//gap of more than 2 dots ends the character
+			quint8 ch = EndChar();
+			if(ch)
+			{
+				pChars[NumChars++] = ch;
+				m_WordPending = true;
+			}
+		}
+		else if( m_WordPending && (m_Count > 5.0*m_DotLen) )
+		{	//gap of more than 5 dots ends the word
+			pChars[NumChars++] = ' ';
+			m_WordPending = false;
+		}
+	}
+	return NumChars;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//	Update the speed estimate with a new mark and save it as a dot or dash
+/////////////////////////////////////////////////////////////////////////////////
+void CCwDecoder::AddMark(TYPEREAL Length)
+{
+	if(Length < 0.3*m_DotLen)
+		return;		//ignore noise spikes
+	m_Marks[m_MarkPos] = Length;
+	if(++m_MarkPos >= CWSK_MARK_HIST)
+		m_MarkPos = 0;
+	if(m_NumMarks < CWSK_MARK_HIST)
+		m_NumMarks++;
+	TYPEREAL min = m_Marks[0];
+	TYPEREAL max = m_Marks[0];
+	TYPEREAL sum = 0.0;
+	for(int i=0; i<m_NumMarks; i++)
+	{
+		if(m_Marks[i] < min)
+			min = m_Marks[i];
+		if(m_Marks[i] > max)
+			max = m_Marks[i];
+		sum += m_Marks[i];
+	}
+	if(max > 2.0*min)
+	{	//split the marks into dots and dashes
+		TYPEREAL thresh = (min + max)/2.0;
+		TYPEREAL dot = min;
+		TYPEREAL dash = max;
+		for(int iter=0; iter<3; iter++)
+		{
+			TYPEREAL s1 = 0.0;
+			TYPEREAL s2 = 0.0;
+			int n1 = 0;
+			int n2 = 0;
+			for(int i=0; i<m_NumMarks; i++)
+			{
+				if(m_Marks[i] < thresh)
+				{
+					s1 += m_Marks[i];
+					n1++;
+				}
+				else
+				{
+					s2 += m_Marks[i];
+					n2++;
+				}
+			}
+			dot = s1/n1;	//never empty since min < thresh <= max
+			dash = s2/n2;
+			thresh = (dot + dash)/2.0;
+		}
+		m_DotLen = (dot + dash/3.0)/2.0;
+	}
+	else if(sum/m_NumMarks < 2.0*m_DotLen)
+	{	//only dots seen lately
+		m_DotLen = sum/m_NumMarks;
+	}
+	if(m_DotLen < m_MinDotLen)
+		m_DotLen = m_MinDotLen;
+	else if(m_DotLen > m_MaxDotLen)
+		m_DotLen = m_MaxDotLen;
+	m_LastMark = Length;
+	m_LastWasDot = Length < 2.0*m_DotLen;
+	if(m_NumElements < (int)sizeof(m_Elements)-1)
+		m_Elements[m_NumElements++] = m_LastWasDot ? '.' : '-';
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//	Look up the character for the saved elements. Returns 0 if unknown.
+/////////////////////////////////////////////////////////////////////////////////
+quint8 CCwDecoder::EndChar()
+{
+	m_Elements[m_NumElements] = 0;
+	m_NumElements = 0;
+	for(int i=0; i<MORSE_TABLE_SIZE; i++)
+	{
+		if( 0 == strcmp(MORSE_TABLE[i].pCode, m_Elements) )
+			return MORSE_TABLE[i].Ch;
+	}
+	return 0;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//	Returns the Morse code for ch or NULL
+/////////////////////////////////////////////////////////////////////////////////
+const char* CCwDecoder::GetMorse(char ch)
+{
+	if( (ch >= 'a') && (ch <= 'z') )
+		ch = ch - 'a' + 'A';
+	for(int i=0; i<MORSE_TABLE_SIZE; i++)
+	{
+		if(MORSE_TABLE[i].Ch == ch)
+			return MORSE_TABLE[i].pCode;
+	}
+	return NULL;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//	Checks if a word looks like a callsign:
+// prefix(A, AB, 2A or A2) + digit + 1 to 4 letter suffix with an optional
+// /portable designator.
+/////////////////////////////////////////////////////////////////////////////////
+static bool IsLetter(char c){return (c >= 'A') && (c <= 'Z');}
+static bool IsDigit(char c){return (c >= '0') && (c <= '9');}
+
+bool CCwDecoder::IsCallSign(const char* pWord)
+{
+	int len = strlen(pWord);
+	if( (len < 3) || (len > CWSK_MAX_WORD) )
+		return false;
+	const char* pSlash = strchr(pWord, '/');
+	int n = pSlash ? (int)(pSlash - pWord) : len;
+	if(pSlash)
+	{	//portable designator must be 1 to 4 letters or digits
+		int m = len - n - 1;
+		if( (m < 1) || (m > 4) )
+			return false;
+		for(int i=n+1; i<len; i++)
+		{
+			if( !IsLetter(pWord[i]) && !IsDigit(pWord[i]) )
+				return false;
+		}
+	}
+	for(int p=1; p<=2; p++)
+	{
+		int suffix = n - p - 1;
+		if( (suffix < 1) || (suffix > 4) )
+			continue;
+		bool ok;
+		if(1 == p)
+			ok = IsLetter(pWord[0]);
+		else
+			ok = (IsLetter(pWord[0]) || IsDigit(pWord[0])) &&
+				 (IsLetter(pWord[1]) || IsDigit(pWord[1])) &&
+				 !(IsDigit(pWord[0]) && IsDigit(pWord[1]));
+		ok = ok && IsDigit(pWord[p]);
+		for(int i=p+1; (i<n) && ok; i++)
+			ok = IsLetter(pWord[i]);
+		if(ok)
+			return true;
+	}
+	return false;
+}
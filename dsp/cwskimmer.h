@@ -0,0 +1,175 @@
+//////////////////////////////////////////////////////////////////////
+// cwskimmer.h: interface for the CCwChannelizer, CCwCarrierDetect and
+//  CCwDecoder classes.
+//
+//  CCwChannelizer  splits the full I/Q bandwidth into narrow channels
+//		with one overlapped FFT per frame.
+//  CCwCarrierDetect  finds keyed carriers in the channel power frames.
+//  CCwDecoder  decodes Morse from the power of one channel with
+//		adaptive threshold and speed.
+//
+// History:
+//	2026-10-18  Initial creation
+//////////////////////////////////////////////////////////////////////
+//==========================================================================================
+// + + +   This Software is released under the "Simplified BSD License"  + + +
+//Copyright 2010 Moe Wheatley. All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification, are
+//permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice, this list of
+//	  conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice, this list
+//	  of conditions and the following disclaimer in the documentation and/or other materials
+//	  provided with the distribution.
+//
+//THIS SOFTWARE IS PROVIDED BY Moe Wheatley ``AS IS'' AND ANY EXPRESS OR IMPLIED
+//WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+//FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Moe Wheatley OR
+//CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+//ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+//ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//The views and conclusions contained in the software and documentation are those of the
+//authors and should not be interpreted as representing official policies, either expressed
+//or implied, of Moe Wheatley.
+//=============================================================================
+#ifndef CWSKIMMER_H
+#define CWSKIMMER_H
+#include "dsp/datatypes.h"
+#include "dsp/fft.h"
+
+#define CWSK_BIN_WIDTH 40.0		//target channel bandwidth in Hz
+#define CWSK_OVERLAP 4			//FFT frames computed per FFT length
+#define CWSK_USABLE_BW 0.9		//fraction of the I/Q bandwidth searched for carriers
+#define CWSK_MAX_CHANNELS 256	//most signals decoded at once
+#define CWSK_DETECT_TIME 1.0	//seconds of frames used for each carrier search
+#define CWSK_DETECT_SNR 12.0	//peak to median noise power ratio needed in dB
+#define CWSK_MAX_DUTY 0.8		//average to peak power above this is a steady carrier
+#define CWSK_MASK_BW 2500.0		//keying sidebands of a strong carrier extend this far in Hz
+#define CWSK_MASK_DB 30.0		//peaks this far below a nearby strong carrier are its sidebands
+#define CWSK_LOSS_TIME 10.0		//seconds without keying before a decoder is freed
+#define CWSK_MAX_WORD 15		//longest word kept by a decoder
+#define CWSK_MARK_HIST 16		//marks used to estimate the speed
+
+////////////
+//class for the FFT channelizer
+////////////
+class CCwChannelizer
+{
+public:
+	CCwChannelizer();
+	~CCwChannelizer();
+
+	void Init(TYPEREAL SampleRate);
+	int GetFftSize(){return m_FftSize;}
+	int GetHopSize(){return m_HopSize;}
+	int GetFirstBin(){return m_FirstBin;}
+	int GetLastBin(){return m_LastBin;}
+	TYPEREAL GetFrameRate(){return m_SampleRate/m_HopSize;}
+	TYPEREAL GetBinWidth(){return m_SampleRate/m_FftSize;}
+	//frequency offset from the I/Q center of a (fractional) bin
+	TYPEREAL GetBinFreq(TYPEREAL Bin){return (Bin - m_FftSize/2)*m_SampleRate/m_FftSize;}
+
+	//Adds GetHopSize() new samples and returns the power of each channel
+	// over the last GetFftSize() samples. Bin 0 is -SampleRate/2.
+	// Only bins GetFirstBin() to GetLastBin() are calculated.
+	const TYPEREAL* ProcessFrame(const TYPECPX* pInData);
+
+private:
+	void FreeMemory();
+	TYPEREAL m_SampleRate;
+	int m_FftSize;
+	int m_HopSize;
+	int m_FirstBin;
+	int m_LastBin;
+	TYPEREAL* m_pWindow;
+	TYPEREAL* m_pPower;
+	TYPECPX* m_pHistory;	//last m_FftSize input samples
+	TYPECPX* m_pFftBuf;
+	CFft m_Fft;
+};
+
+////////////
+//class that finds keyed carriers in the channelizer output
+////////////
+class CCwCarrierDetect
+{
+public:
+	CCwCarrierDetect();
+	~CCwCarrierDetect();
+
+	void Init(int FirstBin, int LastBin, TYPEREAL FrameRate, TYPEREAL BinWidth);
+	//returns true when a new carrier list is ready
+	bool ProcessFrame(const TYPEREAL* pPower);
+	//copies up to MaxCarriers fractional bin positions(strongest first) into pBins
+	int GetCarriers(TYPEREAL* pBins, int MaxCarriers);
+
+private:
+	void FindCarriers();
+	void FreeMemory();
+	int m_FirstBin;
+	int m_LastBin;
+	int m_NumFrames;
+	int m_FrameLimit;
+	int m_MaskBins;
+	int m_NumCarriers;
+	TYPEREAL m_Carriers[CWSK_MAX_CHANNELS];
+	TYPEREAL m_CarrierPwr[CWSK_MAX_CHANNELS];
+	TYPEREAL* m_pAve;		//summed power indexed from m_FirstBin
+	TYPEREAL* m_pPeak;		//peak power indexed from m_FirstBin
+	TYPEREAL* m_pSorted;
+};
+
+////////////
+//class for the Morse decoder of one channel
+////////////
+class CCwDecoder
+{
+public:
+	CCwDecoder();
+
+	void Init(TYPEREAL FrameRate);	//reset to start on a new signal
+	//Decodes Length channel power samples. Puts decoded characters in
+	//pChars(needs room for Length characters) with a space after each word.
+	//Returns the number of characters.
+	int ProcessData(int Length, const TYPEREAL* pPower, quint8* pChars);
+	int GetWpm(){return (int)(1.2*m_FrameRate/m_UnitLen + 0.5);}
+	bool IsLost(){return m_IdleCount >= m_LossLimit;}
+
+	static const char* GetMorse(char ch);	//returns ".-" style code or NULL
+	static bool IsCallSign(const char* pWord);
+
+private:
+	void AddMark(TYPEREAL Length);
+	quint8 EndChar();
+	TYPEREAL m_FrameRate;
+	TYPEREAL m_SigLevel;
+	TYPEREAL m_NoiseLevel;
+	TYPEREAL m_SigDecay;
+	TYPEREAL m_NoiseRise;
+	TYPEREAL m_DotLen;		//dot length in frames used to classify marks and gaps
+	TYPEREAL m_UnitLen;		//dot length in frames from the mark+gap periods
+	TYPEREAL m_LastMark;
+	TYPEREAL m_MinDotLen;
+	TYPEREAL m_MaxDotLen;
+	TYPEREAL m_PendingMark;	//mark waiting to see if the following gap is real
+	TYPEREAL m_Marks[CWSK_MARK_HIST];
+	bool m_KeyDown;
+	bool m_LastWasDot;
+	bool m_WordPending;
+	int m_Count;			//frames in current key state
+	int m_IdleCount;		//frames since key was last down
+	int m_LossLimit;
+	int m_NumMarks;
+	int m_MarkPos;
+	int m_NumElements;
+	char m_Elements[8];
+};
+
+#endif // CWSKIMMER_H
@@ -5,6 +5,7 @@
 //	2010-09-15  Initial creation MSW
 //	2011-03-27  Initial release
 //	2013-07-28  Added single/double precision math macros
+//	2026-10-18  Added tPrecision policy for classes templated on precision
 //////////////////////////////////////////////////////////////////////
 #ifndef DATATYPES_H
 #define DATATYPES_H
@@ -115,6 +116,38 @@ typedef union
  #define MATAN2(x,y) atan2f(x,y)
 #endif
 
+//precision policy for DSP classes templated on their sample type so
+// float and double versions can be used in the same program.
+// tPrecision<T>::Cpx is the complex type and the math functions match T
+// the way the M... macros match TYPEREAL.
+template <typename T> struct tPrecision;
+
+template <> struct tPrecision<tSReal>
+{
+	typedef tSComplex Cpx;
+	static tSReal Sin(tSReal x){return sinf(x);}
+	static tSReal Cos(tSReal x){return cosf(x);}
+	static tSReal Pow(tSReal x, tSReal y){return powf(x,y);}
+	static tSReal Sqrt(tSReal x){return sqrtf(x);}
+	static tSReal Atan(tSReal x){return atanf(x);}
+	static tSReal Log10(tSReal x){return log10f(x);}
+	static tSReal Fabs(tSReal x){return fabsf(x);}
+	static tSReal Exp(tSReal x){return expf(x);}
+};
+
+template <> struct tPrecision<tDReal>
+{
+	typedef tDComplex Cpx;
+	static tDReal Sin(tDReal x){return sin(x);}
+	static tDReal Cos(tDReal x){return cos(x);}
+	static tDReal Pow(tDReal x, tDReal y){return pow(x,y);}
+	static tDReal Sqrt(tDReal x){return sqrt(x);}
+	static tDReal Atan(tDReal x){return atan(x);}
+	static tDReal Log10(tDReal x){return log10(x);}
+	static tDReal Fabs(tDReal x){return fabs(x);}
+	static tDReal Exp(tDReal x){return exp(x);}
+};
+
 #define TYPESTEREO16 tStereo16
 #define TYPEMONO16 qint16
 
@@ -9,6 +9,18 @@
 //	2010-09-15  Initial creation MSW
 //	2011-03-27  Initial release
 //	2013-07-28  Added single/double precision math macros
+//	2026-10-18  Added multi-channel PSK mode
+//	2026-10-18  Added multi-channel DSC FSK mode
+//	2026-10-18  Added squelch gate and CPU counters
+//	2026-10-18  Added spectral noise reduction of the audio
+//	2026-10-18  Added LMS auto notch
+//	2026-10-18  Demods come from a pool created with the object
+//	2026-10-18  Runtime settings are passed to the DSP thread in a snapshot
+//	2026-10-18  Work buffers come from a scratch arena sized from the input rate
+//	2026-10-18  Stats report the memory held by the demods
+//	2026-10-18  Leaving WFM frees its stereo buffers and RDS thread
+//	2026-10-18  Mode and sample rate changes are published to ProcessData() too
+//	2026-10-18  Decimation stages are built by the setters and handed over in the snapshot
 /////////////////////////////////////////////////////////////////////
 //==========================================================================================
 // + + +   This Software is released under the "Simplified BSD License"  + + +
@@ -41,19 +53,17 @@
 #include "dsp/demodulator.h"
 #include "gui/testbench.h"
 #include <QDebug>
+#include <string.h>
 
 //////////////////////////////////////////////////////////////////
 //	Constructor/Destructor
 //////////////////////////////////////////////////////////////////
-CDemodulator::CDemodulator()
+CDemodulator::CDemodulator() : m_Scratch("Demodulator")
 {
+	m_InputRate = 0.0;
 	m_DesiredMaxOutputBandwidth = 48000.0;
 	m_DownConverterOutputRate = 48000.0;
 	m_DemodOutputRate = 48000.0;
-	m_pDemodInBuf = new TYPECPX[MAX_INBUFSIZE];
-	m_pDemodTmpBuf = new TYPECPX[MAX_INBUFSIZE];
-	m_InBufPos = 0;
-	m_InBufLimit = 1000;
 	m_DemodMode = -1;
 	m_pAmDemod = NULL;
 	m_pSamDemod = NULL;
@@ -61,42 +71,97 @@ CDemodulator::CDemodulator()
 	m_pFmDemod = NULL;
 	m_pWFmDemod = NULL;
 	m_pPskDemod = NULL;
+	m_pFskDemod = NULL;
+	m_pMultiPskDemod = NULL;
+	m_pMultiFskDemod = NULL;
+	m_Pool.pAm = new CAmDemod(DEMOD_POOL_RATE);
+	m_Pool.pSam = new CSamDemod(DEMOD_POOL_RATE);
+	m_Pool.pFm = new CFmDemod(DEMOD_POOL_RATE);
+	m_Pool.pWFm = new CWFmDemod(WFM_POOL_RATE);
+	m_Pool.pPsk = new CPskDemod();
+	m_Pool.pFsk = new CFskDemod(DEMOD_POOL_RATE);
+	m_Pool.pSsb = new CSsbDemod();
 	m_USFm = true;
+	m_MultiPsk = false;
+	m_MultiFsk = false;
 	m_PskRate = 31.25;
+	m_SquelchGate = false;
+	m_OutputSilent = false;
+	m_NoiseReduceOn = false;
+	m_NoiseReduceLevel = 15;
+	m_AutoNotchOn = false;
+	tDEMOD_PARAMS Params;
+	Params.Mode = m_DemodMode;
+	Params.InputRate = m_InputRate;
+	Params.Info.LowCutmin = 0;	//read by PublishParams() before the first SetDemod()
+	Params.Info.HiCutmax = 0;
+	Params.InfoSeq = 0;
+	Params.MultiPsk = m_MultiPsk;
+	Params.PskRate = m_PskRate;
+	Params.MultiFsk = m_MultiFsk;
+	Params.USFm = m_USFm;
+	Params.SquelchGate = m_SquelchGate;
+	Params.NoiseReduceOn = m_NoiseReduceOn;
+	Params.NoiseReduceLevel = m_NoiseReduceLevel;
+	Params.AutoNotchOn = m_AutoNotchOn;
+	Params.pChain = NULL;
+	Params.ChainSeq = 0;
+	m_Params.Publish(Params);
+	m_Params.Update();
+	m_NewChainSeq = 0;
+	m_ChainSeq = 0;
+	m_pPendingChain = NULL;
+	m_pRetiringChain = NULL;
+	m_ChainWfm = false;
+	m_ChainInputRate = 0.0;
+	m_ChainBW = 0.0;
+	m_ChainSeqTaken = 0;
+	m_InfoSeq = 0;
+	m_PlannedOutputRate = m_DemodOutputRate;
+	m_ParamsTaken = false;
+	PlanBuffers();
+	ResetGate();
+	ClearStats();
+	m_Stats.ScratchBytes = 0;
+	m_Stats.DemodBytes = 0;
+	m_StatsOut.Publish(m_Stats);
+	m_StatsOut.Update();
 	SetDemodFreq(0.0);
 }
 
 CDemodulator::~CDemodulator()
 {
-	DeleteAllDemods();
-	if(m_pDemodInBuf)
-		delete m_pDemodInBuf;
-	if(m_pDemodTmpBuf)
-		delete m_pDemodTmpBuf;
+	ReleaseDemods();
+	delete m_Pool.pAm;
+	delete m_Pool.pSam;
+	delete m_Pool.pFm;
+	delete m_Pool.pWFm;
+	delete m_Pool.pPsk;
+	delete m_Pool.pFsk;
+	delete m_Pool.pSsb;
+	if(m_pMultiPskDemod)
+		delete m_pMultiPskDemod;
+	if(m_pMultiFskDemod)
+		delete m_pMultiFskDemod;
+	if(m_pPendingChain)
+		delete m_pPendingChain;
+	if(m_pRetiringChain)
+		delete m_pRetiringChain;
 }
 
 //////////////////////////////////////////////////////////////////
-//	Deletes all demod objects
+//	Deselects the active demod. The objects stay in m_Pool.
 //////////////////////////////////////////////////////////////////
-void CDemodulator::DeleteAllDemods()
+void CDemodulator::ReleaseDemods()
 {
-	if(m_pAmDemod)
-		delete m_pAmDemod;
-	if(m_pSamDemod)
-		delete m_pSamDemod;
-	if(m_pFmDemod)
-		delete m_pFmDemod;
 	if(m_pWFmDemod)
-		delete m_pWFmDemod;
-	if(m_pPskDemod)
-		delete m_pPskDemod;
-	if(m_pSsbDemod)
-		delete m_pSsbDemod;
+		m_pWFmDemod->Release();	//leaving WFM, drop the stereo buffers and idle the RDS thread
 	m_pAmDemod = NULL;
 	m_pSamDemod = NULL;
 	m_pFmDemod = NULL;
 	m_pWFmDemod = NULL;
 	m_pPskDemod = NULL;
+	m_pFskDemod = NULL;
 	m_pSsbDemod = NULL;
 }
 
@@ -105,43 +170,11 @@ void CDemodulator::DeleteAllDemods()
 //////////////////////////////////////////////////////////////////
 void CDemodulator::SetInputSampleRate(TYPEREAL InputRate)
 {
-	if(m_InputRate != InputRate)
-	{
-		m_InputRate = InputRate;
-		//change any demod parameters that may occur with sample rate change
-		switch(m_DemodMode)
-		{
-			case DEMOD_FM:
-				m_DownConverterOutputRate = m_DownConvert.SetDataRate(m_InputRate, m_DesiredMaxOutputBandwidth);
-				m_DemodOutputRate = m_DownConverterOutputRate;
-				if(m_pFmDemod)
-					m_pFmDemod->SetSampleRate(m_DownConverterOutputRate);
-				break;
-			case DEMOD_WFM:
-				m_DownConverterOutputRate = m_DownConvert.SetWfmDataRate(m_InputRate, 100000);
-				if(m_pWFmDemod)
-					m_DemodOutputRate = m_pWFmDemod->SetSampleRate(m_DownConverterOutputRate, m_USFm);
-				break;
-			case DEMOD_AM:
-			case DEMOD_SAM:
-			case DEMOD_USB:
-			case DEMOD_LSB:
-			case DEMOD_CWU:
-			case DEMOD_CWL:
-				m_DownConverterOutputRate = m_DownConvert.SetDataRate(m_InputRate, m_DesiredMaxOutputBandwidth);
-				m_DemodOutputRate = m_DownConverterOutputRate;
-				break;
-			case DEMOD_PSK:
-				m_DownConverterOutputRate = m_DownConvert.SetDataRate(m_InputRate, m_DesiredMaxOutputBandwidth);
-				m_DemodOutputRate = m_DownConverterOutputRate;
-				m_pPskDemod->SetPskParams(m_DownConverterOutputRate, m_PskRate, BPSK_MODE);
-				break;
-			case DEMOD_FSK:
-				m_DownConverterOutputRate = m_DownConvert.SetDataRate(m_InputRate, m_DesiredMaxOutputBandwidth);
-				m_DemodOutputRate = m_DownConverterOutputRate;
-				break;
-		}
-	}
+	m_Mutex.lock();
+	tDEMOD_PARAMS Params = m_Params.Published();
+	Params.InputRate = InputRate;
+	PublishParams(Params);
+	m_Mutex.unlock();
 }
 
 //////////////////////////////////////////////////////////////////
@@ -151,66 +184,255 @@ void CDemodulator::SetInputSampleRate(TYPEREAL InputRate)
 void CDemodulator::SetDemod(int Mode, tDemodInfo CurrentDemodInfo)
 {
 	m_Mutex.lock();
-	m_DemodInfo = CurrentDemodInfo;
+	tDEMOD_PARAMS Params = m_Params.Published();
+	Params.Mode = Mode;
+	Params.Info = CurrentDemodInfo;
+	Params.InfoSeq++;
+	PublishParams(Params);
+	m_Mutex.unlock();
+qDebug()<<"InputRate="<<Params.InputRate<<" DemodOutputRate="<<m_PlannedOutputRate;
+qDebug()<<"SquelchThreshold = "<<Params.Info.SquelchValue;
+}
+
+//////////////////////////////////////////////////////////////////
+//	Builds the decimation stages for Params if their rates changed,
+//so GetOutputRate() is valid on return and the DSP thread never
+//allocates them, and publishes Params for the next ProcessData() call.
+//m_Mutex must be locked by the caller.
+//////////////////////////////////////////////////////////////////
+void CDemodulator::PublishParams(tDEMOD_PARAMS& Params)
+{
+	bool Wfm = (DEMOD_WFM == Params.Mode);
+	TYPEREAL ChainBW = WFM_DOWNCONVERT_BW;
+	if(!Wfm)
+		ChainBW = GetMaxOutputBandwidth(Params.Mode, Params.Info, Params.MultiPsk, Params.MultiFsk);
+	if( (Params.Mode >= 0) &&
+		((0 == m_ChainSeq) || (Wfm != m_ChainWfm) ||
+		 (Params.InputRate != m_ChainInputRate) || (ChainBW != m_ChainBW)) )
+	{	//building the chain is slow so skip it for filter and AGC changes
+		CollectChains();
+		m_pPendingChain = new tDEMOD_CHAIN;
+		if(Wfm)
+		{
+			TYPEREAL Rate = m_pPendingChain->DownConvert.BuildWfm(Params.InputRate, ChainBW);
+			m_pPendingChain->Wfm.Build(Rate);
+			m_PlannedOutputRate = Rate/CWFmDemod::GetAudioDecimation(Rate);
+		}
+		else
+		{
+			m_PlannedOutputRate = m_pPendingChain->DownConvert.Build(Params.InputRate, ChainBW);
+		}
+		m_ChainWfm = Wfm;
+		m_ChainInputRate = Params.InputRate;
+		m_ChainBW = ChainBW;
+		m_ChainSeq++;
+		Params.pChain = m_pPendingChain;
+		Params.ChainSeq = m_ChainSeq;
+		m_NewChainSeq.fetchAndStoreOrdered(m_ChainSeq);	//the DSP thread may take it now
+	}
+	m_Params.Publish(Params);
+}
+
+//////////////////////////////////////////////////////////////////
+//	Deletes the chains the DSP thread is done with before a new one
+//is built. m_pPendingChain is taken back if the DSP thread never took
+//it. m_Mutex must be locked by the caller.
+//////////////////////////////////////////////////////////////////
+void CDemodulator::CollectChains()
+{
+	if(m_pPendingChain)
+	{
+		if(m_NewChainSeq.fetchAndStoreOrdered(0) == m_ChainSeq)
+		{	//never taken, the DSP thread can no longer take it
+			delete m_pPendingChain;
+		}
+		else
+		{	//taken so the chain taken before it has already been retired
+			if(m_pRetiringChain)
+				delete m_pRetiringChain;
+			m_pRetiringChain = m_pPendingChain;
+		}
+		m_pPendingChain = NULL;
+	}
+	if( m_pRetiringChain && m_pRetiringChain->Retired.loadAcquire() )
+	{
+		delete m_pRetiringChain;
+		m_pRetiringChain = NULL;
+	}
+}
+
+//////////////////////////////////////////////////////////////////
+//	Returns the bandwidth the decimation chain must keep for Mode
+//////////////////////////////////////////////////////////////////
+TYPEREAL CDemodulator::GetMaxOutputBandwidth(int Mode, const tDemodInfo& Info, bool MultiPsk, bool MultiFsk)
+{
+	if((DEMOD_LSB == Mode) || (DEMOD_CWL == Mode) )
+		return -Info.LowCutmin;
+	else if( (DEMOD_PSK == Mode) && MultiPsk )
+		return MPSK_HICUT;	//whole audio passband is searched
+	else if( (DEMOD_FSK == Mode) && MultiFsk )
+		return MFSK_HICUT;
+	return Info.HiCutmax;
+}
+
+//////////////////////////////////////////////////////////////////
+//	Picks up the settings published since the last call.
+//Runs on the DSP thread at a block boundary.
+//////////////////////////////////////////////////////////////////
+void CDemodulator::UpdateParams()
+{
+	if(m_Params.Update())
+		ApplyParams();
+}
+
+//////////////////////////////////////////////////////////////////
+//	Copies the latest parameter snapshot into the working settings.
+//The demod chain is rebuilt if the mode or anything that sets its
+//decimation or demod rate changed. Runs on the DSP thread.
+// The decimation stages of a new chain were built by the setter and
+//are only swapped in here.
+//////////////////////////////////////////////////////////////////
+void CDemodulator::ApplyParams()
+{
+	const tDEMOD_PARAMS& Params = m_Params.Get();
+	tDEMOD_CHAIN* pNewChain = NULL;
+	if(Params.ChainSeq != m_ChainSeqTaken)
+	{	//take the stages built for these settings
+		if( !m_NewChainSeq.testAndSetOrdered(Params.ChainSeq, 0) )
+			return;	//a setter replaced them so newer settings are on the way
+		m_ChainSeqTaken = Params.ChainSeq;
+		pNewChain = Params.pChain;
+	}
+	m_SquelchGate = Params.SquelchGate;
+	m_NoiseReduceOn = Params.NoiseReduceOn;
+	m_NoiseReduceLevel = Params.NoiseReduceLevel;
+	m_AutoNotchOn = Params.AutoNotchOn;
+	bool NewChain = (pNewChain != NULL) || (Params.InputRate != m_InputRate);
+	if(Params.Mode >= 0)
+	{
+		if(GetMaxOutputBandwidth(Params.Mode, Params.Info, Params.MultiPsk, Params.MultiFsk) != m_DesiredMaxOutputBandwidth)
+			NewChain = true;
+		if( (DEMOD_PSK == Params.Mode) && ((Params.MultiPsk != m_MultiPsk) || (Params.PskRate != m_PskRate)) )
+			NewChain = true;
+		if( (DEMOD_FSK == Params.Mode) && (Params.MultiFsk != m_MultiFsk) )
+			NewChain = true;
+		if( (DEMOD_WFM == Params.Mode) && (Params.USFm != m_USFm) )
+			NewChain = true;
+	}
+	if(Params.InputRate != m_InputRate)
+	{
+		m_InputRate = Params.InputRate;
+		PlanBuffers();
+		ResetGate();
+	}
+	m_MultiPsk = Params.MultiPsk;
+	m_PskRate = Params.PskRate;
+	m_MultiFsk = Params.MultiFsk;
+	m_USFm = Params.USFm;
+	if(NewChain)
+		m_DemodMode = -1;	//force the demod chain to be rebuilt
+	if( (Params.InfoSeq != m_InfoSeq) || (Params.Mode != m_DemodMode) )
+	{
+		m_InfoSeq = Params.InfoSeq;
+		m_DemodInfo = Params.Info;
+		SelectDemod(Params.Mode, pNewChain);	//also updates noise reduction and notch
+	}
+	else
+	{
+		UpdateNoiseReduce();
+		UpdateAutoNotch();
+	}
+	if(pNewChain)
+		pNewChain->Retired.storeRelease(1);	//it now holds the old stages for the setters to delete
+}
+
+//////////////////////////////////////////////////////////////////
+//	Selects the demod object for Mode if it changed and sets up
+//the filters from m_DemodInfo. pChain holds new decimation stages
+//to swap in, NULL if the ones in use are kept. Runs on the DSP thread.
+//////////////////////////////////////////////////////////////////
+void CDemodulator::SelectDemod(int Mode, tDEMOD_CHAIN* pChain)
+{
 	if(m_DemodMode != Mode)	//do only if changes
 	{
-		DeleteAllDemods();		//remove current demod object
+		ReleaseDemods();		//deselect current demod object
 		m_DemodMode = Mode;
-		//create decimation chain and get output sample rate
-		if((DEMOD_LSB == m_DemodMode) || (DEMOD_CWL == m_DemodMode) )
-			m_DesiredMaxOutputBandwidth = -m_DemodInfo.LowCutmin;
-		else
-			m_DesiredMaxOutputBandwidth = m_DemodInfo.HiCutmax;
+		m_AutoNotch.Reset();	//weights of the last mode are no use
+		//put the decimation chain in use and get output sample rate
+		m_DesiredMaxOutputBandwidth = GetMaxOutputBandwidth(m_DemodMode, m_DemodInfo, m_MultiPsk, m_MultiFsk);
+		if(pChain)
+			m_DownConvert.SetChain(pChain->DownConvert);
+		m_DownConverterOutputRate = m_DownConvert.GetOutputRate();
 
-		//now create correct demodulator
+		//now select and initialize the correct demodulator. The demods
+		// come from m_Pool and the multi-channel ones are created by the
+		// setters so nothing is created here.
 		switch(m_DemodMode)
 		{
 			case DEMOD_AM:
-				m_DownConverterOutputRate = m_DownConvert.SetDataRate(m_InputRate, m_DesiredMaxOutputBandwidth);
-				m_pAmDemod = new CAmDemod(m_DownConverterOutputRate);
+				m_pAmDemod = m_Pool.pAm;
+				m_pAmDemod->Init(m_DownConverterOutputRate);
 				m_DemodOutputRate = m_DownConverterOutputRate;
 				break;
 			case DEMOD_SAM:
-				m_DownConverterOutputRate = m_DownConvert.SetDataRate(m_InputRate, m_DesiredMaxOutputBandwidth);
-				m_pSamDemod = new CSamDemod(m_DownConverterOutputRate);
+				m_pSamDemod = m_Pool.pSam;
+				m_pSamDemod->Init(m_DownConverterOutputRate);
 				m_DemodOutputRate = m_DownConverterOutputRate;
 				break;
 			case DEMOD_FM:
-				m_DownConverterOutputRate = m_DownConvert.SetDataRate(m_InputRate, m_DesiredMaxOutputBandwidth);
-				m_pFmDemod = new CFmDemod(m_DownConverterOutputRate);
+				m_pFmDemod = m_Pool.pFm;
+				m_pFmDemod->Init(m_DownConverterOutputRate);
 				m_DemodOutputRate = m_DownConverterOutputRate;
 				break;
 			case DEMOD_WFM:
-				m_DownConverterOutputRate = m_DownConvert.SetWfmDataRate(m_InputRate, 100000);
-				m_pWFmDemod = new CWFmDemod(m_DownConverterOutputRate);
-				m_DemodOutputRate = m_pWFmDemod->GetDemodRate();
+				m_pWFmDemod = m_Pool.pWFm;
+				m_DemodOutputRate = m_pWFmDemod->Init(m_DownConverterOutputRate, m_USFm,
+													  pChain ? &pChain->Wfm : NULL);
 				break;
 			case DEMOD_USB:
 			case DEMOD_LSB:
 			case DEMOD_CWU:
 			case DEMOD_CWL:
-				m_DownConverterOutputRate = m_DownConvert.SetDataRate(m_InputRate, m_DesiredMaxOutputBandwidth);
-				m_pSsbDemod = new CSsbDemod();
+				m_pSsbDemod = m_Pool.pSsb;
 				m_DemodOutputRate = m_DownConverterOutputRate;
 				break;
 			case DEMOD_PSK:
 //qDebug()<<"Desired MaxOutputBW="<<m_DesiredMaxOutputBandwidth;
-				m_DownConverterOutputRate = m_DownConvert.SetDataRate(m_InputRate, m_DesiredMaxOutputBandwidth);
-				m_pPskDemod = new CPskDemod();
-				m_pPskDemod->SetPskParams(m_DownConverterOutputRate, m_PskRate, BPSK_MODE);
+				if(m_MultiPsk)
+				{	//decode every signal in the passband and monitor it as USB audio
+					m_pMultiPskDemod->Init(m_DownConverterOutputRate, m_PskRate);
+					m_pSsbDemod = m_Pool.pSsb;
+				}
+				else
+				{
+					m_pPskDemod = m_Pool.pPsk;
+					m_pPskDemod->SetPskParams(m_DownConverterOutputRate, m_PskRate, BPSK_MODE);
+				}
 				m_DemodOutputRate = m_DownConverterOutputRate;
 				break;
 			case DEMOD_FSK:
 //qDebug()<<"Desired MaxOutputBW="<<m_DesiredMaxOutputBandwidth;
-				m_DownConverterOutputRate = m_DownConvert.SetDataRate(m_InputRate, m_DesiredMaxOutputBandwidth);
-				m_pFskDemod = new CFskDemod(m_DownConverterOutputRate);
+				if(m_MultiFsk)
+				{	//decode every DSC signal in the passband and monitor it as USB audio
+					m_pMultiFskDemod->Init(m_DownConverterOutputRate);
+					m_pSsbDemod = m_Pool.pSsb;
+				}
+				else
+				{
+					m_pFskDemod = m_Pool.pFsk;
+					m_pFskDemod->Init(m_DownConverterOutputRate);
+				}
 				m_DemodOutputRate = m_DownConverterOutputRate;
 				break;
 		}
 	}
 	m_CW_Offset = m_DemodInfo.Offset;
 	m_DownConvert.SetCwOffset(m_CW_Offset);
-	if(m_DemodMode != DEMOD_WFM)
+	if( (DEMOD_PSK == m_DemodMode) && m_MultiPsk )
+		m_FastFIR.SetupParameters(MPSK_LOWCUT, MPSK_HICUT, m_CW_Offset, m_DownConverterOutputRate);
+	else if( (DEMOD_FSK == m_DemodMode) && m_MultiFsk )
+		m_FastFIR.SetupParameters(MFSK_LOWCUT, MFSK_HICUT, m_CW_Offset, m_DownConverterOutputRate);
+	else if(m_DemodMode != DEMOD_WFM)
 		m_FastFIR.SetupParameters(m_DemodInfo.LowCut, m_DemodInfo.HiCut,m_CW_Offset,m_DownConverterOutputRate);
 	m_Agc.SetParameters(m_DemodInfo.AgcOn, m_DemodInfo.AgcHangOn, m_DemodInfo.AgcThresh,
 						m_DemodInfo.AgcManualGain, m_DemodInfo.AgcSlope, m_DemodInfo.AgcDecay, m_DownConverterOutputRate);
@@ -218,28 +440,290 @@ void CDemodulator::SetDemod(int Mode, tDemodInfo CurrentDemodInfo)
 		m_pFmDemod->SetSquelch(m_DemodInfo.SquelchValue);
 	if(m_pAmDemod != NULL)
 		m_pAmDemod->SetBandwidth( (m_DemodInfo.HiCut-m_DemodInfo.LowCut)/2.0);
-	//set input buffer limit so that decimated output is abt 10mSec or more of data
-	m_InBufLimit = (m_DemodOutputRate/100.0) * m_InputRate/m_DemodOutputRate;	//process abt .01sec of output samples at a time
-	m_InBufLimit &= 0xFFFFFF00;	//keep modulo 256 since decimation is only in power of 2
-	m_Mutex.unlock();
-qDebug()<<"m_InputRate="<<m_InputRate<<" DesiredMaxOutputBandwidth=="<<m_DesiredMaxOutputBandwidth <<"DemodOutputRate="<<m_DemodOutputRate;
-//qDebug()<<"m_InBufLimit="<<m_InBufLimit;
-qDebug()<<"SquelchThreshold = "<<m_DemodInfo.SquelchValue;
+	ResetGate();
+	UpdateNoiseReduce();
+	UpdateAutoNotch();
 }
 
 //////////////////////////////////////////////////////////////////
-///
+//	Selects the PSK rate and single or multi-channel decoding.
+//The multi-channel demod is created here the first time so the DSP
+//thread never allocates it.
 //////////////////////////////////////////////////////////////////
 void CDemodulator::SetPskMode(int index)
 {
-	if(	m_pPskDemod && (DEMOD_PSK == m_DemodMode) )
+	m_Mutex.lock();
+	tDEMOD_PARAMS Params = m_Params.Published();
+	//index 0,1 are single BPSK31,BPSK63 and 2,3 are the multi-channel versions
+	Params.MultiPsk = (index >= 2);
+	if(0 == (index&1))
+		Params.PskRate = 31.25;
+	else
+		Params.PskRate = 63.5;
+	if(Params.MultiPsk && !m_pMultiPskDemod)
+		m_pMultiPskDemod = new CMultiPskDemod();	//ProcessData() gets it with the snapshot
+	PublishParams(Params);
+	m_Mutex.unlock();
+}
+
+//////////////////////////////////////////////////////////////////
+//	Switches FSK mode between the single DSC decoder and the
+//multi-channel one
+//////////////////////////////////////////////////////////////////
+void CDemodulator::SetFskMode(bool Multi)
+{
+	m_Mutex.lock();
+	tDEMOD_PARAMS Params = m_Params.Published();
+	Params.MultiFsk = Multi;
+	if(Multi && !m_pMultiFskDemod)
+		m_pMultiFskDemod = new CMultiFskDemod();	//ProcessData() gets it with the snapshot
+	PublishParams(Params);
+	m_Mutex.unlock();
+}
+
+//////////////////////////////////////////////////////////////////
+//	Selects the US(75uSec) or European(50uSec) WFM deemphasis
+//////////////////////////////////////////////////////////////////
+void CDemodulator::SetUSFmVersion(bool USFm)
+{
+	m_Mutex.lock();
+	tDEMOD_PARAMS Params = m_Params.Published();
+	Params.USFm = USFm;
+	PublishParams(Params);
+	m_Mutex.unlock();
+}
+
+//////////////////////////////////////////////////////////////////
+//	Enables/disables the squelch gate
+//////////////////////////////////////////////////////////////////
+void CDemodulator::SetSquelchGate(bool On)
+{
+	m_Mutex.lock();
+	tDEMOD_PARAMS Params = m_Params.Published();
+	Params.SquelchGate = On;
+	m_Params.Publish(Params);
+	m_Mutex.unlock();
+}
+
+//////////////////////////////////////////////////////////////////
+//	Sets the audio noise reduction parameters
+//////////////////////////////////////////////////////////////////
+void CDemodulator::SetNoiseReduce(bool On, int Level)
+{
+	m_Mutex.lock();
+	tDEMOD_PARAMS Params = m_Params.Published();
+	Params.NoiseReduceOn = On;
+	Params.NoiseReduceLevel = Level;
+	m_Params.Publish(Params);
+	m_Mutex.unlock();
+}
+
+//////////////////////////////////////////////////////////////////
+//	Sets up the noise reduction for the current mode and output rate.
+//It is only used with the voice and CW modes.
+//Runs on the DSP thread.
+//////////////////////////////////////////////////////////////////
+void CDemodulator::UpdateNoiseReduce()
+{
+	bool On = m_NoiseReduceOn && (m_DemodMode >= DEMOD_AM) && (m_DemodMode <= DEMOD_CWL);
+	m_NoiseReduce.Setup(On, m_NoiseReduceLevel, m_DemodOutputRate);
+}
+
+//////////////////////////////////////////////////////////////////
+//	Enables/disables the auto notch
+//////////////////////////////////////////////////////////////////
+void CDemodulator::SetAutoNotch(bool On)
+{
+	m_Mutex.lock();
+	tDEMOD_PARAMS Params = m_Params.Published();
+	Params.AutoNotchOn = On;
+	m_Params.Publish(Params);
+	m_Mutex.unlock();
+}
+
+//////////////////////////////////////////////////////////////////
+//	Sets up the auto notch for the current mode. It is used with
+//AM, SAM, USB and LSB. CW is left alone since the wanted signal is a tone.
+//Runs on the DSP thread.
+//////////////////////////////////////////////////////////////////
+void CDemodulator::UpdateAutoNotch()
+{
+	bool On = m_AutoNotchOn && (m_DemodMode <= DEMOD_LSB) && (m_DemodMode != DEMOD_FM);
+	if( (DEMOD_USB == m_DemodMode) || (DEMOD_LSB == m_DemodMode) )
+		m_AutoNotch.Setup(On, ANOTCH_TAPS, m_DownConverterOutputRate);
+	else
+		m_AutoNotch.Setup(On, ANOTCH_TAPS, m_DemodOutputRate);
+}
+
+//////////////////////////////////////////////////////////////////
+//	Copies the CPU counters last published by ProcessData() into
+//pStats(if not NULL) and optionally has ProcessData() clear them
+//////////////////////////////////////////////////////////////////
+void CDemodulator::GetStats(tDEMOD_STATS* pStats, bool Reset)
+{
+	m_Mutex.lock();
+	m_StatsOut.Update();
+	if(pStats)
 	{
-		if(0 == index)
-			m_PskRate = 31.25;
-		else
-			m_PskRate = 63.5;
-		m_pPskDemod->SetPskParams(m_DownConverterOutputRate, m_PskRate, BPSK_MODE);
+		*pStats = m_StatsOut.Get();
+		pStats->ScratchBytes = CScratchArena::GetTotalSize();
+		pStats->DemodBytes = sizeof(CAmDemod) + sizeof(CSamDemod) + sizeof(CFmDemod)
+							+ sizeof(CPskDemod) + sizeof(CFskDemod) + sizeof(CSsbDemod)
+							+ m_Pool.pWFm->GetMemorySize();
+		if(m_pMultiPskDemod)
+			pStats->DemodBytes += m_pMultiPskDemod->GetMemorySize();
+		if(m_pMultiFskDemod)
+			pStats->DemodBytes += m_pMultiFskDemod->GetMemorySize();
+	}
+	if(Reset)
+		m_StatsReset.storeRelease(1);
+	m_Mutex.unlock();
+}
+
+//////////////////////////////////////////////////////////////////
+//	Clears the CPU counters. Runs on the DSP thread.
+//////////////////////////////////////////////////////////////////
+void CDemodulator::ClearStats()
+{
+	m_Stats.FrontEndNs = 0;
+	m_Stats.BackEndNs = 0;
+	m_Stats.Blocks = 0;
+	m_Stats.GatedBlocks = 0;
+}
+
+//////////////////////////////////////////////////////////////////
+//	DSP thread. Picks up the published settings so the returned
+//length holds for the next ProcessData() call even if a setter
+//publishes in between.
+//////////////////////////////////////////////////////////////////
+int CDemodulator::GetMaxOutputLength(int InLength)
+{
+	UpdateParams();
+	m_ParamsTaken = true;
+	return (InLength/m_InBufLimit + 1)*m_BlockOutLength;
+}
+
+//////////////////////////////////////////////////////////////////
+//	Sizes the block and work buffers for the input sample rate.
+//The sizes cover every mode so a mode change does not move them.
+//Runs on the DSP thread(or before it starts).
+//////////////////////////////////////////////////////////////////
+void CDemodulator::PlanBuffers()
+{
+	//set input buffer limit so that decimated output is abt 10mSec of data
+	m_InBufLimit = (int)(m_InputRate*INBUF_TIME);
+	m_InBufLimit &= 0xFFFFFF00;	//keep modulo 256 since decimation is only in power of 2
+	if(m_InBufLimit < 256)
+		m_InBufLimit = 256;
+	m_InBufPos = 0;
+	//the output rate is never above the input rate
+	m_PreRollMax = (int)(m_InputRate*GATE_PREROLL_TIME);
+	if(m_PreRollMax > MAX_PREROLL)
+		m_PreRollMax = MAX_PREROLL;
+	if(m_PreRollMax < 1)
+		m_PreRollMax = 1;
+	//the filter can output one more FFT block than it was given and an
+	// opening squelch gate puts the pre-roll in front
+	m_BlockOutLength = CFastFIR::GetMaxOutputLength(m_InBufLimit) + m_PreRollMax;
+	m_Scratch.Begin();
+	int InOffset = m_Scratch.Add(m_InBufLimit*sizeof(TYPECPX));
+	int TmpOffset = m_Scratch.Add(m_BlockOutLength*sizeof(TYPECPX));
+	int PreRollOffset = m_Scratch.Add(m_PreRollMax*sizeof(TYPECPX));
+	m_Scratch.End();
+	m_pDemodInBuf = (TYPECPX*)m_Scratch.Get(InOffset);
+	m_pDemodTmpBuf = (TYPECPX*)m_Scratch.Get(TmpOffset);
+	m_pPreRollBuf = (TYPECPX*)m_Scratch.Get(PreRollOffset);
+}
+
+//////////////////////////////////////////////////////////////////
+//	Sets up the squelch gate for the current demod output rate.
+//Runs on the DSP thread(or before it starts).
+//////////////////////////////////////////////////////////////////
+void CDemodulator::ResetGate()
+{
+	m_PreRollLength = (int)(m_DownConverterOutputRate*GATE_PREROLL_TIME);
+	if(m_PreRollLength > m_PreRollMax)
+		m_PreRollLength = m_PreRollMax;
+	if(m_PreRollLength < 1)
+		m_PreRollLength = 1;
+	m_GateHoldSamples = (int)(m_DownConverterOutputRate*GATE_HOLD_TIME);
+	m_GateClosed = false;
+	m_SquelchSamples = 0;
+	m_PreRollPos = 0;
+	m_PreRollCount = 0;
+	m_SilenceDebt = 0;
+}
+
+//////////////////////////////////////////////////////////////////
+//	Squelch gate for the n filtered samples in m_pDemodTmpBuf.
+// Returns true if the block should be skipped and n silent samples output.
+//
+//  Once the squelch has been closed for GATE_HOLD_TIME the gate closes and
+//AGC and demod are skipped. The newest filtered samples are kept in a
+//pre-roll ring and the first GATE_PREROLL_TIME of silence is withheld so
+//that when the gate opens the pre-roll can be put in front of the block
+//without changing the overall output rate. This keeps the start of a
+//signal that the slow S-Meter average missed.
+//////////////////////////////////////////////////////////////////
+bool CDemodulator::SquelchGate(bool Squelched, int& n)
+{
+	if(!m_SquelchGate || !Squelched)
+	{
+		m_SquelchSamples = 0;
+		if(m_GateClosed)
+		{	//gate opening so insert the withheld pre-roll samples
+			m_GateClosed = false;
+			int count = m_PreRollLength - m_SilenceDebt;
+			if(count > m_PreRollCount)
+				count = m_PreRollCount;
+			if(count > 0)
+			{
+				memmove(&m_pDemodTmpBuf[count], m_pDemodTmpBuf, n*sizeof(TYPECPX));
+				int pos = m_PreRollPos - count;
+				if(pos < 0)
+					pos += m_PreRollLength;
+				for(int i=0; i<count; i++)
+				{
+					m_pDemodTmpBuf[i] = m_pPreRollBuf[pos];
+					if(++pos >= m_PreRollLength)
+						pos = 0;
+				}
+				n += count;
+			}
+			m_Agc.ResetDelay();	//don't replay old signal from the AGC delay line
+		}
+		return false;
+	}
+	m_SquelchSamples += n;
+	if(!m_GateClosed)
+	{
+		if(m_SquelchSamples < m_GateHoldSamples)
+			return false;
+		m_GateClosed = true;
+		m_PreRollPos = 0;
+		m_PreRollCount = 0;
+		m_SilenceDebt = m_PreRollLength;
+	}
+	//keep the newest samples for the pre-roll
+	int start = n - m_PreRollLength;
+	if(start < 0)
+		start = 0;
+	for(int i=start; i<n; i++)
+	{
+		m_pPreRollBuf[m_PreRollPos] = m_pDemodTmpBuf[i];
+		if(++m_PreRollPos >= m_PreRollLength)
+			m_PreRollPos = 0;
 	}
+	m_PreRollCount += (n-start);
+	if(m_PreRollCount > m_PreRollLength)
+		m_PreRollCount = m_PreRollLength;
+	//withhold silence until there is room for the pre-roll
+	int w = n;
+	if(w > m_SilenceDebt)
+		w = m_SilenceDebt;
+	m_SilenceDebt -= w;
+	n -= w;
+	return true;
 }
 
 //////////////////////////////////////////////////////////////////
@@ -249,13 +733,21 @@ void CDemodulator::SetPskMode(int index)
 int CDemodulator::ProcessData(int InLength, TYPECPX* pInData, TYPEREAL* pOutData)
 {
 int ret = 0;
-bool SquelchState = false;
-	m_Mutex.lock();
+int NumBlocks = 0;
+int NumGated = 0;
+	if(!m_ParamsTaken)
+		UpdateParams();
+	m_ParamsTaken = false;
+	if(m_StatsReset.fetchAndStoreAcquire(0))
+		ClearStats();
 	for(int i=0; i<InLength; i++)
 	{	//place in demod buffer
 		m_pDemodInBuf[m_InBufPos++] = pInData[i];
 		if(m_InBufPos >= m_InBufLimit)
 		{	//when have enough samples, call demod routine sequence
+			TYPEREAL* pOut = &pOutData[ret];	//each block adds to the output
+			bool SquelchState = false;
+			m_Timer.start();
 
 			//perform baseband tuning and decimation
 			int n = m_DownConvert.ProcessData(m_InBufPos, m_pDemodInBuf, m_pDemodInBuf);
@@ -273,57 +765,96 @@ g_pTestBench->DisplayData(n, 1.0, m_pDemodTmpBuf, m_DemodOutputRate,PROFILE_2);
 					if( m_SMeter.GetAve() < (TYPEREAL)m_DemodInfo.SquelchValue )
 						SquelchState = true;
 				}
-				//perform AGC
-				m_Agc.ProcessData(n, m_pDemodTmpBuf, m_pDemodTmpBuf );
-//				g_pTestBench->DisplayData(n, 1.0, m_pDemodTmpBuf, m_DemodOutputRate, PROFILE_3);
 			}
 			else
 			{
 				//perform S-Meter processing for wideband FM
 				m_SMeter.ProcessData(n, m_pDemodInBuf, m_DownConverterOutputRate);
 			}
-
-			//perform the desired demod action
-			switch(m_DemodMode)
-			{
-				case DEMOD_AM:
-					n = m_pAmDemod->ProcessData(n, m_pDemodTmpBuf, pOutData );
-					break;
-				case DEMOD_SAM:
-					n = m_pSamDemod->ProcessData(n, m_pDemodTmpBuf, pOutData );
-					break;
-				case DEMOD_FM:
-					n = m_pFmDemod->ProcessData(n, m_DemodInfo.HiCut, m_pDemodTmpBuf, pOutData );
-					break;
-				case DEMOD_WFM:
-					n = m_pWFmDemod->ProcessData(n, m_pDemodInBuf, pOutData );
-					break;
-				case DEMOD_USB:
-				case DEMOD_LSB:
-				case DEMOD_CWU:
-				case DEMOD_CWL:
-					n = m_pSsbDemod->ProcessData(n, m_pDemodTmpBuf, pOutData);
-					break;
-				case DEMOD_PSK:
-					if(n>0)
-						n = m_pPskDemod->ProcessData(n, m_pDemodTmpBuf, pOutData);
-					break;
-				case DEMOD_FSK:
-					if(n>0)
-						n = m_pFskDemod->ProcessData(n, m_pDemodTmpBuf, pOutData);
-					break;
+			m_Stats.FrontEndNs += m_Timer.nsecsElapsed();
+			m_Timer.start();
+			NumBlocks++;
+			//the gate is only used with the audio modes. FM has its own squelch
+			// and the digital mode decoders need continuous data
+			bool Gateable = (m_DemodMode <= DEMOD_CWL) && (m_DemodMode != DEMOD_FM);
+			if( Gateable && SquelchGate(SquelchState, n) )
+			{	//gate closed so skip AGC and demod
+				for(int i=0; i<n; i++)
+					pOut[i] = 0.0;
+				NumGated++;
 			}
-g_pTestBench->DisplayData(n, 1.0, pOutData, m_DemodOutputRate,PROFILE_4);
-			if(SquelchState)
+			else
 			{
-				for(int i=0; i<n; i++)
-					pOutData[i] = 0.0;
+				if(m_DemodMode != DEMOD_WFM)
+				{	//perform AGC
+					m_Agc.ProcessData(n, m_pDemodTmpBuf, m_pDemodTmpBuf );
+//					g_pTestBench->DisplayData(n, 1.0, m_pDemodTmpBuf, m_DemodOutputRate, PROFILE_3);
+				}
+				if( (DEMOD_USB == m_DemodMode) || (DEMOD_LSB == m_DemodMode) )
+					m_AutoNotch.ProcessData(n, m_pDemodTmpBuf);	//AM carriers must pass the demod
+				//perform the desired demod action
+				switch(m_DemodMode)
+				{
+					case DEMOD_AM:
+						n = m_pAmDemod->ProcessData(n, m_pDemodTmpBuf, pOut );
+						break;
+					case DEMOD_SAM:
+						n = m_pSamDemod->ProcessData(n, m_pDemodTmpBuf, pOut );
+						break;
+					case DEMOD_FM:
+						n = m_pFmDemod->ProcessData(n, m_DemodInfo.HiCut, m_pDemodTmpBuf, pOut );
+						break;
+					case DEMOD_WFM:
+						n = m_pWFmDemod->ProcessData(n, m_pDemodInBuf, pOut );
+						break;
+					case DEMOD_USB:
+					case DEMOD_LSB:
+					case DEMOD_CWU:
+					case DEMOD_CWL:
+						n = m_pSsbDemod->ProcessData(n, m_pDemodTmpBuf, pOut);
+						break;
+					case DEMOD_PSK:
+						if(m_MultiPsk)
+						{
+							m_pMultiPskDemod->PutData(n, m_pDemodTmpBuf);
+							n = m_pSsbDemod->ProcessData(n, m_pDemodTmpBuf, pOut);
+						}
+						else if(n>0)
+						{
+							n = m_pPskDemod->ProcessData(n, m_pDemodTmpBuf, pOut);
+						}
+						break;
+					case DEMOD_FSK:
+						if(m_MultiFsk)
+						{
+							m_pMultiFskDemod->PutData(n, m_pDemodTmpBuf);
+							n = m_pSsbDemod->ProcessData(n, m_pDemodTmpBuf, pOut);
+						}
+						else if(n>0)
+						{
+							n = m_pFskDemod->ProcessData(n, m_pDemodTmpBuf, pOut);
+						}
+						break;
+				}
+g_pTestBench->DisplayData(n, 1.0, pOut, m_DemodOutputRate,PROFILE_4);
+				if(m_DemodMode <= DEMOD_SAM)
+					m_AutoNotch.ProcessData(n, pOut);
+				m_NoiseReduce.ProcessData(n, pOut);
+				if(SquelchState)
+				{
+					for(int i=0; i<n; i++)
+						pOut[i] = 0.0;
+				}
 			}
+			m_Stats.BackEndNs += m_Timer.nsecsElapsed();
 			m_InBufPos = 0;
 			ret += n;
 		}
 	}
-	m_Mutex.unlock();
+	m_Stats.Blocks += NumBlocks;
+	m_Stats.GatedBlocks += NumGated;
+	m_OutputSilent = (NumBlocks > 0) && (NumBlocks == NumGated);
+	m_StatsOut.Publish(m_Stats);
 	return ret;
 }
 
@@ -334,13 +865,21 @@ g_pTestBench->DisplayData(n, 1.0, pOutData, m_DemodOutputRate,PROFILE_4);
 int CDemodulator::ProcessData(int InLength, TYPECPX* pInData, TYPECPX* pOutData)
 {
 int ret = 0;
-bool SquelchState = false;
-	m_Mutex.lock();
+int NumBlocks = 0;
+int NumGated = 0;
+	if(!m_ParamsTaken)
+		UpdateParams();
+	m_ParamsTaken = false;
+	if(m_StatsReset.fetchAndStoreAcquire(0))
+		ClearStats();
 	for(int i=0; i<InLength; i++)
 	{	//place in demod buffer
 		m_pDemodInBuf[m_InBufPos++] = pInData[i];
 		if(m_InBufPos >= m_InBufLimit)
 		{	//when have enough samples, call demod routine sequence
+			TYPECPX* pOut = &pOutData[ret];	//each block adds to the output
+			bool SquelchState = false;
+			m_Timer.start();
 
 			//perform baseband tuning and decimation
 			int n = m_DownConvert.ProcessData(m_InBufPos, m_pDemodInBuf, m_pDemodInBuf);
@@ -360,56 +899,101 @@ g_pTestBench->DisplayData(n, 1.0, m_pDemodTmpBuf, m_DemodOutputRate,PROFILE_2);
 					if( m_SMeter.GetAve() < (TYPEREAL)m_DemodInfo.SquelchValue )
 						SquelchState = true;
 				}
-				//perform AGC
-				m_Agc.ProcessData(n, m_pDemodTmpBuf, m_pDemodTmpBuf );
-//g_pTestBench->DisplayData(n, 1.0, m_pDemodTmpBuf, m_DemodOutputRate, PROFILE_3);
 			}
 			else
 			{
 				//perform S-Meter processing for wideband FM
 				m_SMeter.ProcessData(n, m_pDemodInBuf, m_DownConverterOutputRate);
 			}
-			//perform the desired demod action
-			switch(m_DemodMode)
-			{
-				case DEMOD_AM:
-					n = m_pAmDemod->ProcessData(n, m_pDemodTmpBuf, pOutData );
-					break;
-				case DEMOD_SAM:
-					n = m_pSamDemod->ProcessData(n, m_pDemodTmpBuf, pOutData );
-					break;
-				case DEMOD_FM:
-					n = m_pFmDemod->ProcessData(n, m_DemodInfo.HiCut, m_pDemodTmpBuf, pOutData );
-					break;
-				case DEMOD_WFM:
-					n = m_pWFmDemod->ProcessData(n, m_pDemodInBuf, pOutData );
-					break;
-				case DEMOD_USB:
-				case DEMOD_LSB:
-				case DEMOD_CWU:
-				case DEMOD_CWL:
-					n = m_pSsbDemod->ProcessData(n, m_pDemodTmpBuf, pOutData);
-					break;
-				case DEMOD_PSK:
-					n = m_pPskDemod->ProcessData(n, m_pDemodTmpBuf, pOutData);
-					break;
-				case DEMOD_FSK:
-					n = m_pFskDemod->ProcessData(n, m_pDemodTmpBuf, pOutData);
-					break;
+			m_Stats.FrontEndNs += m_Timer.nsecsElapsed();
+			m_Timer.start();
+			NumBlocks++;
+			//the gate is only used with the audio modes. FM has its own squelch
+			// and the digital mode decoders need continuous data
+			bool Gateable = (m_DemodMode <= DEMOD_CWL) && (m_DemodMode != DEMOD_FM);
+			if( Gateable && SquelchGate(SquelchState, n) )
+			{	//gate closed so skip AGC and demod
+				for(int i=0; i<n; i++)
+				{
+					pOut[i].re = 0.0;
+					pOut[i].im = 0.0;
+				}
+				NumGated++;
 			}
-			if(SquelchState)
+			else
 			{
-				for(int i=0; i<n; i++)
+				if(m_DemodMode != DEMOD_WFM)
+				{	//perform AGC
+					m_Agc.ProcessData(n, m_pDemodTmpBuf, m_pDemodTmpBuf );
+//g_pTestBench->DisplayData(n, 1.0, m_pDemodTmpBuf, m_DemodOutputRate, PROFILE_3);
+				}
+				if( (DEMOD_USB == m_DemodMode) || (DEMOD_LSB == m_DemodMode) )
+					m_AutoNotch.ProcessData(n, m_pDemodTmpBuf);	//AM carriers must pass the demod
+				//perform the desired demod action
+				switch(m_DemodMode)
 				{
-					pOutData[i].re = 0.0;
-					pOutData[i].im = 0.0;
+					case DEMOD_AM:
+						n = m_pAmDemod->ProcessData(n, m_pDemodTmpBuf, pOut );
+						break;
+					case DEMOD_SAM:
+						n = m_pSamDemod->ProcessData(n, m_pDemodTmpBuf, pOut );
+						break;
+					case DEMOD_FM:
+						n = m_pFmDemod->ProcessData(n, m_DemodInfo.HiCut, m_pDemodTmpBuf, pOut );
+						break;
+					case DEMOD_WFM:
+						n = m_pWFmDemod->ProcessData(n, m_pDemodInBuf, pOut );
+						break;
+					case DEMOD_USB:
+					case DEMOD_LSB:
+					case DEMOD_CWU:
+					case DEMOD_CWL:
+						n = m_pSsbDemod->ProcessData(n, m_pDemodTmpBuf, pOut);
+						break;
+					case DEMOD_PSK:
+						if(m_MultiPsk)
+						{
+							m_pMultiPskDemod->PutData(n, m_pDemodTmpBuf);
+							n = m_pSsbDemod->ProcessData(n, m_pDemodTmpBuf, pOut);
+						}
+						else
+						{
+							n = m_pPskDemod->ProcessData(n, m_pDemodTmpBuf, pOut);
+						}
+						break;
+					case DEMOD_FSK:
+						if(m_MultiFsk)
+						{
+							m_pMultiFskDemod->PutData(n, m_pDemodTmpBuf);
+							n = m_pSsbDemod->ProcessData(n, m_pDemodTmpBuf, pOut);
+						}
+						else
+						{
+							n = m_pFskDemod->ProcessData(n, m_pDemodTmpBuf, pOut);
+						}
+						break;
+				}
+				if(m_DemodMode <= DEMOD_SAM)
+					m_AutoNotch.ProcessData(n, pOut);
+				m_NoiseReduce.ProcessData(n, pOut);
+				if(SquelchState)
+				{
+					for(int i=0; i<n; i++)
+					{
+						pOut[i].re = 0.0;
+						pOut[i].im = 0.0;
+					}
 				}
 			}
-g_pTestBench->DisplayData(n, 1.0, pOutData, m_DemodOutputRate,PROFILE_4);
+			m_Stats.BackEndNs += m_Timer.nsecsElapsed();
+g_pTestBench->DisplayData(n, 1.0, pOut, m_DemodOutputRate,PROFILE_4);
 			m_InBufPos = 0;
 			ret += n;
 		}
 	}
-	m_Mutex.unlock();
+	m_Stats.Blocks += NumBlocks;
+	m_Stats.GatedBlocks += NumGated;
+	m_OutputSilent = (NumBlocks > 0) && (NumBlocks == NumGated);
+	m_StatsOut.Publish(m_Stats);
 	return ret;
 }
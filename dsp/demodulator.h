@@ -4,6 +4,17 @@
 // History:
 //	2010-09-15  Initial creation MSW
 //	2011-03-27  Initial release
+//	2026-10-18  Added multi-channel PSK mode
+//	2026-10-18  Added multi-channel DSC FSK mode
+//	2026-10-18  Added squelch gate and CPU counters
+//	2026-10-18  Added spectral noise reduction of the audio
+//	2026-10-18  Added LMS auto notch
+//	2026-10-18  Demods come from a pool created with the object
+//	2026-10-18  Runtime settings are passed to the DSP thread in a snapshot
+//	2026-10-18  Work buffers come from a scratch arena sized from the input rate
+//	2026-10-18  Stats report the memory held by the demods
+//	2026-10-18  Mode and sample rate changes are published to ProcessData() too
+//	2026-10-18  Decimation stages are built by the setters and handed over in the snapshot
 /////////////////////////////////////////////////////////////////////
 //==========================================================================================
 // + + +   This Software is released under the "Simplified BSD License"  + + +
@@ -38,10 +49,16 @@
 
 #include <QObject>
 #include <QString>
+#include <QMutex>
+#include <QAtomicInt>
+#include <QElapsedTimer>
 #include "dsp/downconvert.h"
 #include "dsp/fastfir.h"
 #include "smeter.h"
 #include "dsp/agc.h"
+#include "dsp/noisereduce.h"
+#include "dsp/autonotch.h"
+#include "dsp/scratcharena.h"
 #include "dsp/amdemod.h"
 #include "dsp/samdemod.h"
 #include "dsp/fmdemod.h"
@@ -49,6 +66,8 @@
 #include "dsp/ssbdemod.h"
 #include "dsp/pskdemod.h"
 #include "dsp/fskdemod.h"
+#include "interface/multipskdemod.h"
+#include "interface/multifskdemod.h"
 
 #define DEMOD_AM 0		//defines for supported demod modes
 #define DEMOD_SAM 1
@@ -63,11 +82,28 @@
 
 #define NUM_DEMODS 11	//manually update if modify number of demod types
 
-#define MAX_INBUFSIZE 250000	//maximum size of demod input buffer
-								//pick so that worst case decimation leaves
-								//reasonable number of samples to process
+#define INBUF_TIME .01		//seconds of input samples processed per block
 #define MAX_MAGBUFSIZE 32000
 
+#define GATE_PREROLL_TIME .05	//seconds of filtered signal replayed when the squelch gate opens
+#define GATE_HOLD_TIME .3		//seconds squelch must stay closed before the gate closes
+#define MAX_PREROLL 4096
+
+#define DEMOD_POOL_RATE 48000.0	//placeholder rates for creating the demod pool
+#define WFM_DOWNCONVERT_BW 100000.0	//bandwidth the WFM downconverter keeps alias free
+#define WFM_POOL_RATE 250000.0
+
+//demodulator CPU use
+typedef struct _dmstats
+{
+	qint64 FrontEndNs;	//downconvert, filter and S-meter time
+	qint64 BackEndNs;	//AGC and demod time
+	qint64 Blocks;
+	qint64 GatedBlocks;	//blocks that skipped AGC and demod
+	int ScratchBytes;	//memory held by all scratch arenas
+	int DemodBytes;		//memory held by the demod pool and the multi-channel demods
+}tDEMOD_STATS;
+
 typedef struct _sdmd
 {
 	int HiCut;
@@ -91,6 +127,50 @@ typedef struct _sdmd
 	QString txt;	//not saved in settings
 }tDemodInfo;
 
+//decimation stages a setter builds for the next demod chain so the DSP
+// thread only swaps pointers. The DSP thread sets Retired once it has
+// swapped them in and the stages it swapped out are the ones left here.
+typedef struct _dmchain
+{
+	CDownConvert::CChain DownConvert;
+	CWFmDemod::CChains Wfm;		//only built for DEMOD_WFM
+	QAtomicInt Retired;
+}tDEMOD_CHAIN;
+
+//settings that can change while the DSP thread is running. The setters
+// publish a copy that ProcessData() picks up at the start of its next call,
+// so mode and sample rate changes also take effect at a block boundary.
+typedef struct _dmparams
+{
+	int Mode;
+	TYPEREAL InputRate;
+	tDemodInfo Info;
+	int InfoSeq;		//incremented each time Info is published
+	bool MultiPsk;
+	TYPEREAL PskRate;
+	bool MultiFsk;
+	bool USFm;
+	bool SquelchGate;
+	bool NoiseReduceOn;
+	int NoiseReduceLevel;
+	bool AutoNotchOn;
+	tDEMOD_CHAIN* pChain;	//stages for Mode and InputRate, NULL before the first mode is set
+	int ChainSeq;			//incremented each time a new pChain is built
+}tDEMOD_PARAMS;
+
+//one instance of every demod is created with CDemodulator and kept so a
+// mode switch only re-initializes one and points the active pointer at it
+typedef struct _dmpool
+{
+	CAmDemod* pAm;
+	CSamDemod* pSam;
+	CFmDemod* pFm;
+	CWFmDemod* pWFm;
+	CPskDemod* pPsk;
+	CFskDemod* pFsk;
+	CSsbDemod* pSsb;
+}tDEMOD_POOL;
+
 class CDemodulator
 {
 public:
@@ -98,52 +178,133 @@ public:
 	virtual ~CDemodulator();
 
 	void SetInputSampleRate(TYPEREAL InputRate);
-	TYPEREAL GetOutputRate(){return m_DemodOutputRate;}
+	//output rate of the last published mode and sample rate. It is planned
+	// by the setters so it is valid on return before ProcessData() switches.
+	TYPEREAL GetOutputRate(){return m_PlannedOutputRate;}
+	//DSP thread. Picks up the published settings for the next ProcessData()
+	// call and returns the most samples it can put in pOutData for InLength
+	// input samples in any mode. Only changes with the input sample rate.
+	int GetMaxOutputLength(int InLength);
 	TYPEREAL GetSMeterPeak(){return m_SMeter.GetPeak();}
 	TYPEREAL GetSMeterAve(){return m_SMeter.GetAve();}
 	void SetSmeterOffset(TYPEREAL Offset){ m_SMeter.SetSMeterCalibration(Offset);}
 
+	//None of the setters wait for ProcessData()
 	void SetDemod(int Mode, tDemodInfo CurrentDemodInfo);
-	void SetDemodFreq(TYPEREAL Freq){m_DownConvert.SetCwOffset(m_CW_Offset);
-										m_DownConvert.SetFrequency(Freq);}
+	void SetDemodFreq(TYPEREAL Freq){m_DownConvert.SetFrequency(Freq);}	//does not wait
 
 	//overloaded functions to perform demod mono or stereo
 	int ProcessData(int InLength, TYPECPX* pInData, TYPEREAL* pOutData);
 	int ProcessData(int InLength, TYPECPX* pInData, TYPECPX* pOutData);
 
-	void SetUSFmVersion(bool USFm){m_USFm = USFm;}
-	bool GetUSFmVersion(){return m_USFm;}
+	void SetUSFmVersion(bool USFm);
+	bool GetUSFmVersion(){return m_Params.Published().USFm;}
 	void SetPskMode(int index);
+	void SetFskMode(bool Multi);
+
+	//the squelch gate skips AGC, demod and audio resampling while an
+	// audio mode is squelched
+	void SetSquelchGate(bool On);
+	bool IsOutputSilent(){return m_OutputSilent;}	//true if the last ProcessData() output was all gated
+	void GetStats(tDEMOD_STATS* pStats, bool Reset);
+	//Level is the most noise reduction in dB
+	void SetNoiseReduce(bool On, int Level);
+	//the auto notch runs on the SSB baseband after the AGC and on the AM/SAM audio
+	void SetAutoNotch(bool On);
 
 
 	//access to WFM mode status
-	int GetStereoLock(int* pPilotLock){ if(m_pWFmDemod) return m_pWFmDemod->GetStereoLock(pPilotLock); else return false;}
+	int GetStereoLock(int* pPilotLock)
+	{
+		if(DEMOD_WFM == m_Params.Published().Mode) return m_Pool.pWFm->GetStereoLock(pPilotLock); else return false;
+	}
 	int GetNextRdsGroupData(tRDS_GROUPS* pGroupData)
 	{
-		if(m_pWFmDemod) return m_pWFmDemod->GetNextRdsGroupData(pGroupData); else return false;
+		if(DEMOD_WFM == m_Params.Published().Mode) return m_Pool.pWFm->GetNextRdsGroupData(pGroupData); else return false;
+	}
+
+	//access to multi-channel PSK text
+	bool GetNextPskText(tPSK_TEXT* pText)
+	{
+		if(m_pMultiPskDemod) return m_pMultiPskDemod->GetText(pText); else return false;
+	}
+
+	//access to multi-channel FSK text
+	bool GetNextFskText(tFSK_TEXT* pText)
+	{
+		if(m_pMultiFskDemod) return m_pMultiFskDemod->GetText(pText); else return false;
 	}
 
 private:
-	void DeleteAllDemods();
+	void ReleaseDemods();
+	void SelectDemod(int Mode, tDEMOD_CHAIN* pChain);
+	void PublishParams(tDEMOD_PARAMS& Params);
+	void CollectChains();
+	void UpdateParams();
+	void ApplyParams();
+	void ClearStats();
+	static TYPEREAL GetMaxOutputBandwidth(int Mode, const tDemodInfo& Info, bool MultiPsk, bool MultiFsk);
+	void ResetGate();
+	void PlanBuffers();
+	void UpdateNoiseReduce();
+	void UpdateAutoNotch();
+	bool SquelchGate(bool Squelched, int& n);
 	CDownConvert m_DownConvert;
 	CFastFIR m_FastFIR;
 	CAgc m_Agc;
+	CNoiseReduce m_NoiseReduce;
+	CAutoNotch m_AutoNotch;
 	CSMeter m_SMeter;
-	QMutex m_Mutex;		//for keeping threads from stomping on each other
+	QMutex m_Mutex;		//serializes the setters that publish m_Params
+	CParamSnapshot<tDEMOD_PARAMS> m_Params;
+	TYPEREAL m_PlannedOutputRate;	//output rate for the last published m_Params
+	bool m_ParamsTaken;		//GetMaxOutputLength() picked up m_Params for the next ProcessData()
+	QAtomicInt m_NewChainSeq;	//ChainSeq of a built chain the DSP thread has not taken, else 0
+	int m_ChainSeq;			//setters: ChainSeq of m_pPendingChain
+	tDEMOD_CHAIN* m_pPendingChain;	//setters: last chain built, taken or not
+	tDEMOD_CHAIN* m_pRetiringChain;	//setters: chain taken before it, deleted once retired
+	bool m_ChainWfm;		//setters: rates m_pPendingChain was built for
+	TYPEREAL m_ChainInputRate;
+	TYPEREAL m_ChainBW;
+	int m_ChainSeqTaken;	//DSP thread: ChainSeq of the chain in use
+	CParamSnapshot<tDEMOD_STATS> m_StatsOut;	//m_Stats passed from ProcessData() to GetStats()
+	QAtomicInt m_StatsReset;	//set by GetStats() to have ProcessData() clear m_Stats
+	int m_InfoSeq;		//InfoSeq of m_DemodInfo
 	tDemodInfo m_DemodInfo;
 	TYPEREAL m_InputRate;
 	TYPEREAL m_DownConverterOutputRate;
 	TYPEREAL m_DemodOutputRate;
 	TYPEREAL m_DesiredMaxOutputBandwidth;
+	CScratchArena m_Scratch;	//holds the three buffers below
 	TYPECPX* m_pDemodInBuf;
 	TYPECPX* m_pDemodTmpBuf;
 	TYPEREAL m_CW_Offset;
 	TYPEREAL m_PskRate;
 	bool m_USFm;
+	bool m_MultiPsk;
+	bool m_MultiFsk;
+	bool m_SquelchGate;
+	bool m_NoiseReduceOn;
+	int m_NoiseReduceLevel;
+	bool m_AutoNotchOn;
+	bool m_GateClosed;
+	bool m_OutputSilent;
+	int m_SquelchSamples;	//samples since squelch closed
+	int m_GateHoldSamples;
+	int m_PreRollLength;
+	int m_PreRollMax;		//size of m_pPreRollBuf
+	int m_PreRollPos;
+	int m_PreRollCount;
+	int m_SilenceDebt;		//silent samples still to be withheld while the gate is closed
+	TYPECPX* m_pPreRollBuf;
+	tDEMOD_STATS m_Stats;
+	QElapsedTimer m_Timer;
 	int m_DemodMode;
 	int m_InBufPos;
 	int m_InBufLimit;
-	//pointers to all the various implemented demodulator classes
+	int m_BlockOutLength;	//size of m_pDemodTmpBuf, most output samples per block
+	tDEMOD_POOL m_Pool;
+	//pointers to the active demodulator in m_Pool, NULL if not in use
 	CAmDemod* m_pAmDemod;
 	CSamDemod* m_pSamDemod;
 	CFmDemod* m_pFmDemod;
@@ -151,6 +312,8 @@ private:
 	CPskDemod* m_pPskDemod;
 	CFskDemod* m_pFskDemod;
 	CSsbDemod* m_pSsbDemod;	//includes CW modes
+	CMultiPskDemod* m_pMultiPskDemod;	//created by the first multi-channel SetPskMode() and kept so its threads are not restarted
+	CMultiFskDemod* m_pMultiFskDemod;	//created by the first multi-channel SetFskMode()
 };
 
 #endif // DEMODULATOR_H
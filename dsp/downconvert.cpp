@@ -10,6 +10,14 @@
 //	2011-04-20  Changed some scope resolution operators to allow compiling with different compilers
 //	2013-02-01  Fixed issue with missing first coef of HB calculation
 //	2013-07-28  Added single/double precision math macros
+//	2026-10-18  Added vectorized phasor NCO fused with first decimation stage
+//	2026-10-18  Replaced rate threshold tables with decimation chain planner
+//	2026-10-18  Half band stages are now template generated, fixed double counted tap 0
+//	2026-10-18  Tuning frequency is passed to ProcessData() in a lock free snapshot
+//	2026-10-18  Split the chain planner from the builder so the output rate can be planned
+//	2026-10-18  CDownConvert is CDownConvertT<TYPEREAL>, float and double versions are built
+//	2026-10-18  Decimate by 2 stage choice no longer depends on the precision
+//	2026-10-18  Decimation stages are built in a CChain and put in use with SetChain()
 //////////////////////////////////////////////////////////////////////
 //==========================================================================================
 // + + +   This Software is released under the "Simplified BSD License"  + + +
@@ -41,167 +49,462 @@
 //==========================================================================================
 #include "dsp/downconvert.h"
 #include "dsp/filtercoef.h"
+#include "dsp/simdops.h"
 #include "gui/testbench.h"
 #include "interface/perform.h"
 #include <QDebug>
 
 //pick a method of calculating the NCO
+#define NCO_PHASOR 1	//vectorized phasor table fused with first decimation stage
 #define NCO_LIB 0		//normal sin cos library (188nS)
-#define NCO_OSC 1		//quadrature oscillator (25nS)
+#define NCO_OSC 0		//quadrature oscillator (25nS)
 #define NCO_VCASM 0		//Visual C assembly call to floating point sin/cos instruction
 #define NCO_GCCASM 0	//GCC assembly call to floating point sin/cos instruction (100nS)
 
 #define MIN_OUTPUT_RATE (7900.0*2.0)
+#define WFM_MAX_OUTPUT_RATE 400000.0
 
-#define MAX_HALF_BAND_BUFSIZE 32768
+#define MAX_POW2_DECIMATION 256		//caller block sizes are only guaranteed to be a multiple of this
+#define DOWNSTREAM_MACS 64.0		//rough cost per output sample of the processing after the downconverter
+
+#define NCO_RENORM_BLOCKS 16	//phasor magnitude is corrected every NCO_RENORM_BLOCKS*NCO_LANES samples
+
+//////////////////////////////////////////////////////////////////////
+// Table of the fixed decimate by 2 stages in order of increasing cost.
+// MaxBW is the normalized alias free bandwidth from filtercoef.h
+// Macs is the number of multiplies per input sample.
+//////////////////////////////////////////////////////////////////////
+typedef struct _dec2
+{
+	TYPEREAL MaxBW;
+	int Length;			//0 for CIC
+	TYPEREAL Macs;
+}tDec2Stage;
+
+#define HB_MACS(len) ( ( (TYPEREAL)((len+1)/4) + 1.0)/2.0 )	//folded even taps plus center tap at half rate
+static const tDec2Stage DEC2_STAGES[] =
+{
+	{CIC3_MAX, 0, 1.0},
+	{HB11TAP_MAX, HB11TAP_LENGTH, HB_MACS(HB11TAP_LENGTH)},
+	{HB15TAP_MAX, HB15TAP_LENGTH, HB_MACS(HB15TAP_LENGTH)},
+	{HB19TAP_MAX, HB19TAP_LENGTH, HB_MACS(HB19TAP_LENGTH)},
+	{HB23TAP_MAX, HB23TAP_LENGTH, HB_MACS(HB23TAP_LENGTH)},
+	{HB27TAP_MAX, HB27TAP_LENGTH, HB_MACS(HB27TAP_LENGTH)},
+	{HB31TAP_MAX, HB31TAP_LENGTH, HB_MACS(HB31TAP_LENGTH)},
+	{HB35TAP_MAX, HB35TAP_LENGTH, HB_MACS(HB35TAP_LENGTH)},
+	{HB39TAP_MAX, HB39TAP_LENGTH, HB_MACS(HB39TAP_LENGTH)},
+	{HB43TAP_MAX, HB43TAP_LENGTH, HB_MACS(HB43TAP_LENGTH)},
+	{HB47TAP_MAX, HB47TAP_LENGTH, HB_MACS(HB47TAP_LENGTH)},
+	{HB51TAP_MAX, HB51TAP_LENGTH, HB_MACS(HB51TAP_LENGTH)}
+};
+#define NUM_DEC2_STAGES ( (int)(sizeof(DEC2_STAGES)/sizeof(tDec2Stage)) )
 
 
 //////////////////////////////////////////////////////////////////////
 // Construction/Destruction
 //////////////////////////////////////////////////////////////////////
-CDownConvert::CDownConvert()
+template <typename T>
+CDownConvertT<T>::CDownConvertT()
 {
 int i;
 	m_NcoInc = 0.0;
 	m_NcoTime = 0.0;
 	m_NcoFreq = 0.0;
+	m_TuneFreq.Publish(0.0);
+	m_TuneFreq.Update();
 	m_CW_Offset = 0.0;
 	m_InRate = 100000.0;
 	m_MaxBW = 10000.0;
+	m_Astop = DEF_DECIMATION_ASTOP;
+	m_OutputRate = m_InRate;
+	m_MacsPerSample = 0.0;
 	for(i=0; i<MAX_DECSTAGES; i++)
 		m_pDecimatorPtrs[i] = NULL;
 	m_Osc1.re = 1.0;	//initialize unit vector that will get rotated
 	m_Osc1.im = 0.0;
 }
 
-CDownConvert::~CDownConvert()
+template <typename T>
+CDownConvertT<T>::~CDownConvertT()
 {
-	DeleteFilters();
+	DeleteStages(m_pDecimatorPtrs);
 }
 
 //////////////////////////////////////////////////////////////////////
-// Delete all active Filters in m_pDecimatorPtrs array
+// Delete all active Filters in a MAX_DECSTAGES long stage array
 //////////////////////////////////////////////////////////////////////
-void CDownConvert::DeleteFilters()
+template <typename T>
+void CDownConvertT<T>::DeleteStages(CDec2** pStages)
 {
 	for(int i=0; i<MAX_DECSTAGES; i++)
 	{
-		if(m_pDecimatorPtrs[i])
+		if(pStages[i])
 		{
-			delete m_pDecimatorPtrs[i];
-			m_pDecimatorPtrs[i] = NULL;
+			delete pStages[i];
+			pStages[i] = NULL;
 		}
 	}
 }
 
 //////////////////////////////////////////////////////////////////////
-// Sets NCO Frequency parameters
+// Puts the stages built in Chain in use.  The stages in use are
+//swapped into Chain so they are deleted along with it on the thread
+//that built it.  Nothing is allocated or freed here.
+// Returns the output sample rate.
+//////////////////////////////////////////////////////////////////////
+template <typename T>
+T CDownConvertT<T>::SetChain(CChain& Chain)
+{
+	for(int i=0; i<MAX_DECSTAGES; i++)
+	{
+		CDec2* pStage = m_pDecimatorPtrs[i];
+		m_pDecimatorPtrs[i] = Chain.m_pStages[i];
+		Chain.m_pStages[i] = pStage;
+	}
+	m_InRate = Chain.m_InRate;
+	m_MaxBW = Chain.m_MaxBW;
+	m_Astop = Chain.m_Astop;
+	m_OutputRate = Chain.m_OutputRate;
+	m_MacsPerSample = Chain.m_MacsPerSample;
+	UpdateNco();
+	return m_OutputRate;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Sets NCO Frequency. The DSP thread picks it up at the start of the
+//next ProcessData() call so tuning never waits for a block.
 //////////////////////////////////////////////////////////////////////
-void CDownConvert::SetFrequency(TYPEREAL NcoFreq)
+template <typename T>
+void CDownConvertT<T>::SetFrequency(T NcoFreq)
 {
-TYPEREAL tmpf = NcoFreq + m_CW_Offset;
+	m_TuneFreq.Publish(NcoFreq);
+}
 
-	m_NcoFreq = tmpf;
+//////////////////////////////////////////////////////////////////////
+// Sets the CW offset added to the tuning frequency
+//////////////////////////////////////////////////////////////////////
+template <typename T>
+void CDownConvertT<T>::SetCwOffset(T offset)
+{
+	m_CW_Offset = offset;
+	UpdateNco();
+}
+
+//////////////////////////////////////////////////////////////////////
+// Sets the NCO from the latest tuning frequency, CW offset and
+//input rate
+//////////////////////////////////////////////////////////////////////
+template <typename T>
+void CDownConvertT<T>::UpdateNco()
+{
+	m_NcoFreq = m_TuneFreq.Get() + m_CW_Offset;
 	m_NcoInc = K_2PI*m_NcoFreq/m_InRate;
-	m_OscCos = MCOS(m_NcoInc);
-	m_OscSin = MSIN(m_NcoInc);
+	m_OscCos = Prec::Cos(m_NcoInc);
+	m_OscSin = Prec::Sin(m_NcoInc);
+	m_Nco.SetPhaseInc(m_NcoInc);
 //qDebug()<<"NCO "<<m_NcoFreq;
 }
 
 //////////////////////////////////////////////////////////////////////
 // Calculates sequence and number of decimation stages based on
 // input sample rate and desired output bandwidth.  Returns final output rate
-//from divide by 2 stages.
+//from the decimation stages.
+// MaxBW is the bandwidth that must be kept alias free and Astop is
+//the alias rejection used to design any polyphase stages.
 //////////////////////////////////////////////////////////////////////
-TYPEREAL CDownConvert::SetDataRate(TYPEREAL InRate, TYPEREAL MaxBW)
+template <typename T>
+T CDownConvertT<T>::SetDataRate(T InRate, T MaxBW, T Astop)
 {
-int n = 0;
-TYPEREAL f = InRate;
 	if( (m_InRate!=InRate) ||
-		(m_MaxBW!=MaxBW) )
+		(m_MaxBW!=MaxBW) ||
+		(m_Astop!=Astop) )
 	{
-		m_InRate = InRate;
-		m_MaxBW = MaxBW;
-		m_Mutex.lock();
-		DeleteFilters();
-		//loop until closest output rate is found and list of pointers to decimate by 2 stages is generated
-		while( (f > (m_MaxBW / HB51TAP_MAX) ) && (f > MIN_OUTPUT_RATE) )
-		{
-			if(f >= (m_MaxBW / CIC3_MAX) )		//See if can use CIC order 3
-				m_pDecimatorPtrs[n++] =
-						new CCicN3DecimateBy2;
-			else if(f >= (m_MaxBW / HB11TAP_MAX) )	//See if can use fixed 11 Tap Halfband
-				m_pDecimatorPtrs[n++] =
-						new CHalfBand11TapDecimateBy2();
-			else if(f >= (m_MaxBW / HB15TAP_MAX) )	//See if can use Halfband 15 Tap
-				m_pDecimatorPtrs[n++] =
-						new CHalfBandDecimateBy2(HB15TAP_LENGTH, HB15TAP_H);
-			else if(f >= (m_MaxBW / HB19TAP_MAX) )	//See if can use Halfband 19 Tap
-				m_pDecimatorPtrs[n++] =
-						new CHalfBandDecimateBy2(HB19TAP_LENGTH, HB19TAP_H);
-			else if(f >= (m_MaxBW / HB23TAP_MAX) )	//See if can use Halfband 23 Tap
-				m_pDecimatorPtrs[n++] =
-						new CHalfBandDecimateBy2(HB23TAP_LENGTH, HB23TAP_H);
-			else if(f >= (m_MaxBW / HB27TAP_MAX) )	//See if can use Halfband 27 Tap
-				m_pDecimatorPtrs[n++] =
-						new CHalfBandDecimateBy2(HB27TAP_LENGTH, HB27TAP_H);
-			else if(f >= (m_MaxBW / HB31TAP_MAX) )	//See if can use Halfband 31 Tap
-				m_pDecimatorPtrs[n++] =
-						new CHalfBandDecimateBy2(HB31TAP_LENGTH, HB31TAP_H);
-			else if(f >= (m_MaxBW / HB35TAP_MAX) )	//See if can use Halfband 35 Tap
-				m_pDecimatorPtrs[n++] =
-						new CHalfBandDecimateBy2(HB35TAP_LENGTH, HB35TAP_H);
-			else if(f >= (m_MaxBW / HB39TAP_MAX) )	//See if can use Halfband 39 Tap
-				m_pDecimatorPtrs[n++] =
-						new CHalfBandDecimateBy2(HB39TAP_LENGTH, HB39TAP_H);
-			else if(f >= (m_MaxBW / HB43TAP_MAX) )	//See if can use Halfband 43 Tap
-				m_pDecimatorPtrs[n++] =
-						new CHalfBandDecimateBy2(HB43TAP_LENGTH, HB43TAP_H);
-			else if(f >= (m_MaxBW / HB47TAP_MAX) )	//See if can use Halfband 47 Tap
-				m_pDecimatorPtrs[n++] =
-						new CHalfBandDecimateBy2(HB47TAP_LENGTH, HB47TAP_H);
-			else if(f >= (m_MaxBW / HB51TAP_MAX) )	//See if can use Halfband 51 Tap
-				m_pDecimatorPtrs[n++] =
-						new CHalfBandDecimateBy2(HB51TAP_LENGTH, HB51TAP_H);
-			f /= 2.0;
-		}
-		m_Mutex.unlock();
-		m_OutputRate = f;
-		SetFrequency(m_NcoFreq);
-qDebug()<<"Filters "<<n<< " Fin="<<InRate<<" BW="<<m_MaxBW<<" fout="<<m_OutputRate;
+		CChain Chain;
+		Chain.Build(InRate, MaxBW, Astop);
+		SetChain(Chain);
 	}
 	return m_OutputRate;
 }
 
+//////////////////////////////////////////////////////////////////////
+// Returns the output rate SetDataRate() gives for these parameters
+//without building the chain. Does not touch the object so it can be
+//called from any thread.
+//////////////////////////////////////////////////////////////////////
+template <typename T>
+T CDownConvertT<T>::GetDataRate(T InRate, T MaxBW, T Astop)
+{
+int K;
+int M;
+T Cost;
+	return PlanChain(InRate, MaxBW, Astop, MinOutputRate(MaxBW), true, &K, &M, &Cost);
+}
+
+//////////////////////////////////////////////////////////////////////
+// Lowest output rate SetDataRate() plans for. The output rate must be
+//above half of the old threshold for continuing to divide by 2.
+//////////////////////////////////////////////////////////////////////
+template <typename T>
+T CDownConvertT<T>::MinOutputRate(T MaxBW)
+{
+	T MinOutRate = MaxBW / HB51TAP_MAX;
+	if(MinOutRate < MIN_OUTPUT_RATE)
+		MinOutRate = MIN_OUTPUT_RATE;
+	return MinOutRate/2.0;
+}
+
 //////////////////////////////////////////////////////////////////////
 // Calculates sequence and number of decimation stages for WBFM based on
 // input sample rate and desired output bandwidth.  Returns final output rate
 //from divide by 2 stages.
+// Only power of 2 decimation is used so the block lengths passed on to
+//the RDS downconverter stay even.
 //////////////////////////////////////////////////////////////////////
-TYPEREAL CDownConvert::SetWfmDataRate(TYPEREAL InRate, TYPEREAL MaxBW)
+template <typename T>
+T CDownConvertT<T>::SetWfmDataRate(T InRate, T MaxBW)
 {
-int n = 0;
-TYPEREAL f = InRate;
 	if( (m_InRate!=InRate) ||
 		(m_MaxBW!=MaxBW) )
 	{
-		m_InRate = InRate;
-		m_MaxBW = MaxBW;
-		m_Mutex.lock();
-		DeleteFilters();
-		//loop until closest output rate is found and list of pointers to decimate by 2 stages is generated
-		while( (f > 400000.0)  )
+		CChain Chain;
+		Chain.BuildWfm(InRate, MaxBW);
+		SetChain(Chain);
+	}
+	return m_OutputRate;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Returns the output rate SetWfmDataRate() gives for these parameters
+//without building the chain.
+//////////////////////////////////////////////////////////////////////
+template <typename T>
+T CDownConvertT<T>::GetWfmDataRate(T InRate, T MaxBW)
+{
+int K;
+int M;
+T Cost;
+	return PlanChain(InRate, MaxBW, DEF_DECIMATION_ASTOP, WFM_MAX_OUTPUT_RATE/2.0, false, &K, &M, &Cost);
+}
+
+//////////////////////////////////////////////////////////////////////
+// Returns the index into DEC2_STAGES[] of the cheapest decimate by 2 stage
+//that keeps MaxBW alias free at input rate 'Rate'.
+// If none can, the longest half band is returned.
+//////////////////////////////////////////////////////////////////////
+template <typename T>
+int CDownConvertT<T>::PickDecBy2(T Rate, T MaxBW)
+{
+	for(int i=0; i<NUM_DEC2_STAGES; i++)
+	{	//compared in double so the float and double chains pick the same stage
+		if( (tDReal)Rate >= ((tDReal)MaxBW / DEC2_STAGES[i].MaxBW) )
+			return i;
+	}
+	return NUM_DEC2_STAGES-1;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Creates decimate by 2 stage of type DEC2_STAGES[Type]
+//////////////////////////////////////////////////////////////////////
+template <typename T>
+typename CDownConvertT<T>::CDec2* CDownConvertT<T>::CreateDecBy2(int Type)
+{
+	switch(DEC2_STAGES[Type].Length)
+	{
+		case 0:
+			return new CCicN3DecimateBy2;
+		case HB11TAP_LENGTH:
+			return new CHalfBandDecimateBy2<HB11TAP_LENGTH, HB11TAP_H>;
+		case HB15TAP_LENGTH:
+			return new CHalfBandDecimateBy2<HB15TAP_LENGTH, HB15TAP_H>;
+		case HB19TAP_LENGTH:
+			return new CHalfBandDecimateBy2<HB19TAP_LENGTH, HB19TAP_H>;
+		case HB23TAP_LENGTH:
+			return new CHalfBandDecimateBy2<HB23TAP_LENGTH, HB23TAP_H>;
+		case HB27TAP_LENGTH:
+			return new CHalfBandDecimateBy2<HB27TAP_LENGTH, HB27TAP_H>;
+		case HB31TAP_LENGTH:
+			return new CHalfBandDecimateBy2<HB31TAP_LENGTH, HB31TAP_H>;
+		case HB35TAP_LENGTH:
+			return new CHalfBandDecimateBy2<HB35TAP_LENGTH, HB35TAP_H>;
+		case HB39TAP_LENGTH:
+			return new CHalfBandDecimateBy2<HB39TAP_LENGTH, HB39TAP_H>;
+		case HB43TAP_LENGTH:
+			return new CHalfBandDecimateBy2<HB43TAP_LENGTH, HB43TAP_H>;
+		case HB47TAP_LENGTH:
+			return new CHalfBandDecimateBy2<HB47TAP_LENGTH, HB47TAP_H>;
+		default:
+			return new CHalfBandDecimateBy2<HB51TAP_LENGTH, HB51TAP_H>;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+// Decimation chain planner.
+// Every total decimation D that gives an output rate above MinOutRate
+//and within a factor of 2 of the lowest such rate is tried.
+// D is split into 2^k decimate by 2 stages (the cheapest stage that
+//keeps MaxBW alias free is used at each rate) followed by a polyphase
+//section for the remaining factor D/2^k.
+// The plan with the lowest cost, counting the multiplies per input sample
+//of the chain plus DOWNSTREAM_MACS per output sample, is returned in
+//*pK(decimate by 2 stages), *pM(polyphase factor) and *pCost(chain
+//multiplies per input sample).  If UsePolyphase is false only D = 2^k is
+//tried.  Nothing is built so the planned rate can be found up front.
+// Returns the output sample rate.
+//////////////////////////////////////////////////////////////////////
+template <typename T>
+T CDownConvertT<T>::PlanChain(T InRate, T MaxBW, T Astop,
+								 T MinOutRate, bool UsePolyphase,
+								 int* pK, int* pM, T* pCost)
+{
+int Dmax = 1;
+int BestK = 0;
+int BestM = 1;
+T BestCost = 1e30;
+T BestChainCost = 0.0;
+int Factors[MAX_POLYPHASE_STAGES];
+int NumStages;
+	//find largest decimation with output rate still above MinOutRate
+	while( (InRate/(Dmax+1)) > MinOutRate )
+		Dmax++;
+	if(!UsePolyphase)
+	{	//largest power of 2
+		int d = 1;
+		while( (d*2) <= Dmax )
+			d *= 2;
+		Dmax = d;
+	}
+	for(int D=Dmax; (D>=1) && (2*D>Dmax); D--)
+	{
+		int k = 0;
+		int pow2 = 1;
+		while( ((D % (pow2*2)) == 0) && (pow2 < MAX_POW2_DECIMATION) && (k < MAX_DECSTAGES-2) )
+		{
+			pow2 *= 2;
+			k++;
+		}
+		for( ; k>=0; k--, pow2/=2)
 		{
-			m_pDecimatorPtrs[n++] = new CDownConvert::CHalfBandDecimateBy2(HB51TAP_LENGTH, HB51TAP_H);
-			f /= 2.0;
+			int M = D/pow2;
+			if( !UsePolyphase && (M>1) )
+				continue;
+			T f = InRate;
+			T scale = 1.0;
+			T cost = 0.0;
+			for(int i=0; i<k; i++)
+			{
+				cost += scale*DEC2_STAGES[PickDecBy2(f, MaxBW)].Macs;
+				scale *= 0.5;
+				f *= 0.5;
+			}
+			if(M > 1)
+			{
+				T pcost = CMultiStageDecimateT<T>::PlanStages(M, MaxBW, Astop, f,
+															Factors, &NumStages);
+				if(pcost < 0.0)
+					continue;	//can't keep MaxBW alias free
+				cost += scale*pcost;
+			}
+			T total = cost + DOWNSTREAM_MACS/(T)D;
+			if(total < BestCost)
+			{
+				BestCost = total;
+				BestChainCost = cost;
+				BestK = k;
+				BestM = M;
+			}
 		}
-		m_OutputRate = f;
-		m_Mutex.unlock();
-		SetFrequency(m_NcoFreq);
 	}
+	*pK = BestK;
+	*pM = BestM;
+	*pCost = BestChainCost;
+	T f = InRate;
+	for(int i=0; i<BestK; i++)
+		f /= 2.0;
+	if(BestM > 1)
+		f /= BestM;
+	return f;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Chain Construction/Destruction
+//////////////////////////////////////////////////////////////////////
+template <typename T>
+CDownConvertT<T>::CChain::CChain()
+{
+	m_InRate = 0.0;
+	m_MaxBW = 0.0;
+	m_Astop = DEF_DECIMATION_ASTOP;
+	m_OutputRate = 0.0;
+	m_MacsPerSample = 0.0;
+	for(int i=0; i<MAX_DECSTAGES; i++)
+		m_pStages[i] = NULL;
+}
+
+template <typename T>
+CDownConvertT<T>::CChain::~CChain()
+{
+	DeleteStages(m_pStages);
+}
+
+//////////////////////////////////////////////////////////////////////
+// Plans and builds the stages SetDataRate() uses for these parameters.
+// Returns the output sample rate.
+//////////////////////////////////////////////////////////////////////
+template <typename T>
+T CDownConvertT<T>::CChain::Build(T InRate, T MaxBW, T Astop)
+{
+int K;
+int M;
+	m_InRate = InRate;
+	m_MaxBW = MaxBW;
+	m_Astop = Astop;
+	PlanChain(m_InRate, m_MaxBW, m_Astop, MinOutputRate(m_MaxBW), true, &K, &M, &m_MacsPerSample);
+	BuildStages(K, M);
 	return m_OutputRate;
 }
 
+//////////////////////////////////////////////////////////////////////
+// Plans and builds the stages SetWfmDataRate() uses for these parameters.
+// Returns the output sample rate.
+//////////////////////////////////////////////////////////////////////
+template <typename T>
+T CDownConvertT<T>::CChain::BuildWfm(T InRate, T MaxBW)
+{
+int K;
+int M;
+	m_InRate = InRate;
+	m_MaxBW = MaxBW;
+	m_Astop = DEF_DECIMATION_ASTOP;
+	PlanChain(m_InRate, m_MaxBW, m_Astop, WFM_MAX_OUTPUT_RATE/2.0, false, &K, &M, &m_MacsPerSample);
+	BuildStages(K, M);
+	return m_OutputRate;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Builds the chain planned by PlanChain() into m_pStages[]
+//for m_InRate and m_MaxBW.  K decimate by 2 stages are followed by a
+//polyphase stage if M > 1.  Sets m_OutputRate.
+//////////////////////////////////////////////////////////////////////
+template <typename T>
+void CDownConvertT<T>::CChain::BuildStages(int K, int M)
+{
+	DeleteStages(m_pStages);
+	int n = 0;
+	T f = m_InRate;
+	for(int i=0; i<K; i++)
+	{
+		m_pStages[n++] = CreateDecBy2(PickDecBy2(f, m_MaxBW));
+		f /= 2.0;
+	}
+	if(M > 1)
+	{
+		m_pStages[n++] = new CPolyphaseDecimate(M, m_MaxBW, m_Astop, f);
+		f /= M;
+	}
+	m_OutputRate = f;
+qDebug()<<"Filters "<<n<<" Fin="<<m_InRate<<" BW="<<m_MaxBW<<" fout="<<f<<" Dec2="<<K<<" M="<<M<<" MACs/samp="<<m_MacsPerSample;
+}
+
 //////////////////////////////////////////////////////////////////////
 // Processes 'InLength' I/Q samples of 'pInData' buffer
 // and places in 'pOutData' buffer.
@@ -213,20 +516,36 @@ TYPEREAL f = InRate;
 // decimation by 2 stages expected.
 // ~50nSec/sample at decimation by 128
 //////////////////////////////////////////////////////////////////////
-int CDownConvert::ProcessData(int InLength, TYPECPX* pInData, TYPECPX* pOutData)
+template <typename T>
+int CDownConvertT<T>::ProcessData(int InLength, Cpx* pInData, Cpx* pOutData)
 {
 int i,j;
-TYPECPX dtmp;
-TYPECPX Osc;
+int n;
 
 //StartPerformance();
+	if(m_TuneFreq.Update())
+		UpdateNco();	//new tuning frequency takes effect at the block boundary
+
+#if NCO_PHASOR
+	//shift frequency and do the first decimation stage in one pass
+	j = 0;
+	if(m_pDecimatorPtrs[0])
+		n = m_pDecimatorPtrs[j++]->MixDecBy2(m_Nco, InLength, pInData, pInData);
+	else
+	{
+		m_Nco.Mix(InLength, pInData, pInData);
+		n = InLength;
+	}
+#else
+Cpx dtmp;
+Cpx Osc;
 
 #if (NCO_VCASM || NCO_GCCASM)
-TYPEREAL	dPhaseAcc = m_NcoTime;
-TYPEREAL	dASMCos   = 0.0;
-TYPEREAL	dASMSin   = 0.0;
-TYPEREAL*	pdCosAns  = &dASMCos;
-TYPEREAL*	pdSinAns  = &dASMSin;
+T	dPhaseAcc = m_NcoTime;
+T	dASMCos   = 0.0;
+T	dASMSin   = 0.0;
+T*	pdCosAns  = &dASMCos;
+T*	pdSinAns  = &dASMSin;
 #endif
 
 //263uS using sin/cos or 70uS using quadrature osc or 200uS using _asm
@@ -234,11 +553,11 @@ TYPEREAL*	pdSinAns  = &dASMSin;
 	{
 		dtmp = pInData[i];
 #if NCO_LIB
-		Osc.re = MCOS(m_NcoTime);
-		Osc.im = MSIN(m_NcoTime);
+		Osc.re = Prec::Cos(m_NcoTime);
+		Osc.im = Prec::Sin(m_NcoTime);
 		m_NcoTime += m_NcoInc;
 #elif NCO_OSC
-		TYPEREAL OscGn;
+		T OscGn;
 		Osc.re = m_Osc1.re * m_OscCos - m_Osc1.im * m_OscSin;
 		Osc.im = m_Osc1.im * m_OscCos + m_Osc1.re * m_OscSin;
 		OscGn = 1.95 - (m_Osc1.re*m_Osc1.re + m_Osc1.im*m_Osc1.im);
@@ -271,21 +590,20 @@ TYPEREAL*	pdSinAns  = &dASMSin;
 #if (NCO_VCASM || NCO_GCCASM)
 	m_NcoTime = dPhaseAcc;
 #elif !NCO_OSC
-	m_NcoTime = MFMOD(m_NcoTime, K_2PI);	//keep radian counter bounded
+	m_NcoTime = Prec::Fmod(m_NcoTime, K_2PI);	//keep radian counter bounded
+#endif
+	n = InLength;
+	j = 0;
 #endif
 
 	//now perform decimation of pInData by calling decimate by 2 stages
 	//until NULL pointer encountered designating end of chain
-	int n = InLength;
-	j = 0;
-	m_Mutex.lock();
 	while(m_pDecimatorPtrs[j])
 	{
 		n = m_pDecimatorPtrs[j++]->DecBy2(n, pInData, pInData);
 //if(1==j)
-//g_pTestBench->DisplayData(n, 1.0, (TYPECPX*)pInData, 615385/2.0);
+//g_pTestBench->DisplayData(n, 1.0, (Cpx*)pInData, 615385/2.0);
 	}
-	m_Mutex.unlock();
 	for(i=0; i<n; i++)
 		pOutData[i] = pInData[i];
 //StopPerformance(InLength);
@@ -295,161 +613,313 @@ TYPEREAL*	pdSinAns  = &dASMSin;
 // *&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*
 
 //////////////////////////////////////////////////////////////////////
-//Decimate by 2 Halfband filter class implementation
+//Phasor table NCO class implementation
 //////////////////////////////////////////////////////////////////////
-CDownConvert::CHalfBandDecimateBy2::CHalfBandDecimateBy2(int len,const TYPEREAL* pCoef )
-	: m_FirLength(len), m_pCoef(pCoef)
+template <typename T>
+CDownConvertT<T>::CNco::CNco()
 {
-	//create buffer for FIR implementation
-	m_pHBFirBuf = new TYPECPX[MAX_HALF_BAND_BUFSIZE];
-	TYPECPX CPXZERO = {0.0,0.0};
-	for(int i=0; i<MAX_HALF_BAND_BUFSIZE ;i++)
-		m_pHBFirBuf[i] = CPXZERO;
+	for(int k=0; k<NCO_LANES; k++)
+	{
+		m_Re[k] = 1.0;
+		m_Im[k] = 0.0;
+	}
+	m_RenormCount = 0;
+	SetPhaseInc(0.0);
 }
 
 //////////////////////////////////////////////////////////////////////
-// Half band filter and decimate by 2 function.
-// Two restrictions on this routine:
-// InLength must be larger or equal to the Number of Halfband Taps
-// InLength must be an even number  ~37nS
+// Sets the phase increment in radians per sample.
+// The lanes are re-spread from lane 0 so the phase stays continuous.
+//////////////////////////////////////////////////////////////////////
+template <typename T>
+void CDownConvertT<T>::CNco::SetPhaseInc(T PhaseInc)
+{
+	m_IncRe = Prec::Cos(PhaseInc);
+	m_IncIm = Prec::Sin(PhaseInc);
+	m_StepRe = Prec::Cos(NCO_LANES*PhaseInc);
+	m_StepIm = Prec::Sin(NCO_LANES*PhaseInc);
+	for(int k=1; k<NCO_LANES; k++)
+	{
+		m_Re[k] = m_Re[k-1]*m_IncRe - m_Im[k-1]*m_IncIm;
+		m_Im[k] = m_Re[k-1]*m_IncIm + m_Im[k-1]*m_IncRe;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+// Shift NCO_LANES samples of pInData and put the I and Q results in
+//pRe[] and pIm[] then rotate all the lanes ahead by NCO_LANES samples.
+// Every NCO_RENORM_BLOCKS calls the phasor magnitudes are pulled back
+//to one with one Newton step of 1/sqrt(x) since x is always close to 1.
 //////////////////////////////////////////////////////////////////////
-int CDownConvert::CHalfBandDecimateBy2::DecBy2(int InLength, TYPECPX* pInData, TYPECPX* pOutData)
+template <typename T>
+inline void CDownConvertT<T>::CNco::MixLanes(const Cpx* pInData, T* pRe, T* pIm)
 {
+	int k;
+	for(k=0; k<NCO_LANES; k++)
+	{	//Cpx multiply by shift frequency
+		pRe[k] = pInData[k].re * m_Re[k] - pInData[k].im * m_Im[k];
+		pIm[k] = pInData[k].re * m_Im[k] + pInData[k].im * m_Re[k];
+	}
+	for(k=0; k<NCO_LANES; k++)
+	{	//rotate phasors
+		T re = m_Re[k] * m_StepRe - m_Im[k] * m_StepIm;
+		m_Im[k] = m_Re[k] * m_StepIm + m_Im[k] * m_StepRe;
+		m_Re[k] = re;
+	}
+	if(++m_RenormCount >= NCO_RENORM_BLOCKS)
+	{
+		m_RenormCount = 0;
+		for(k=0; k<NCO_LANES; k++)
+		{
+			T gn = 1.5 - 0.5*(m_Re[k]*m_Re[k] + m_Im[k]*m_Im[k]);
+			m_Re[k] *= gn;
+			m_Im[k] *= gn;
+		}
+	}
+}
+
+#if USE_SSE
+//////////////////////////////////////////////////////////////////////
+// Single precision version, all NCO_LANES lanes in one SSE register
+//////////////////////////////////////////////////////////////////////
+template <>
+inline void CDownConvertT<tSReal>::CNco::MixLanes(const tSComplex* pInData, tSReal* pRe, tSReal* pIm)
+{
+	__m128 a = _mm_loadu_ps(&pInData[0].re);	//I0 Q0 I1 Q1
+	__m128 b = _mm_loadu_ps(&pInData[2].re);	//I2 Q2 I3 Q3
+	__m128 xre = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2,0,2,0));
+	__m128 xim = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3,1,3,1));
+	__m128 ore = _mm_loadu_ps(m_Re);
+	__m128 oim = _mm_loadu_ps(m_Im);
+	//Cpx multiply by shift frequency
+	_mm_storeu_ps(pRe, _mm_sub_ps(_mm_mul_ps(xre, ore), _mm_mul_ps(xim, oim)) );
+	_mm_storeu_ps(pIm, _mm_add_ps(_mm_mul_ps(xre, oim), _mm_mul_ps(xim, ore)) );
+	//rotate phasors
+	__m128 sre = _mm_set1_ps(m_StepRe);
+	__m128 sim = _mm_set1_ps(m_StepIm);
+	__m128 nre = _mm_sub_ps(_mm_mul_ps(ore, sre), _mm_mul_ps(oim, sim));
+	__m128 nim = _mm_add_ps(_mm_mul_ps(ore, sim), _mm_mul_ps(oim, sre));
+	if(++m_RenormCount >= NCO_RENORM_BLOCKS)
+	{
+		m_RenormCount = 0;
+		__m128 mag = _mm_add_ps(_mm_mul_ps(nre, nre), _mm_mul_ps(nim, nim));
+		__m128 gn = _mm_sub_ps(_mm_set1_ps(1.5f), _mm_mul_ps(_mm_set1_ps(0.5f), mag));
+		nre = _mm_mul_ps(nre, gn);
+		nim = _mm_mul_ps(nim, gn);
+	}
+	_mm_storeu_ps(m_Re, nre);
+	_mm_storeu_ps(m_Im, nim);
+}
+#endif
+
+//////////////////////////////////////////////////////////////////////
+// Shift a single sample with lane 0 then move every lane up one
+//sample. Only used for the odd samples at the end of a block.
+//////////////////////////////////////////////////////////////////////
+template <typename T>
+inline void CDownConvertT<T>::CNco::MixOne(const Cpx& In, Cpx& Out)
+{
+	Cpx tmp = In;
+	Out.re = tmp.re * m_Re[0] - tmp.im * m_Im[0];
+	Out.im = tmp.re * m_Im[0] + tmp.im * m_Re[0];
+	int k;
+	for(k=0; k<NCO_LANES-1; k++)
+	{
+		m_Re[k] = m_Re[k+1];
+		m_Im[k] = m_Im[k+1];
+	}
+	T re = m_Re[k] * m_IncRe - m_Im[k] * m_IncIm;
+	m_Im[k] = m_Re[k] * m_IncIm + m_Im[k] * m_IncRe;
+	m_Re[k] = re;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Frequency shift InLength samples of pInData into pOutData.
+// pOutData can be the same as pInData.
+//////////////////////////////////////////////////////////////////////
+template <typename T>
+void CDownConvertT<T>::CNco::Mix(int InLength, Cpx* pInData, Cpx* pOutData)
+{
+T re[NCO_LANES];
+T im[NCO_LANES];
 int i;
-int j;
-int numoutsamples = 0;
-	if(InLength<m_FirLength)	//safety net to make sure InLength is large enough to process
-		return InLength/2;
-//StartPerformance();
-	//copy input samples into buffer starting at position m_FirLength-1
-	for(i=0,j = m_FirLength - 1; i<InLength; i++)
-		m_pHBFirBuf[j++] = pInData[i];
-	//perform decimation FIR filter on even samples
-	for(i=0; i<InLength; i+=2)
+	for(i=0; i<=(InLength-NCO_LANES); i+=NCO_LANES)
 	{
-		TYPECPX acc;
-		acc.re = ( m_pHBFirBuf[i].re * m_pCoef[0] );
-		acc.im = ( m_pHBFirBuf[i].im * m_pCoef[0] );
-		for(j=0; j<m_FirLength; j+=2)	//only use even coefficients since odd are zero(except center point)
+		MixLanes(&pInData[i], re, im);
+		for(int k=0; k<NCO_LANES; k++)
 		{
-			acc.re += ( m_pHBFirBuf[i+j].re * m_pCoef[j] );
-			acc.im += ( m_pHBFirBuf[i+j].im * m_pCoef[j] );
+			pOutData[i+k].re = re[k];
+			pOutData[i+k].im = im[k];
 		}
-		//now multiply the center coefficient
-		acc.re += ( m_pHBFirBuf[i+(m_FirLength-1)/2].re * m_pCoef[(m_FirLength-1)/2] );
-		acc.im += ( m_pHBFirBuf[i+(m_FirLength-1)/2].im * m_pCoef[(m_FirLength-1)/2] );
-		pOutData[numoutsamples++] = acc;	//put output buffer
+	}
+	for( ; i<InLength; i++)
+		MixOne(pInData[i], pOutData[i]);
+}
 
+//////////////////////////////////////////////////////////////////////
+// Default mix and decimate function for first stage.
+// Shifts MIX_CHUNK samples at a time into a small buffer that stays in
+//the cache and decimates from there.  The last chunk is allowed to be
+//up to 2*MIX_CHUNK long so it is never shorter than the filter.
+// pOutData can be the same as pInData.
+//////////////////////////////////////////////////////////////////////
+template <typename T>
+int CDownConvertT<T>::CDec2::MixDecBy2(CNco& Nco, int InLength, Cpx* pInData, Cpx* pOutData)
+{
+Cpx MixBuf[2*MIX_CHUNK];
+int numoutsamples = 0;
+	while(InLength > 0)
+	{
+		int n = (InLength < 2*MIX_CHUNK) ? InLength : MIX_CHUNK;
+		Nco.Mix(n, pInData, MixBuf);
+		numoutsamples += DecBy2(n, MixBuf, &pOutData[numoutsamples]);
+		pInData += n;
+		InLength -= n;
 	}
-	//need to copy last m_FirLength - 1 input samples in buffer to beginning of buffer
-	// for FIR wrap around management
-	for(i=0,j = InLength-m_FirLength+1; i<m_FirLength - 1; i++)
-		m_pHBFirBuf[i] = pInData[j++];
-//StopPerformance(InLength);
 	return numoutsamples;
 }
 
 // *&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*
 
 //////////////////////////////////////////////////////////////////////
-//Decimate by 2 Fixed 11 Tap Halfband filter class implementation
-// Loop unrolled for speed ~9nS /samp
+// Vector types used by the half band kernels.
+// Each one holds WIDTH consecutive complex samples of type T so WIDTH
+//output samples are calculated per pass.
 //////////////////////////////////////////////////////////////////////
-CDownConvert::CHalfBand11TapDecimateBy2::CHalfBand11TapDecimateBy2()
+template <typename T>
+struct CpxScalar
+{
+	enum {WIDTH = 1};
+	typedef typename tPrecision<T>::Cpx Cpx;
+	typedef Cpx V;
+	static inline V Load(const Cpx* p){return *p;}
+	static inline void Store(Cpx* p, V a){*p = a;}
+	static inline V Add(V a, V b){V r = {a.re+b.re, a.im+b.im}; return r;}
+	static inline V Scale(V a, T h){V r = {a.re*h, a.im*h}; return r;}
+};
+#if USE_SSE
+template <typename T> struct CpxVec;
+template <>
+struct CpxVec<tSReal>
+{
+	enum {WIDTH = 2};
+	typedef tSComplex Cpx;
+	typedef __m128 V;
+	static inline V Load(const Cpx* p){return _mm_loadu_ps(&p->re);}
+	static inline void Store(Cpx* p, V a){_mm_storeu_ps(&p->re, a);}
+	static inline V Add(V a, V b){return _mm_add_ps(a, b);}
+	static inline V Scale(V a, tSReal h){return _mm_mul_ps(a, _mm_set1_ps(h));}
+};
+template <>
+struct CpxVec<tDReal>
 {
-	//preload only the taps that are used since evey other one is zero
-	//except center tap 5
-	H0 = HB11TAP_H[0]; H2 = HB11TAP_H[2]; H4 = HB11TAP_H[4];
-	H5 = HB11TAP_H[5];
-	H6 = HB11TAP_H[6]; H8 = HB11TAP_H[8]; H10 = HB11TAP_H[10];
-	TYPECPX CPXZERO = {0.0,0.0};
-	d0 = CPXZERO; d1 = CPXZERO;	d2 = CPXZERO; d3 = CPXZERO;
-	d4 = CPXZERO; d5 = CPXZERO;	d6 = CPXZERO; d7 = CPXZERO;
-	d8 = CPXZERO; d9 = CPXZERO;
+	enum {WIDTH = 1};
+	typedef tDComplex Cpx;
+	typedef __m128d V;
+	static inline V Load(const Cpx* p){return _mm_loadu_pd(&p->re);}
+	static inline void Store(Cpx* p, V a){_mm_storeu_pd(&p->re, a);}
+	static inline V Add(V a, V b){return _mm_add_pd(a, b);}
+	static inline V Scale(V a, tDReal h){return _mm_mul_pd(a, _mm_set1_pd(h));}
+};
+#else
+template <typename T>
+struct CpxVec : public CpxScalar<T> {};
+#endif
+
+//////////////////////////////////////////////////////////////////////
+// Unrolled sum of the folded even taps of a half band filter.
+// pE points to the first of NUM even branch samples used by one output.
+// Tap pair K uses coefficient H[2K] on samples pE[K] and pE[NUM-1-K].
+// The recursion runs at compile time so the coefficients become constants.
+//////////////////////////////////////////////////////////////////////
+template <class VEC, int NUM, const TYPEREAL* H, int K>
+struct CHbFold
+{
+	static inline typename VEC::V Sum(const typename VEC::Cpx* pE)
+	{
+		return VEC::Add( CHbFold<VEC, NUM, H, K-1>::Sum(pE),
+					VEC::Scale(VEC::Add(VEC::Load(pE+K), VEC::Load(pE+NUM-1-K)), H[2*K]) );
+	}
+};
+template <class VEC, int NUM, const TYPEREAL* H>
+struct CHbFold<VEC, NUM, H, 0>
+{
+	static inline typename VEC::V Sum(const typename VEC::Cpx* pE)
+	{
+		return VEC::Scale(VEC::Add(VEC::Load(pE), VEC::Load(pE+NUM-1)), H[0]);
+	}
+};
+
+//////////////////////////////////////////////////////////////////////
+// Calculates one output (or VEC::WIDTH outputs) of a half band filter
+//from the even and odd branches.
+//////////////////////////////////////////////////////////////////////
+template <class VEC, int NUM, const TYPEREAL* H>
+static inline void HalfBandOut(const typename VEC::Cpx* pE, const typename VEC::Cpx* pO, typename VEC::Cpx* pOut)
+{
+	typename VEC::V acc = CHbFold<VEC, NUM, H, NUM/2-1>::Sum(pE);
+	//center tap is the only non-zero odd tap
+	acc = VEC::Add(acc, VEC::Scale(VEC::Load(pO + NUM/2-1), H[NUM-1]));
+	VEC::Store(pOut, acc);
 }
 
 //////////////////////////////////////////////////////////////////////
-//Decimate by 2 Fixed 11 Tap Halfband filter class implementation
-// Two restrictions on this routine:
-// InLength must be larger or equal to the Number of Halfband Taps(11)
-// InLength must be an even number
-// Loop unrolled for speed ~15nS/samp
+//Decimate by 2 Halfband filter template class implementation
+//////////////////////////////////////////////////////////////////////
+template <typename T>
+template <int LENGTH, const TYPEREAL* H>
+CDownConvertT<T>::CHalfBandDecimateBy2<LENGTH, H>::CHalfBandDecimateBy2()
+{
+	Cpx CPXZERO = {0.0,0.0};
+	for(int i=0; i<HIST; i++)
+	{
+		m_Even[i] = CPXZERO;
+		m_Odd[i] = CPXZERO;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+// Half band filter and decimate by 2 function.
+// InLength must be an even number.
+// Output sample i is the sum of H[2k]*Even[i+k] for the NUM_EVEN even
+//taps plus the center tap H[LENGTH/2]*Odd[i+NUM_EVEN/2-1], where the
+//branches are preceded by HIST samples from the previous call.
 //////////////////////////////////////////////////////////////////////
-int CDownConvert::CHalfBand11TapDecimateBy2::DecBy2(int InLength, TYPECPX* pInData, TYPECPX* pOutData)
+template <typename T>
+template <int LENGTH, const TYPEREAL* H>
+int CDownConvertT<T>::CHalfBandDecimateBy2<LENGTH, H>::DecBy2(int InLength, Cpx* pInData, Cpx* pOutData)
 {
+int numoutsamples = 0;
 //StartPerformance();
-	//first calculate beginning 10 samples using previous samples in delay buffer
-	TYPECPX tmpout[9];	//use temp buffer so outbuf can be same as inbuf
-	tmpout[0].re = H0*d0.re + H2*d2.re + H4*d4.re + H5*d5.re + H6*d6.re + H8*d8.re
-					 + H10*pInData[0].re;
-	tmpout[0].im = H0*d0.im + H2*d2.im + H4*d4.im + H5*d5.im + H6*d6.im + H8*d8.im
-					 + H10*pInData[0].im;
-
-	tmpout[1].re = H0*d2.re + H2*d4.re + H4*d6.re + H5*d7.re + H6*d8.re
-					 + H8*pInData[0].re + H10*pInData[2].re;
-	tmpout[1].im = H0*d2.im + H2*d4.im + H4*d6.im + H5*d7.im + H6*d8.im
-					 + H8*pInData[0].im + H10*pInData[2].im;
-
-	tmpout[2].re = H0*d4.re + H2*d6.re + H4*d8.re + H5*d9.re
-					 + H6*pInData[0].re + H8*pInData[2].re + H10*pInData[4].re;
-	tmpout[2].im = H0*d4.im + H2*d6.im + H4*d8.im + H5*d9.im
-					 + H6*pInData[0].im + H8*pInData[2].im + H10*pInData[4].im;
-
-	tmpout[3].re = H0*d6.re + H2*d8.re + H4*pInData[0].re + H5*pInData[1].re
-					 + H6*pInData[2].re + H8*pInData[4].re + H10*pInData[6].re;
-	tmpout[3].im = H0*d6.im + H2*d8.im + H4*pInData[0].im + H5*pInData[1].im
-					 + H6*pInData[2].im + H8*pInData[4].im + H10*pInData[6].im;
-
-	tmpout[4].re = H0*d8.re + H2*pInData[0].re + H4*pInData[2].re + H5*pInData[3].re
-					 + H6*pInData[4].re + H8*pInData[6].re + H10*pInData[8].re;
-	tmpout[4].im = H0*d8.im + H2*pInData[0].im + H4*pInData[2].im + H5*pInData[3].im
-					 + H6*pInData[4].im + H8*pInData[6].im + H10*pInData[8].im;
-
-	tmpout[5].re = H0*pInData[0].re + H2*pInData[2].re + H4*pInData[4].re + H5*pInData[5].re
-					 + H6*pInData[6].re + H8*pInData[8].re + H10*pInData[10].re;
-	tmpout[5].im = H0*pInData[0].im + H2*pInData[2].im + H4*pInData[4].im + H5*pInData[5].im
-					 + H6*pInData[6].im + H8*pInData[8].im + H10*pInData[10].im;
-
-	tmpout[6].re = H0*pInData[2].re + H2*pInData[4].re + H4*pInData[6].re + H5*pInData[7].re
-					 + H6*pInData[8].re + H8*pInData[10].re + H10*pInData[12].re;
-	tmpout[6].im = H0*pInData[2].im + H2*pInData[4].im + H4*pInData[6].im + H5*pInData[7].im
-					 + H6*pInData[8].im + H8*pInData[10].im + H10*pInData[12].im;
-
-	tmpout[7].re = H0*pInData[4].re + H2*pInData[6].re + H4*pInData[8].re + H5*pInData[9].re
-					 + H6*pInData[10].re + H8*pInData[12].re + H10*pInData[14].re;
-	tmpout[7].im = H0*pInData[4].im + H2*pInData[6].im + H4*pInData[8].im + H5*pInData[9].im
-					 + H6*pInData[10].im + H8*pInData[12].im + H10*pInData[14].im;
-
-	tmpout[8].re = H0*pInData[6].re + H2*pInData[8].re + H4*pInData[10].re + H5*pInData[11].re
-					 + H6*pInData[12].re + H8*pInData[14].re + H10*pInData[16].re;
-	tmpout[8].im = H0*pInData[6].im + H2*pInData[8].im + H4*pInData[10].im + H5*pInData[11].im
-					 + H6*pInData[12].im + H8*pInData[14].im + H10*pInData[16].im;
-
-	//now loop through remaining input samples
-	TYPECPX* pIn = &pInData[8];
-	TYPECPX* pOut = &pOutData[9];
-	for(int i=0; i<(InLength-11-6 )/2; i++)
+	while(InLength > 1)		//an odd last sample is dropped
 	{
-		(*pOut).re   = H0*pIn[0].re + H2*pIn[2].re + H4*pIn[4].re + H5*pIn[5].re
-					  + H6*pIn[6].re + H8*pIn[8].re + H10*pIn[10].re;
-		(*pOut++).im = H0*pIn[0].im + H2*pIn[2].im + H4*pIn[4].im + H5*pIn[5].im
-					  + H6*pIn[6].im + H8*pIn[8].im + H10*pIn[10].im;
-		pIn += 2;
+		int n = InLength/2;
+		if(n > HB_BRANCH_BUFSIZE)
+			n = HB_BRANCH_BUFSIZE;
+		//split input into even and odd branches after the history samples
+		//(all input is read before any output is written so in place works)
+		for(int i=0; i<n; i++)
+		{
+			m_Even[HIST+i] = pInData[2*i];
+			m_Odd[HIST+i] = pInData[2*i+1];
+		}
+		int i = 0;
+		for( ; i<=n-CpxVec<T>::WIDTH; i+=CpxVec<T>::WIDTH)
+			HalfBandOut<CpxVec<T>, NUM_EVEN, H>(&m_Even[i], &m_Odd[i], &pOutData[numoutsamples+i]);
+		for( ; i<n; i++)	//pick up any leftovers
+			HalfBandOut<CpxScalar<T>, NUM_EVEN, H>(&m_Even[i], &m_Odd[i], &pOutData[numoutsamples+i]);
+		//keep last HIST samples of each branch for next call
+		for(i=0; i<HIST; i++)
+		{
+			m_Even[i] = m_Even[n+i];
+			m_Odd[i] = m_Odd[n+i];
+		}
+		numoutsamples += n;
+		pInData += 2*n;
+		InLength -= 2*n;
 	}
-	//copy first outputs back into output array so outbuf can be same as inbuf
-	pOutData[0] = tmpout[0]; pOutData[1] = tmpout[1];
-	pOutData[2] = tmpout[2]; pOutData[3] = tmpout[3];
-	pOutData[4] = tmpout[4]; pOutData[5] = tmpout[5];
-	pOutData[6] = tmpout[6]; pOutData[7] = tmpout[7];
-	pOutData[8] = tmpout[8];
-
-	//copy last 10 input samples into delay buffer for next time
-	pIn = &pInData[InLength-1];
-	d9 = *pIn--; d8 = *pIn--; d7 = *pIn--;
-	d6 = *pIn--; d5 = *pIn--; d4 = *pIn--;
-	d3 = *pIn--; d2 = *pIn--; d1 = *pIn--; d0 = *pIn;
 //StopPerformance(InLength);
-	return InLength/2;
+	return numoutsamples;
 }
 
 // *&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*
@@ -458,7 +928,8 @@ int CDownConvert::CHalfBand11TapDecimateBy2::DecBy2(int InLength, TYPECPX* pInDa
 //Decimate by 2 CIC 3 stage
 // -80dB alias rejection up to Fs * (.5 - .4985)
 //////////////////////////////////////////////////////////////////////
-CDownConvert::CCicN3DecimateBy2::CCicN3DecimateBy2()
+template <typename T>
+CDownConvertT<T>::CCicN3DecimateBy2::CCicN3DecimateBy2()
 {
 	m_Xodd.re = 0.0; m_Xodd.im = 0.0;
 	m_Xeven.re = 0.0; m_Xeven.im = 0.0;
@@ -471,10 +942,11 @@ CDownConvert::CCicN3DecimateBy2::CCicN3DecimateBy2()
 //returns number of output samples processed
 // 6nS/sample
 //////////////////////////////////////////////////////////////////////
-int CDownConvert::CCicN3DecimateBy2::DecBy2(int InLength, TYPECPX* pInData, TYPECPX* pOutData)
+template <typename T>
+int CDownConvertT<T>::CCicN3DecimateBy2::DecBy2(int InLength, Cpx* pInData, Cpx* pOutData)
 {
 int i,j;
-TYPECPX even,odd;
+Cpx even,odd;
 //StartPerformance();
 	for(i=0,j=0; i<InLength; i+=2,j++)
 	{	//mag gn=8
@@ -488,3 +960,51 @@ TYPECPX even,odd;
 //StopPerformance(InLength);
 	return j;
 }
+
+//////////////////////////////////////////////////////////////////////
+//Fused NCO and CIC N=3 decimate by 2.
+// Each group of NCO_LANES shifted samples stays in registers and is
+//decimated directly so the full rate mixed data is never stored.
+// InLength must be an even number
+//returns number of output samples processed
+//////////////////////////////////////////////////////////////////////
+template <typename T>
+int CDownConvertT<T>::CCicN3DecimateBy2::MixDecBy2(CNco& Nco, int InLength, Cpx* pInData, Cpx* pOutData)
+{
+int i,j;
+T re[NCO_LANES];
+T im[NCO_LANES];
+//StartPerformance();
+	for(i=0,j=0; i<=(InLength-NCO_LANES); i+=NCO_LANES)
+	{
+		Nco.MixLanes(&pInData[i], re, im);
+		for(int k=0; k<NCO_LANES; k+=2)
+		{	//mag gn=8
+			pOutData[j].re = .125*( re[k+1] + m_Xeven.re + 3.0*(m_Xodd.re + re[k]) );
+			pOutData[j].im = .125*( im[k+1] + m_Xeven.im + 3.0*(m_Xodd.im + im[k]) );
+			j++;
+			m_Xeven.re = re[k];
+			m_Xeven.im = im[k];
+			m_Xodd.re = re[k+1];
+			m_Xodd.im = im[k+1];
+		}
+	}
+	for( ; i<(InLength-1); i+=2)
+	{	//left over pair at end of block
+		Cpx even,odd;
+		Nco.MixOne(pInData[i], even);
+		Nco.MixOne(pInData[i+1], odd);
+		pOutData[j].re = .125*( odd.re + m_Xeven.re + 3.0*(m_Xodd.re + even.re) );
+		pOutData[j].im = .125*( odd.im + m_Xeven.im + 3.0*(m_Xodd.im + even.im) );
+		j++;
+		m_Xodd = odd;
+		m_Xeven = even;
+	}
+//StopPerformance(InLength);
+	return j;
+}
+
+
+//float and double versions of the down converter
+template class CDownConvertT<tSReal>;
+template class CDownConvertT<tDReal>;
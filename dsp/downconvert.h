@@ -7,6 +7,13 @@
 // History:
 //	2010-09-15  Initial creation MSW
 //	2011-03-27  Initial release
+//	2026-10-18  Added vectorized phasor NCO fused with first decimation stage
+//	2026-10-18  Added decimation chain planner with cost model
+//	2026-10-18  Replaced half band classes with template generated kernels
+//	2026-10-18  Tuning frequency is passed to ProcessData() in a lock free snapshot
+//	2026-10-18  Added GetDataRate() and GetWfmDataRate() to plan the output rate
+//	2026-10-18  CDownConvert is CDownConvertT<TYPEREAL>, float and double versions are built
+//	2026-10-18  Decimation stages are built in a CChain and put in use with SetChain()
 //////////////////////////////////////////////////////////////////////
 //==========================================================================================
 // + + +   This Software is released under the "Simplified BSD License"  + + +
@@ -40,112 +47,195 @@
 #define DOWNCONVERT_H
 
 #include "dsp/datatypes.h"
-#include <QMutex>
+#include "dsp/polyphasefir.h"
+#include "dsp/paramsnapshot.h"
 
 
 #define MAX_DECSTAGES 10	//one more than max to make sure is a null at end of list
 
+#define NCO_LANES 4			//number of samples the phasor NCO calculates at once
+#define MIX_CHUNK 256		//samples mixed per pass into L1 sized scratch buffer
+
+#define HB_BRANCH_BUFSIZE 16384	//max samples per polyphase branch of a half band decimator
+
+#define DEF_DECIMATION_ASTOP 100.0	//default alias rejection(dB) of polyphase decimation stages
+
 //////////////////////////////////////////////////////////////////////////////////
-// Main Downconverter Class
+// Main Downconverter Class. T is the sample type, tSReal or tDReal.
+// CDownConvert uses the build precision TYPEREAL.
 //////////////////////////////////////////////////////////////////////////////////
-class CDownConvert  
+template <typename T>
+class CDownConvertT
 {
 public:
-	CDownConvert();
-	virtual ~CDownConvert();
-	void SetFrequency(TYPEREAL NcoFreq);
-	void SetCwOffset(TYPEREAL offset){m_CW_Offset= offset;}
-	int ProcessData(int InLength, TYPECPX* pInData, TYPECPX* pOutData);
-	TYPEREAL SetDataRate(TYPEREAL InRate, TYPEREAL MaxBW);
-	TYPEREAL SetWfmDataRate(TYPEREAL InRate, TYPEREAL MaxBW);
+	typedef typename tPrecision<T>::Cpx Cpx;
+	CDownConvertT();
+	virtual ~CDownConvertT();
+	//SetFrequency() is lock free and can be called by a control thread
+	// while ProcessData() runs. It takes effect at the next block.
+	// The other setters must not run at the same time as ProcessData().
+	void SetFrequency(T NcoFreq);
+	void SetCwOffset(T offset);
+	int ProcessData(int InLength, Cpx* pInData, Cpx* pOutData);
+	T SetDataRate(T InRate, T MaxBW, T Astop = DEF_DECIMATION_ASTOP);
+	T SetWfmDataRate(T InRate, T MaxBW);
+	T GetOutputRate(){return m_OutputRate;}
+	//output rates the two functions above would give. They only plan the
+	// chain so a control thread can use them while ProcessData() runs.
+	static T GetDataRate(T InRate, T MaxBW, T Astop = DEF_DECIMATION_ASTOP);
+	static T GetWfmDataRate(T InRate, T MaxBW);
+	T GetMacsPerSample(){return m_MacsPerSample;}	//estimated decimation cost per input sample
 
 private:
+	////////////
+	//private class for the phasor table NCO
+	//NCO_LANES consecutive samples are calculated at once by rotating
+	//a vector of phasors each one sample apart by NCO_LANES samples.
+	////////////
+	class CNco
+	{
+	public:
+		CNco();
+		void SetPhaseInc(T PhaseInc);
+		void Mix(int InLength, Cpx* pInData, Cpx* pOutData);
+		inline void MixLanes(const Cpx* pInData, T* pRe, T* pIm);
+		inline void MixOne(const Cpx& In, Cpx& Out);
+	private:
+		T m_Re[NCO_LANES];	//phasor for each lane
+		T m_Im[NCO_LANES];
+		T m_StepRe;			//rotation of NCO_LANES samples
+		T m_StepIm;
+		T m_IncRe;			//rotation of one sample
+		T m_IncIm;
+		int m_RenormCount;
+	};
+
 	////////////
 	//pure abstract base class for all the different types of decimate by 2 stages
 	//DecBy2 function is defined in derived classes
+	//MixDecBy2 is used for the first stage and shifts the input with the NCO
+	//in small chunks so full rate mixed data does not go back out to memory.
 	////////////
 	class CDec2
 	{
 	public:
 		CDec2(){}
 		virtual ~CDec2(){}
-		virtual int DecBy2(int InLength, TYPECPX* pInData, TYPECPX* pOutData) = 0;
+		virtual int DecBy2(int InLength, Cpx* pInData, Cpx* pOutData) = 0;
+		virtual int MixDecBy2(CNco& Nco, int InLength, Cpx* pInData, Cpx* pOutData);
 	};
 
 	////////////
-	//private class for the Half Band decimate by 2 stages
+	//private template class for the Half Band decimate by 2 stages
+	//One kernel is generated for each coefficient table in filtercoef.h.
+	//The input is split into its even and odd sample branches so only the
+	//non-zero taps are used and symmetric taps are folded.
 	////////////
+	template <int LENGTH, const TYPEREAL* H>
 	class CHalfBandDecimateBy2 : public CDec2
 	{
 	public:
-		CHalfBandDecimateBy2(int len,const TYPEREAL* pCoef);
-		~CHalfBandDecimateBy2(){if(m_pHBFirBuf) delete m_pHBFirBuf;}
-		int DecBy2(int InLength, TYPECPX* pInData, TYPECPX* pOutData);
-		TYPECPX* m_pHBFirBuf;
-		int m_FirLength;
-		const TYPEREAL* m_pCoef;
+		CHalfBandDecimateBy2();
+		~CHalfBandDecimateBy2(){}
+		int DecBy2(int InLength, Cpx* pInData, Cpx* pOutData);
+	private:
+		enum
+		{
+			NUM_EVEN = (LENGTH+1)/2,	//number of non-zero even taps
+			HIST = NUM_EVEN-1			//history samples kept in each branch
+		};
+		Cpx m_Even[HIST+HB_BRANCH_BUFSIZE];
+		Cpx m_Odd[HIST+HB_BRANCH_BUFSIZE];
 	};
 
+	////////////
+	//private class for the N=3 CIC decimate by 2 stages
+	////////////
+	class CCicN3DecimateBy2 : public CDec2
+	{
+	public:
+		CCicN3DecimateBy2();
+		~CCicN3DecimateBy2(){}
+		int DecBy2(int InLength, Cpx* pInData, Cpx* pOutData);
+		int MixDecBy2(CNco& Nco, int InLength, Cpx* pInData, Cpx* pOutData);
+		Cpx m_Xodd;
+		Cpx m_Xeven;
+	};
 
 	////////////
-	//private class for the fixed 11 tap Half Band decimate by 2 stages
+	//private class for a polyphase decimate by M stage
+	//(DecBy2 decimates by the factor given to the constructor)
 	////////////
-	class CHalfBand11TapDecimateBy2 : public CDec2
+	class CPolyphaseDecimate : public CDec2
 	{
 	public:
-		CHalfBand11TapDecimateBy2();
-		~CHalfBand11TapDecimateBy2(){}
-		int DecBy2(int InLength, TYPECPX* pInData, TYPECPX* pOutData);
-		TYPEREAL H0;	//unwrapped coeeficients
-		TYPEREAL H2;
-		TYPEREAL H4;
-		TYPEREAL H5;
-		TYPEREAL H6;
-		TYPEREAL H8;
-		TYPEREAL H10;
-		TYPECPX d0;		//unwrapped delay buffer
-		TYPECPX d1;
-		TYPECPX d2;
-		TYPECPX d3;
-		TYPECPX d4;
-		TYPECPX d5;
-		TYPECPX d6;
-		TYPECPX d7;
-		TYPECPX d8;
-		TYPECPX d9;
+		CPolyphaseDecimate(int M, T MaxBW, T Astop, T InRate)
+				{m_Decimator.Init(M, MaxBW, Astop, InRate);}
+		~CPolyphaseDecimate(){}
+		int DecBy2(int InLength, Cpx* pInData, Cpx* pOutData)
+				{return m_Decimator.ProcessData(InLength, pInData, pOutData);}
+		CMultiStageDecimateT<T> m_Decimator;
 	};
 
+public:
 	////////////
-	//private class for the N=3 CIC decimate by 2 stages
+	//decimation stages for one set of rates.  A control thread builds them
+	//so SetChain() only has to swap pointers while ProcessData() is stopped.
 	////////////
-	class CCicN3DecimateBy2 : public CDec2
+	class CChain
 	{
 	public:
-		CCicN3DecimateBy2();
-		~CCicN3DecimateBy2(){}
-		int DecBy2(int InLength, TYPECPX* pInData, TYPECPX* pOutData);
-		TYPECPX m_Xodd;
-		TYPECPX m_Xeven;
+		CChain();
+		~CChain();
+		T Build(T InRate, T MaxBW, T Astop = DEF_DECIMATION_ASTOP);
+		T BuildWfm(T InRate, T MaxBW);
+		T GetOutputRate(){return m_OutputRate;}
+	private:
+		friend class CDownConvertT<T>;
+		void BuildStages(int K, int M);
+		T m_InRate;
+		T m_MaxBW;
+		T m_Astop;
+		T m_OutputRate;
+		T m_MacsPerSample;
+		CDec2* m_pStages[MAX_DECSTAGES];
 	};
+	//puts the stages of Chain in use and hands back the old ones in Chain
+	//so they get deleted with it.  Does not allocate so it can run on the
+	//DSP thread.  Returns the output rate.
+	T SetChain(CChain& Chain);
 
 private:
+	typedef tPrecision<T> Prec;
 	//private helper functions
-	void DeleteFilters();
-
-	TYPEREAL m_OutputRate;
-	TYPEREAL m_NcoFreq;
-	TYPEREAL m_CW_Offset;
-	TYPEREAL m_NcoInc;
-	TYPEREAL m_NcoTime;
-	TYPEREAL m_InRate;
-	TYPEREAL m_MaxBW;
-	TYPECPX m_Osc1;
-	TYPEREAL m_OscCos;
-	TYPEREAL m_OscSin;
-	QMutex m_Mutex;		//for keeping threads from stomping on each other
+	static void DeleteStages(CDec2** pStages);
+	static T MinOutputRate(T MaxBW);
+	static T PlanChain(T InRate, T MaxBW, T Astop,
+							  T MinOutRate, bool UsePolyphase,
+							  int* pK, int* pM, T* pCost);
+	static int PickDecBy2(T Rate, T MaxBW);
+	static CDec2* CreateDecBy2(int Type);
+	void UpdateNco();
+
+	T m_OutputRate;
+	T m_NcoFreq;
+	T m_CW_Offset;
+	T m_NcoInc;
+	T m_NcoTime;
+	T m_InRate;
+	T m_MaxBW;
+	T m_Astop;
+	T m_MacsPerSample;
+	Cpx m_Osc1;
+	T m_OscCos;
+	T m_OscSin;
+	CNco m_Nco;
+	CParamSnapshot<T> m_TuneFreq;
 	//array of pointers for performing decimate by 2 stages
 	CDec2* m_pDecimatorPtrs[MAX_DECSTAGES];
 
 };
 
+typedef CDownConvertT<TYPEREAL> CDownConvert;
+
 #endif // DOWNCONVERT_H
@@ -15,6 +15,8 @@
 //	2011-11-03  Fixed m_pFFTOverlapBuf initialization bug
 //	2012-08-06	Fixed m_pWindowTbl sizing problem
 //	2013-07-28  Added single/double precision math macros
+//	2026-10-18  Added GetMaxOutputLength() for sizing output buffers
+//	2026-10-18  CFastFIR is CFastFIRT<TYPEREAL>, float and double versions are built
 //////////////////////////////////////////////////////////////////////
 //==========================================================================================
 // + + +   This Software is released under the "Simplified BSD License"  + + +
@@ -67,7 +69,8 @@
 // Construction/Destruction
 //////////////////////////////////////////////////////////////////////
 
-CFastFIR::CFastFIR()
+template <typename T>
+CFastFIRT<T>::CFastFIRT()
 {
 int i;
 	m_pWindowTbl = NULL;
@@ -75,10 +78,10 @@ int i;
 	m_pFFTOverlapBuf = NULL;
 	m_pFilterCoef = NULL;
 	//allocate internal buffer space on Heap
-	m_pWindowTbl = new TYPEREAL[CONV_FIR_SIZE];
-	m_pFilterCoef = new TYPECPX[CONV_FFT_SIZE];
-	m_pFFTBuf = new TYPECPX[CONV_FFT_SIZE];
-	m_pFFTOverlapBuf = new TYPECPX[CONV_FIR_SIZE];
+	m_pWindowTbl = new T[CONV_FIR_SIZE];
+	m_pFilterCoef = new Cpx[CONV_FFT_SIZE];
+	m_pFFTBuf = new Cpx[CONV_FFT_SIZE];
+	m_pFFTOverlapBuf = new Cpx[CONV_FIR_SIZE];
 
 	if(!m_pWindowTbl || !m_pFilterCoef || !m_pFFTBuf || !m_pFFTOverlapBuf)
 	{
@@ -96,9 +99,9 @@ int i;
 	for( i=0; i<CONV_FIR_SIZE; i++)
 	{
 		m_pWindowTbl[i] = (0.3635819
-			- 0.4891775*MCOS( (K_2PI*i)/(CONV_FIR_SIZE-1) )
-			+ 0.1365995*MCOS( (2.0*K_2PI*i)/(CONV_FIR_SIZE-1) )
-			- 0.0106411*MCOS( (3.0*K_2PI*i)/(CONV_FIR_SIZE-1) ) );
+			- 0.4891775*Prec::Cos( (K_2PI*i)/(CONV_FIR_SIZE-1) )
+			+ 0.1365995*Prec::Cos( (2.0*K_2PI*i)/(CONV_FIR_SIZE-1) )
+			- 0.0106411*Prec::Cos( (3.0*K_2PI*i)/(CONV_FIR_SIZE-1) ) );
 		m_pFFTOverlapBuf[i].re = 0.0;
 		m_pFFTOverlapBuf[i].im = 0.0;
 	}
@@ -108,9 +111,9 @@ int i;
 	for( i=0; i<CONV_FIR_SIZE; i++)
 	{
 		m_pWindowTbl[i] = (0.35875
-			- 0.48829*MCOS( (K_2PI*i)/(CONV_FIR_SIZE-1) )
-			+ 0.14128*MCOS( (2.0*K_2PI*i)/(CONV_FIR_SIZE-1) )
-			- 0.01168*MCOS( (3.0*K_2PI*i)/(CONV_FIR_SIZE-1) ) );
+			- 0.48829*Prec::Cos( (K_2PI*i)/(CONV_FIR_SIZE-1) )
+			+ 0.14128*Prec::Cos( (2.0*K_2PI*i)/(CONV_FIR_SIZE-1) )
+			- 0.01168*Prec::Cos( (3.0*K_2PI*i)/(CONV_FIR_SIZE-1) ) );
 		m_pFFTOverlapBuf[i].re = 0.0;
 		m_pFFTOverlapBuf[i].im = 0.0;
 	}
@@ -120,9 +123,9 @@ int i;
 	for( i=0; i<CONV_FIR_SIZE; i++)
 	{
 		m_pWindowTbl[i] = (0.355768
-			- 0.487396*MCOS( (K_2PI*i)/(CONV_FIR_SIZE-1) )
-			+ 0.144232*MCOS( (2.0*K_2PI*i)/(CONV_FIR_SIZE-1) )
-			- 0.012604*MCOS( (3.0*K_2PI*i)/(CONV_FIR_SIZE-1) ) );
+			- 0.487396*Prec::Cos( (K_2PI*i)/(CONV_FIR_SIZE-1) )
+			+ 0.144232*Prec::Cos( (2.0*K_2PI*i)/(CONV_FIR_SIZE-1) )
+			- 0.012604*Prec::Cos( (3.0*K_2PI*i)/(CONV_FIR_SIZE-1) ) );
 		m_pFFTOverlapBuf[i].re = 0.0;
 		m_pFFTOverlapBuf[i].im = 0.0;
 	}
@@ -134,7 +137,8 @@ int i;
 	m_SampleRate = 1.0;
 }
 
-CFastFIR::~CFastFIR()
+template <typename T>
+CFastFIRT<T>::~CFastFIRT()
 {
 	FreeMemory();
 
@@ -143,7 +147,8 @@ CFastFIR::~CFastFIR()
 //////////////////////////////////////////////////////////////////////
 //delete all heap memory
 //////////////////////////////////////////////////////////////////////
-void CFastFIR::FreeMemory()
+template <typename T>
+void CFastFIRT<T>::FreeMemory()
 {
 	if(m_pWindowTbl)
 	{
@@ -178,8 +183,9 @@ void CFastFIR::FreeMemory()
 //		example to make 2700Hz USB filter:
 //	SetupParameters( 100, 2800, 0, 48000);
 //////////////////////////////////////////////////////////////////////
-void CFastFIR::SetupParameters( TYPEREAL FLoCut, TYPEREAL FHiCut,
-								TYPEREAL Offset, TYPEREAL SampleRate)
+template <typename T>
+void CFastFIRT<T>::SetupParameters( T FLoCut, T FHiCut,
+								T Offset, T SampleRate)
 {
 int i;
 	if( (FLoCut==m_FLoCut) && (FHiCut==m_FHiCut) &&
@@ -207,11 +213,11 @@ int i;
 //qDebug()<<"FLowCut="<<FLoCut<<"FHiCut="<<FHiCut<<"SampleRate="<<SampleRate;
 	m_Mutex.lock();
 	//calculate some normalized filter parameters
-	TYPEREAL nFL = FLoCut/SampleRate;
-	TYPEREAL nFH = FHiCut/SampleRate;
-	TYPEREAL nFc = (nFH-nFL)/2.0;		//prototype LP filter cutoff
-	TYPEREAL nFs = K_2PI*(nFH+nFL)/2.0;		//2 PI times required frequency shift (FHiCut+FLoCut)/2
-	TYPEREAL fCenter = 0.5*(TYPEREAL)(CONV_FIR_SIZE-1);	//floating point center index of FIR filter
+	T nFL = FLoCut/SampleRate;
+	T nFH = FHiCut/SampleRate;
+	T nFc = (nFH-nFL)/2.0;		//prototype LP filter cutoff
+	T nFs = K_2PI*(nFH+nFL)/2.0;		//2 PI times required frequency shift (FHiCut+FLoCut)/2
+	T fCenter = 0.5*(T)(CONV_FIR_SIZE-1);	//floating point center index of FIR filter
 
 	for(i=0; i<CONV_FFT_SIZE; i++)		//zero pad entire coefficient buffer to FFT size
 	{
@@ -222,17 +228,17 @@ int i;
 	//create LP FIR windowed sinc, sin(x)/x complex LP filter coefficients
 	for(i=0; i<CONV_FIR_SIZE; i++)
 	{
-		TYPEREAL x = (TYPEREAL)i - fCenter;
-		TYPEREAL z;
-		if( (TYPEREAL)i == fCenter )	//deal with odd size filter singularity where sin(0)/0==1
+		T x = (T)i - fCenter;
+		T z;
+		if( (T)i == fCenter )	//deal with odd size filter singularity where sin(0)/0==1
 			z = 2.0 * nFc;
 		else
-			z = (TYPEREAL)MSIN(K_2PI*x*nFc)/(K_PI*x) * m_pWindowTbl[i];
+			z = (T)Prec::Sin(K_2PI*x*nFc)/(K_PI*x) * m_pWindowTbl[i];
 
 		//shift lowpass filter coefficients in frequency by (hicut+lowcut)/2 to form bandpass filter anywhere in range
 		// (also scales by 1/FFTsize since inverse FFT routine scales by FFTsize)
-		m_pFilterCoef[i].re  =  z * MCOS(nFs * x)/(TYPEREAL)CONV_FFT_SIZE;
-		m_pFilterCoef[i].im = z * MSIN(nFs * x)/(TYPEREAL)CONV_FFT_SIZE;
+		m_pFilterCoef[i].re  =  z * Prec::Cos(nFs * x)/(T)CONV_FFT_SIZE;
+		m_pFilterCoef[i].im = z * Prec::Sin(nFs * x)/(T)CONV_FFT_SIZE;
 	}
 
 #if 0		//debug hack to write m_pFilterCoef to a file for analysis
@@ -245,7 +251,7 @@ int i;
 		char Buf[256];
 		for( i=0; i<CONV_FIR_SIZE; i++)
 		{
-			sprintf( Buf, "%19.12g %19.12g\r\n", (TYPEREAL)CONV_FFT_SIZE*m_pFilterCoef[i].re, (TYPEREAL)CONV_FFT_SIZE*m_pFilterCoef[i].im);
+			sprintf( Buf, "%19.12g %19.12g\r\n", (T)CONV_FFT_SIZE*m_pFilterCoef[i].re, (T)CONV_FFT_SIZE*m_pFilterCoef[i].im);
 			File.write(Buf);
 		}
 	}
@@ -261,6 +267,17 @@ int i;
 
 }
 
+///////////////////////////////////////////////////////////////////////////////
+//   Returns the most samples ProcessData() can place in OutBuf for
+//InLength input samples. Up to one FFT block of earlier input may be
+//waiting in the FFT buffer.
+///////////////////////////////////////////////////////////////////////////////
+template <typename T>
+int CFastFIRT<T>::GetMaxOutputLength(int InLength)
+{
+	return InLength + CONV_FFT_SIZE;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 //   Process 'InLength' complex samples in 'InBuf'.
 //  returns number of complex samples placed in OutBuf
@@ -268,7 +285,8 @@ int i;
 //input samples due to FFT block size processing.
 //600ns/samp
 ///////////////////////////////////////////////////////////////////////////////
-int CFastFIR::ProcessData(int InLength, TYPECPX* InBuf, TYPECPX* OutBuf)
+template <typename T>
+int CFastFIRT<T>::ProcessData(int InLength, Cpx* InBuf, Cpx* OutBuf)
 {
 int i = 0;
 int j;
@@ -312,14 +330,19 @@ int outpos = 0;
 //   Complex multiply N point array m with src and place in dest.  
 // src and dest can be the same buffer.
 ///////////////////////////////////////////////////////////////////////////////
-inline void CFastFIR::CpxMpy(int N, TYPECPX* m, TYPECPX* src, TYPECPX* dest)
+template <typename T>
+inline void CFastFIRT<T>::CpxMpy(int N, Cpx* m, Cpx* src, Cpx* dest)
 {
 	for(int i=0; i<N; i++)
 	{
-		TYPEREAL sr = src[i].re;
-		TYPEREAL si = src[i].im;
+		T sr = src[i].re;
+		T si = src[i].im;
 		dest[i].re = m[i].re * sr - m[i].im * si;
 		dest[i].im = m[i].re * si + m[i].im * sr;
 	}
 }
 
+
+//float and double versions of the fast convolution filter
+template class CFastFIRT<tSReal>;
+template class CFastFIRT<tDReal>;
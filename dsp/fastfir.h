@@ -8,6 +8,8 @@
 // History:
 //	2010-09-15  Initial creation MSW
 //	2011-03-27  Initial release
+//	2026-10-18  Added GetMaxOutputLength() for sizing output buffers
+//	2026-10-18  CFastFIR is CFastFIRT<TYPEREAL>, float and double versions are built
 //////////////////////////////////////////////////////////////////////
 //==========================================================================================
 // + + +   This Software is released under the "Simplified BSD License"  + + +
@@ -44,30 +46,41 @@
 #include "dsp/fft.h"
 #include <QMutex>
 
-class CFastFIR  
+////////////
+//Fast convolution filter class. T is the sample type, tSReal or tDReal.
+// CFastFIR uses the build precision TYPEREAL.
+////////////
+template <typename T>
+class CFastFIRT
 {
 public:
-	CFastFIR();
-	virtual ~CFastFIR();
+	typedef typename tPrecision<T>::Cpx Cpx;
+	CFastFIRT();
+	virtual ~CFastFIRT();
 
-	void SetupParameters( TYPEREAL FLoCut,TYPEREAL FHiCut,TYPEREAL Offset, TYPEREAL SampleRate);
-	int ProcessData(int InLength, TYPECPX* InBuf, TYPECPX* OutBuf);
+	void SetupParameters( T FLoCut,T FHiCut,T Offset, T SampleRate);
+	int ProcessData(int InLength, Cpx* InBuf, Cpx* OutBuf);
+	static int GetMaxOutputLength(int InLength);	//most samples ProcessData() can return
 
 private:
-	inline void CpxMpy(int N, TYPECPX* m, TYPECPX* src, TYPECPX* dest);
+	typedef tPrecision<T> Prec;
+	inline void CpxMpy(int N, Cpx* m, Cpx* src, Cpx* dest);
 	void FreeMemory();
 
-	TYPEREAL m_FLoCut;
-	TYPEREAL m_FHiCut;
-	TYPEREAL m_Offset;
-	TYPEREAL m_SampleRate;
+	T m_FLoCut;
+	T m_FHiCut;
+	T m_Offset;
+	T m_SampleRate;
 
 	int m_InBufInPos;
-	TYPEREAL* m_pWindowTbl;
-	TYPECPX* m_pFFTOverlapBuf;
-	TYPECPX* m_pFilterCoef;
-	TYPECPX* m_pFFTBuf;
+	T* m_pWindowTbl;
+	Cpx* m_pFFTOverlapBuf;
+	Cpx* m_pFilterCoef;
+	Cpx* m_pFFTBuf;
 	QMutex m_Mutex;		//for keeping threads from stomping on each other
-	CFft m_Fft;
+	CFftT<T> m_Fft;
 };
+
+typedef CFastFIRT<TYPEREAL> CFastFIR;
+
 #endif // FASTFIR_H
@@ -7,6 +7,7 @@
 // History:
 //	2010-09-15  Initial creation MSW
 //	2011-03-27  Initial release
+//	2026-10-18  CFft is CFftT<TYPEREAL>, float and double versions are built
 //////////////////////////////////////////////////////////////////////
 #include <math.h>
 #include "dsp/fft.h"
@@ -26,7 +27,8 @@
 //////////////////////////////////////////////////////////////////////
 // Construction/Destruction
 //////////////////////////////////////////////////////////////////////
-CFft::CFft()
+template <typename T>
+CFftT<T>::CFftT()
 {
 	m_Overload = false;
 	m_Invert = false;
@@ -48,12 +50,14 @@ CFft::CFft()
 	SetFFTAve( 1);
 }
 
-CFft::~CFft()
+template <typename T>
+CFftT<T>::~CFftT()
 {							// free all resources
 	FreeMemory();
 }
 
-void CFft::FreeMemory()
+template <typename T>
+void CFftT<T>::FreeMemory()
 {
 	if(m_pWorkArea)
 	{
@@ -100,7 +104,8 @@ void CFft::FreeMemory()
 ///////////////////////////////////////////////////////////////////
 //FFT initialization and parameter setup function
 ///////////////////////////////////////////////////////////////////
-void CFft::SetFFTAve( qint32 ave)
+template <typename T>
+void CFftT<T>::SetFFTAve( qint32 ave)
 {
 	if(m_AveSize != ave)
 	{
@@ -115,10 +120,11 @@ void CFft::SetFFTAve( qint32 ave)
 ///////////////////////////////////////////////////////////////////
 //FFT initialization and parameter setup function
 ///////////////////////////////////////////////////////////////////
-void CFft::SetFFTParams( qint32 size,
+template <typename T>
+void CFftT<T>::SetFFTParams( qint32 size,
 						 bool invert,
-						 TYPEREAL dBCompensation,
-						 TYPEREAL SampleFreq)
+						 T dBCompensation,
+						 T SampleFreq)
 {
 qint32 i;
 	if(size==0)
@@ -148,12 +154,12 @@ qint32 i;
 	{
 		m_LastFFTSize = m_FFTSize;
 		FreeMemory();
-		m_pWindowTbl = new TYPEREAL[m_FFTSize];
-		m_pSinCosTbl = new TYPEREAL[m_FFTSize/2];
-		m_pWorkArea = new qint32[ (qint32)MSQRT((TYPEREAL)m_FFTSize)+2];
-		m_pFFTPwrAveBuf = new TYPEREAL[m_FFTSize];
-		m_pFFTAveBuf = new TYPEREAL[m_FFTSize];
-		m_pFFTSumBuf = new TYPEREAL[m_FFTSize];
+		m_pWindowTbl = new T[m_FFTSize];
+		m_pSinCosTbl = new T[m_FFTSize/2];
+		m_pWorkArea = new qint32[ (qint32)Prec::Sqrt((T)m_FFTSize)+2];
+		m_pFFTPwrAveBuf = new T[m_FFTSize];
+		m_pFFTAveBuf = new T[m_FFTSize];
+		m_pFFTSumBuf = new T[m_FFTSize];
 		for(i=0; i<m_FFTSize; i++)
 		{
 			m_pFFTPwrAveBuf[i] = 0.0;
@@ -161,7 +167,7 @@ qint32 i;
 			m_pFFTSumBuf[i] = 0.0;
 		}
 		m_pWorkArea[0] = 0;
-		m_pFFTInBuf = new TYPEREAL[m_FFTSize*2];
+		m_pFFTInBuf = new T[m_FFTSize*2];
 		m_pTranslateTbl = new qint32[m_FFTSize];
 		for(i=0; i<m_FFTSize*2; i++)
 			m_pFFTInBuf[i] = 0.0;
@@ -183,10 +189,10 @@ qint32 i;
 //		range of 0 to -120dB the stored value is 0.0 to -12.0
 //   so final constant K_B = -8.663833		
 ///////////////////////////////////////////////////////////////////////
-		m_K_B = m_dBCompensation - 20*MLOG10( (TYPEREAL)m_FFTSize*K_AMPMAX/2.0 );
-		m_K_C = MPOW( 10.0, (K_MINDB-m_K_B)/10.0 );
+		m_K_B = m_dBCompensation - 20*Prec::Log10( (T)m_FFTSize*K_AMPMAX/2.0 );
+		m_K_C = Prec::Pow( 10.0, (K_MINDB-m_K_B)/10.0 );
 		m_K_B = m_K_B/10.0;
-TYPEREAL WindowGain;
+T WindowGain;
 #if 0
 		WindowGain = 1.0;
 		for(i=0; i<m_FFTSize; i++)	//Rectangle(no window)
@@ -195,45 +201,45 @@ TYPEREAL WindowGain;
 #if 0
 		WindowGain = 2.0;
 		for(i=0; i<m_FFTSize; i++)	//Hann
-			m_pWindowTbl[i] = WindowGain*(.5  - .5 *MCOS( (K_2PI*i)/(m_FFTSize-1) ));
+			m_pWindowTbl[i] = WindowGain*(.5  - .5 *Prec::Cos( (K_2PI*i)/(m_FFTSize-1) ));
 #endif
 #if 0
 		WindowGain = 1.852;
 		for(i=0; i<m_FFTSize; i++)	//Hamming
-			m_pWindowTbl[i] = WindowGain*(.54  - .46 *MCOS( (K_2PI*i)/(m_FFTSize-1) ));
+			m_pWindowTbl[i] = WindowGain*(.54  - .46 *Prec::Cos( (K_2PI*i)/(m_FFTSize-1) ));
 #endif
 #if 0
 		WindowGain = 2.8;
 		for(i=0; i<m_FFTSize; i++)	//Blackman-Nuttall
 			m_pWindowTbl[i] = WindowGain*(0.3635819
-				- 0.4891775*MCOS( (K_2PI*i)/(m_FFTSize-1) )
-				+ 0.1365995*MCOS( (2.0*K_2PI*i)/(m_FFTSize-1) )
-				- 0.0106411*MCOS( (3.0*K_2PI*i)/(m_FFTSize-1) ) );
+				- 0.4891775*Prec::Cos( (K_2PI*i)/(m_FFTSize-1) )
+				+ 0.1365995*Prec::Cos( (2.0*K_2PI*i)/(m_FFTSize-1) )
+				- 0.0106411*Prec::Cos( (3.0*K_2PI*i)/(m_FFTSize-1) ) );
 #endif
 #if 0
 		WindowGain = 2.82;
 		for(i=0; i<m_FFTSize; i++)	//Blackman-Harris
 			m_pWindowTbl[i] = WindowGain*(0.35875
-				- 0.48829*MCOS( (K_2PI*i)/(m_FFTSize-1) )
-				+ 0.14128*MCOS( (2.0*K_2PI*i)/(m_FFTSize-1) )
-				- 0.01168*MCOS( (3.0*K_2PI*i)/(m_FFTSize-1) ) );
+				- 0.48829*Prec::Cos( (K_2PI*i)/(m_FFTSize-1) )
+				+ 0.14128*Prec::Cos( (2.0*K_2PI*i)/(m_FFTSize-1) )
+				- 0.01168*Prec::Cos( (3.0*K_2PI*i)/(m_FFTSize-1) ) );
 #endif
 #if 1
 		WindowGain = 2.8;
 		for(i=0; i<m_FFTSize; i++)	//Nuttall
 			m_pWindowTbl[i] = WindowGain*(0.355768
-				- 0.487396*MCOS( (K_2PI*i)/(m_FFTSize-1) )
-				+ 0.144232*MCOS( (2.0*K_2PI*i)/(m_FFTSize-1) )
-				- 0.012604*MCOS( (3.0*K_2PI*i)/(m_FFTSize-1) ) );
+				- 0.487396*Prec::Cos( (K_2PI*i)/(m_FFTSize-1) )
+				+ 0.144232*Prec::Cos( (2.0*K_2PI*i)/(m_FFTSize-1) )
+				- 0.012604*Prec::Cos( (3.0*K_2PI*i)/(m_FFTSize-1) ) );
 #endif
 #if 0
 		WindowGain = 1.0;
 		for(i=0; i<m_FFTSize; i++)	//Flat Top 4 term
 			m_pWindowTbl[i] = WindowGain*(1.0
-					- 1.942604  * MCOS( (K_2PI*i)/(m_FFTSize-1) )
-					+ 1.340318 * MCOS( (2.0*K_2PI*i)/(m_FFTSize-1) )
-					- 0.440811 * MCOS( (3.0*K_2PI*i)/(m_FFTSize-1) )
-					+ 0.043097  * MCOS( (4.0*K_2PI*i)/(m_FFTSize-1) )
+					- 1.942604  * Prec::Cos( (K_2PI*i)/(m_FFTSize-1) )
+					+ 1.340318 * Prec::Cos( (2.0*K_2PI*i)/(m_FFTSize-1) )
+					- 0.440811 * Prec::Cos( (3.0*K_2PI*i)/(m_FFTSize-1) )
+					+ 0.043097  * Prec::Cos( (4.0*K_2PI*i)/(m_FFTSize-1) )
 				);
 
 #endif
@@ -245,7 +251,8 @@ TYPEREAL WindowGain;
 ///////////////////////////////////////////////////////////////////
 //  Resets the FFT buffers and averaging variables.
 ///////////////////////////////////////////////////////////////////
-void CFft::ResetFFT()
+template <typename T>
+void CFftT<T>::ResetFFT()
 {
 	m_Mutex.lock();
 	for(qint32 i=0; i<m_FFTSize;i++)
@@ -264,12 +271,13 @@ void CFft::ResetFFT()
 //	For real data there should be  m_FFTSize/2 InBuf data points
 //	For complex data there should be  m_FFTSize InBuf data points
 //////////////////////////////////////////////////////////////////////
-qint32 CFft::PutInDisplayFFT(qint32 n, TYPECPX* InBuf)
+template <typename T>
+qint32 CFftT<T>::PutInDisplayFFT(qint32 n, Cpx* InBuf)
 {
 qint32 i;
 	m_Overload = false;
 	m_Mutex.lock();
-	TYPEREAL dtmp1;
+	T dtmp1;
 	for(i=0; i<n; i++)
 	{
 		if( InBuf[i].re > OVER_LIMIT )	//flag overload if within OVLimit of max
@@ -277,8 +285,8 @@ qint32 i;
 		dtmp1 = m_pWindowTbl[i];
 		//NOTE: For some reason I and Q are swapped(demod I/Q does not apear to be swapped)
 		//possibly an issue with the FFT ?
-		((TYPECPX*)m_pFFTInBuf)[i].im =  dtmp1 * (InBuf[i].re);//window the I data
-		((TYPECPX*)m_pFFTInBuf)[i].re = dtmp1 * (InBuf[i].im);	//window the Q data
+		((Cpx*)m_pFFTInBuf)[i].im =  dtmp1 * (InBuf[i].re);//window the I data
+		((Cpx*)m_pFFTInBuf)[i].re = dtmp1 * (InBuf[i].im);	//window the Q data
 	}
 	//Calculate the complex FFT
 	bitrv2(m_FFTSize*2, m_pWorkArea + 2, m_pFFTInBuf);
@@ -305,10 +313,11 @@ qint32 i;
 //		MindB = FFT dB level  corresponding to output value == MaxHeight
 //			must be >= to K_MINDB
 //////////////////////////////////////////////////////////////////////
-bool CFft::GetScreenIntegerFFTData(qint32 MaxHeight,
+template <typename T>
+bool CFftT<T>::GetScreenIntegerFFTData(qint32 MaxHeight,
 								qint32 MaxWidth,
-								TYPEREAL MaxdB,
-								TYPEREAL MindB,
+								T MaxdB,
+								T MindB,
 								qint32 StartFreq,
 								qint32 StopFreq,
 								qint32* OutBuf )
@@ -320,8 +329,8 @@ qint32 m;
 qint32 ymax = -10000;
 qint32 xprev = -1;
 qint32 maxbin;
-TYPEREAL dBmaxOffset = MaxdB/10.0;
-TYPEREAL dBGainFactor = -10.0/(MaxdB-MindB);
+T dBmaxOffset = MaxdB/10.0;
+T dBGainFactor = -10.0/(MaxdB-MindB);
 
 //qDebug()<<"maxoffset dbgaindfact "<<dBmaxOffset << dBGainFactor;
 
@@ -334,9 +343,9 @@ TYPEREAL dBGainFactor = -10.0/(MaxdB-MindB);
 		m_StopFreq = StopFreq;
 		m_PlotWidth = MaxWidth;
 		maxbin = m_FFTSize - 1;
-		m_BinMin = (qint32)((TYPEREAL)StartFreq*(TYPEREAL)m_FFTSize/m_SampleFreq);
+		m_BinMin = (qint32)((T)StartFreq*(T)m_FFTSize/m_SampleFreq);
 		m_BinMin += (m_FFTSize/2);
-		m_BinMax = (qint32)((TYPEREAL)StopFreq*(TYPEREAL)m_FFTSize/m_SampleFreq);
+		m_BinMax = (qint32)((T)StopFreq*(T)m_FFTSize/m_SampleFreq);
 		m_BinMax += (m_FFTSize/2);
 		if(m_BinMin < 0)	//don't allow these go outside the translate table
 			m_BinMin = 0;
@@ -367,9 +376,9 @@ TYPEREAL dBGainFactor = -10.0/(MaxdB-MindB);
 		for( i=m_BinMin; i<=m_BinMax; i++ )
 		{
 			if(m_Invert)
-				y = (qint32)((TYPEREAL)MaxHeight*dBGainFactor*(m_pFFTAveBuf[(m-i)] - dBmaxOffset));
+				y = (qint32)((T)MaxHeight*dBGainFactor*(m_pFFTAveBuf[(m-i)] - dBmaxOffset));
 			else
-				y = (qint32)((TYPEREAL)MaxHeight*dBGainFactor*(m_pFFTAveBuf[i] - dBmaxOffset));
+				y = (qint32)((T)MaxHeight*dBGainFactor*(m_pFFTAveBuf[i] - dBmaxOffset));
 			if(y<0)
 				y = 0;
 			if(y > MaxHeight)
@@ -398,9 +407,9 @@ TYPEREAL dBGainFactor = -10.0/(MaxdB-MindB);
 		{
 			i = m_pTranslateTbl[x];	//get plot to fft bin coordinate transform
 			if(m_Invert)
-				y = (qint32)((TYPEREAL)MaxHeight*dBGainFactor*(m_pFFTAveBuf[(m-i)] - dBmaxOffset));
+				y = (qint32)((T)MaxHeight*dBGainFactor*(m_pFFTAveBuf[(m-i)] - dBmaxOffset));
 			else
-				y = (qint32)((TYPEREAL)MaxHeight*dBGainFactor*(m_pFFTAveBuf[i] - dBmaxOffset));
+				y = (qint32)((T)MaxHeight*dBGainFactor*(m_pFFTAveBuf[i] - dBmaxOffset));
 			if(y<0)
 				y = 0;
 			if(y > MaxHeight)
@@ -416,16 +425,18 @@ TYPEREAL dBGainFactor = -10.0/(MaxdB-MindB);
 //Interface for doing fast convolution filters.  Takes complex data
 // in pInOutBuf and does fwd or rev FFT and places back in same buffer.
 ///////////////////////////////////////////////////////////////////
-void CFft::FwdFFT( TYPECPX* pInOutBuf)
+template <typename T>
+void CFftT<T>::FwdFFT( Cpx* pInOutBuf)
 {
-	bitrv2(m_FFTSize*2, m_pWorkArea + 2, (TYPEREAL*)pInOutBuf);
-	CpxFFT(m_FFTSize*2, (TYPEREAL*)pInOutBuf, m_pSinCosTbl);
+	bitrv2(m_FFTSize*2, m_pWorkArea + 2, (T*)pInOutBuf);
+	CpxFFT(m_FFTSize*2, (T*)pInOutBuf, m_pSinCosTbl);
 }
 
-void CFft::RevFFT( TYPECPX* pInOutBuf)
+template <typename T>
+void CFftT<T>::RevFFT( Cpx* pInOutBuf)
 {
-	bitrv2conj(m_FFTSize*2, m_pWorkArea + 2, (TYPEREAL*)pInOutBuf);
-	cftbsub(m_FFTSize*2, (TYPEREAL*)pInOutBuf, m_pSinCosTbl);
+	bitrv2conj(m_FFTSize*2, m_pWorkArea + 2, (T*)pInOutBuf);
+	cftbsub(m_FFTSize*2, (T*)pInOutBuf, m_pSinCosTbl);
 }
 
 
@@ -433,10 +444,11 @@ void CFft::RevFFT( TYPECPX* pInOutBuf)
 // Nitty gritty fft routines by Takuya OOURA(Updated to his new version 4-18-02)
 // Routine calculates real FFT
 ///////////////////////////////////////////////////////////////////
-void CFft::rftfsub(qint32 n, TYPEREAL *a, qint32 nc, TYPEREAL *c)
+template <typename T>
+void CFftT<T>::rftfsub(qint32 n, T *a, qint32 nc, T *c)
 {
 qint32 j, k, kk, ks, m;
-TYPEREAL wkr, wki, xr, xi, yr, yi;
+T wkr, wki, xr, xi, yr, yi;
 
 	m_TotalCount++;
  	if(m_AveCount < m_AveSize)
@@ -475,11 +487,11 @@ TYPEREAL wkr, wki, xr, xi, yr, yi;
 			m_pFFTSumBuf[j] = m_pFFTSumBuf[j] - m_pFFTPwrAveBuf[j] + xi;
 			m_pFFTSumBuf[k] = m_pFFTSumBuf[k] - m_pFFTPwrAveBuf[k] + xr;
 		}
-		m_pFFTPwrAveBuf[j] = m_pFFTSumBuf[j]/(TYPEREAL)m_AveCount;
-		m_pFFTPwrAveBuf[k] = m_pFFTSumBuf[k]/(TYPEREAL)m_AveCount;
+		m_pFFTPwrAveBuf[j] = m_pFFTSumBuf[j]/(T)m_AveCount;
+		m_pFFTPwrAveBuf[k] = m_pFFTSumBuf[k]/(T)m_AveCount;
 
-		m_pFFTAveBuf[j] = MLOG10(m_pFFTPwrAveBuf[j] + m_K_C) + m_K_B;
-		m_pFFTAveBuf[k] = MLOG10(m_pFFTPwrAveBuf[k] + m_K_C) + m_K_B;
+		m_pFFTAveBuf[j] = Prec::Log10(m_pFFTPwrAveBuf[j] + m_K_C) + m_K_B;
+		m_pFFTAveBuf[k] = Prec::Log10(m_pFFTPwrAveBuf[k] + m_K_C) + m_K_B;
 
 	}
 
@@ -498,11 +510,11 @@ TYPEREAL wkr, wki, xr, xi, yr, yi;
 		m_pFFTSumBuf[0] = m_pFFTSumBuf[0] - m_pFFTPwrAveBuf[0] + a[0];
 		m_pFFTSumBuf[n/2] = m_pFFTSumBuf[n/2] - m_pFFTPwrAveBuf[n/2] + xr;
 	}
-	m_pFFTPwrAveBuf[0] = m_pFFTSumBuf[0]/(TYPEREAL)m_AveCount;
-	m_pFFTPwrAveBuf[n/2] = m_pFFTSumBuf[n/2]/(TYPEREAL)m_AveCount;
+	m_pFFTPwrAveBuf[0] = m_pFFTSumBuf[0]/(T)m_AveCount;
+	m_pFFTPwrAveBuf[n/2] = m_pFFTSumBuf[n/2]/(T)m_AveCount;
 
-	m_pFFTAveBuf[0] = MLOG10(m_pFFTPwrAveBuf[0] + m_K_C) + m_K_B;
-	m_pFFTAveBuf[n/2] = MLOG10(m_pFFTPwrAveBuf[n/2] + m_K_C) + m_K_B;
+	m_pFFTAveBuf[0] = Prec::Log10(m_pFFTPwrAveBuf[0] + m_K_C) + m_K_B;
+	m_pFFTAveBuf[n/2] = Prec::Log10(m_pFFTPwrAveBuf[n/2] + m_K_C) + m_K_B;
 
 }
 
@@ -510,10 +522,11 @@ TYPEREAL wkr, wki, xr, xi, yr, yi;
 ///////////////////////////////////////////////////////////////////
 // Routine calculates complex FFT
 ///////////////////////////////////////////////////////////////////
-void CFft::CpxFFT(qint32 n, TYPEREAL *a, TYPEREAL *w)
+template <typename T>
+void CFftT<T>::CpxFFT(qint32 n, T *a, T *w)
 {
 qint32 j, j1, j2, j3, l;
-TYPEREAL x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i;
+T x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i;
     
 	m_TotalCount++;
  	if(m_AveCount < m_AveSize)
@@ -574,8 +587,8 @@ TYPEREAL x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i;
 			m_pFFTSumBuf[j] = m_pFFTSumBuf[j] + x0r;
 		else
 			m_pFFTSumBuf[j] = m_pFFTSumBuf[j] - m_pFFTPwrAveBuf[j] + x0r;
-		m_pFFTPwrAveBuf[j] = m_pFFTSumBuf[j]/(TYPEREAL)m_AveCount;
-		m_pFFTAveBuf[j] = MLOG10( m_pFFTPwrAveBuf[j] + m_K_C) + m_K_B;
+		m_pFFTPwrAveBuf[j] = m_pFFTSumBuf[j]/(T)m_AveCount;
+		m_pFFTAveBuf[j] = Prec::Log10( m_pFFTPwrAveBuf[j] + m_K_C) + m_K_B;
 	}
 	// FFT output index N/2 to N-1  (times 2 since complex samples)
 	// is frequency output -Fs/2 to 0  
@@ -587,8 +600,8 @@ TYPEREAL x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i;
 			m_pFFTSumBuf[j] = m_pFFTSumBuf[j] + x0r;
 		else
 			m_pFFTSumBuf[j] = m_pFFTSumBuf[j] - m_pFFTPwrAveBuf[j] + x0r;
-		m_pFFTPwrAveBuf[j] = m_pFFTSumBuf[j]/(TYPEREAL)m_AveCount;
-		m_pFFTAveBuf[j] = MLOG10( m_pFFTPwrAveBuf[j] + m_K_C) + m_K_B;
+		m_pFFTPwrAveBuf[j] = m_pFFTSumBuf[j]/(T)m_AveCount;
+		m_pFFTAveBuf[j] = Prec::Log10( m_pFFTPwrAveBuf[j] + m_K_C) + m_K_B;
 	}
 
 }
@@ -596,24 +609,25 @@ TYPEREAL x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i;
 ///////////////////////////////////////////////////////////////////
 /* -------- initializing routines -------- */
 ///////////////////////////////////////////////////////////////////
-void CFft::makewt(qint32 nw, qint32 *ip, TYPEREAL *w)
+template <typename T>
+void CFftT<T>::makewt(qint32 nw, qint32 *ip, T *w)
 {
 qint32 j, nwh;
-TYPEREAL delta, x, y;
+T delta, x, y;
     
     ip[0] = nw;
     ip[1] = 1;
     if (nw > 2) {
         nwh = nw >> 1;
-		delta = MATAN(1.0) / nwh;
+		delta = Prec::Atan(1.0) / nwh;
         w[0] = 1;
         w[1] = 0;
-		w[nwh] = MCOS(delta * nwh);
+		w[nwh] = Prec::Cos(delta * nwh);
         w[nwh + 1] = w[nwh];
         if (nwh > 2) {
             for (j = 2; j < nwh; j += 2) {
-				x = MCOS(delta * j);
-				y = MSIN(delta * j);
+				x = Prec::Cos(delta * j);
+				y = Prec::Sin(delta * j);
                 w[j] = x;
                 w[j + 1] = y;
                 w[nw - j] = y;
@@ -625,20 +639,21 @@ TYPEREAL delta, x, y;
 }
 
 ///////////////////////////////////////////////////////////////////
-void CFft::makect(qint32 nc, qint32 *ip, TYPEREAL *c)
+template <typename T>
+void CFftT<T>::makect(qint32 nc, qint32 *ip, T *c)
 {
 qint32 j, nch;
-TYPEREAL delta;
+T delta;
     
 	ip[1] = nc;
     if (nc > 1) {
         nch = nc >> 1;
-		delta = MATAN(1.0) / nch;
-		c[0] = MCOS(delta * nch);
+		delta = Prec::Atan(1.0) / nch;
+		c[0] = Prec::Cos(delta * nch);
         c[nch] = 0.5 * c[0];
         for (j = 1; j < nch; j++) {
-			c[j] = 0.5 * MCOS(delta * j);
-			c[nc - j] = 0.5 * MSIN(delta * j);
+			c[j] = 0.5 * Prec::Cos(delta * j);
+			c[nc - j] = 0.5 * Prec::Sin(delta * j);
         }
     }
 }
@@ -646,10 +661,11 @@ TYPEREAL delta;
 ///////////////////////////////////////////////////////////////////
 /* -------- child routines -------- */
 ///////////////////////////////////////////////////////////////////
-void CFft::bitrv2(qint32 n, qint32 *ip, TYPEREAL *a)
+template <typename T>
+void CFftT<T>::bitrv2(qint32 n, qint32 *ip, T *a)
 {
 qint32 j, j1, k, k1, l, m, m2;
-TYPEREAL xr, xi, yr, yi;
+T xr, xi, yr, yi;
     
     ip[0] = 0;
     l = n;
@@ -746,10 +762,11 @@ TYPEREAL xr, xi, yr, yi;
 }
 
 ///////////////////////////////////////////////////////////////////
-void CFft::cftfsub(qint32 n, TYPEREAL *a, TYPEREAL *w)
+template <typename T>
+void CFftT<T>::cftfsub(qint32 n, T *a, T *w)
 {
 qint32 j, j1, j2, j3, l;
-TYPEREAL x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i;
+T x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i;
     
     l = 2;
     if (n > 8) {
@@ -796,11 +813,12 @@ TYPEREAL x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i;
 }
 
 ///////////////////////////////////////////////////////////////////
-void CFft::cft1st(qint32 n, TYPEREAL *a, TYPEREAL *w)
+template <typename T>
+void CFftT<T>::cft1st(qint32 n, T *a, T *w)
 {
 qint32 j, k1, k2;
-TYPEREAL wk1r, wk1i, wk2r, wk2i, wk3r, wk3i;
-TYPEREAL x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i;
+T wk1r, wk1i, wk2r, wk2i, wk3r, wk3i;
+T x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i;
     
     x0r = a[0] + a[2];
     x0i = a[1] + a[3];
@@ -901,11 +919,12 @@ TYPEREAL x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i;
 }
 
 ///////////////////////////////////////////////////////////////////
-void CFft::cftmdl(qint32 n, qint32 l, TYPEREAL *a, TYPEREAL *w)
+template <typename T>
+void CFftT<T>::cftmdl(qint32 n, qint32 l, T *a, T *w)
 {
 qint32 j, j1, j2, j3, k, k1, k2, m, m2;
-TYPEREAL wk1r, wk1i, wk2r, wk2i, wk3r, wk3i;
-TYPEREAL x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i;
+T wk1r, wk1i, wk2r, wk2i, wk3r, wk3i;
+T x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i;
     
     m = l << 2;
     for (j = 0; j < l; j += 2) {
@@ -1027,10 +1046,11 @@ TYPEREAL x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i;
     }
 }
 
-void CFft::bitrv2conj(int n, int *ip, TYPEREAL *a)
+template <typename T>
+void CFftT<T>::bitrv2conj(int n, int *ip, T *a)
 {
 	int j, j1, k, k1, l, m, m2;
-	TYPEREAL xr, xi, yr, yi;
+	T xr, xi, yr, yi;
 
 	ip[0] = 0;
 	l = n;
@@ -1135,10 +1155,11 @@ void CFft::bitrv2conj(int n, int *ip, TYPEREAL *a)
 	}
 }
 
-void CFft::cftbsub(int n, TYPEREAL *a, TYPEREAL *w)
+template <typename T>
+void CFftT<T>::cftbsub(int n, T *a, T *w)
 {
 	int j, j1, j2, j3, l;
-	TYPEREAL x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i;
+	T x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i;
 
 	l = 2;
 	if (n > 8) {
@@ -1185,3 +1206,6 @@ void CFft::cftbsub(int n, TYPEREAL *a, TYPEREAL *w)
 }
 
 
+//float and double versions of the FFT
+template class CFftT<tSReal>;
+template class CFftT<tDReal>;
@@ -11,6 +11,7 @@
 // History:
 //	2010-09-15  Initial creation MSW
 //	2011-03-27  Initial release
+//	2026-10-18  CFft is CFftT<TYPEREAL>, float and double versions are built
 //////////////////////////////////////////////////////////////////////
 #ifndef FFT_H
 #define FFT_H
@@ -21,40 +22,47 @@
 #define MAX_FFT_SIZE 65536
 #define MIN_FFT_SIZE 512
 
-class CFft
+////////////
+//FFT class. T is the sample type, tSReal or tDReal.
+// CFft uses the build precision TYPEREAL.
+////////////
+template <typename T>
+class CFftT
 {
 public:
-	CFft();
-	virtual ~CFft();
+	typedef typename tPrecision<T>::Cpx Cpx;
+	CFftT();
+	virtual ~CFftT();
 	void SetFFTParams( qint32 size,
 						bool invert,
-						TYPEREAL dBCompensation,
-						TYPEREAL SampleFreq);
+						T dBCompensation,
+						T SampleFreq);
 	//Methods to obtain spectrum formated power vs frequency
 	void SetFFTAve( qint32 ave);
 	void ResetFFT();
 	bool GetScreenIntegerFFTData(qint32 MaxHeight, qint32 MaxWidth,
-									TYPEREAL MaxdB, TYPEREAL MindB,
+									T MaxdB, T MindB,
 									qint32 StartFreq, qint32 StopFreq,
 									qint32* OutBuf );
-	qint32 PutInDisplayFFT(qint32 n, TYPECPX* InBuf);
+	qint32 PutInDisplayFFT(qint32 n, Cpx* InBuf);
 
 	//Methods for doing Fast convolutions using forward and reverse FFT
-	void FwdFFT( TYPECPX* pInOutBuf);
-	void RevFFT( TYPECPX* pInOutBuf);
+	void FwdFFT( Cpx* pInOutBuf);
+	void RevFFT( Cpx* pInOutBuf);
 
 private:
+	typedef tPrecision<T> Prec;
 	void FreeMemory();
-	void makewt(qint32 nw, qint32 *ip, TYPEREAL *w);
-	void makect(qint32 nc, qint32 *ip, TYPEREAL *c);
-	void bitrv2(qint32 n, qint32 *ip, TYPEREAL *a);
-	void cftfsub(qint32 n, TYPEREAL *a, TYPEREAL *w);
-	void rftfsub(qint32 n, TYPEREAL *a, qint32 nc, TYPEREAL *c);
-	void CpxFFT(qint32 n, TYPEREAL *a, TYPEREAL *w);
-	void cft1st(qint32 n, TYPEREAL *a, TYPEREAL *w);
-	void cftmdl(qint32 n, qint32 l, TYPEREAL *a, TYPEREAL *w);
-	void bitrv2conj(int n, int *ip, TYPEREAL *a);
-	void cftbsub(int n, TYPEREAL *a, TYPEREAL *w);
+	void makewt(qint32 nw, qint32 *ip, T *w);
+	void makect(qint32 nc, qint32 *ip, T *c);
+	void bitrv2(qint32 n, qint32 *ip, T *a);
+	void cftfsub(qint32 n, T *a, T *w);
+	void rftfsub(qint32 n, T *a, qint32 nc, T *c);
+	void CpxFFT(qint32 n, T *a, T *w);
+	void cft1st(qint32 n, T *a, T *w);
+	void cftmdl(qint32 n, qint32 l, T *a, T *w);
+	void bitrv2conj(int n, int *ip, T *a);
+	void cftbsub(int n, T *a, T *w);
 
 	bool m_Overload;
 	bool m_Invert;
@@ -69,19 +77,21 @@ private:
 	qint32 m_BinMax;
 	qint32 m_PlotWidth;
 
-	TYPEREAL m_K_C;
-	TYPEREAL m_K_B;
-	TYPEREAL m_dBCompensation;
-	TYPEREAL m_SampleFreq;
+	T m_K_C;
+	T m_K_B;
+	T m_dBCompensation;
+	T m_SampleFreq;
 	qint32* m_pWorkArea;
 	qint32* m_pTranslateTbl;
-	TYPEREAL* m_pSinCosTbl;
-	TYPEREAL* m_pWindowTbl;
-	TYPEREAL* m_pFFTPwrAveBuf;
-	TYPEREAL* m_pFFTAveBuf;
-	TYPEREAL* m_pFFTSumBuf;
-	TYPEREAL* m_pFFTInBuf;
+	T* m_pSinCosTbl;
+	T* m_pWindowTbl;
+	T* m_pFFTPwrAveBuf;
+	T* m_pFFTAveBuf;
+	T* m_pFFTSumBuf;
+	T* m_pFFTInBuf;
 	QMutex m_Mutex;		//for keeping threads from stomping on each other
 };
 
+typedef CFftT<TYPEREAL> CFft;
+
 #endif // FFT_H
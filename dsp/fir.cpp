@@ -13,6 +13,8 @@
 //	2011-03-27  Initial release
 //	2011-08-07  Modified FIR filter initialization to force fixed size
 //	2013-07-28  Added single/double precision math macros
+//	2026-10-18  CFir is CFirT<TYPEREAL>, float and double versions are built
+//	2026-10-18  CDecimateBy2 is CDecimateBy2T<TYPEREAL>
 //////////////////////////////////////////////////////////////////////
 
 //==========================================================================================
@@ -44,6 +46,7 @@
 //or implied, of Moe Wheatley.
 //==========================================================================================
 #include "fir.h"
+#include "dsp/simdops.h"
 #include <QFile>
 #include <QDir>
 #include <QDebug>
@@ -58,7 +61,8 @@
 /////////////////////////////////////////////////////////////////////////////////
 //	Construct CFir object
 /////////////////////////////////////////////////////////////////////////////////
-CFir::CFir()
+template <typename T>
+CFirT<T>::CFirT()
 {
 	m_NumTaps = 1;
 	m_State = 0;
@@ -73,23 +77,16 @@ CFir::CFir()
 //   {21, -43, 15, 21, -43, 15 }
 //REAL version
 /////////////////////////////////////////////////////////////////////////////////
-void CFir::ProcessFilter(int InLength, TYPEREAL* InBuf, TYPEREAL* OutBuf)
+template <typename T>
+void CFirT<T>::ProcessFilter(int InLength, T* InBuf, T* OutBuf)
 {
-TYPEREAL acc;
-TYPEREAL* Zptr;
-const TYPEREAL* Hptr;
 	m_Mutex.lock();
 	for(int i=0; i<InLength; i++)
 	{
 		m_rZBuf[m_State] = InBuf[i];
-		Hptr = &m_Coef[m_NumTaps - m_State];
-		Zptr = m_rZBuf;
-		acc = (*Hptr++ * *Zptr++);	//do the 1st MAC
-		for(int j=1; j<m_NumTaps; j++)
-			acc += (*Hptr++ * *Zptr++);	//do the remaining MACs
+		OutBuf[i] = SimdDotProduct(&m_Coef[m_NumTaps - m_State], m_rZBuf, m_NumTaps);
 		if(--m_State < 0)
 			m_State += m_NumTaps;
-		OutBuf[i] = acc;
 	}
 	m_Mutex.unlock();
 }
@@ -102,30 +99,18 @@ const TYPEREAL* Hptr;
 //   {21, -43, 15, 21, -43, 15 }
 //COMPLEX version
 /////////////////////////////////////////////////////////////////////////////////
-void CFir::ProcessFilter(int InLength, TYPECPX* InBuf, TYPECPX* OutBuf)
+template <typename T>
+void CFirT<T>::ProcessFilter(int InLength, Cpx* InBuf, Cpx* OutBuf)
 {
-TYPECPX acc;
-TYPECPX* Zptr;
-TYPEREAL* HIptr;
-TYPEREAL* HQptr;
-
 	m_Mutex.lock();
 	for(int i=0; i<InLength; i++)
 	{
-		m_cZBuf[m_State] = InBuf[i];
-		HIptr = m_ICoef + m_NumTaps - m_State;
-		HQptr = m_QCoef + m_NumTaps - m_State;
-		Zptr = m_cZBuf;
-		acc.re = (*HIptr++ * (*Zptr).re);		//do the first MAC
-		acc.im = (*HQptr++ * (*Zptr++).im);
-		for(int j=1; j<m_NumTaps; j++)
-		{
-			acc.re += (*HIptr++ * (*Zptr).re);		//do the remaining MACs
-			acc.im += (*HQptr++ * (*Zptr++).im);
-		}
+		m_cZRe[m_State] = InBuf[i].re;
+		m_cZIm[m_State] = InBuf[i].im;
+		OutBuf[i].re = SimdDotProduct(m_ICoef + m_NumTaps - m_State, m_cZRe, m_NumTaps);
+		OutBuf[i].im = SimdDotProduct(m_QCoef + m_NumTaps - m_State, m_cZIm, m_NumTaps);
 		if(--m_State < 0)
 			m_State += m_NumTaps;
-		OutBuf[i] = acc;
 	}
 	m_Mutex.unlock();
 }
@@ -139,31 +124,18 @@ TYPEREAL* HQptr;
 //   {21, -43, 15, 21, -43, 15 }
 //REAL in COMPLEX out version (for Hilbert filter pair)
 /////////////////////////////////////////////////////////////////////////////////
-void CFir::ProcessFilter(int InLength, TYPEREAL* InBuf, TYPECPX* OutBuf)
+template <typename T>
+void CFirT<T>::ProcessFilter(int InLength, T* InBuf, Cpx* OutBuf)
 {
-TYPECPX acc;
-TYPECPX* Zptr;
-TYPEREAL* HIptr;
-TYPEREAL* HQptr;
-
 	m_Mutex.lock();
 	for(int i=0; i<InLength; i++)
 	{
-		m_cZBuf[m_State].re = InBuf[i];
-		m_cZBuf[m_State].im = InBuf[i];
-		HIptr = m_ICoef + m_NumTaps - m_State;
-		HQptr = m_QCoef + m_NumTaps - m_State;
-		Zptr = m_cZBuf;
-		acc.re = (*HIptr++ * (*Zptr).re);		//do the first MAC
-		acc.im = (*HQptr++ * (*Zptr++).im);
-		for(int j=1; j<m_NumTaps; j++)
-		{
-			acc.re += (*HIptr++ * (*Zptr).re);		//do the remaining MACs
-			acc.im += (*HQptr++ * (*Zptr++).im);
-		}
+		m_cZRe[m_State] = InBuf[i];
+		m_cZIm[m_State] = InBuf[i];
+		OutBuf[i].re = SimdDotProduct(m_ICoef + m_NumTaps - m_State, m_cZRe, m_NumTaps);
+		OutBuf[i].im = SimdDotProduct(m_QCoef + m_NumTaps - m_State, m_cZIm, m_NumTaps);
 		if(--m_State < 0)
 			m_State += m_NumTaps;
-		OutBuf[i] = acc;
 	}
 	m_Mutex.unlock();
 }
@@ -172,7 +144,8 @@ TYPEREAL* HQptr;
 //  Initializes a pre-designed FIR filter with fixed coefficients
 //	Iniitalize FIR variables and clear out buffers.
 /////////////////////////////////////////////////////////////////////////////////
-void CFir::InitConstFir( int NumTaps, const TYPEREAL* pCoef, TYPEREAL Fsamprate)
+template <typename T>
+void CFirT<T>::InitConstFir( int NumTaps, const TYPEREAL* pCoef, T Fsamprate)
 {
 	m_Mutex.lock();
 	m_SampleRate = Fsamprate;
@@ -188,8 +161,8 @@ void CFir::InitConstFir( int NumTaps, const TYPEREAL* pCoef, TYPEREAL Fsamprate)
 	for(int i=0; i<m_NumTaps; i++)
 	{	//zero input buffers
 		m_rZBuf[i] = 0.0;
-		m_cZBuf[i].re = 0.0;
-		m_cZBuf[i].im = 0.0;
+		m_cZRe[i] = 0.0;
+		m_cZIm[i] = 0.0;
 	}
 	m_State = 0;	//zero filter state variable
 	m_Mutex.unlock();
@@ -199,7 +172,8 @@ void CFir::InitConstFir( int NumTaps, const TYPEREAL* pCoef, TYPEREAL Fsamprate)
 //  Initializes a pre-designed complex FIR filter with fixed coefficients
 //	Iniitalize FIR variables and clear out buffers.
 /////////////////////////////////////////////////////////////////////////////////
-void CFir::InitConstFir( int NumTaps, const TYPEREAL* pICoef, const TYPEREAL* pQCoef, TYPEREAL Fsamprate)
+template <typename T>
+void CFirT<T>::InitConstFir( int NumTaps, const TYPEREAL* pICoef, const TYPEREAL* pQCoef, T Fsamprate)
 {
 	m_Mutex.lock();
 	m_SampleRate = Fsamprate;
@@ -217,8 +191,8 @@ void CFir::InitConstFir( int NumTaps, const TYPEREAL* pICoef, const TYPEREAL* pQ
 	for(int i=0; i<m_NumTaps; i++)
 	{	//zero input buffers
 		m_rZBuf[i] = 0.0;
-		m_cZBuf[i].re = 0.0;
-		m_cZBuf[i].im = 0.0;
+		m_cZRe[i] = 0.0;
+		m_cZIm[i] = 0.0;
 	}
 	m_State = 0;	//zero filter state variable
 	m_Mutex.unlock();
@@ -242,16 +216,17 @@ void CFir::InitConstFir( int NumTaps, const TYPEREAL* pICoef, const TYPEREAL* pQ
 //                    Fpass   Fstop
 //
 ////////////////////////////////////////////////////////////////////
-int CFir::InitLPFilter(int NumTaps, TYPEREAL Scale, TYPEREAL Astop, TYPEREAL Fpass, TYPEREAL Fstop, TYPEREAL Fsamprate)
+template <typename T>
+int CFirT<T>::InitLPFilter(int NumTaps, T Scale, T Astop, T Fpass, T Fstop, T Fsamprate)
 {
 int n;
-TYPEREAL Beta;
+T Beta;
 	m_Mutex.lock();
 	m_SampleRate = Fsamprate;
 	//create normalized frequency parameters
-	TYPEREAL normFpass = Fpass/Fsamprate;
-	TYPEREAL normFstop = Fstop/Fsamprate;
-	TYPEREAL normFcut = (normFstop + normFpass)/2.0;	//low pass filter 6dB cutoff
+	T normFpass = Fpass/Fsamprate;
+	T normFstop = Fstop/Fsamprate;
+	T normFcut = (normFstop + normFpass)/2.0;	//low pass filter 6dB cutoff
 
 	//calculate Kaiser-Bessel window shape factor, Beta, from stopband attenuation
 	if(Astop < 20.96)
@@ -259,7 +234,7 @@ TYPEREAL Beta;
 	else if(Astop >= 50.0)
 		Beta = .1102 * (Astop - 8.71);
 	else
-		Beta = .5842 * MPOW( (Astop-20.96), 0.4) + .07886 * (Astop - 20.96);
+		Beta = .5842 * Prec::Pow( (Astop-20.96), 0.4) + .07886 * (Astop - 20.96);
 
 	//Now Estimate number of filter taps required based on filter specs
 	m_NumTaps = (Astop - 8.0) / (2.285*K_2PI*(normFstop - normFpass) ) + 1;
@@ -273,20 +248,20 @@ TYPEREAL Beta;
 	if(NumTaps)	//if need to force to to a number of taps
 		m_NumTaps = NumTaps;
 
-	TYPEREAL fCenter = .5*(TYPEREAL)(m_NumTaps-1);
-	TYPEREAL izb = Izero(Beta);		//precalculate denominator since is same for all points
+	T fCenter = .5*(T)(m_NumTaps-1);
+	T izb = Izero(Beta);		//precalculate denominator since is same for all points
 	for( n=0; n < m_NumTaps; n++)
 	{
-		TYPEREAL x = (TYPEREAL)n - fCenter;
-		TYPEREAL c;
+		T x = (T)n - fCenter;
+		T c;
 		// create ideal Sinc() LP filter with normFcut
-		if( (TYPEREAL)n == fCenter )	//deal with odd size filter singularity where sin(0)/0==1
+		if( (T)n == fCenter )	//deal with odd size filter singularity where sin(0)/0==1
 			c = 2.0 * normFcut;
 		else
-			c = MSIN(K_2PI*x*normFcut)/(K_PI*x);
+			c = Prec::Sin(K_2PI*x*normFcut)/(K_PI*x);
 		//calculate Kaiser window and multiply to get coefficient
-		x = ((TYPEREAL)n - ((TYPEREAL)m_NumTaps-1.0)/2.0 ) / (((TYPEREAL)m_NumTaps-1.0)/2.0);
-		m_Coef[n] = Scale * c * Izero( Beta * MSQRT(1 - (x*x) ) )  / izb;
+		x = ((T)n - ((T)m_NumTaps-1.0)/2.0 ) / (((T)m_NumTaps-1.0)/2.0);
+		m_Coef[n] = Scale * c * Izero( Beta * Prec::Sqrt(1 - (x*x) ) )  / izb;
 	}
 
 	//make a 2x length array for FIR flat calculation efficiency
@@ -304,8 +279,8 @@ TYPEREAL Beta;
 	for(int i=0; i<m_NumTaps; i++)
 	{
 		m_rZBuf[i] = 0.0;
-		m_cZBuf[i].re = 0.0;
-		m_cZBuf[i].im = 0.0;
+		m_cZRe[i] = 0.0;
+		m_cZIm[i] = 0.0;
 	}
 	m_State = 0;
 
@@ -351,16 +326,17 @@ TYPEREAL Beta;
 //  Astop ---------
 //            Fstop   Fpass
 ////////////////////////////////////////////////////////////////////
-int CFir::InitHPFilter(int NumTaps, TYPEREAL Scale, TYPEREAL Astop, TYPEREAL Fpass, TYPEREAL Fstop, TYPEREAL Fsamprate)
+template <typename T>
+int CFirT<T>::InitHPFilter(int NumTaps, T Scale, T Astop, T Fpass, T Fstop, T Fsamprate)
 {
 int n;
-TYPEREAL Beta;
+T Beta;
 	m_Mutex.lock();
 	m_SampleRate = Fsamprate;
 	//create normalized frequency parameters
-	TYPEREAL normFpass = Fpass/Fsamprate;
-	TYPEREAL normFstop = Fstop/Fsamprate;
-	TYPEREAL normFcut = (normFstop + normFpass)/2.0;	//high pass filter 6dB cutoff
+	T normFpass = Fpass/Fsamprate;
+	T normFstop = Fstop/Fsamprate;
+	T normFcut = (normFstop + normFpass)/2.0;	//high pass filter 6dB cutoff
 
 	//calculate Kaiser-Bessel window shape factor, Beta, from stopband attenuation
 	if(Astop < 20.96)
@@ -368,7 +344,7 @@ TYPEREAL Beta;
 	else if(Astop >= 50.0)
 		Beta = .1102 * (Astop - 8.71);
 	else
-		Beta = .5842 * MPOW( (Astop-20.96), 0.4) + .07886 * (Astop - 20.96);
+		Beta = .5842 * Prec::Pow( (Astop-20.96), 0.4) + .07886 * (Astop - 20.96);
 
 	//Now Estimate number of filter taps required based on filter specs
 	m_NumTaps = (Astop - 8.0) / (2.285*K_2PI*(normFpass - normFstop ) ) + 1;
@@ -384,21 +360,21 @@ TYPEREAL Beta;
 	if(NumTaps)	//if need to force to to a number of taps
 		m_NumTaps = NumTaps;
 
-	TYPEREAL izb = Izero(Beta);		//precalculate denominator since is same for all points
-	TYPEREAL fCenter = .5*(TYPEREAL)(m_NumTaps-1);
+	T izb = Izero(Beta);		//precalculate denominator since is same for all points
+	T fCenter = .5*(T)(m_NumTaps-1);
 	for( n=0; n < m_NumTaps; n++)
 	{
-		TYPEREAL x = (TYPEREAL)n - (TYPEREAL)(m_NumTaps-1)/2.0;
-		TYPEREAL c;
+		T x = (T)n - (T)(m_NumTaps-1)/2.0;
+		T c;
 		// create ideal Sinc() HP filter with normFcut
-		if( (TYPEREAL)n == fCenter )	//deal with odd size filter singularity where sin(0)/0==1
+		if( (T)n == fCenter )	//deal with odd size filter singularity where sin(0)/0==1
 			c = 1.0 - 2.0 * normFcut;
 		else
-			c = MSIN(K_PI*x)/(K_PI*x) - MSIN(K_2PI*x*normFcut)/(K_PI*x);
+			c = Prec::Sin(K_PI*x)/(K_PI*x) - Prec::Sin(K_2PI*x*normFcut)/(K_PI*x);
 
 		//calculate Kaiser window and multiply to get coefficient
-		x = ((TYPEREAL)n - ((TYPEREAL)m_NumTaps-1.0)/2.0 ) / (((TYPEREAL)m_NumTaps-1.0)/2.0);
-		m_Coef[n] = Scale * c * Izero( Beta * MSQRT(1 - (x*x) ) )  / izb;
+		x = ((T)n - ((T)m_NumTaps-1.0)/2.0 ) / (((T)m_NumTaps-1.0)/2.0);
+		m_Coef[n] = Scale * c * Izero( Beta * Prec::Sqrt(1 - (x*x) ) )  / izb;
 	}
 
 	//make a 2x length array for FIR flat calculation efficiency
@@ -416,8 +392,8 @@ TYPEREAL Beta;
 	for(int i=0; i<m_NumTaps; i++)
 	{
 		m_rZBuf[i] = 0.0;
-		m_cZBuf[i].re = 0.0;
-		m_cZBuf[i].im = 0.0;
+		m_cZRe[i] = 0.0;
+		m_cZIm[i] = 0.0;
 	}
 	m_State = 0;
 
@@ -450,14 +426,15 @@ TYPEREAL Beta;
 // filter coefficients.
 // Hbpreal(n)= 2*Hlp(n)*cos( 2PI*FreqOffset*(n-(N-1)/2)/samplerate );
 // Hbpimaj(n)= 2*Hlp(n)*sin( 2PI*FreqOffset*(n-(N-1)/2)/samplerate );
-void CFir::GenerateHBFilter( TYPEREAL FreqOffset)
+template <typename T>
+void CFirT<T>::GenerateHBFilter( T FreqOffset)
 {
 int n;
 	for(n=0; n<m_NumTaps; n++)
 	{
 		// apply complex frequency shift transform to low pass filter coefficients
-		m_ICoef[n] = 2.0 * m_Coef[n] * MCOS( (K_2PI*FreqOffset/m_SampleRate)*((TYPEREAL)n - ( (TYPEREAL)(m_NumTaps-1)/2.0 ) ) );
-		m_QCoef[n] = 2.0 * m_Coef[n] * MSIN( (K_2PI*FreqOffset/m_SampleRate)*((TYPEREAL)n - ( (TYPEREAL)(m_NumTaps-1)/2.0 ) ) );
+		m_ICoef[n] = 2.0 * m_Coef[n] * Prec::Cos( (K_2PI*FreqOffset/m_SampleRate)*((T)n - ( (T)(m_NumTaps-1)/2.0 ) ) );
+		m_QCoef[n] = 2.0 * m_Coef[n] * Prec::Sin( (K_2PI*FreqOffset/m_SampleRate)*((T)n - ( (T)(m_NumTaps-1)/2.0 ) ) );
 	}
 	//make a 2x length array for FIR flat calculation efficiency
 	for (n = 0; n < m_NumTaps; n++)
@@ -490,14 +467,15 @@ int n;
 //     using a series approximation.
 // I0(x) = 1.0 + { sum from k=1 to infinity ---->  [(x/2)^k / k!]^2 }
 ///////////////////////////////////////////////////////////////////////////
-TYPEREAL CFir::Izero(TYPEREAL x)
+template <typename T>
+T CFirT<T>::Izero(T x)
 {
-TYPEREAL x2 = x/2.0;
-TYPEREAL sum = 1.0;
-TYPEREAL ds = 1.0;
-TYPEREAL di = 1.0;
-TYPEREAL errorlimit = 1e-9;
-TYPEREAL tmp;
+T x2 = x/2.0;
+T sum = 1.0;
+T ds = 1.0;
+T di = 1.0;
+T errorlimit = 1e-9;
+T tmp;
 	do
 	{
 		tmp = x2/di;
@@ -511,6 +489,11 @@ TYPEREAL tmp;
 }
 
 
+//float and double versions of the FIR filter
+template class CFirT<tSReal>;
+template class CFirT<tDReal>;
+
+
 // *&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*
 //						Class to do decimation by 2
 // *&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*
@@ -518,13 +501,14 @@ TYPEREAL tmp;
 //////////////////////////////////////////////////////////////////////
 //Decimate by 2 Halfband filter class implementation
 //////////////////////////////////////////////////////////////////////
-CDecimateBy2::CDecimateBy2(int len,const TYPEREAL* pCoef )
+template <typename T>
+CDecimateBy2T<T>::CDecimateBy2T(int len,const TYPEREAL* pCoef )
 	: m_FirLength(len), m_pCoef(pCoef)
 {
 	//create buffer for FIR implementation
-	m_pHBFirRBuf = new TYPEREAL[MAX_HALF_BAND_BUFSIZE];
-	m_pHBFirCBuf = new TYPECPX[MAX_HALF_BAND_BUFSIZE];
-	TYPECPX CPXZERO = {0.0,0.0};
+	m_pHBFirRBuf = new T[MAX_HALF_BAND_BUFSIZE];
+	m_pHBFirCBuf = new Cpx[MAX_HALF_BAND_BUFSIZE];
+	Cpx CPXZERO = {0.0,0.0};
 	for(int i=0; i<MAX_HALF_BAND_BUFSIZE ;i++)
 	{
 		m_pHBFirRBuf[i] = 0.0;
@@ -539,7 +523,8 @@ CDecimateBy2::CDecimateBy2(int len,const TYPEREAL* pCoef )
 // InLength must be an even number
 //Mono version
 //////////////////////////////////////////////////////////////////////
-int CDecimateBy2::DecBy2(int InLength, TYPEREAL* pInData, TYPEREAL* pOutData)
+template <typename T>
+int CDecimateBy2T<T>::DecBy2(int InLength, T* pInData, T* pOutData)
 {
 int i;
 int j;
@@ -555,7 +540,7 @@ int numoutsamples = 0;
 	//perform decimation FIR filter on even samples
 	for(i=0; i<InLength; i+=2)
 	{
-		TYPEREAL acc;
+		T acc;
 		acc = ( m_pHBFirRBuf[i] * m_pCoef[0] );
 		for(j=2; j<m_FirLength; j+=2)	//only use even coefficients since odd are zero(except center point)
 			acc += ( m_pHBFirRBuf[i+j] * m_pCoef[j] );
@@ -577,7 +562,8 @@ int numoutsamples = 0;
 // InLength must be an even number  ~37nS
 // complex or stereo version
 //////////////////////////////////////////////////////////////////////
-int CDecimateBy2::DecBy2(int InLength, TYPECPX* pInData, TYPECPX* pOutData)
+template <typename T>
+int CDecimateBy2T<T>::DecBy2(int InLength, Cpx* pInData, Cpx* pOutData)
 {
 int i;
 int j;
@@ -593,7 +579,7 @@ qDebug()<<"InLength = "<<InLength;
 	//perform decimation FIR filter on even samples
 	for(i=0; i<InLength; i+=2)
 	{
-		TYPECPX acc;
+		Cpx acc;
 		acc.re = ( m_pHBFirCBuf[i].re * m_pCoef[0] );
 		acc.im = ( m_pHBFirCBuf[i].im * m_pCoef[0] );
 		for(j=2; j<m_FirLength; j+=2)	//only use even coefficients since odd are zero(except center point)
@@ -613,3 +599,8 @@ qDebug()<<"InLength = "<<InLength;
 		m_pHBFirCBuf[i] = pInData[j++];
 	return numoutsamples;
 }
+
+
+//float and double versions of the half band decimator
+template class CDecimateBy2T<tSReal>;
+template class CDecimateBy2T<tDReal>;
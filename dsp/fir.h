@@ -11,6 +11,8 @@
 //	2011-03-27  Initial release
 //	2011-08-05  Added decimate by 2 class
 //	2011-08-07  Modified FIR filter initialization
+//	2026-10-18  CFir is CFirT<TYPEREAL>, float and double versions are built
+//	2026-10-18  CDecimateBy2 is CDecimateBy2T<TYPEREAL>
 //////////////////////////////////////////////////////////////////////
 //==========================================================================================
 // + + +   This Software is released under the "Simplified BSD License"  + + +
@@ -50,49 +52,61 @@
 #include <QMutex>
 
 ////////////
-//class for FIR Filters
+//class for FIR Filters. T is the sample type, tSReal or tDReal.
+// CFir uses the build precision TYPEREAL.
 ////////////
-class CFir
+template <typename T>
+class CFirT
 {
 public:
-    CFir();
+	typedef typename tPrecision<T>::Cpx Cpx;
+    CFirT();
 
-	void InitConstFir( int NumTaps, const TYPEREAL* pCoef, TYPEREAL Fsamprate);
-	void InitConstFir( int NumTaps, const TYPEREAL* pICoef, const TYPEREAL* pQCoef, TYPEREAL Fsamprate);
-	int InitLPFilter(int NumTaps, TYPEREAL Scale, TYPEREAL Astop, TYPEREAL Fpass, TYPEREAL Fstop, TYPEREAL Fsamprate);
-	int InitHPFilter(int NumTaps, TYPEREAL Scale, TYPEREAL Astop, TYPEREAL Fpass, TYPEREAL Fstop, TYPEREAL Fsamprate);
-	void GenerateHBFilter( TYPEREAL FreqOffset);
-	void ProcessFilter(int InLength, TYPEREAL* InBuf, TYPEREAL* OutBuf);
-	void ProcessFilter(int InLength, TYPEREAL* InBuf, TYPECPX* OutBuf);
-	void ProcessFilter(int InLength, TYPECPX* InBuf, TYPECPX* OutBuf);
+	void InitConstFir( int NumTaps, const TYPEREAL* pCoef, T Fsamprate);
+	void InitConstFir( int NumTaps, const TYPEREAL* pICoef, const TYPEREAL* pQCoef, T Fsamprate);
+	int InitLPFilter(int NumTaps, T Scale, T Astop, T Fpass, T Fstop, T Fsamprate);
+	int InitHPFilter(int NumTaps, T Scale, T Astop, T Fpass, T Fstop, T Fsamprate);
+	void GenerateHBFilter( T FreqOffset);
+	void ProcessFilter(int InLength, T* InBuf, T* OutBuf);
+	void ProcessFilter(int InLength, T* InBuf, Cpx* OutBuf);
+	void ProcessFilter(int InLength, Cpx* InBuf, Cpx* OutBuf);
 
 private:
-	TYPEREAL Izero(TYPEREAL x);
-	TYPEREAL m_SampleRate;
+	typedef tPrecision<T> Prec;
+	T Izero(T x);
+	T m_SampleRate;
 	int m_NumTaps;
 	int m_State;
-	TYPEREAL m_Coef[MAX_NUMCOEF*2];
-	TYPEREAL m_ICoef[MAX_NUMCOEF*2];
-	TYPEREAL m_QCoef[MAX_NUMCOEF*2];
-	TYPEREAL m_rZBuf[MAX_NUMCOEF];
-	TYPECPX m_cZBuf[MAX_NUMCOEF];
+	T m_Coef[MAX_NUMCOEF*2];
+	T m_ICoef[MAX_NUMCOEF*2];
+	T m_QCoef[MAX_NUMCOEF*2];
+	T m_rZBuf[MAX_NUMCOEF];
+	T m_cZRe[MAX_NUMCOEF];	//complex delay line kept as I and Q planes
+	T m_cZIm[MAX_NUMCOEF];	// for the dot product kernels
 	QMutex m_Mutex;		//for keeping threads from stomping on each other
 };
 
+typedef CFirT<TYPEREAL> CFir;
+
 ////////////
 //class for the Half Band decimate by 2 FIR filters
+// T is the sample type, the coefficient tables stay TYPEREAL.
 ////////////
-class CDecimateBy2
+template <typename T>
+class CDecimateBy2T
 {
 public:
-	CDecimateBy2(int len, const TYPEREAL* pCoef);
-	~CDecimateBy2(){if(m_pHBFirRBuf) delete m_pHBFirRBuf; if(m_pHBFirCBuf) delete m_pHBFirCBuf;}
-	int DecBy2(int InLength, TYPEREAL* pInData, TYPEREAL* pOutData);
-	int DecBy2(int InLength, TYPECPX* pInData, TYPECPX* pOutData);
-	TYPEREAL* m_pHBFirRBuf;
-	TYPECPX* m_pHBFirCBuf;
+	typedef typename tPrecision<T>::Cpx Cpx;
+	CDecimateBy2T(int len, const TYPEREAL* pCoef);
+	~CDecimateBy2T(){if(m_pHBFirRBuf) delete m_pHBFirRBuf; if(m_pHBFirCBuf) delete m_pHBFirCBuf;}
+	int DecBy2(int InLength, T* pInData, T* pOutData);
+	int DecBy2(int InLength, Cpx* pInData, Cpx* pOutData);
+	T* m_pHBFirRBuf;
+	Cpx* m_pHBFirCBuf;
 	int m_FirLength;
 	const TYPEREAL* m_pCoef;
 };
 
+typedef CDecimateBy2T<TYPEREAL> CDecimateBy2;
+
 #endif // FIR_H
@@ -127,3 +127,26 @@ const TYPEREAL FSK1_COEF[FSK1_LENGTH] = {
     0.000621844768,
     0.000556525454
 };
+
+#define HILB_LENGTH 61
+const TYPEREAL HILBLP_H[HILB_LENGTH] =
+{	//LowPass filter prototype that is shifted and "hilbertized" to get 90 deg phase shift
+	//and convert to baseband complex domain.
+	//kaiser-Bessel alpha 1.4  cutoff 30Khz at sample rate of 250KHz
+	-0.000389631665953405,0.000115430826670992,0.000945331102222503,0.001582460677684605,
+	 0.001370803713784687,-0.000000000000000002,-0.002077413537668161,-0.003656132107176520,
+	-0.003372610825000167,-0.000649815020884706, 0.003583263233560064, 0.006997162933343487,
+	 0.006990985399916562, 0.002383133886438500,-0.005324501734543406,-0.012092135317628615,
+	-0.013212201698221963,-0.006168904735839018, 0.007082277142635906, 0.020017841466263672,
+	 0.024271835962039127, 0.014255112728911837,-0.008597071392140753,-0.034478282954624850,
+	-0.048147195828726633,-0.035409729589347565, 0.009623663461671806, 0.080084441681677138,
+	 0.157278883310078170, 0.217148915611638180, 0.239688166538436750, 0.217148915611638180,
+	 0.157278883310078170, 0.080084441681677138, 0.009623663461671806,-0.035409729589347565,
+	-0.048147195828726633,-0.034478282954624850,-0.008597071392140753, 0.014255112728911837,
+	 0.024271835962039127, 0.020017841466263672, 0.007082277142635906,-0.006168904735839018,
+	-0.013212201698221963,-0.012092135317628615,-0.005324501734543406, 0.002383133886438500,
+	 0.006990985399916562, 0.006997162933343487, 0.003583263233560064,-0.000649815020884706,
+	-0.003372610825000167,-0.003656132107176520,-0.002077413537668161,-0.000000000000000002,
+	 0.001370803713784687, 0.001582460677684605, 0.000945331102222503, 0.000115430826670992,
+	-0.000389631665953405
+};
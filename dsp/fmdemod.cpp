@@ -8,6 +8,8 @@
 //	2011-03-27  Initial release
 //	2011-08-07  Modified FIR filter initialization to force fixed size
 //	2013-07-28  Added single/double precision math macros
+//	2026-10-18  PLL phase detector uses FastAtan2()
+//	2026-10-18  Added Init() so one instance can be reused
 //////////////////////////////////////////////////////////////////////
 
 //==========================================================================================
@@ -41,6 +43,7 @@
 #include "fmdemod.h"
 #include "gui/testbench.h"
 #include "dsp/datatypes.h"
+#include "dsp/simdops.h"
 #include <QDebug>
 
 
@@ -63,13 +66,21 @@
 /////////////////////////////////////////////////////////////////////////////////
 //	Construct FM demod object
 /////////////////////////////////////////////////////////////////////////////////
-CFmDemod::CFmDemod(TYPEREAL samplerate) : m_SampleRate(samplerate)
+CFmDemod::CFmDemod(TYPEREAL samplerate)
+{
+	Init(samplerate);
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//	Sets the sample rate and clears the demod state
+/////////////////////////////////////////////////////////////////////////////////
+void CFmDemod::Init(TYPEREAL samplerate)
 {
 	m_FreqErrorDC = 0.0;
 	m_NcoPhase = 0.0;
 	m_NcoFreq = 0.0;
 
-	SetSampleRate(m_SampleRate);
+	SetSampleRate(samplerate);
 }
 
 
@@ -193,7 +204,7 @@ TYPECPX tmp;
 		tmp.re = Cos * pInData[i].re - Sin * pInData[i].im;
 		tmp.im = Cos * pInData[i].im + Sin * pInData[i].re;
 		//find current sample phase after being shifted by NCO frequency
-		TYPEREAL phzerror = -MATAN2(tmp.im, tmp.re);
+		TYPEREAL phzerror = -FastAtan2(tmp.im, tmp.re);
 		//create new NCO frequency term
 		m_NcoFreq += (m_PllBeta * phzerror);		//  radians per sampletime
 		//clamp NCO frequency so doesn't get out of lock range
@@ -233,7 +244,7 @@ TYPECPX tmp;
 		tmp.re = Cos * pInData[i].re - Sin * pInData[i].im;
 		tmp.im = Cos * pInData[i].im + Sin * pInData[i].re;
 		//find current sample phase after being shifted by NCO frequency
-		TYPEREAL phzerror = -MATAN2(tmp.im, tmp.re);
+		TYPEREAL phzerror = -FastAtan2(tmp.im, tmp.re);
 
 		m_NcoFreq += (m_PllBeta * phzerror);		//  radians per sampletime
 		//clamp NCO frequency so doesn't drift out of lock range
@@ -4,6 +4,7 @@
 // History:
 //	2011-01-17  Initial creation MSW
 //	2011-03-27  Initial release
+//	2026-10-18  Added Init() so one instance can be reused
 /////////////////////////////////////////////////////////////////////
 //==========================================================================================
 // + + +   This Software is released under the "Simplified BSD License"  + + +
@@ -45,6 +46,7 @@ class CFmDemod
 {
 public:
 	CFmDemod(TYPEREAL samplerate);
+	void Init(TYPEREAL samplerate);		//clears the state for a new sample rate
 	//overloaded functions for mono and stereo
 	int ProcessData(int InLength, TYPEREAL FmBW, TYPECPX* pInData, TYPECPX* pOutData);
 	int ProcessData(int InLength, TYPEREAL FmBW, TYPECPX* pInData, TYPEREAL* pOutData);
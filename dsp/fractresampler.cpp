@@ -4,11 +4,16 @@
 //  This class implements a fractional resampler that can be used to
 //convert between different sample rates.  A windowes sinc interpolator
 // is used to create samples "in between" input samples.
+//  The windowed sinc is stored as a small polyphase table of SINC_PHASES
+// filters and the filter for any fractional time is linearly interpolated
+// between the two nearest phases.
 //
 // History:
 //	2010-09-15  Initial creation MSW
 //	2011-03-27  Initial release
 //	2013-07-28  Added single/double precision math macros
+//	2026-10-18  Replaced large sinc table with polyphase table and SIMD dot products
+//	2026-10-18  CFractResampler is CFractResamplerT<TYPEREAL>, float and double versions are built
 /////////////////////////////////////////////////////////////////////
 
 //==========================================================================================
@@ -41,6 +46,7 @@
 //==========================================================================================
 
 #include "dsp/fractresampler.h"
+#include "dsp/simdops.h"
 #include <QDir>
 #include <QFile>
 #include <QDebug>
@@ -49,17 +55,16 @@
 // Local defines
 //////////////////////////////////////////////////////////////////////
 #ifdef USE_DOUBLE_PRECISION
-#define SINC_PERIOD_PTS 10000	//number of points in sinc table between "zero crossings"
-								//smaller value increases noise floor
 #define SINC_PERIODS 28	//number of input sample periods("zero crossings"-1) in
 						//sinc function(should be even)
 						//decreasing reduces alias free bandwidth
 #else   //if using single precision math assume lightweight CPU and dont worry so much about resample quality
-#define SINC_PERIOD_PTS 1000
 #define SINC_PERIODS 10
 #endif
+#define SINC_PHASES 256		//number of fractional time phases in table
+							//smaller value increases noise floor
 
-#define SINC_LENGTH	( (SINC_PERIODS)*SINC_PERIOD_PTS + 1)//number of total points in sinc table
+#define TABLE_LENGTH ( (SINC_PHASES+1)*SINC_PERIODS )	//number of total points in phase table
 
 #define MAX_SOUNDCARDVAL 32767.0
 
@@ -67,58 +72,77 @@
 //////////////////////////////////////////////////////////////////////
 // Construction/Destruction
 //////////////////////////////////////////////////////////////////////
-CFractResampler::CFractResampler()
+template <typename T>
+CFractResamplerT<T>::CFractResamplerT()
 {
-	m_pSinc = NULL;
-	m_pInputBuf = NULL;
-
+	m_pPhaseTable = NULL;
+	m_pInputRe = NULL;
+	m_pInputIm = NULL;
 }
 
-CFractResampler::~CFractResampler()
+template <typename T>
+CFractResamplerT<T>::~CFractResamplerT()
 {
-	if(m_pSinc)
-		delete m_pSinc;
-	if(m_pInputBuf)
-		delete m_pInputBuf;
+	if(m_pPhaseTable)
+		delete [] m_pPhaseTable;
+	if(m_pInputRe)
+		delete [] m_pInputRe;
+	if(m_pInputIm)
+		delete [] m_pInputIm;
 }
 
 //////////////////////////////////////////////////////////////////////
-// Initialize resampler memory and create windowed sinc table
+// Initialize resampler memory and create windowed sinc phase table
 // MaxInputSize is the largest number of input samples expected to be processed
+// Row p of the table holds the SINC_PERIODS filter taps for an output
+//time p/SINC_PHASES of an input sample past the integer time.  Tap i is
+//the Blackman-Harris windowed sinc evaluated at t = i+1 - p/SINC_PHASES
+//where the window spans t = 0 to SINC_PERIODS.
 //////////////////////////////////////////////////////////////////////
-void CFractResampler::Init(int MaxInputSize)
+template <typename T>
+void CFractResamplerT<T>::Init(int MaxInputSize)
 {
 int i;
-TYPEREAL fi;
-TYPEREAL window;
+int p;
+T fi;
+T window;
 	MaxInputSize += SINC_PERIODS;	//expand buffer size  to include wrap around
-	if(NULL == m_pSinc)
-		m_pSinc = new  TYPEREAL[SINC_LENGTH];
-	if(m_pInputBuf)
-		delete m_pInputBuf;
-	m_pInputBuf = new TYPECPX[MaxInputSize];
+	if(m_pInputRe)
+		delete [] m_pInputRe;
+	if(m_pInputIm)
+		delete [] m_pInputIm;
+	m_pInputRe = new T[MaxInputSize];
+	m_pInputIm = new T[MaxInputSize];
 	for(i=0; i<MaxInputSize; i++)
 	{
-		m_pInputBuf[i].re = 0.0;
-		m_pInputBuf[i].im = 0.0;
+		m_pInputRe[i] = 0.0;
+		m_pInputIm[i] = 0.0;
 	}
-	for(i=0; i<SINC_LENGTH; i++)
-	{	//calc Blackman-Harris window points
-		window = (0.35875
-				- 0.48829*MCOS( (K_2PI*i)/(SINC_LENGTH-1) )
-				+ 0.14128*MCOS( (2.0*K_2PI*i)/(SINC_LENGTH-1) )
-				- 0.01168*MCOS( (3.0*K_2PI*i)/(SINC_LENGTH-1) ) );
-		//calculate sin(x)/x    sinc point * window
-		fi = K_PI*(TYPEREAL)(i - SINC_LENGTH/2)/(TYPEREAL)SINC_PERIOD_PTS ;
-		if(i != SINC_LENGTH/2)
-			m_pSinc[i] = window * (TYPEREAL)MSIN( (TYPEREAL)fi )/(TYPEREAL)fi;
-		else
-			m_pSinc[i] = 1.0;
-
+	if(NULL == m_pPhaseTable)
+	{
+		m_pPhaseTable = new T[TABLE_LENGTH];
+		for(p=0; p<=SINC_PHASES; p++)
+		{
+			for(i=0; i<SINC_PERIODS; i++)
+			{
+				T t = (T)(i+1) - (T)p/(T)SINC_PHASES;
+				//calc Blackman-Harris window points
+				window = (0.35875
+						- 0.48829*Prec::Cos( (K_2PI*t)/SINC_PERIODS )
+						+ 0.14128*Prec::Cos( (2.0*K_2PI*t)/SINC_PERIODS )
+						- 0.01168*Prec::Cos( (3.0*K_2PI*t)/SINC_PERIODS ) );
+				//calculate sin(x)/x    sinc point * window
+				fi = K_PI*(t - (T)(SINC_PERIODS/2));
+				if( Prec::Fabs(fi) > 1.0e-9 )
+					m_pPhaseTable[p*SINC_PERIODS + i] = window * (T)Prec::Sin( (T)fi )/(T)fi;
+				else
+					m_pPhaseTable[p*SINC_PERIODS + i] = 1.0;
+			}
+		}
 	}
 	m_FloatTime = 0.0;		//init floating point time accumulator
 
-#if 0		//debug hack to write m_pSinc to a file for analysis
+#if 0		//debug hack to write m_pPhaseTable to a file for analysis
 	QDir::setCurrent("d:/");
 	QFile File;
 	File.setFileName("Sinc.txt");
@@ -126,9 +150,9 @@ TYPEREAL window;
 	{
 		qDebug()<<"file Opened OK";
 		char Buf[30000];
-		for( i=0; i<SINC_LENGTH; i++)
+		for( i=0; i<TABLE_LENGTH; i++)
 		{
-			sprintf( Buf, "%19.12g\r\n", m_pSinc[i]);
+			sprintf( Buf, "%19.12g\r\n", m_pPhaseTable[i]);
 			File.write(Buf);
 		}
 	}
@@ -138,6 +162,44 @@ TYPEREAL window;
 #endif
 }
 
+//////////////////////////////////////////////////////////////////////
+// Convolve the windowed sinc centered at the current output time
+//with the input samples starting at IntegerTime+1.
+// The result from the two nearest table phases is linearly interpolated
+//which is the same as interpolating the filter taps.
+// REAL version uses m_pInputRe only
+//////////////////////////////////////////////////////////////////////
+template <typename T>
+inline T CFractResamplerT<T>::Convolve(int IntegerTime)
+{
+	T frac = (m_FloatTime - (T)IntegerTime)*(T)SINC_PHASES;
+	int p = (int)frac;
+	frac -= (T)p;
+	const T* pH = &m_pPhaseTable[p*SINC_PERIODS];
+	const T* pX = &m_pInputRe[IntegerTime+1];
+	T acc0 = SimdDotProduct(pX, pH, SINC_PERIODS);
+	T acc1 = SimdDotProduct(pX, pH+SINC_PERIODS, SINC_PERIODS);
+	return acc0 + frac*(acc1 - acc0);
+}
+
+// COMPLEX version
+template <typename T>
+inline void CFractResamplerT<T>::Convolve(int IntegerTime, Cpx& Out)
+{
+	T frac = (m_FloatTime - (T)IntegerTime)*(T)SINC_PHASES;
+	int p = (int)frac;
+	frac -= (T)p;
+	const T* pH = &m_pPhaseTable[p*SINC_PERIODS];
+	Cpx acc0;
+	Cpx acc1;
+	SimdDotProduct2(&m_pInputRe[IntegerTime+1], &m_pInputIm[IntegerTime+1], pH,
+					SINC_PERIODS, acc0.re, acc0.im);
+	SimdDotProduct2(&m_pInputRe[IntegerTime+1], &m_pInputIm[IntegerTime+1], pH+SINC_PERIODS,
+					SINC_PERIODS, acc1.re, acc1.im);
+	Out.re = acc0.re + frac*(acc1.re - acc0.re);
+	Out.im = acc0.im + frac*(acc1.im - acc0.im);
+}
+
 //////////////////////////////////////////////////////////////////////
 // Resample InLength samples in pInBuf and place into pOutBuf
 // using Rate = input rate / output rate
@@ -145,19 +207,22 @@ TYPEREAL window;
 //  the generated samples, especially if up converting  !!!!!
 // COMPLEX version
 //////////////////////////////////////////////////////////////////////
-int CFractResampler::Resample( int InLength, TYPEREAL Rate, TYPECPX* pInBuf, TYPECPX* pOutBuf)
+template <typename T>
+int CFractResamplerT<T>::Resample( int InLength, T Rate, Cpx* pInBuf, Cpx* pOutBuf)
 {
 int i;
 int j;
 int IntegerTime = (int)m_FloatTime;	//integer input time accumulator
-TYPEREAL dt = Rate;	//output delta time as function of input sample time (input rate/output rate)
+T dt = Rate;	//output delta time as function of input sample time (input rate/output rate)
 int outsamples = 0;
-TYPECPX acc;
 
 	//copy input samples into buffer starting at position SINC_PERIODS
 	j = SINC_PERIODS;
 	for(i=0; i<InLength; i++)
-		m_pInputBuf[j++] = pInBuf[i];
+	{
+		m_pInputRe[j] = pInBuf[i].re;
+		m_pInputIm[j++] = pInBuf[i].im;
+	}
 	//now calculate output samples by looping until end of input buffer
 	// is reached.  The output position is incremented in fractional time
 	// of input sample time until all the possible input samples are
@@ -165,25 +230,20 @@ TYPECPX acc;
 	while(IntegerTime < InLength )
 	{	//convolve sinc function with input samples where sinc
 		//function is centered at the output fractional time position
-		acc.re = 0.0; acc.im = 0.0;
-		for(i=1; i<=SINC_PERIODS; i++)
-		{
-			j = IntegerTime + i;	//temp integer time position for convolution loop
-			int sindx =  (int)(( (TYPEREAL)j - m_FloatTime) * (TYPEREAL)SINC_PERIOD_PTS );
-			acc.re += (m_pInputBuf[j].re * m_pSinc[sindx] );
-			acc.im += (m_pInputBuf[j].im * m_pSinc[sindx] );
-		}
-		pOutBuf[outsamples++] = acc;
+		Convolve(IntegerTime, pOutBuf[outsamples++]);
 		m_FloatTime += dt;		//inc floating pt output time step
 		IntegerTime = (int)m_FloatTime;	//truncate to integer
 	}
-	m_FloatTime -= (TYPEREAL)InLength;	//move floating time position back for next call
+	m_FloatTime -= (T)InLength;	//move floating time position back for next call
 										//keeping leftover fraction
 	//need to copy last SINC_PERIODS input samples in buffer to beginning of buffer
 	// for FIR wrap around management. j points to last input sample processed
 	j = InLength;
 	for(i=0; i<SINC_PERIODS; i++)
-		m_pInputBuf[i] = m_pInputBuf[j++];
+	{
+		m_pInputRe[i] = m_pInputRe[j];
+		m_pInputIm[i] = m_pInputIm[j++];
+	}
 	return outsamples;		//return number of output samples processed
 }
 
@@ -195,20 +255,22 @@ TYPECPX acc;
 //  the generated samples, especially if up converting  !!!!!
 // stereo Integer version
 //////////////////////////////////////////////////////////////////////
-int CFractResampler::Resample( int InLength, TYPEREAL Rate, TYPECPX* pInBuf, TYPESTEREO16* pOutBuf, TYPEREAL gain)
+template <typename T>
+int CFractResamplerT<T>::Resample( int InLength, T Rate, Cpx* pInBuf, TYPESTEREO16* pOutBuf, T gain)
 {
 int i;
 int j;
 int IntegerTime = (int)m_FloatTime;	//integer input time accumulator
-TYPEREAL dt = Rate;	//output delta time as function of input sample time (input rate/output rate)
+T dt = Rate;	//output delta time as function of input sample time (input rate/output rate)
 int outsamples = 0;
-TYPECPX acc;
+Cpx acc;
 
 	//copy input samples into buffer starting at position SINC_PERIODS
 	j = SINC_PERIODS;
 	for(i=0; i<InLength; i++)
 	{
-		m_pInputBuf[j++] = pInBuf[i];
+		m_pInputRe[j] = pInBuf[i].re;
+		m_pInputIm[j++] = pInBuf[i].im;
 	}
 	//now calculate output samples by looping until end of input buffer
 	// is reached.  The output position is incremented in fractional time
@@ -217,15 +279,8 @@ TYPECPX acc;
 	while(IntegerTime < InLength )
 	{	//convolve sinc function with input samples where sinc
 		//function is centered at the output fractional time position
-		acc.re = 0.0; acc.im = 0.0;
-		for(i=1; i<=SINC_PERIODS; i++)
-		{
-			j = IntegerTime + i;	//temp integer time position for convolution loop
-			int sindx =  (int)(( (TYPEREAL)j - m_FloatTime) * (TYPEREAL)SINC_PERIOD_PTS );
-			acc.re += (m_pInputBuf[j].re * m_pSinc[sindx] );
-			acc.im += (m_pInputBuf[j].im * m_pSinc[sindx] );
-		}
-		TYPECPX tmp;
+		Convolve(IntegerTime, acc);
+		Cpx tmp;
 		tmp.re = (acc.re * gain);;
 		tmp.im = (acc.im * gain);;
 		if(tmp.re > MAX_SOUNDCARDVAL)
@@ -242,13 +297,16 @@ TYPECPX acc;
 		m_FloatTime += dt;	//inc floating pt output time step
 		IntegerTime = (int)m_FloatTime;	//truncate to integer
 	}
-	m_FloatTime -= (TYPEREAL)InLength;	//move floating time position back for next call
+	m_FloatTime -= (T)InLength;	//move floating time position back for next call
 										//keeping leftover fraction
 	//need to copy last SINC_PERIODS input samples in buffer to beginning of buffer
 	// for FIR wrap around management. j points to last input sample processed
 	j = InLength;
 	for(i=0; i<SINC_PERIODS; i++)
-		m_pInputBuf[i] = m_pInputBuf[j++];
+	{
+		m_pInputRe[i] = m_pInputRe[j];
+		m_pInputIm[i] = m_pInputIm[j++];
+	}
 	return outsamples;		//return number of output samples processed
 }
 
@@ -259,19 +317,19 @@ TYPECPX acc;
 //  the generated samples, especially if up converting  !!!!!
 // REAL version
 //////////////////////////////////////////////////////////////////////
-int CFractResampler::Resample( int InLength, TYPEREAL Rate, TYPEREAL* pInBuf, TYPEREAL* pOutBuf)
+template <typename T>
+int CFractResamplerT<T>::Resample( int InLength, T Rate, T* pInBuf, T* pOutBuf)
 {
 int i;
 int j;
 int IntegerTime = (int)m_FloatTime;	//integer input time accumulator
-TYPEREAL dt = Rate;	//output delta time as function of input sample time (input rate/output rate)
+T dt = Rate;	//output delta time as function of input sample time (input rate/output rate)
 int outsamples = 0;
-TYPEREAL acc;
 
 	//copy input samples into buffer starting at position SINC_PERIODS
 	j = SINC_PERIODS;
 	for(i=0; i<InLength; i++)
-		m_pInputBuf[j++].re = pInBuf[i];
+		m_pInputRe[j++] = pInBuf[i];
 	//now calculate output samples by looping until end of input buffer
 	// is reached.  The output position is incremented in fractional time
 	// of input sample time until all the possible input samples are
@@ -279,24 +337,17 @@ TYPEREAL acc;
 	while(IntegerTime < InLength )
 	{	//convolve sinc function with input samples where sinc
 		//function is centered at the output fractional time position
-		acc = 0.0;
-		for(i=1; i<=SINC_PERIODS; i++)
-		{
-			j = IntegerTime + i;	//temp integer time position for convolution loop
-			int sindx =  (int)(( (TYPEREAL)j - m_FloatTime) * (TYPEREAL)SINC_PERIOD_PTS );
-			acc += (m_pInputBuf[j].re * m_pSinc[sindx] );
-		}
-		pOutBuf[outsamples++] = acc;
+		pOutBuf[outsamples++] = Convolve(IntegerTime);
 		m_FloatTime += dt;
 		IntegerTime = (int)m_FloatTime;
 	}
-	m_FloatTime -= (TYPEREAL)InLength;	//move floating time position back for next call
+	m_FloatTime -= (T)InLength;	//move floating time position back for next call
 										//keeping leftover fraction
 	//need to copy last SINC_PERIODS input samples in buffer to beginning of buffer
 	// for FIR wrap around management. j points to last input sample processed
 	j = InLength;
 	for(i=0; i<SINC_PERIODS; i++)
-		m_pInputBuf[i].re = m_pInputBuf[j++].re;
+		m_pInputRe[i] = m_pInputRe[j++];
 	return outsamples;
 }
 
@@ -307,19 +358,20 @@ TYPEREAL acc;
 //  the generated samples, especially if up converting  !!!!!
 // short Integer version
 //////////////////////////////////////////////////////////////////////
-int CFractResampler::Resample( int InLength, TYPEREAL Rate, TYPEREAL* pInBuf, TYPEMONO16* pOutBuf, TYPEREAL gain)
+template <typename T>
+int CFractResamplerT<T>::Resample( int InLength, T Rate, T* pInBuf, TYPEMONO16* pOutBuf, T gain)
 {
 int i;
 int j;
 int IntegerTime = (int)m_FloatTime;	//integer input time accumulator
-TYPEREAL dt = Rate;	//output delta time as function of input sample time (input rate/output rate)
+T dt = Rate;	//output delta time as function of input sample time (input rate/output rate)
 int outsamples = 0;
-TYPEREAL acc;
+T acc;
 
 	//copy input samples into buffer starting at position SINC_PERIODS
 	j = SINC_PERIODS;
 	for(i=0; i<InLength; i++)
-		m_pInputBuf[j++].re = pInBuf[i];
+		m_pInputRe[j++] = pInBuf[i];
 	//now calculate output samples by looping until end of input buffer
 	// is reached.  The output position is incremented in fractional time
 	// of input sample time until all the possible input samples are
@@ -327,14 +379,8 @@ TYPEREAL acc;
 	while(IntegerTime < InLength )
 	{	//convolve sinc function with input samples where sinc
 		//function is centered at the output fractional time position
-		acc = 0.0;
-		for(i=1; i<=SINC_PERIODS; i++)
-		{
-			j = IntegerTime + i;	//temp integer time position for convolution loop
-			int sindx =  (int)(( (TYPEREAL)j - m_FloatTime) * (TYPEREAL)SINC_PERIOD_PTS );
-			acc += (m_pInputBuf[j].re * m_pSinc[sindx] );
-		}
-		TYPEREAL tmp;
+		acc = Convolve(IntegerTime);
+		T tmp;
 		tmp = (acc * gain);;
 		if(tmp > MAX_SOUNDCARDVAL)
 			tmp = MAX_SOUNDCARDVAL;
@@ -345,12 +391,17 @@ TYPEREAL acc;
 		m_FloatTime += dt;
 		IntegerTime = (int)m_FloatTime;
 	}
-	m_FloatTime -= (TYPEREAL)InLength;	//move floating time position back for next call
+	m_FloatTime -= (T)InLength;	//move floating time position back for next call
 										//keeping leftover fraction
 	//need to copy last SINC_PERIODS input samples in buffer to beginning of buffer
 	// for FIR wrap around management. j points to last input sample processed
 	j = InLength;
 	for(i=0; i<SINC_PERIODS; i++)
-		m_pInputBuf[i].re = m_pInputBuf[j++].re;
+		m_pInputRe[i] = m_pInputRe[j++];
 	return outsamples;
 }
+
+
+//float and double versions of the resampler
+template class CFractResamplerT<tSReal>;
+template class CFractResamplerT<tDReal>;
@@ -7,6 +7,8 @@
 // History:
 //	2010-09-15  Initial creation MSW
 //	2011-03-27  Initial release
+//	2026-10-18  Replaced large sinc table with polyphase table
+//	2026-10-18  CFractResampler is CFractResamplerT<TYPEREAL>, float and double versions are built
 //////////////////////////////////////////////////////////////////////
 //==========================================================================================
 // + + +   This Software is released under the "Simplified BSD License"  + + +
@@ -41,23 +43,35 @@
 
 #include "dsp/datatypes.h"
 
-class CFractResampler  
+////////////
+//Fractional resampler class. T is the sample type, tSReal or tDReal.
+// CFractResampler uses the build precision TYPEREAL.
+////////////
+template <typename T>
+class CFractResamplerT
 {
 public:
-	CFractResampler();
-	virtual ~CFractResampler();
+	typedef typename tPrecision<T>::Cpx Cpx;
+	CFractResamplerT();
+	virtual ~CFractResamplerT();
 
 	void Init(int MaxInputSize);
 	//overloaded functions for processing different data types
-	int Resample( int InLength, TYPEREAL Rate, TYPEREAL* pInBuf, TYPEREAL* pOutBuf);
-	int Resample( int InLength, TYPEREAL Rate, TYPECPX* pInBuf, TYPECPX* pOutBuf);
-	int Resample( int InLength, TYPEREAL Rate, TYPEREAL* pInBuf, TYPEMONO16* pOutBuf, TYPEREAL gain);
-	int Resample( int InLength, TYPEREAL Rate, TYPECPX* pInBuf, TYPESTEREO16* pOutBuf, TYPEREAL gain);
+	int Resample( int InLength, T Rate, T* pInBuf, T* pOutBuf);
+	int Resample( int InLength, T Rate, Cpx* pInBuf, Cpx* pOutBuf);
+	int Resample( int InLength, T Rate, T* pInBuf, TYPEMONO16* pOutBuf, T gain);
+	int Resample( int InLength, T Rate, Cpx* pInBuf, TYPESTEREO16* pOutBuf, T gain);
 
 private:
-	TYPEREAL m_FloatTime;	//floating pt output time accumulator
-	TYPEREAL* m_pSinc;	//ptr to sinc table
-	TYPECPX* m_pInputBuf;	//internal working input sample buffer
+	typedef tPrecision<T> Prec;
+	inline T Convolve(int IntegerTime);
+	inline void Convolve(int IntegerTime, Cpx& Out);
+	T m_FloatTime;	//floating pt output time accumulator
+	T* m_pPhaseTable;	//ptr to polyphase windowed sinc table
+	T* m_pInputRe;	//internal working input sample buffers(I or real data)
+	T* m_pInputIm;	//(Q data)
 };
 
+typedef CFractResamplerT<TYPEREAL> CFractResampler;
+
 #endif // FRACTRESAMPLER_H
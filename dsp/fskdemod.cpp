@@ -5,6 +5,8 @@
 // History:
 //	2012-10-19  Initial creation MSW
 //	2017-09-17  Modified MSW
+//	2026-10-18  Split into state structs and block correlator kernel
+//	2026-10-18  Added Init() so one instance can be reused
 //////////////////////////////////////////////////////////////////////
 #include "fskdemod.h"
 #include "gui/testbench.h"
@@ -13,8 +15,6 @@
 #include "dsp/fircoef.h"
 #include <QDebug>
 
-#define SHIFT_FREQ 170.0
-
 //ATC time constants in seconds
 #define ATTACK_TIMECONST 0.025
 #define DECAY_TIMECONST	0.3
@@ -105,54 +105,26 @@ const quint8 CHARTBL[0x400] = {
 /////////////////////////////////////////////////////////////////////////////////
 //	Construct FSK demod object
 /////////////////////////////////////////////////////////////////////////////////
-CFskDemod::CFskDemod(TYPEREAL samplerate) : m_SampleRate(samplerate)
+CFskDemod::CFskDemod(TYPEREAL samplerate)
 {
-qDebug()<<"FSK Rate = "<<m_SampleRate;
-TYPEREAL PhzInc = K_2PI*SHIFT_FREQ/(2.0*m_SampleRate);	// FreqShift/2
-	m_MarkOsc1.re = 1.0;	//initialize oscillator unit vectors that will get rotated
-	m_MarkOsc1.im = 0.0;
-	m_SpaceOsc1.re = 1.0;
-	m_SpaceOsc1.im = 0.0;
-
-	m_MarkOscCos = cos(-PhzInc);
-	m_MarkOscSin = sin(-PhzInc);
-	m_SpaceOscCos = cos(PhzInc);
-	m_SpaceOscSin = sin(PhzInc);
-
-	//init integrators
-	m_MarkIntegratorIndex = 0;
-	m_SpaceIntegratorIndex = 0;
-	for(int i=0; i<INTEGRATOR_BUF_LEN; i++)
-	{
-		m_MarkIntegrationBuf[i].re = 0.0;
-		m_MarkIntegrationBuf[i].im = 0.0;
-		m_SpaceIntegrationBuf[i].re = 0.0;
-		m_SpaceIntegrationBuf[i].im = 0.0;
-	}
+	Init(samplerate);
+}
 
-	//calculate ATC dual time constant filter values.
-	m_AttackAlpha = (1.0-exp(-1.0/(m_SampleRate*ATTACK_TIMECONST)) );
-	m_DecayAlpha = (1.0-exp(-1.0/(m_SampleRate*DECAY_TIMECONST)) );
-	m_MarkAve = 0.0;
-	m_SpaceAve = 0.0;
+/////////////////////////////////////////////////////////////////////////////////
+//	Sets the sample rate and clears the demod and decoder state
+/////////////////////////////////////////////////////////////////////////////////
+void CFskDemod::Init(TYPEREAL samplerate)
+{
+	m_SampleRate = samplerate;
+qDebug()<<"FSK Rate = "<<m_SampleRate;
+	//signal is centered at 0Hz with mark at -85Hz and space at +85Hz
+	InitCorrelator(&m_Corr, m_SampleRate, 0.0);
+	InitBlock(&m_Block, m_SampleRate);
+	InitDecoder(&m_Dsc);
 
 	//Init LP filter for complex input. abt +-250Hz
 	m_Fir.InitConstFir(FSK1_LENGTH, FSK1_COEF, FSK1_COEF, m_SampleRate);
 
-	//Init Post data IIR LP filter
-	m_OutIir.InitLP(150.0, 0.707, m_SampleRate);
-
-	//create Hi-Q resonator at the bit rate to recover bit sync position Q==200
-	m_BitSyncFilter.InitBP(100.0, 200.0, m_SampleRate);
-
-	//init some decoder variables
-	m_RxShiftReg = 0;
-	m_RxBitPos = 0;
-	m_RxDecodeState = STATE_PHASEDET;
-	m_RxDecodeTimer = 0;
-	for(int i=0; i<16; i++)
-		m_ShiftReg[i] = 0;
-
 	//just for testing, create 1700Hz osc for shifting baseband IQ into audio range for soundcard
 	m_AudioShiftOsc1.re = 1.0;	//initialize interocitor unit vectors that will get rotated
 	m_AudioShiftOsc1.im = 0.0;
@@ -167,120 +139,9 @@ TYPEREAL PhzInc = K_2PI*SHIFT_FREQ/(2.0*m_SampleRate);	// FreqShift/2
 int CFskDemod::ProcessData(int InLength, TYPECPX* pInData, TYPECPX* pOutData)
 {
 TYPECPX cxIn;
-TYPECPX cxtmp;
-TYPEREAL Mpwr;
-TYPEREAL Spwr;
 TYPEREAL OscGn;
 TYPECPX Osc;
-	//lowpass Filter +/-250Hz
-	m_Fir.ProcessFilter(InLength, pInData, pInData);
-//g_pTestBench->DisplayData(InLength, pInData, m_SampleRate, PROFILE_2);
-
-	for(int i=0; i<InLength; i++)
-	{
-		cxIn = pInData[i];	//make copy of complex I/Q input sample
-
-		//First Process MARK('1") signal path
-		//create -85Hz Mark correlator Osc samples using quadrature oscillator
-		Osc.re = m_MarkOsc1.re * m_MarkOscCos - m_MarkOsc1.im * m_MarkOscSin;
-		Osc.im = m_MarkOsc1.im * m_MarkOscCos + m_MarkOsc1.re * m_MarkOscSin;
-		OscGn = 1.95 - (m_MarkOsc1.re*m_MarkOsc1.re + m_MarkOsc1.im*m_MarkOsc1.im);
-		m_MarkOsc1.re = OscGn * Osc.re;		//keeps amplitude bounded
-		m_MarkOsc1.im = OscGn * Osc.im;
-		//
-		//Cpx multiply Input sample by Mark shift frequency(bring -85Hz to 0Hz)
-		cxtmp.re = ((cxIn.re * Osc.re) + (cxIn.im * Osc.im));
-		cxtmp.im = ((cxIn.im * Osc.re) - (cxIn.re * Osc.im));
-
-		//place shifted Mark I/Q sample in Circular Integrator Buffer
-		//that is one symbol time deep
-		m_MarkIntegrationBuf[m_MarkIntegratorIndex++] = cxtmp;
-		if(m_MarkIntegratorIndex >= INTEGRATOR_BUF_LEN)
-			m_MarkIntegratorIndex = 0;
-
-		//integrate over the last 'INTEGRATOR_BUF_LEN' samples
-		cxtmp.re = 0.0; cxtmp.im = 0.0;
-		for(int j=0; j<INTEGRATOR_BUF_LEN; j++)
-		{
-			cxtmp.re += m_MarkIntegrationBuf[j].re;
-			cxtmp.im += m_MarkIntegrationBuf[j].im;
-		}
-		//calc correlation energy in Mark signal
-		Mpwr = sqrt(cxtmp.re*cxtmp.re + cxtmp.im*cxtmp.im);
-
-		//create average Mark energy with dual time constant agc for ATC
-		if(Mpwr>m_MarkAve)	//if magnitude is rising (use m_AttackAlpha time constant)
-			m_MarkAve = (1.0-m_AttackAlpha)*m_MarkAve + m_AttackAlpha*Mpwr;
-		else				//else magnitude is falling (use m_DecayAlpha time constant)
-			m_MarkAve = (1.0-m_DecayAlpha)*m_MarkAve + m_DecayAlpha*Mpwr;
-
-		//Now Process SPACE('0') signal path
-		//create +85Hz Space correlator Osc samples using quadrature oscillator
-		Osc.re = m_SpaceOsc1.re * m_SpaceOscCos - m_SpaceOsc1.im * m_SpaceOscSin;
-		Osc.im = m_SpaceOsc1.im * m_SpaceOscCos + m_SpaceOsc1.re * m_SpaceOscSin;
-		OscGn = 1.95 - (m_SpaceOsc1.re*m_SpaceOsc1.re + m_SpaceOsc1.im*m_SpaceOsc1.im);
-		m_SpaceOsc1.re = OscGn * Osc.re;		//keeps amplitude bounded
-		m_SpaceOsc1.im = OscGn * Osc.im;
-
-		//Cpx multiply Input sample by Space shift frequency(bring +85Hz to 0Hz)
-		cxtmp.re = ((cxIn.re * Osc.re) + (cxIn.im * Osc.im));
-		cxtmp.im = ((cxIn.im * Osc.re) - (cxIn.re * Osc.im));
-
-		//place shifted Mark I/Q sample in Circular Integrator Buffer
-		//that is one symbol time deep
-		m_SpaceIntegrationBuf[m_SpaceIntegratorIndex++] = cxtmp;
-		if(m_SpaceIntegratorIndex>=INTEGRATOR_BUF_LEN)
-			m_SpaceIntegratorIndex = 0;
-
-		//integrate over the last 'INTEGRATOR_BUF_LEN' samples
-		cxtmp.re = 0.0; cxtmp.im = 0.0;
-		for(int j=0; j<INTEGRATOR_BUF_LEN; j++)
-		{
-			cxtmp.re += m_SpaceIntegrationBuf[j].re;
-			cxtmp.im += m_SpaceIntegrationBuf[j].im;
-		}
-		//calc correlation energy in Space signal
-		Spwr = sqrt(cxtmp.re*cxtmp.re + cxtmp.im*cxtmp.im);
-
-		//create average Space energy with dual time constant agc for ATC
-		if(Spwr>m_SpaceAve)	//if magnitude is rising (use m_AttackAlpha time constant)
-			m_SpaceAve = (1.0-m_AttackAlpha)*m_SpaceAve + m_AttackAlpha*Spwr;
-		else				//else magnitude is falling (use m_DecayAlpha time constant)
-			m_SpaceAve = (1.0-m_DecayAlpha)*m_SpaceAve + m_DecayAlpha*Spwr;
-
-		//calculate mark-space difference and shift by ATC threshold value
-		//
-		m_Outbuf[i] = (Mpwr - Spwr + m_SpaceAve/2.0 - m_MarkAve/2.0);
-
-		//perform post filter 1 sample at a time in this loop(should be done before ATC?)
-		m_OutIir.ProcessFilter(1, &m_Outbuf[i], &m_Outbuf[i]);
-
-		//create absolute value version of output to use in bit sync algorithm
-		m_SyncSignal[i] = fabs(m_Outbuf[i]);
-	}
-
-	//now Create Bit sync signal with High Q Resonator IIR BP Filter
-	//using squared magnitude of data.  Positive peak of this signal
-	//correspondes to the maximum bit energy position so good place to sample
-	m_BitSyncFilter.ProcessFilter(InLength, m_SyncSignal, m_SyncSignal);
-	for(int i=0; i<InLength; i++)
-	{
-		//the best bit sync position is at the positive peak of the m_SyncSignal waveform
-		TYPEREAL CurrentSlope = m_SyncSignal[i] - m_LastSync;	//current slope
-		//see if at the top peak of the sync waveform(slope changes from pos to neg)
-		if( (CurrentSlope < 0.0) && (m_LastSyncSlope >= 0.0) )
-		{	//are at sample time so use previous bit time value since we are one sample behind in sync position
-			ProcessNewDataBit( (m_LastData>0) );	//go process new DSC bit
-		}
-
-		m_LastSync = m_SyncSignal[i];		//save previous states
-		m_LastSyncSlope = CurrentSlope;
-		m_LastData = m_Outbuf[i];
-
-		pOutData[i].im = m_Outbuf[i]/10.0;	//use pInData as debug output buf for display
-		pOutData[i].re = m_SyncSignal[i]/3.0;	//use pInData as debug output buf for display
-	}
-//g_pTestBench->DisplayData(InLength, pOutData, m_SampleRate, PROFILE_3);
+	DemodBlocks(InLength, pInData);
 
 	//for testing, create 1700Hz shifted copy of IQ data to get sent to soundcard
 	for(int i=0; i<InLength; i++)
@@ -306,276 +167,438 @@ TYPECPX Osc;
 /////////////////////////////////////////////////////////////////////////////////
 int CFskDemod::ProcessData(int InLength, TYPECPX* pInData, TYPEREAL* pOutData)
 {
-TYPECPX cxIn;
-TYPECPX cxtmp;
-TYPEREAL Mpwr;
-TYPEREAL Spwr;
-TYPEREAL OscGn;
-TYPECPX Osc;
+	DemodBlocks(InLength, pInData);
+	for(int i=0; i<InLength; i++)
+	{
+		pOutData[i] = pInData[i].re;
+	}
+
+	return InLength;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//	Filter 'InLength' samples of 'pInData' in place and run the correlator
+// and DSC decoder over them
+/////////////////////////////////////////////////////////////////////////////////
+void CFskDemod::DemodBlocks(int InLength, TYPECPX* pInData)
+{
 	//lowpass Filter +/-250Hz
 	m_Fir.ProcessFilter(InLength, pInData, pInData);
 //g_pTestBench->DisplayData(InLength, pInData, m_SampleRate, PROFILE_2);
-
-	for(int i=0; i<InLength; i++)
+	for(int pos=0; pos<InLength; pos+=FSK_BLOCK)
 	{
-		cxIn = pInData[i];	//make copy of complex I/Q input sample
-
-		//First Process MARK('1") signal path
-		//create -85Hz Mark correlator Osc samples using quadrature oscillator
-		Osc.re = m_MarkOsc1.re * m_MarkOscCos - m_MarkOsc1.im * m_MarkOscSin;
-		Osc.im = m_MarkOsc1.im * m_MarkOscCos + m_MarkOsc1.re * m_MarkOscSin;
-		OscGn = 1.95 - (m_MarkOsc1.re*m_MarkOsc1.re + m_MarkOsc1.im*m_MarkOsc1.im);
-		m_MarkOsc1.re = OscGn * Osc.re;		//keeps amplitude bounded
-		m_MarkOsc1.im = OscGn * Osc.im;
-		//
-		//Cpx multiply Input sample by Mark shift frequency(bring -85Hz to 0Hz)
-		cxtmp.re = ((cxIn.re * Osc.re) + (cxIn.im * Osc.im));
-		cxtmp.im = ((cxIn.im * Osc.re) - (cxIn.re * Osc.im));
-
-		//place shifted Mark I/Q sample in Circular Integrator Buffer
-		//that is one symbol time deep
-		m_MarkIntegrationBuf[m_MarkIntegratorIndex++] = cxtmp;
-		if(m_MarkIntegratorIndex >= INTEGRATOR_BUF_LEN)
-			m_MarkIntegratorIndex = 0;
-
-		//integrate over the last 'INTEGRATOR_BUF_LEN' samples
-		cxtmp.re = 0.0; cxtmp.im = 0.0;
-		for(int j=0; j<INTEGRATOR_BUF_LEN; j++)
+		int n = InLength - pos;
+		if(n > FSK_BLOCK)
+			n = FSK_BLOCK;
+		StartBlock(&m_Block, n);
+		int NumBits = Correlate(&m_Corr, &m_Block, n, &pInData[pos], m_Bits);
+		for(int i=0; i<NumBits; i++)
 		{
-			cxtmp.re += m_MarkIntegrationBuf[j].re;
-			cxtmp.im += m_MarkIntegrationBuf[j].im;
+			int Status = DecodeBit(&m_Dsc, m_Bits[i]);
+			if(FSK_MSG_NONE != Status)
+			{
+				ShowMsg(Status);
+				ResetBitSync(&m_Corr);
+			}
 		}
-		//calc correlation energy in Mark signal
-		Mpwr = sqrt(cxtmp.re*cxtmp.re + cxtmp.im*cxtmp.im);
-
-		//create average Mark energy with dual time constant agc for ATC
-		if(Mpwr>m_MarkAve)	//if magnitude is rising (use m_AttackAlpha time constant)
-			m_MarkAve = (1.0-m_AttackAlpha)*m_MarkAve + m_AttackAlpha*Mpwr;
-		else				//else magnitude is falling (use m_DecayAlpha time constant)
-			m_MarkAve = (1.0-m_DecayAlpha)*m_MarkAve + m_DecayAlpha*Mpwr;
-
-		//Now Process SPACE('0') signal path
-		//create +85Hz Space correlator Osc samples using quadrature oscillator
-		Osc.re = m_SpaceOsc1.re * m_SpaceOscCos - m_SpaceOsc1.im * m_SpaceOscSin;
-		Osc.im = m_SpaceOsc1.im * m_SpaceOscCos + m_SpaceOsc1.re * m_SpaceOscSin;
-		OscGn = 1.95 - (m_SpaceOsc1.re*m_SpaceOsc1.re + m_SpaceOsc1.im*m_SpaceOsc1.im);
-		m_SpaceOsc1.re = OscGn * Osc.re;		//keeps amplitude bounded
-		m_SpaceOsc1.im = OscGn * Osc.im;
-
-		//Cpx multiply Input sample by Space shift frequency(bring +85Hz to 0Hz)
-		cxtmp.re = ((cxIn.re * Osc.re) + (cxIn.im * Osc.im));
-		cxtmp.im = ((cxIn.im * Osc.re) - (cxIn.re * Osc.im));
-
-		//place shifted Mark I/Q sample in Circular Integrator Buffer
-		//that is one symbol time deep
-		m_SpaceIntegrationBuf[m_SpaceIntegratorIndex++] = cxtmp;
-		if(m_SpaceIntegratorIndex>=INTEGRATOR_BUF_LEN)
-			m_SpaceIntegratorIndex = 0;
-
-		//integrate over the last 'INTEGRATOR_BUF_LEN' samples
-		cxtmp.re = 0.0; cxtmp.im = 0.0;
-		for(int j=0; j<INTEGRATOR_BUF_LEN; j++)
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//	Send a finished DSC message to the text window
+/////////////////////////////////////////////////////////////////////////////////
+void CFskDemod::ShowMsg(int Status)
+{
+char Buf[FSK_MAX_MSG*4+32];
+	FormatMsg(&m_Dsc, Status, Buf);
+	QString Str(Buf);
+	g_pTestBench->SendDebugTxt(Str);
+qDebug()<<"Got Msg ecc = "<<m_Dsc.Ecc << Str;
+	emit g_pChatDialog->SendChatStr(Str);
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//	Format a finished DSC message as text.
+// pStr must have room for FSK_MAX_MSG*4+32 characters
+/////////////////////////////////////////////////////////////////////////////////
+void CFskDemod::FormatMsg(const tDSC_DECODE* pDsc, int Status, char* pStr)
+{
+	if(FSK_MSG_VALID == Status)
+	{
+		pStr += sprintf(pStr, "*** Valid Msg ");
+		for(int i=1; i<=pDsc->RxBufIndex; i++)
+			pStr += sprintf(pStr, "% d", pDsc->RxBuf[i]);
+	}
+	else
+	{
+		int cnt = 0; //count up all error characters
+		for(int i=1; i<=pDsc->RxBufIndex; i++)
 		{
-			cxtmp.re += m_SpaceIntegrationBuf[j].re;
-			cxtmp.im += m_SpaceIntegrationBuf[j].im;
+			if(255 == pDsc->RxBuf[i])
+				cnt++;
 		}
-		//calc correlation energy in Space signal
-		Spwr = sqrt(cxtmp.re*cxtmp.re + cxtmp.im*cxtmp.im);
+		sprintf(pStr, "??? Got Bad Msg  Cnt=%d", cnt);
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//	Setup a correlator for a signal centered at Freq Hz
+/////////////////////////////////////////////////////////////////////////////////
+void CFskDemod::InitCorrelator(tFSK_CORR* pCorr, TYPEREAL SampleRate, TYPEREAL Freq)
+{
+	pCorr->SampleRate = SampleRate;
+	for(int k=0; k<4; k++)
+	{	//lane k starts k samples ahead
+		pCorr->Osc[k].re = MCOS(K_2PI*Freq*k/SampleRate);
+		pCorr->Osc[k].im = MSIN(K_2PI*Freq*k/SampleRate);
+	}
+	pCorr->Step4.re = MCOS(K_2PI*Freq*4.0/SampleRate);
+	pCorr->Step4.im = MSIN(K_2PI*Freq*4.0/SampleRate);
+
+	//integrate over one symbol time
+	pCorr->IntLen = (int)(SampleRate/FSK_SYMB_RATE + 0.5);
+	if(pCorr->IntLen > FSK_MAX_INTEGRATOR)
+		pCorr->IntLen = FSK_MAX_INTEGRATOR;
+	if(pCorr->IntLen < 1)
+		pCorr->IntLen = 1;
+	pCorr->IntPos = 0;
+	pCorr->MarkSum.re = 0.0;
+	pCorr->MarkSum.im = 0.0;
+	pCorr->SpaceSum = pCorr->MarkSum;
+	for(int i=0; i<pCorr->IntLen; i++)
+	{
+		pCorr->MarkHist[i] = pCorr->MarkSum;
+		pCorr->SpaceHist[i] = pCorr->MarkSum;
+	}
 
-		//create average Space energy with dual time constant agc for ATC
-		if(Spwr>m_SpaceAve)	//if magnitude is rising (use m_AttackAlpha time constant)
-			m_SpaceAve = (1.0-m_AttackAlpha)*m_SpaceAve + m_AttackAlpha*Spwr;
-		else				//else magnitude is falling (use m_DecayAlpha time constant)
-			m_SpaceAve = (1.0-m_DecayAlpha)*m_SpaceAve + m_DecayAlpha*Spwr;
+	//calculate ATC dual time constant filter values.
+	pCorr->AttackAlpha = (1.0-exp(-1.0/(SampleRate*ATTACK_TIMECONST)) );
+	pCorr->DecayAlpha = (1.0-exp(-1.0/(SampleRate*DECAY_TIMECONST)) );
+	pCorr->MarkAve = 0.0;
+	pCorr->SpaceAve = 0.0;
 
-		//calculate mark-space difference and shift by ATC threshold value
-		//
-		m_Outbuf[i] = (Mpwr - Spwr + m_SpaceAve/2.0 - m_MarkAve/2.0);
+	//Init Post data IIR LP filter
+	pCorr->OutIir.InitLP(150.0, 0.707, SampleRate);
+	ResetBitSync(pCorr);
+	pCorr->LastSync = 0.0;
+	pCorr->LastSyncSlope = 0.0;
+	pCorr->LastData = 0.0;
+}
 
-		//perform post filter 1 sample at a time in this loop(should be done before ATC?)
-		m_OutIir.ProcessFilter(1, &m_Outbuf[i], &m_Outbuf[i]);
+/////////////////////////////////////////////////////////////////////////////////
+//	create/Reset Hi-Q resonator at the bit rate to recover bit sync position Q==200
+/////////////////////////////////////////////////////////////////////////////////
+void CFskDemod::ResetBitSync(tFSK_CORR* pCorr)
+{
+	pCorr->BitSyncFilter.InitBP(FSK_SYMB_RATE, 200.0, pCorr->SampleRate);
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//	Setup the shift oscillator shared by all correlators run on a block
+/////////////////////////////////////////////////////////////////////////////////
+void CFskDemod::InitBlock(tFSK_BLOCK* pBlock, TYPEREAL SampleRate)
+{
+	pBlock->ShiftOsc.re = 1.0;
+	pBlock->ShiftOsc.im = 0.0;
+	pBlock->ShiftStep.re = MCOS(K_2PI*FSK_SHIFT_FREQ/(2.0*SampleRate));	// FreqShift/2
+	pBlock->ShiftStep.im = MSIN(K_2PI*FSK_SHIFT_FREQ/(2.0*SampleRate));
+}
 
-		//create absolute value version of output to use in bit sync algorithm
-		m_SyncSignal[i] = fabs(m_Outbuf[i]);
+/////////////////////////////////////////////////////////////////////////////////
+//	Create the +FreqShift/2 oscillator samples for the next block.
+// Mark is brought to 0Hz by multiplying with it and space with its conjugate.
+/////////////////////////////////////////////////////////////////////////////////
+void CFskDemod::StartBlock(tFSK_BLOCK* pBlock, int Length)
+{
+TYPECPX Osc = pBlock->ShiftOsc;
+	for(int i=0; i<Length; i++)
+	{
+		pBlock->ShiftRe[i] = Osc.re;
+		pBlock->ShiftIm[i] = Osc.im;
+		TYPEREAL tmp = Osc.re*pBlock->ShiftStep.re - Osc.im*pBlock->ShiftStep.im;
+		Osc.im = Osc.re*pBlock->ShiftStep.im + Osc.im*pBlock->ShiftStep.re;
+		Osc.re = tmp;
 	}
+	TYPEREAL OscGn = 1.5 - 0.5*(Osc.re*Osc.re + Osc.im*Osc.im);	//keeps amplitude bounded
+	pBlock->ShiftOsc.re = OscGn*Osc.re;
+	pBlock->ShiftOsc.im = OscGn*Osc.im;
+}
 
-	//now Create Bit sync signal with High Q Resonator IIR BP Filter
-	//using squared magnitude of data.  Positive peak of this signal
-	//correspondes to the maximum bit energy position so good place to sample
-	m_BitSyncFilter.ProcessFilter(InLength, m_SyncSignal, m_SyncSignal);
-	for(int i=0; i<InLength; i++)
+/////////////////////////////////////////////////////////////////////////////////
+//	Mark/space correlator, ATC and bit sync for one signal.
+// Each step is a separate loop over the block so the mixing and magnitude
+// loops have no carried dependencies. The one symbol integrators are
+// running sums that are recomputed every time they wrap so rounding
+// errors cannot build up.
+/////////////////////////////////////////////////////////////////////////////////
+int CFskDemod::Correlate(tFSK_CORR* pCorr, tFSK_BLOCK* pBlock, int Length,
+						 const TYPECPX* pInData, quint8* pBits)
+{
+TYPECPX Osc[4];
+int i;
+	//bring signal center to 0Hz using 4 independent phasors
+	for(int k=0; k<4; k++)
+		Osc[k] = pCorr->Osc[k];
+	TYPECPX Step = pCorr->Step4;
+	int n4 = Length & ~3;
+	for(i=0; i<n4; i+=4)
 	{
-		//the best bit sync position is at the positive peak of the m_SyncSignal waveform
-		TYPEREAL CurrentSlope = m_SyncSignal[i] - m_LastSync;	//current slope
-		//see if at the top peak of the sync waveform(slope changes from pos to neg)
-		if( (CurrentSlope < 0.0) && (m_LastSyncSlope >= 0.0) )
-		{	//are at sample time so use previous bit time value since we are one sample behind in sync position
-			ProcessNewDataBit( (m_LastData>0) );	//go process new DSC bit
+		for(int k=0; k<4; k++)
+		{
+			pBlock->MixRe[i+k] = pInData[i+k].re*Osc[k].re + pInData[i+k].im*Osc[k].im;
+			pBlock->MixIm[i+k] = pInData[i+k].im*Osc[k].re - pInData[i+k].re*Osc[k].im;
+			TYPEREAL tmp = Osc[k].re*Step.re - Osc[k].im*Step.im;
+			Osc[k].im = Osc[k].re*Step.im + Osc[k].im*Step.re;
+			Osc[k].re = tmp;
 		}
+	}
+	for(int k=0; i<Length; i++, k++)
+	{	//leftover samples use the first lanes
+		pBlock->MixRe[i] = pInData[i].re*Osc[k].re + pInData[i].im*Osc[k].im;
+		pBlock->MixIm[i] = pInData[i].im*Osc[k].re - pInData[i].re*Osc[k].im;
+		TYPEREAL tmp = Osc[k].re*Step.re - Osc[k].im*Step.im;
+		Osc[k].im = Osc[k].re*Step.im + Osc[k].im*Step.re;
+		Osc[k].re = tmp;
+	}
+	//rotate the lanes so lane 0 is the next sample
+	for(int k=0; k<4; k++)
+	{
+		TYPECPX o = Osc[(k + Length)&3];
+		TYPEREAL OscGn = 1.5 - 0.5*(o.re*o.re + o.im*o.im);	//keeps amplitude bounded
+		pCorr->Osc[k].re = OscGn*o.re;
+		pCorr->Osc[k].im = OscGn*o.im;
+	}
 
-		m_LastSync = m_SyncSignal[i];		//save previous states
-		m_LastSyncSlope = CurrentSlope;
-		m_LastData = m_Outbuf[i];
+	//shift mark and space to 0Hz and integrate over the last symbol
+	TYPECPX* pMarkHist = pCorr->MarkHist;
+	TYPECPX* pSpaceHist = pCorr->SpaceHist;
+	TYPECPX MarkSum = pCorr->MarkSum;
+	TYPECPX SpaceSum = pCorr->SpaceSum;
+	int pos = pCorr->IntPos;
+	for(i=0; i<Length; i++)
+	{
+		TYPEREAL a = pBlock->MixRe[i]*pBlock->ShiftRe[i];
+		TYPEREAL b = pBlock->MixIm[i]*pBlock->ShiftIm[i];
+		TYPEREAL c = pBlock->MixRe[i]*pBlock->ShiftIm[i];
+		TYPEREAL d = pBlock->MixIm[i]*pBlock->ShiftRe[i];
+		TYPECPX m = {a - b, c + d};
+		TYPECPX s = {a + b, d - c};
+		MarkSum.re += m.re - pMarkHist[pos].re;
+		MarkSum.im += m.im - pMarkHist[pos].im;
+		SpaceSum.re += s.re - pSpaceHist[pos].re;
+		SpaceSum.im += s.im - pSpaceHist[pos].im;
+		pMarkHist[pos] = m;
+		pSpaceHist[pos] = s;
+		if(++pos >= pCorr->IntLen)
+		{
+			pos = 0;
+			MarkSum.re = 0.0; MarkSum.im = 0.0;
+			SpaceSum = MarkSum;
+			for(int j=0; j<pCorr->IntLen; j++)
+			{
+				MarkSum.re += pMarkHist[j].re;
+				MarkSum.im += pMarkHist[j].im;
+				SpaceSum.re += pSpaceHist[j].re;
+				SpaceSum.im += pSpaceHist[j].im;
+			}
+		}
+		pBlock->Mark[i] = MarkSum.re*MarkSum.re + MarkSum.im*MarkSum.im;
+		pBlock->Space[i] = SpaceSum.re*SpaceSum.re + SpaceSum.im*SpaceSum.im;
+	}
+	pCorr->MarkSum = MarkSum;
+	pCorr->SpaceSum = SpaceSum;
+	pCorr->IntPos = pos;
+	//calc correlation energy in Mark and Space signals
+	for(i=0; i<Length; i++)
+	{
+		pBlock->Mark[i] = MSQRT(pBlock->Mark[i]);
+		pBlock->Space[i] = MSQRT(pBlock->Space[i]);
+	}
 
+	//create average Mark and Space energy with dual time constant agc for ATC
+	//then calculate mark-space difference and shift by ATC threshold value
+	TYPEREAL MarkAve = pCorr->MarkAve;
+	TYPEREAL SpaceAve = pCorr->SpaceAve;
+	for(i=0; i<Length; i++)
+	{
+		TYPEREAL Mpwr = pBlock->Mark[i];
+		TYPEREAL Spwr = pBlock->Space[i];
+		MarkAve += ((Mpwr > MarkAve) ? pCorr->AttackAlpha : pCorr->DecayAlpha)*(Mpwr - MarkAve);
+		SpaceAve += ((Spwr > SpaceAve) ? pCorr->AttackAlpha : pCorr->DecayAlpha)*(Spwr - SpaceAve);
+		pBlock->Data[i] = Mpwr - Spwr + SpaceAve/2.0 - MarkAve/2.0;
 	}
-//g_pTestBench->DisplayData(InLength, pOutData, m_SampleRate, PROFILE_3);
+	pCorr->MarkAve = MarkAve;
+	pCorr->SpaceAve = SpaceAve;
 
+	//perform post filter
+	pCorr->OutIir.ProcessFilter(Length, pBlock->Data, pBlock->Data);
 
-	for(int i=0; i<InLength; i++)
+	//now Create Bit sync signal with High Q Resonator IIR BP Filter
+	//using absolute value of data.  Positive peak of this signal
+	//correspondes to the maximum bit energy position so good place to sample
+	for(i=0; i<Length; i++)
+		pBlock->Sync[i] = MFABS(pBlock->Data[i]);
+	pCorr->BitSyncFilter.ProcessFilter(Length, pBlock->Sync, pBlock->Sync);
+	int NumBits = 0;
+	for(i=0; i<Length; i++)
 	{
-		pOutData[i] = pInData[i].re;
+		//the best bit sync position is at the positive peak of the Sync waveform
+		TYPEREAL CurrentSlope = pBlock->Sync[i] - pCorr->LastSync;	//current slope
+		//see if at the top peak of the sync waveform(slope changes from pos to neg)
+		if( (CurrentSlope < 0.0) && (pCorr->LastSyncSlope >= 0.0) )
+		{	//are at sample time so use previous bit time value since we are one sample behind in sync position
+			pBits[NumBits++] = (pCorr->LastData > 0) ? 1 : 0;
+		}
+		pCorr->LastSync = pBlock->Sync[i];		//save previous states
+		pCorr->LastSyncSlope = CurrentSlope;
+		pCorr->LastData = pBlock->Data[i];
 	}
-
-	return InLength;
+	return NumBits;
 }
 
+/////////////////////////////////////////////////////////////////////////////////
+//	Reset DSC decoder to look for a new phasing sequence
+/////////////////////////////////////////////////////////////////////////////////
+void CFskDemod::InitDecoder(tDSC_DECODE* pDsc)
+{
+	for(int i=0; i<16; i++)
+		pDsc->ShiftReg[i] = 0;
+	pDsc->DecodeState = STATE_PHASEDET;
+	pDsc->BitPos = 0;
+	pDsc->DecodeTimer = 0;
+	pDsc->Ecc = 0;
+	pDsc->DxBufIndex = 0;
+	pDsc->RxBufIndex = 0;
+}
 
 /////////////////////////////////////////////////////////////////////////////////
 //	DSC state decoder to find bit phase position and get raw characters.
 /////////////////////////////////////////////////////////////////////////////////
-void CFskDemod::ProcessNewDataBit(bool Bit)
+int CFskDemod::DecodeBit(tDSC_DECODE* pDsc, bool Bit)
 {
 quint8 ch;
 int i;
 int dxphzcnt = 0;
 int rxphzcnt = 0;
+int Status = FSK_MSG_NONE;
+quint16* pShiftReg = pDsc->ShiftReg;
 	//shift in new data bit into 160 bit shift register consisting of 16 ten bit shift registers
 	for(i=0; i<16; i++)
 	{
-		m_ShiftReg[i] >>= 1;
+		pShiftReg[i] >>= 1;
 		if(i<15)
 		{
-			if(m_ShiftReg[i+1] & 1)	//shift in bit from upper register
-				m_ShiftReg[i] |= 0x0200;
+			if(pShiftReg[i+1] & 1)	//shift in bit from upper register
+				pShiftReg[i] |= 0x0200;
 		}
 		else
 		{
 			if(Bit)
-				m_ShiftReg[15] |= 0x0200;
+				pShiftReg[15] |= 0x0200;
 		}
 	}
 	// go through all Rx Phase positions and count matches to Rx phase characters
 	//this will detect a phase sequence even if already decoding a msg.
-	if(111 == CHARTBL[ m_ShiftReg[1] ]) rxphzcnt++;
-	if(110 == CHARTBL[ m_ShiftReg[3] ]) rxphzcnt++;
-	if(109 == CHARTBL[ m_ShiftReg[5] ]) rxphzcnt++;
-	if(108 == CHARTBL[ m_ShiftReg[7] ]) rxphzcnt++;
-	if(107 == CHARTBL[ m_ShiftReg[9] ]) rxphzcnt++;
-	if(106 == CHARTBL[ m_ShiftReg[11] ]) rxphzcnt++;
-	if(105 == CHARTBL[ m_ShiftReg[13] ]) rxphzcnt++;
-	if(104 == CHARTBL[ m_ShiftReg[15] ]) rxphzcnt++;
-
-	if(125 == CHARTBL[ m_ShiftReg[0] ]) dxphzcnt++;
-	if(125 == CHARTBL[ m_ShiftReg[2] ]) dxphzcnt++;
-	if(125 == CHARTBL[ m_ShiftReg[4] ]) dxphzcnt++;
-	if(125 == CHARTBL[ m_ShiftReg[6] ]) dxphzcnt++;
-	if(125 == CHARTBL[ m_ShiftReg[8] ]) dxphzcnt++;
-	if(125 == CHARTBL[ m_ShiftReg[10] ]) dxphzcnt++;
+	if(111 == CHARTBL[ pShiftReg[1] ]) rxphzcnt++;
+	if(110 == CHARTBL[ pShiftReg[3] ]) rxphzcnt++;
+	if(109 == CHARTBL[ pShiftReg[5] ]) rxphzcnt++;
+	if(108 == CHARTBL[ pShiftReg[7] ]) rxphzcnt++;
+	if(107 == CHARTBL[ pShiftReg[9] ]) rxphzcnt++;
+	if(106 == CHARTBL[ pShiftReg[11] ]) rxphzcnt++;
+	if(105 == CHARTBL[ pShiftReg[13] ]) rxphzcnt++;
+	if(104 == CHARTBL[ pShiftReg[15] ]) rxphzcnt++;
+
+	if(125 == CHARTBL[ pShiftReg[0] ]) dxphzcnt++;
+	if(125 == CHARTBL[ pShiftReg[2] ]) dxphzcnt++;
+	if(125 == CHARTBL[ pShiftReg[4] ]) dxphzcnt++;
+	if(125 == CHARTBL[ pShiftReg[6] ]) dxphzcnt++;
+	if(125 == CHARTBL[ pShiftReg[8] ]) dxphzcnt++;
+	if(125 == CHARTBL[ pShiftReg[10] ]) dxphzcnt++;
 
 	if( (rxphzcnt>=3) || ((rxphzcnt==2)&&(dxphzcnt>=1)) || ((rxphzcnt==1)&&(dxphzcnt>=2)))
 	{
 //qDebug()<<"Got Phase Sequence pattern";
-		m_DxBufIndex = 0;
-		m_RxBufIndex = 0;
-		m_DxBuf[m_DxBufIndex++] = CHARTBL[ m_ShiftReg[12] ];	//read in first A Dx field
-		m_DxBuf[m_DxBufIndex++] = CHARTBL[ m_ShiftReg[14] ];	//read in second A Dx field
-		m_RxDecodeState = STATE_DECODEDX;
-		m_RxBitPos = -10;	//set sync bit position so shifts in next full symbol before executing decode state machine
-		m_Ecc = 0;
-		m_RxDecodeTimer = MSG_TIMEOUT;
+		pDsc->DxBufIndex = 0;
+		pDsc->RxBufIndex = 0;
+		pDsc->DxBuf[pDsc->DxBufIndex++] = CHARTBL[ pShiftReg[12] ];	//read in first A Dx field
+		pDsc->DxBuf[pDsc->DxBufIndex++] = CHARTBL[ pShiftReg[14] ];	//read in second A Dx field
+		pDsc->DecodeState = STATE_DECODEDX;
+		pDsc->BitPos = -10;	//set sync bit position so shifts in next full symbol before executing decode state machine
+		pDsc->Ecc = 0;
+		pDsc->DecodeTimer = MSG_TIMEOUT;
 	}
-	if(0==m_RxBitPos)
+	if(0==pDsc->BitPos)
 	{
-		if(m_RxDecodeTimer > 0)		//dec msg timeout
+		if(pDsc->DecodeTimer > 0)		//dec msg timeout
 		{
-			m_RxDecodeTimer--;
+			pDsc->DecodeTimer--;
 		}
 		else
 		{
-			m_RxDecodeState = STATE_PHASEDET;
+			pDsc->DecodeState = STATE_PHASEDET;
 		}
-		switch(	m_RxDecodeState)
+		switch(	pDsc->DecodeState)
 		{
 			case STATE_PHASEDET:	//looking for initial phazing position so do nothing
 				break;
 			case STATE_DECODEDX:	//here to store next Dx character into
-				ch = CHARTBL[ m_ShiftReg[15] ];
-				m_DxBuf[m_DxBufIndex++] = ch;
-				if(m_DxBufIndex>2)	//only need to save last 3 Dx characters
-					m_DxBufIndex = 0;
-				m_RxDecodeState = STATE_DECODERX;
+				ch = CHARTBL[ pShiftReg[15] ];
+				pDsc->DxBuf[pDsc->DxBufIndex++] = ch;
+				if(pDsc->DxBufIndex>2)	//only need to save last 3 Dx characters
+					pDsc->DxBufIndex = 0;
+				pDsc->DecodeState = STATE_DECODERX;
 				break;
 			case STATE_DECODERX:
-				ch = CHARTBL[ m_ShiftReg[15] ];
+				ch = CHARTBL[ pShiftReg[15] ];
 				if(ch!=255)	//if Rx char is ok use it
-					m_RxBuf[m_RxBufIndex] = ch;
+					pDsc->RxBuf[pDsc->RxBufIndex] = ch;
 				else	//else use Dx char
-					m_RxBuf[m_RxBufIndex] = m_DxBuf[m_DxBufIndex];
+					pDsc->RxBuf[pDsc->RxBufIndex] = pDsc->DxBuf[pDsc->DxBufIndex];
 
-				if(1==m_RxBufIndex)	//if second 'A' position is error then use first char 'A'
+				if(1==pDsc->RxBufIndex)	//if second 'A' position is error then use first char 'A'
 				{
-					if(255 == m_RxBuf[1] )
-						m_RxBuf[1] = m_RxBuf[0];
-					m_Ecc = m_RxBuf[1];		//init ecc value
+					if(255 == pDsc->RxBuf[1] )
+						pDsc->RxBuf[1] = pDsc->RxBuf[0];
+					pDsc->Ecc = pDsc->RxBuf[1];		//init ecc value
 				}
 				else
-					m_Ecc ^= m_RxBuf[m_RxBufIndex];
-				if( (117==m_RxBuf[m_RxBufIndex]) || (122==m_RxBuf[m_RxBufIndex]) || (127==m_RxBuf[m_RxBufIndex]) )
+					pDsc->Ecc ^= pDsc->RxBuf[pDsc->RxBufIndex];
+				if( (117==pDsc->RxBuf[pDsc->RxBufIndex]) || (122==pDsc->RxBuf[pDsc->RxBufIndex]) ||
+						(127==pDsc->RxBuf[pDsc->RxBufIndex]) )
 				{
-					m_RxDecodeState = STATE_ECCDX;
+					pDsc->DecodeState = STATE_ECCDX;
 				}
 				else
 				{
-					m_RxDecodeState = STATE_DECODEDX;
+					pDsc->DecodeState = STATE_DECODEDX;
 				}
-				m_RxBufIndex++;
+				if(++pDsc->RxBufIndex >= FSK_MAX_MSG-1)
+					pDsc->DecodeState = STATE_PHASEDET;		//too long so give up
 				break;
 			case STATE_ECCDX:	//here to store next Dx character
-				ch = CHARTBL[ m_ShiftReg[15] ];
-				m_DxBuf[m_DxBufIndex++] = ch;
-				if(m_DxBufIndex>2)	//only need to save last 3 Dx characters
-					m_DxBufIndex = 0;
-				m_RxDecodeState = STATE_ECCRX;
+				ch = CHARTBL[ pShiftReg[15] ];
+				pDsc->DxBuf[pDsc->DxBufIndex++] = ch;
+				if(pDsc->DxBufIndex>2)	//only need to save last 3 Dx characters
+					pDsc->DxBufIndex = 0;
+				pDsc->DecodeState = STATE_ECCRX;
 				break;
 			case STATE_ECCRX:
-				ch = CHARTBL[ m_ShiftReg[15] ];
+				ch = CHARTBL[ pShiftReg[15] ];
 				if(ch!=255)	//if ECC char is ok use it
-					m_RxBuf[m_RxBufIndex] = ch;
+					pDsc->RxBuf[pDsc->RxBufIndex] = ch;
 				else	//else use Dx ECC
-					m_RxBuf[m_RxBufIndex] = m_DxBuf[m_DxBufIndex];
-				if(m_Ecc == m_RxBuf[m_RxBufIndex])
-				{	//here if EEC correct MSG received in m_RxBuf[]
-					m_Str1.sprintf("*** Valid Msg ");
-					for(i=1; i<=m_RxBufIndex; i++)
-					{
-						m_Str1 += m_Str2.sprintf("% d",m_RxBuf[i]);
-					}
-g_pTestBench->SendDebugTxt(m_Str1);
-qDebug()<<"Got Valid Msg ecc = "<<m_Ecc << m_Str1;
-				emit g_pChatDialog->SendChatStr(m_Str1);
-				}
+					pDsc->RxBuf[pDsc->RxBufIndex] = pDsc->DxBuf[pDsc->DxBufIndex];
+				if(pDsc->Ecc == pDsc->RxBuf[pDsc->RxBufIndex])
+					Status = FSK_MSG_VALID;		//here if EEC correct MSG received in RxBuf[]
 				else
-				{
-					rxphzcnt = 0; //use to count up all error characters
-					for(i=1; i<=m_RxBufIndex; i++)
-					{
-						if(255==m_RxBuf[i])
-							rxphzcnt++;
-					}
-					m_Str1.sprintf("??? Got Bad Msg  Cnt=%d",rxphzcnt);
-qDebug()<<"Got BAD Msg ecc = "<<m_Ecc;
-					emit g_pChatDialog->SendChatStr(m_Str1);
-					g_pTestBench->SendDebugTxt(m_Str1);
-				}
-				m_RxDecodeState = STATE_PHASEDET;
-				//create/Reset Hi-Q resonator at the bit rate to recover bit sync position Q==200
-				m_BitSyncFilter.InitBP(100.0, 200.0, m_SampleRate);
+					Status = FSK_MSG_BAD;
+				pDsc->DecodeState = STATE_PHASEDET;
 				break;
 		}
 	}
 
 	//inc current Bit position modulo 10
-	if(	++m_RxBitPos >= 10)
-		m_RxBitPos = 0;
-
+	if(	++pDsc->BitPos >= 10)
+		pDsc->BitPos = 0;
+	return Status;
 }
@@ -1,9 +1,15 @@
 //////////////////////////////////////////////////////////////////////
 // fskdemod.h: interface for the CFskDemod class.
 //
+//  The correlator and DSC decoder state live in plain structs and are
+// run by static kernels so one thread can decode many FSK signals at
+// different offsets in the same block of samples.
+//
 // History:
 //	2010-09-22  Initial creation MSW
 //	2011-03-27  Initial release
+//	2026-10-18  Split into state structs and block correlator kernel
+//	2026-10-18  Added Init() so one instance can be reused
 /////////////////////////////////////////////////////////////////////
 #ifndef FSKDEMOD_H
 #define FSKDEMOD_H
@@ -12,62 +18,109 @@
 #include "dsp/iir.h"
 #include <QString>
 
-#define INTEGRATOR_BUF_LEN 125
+#define FSK_SHIFT_FREQ 170.0	//mark to space spacing in Hz
+#define FSK_SYMB_RATE 100.0		//DSC bit rate
+#define FSK_MAX_INTEGRATOR 256	//longest symbol integrator(25.6KHz sample rate)
+#define FSK_BLOCK 256			//most samples run through the correlator kernel per call
+#define FSK_MAX_MSG 64			//longest DSC message in characters
+
+//DSC message status returned by DecodeBit()
+#define FSK_MSG_NONE 0
+#define FSK_MSG_VALID 1
+#define FSK_MSG_BAD 2
+
+//correlator state for one FSK signal
+typedef struct _fskcorr
+{
+	TYPECPX Osc[4];			//4 interleaved NCO phasors that bring the signal center to 0Hz
+	TYPECPX Step4;			//NCO phase advance for 4 samples
+	int IntLen;				//symbol integrator length in samples
+	int IntPos;
+	TYPECPX MarkSum;		//running sums of the last IntLen correlator samples
+	TYPECPX SpaceSum;
+	TYPECPX MarkHist[FSK_MAX_INTEGRATOR];
+	TYPECPX SpaceHist[FSK_MAX_INTEGRATOR];
+	TYPEREAL MarkAve;		//ATC dual time constant averages
+	TYPEREAL SpaceAve;
+	TYPEREAL AttackAlpha;
+	TYPEREAL DecayAlpha;
+	TYPEREAL SampleRate;
+	TYPEREAL LastSync;		//bit sync peak detector
+	TYPEREAL LastSyncSlope;
+	TYPEREAL LastData;
+	CIir OutIir;			//post detection low pass filter
+	CIir BitSyncFilter;		//Hi-Q resonator at the bit rate
+}tFSK_CORR;
+
+//DSC character decoder state
+typedef struct _dscdecode
+{
+	quint16 ShiftReg[16];	//16 ten bit shift registers
+	quint32 DecodeState;
+	qint32 BitPos;
+	qint32 DecodeTimer;
+	quint8 Ecc;
+	quint8 DxBuf[3];
+	quint8 RxBuf[FSK_MAX_MSG];
+	int DxBufIndex;
+	int RxBufIndex;
+}tDSC_DECODE;
+
+//data shared by every correlator run over the same block of samples
+typedef struct _fskblock
+{
+	TYPECPX ShiftOsc;		//+FSK_SHIFT_FREQ/2 phasor carried between blocks
+	TYPECPX ShiftStep;
+	TYPEREAL ShiftRe[FSK_BLOCK];	//+FSK_SHIFT_FREQ/2 oscillator for this block
+	TYPEREAL ShiftIm[FSK_BLOCK];
+	//scratch used by one Correlate() call at a time
+	TYPEREAL MixRe[FSK_BLOCK];
+	TYPEREAL MixIm[FSK_BLOCK];
+	TYPEREAL Mark[FSK_BLOCK];
+	TYPEREAL Space[FSK_BLOCK];
+	TYPEREAL Data[FSK_BLOCK];
+	TYPEREAL Sync[FSK_BLOCK];
+}tFSK_BLOCK;
 
 class CFskDemod
 {
 public:
 	CFskDemod(TYPEREAL samplerate);
+	void Init(TYPEREAL samplerate);		//clears the state for a new sample rate
 	//overloaded functions for mono and stereo
 	int ProcessData(int InLength, TYPECPX* pInData, TYPECPX* pOutData);
 	int ProcessData(int InLength, TYPECPX* pInData, TYPEREAL* pOutData);
+
+	//stateless kernels
+	static void InitCorrelator(tFSK_CORR* pCorr, TYPEREAL SampleRate, TYPEREAL Freq);
+	static void ResetBitSync(tFSK_CORR* pCorr);
+	static void InitBlock(tFSK_BLOCK* pBlock, TYPEREAL SampleRate);
+	//fills the shared shift oscillator for the next Length(<=FSK_BLOCK) samples
+	static void StartBlock(tFSK_BLOCK* pBlock, int Length);
+	//correlates Length samples, pBits gets one 0/1 entry per recovered bit.
+	// Returns the number of bits.
+	static int Correlate(tFSK_CORR* pCorr, tFSK_BLOCK* pBlock, int Length,
+						 const TYPECPX* pInData, quint8* pBits);
+	static void InitDecoder(tDSC_DECODE* pDsc);
+	//returns FSK_MSG_VALID or FSK_MSG_BAD when a message ends with
+	// the message in RxBuf[1] to RxBuf[RxBufIndex]
+	static int DecodeBit(tDSC_DECODE* pDsc, bool Bit);
+	//pStr must have room for FSK_MAX_MSG*4+32 characters
+	static void FormatMsg(const tDSC_DECODE* pDsc, int Status, char* pStr);
+
 private:
-	void ProcessNewDataBit(bool Bit);
+	void DemodBlocks(int InLength, TYPECPX* pInData);
+	void ShowMsg(int Status);
 
 	TYPEREAL m_SampleRate;
-	TYPECPX m_MarkOsc1;
-	TYPEREAL m_MarkOscCos;
-	TYPEREAL m_MarkOscSin;
-	TYPECPX m_SpaceOsc1;
-	TYPEREAL m_SpaceOscCos;
-	TYPEREAL m_SpaceOscSin;
-
-	qint32 m_MarkIntegratorIndex;
-	qint32 m_SpaceIntegratorIndex;
-	TYPECPX m_MarkIntegrationBuf[INTEGRATOR_BUF_LEN];
-	TYPECPX m_SpaceIntegrationBuf[INTEGRATOR_BUF_LEN];
+	tFSK_CORR m_Corr;
+	tDSC_DECODE m_Dsc;
+	tFSK_BLOCK m_Block;
+	quint8 m_Bits[FSK_BLOCK];
 
 	CFir m_Fir;
-	CIir m_OutIir;
-	CIir m_BitSyncFilter;
-
-	TYPEREAL m_Outbuf[2048];
-	TYPEREAL m_SyncSignal[2048];
-	TYPEREAL m_LastSync;
-	TYPEREAL m_LastSyncSlope;
-	TYPEREAL m_LastData;
-
-	TYPEREAL m_MarkAve;
-	TYPEREAL m_SpaceAve;
-	TYPEREAL m_AttackAlpha;
-	TYPEREAL m_DecayAlpha;
-
-	quint16 m_RxShiftReg;
-	qint32 m_RxBitPos;
-	quint32 m_RxDecodeState;
-	qint32 m_RxDecodeTimer;
-
-	quint8 m_Ecc;
-	quint16 m_ShiftReg[16];		//used for 16 10 bit shift registers
-	quint8 m_DxBuf[3];
-	quint8 m_RxBuf[256];
-	int m_DxBufIndex;
-	int m_RxBufIndex;
-
 
 	//tst stuff
-	QString m_Str1;	//for debug
-	QString m_Str2;
 	TYPECPX m_AudioShiftOsc1;
 	TYPEREAL m_AudioShiftOscCos;
 	TYPEREAL m_AudioShiftOscSin;
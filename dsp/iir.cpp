@@ -40,6 +40,7 @@
 //	2011-02-05  Initial creation MSW
 //	2011-03-27  Initial release
 //	2013-07-28  Added single/double precision math macros
+//	2026-10-18  CIir is CIirT<TYPEREAL>, float and double versions are built
 //////////////////////////////////////////////////////////////////////
 
 //==========================================================================================
@@ -75,7 +76,8 @@
 /////////////////////////////////////////////////////////////////////////////////
 //	Construct CIir object
 /////////////////////////////////////////////////////////////////////////////////
-CIir::CIir()
+template <typename T>
+CIirT<T>::CIirT()
 {
 	InitBR( 25000, 1000.0, 100000);
 }
@@ -84,15 +86,16 @@ CIir::CIir()
 //	Iniitalize IIR variables for Low Pass IIR filter.
 // analog prototype == H(s) = 1 / (s^2 + s/Q + 1)
 /////////////////////////////////////////////////////////////////////////////////
-void CIir::InitLP( TYPEREAL F0Freq, TYPEREAL FilterQ, TYPEREAL SampleRate)
+template <typename T>
+void CIirT<T>::InitLP( T F0Freq, T FilterQ, T SampleRate)
 {
-	TYPEREAL w0 = K_2PI * F0Freq/SampleRate;	//normalized corner frequency
-	TYPEREAL alpha = MSIN(w0)/(2.0*FilterQ);
-	TYPEREAL A = 1.0/(1.0 + alpha);	//scale everything by 1/A0 for direct form 2
-	m_B0 = A*( (1.0 - MCOS(w0))/2.0);
-	m_B1 = A*( 1.0 - MCOS(w0));
-	m_B2 = A*( (1.0 - MCOS(w0))/2.0);
-	m_A1 = A*( -2.0*MCOS(w0));
+	T w0 = K_2PI * F0Freq/SampleRate;	//normalized corner frequency
+	T alpha = Prec::Sin(w0)/(2.0*FilterQ);
+	T A = 1.0/(1.0 + alpha);	//scale everything by 1/A0 for direct form 2
+	m_B0 = A*( (1.0 - Prec::Cos(w0))/2.0);
+	m_B1 = A*( 1.0 - Prec::Cos(w0));
+	m_B2 = A*( (1.0 - Prec::Cos(w0))/2.0);
+	m_A1 = A*( -2.0*Prec::Cos(w0));
 	m_A2 = A*( 1.0 - alpha);
 
 	m_w1a = 0.0;
@@ -106,15 +109,16 @@ void CIir::InitLP( TYPEREAL F0Freq, TYPEREAL FilterQ, TYPEREAL SampleRate)
 //	Iniitalize IIR variables for High Pass IIR filter.
 // analog prototype == H(s) = s^2 / (s^2 + s/Q + 1)
 /////////////////////////////////////////////////////////////////////////////////
-void CIir::InitHP( TYPEREAL F0Freq, TYPEREAL FilterQ, TYPEREAL SampleRate)
+template <typename T>
+void CIirT<T>::InitHP( T F0Freq, T FilterQ, T SampleRate)
 {
-	TYPEREAL w0 = K_2PI * F0Freq/SampleRate;	//normalized corner frequency
-	TYPEREAL alpha = MSIN(w0)/(2.0*FilterQ);
-	TYPEREAL A = 1.0/(1.0 + alpha);	//scale everything by 1/A0 for direct form 2
-	m_B0 = A*( (1.0 + MCOS(w0))/2.0);
-	m_B1 = -A*( 1.0 + MCOS(w0));
-	m_B2 = A*( (1.0 + MCOS(w0))/2.0);
-	m_A1 = A*( -2.0*MCOS(w0));
+	T w0 = K_2PI * F0Freq/SampleRate;	//normalized corner frequency
+	T alpha = Prec::Sin(w0)/(2.0*FilterQ);
+	T A = 1.0/(1.0 + alpha);	//scale everything by 1/A0 for direct form 2
+	m_B0 = A*( (1.0 + Prec::Cos(w0))/2.0);
+	m_B1 = -A*( 1.0 + Prec::Cos(w0));
+	m_B2 = A*( (1.0 + Prec::Cos(w0))/2.0);
+	m_A1 = A*( -2.0*Prec::Cos(w0));
 	m_A2 = A*( 1.0 - alpha);
 
 	m_w1a = 0.0;
@@ -127,15 +131,16 @@ void CIir::InitHP( TYPEREAL F0Freq, TYPEREAL FilterQ, TYPEREAL SampleRate)
 //	Iniitalize IIR variables for Band Pass IIR filter.
 // analog prototype == H(s) = (s/Q) / (s^2 + s/Q + 1)
 /////////////////////////////////////////////////////////////////////////////////
-void CIir::InitBP( TYPEREAL F0Freq, TYPEREAL FilterQ, TYPEREAL SampleRate)
+template <typename T>
+void CIirT<T>::InitBP( T F0Freq, T FilterQ, T SampleRate)
 {
-	TYPEREAL w0 = K_2PI * F0Freq/SampleRate;	//normalized corner frequency
-	TYPEREAL alpha = MSIN(w0)/(2.0*FilterQ);
-	TYPEREAL A = 1.0/(1.0 + alpha);	//scale everything by 1/A0 for direct form 2
+	T w0 = K_2PI * F0Freq/SampleRate;	//normalized corner frequency
+	T alpha = Prec::Sin(w0)/(2.0*FilterQ);
+	T A = 1.0/(1.0 + alpha);	//scale everything by 1/A0 for direct form 2
 	m_B0 = A * alpha;
 	m_B1 = 0.0;
 	m_B2 = A * -alpha;
-	m_A1 = A*( -2.0*MCOS(w0));
+	m_A1 = A*( -2.0*Prec::Cos(w0));
 	m_A2 = A*( 1.0 - alpha);
 
 	m_w1a = 0.0;
@@ -148,15 +153,16 @@ void CIir::InitBP( TYPEREAL F0Freq, TYPEREAL FilterQ, TYPEREAL SampleRate)
 //	Iniitalize IIR variables for Band Reject(Notch) IIR filter.
 // analog prototype == H(s) = (s^2 + 1) / (s^2 + s/Q + 1)
 /////////////////////////////////////////////////////////////////////////////////
-void CIir::InitBR( TYPEREAL F0Freq, TYPEREAL FilterQ, TYPEREAL SampleRate)
+template <typename T>
+void CIirT<T>::InitBR( T F0Freq, T FilterQ, T SampleRate)
 {
-	TYPEREAL w0 = K_2PI * F0Freq/SampleRate;	//normalized corner frequency
-	TYPEREAL alpha = MSIN(w0)/(2.0*FilterQ);
-	TYPEREAL A = 1.0/(1.0 + alpha);	//scale everything by 1/A0 for direct form 2
+	T w0 = K_2PI * F0Freq/SampleRate;	//normalized corner frequency
+	T alpha = Prec::Sin(w0)/(2.0*FilterQ);
+	T A = 1.0/(1.0 + alpha);	//scale everything by 1/A0 for direct form 2
 	m_B0 = A*1.0;
-	m_B1 = A*( -2.0*MCOS(w0));
+	m_B1 = A*( -2.0*Prec::Cos(w0));
 	m_B2 = A*1.0;
-	m_A1 = A*( -2.0*MCOS(w0));
+	m_A1 = A*( -2.0*Prec::Cos(w0));
 	m_A2 = A*( 1.0 - alpha);
 
 	m_w1a = 0.0;
@@ -169,11 +175,12 @@ void CIir::InitBR( TYPEREAL F0Freq, TYPEREAL FilterQ, TYPEREAL SampleRate)
 //	Process InLength InBuf[] samples and place in OutBuf[]
 //REAL version
 /////////////////////////////////////////////////////////////////////////////////
-void CIir::ProcessFilter(int InLength, TYPEREAL* InBuf, TYPEREAL* OutBuf)
+template <typename T>
+void CIirT<T>::ProcessFilter(int InLength, T* InBuf, T* OutBuf)
 {
 	for(int i=0; i<InLength; i++)
 	{
-		TYPEREAL w0 = InBuf[i] - m_A1*m_w1a - m_A2*m_w2a;
+		T w0 = InBuf[i] - m_A1*m_w1a - m_A2*m_w2a;
 		OutBuf[i] =m_B0*w0 + m_B1*m_w1a + m_B2*m_w2a;
 		m_w2a = m_w1a;
 		m_w1a = w0;
@@ -184,16 +191,17 @@ void CIir::ProcessFilter(int InLength, TYPEREAL* InBuf, TYPEREAL* OutBuf)
 //	Process InLength InBuf[] samples and place in OutBuf[]
 //Complex version
 /////////////////////////////////////////////////////////////////////////////////
-void CIir::ProcessFilter(int InLength, TYPECPX* InBuf, TYPECPX* OutBuf)
+template <typename T>
+void CIirT<T>::ProcessFilter(int InLength, Cpx* InBuf, Cpx* OutBuf)
 {
 	for(int i=0; i<InLength; i++)
 	{
-		TYPEREAL w0a = InBuf[i].re - m_A1*m_w1a - m_A2*m_w2a;
+		T w0a = InBuf[i].re - m_A1*m_w1a - m_A2*m_w2a;
 		OutBuf[i].re =m_B0*w0a + m_B1*m_w1a + m_B2*m_w2a;
 		m_w2a = m_w1a;
 		m_w1a = w0a;
 
-		TYPEREAL w0b = InBuf[i].im - m_A1*m_w1b - m_A2*m_w2b;
+		T w0b = InBuf[i].im - m_A1*m_w1b - m_A2*m_w2b;
 		OutBuf[i].im =m_B0*w0b + m_B1*m_w1b + m_B2*m_w2b;
 		m_w2b = m_w1b;
 		m_w1b = w0b;
@@ -201,4 +209,6 @@ void CIir::ProcessFilter(int InLength, TYPECPX* InBuf, TYPECPX* OutBuf)
 	}
 }
 
-
+//float and double versions of the IIR filter
+template class CIirT<tSReal>;
+template class CIirT<tDReal>;
@@ -6,6 +6,7 @@
 // History:
 //	2011-02-05  Initial creation MSW
 //	2011-03-27  Initial release
+//	2026-10-18  CIir is CIirT<TYPEREAL>, float and double versions are built
 //////////////////////////////////////////////////////////////////////
 //==========================================================================================
 // + + +   This Software is released under the "Simplified BSD License"  + + +
@@ -41,29 +42,36 @@
 #include "dsp/datatypes.h"
 
 
-class CIir
+//class for biquad IIR filters. T is the sample type, tSReal or tDReal.
+// CIir uses the build precision TYPEREAL.
+template <typename T>
+class CIirT
 {
 public:
-	CIir();
+	typedef typename tPrecision<T>::Cpx Cpx;
+	CIirT();
 
-	void InitLP( TYPEREAL F0Freq, TYPEREAL FilterQ, TYPEREAL SampleRate);	//create Low Pass
-	void InitHP( TYPEREAL F0Freq, TYPEREAL FilterQ, TYPEREAL SampleRate);	//create High Pass
-	void InitBP( TYPEREAL F0Freq, TYPEREAL FilterQ, TYPEREAL SampleRate);	//create Band Pass
-	void InitBR( TYPEREAL F0Freq, TYPEREAL FilterQ, TYPEREAL SampleRate);	//create Band Reject
-	void ProcessFilter(int InLength, TYPEREAL* InBuf, TYPEREAL* OutBuf);
-	void ProcessFilter(int InLength, TYPECPX* InBuf, TYPECPX* OutBuf);
+	void InitLP( T F0Freq, T FilterQ, T SampleRate);	//create Low Pass
+	void InitHP( T F0Freq, T FilterQ, T SampleRate);	//create High Pass
+	void InitBP( T F0Freq, T FilterQ, T SampleRate);	//create Band Pass
+	void InitBR( T F0Freq, T FilterQ, T SampleRate);	//create Band Reject
+	void ProcessFilter(int InLength, T* InBuf, T* OutBuf);
+	void ProcessFilter(int InLength, Cpx* InBuf, Cpx* OutBuf);
 
 private:
-	TYPEREAL m_A1;		//direct form 2 coefficients
-	TYPEREAL m_A2;
-	TYPEREAL m_B0;
-	TYPEREAL m_B1;
-	TYPEREAL m_B2;
+	typedef tPrecision<T> Prec;
+	T m_A1;		//direct form 2 coefficients
+	T m_A2;
+	T m_B0;
+	T m_B1;
+	T m_B2;
 
-	TYPEREAL m_w1a;		//biquad delay storage
-	TYPEREAL m_w2a;
-	TYPEREAL m_w1b;		//biquad delay storage
-	TYPEREAL m_w2b;
+	T m_w1a;		//biquad delay storage
+	T m_w2a;
+	T m_w1b;		//biquad delay storage
+	T m_w2b;
 };
 
+typedef CIirT<TYPEREAL> CIir;
+
 #endif // IIR_H
@@ -0,0 +1,226 @@
+/////////////////////////////////////////////////////////////////////
+// multifsk.cpp: implementation of the CFskPairDetect class.
+//
+//	The averaged spectrum is smoothed over +/-SymbRate/2 so each keyed
+// tone makes one peak. A pair's score is the weaker of the two tones
+// FSK_SHIFT_FREQ/2 either side of its center and must also stand out
+// from the spectrum just outside the pair so wideband signals and lone
+// carriers are not taken as FSK.
+// History:
+//	2026-10-18  Initial creation
+/////////////////////////////////////////////////////////////////////
+//==========================================================================================
+// + + +   This Software is released under the "Simplified BSD License"  + + +
+//Copyright 2010 Moe Wheatley. All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification, are
+//permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice, this list of
+//	  conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice, this list
+//	  of conditions and the following disclaimer in the documentation and/or other materials
+//	  provided with the distribution.
+//
+//THIS SOFTWARE IS PROVIDED BY Moe Wheatley ``AS IS'' AND ANY EXPRESS OR IMPLIED
+//WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+//FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Moe Wheatley OR
+//CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+//ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+//ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//The views and conclusions contained in the software and documentation are those of the
+//authors and should not be interpreted as representing official policies, either expressed
+//or implied, of Moe Wheatley.
+//==========================================================================================
+#include "dsp/multifsk.h"
+#include <algorithm>
+#include <QDebug>
+
+#define PAIR_CONTRAST 2.0	//tones must be this much stronger than the spectrum outside the pair
+
+/////////////////////////////////////////////////////////////////////////////////
+//	Construct pair detector object
+/////////////////////////////////////////////////////////////////////////////////
+CFskPairDetect::CFskPairDetect()
+{
+	m_SampleRate = 0.0;
+	m_InPos = 0;
+	m_NumAve = 0;
+	m_AveLimit = 1;
+	m_NumPairs = 0;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//	Setup the FFT for the passband sample rate and clear the averages
+/////////////////////////////////////////////////////////////////////////////////
+void CFskPairDetect::Init(TYPEREAL SampleRate)
+{
+	m_SampleRate = SampleRate;
+	m_Fft.SetFFTParams(MFSK_FFT_SIZE, false, 0.0, SampleRate);
+	for(int i=0; i<MFSK_FFT_SIZE; i++)
+	{	//Hann window
+		m_Window[i] = 0.5 - 0.5*MCOS( (K_2PI*i)/(MFSK_FFT_SIZE-1) );
+		m_PwrSum[i] = 0.0;
+	}
+	m_AveLimit = (int)(MFSK_DETECT_TIME*SampleRate/MFSK_FFT_SIZE + 0.5);
+	if(m_AveLimit < 1)
+		m_AveLimit = 1;
+	m_InPos = 0;
+	m_NumAve = 0;
+	m_NumPairs = 0;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//	Accumulate power spectra and search for pairs every MFSK_DETECT_TIME
+/////////////////////////////////////////////////////////////////////////////////
+bool CFskPairDetect::ProcessData(int InLength, const TYPECPX* pInData)
+{
+bool ready = false;
+	for(int i=0; i<InLength; i++)
+	{
+		m_FftBuf[m_InPos].re = pInData[i].re*m_Window[m_InPos];
+		m_FftBuf[m_InPos].im = pInData[i].im*m_Window[m_InPos];
+		if(++m_InPos < MFSK_FFT_SIZE)
+			continue;
+		m_InPos = 0;
+		m_Fft.FwdFFT(m_FftBuf);
+		//CFft puts positive frequency k in bin N-k so flip it here
+		for(int k=0; k<MFSK_FFT_SIZE; k++)
+		{
+			TYPECPX& x = m_FftBuf[(MFSK_FFT_SIZE - k) & (MFSK_FFT_SIZE-1)];
+			m_PwrSum[k] += x.re*x.re + x.im*x.im;
+		}
+		if(++m_NumAve >= m_AveLimit)
+		{
+			FindPairs();
+			for(int k=0; k<MFSK_FFT_SIZE; k++)
+				m_PwrSum[k] = 0.0;
+			m_NumAve = 0;
+			ready = true;
+		}
+	}
+	return ready;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//	Pick the tone pairs in the averaged spectrum that are well above the noise
+/////////////////////////////////////////////////////////////////////////////////
+void CFskPairDetect::FindPairs()
+{
+	TYPEREAL BinWidth = m_SampleRate/MFSK_FFT_SIZE;
+	int kmin = (int)(MFSK_LOWCUT/BinWidth);
+	int kmax = (int)(MFSK_HICUT/BinWidth);
+	if(kmax > MFSK_FFT_SIZE/2 - 1)
+		kmax = MFSK_FFT_SIZE/2 - 1;
+	int hw = (int)(FSK_SYMB_RATE/(2.0*BinWidth) + 0.5);	//+/- half the symbol rate in bins
+	if(hw < 1)
+		hw = 1;
+	int hs = (int)(FSK_SHIFT_FREQ/(2.0*BinWidth) + 0.5);	//half the shift in bins
+	if(hs < 1)
+		hs = 1;
+	int ho = hs + 2*hw;		//just outside the pair
+	m_NumPairs = 0;
+	if(kmax - kmin < 4*ho)
+		return;
+
+	//smooth the spectrum so each keyed tone makes a single peak
+	for(int k=kmin; k<=kmax; k++)
+	{
+		TYPEREAL sum = 0.0;
+		int n = 0;
+		for(int j=k-hw; j<=k+hw; j++)
+		{
+			if( (j >= 0) && (j < MFSK_FFT_SIZE/2) )
+			{
+				sum += m_PwrSum[j];
+				n++;
+			}
+		}
+		m_Smooth[k] = sum/n;
+	}
+	//noise floor is the lower quartile of the passband so a crowded
+	// band does not raise it
+	int n = kmax - kmin + 1;
+	for(int k=0; k<n; k++)
+		m_Sorted[k] = m_Smooth[kmin+k];
+	std::nth_element(m_Sorted, m_Sorted + n/4, m_Sorted + n);
+	TYPEREAL Threshold = m_Sorted[n/4]*MFSK_DETECT_SNR;
+
+	//score every possible pair center by its weaker tone
+	int cmin = kmin + hs;
+	int cmax = kmax - hs;
+	for(int k=cmin; k<=cmax; k++)
+	{
+		TYPEREAL pwr = (m_Smooth[k-hs] < m_Smooth[k+hs]) ? m_Smooth[k-hs] : m_Smooth[k+hs];
+		TYPEREAL lo = (k-ho >= kmin) ? m_Smooth[k-ho] : 0.0;
+		TYPEREAL hi = (k+ho <= kmax) ? m_Smooth[k+ho] : 0.0;
+		TYPEREAL out = (lo > hi) ? lo : hi;
+		m_Score[k] = (pwr > PAIR_CONTRAST*out) ? pwr : 0.0;
+	}
+
+	for(int k=cmin; k<=cmax; k++)
+	{
+		TYPEREAL pwr = m_Score[k];
+		if(pwr <= Threshold)
+			continue;
+		//must be the best pair within +/- one shift
+		bool peak = true;
+		for(int j=k-2*hs; j<=k+2*hs && peak; j++)
+		{
+			if( (j < cmin) || (j > cmax) || (j == k) )
+				continue;
+			if( (m_Score[j] > pwr) || ((j < k) && (m_Score[j] == pwr)) )
+				peak = false;
+		}
+		if(!peak)
+			continue;
+		//the score is flat topped so the center is the midpoint of the
+		// power centroids of the two tones
+		TYPEREAL sum = 0.0;
+		TYPEREAL wsum = 0.0;
+		for(int j=k-hs-2*hw; j<=k+hs+2*hw; j++)
+		{
+			if( (j < 0) || (j >= MFSK_FFT_SIZE/2) )
+				continue;
+			//fold each tone onto the center
+			TYPEREAL p = m_PwrSum[j];
+			sum += p;
+			wsum += p*( (j >= k) ? (j - hs) : (j + hs) );
+		}
+		TYPEREAL freq = (sum > 0.0) ? (wsum/sum)*BinWidth : k*BinWidth;
+		//insert in list sorted by power, dropping the weakest if full
+		int pos = m_NumPairs;
+		while( (pos > 0) && (m_PairPwr[pos-1] < pwr) )
+			pos--;
+		if(pos >= MFSK_MAX_CHANNELS)
+			continue;
+		int last = (m_NumPairs < MFSK_MAX_CHANNELS) ? m_NumPairs : MFSK_MAX_CHANNELS-1;
+		for(int i=last; i>pos; i--)
+		{
+			m_Pairs[i] = m_Pairs[i-1];
+			m_PairPwr[i] = m_PairPwr[i-1];
+		}
+		m_Pairs[pos] = freq;
+		m_PairPwr[pos] = pwr;
+		if(m_NumPairs < MFSK_MAX_CHANNELS)
+			m_NumPairs++;
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//	Get the pair center frequencies found by the last search
+/////////////////////////////////////////////////////////////////////////////////
+int CFskPairDetect::GetPairs(TYPEREAL* pFreqs, int MaxPairs)
+{
+	int n = m_NumPairs;
+	if(n > MaxPairs)
+		n = MaxPairs;
+	for(int i=0; i<n; i++)
+		pFreqs[i] = m_Pairs[i];
+	return n;
+}
@@ -0,0 +1,86 @@
+//////////////////////////////////////////////////////////////////////
+// multifsk.h: interface for the CFskPairDetect class.
+//
+//  Finds the DSC FSK signals in an SSB passband so a decoder channel
+//can be started on each one. Each signal is two tones FSK_SHIFT_FREQ
+//apart so the averaged spectrum is searched for pairs of peaks rather
+//than single carriers.
+//
+// History:
+//	2026-10-18  Initial creation
+//////////////////////////////////////////////////////////////////////
+//==========================================================================================
+// + + +   This Software is released under the "Simplified BSD License"  + + +
+//Copyright 2010 Moe Wheatley. All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification, are
+//permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice, this list of
+//	  conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice, this list
+//	  of conditions and the following disclaimer in the documentation and/or other materials
+//	  provided with the distribution.
+//
+//THIS SOFTWARE IS PROVIDED BY Moe Wheatley ``AS IS'' AND ANY EXPRESS OR IMPLIED
+//WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+//FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Moe Wheatley OR
+//CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+//ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+//ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//The views and conclusions contained in the software and documentation are those of the
+//authors and should not be interpreted as representing official policies, either expressed
+//or implied, of Moe Wheatley.
+//=============================================================================
+#ifndef MULTIFSK_H
+#define MULTIFSK_H
+#include "dsp/datatypes.h"
+#include "dsp/fft.h"
+#include "dsp/fskdemod.h"
+
+#define MFSK_LOWCUT 200.0		//audio passband searched for FSK signals in Hz
+#define MFSK_HICUT 3000.0
+#define MFSK_MAX_CHANNELS 32	//most signals decoded at once
+#define MFSK_FFT_SIZE 2048		//pair search FFT size
+#define MFSK_DETECT_TIME 1.0	//seconds of spectra averaged for each pair search
+#define MFSK_DETECT_SNR 4.0		//tone to noise floor power ratio needed(6dB)
+#define MFSK_LOSS_TIME 60.0		//seconds a pair is not seen before its decoder is freed
+
+////////////
+//class that finds FSK tone pairs in the passband
+////////////
+class CFskPairDetect
+{
+public:
+	CFskPairDetect();
+
+	void Init(TYPEREAL SampleRate);
+	//returns true when a new pair list is ready
+	bool ProcessData(int InLength, const TYPECPX* pInData);
+	//copies up to MaxPairs center frequencies(strongest first) into pFreqs
+	int GetPairs(TYPEREAL* pFreqs, int MaxPairs);
+
+private:
+	void FindPairs();
+	TYPEREAL m_SampleRate;
+	int m_InPos;
+	int m_NumAve;
+	int m_AveLimit;
+	int m_NumPairs;
+	TYPEREAL m_Pairs[MFSK_MAX_CHANNELS];
+	TYPEREAL m_PairPwr[MFSK_MAX_CHANNELS];
+	TYPEREAL m_Window[MFSK_FFT_SIZE];
+	TYPEREAL m_PwrSum[MFSK_FFT_SIZE];
+	TYPEREAL m_Smooth[MFSK_FFT_SIZE];
+	TYPEREAL m_Score[MFSK_FFT_SIZE];
+	TYPEREAL m_Sorted[MFSK_FFT_SIZE];
+	TYPECPX m_FftBuf[MFSK_FFT_SIZE];
+	CFft m_Fft;
+};
+
+#endif // MULTIFSK_H
@@ -0,0 +1,291 @@
+/////////////////////////////////////////////////////////////////////
+// multipsk.cpp: implementation of the CPskChannel and CPskCarrierDetect classes.
+//
+//	A PSK31 signal sending idles is two tones +/-SymbRate/2 from the
+// carrier so the averaged spectrum is smoothed over +/-SymbRate/2 before
+// looking for peaks. The noise floor is the median of the passband so a
+// crowded band still has a sensible threshold.
+// History:
+//	2026-10-18  Initial creation
+/////////////////////////////////////////////////////////////////////
+//==========================================================================================
+// + + +   This Software is released under the "Simplified BSD License"  + + +
+//Copyright 2010 Moe Wheatley. All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification, are
+//permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice, this list of
+//	  conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice, this list
+//	  of conditions and the following disclaimer in the documentation and/or other materials
+//	  provided with the distribution.
+//
+//THIS SOFTWARE IS PROVIDED BY Moe Wheatley ``AS IS'' AND ANY EXPRESS OR IMPLIED
+//WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+//FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Moe Wheatley OR
+//CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+//ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+//ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//The views and conclusions contained in the software and documentation are those of the
+//authors and should not be interpreted as representing official policies, either expressed
+//or implied, of Moe Wheatley.
+//==========================================================================================
+#include "dsp/multipsk.h"
+#include <algorithm>
+#include <QDebug>
+
+#define CHAN_DECIMATED_RATE 500.0	//rate CPskDecoder runs at
+#define CHAN_ASTOP 50.0				//stop band attenuation of channel filter in dB
+#define CHAN_FSTOP 250.0			//stop band edge of channel filter in Hz
+
+/////////////////////////////////////////////////////////////////////////////////
+//	Construct Psk channel object
+/////////////////////////////////////////////////////////////////////////////////
+CPskChannel::CPskChannel()
+{
+	m_InSampleRate = 0.0;
+	m_SymbRate = 31.25;
+	m_Freq = 0.0;
+	m_Osc.re = 1.0;
+	m_Osc.im = 0.0;
+	m_ClosedCount = 0;
+	m_LossLimit = 1;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//	Create the channel filter for the passband sample rate and symbol rate
+/////////////////////////////////////////////////////////////////////////////////
+void CPskChannel::Init(TYPEREAL InSampleRate, TYPEREAL SymbRate)
+{
+	m_InSampleRate = InSampleRate;
+	m_SymbRate = SymbRate;
+	//calculate integer M to get close to 500Hz sample rate like CPskDemod
+	int M = (int)(InSampleRate/CHAN_DECIMATED_RATE + 0.5);
+	if(M < 1)
+		M = 1;
+	m_Decimate.InitLPFilter(M, CHAN_ASTOP, SymbRate*1.5, CHAN_FSTOP, InSampleRate);
+	m_LossLimit = (int)(MPSK_LOSS_TIME*InSampleRate/M);
+	Start(m_Freq);
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//	Reset the decoder to start on a new signal at Freq Hz
+/////////////////////////////////////////////////////////////////////////////////
+void CPskChannel::Start(TYPEREAL Freq)
+{
+	m_Freq = Freq;
+	m_Osc.re = 1.0;
+	m_Osc.im = 0.0;
+	m_ClosedCount = 0;
+	m_Decimate.Reset();
+	m_Decoder.Init(m_InSampleRate/m_Decimate.GetDecimation(), m_SymbRate);
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//	Shift the channel signal to baseband, decimate and decode it.
+/////////////////////////////////////////////////////////////////////////////////
+int CPskChannel::ProcessData(int InLength, const TYPECPX* pInData, quint8* pChars)
+{
+int NumChars = 0;
+	while(InLength > 0)
+	{
+		int n = InLength;
+		if(n > MPSK_MIX_BLOCK)
+			n = MPSK_MIX_BLOCK;
+		//NCO step is updated every block with the latest AFC correction
+		TYPEREAL inc = -K_2PI*GetFreq()/m_InSampleRate;
+		TYPEREAL StepRe = MCOS(inc);
+		TYPEREAL StepIm = MSIN(inc);
+		for(int i=0; i<n; i++)
+		{
+			TYPECPX in = pInData[i];
+			m_MixBuf[i].re = in.re*m_Osc.re - in.im*m_Osc.im;
+			m_MixBuf[i].im = in.re*m_Osc.im + in.im*m_Osc.re;
+			TYPEREAL tmp = m_Osc.re*StepRe - m_Osc.im*StepIm;
+			m_Osc.im = m_Osc.re*StepIm + m_Osc.im*StepRe;
+			m_Osc.re = tmp;
+		}
+		//keep phasor at unit length
+		TYPEREAL gain = 1.5 - 0.5*(m_Osc.re*m_Osc.re + m_Osc.im*m_Osc.im);
+		m_Osc.re *= gain;
+		m_Osc.im *= gain;
+
+		int length = m_Decimate.ProcessData(n, m_MixBuf, m_MixBuf);
+		NumChars += m_Decoder.ProcessData(length, m_MixBuf, &pChars[NumChars]);
+		if( m_Decoder.IsSquelchOpen() )
+			m_ClosedCount = 0;
+		else
+			m_ClosedCount += length;
+		pInData += n;
+		InLength -= n;
+	}
+	return NumChars;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//	Construct carrier detector object
+/////////////////////////////////////////////////////////////////////////////////
+CPskCarrierDetect::CPskCarrierDetect()
+{
+	m_SampleRate = 0.0;
+	m_SymbRate = 31.25;
+	m_InPos = 0;
+	m_NumAve = 0;
+	m_AveLimit = 1;
+	m_NumCarriers = 0;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//	Setup the FFT for the passband sample rate and clear the averages
+/////////////////////////////////////////////////////////////////////////////////
+void CPskCarrierDetect::Init(TYPEREAL SampleRate, TYPEREAL SymbRate)
+{
+	m_SampleRate = SampleRate;
+	m_SymbRate = SymbRate;
+	m_Fft.SetFFTParams(MPSK_FFT_SIZE, false, 0.0, SampleRate);
+	for(int i=0; i<MPSK_FFT_SIZE; i++)
+	{	//Hann window
+		m_Window[i] = 0.5 - 0.5*MCOS( (K_2PI*i)/(MPSK_FFT_SIZE-1) );
+		m_PwrSum[i] = 0.0;
+	}
+	m_AveLimit = (int)(MPSK_DETECT_TIME*SampleRate/MPSK_FFT_SIZE + 0.5);
+	if(m_AveLimit < 1)
+		m_AveLimit = 1;
+	m_InPos = 0;
+	m_NumAve = 0;
+	m_NumCarriers = 0;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//	Accumulate power spectra and search for carriers every MPSK_DETECT_TIME
+/////////////////////////////////////////////////////////////////////////////////
+bool CPskCarrierDetect::ProcessData(int InLength, const TYPECPX* pInData)
+{
+bool ready = false;
+	for(int i=0; i<InLength; i++)
+	{
+		m_FftBuf[m_InPos].re = pInData[i].re*m_Window[m_InPos];
+		m_FftBuf[m_InPos].im = pInData[i].im*m_Window[m_InPos];
+		if(++m_InPos < MPSK_FFT_SIZE)
+			continue;
+		m_InPos = 0;
+		m_Fft.FwdFFT(m_FftBuf);
+		//CFft puts positive frequency k in bin N-k so flip it here
+		for(int k=0; k<MPSK_FFT_SIZE; k++)
+		{
+			TYPECPX& x = m_FftBuf[(MPSK_FFT_SIZE - k) & (MPSK_FFT_SIZE-1)];
+			m_PwrSum[k] += x.re*x.re + x.im*x.im;
+		}
+		if(++m_NumAve >= m_AveLimit)
+		{
+			FindCarriers();
+			for(int k=0; k<MPSK_FFT_SIZE; k++)
+				m_PwrSum[k] = 0.0;
+			m_NumAve = 0;
+			ready = true;
+		}
+	}
+	return ready;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//	Pick the peaks in the averaged spectrum that are well above the noise
+/////////////////////////////////////////////////////////////////////////////////
+void CPskCarrierDetect::FindCarriers()
+{
+	TYPEREAL BinWidth = m_SampleRate/MPSK_FFT_SIZE;
+	int kmin = (int)(MPSK_LOWCUT/BinWidth);
+	int kmax = (int)(MPSK_HICUT/BinWidth);
+	if(kmax > MPSK_FFT_SIZE/2 - 1)
+		kmax = MPSK_FFT_SIZE/2 - 1;
+	int hw = (int)(m_SymbRate/(2.0*BinWidth) + 0.5);	//+/- half the symbol rate in bins
+	if(hw < 1)
+		hw = 1;
+	m_NumCarriers = 0;
+	if(kmax - kmin < 8*hw)
+		return;
+
+	//smooth the spectrum so each PSK signal makes a single peak
+	for(int k=kmin; k<=kmax; k++)
+	{
+		TYPEREAL sum = 0.0;
+		int n = 0;
+		for(int j=k-hw; j<=k+hw; j++)
+		{
+			if( (j >= 0) && (j < MPSK_FFT_SIZE/2) )
+			{
+				sum += m_PwrSum[j];
+				n++;
+			}
+		}
+		m_Smooth[k] = sum/n;
+	}
+	//noise floor is the median of the passband
+	int n = kmax - kmin + 1;
+	for(int k=0; k<n; k++)
+		m_Sorted[k] = m_Smooth[kmin+k];
+	std::nth_element(m_Sorted, m_Sorted + n/2, m_Sorted + n);
+	TYPEREAL Threshold = m_Sorted[n/2]*MPSK_DETECT_SNR;
+
+	for(int k=kmin; k<=kmax; k++)
+	{
+		TYPEREAL pwr = m_Smooth[k];
+		if(pwr <= Threshold)
+			continue;
+		//must be the largest value within +/- one symbol rate
+		bool peak = true;
+		for(int j=k-2*hw; j<=k+2*hw && peak; j++)
+		{
+			if( (j < kmin) || (j > kmax) || (j == k) )
+				continue;
+			if( (m_Smooth[j] > pwr) || ((j < k) && (m_Smooth[j] == pwr)) )
+				peak = false;
+		}
+		if(!peak)
+			continue;
+		//carrier frequency is the power centroid around the peak
+		TYPEREAL sum = 0.0;
+		TYPEREAL wsum = 0.0;
+		for(int j=k-hw; j<=k+hw; j++)
+		{
+			sum += m_PwrSum[j];
+			wsum += m_PwrSum[j]*j;
+		}
+		TYPEREAL freq = (sum > 0.0) ? (wsum/sum)*BinWidth : k*BinWidth;
+		//insert in list sorted by power, dropping the weakest if full
+		int pos = m_NumCarriers;
+		while( (pos > 0) && (m_CarrierPwr[pos-1] < pwr) )
+			pos--;
+		if(pos >= MPSK_MAX_CHANNELS)
+			continue;
+		int last = (m_NumCarriers < MPSK_MAX_CHANNELS) ? m_NumCarriers : MPSK_MAX_CHANNELS-1;
+		for(int i=last; i>pos; i--)
+		{
+			m_Carriers[i] = m_Carriers[i-1];
+			m_CarrierPwr[i] = m_CarrierPwr[i-1];
+		}
+		m_Carriers[pos] = freq;
+		m_CarrierPwr[pos] = pwr;
+		if(m_NumCarriers < MPSK_MAX_CHANNELS)
+			m_NumCarriers++;
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//	Get the carriers found by the last search
+/////////////////////////////////////////////////////////////////////////////////
+int CPskCarrierDetect::GetCarriers(TYPEREAL* pFreqs, int MaxCarriers)
+{
+	int n = m_NumCarriers;
+	if(n > MaxCarriers)
+		n = MaxCarriers;
+	for(int i=0; i<n; i++)
+		pFreqs[i] = m_Carriers[i];
+	return n;
+}
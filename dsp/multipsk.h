@@ -0,0 +1,120 @@
+//////////////////////////////////////////////////////////////////////
+// multipsk.h: interface for the CPskChannel and CPskCarrierDetect classes.
+//
+//  Building blocks for decoding every PSK31/63 signal in an SSB passband.
+//  CPskCarrierDetect averages FFTs of the passband and returns the
+//frequencies of the PSK signals it finds.
+//  CPskChannel is one lightweight decoder. It shifts its signal to
+//baseband, filters and decimates it to ~500Hz and runs a CPskDecoder.
+//Its memory is fixed and its cost per input sample does not depend on
+//how many signals are present.
+//
+// History:
+//	2026-10-18  Initial creation
+//////////////////////////////////////////////////////////////////////
+//==========================================================================================
+// + + +   This Software is released under the "Simplified BSD License"  + + +
+//Copyright 2010 Moe Wheatley. All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification, are
+//permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice, this list of
+//	  conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice, this list
+//	  of conditions and the following disclaimer in the documentation and/or other materials
+//	  provided with the distribution.
+//
+//THIS SOFTWARE IS PROVIDED BY Moe Wheatley ``AS IS'' AND ANY EXPRESS OR IMPLIED
+//WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+//FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Moe Wheatley OR
+//CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+//ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+//ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//The views and conclusions contained in the software and documentation are those of the
+//authors and should not be interpreted as representing official policies, either expressed
+//or implied, of Moe Wheatley.
+//=============================================================================
+#ifndef MULTIPSK_H
+#define MULTIPSK_H
+#include "dsp/datatypes.h"
+#include "dsp/fft.h"
+#include "dsp/polyphasefir.h"
+#include "dsp/pskdemod.h"
+
+#define MPSK_LOWCUT 200.0		//audio passband searched for PSK signals in Hz
+#define MPSK_HICUT 3000.0
+#define MPSK_MAX_CHANNELS 32	//most signals decoded at once
+#define MPSK_FFT_SIZE 2048		//carrier search FFT size
+#define MPSK_DETECT_TIME 1.0	//seconds of spectra averaged for each carrier search
+#define MPSK_DETECT_SNR 10.0	//signal to median noise power ratio needed(10dB)
+#define MPSK_LOSS_TIME 5.0		//seconds of closed squelch before a decoder is freed
+#define MPSK_MIX_BLOCK 256		//input samples mixed per pass by a channel
+
+////////////
+//class for one channel of the multi-channel PSK decoder
+////////////
+class CPskChannel
+{
+public:
+	CPskChannel();
+
+	void Init(TYPEREAL InSampleRate, TYPEREAL SymbRate);
+	void Start(TYPEREAL Freq);	//start decoding a new signal at Freq Hz
+	//Decodes InLength passband samples, pChars must have room for
+	//InLength/GetDecimation()+1 characters. Returns number of characters.
+	int ProcessData(int InLength, const TYPECPX* pInData, quint8* pChars);
+	TYPEREAL GetFreq(){return m_Freq + m_Decoder.GetFreqError();}	//includes AFC
+	int GetDecimation(){return m_Decimate.GetDecimation();}
+	bool IsLost(){return m_ClosedCount >= m_LossLimit;}
+
+private:
+	TYPEREAL m_InSampleRate;
+	TYPEREAL m_SymbRate;
+	TYPEREAL m_Freq;
+	TYPECPX m_Osc;			//NCO phasor
+	int m_ClosedCount;		//decimated samples since the squelch closed
+	int m_LossLimit;
+	TYPECPX m_MixBuf[MPSK_MIX_BLOCK];
+	CDecimateByM m_Decimate;
+	CPskDecoder m_Decoder;
+};
+
+////////////
+//class that finds PSK signals in the passband
+////////////
+class CPskCarrierDetect
+{
+public:
+	CPskCarrierDetect();
+
+	void Init(TYPEREAL SampleRate, TYPEREAL SymbRate);
+	//returns true when a new carrier list is ready
+	bool ProcessData(int InLength, const TYPECPX* pInData);
+	//copies up to MaxCarriers frequencies(strongest first) into pFreqs
+	int GetCarriers(TYPEREAL* pFreqs, int MaxCarriers);
+
+private:
+	void FindCarriers();
+	TYPEREAL m_SampleRate;
+	TYPEREAL m_SymbRate;
+	int m_InPos;
+	int m_NumAve;
+	int m_AveLimit;
+	int m_NumCarriers;
+	TYPEREAL m_Carriers[MPSK_MAX_CHANNELS];
+	TYPEREAL m_CarrierPwr[MPSK_MAX_CHANNELS];
+	TYPEREAL m_Window[MPSK_FFT_SIZE];
+	TYPEREAL m_PwrSum[MPSK_FFT_SIZE];
+	TYPEREAL m_Smooth[MPSK_FFT_SIZE];
+	TYPEREAL m_Sorted[MPSK_FFT_SIZE];
+	TYPECPX m_FftBuf[MPSK_FFT_SIZE];
+	CFft m_Fft;
+};
+
+#endif // MULTIPSK_H
@@ -8,6 +8,8 @@
 //	2011-01-06  Initial creation MSW
 //	2011-03-27  Initial release(not implemented yet)
 //	2013-07-28  Added single/double precision math macros
+//	2026-10-18  Blanker processes blocks with power of 2 rings and SIMD kernels
+//	2026-10-18  Blanker settings are passed to the DSP thread in a snapshot
 //////////////////////////////////////////////////////////////////////
 
 //==========================================================================================
@@ -40,18 +42,21 @@
 //==========================================================================================
 
 #include "dsp/noiseproc.h"
+#include "dsp/simdops.h"
 #include "gui/testbench.h"
 #include "interface/perform.h"
 #include <QDebug>
+#include <string.h>
 
 //////////////////////////////////////////////////////////////////////
 // Local Defines
 //////////////////////////////////////////////////////////////////////
 #define MAX_WIDTH 4096		//abt 1 mSec at 2MHz
-#define MAX_DELAY 4096		//abt 1 mSec at 2MHz
-#define MAX_AVE 32768		//abt 10 mSec at 2MHz
+#define MAX_DELAY 4096		//abt 1 mSec at 2MHz must be a power of 2
+#define MAX_AVE 32768		//abt 10 mSec at 2MHz must be a power of 2
 
 #define MAGAVE_TIME 0.005
+#define RESYNC_SAMPLES 262144	//how often the moving magnitude sum is recomputed
 
 //////////////////////////////////////////////////////////////////////
 // Construction/Destruction
@@ -61,8 +66,10 @@ CNoiseProc::CNoiseProc()
 {
 	m_DelayBuf = new TYPECPX[MAX_DELAY];
 	m_MagBuf = new TYPEREAL[MAX_AVE];
-	m_TestBenchDataBuf = new TYPECPX[4096];
-	SetupBlanker(false, 50.0, 2.0, 1000.0);
+	tNB_PARAMS Params = {false, 50.0, 2.0, 1000.0};
+	m_Params.Publish(Params);
+	m_Params.Update();
+	ApplyBlanker();
 }
 
 CNoiseProc::~CNoiseProc()
@@ -71,42 +78,63 @@ CNoiseProc::~CNoiseProc()
 		delete m_DelayBuf;
 	if(m_MagBuf)
 		delete m_MagBuf;
-	if(m_TestBenchDataBuf)
-		delete m_TestBenchDataBuf;
 }
 
+//////////////////////////////////////////////////////////////////////
+//	Publishes new blanker settings. ProcessBlanker() picks them up at
+//the start of its next block so neither thread waits on the other.
+//////////////////////////////////////////////////////////////////////
 void CNoiseProc::SetupBlanker(bool On, TYPEREAL Threshold, TYPEREAL Width, TYPEREAL SampleRate)
 {
-	if( (Threshold==m_Threshold) &&
-		(Width==m_Width) &&
-		(m_On == On) &&
-		(SampleRate==SampleRate) )
+	const tNB_PARAMS& Last = m_Params.Published();
+	if( (Threshold==Last.Threshold) &&
+		(Width==Last.Width) &&
+		(Last.On == On) &&
+		(SampleRate==Last.SampleRate) )
 	{
 		return;
 	}
-	m_Mutex.lock();
-	m_On = On;
-	m_Threshold = Threshold;
-	m_Width = Width;
-	m_SampleRate = SampleRate;
+	tNB_PARAMS Params = {On, Threshold, Width, SampleRate};
+	m_Params.Publish(Params);
+}
+
+//////////////////////////////////////////////////////////////////////
+//	Sets up the blanker from the current snapshot and clears the rings.
+//Only called on the thread running ProcessBlanker().
+//////////////////////////////////////////////////////////////////////
+void CNoiseProc::ApplyBlanker()
+{
+	const tNB_PARAMS& Params = m_Params.Get();
+	m_On = Params.On;
+	m_Threshold = Params.Threshold;
+	m_Width = Params.Width;
+	m_SampleRate = Params.SampleRate;
 
-	m_WidthSamples = Width * 1e-6 * m_SampleRate;
+	m_WidthSamples = m_Width * 1e-6 * m_SampleRate;
 	if(m_WidthSamples < 1)
 		m_WidthSamples = 1;
 	else if(m_WidthSamples>MAX_WIDTH)
 		m_WidthSamples = MAX_WIDTH;
 
+	//the rings must hold the averaging window or delay plus one block
 	m_MagSamples = MAGAVE_TIME*m_SampleRate;
+	if(m_MagSamples < 1)
+		m_MagSamples = 1;
+	else if(m_MagSamples > MAX_AVE-NB_BLOCK)
+		m_MagSamples = MAX_AVE-NB_BLOCK;
 
 	m_Ratio = .005*(m_Threshold)*(TYPEREAL)m_MagSamples;
 
 	m_DelaySamples = m_WidthSamples/2;
+	if(m_DelaySamples > MAX_DELAY-NB_BLOCK)
+		m_DelaySamples = MAX_DELAY-NB_BLOCK;
 
 //	qDebug()<<"m_DelaySamples="<<m_DelaySamples << m_Ratio;
 
 	m_Dptr = 0;
 	m_Mptr = 0;
 	m_BlankCounter = 0;
+	m_ResyncCount = 0;
 	m_MagAveSum = 0.0;
 	for(int i=0; i<MAX_DELAY ; i++)
 	{
@@ -115,63 +143,111 @@ void CNoiseProc::SetupBlanker(bool On, TYPEREAL Threshold, TYPEREAL Width, TYPER
 	}
 	for(int i=0; i<MAX_AVE ; i++)
 		m_MagBuf[i] = 0.0;
-
-	m_Mutex.unlock();
 }
 
 void CNoiseProc::ProcessBlanker(int InLength, TYPECPX* pInData, TYPECPX* pOutData)
 {
-TYPECPX newsamp;
-TYPECPX oldest;
+	if(m_Params.Update())
+		ApplyBlanker();
 	if(!m_On)
 	{
 		g_pTestBench->DisplayData(InLength, 1.0, pOutData, m_SampleRate,PROFILE_7);
 		return;
 	}
-	m_Mutex.lock();
 //StartPerformance();
-	for(int i=0; i<InLength; i++)
+	for(int i=0; i<InLength; i+=NB_BLOCK)
 	{
-		newsamp = pInData[i];
-
-		//calculate magnitude peak magnitude
-		TYPEREAL mre = MFABS(newsamp.re);
-		TYPEREAL mim = MFABS(newsamp.im);
-		TYPEREAL mag = (mre>mim) ? mre : mim;
-
-//m_TestBenchDataBuf[i].im = mag;
-		//calc moving average of "m_MagSamples"
-		m_MagAveSum -= m_MagBuf[m_Mptr];	//subtract oldest sample
-		m_MagAveSum += mag;					//add new sample
-		m_MagBuf[m_Mptr++] = mag;			//stick in buffer
-		if(m_Mptr > m_MagSamples)
-			m_Mptr = 0;
-
-		//pull out oldest sample from delay buffer and put in new one
-		oldest = m_DelayBuf[m_Dptr];
-		m_DelayBuf[m_Dptr++] = newsamp;
-		if(m_Dptr > m_DelaySamples)
-			m_Dptr = 0;
-
-		if( mag*m_Ratio > m_MagAveSum )
-		{
-			m_BlankCounter = m_WidthSamples;
-		}
-m_TestBenchDataBuf[i].im = oldest.re + oldest.im;
-		if(m_BlankCounter)
-		{
-			m_BlankCounter--;
-m_TestBenchDataBuf[i].re = 0.0;
-			pOutData[i].re = 0.0;
-			pOutData[i].im = 0.0;
-		}
-		else
-		{
-m_TestBenchDataBuf[i].re = m_MagAveSum/m_Ratio;
-			pOutData[i] = oldest;
-		}
+		int n = InLength - i;
+		if(n > NB_BLOCK)
+			n = NB_BLOCK;
+		BlankBlock(n, &pInData[i], &pOutData[i]);
 	}
-	m_Mutex.unlock();
 //StopPerformance(InLength);
-g_pTestBench->DisplayData(InLength, 1.0, m_TestBenchDataBuf, m_SampleRate,PROFILE_7);
+g_pTestBench->DisplayData(InLength, 1.0, pOutData, m_SampleRate,PROFILE_7);
+}
+
+//////////////////////////////////////////////////////////////////////
+//	Blanks one block of Length(<=NB_BLOCK) samples.
+//  The output is the input delayed by m_DelaySamples and zeroed for
+//m_WidthSamples starting m_DelaySamples before any sample whose peak
+//magnitude is more than m_Threshold/.005 times the average magnitude of
+//the last m_MagSamples samples.
+//  pOutData may be the same buffer as pInData.
+//////////////////////////////////////////////////////////////////////
+void CNoiseProc::BlankBlock(int Length, const TYPECPX* pInData, TYPECPX* pOutData)
+{
+const int MagMask = MAX_AVE-1;
+const int DelayMask = MAX_DELAY-1;
+	//peak magnitudes go into the ring so the samples leaving the
+	// averaging window are ring[pos-m_MagSamples]
+	SimdPeakMag(pInData, m_Mag, Length);
+	int n1 = MAX_AVE - m_Mptr;
+	if(n1 > Length)
+		n1 = Length;
+	memcpy(&m_MagBuf[m_Mptr], m_Mag, n1*sizeof(TYPEREAL));
+	memcpy(m_MagBuf, &m_Mag[n1], (Length-n1)*sizeof(TYPEREAL));
+	m_Mptr = (m_Mptr + Length)&MagMask;
+	//moving sum is the running sum of new minus oldest magnitudes
+	int optr = (m_Mptr - Length - m_MagSamples)&MagMask;
+	n1 = MAX_AVE - optr;
+	if(n1 > Length)
+		n1 = Length;
+	m_MagAveSum = SimdPrefixSum(m_Mag, &m_MagBuf[optr], m_Sum, n1, m_MagAveSum);
+	m_MagAveSum = SimdPrefixSum(&m_Mag[n1], m_MagBuf, &m_Sum[n1], Length-n1, m_MagAveSum);
+	m_ResyncCount += Length;
+	if(m_ResyncCount >= RESYNC_SAMPLES)
+		ResyncMagSum();
+
+	//delay the input so blanking starts before the detected pulse
+	n1 = MAX_DELAY - m_Dptr;
+	if(n1 > Length)
+		n1 = Length;
+	memcpy(&m_DelayBuf[m_Dptr], pInData, n1*sizeof(TYPECPX));
+	memcpy(m_DelayBuf, &pInData[n1], (Length-n1)*sizeof(TYPECPX));
+	int rptr = (m_Dptr - m_DelaySamples)&DelayMask;
+	n1 = MAX_DELAY - rptr;
+	if(n1 > Length)
+		n1 = Length;
+	memmove(pOutData, &m_DelayBuf[rptr], n1*sizeof(TYPECPX));
+	memmove(&pOutData[n1], m_DelayBuf, (Length-n1)*sizeof(TYPECPX));
+	m_Dptr = (m_Dptr + Length)&DelayMask;
+
+	//find impulses. Usually there are none so the block is just delayed
+	if( (0==SimdCountAbove(m_Mag, m_Ratio, m_Sum, Length)) && (0==m_BlankCounter) )
+		return;
+	//build the blanking mask then apply it to the block
+	int count = m_BlankCounter;
+	for(int i=0; i<Length; i++)
+	{
+		if( m_Mag[i]*m_Ratio > m_Sum[i] )
+			count = m_WidthSamples;
+		m_Gain[i] = (count > 0) ? 0.0 : 1.0;
+		if(count > 0)
+			count--;
+	}
+	m_BlankCounter = count;
+	for(int i=0; i<Length; i++)
+	{
+		pOutData[i].re *= m_Gain[i];
+		pOutData[i].im *= m_Gain[i];
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+//	Recomputes the moving magnitude sum from the ring so rounding
+//errors from the running sum don't build up.
+//////////////////////////////////////////////////////////////////////
+void CNoiseProc::ResyncMagSum()
+{
+	int start = (m_Mptr - m_MagSamples)&(MAX_AVE-1);
+	int n1 = MAX_AVE - start;
+	if(n1 > m_MagSamples)
+		n1 = m_MagSamples;
+	TYPEREAL sum = 0.0;
+	for(int i=0; i<n1; i++)
+		sum += m_MagBuf[start+i];
+	for(int i=0; i<m_MagSamples-n1; i++)
+		sum += m_MagBuf[i];
+	m_MagAveSum = sum;
+	m_ResyncCount = 0;
 }
@@ -6,6 +6,10 @@
 // History:
 //	2011-01-06  Initial creation MSW
 //	2011-03-27  Initial release
+//	2026-10-18  Blanker processes blocks with power of 2 rings
+//	2026-10-18  Added noise reduction settings
+//	2026-10-18  Added auto notch setting
+//	2026-10-18  Blanker settings are passed to the DSP thread in a snapshot
 //////////////////////////////////////////////////////////////////////
 //==========================================================================================
 // + + +   This Software is released under the "Simplified BSD License"  + + +
@@ -39,43 +43,65 @@
 #define NOISEPROC_H
 
 #include "dsp/datatypes.h"
-#include <QMutex>
+#include "dsp/paramsnapshot.h"
+
+#define NB_BLOCK 1024		//samples processed per blanker block
 
 typedef struct _snproc
 {
 	bool NBOn;
 	int NBThreshold;
 	int NBWidth;
+	bool NROn;		//audio noise reduction done by CNoiseReduce
+	int NRLevel;	//most noise reduction in dB
+	bool NotchOn;	//automatic notch done by CAutoNotch
 }tNoiseProcdInfo;
 
+//blanker settings passed from SetupBlanker() to the DSP thread
+typedef struct _nbparams
+{
+	bool On;
+	TYPEREAL Threshold;
+	TYPEREAL Width;
+	TYPEREAL SampleRate;
+}tNB_PARAMS;
+
 class CNoiseProc
 {
 public:
 	CNoiseProc();
 	virtual ~CNoiseProc();
 
+	//may be called from any one thread while ProcessBlanker() runs, the new
+	// settings are used from the start of the next ProcessBlanker() call
 	void SetupBlanker( bool On, TYPEREAL Threshold, TYPEREAL Width, TYPEREAL SampleRate);
 	void ProcessBlanker(int InLength, TYPECPX* pInData, TYPECPX* pOutData);
 
 private:
+	void ApplyBlanker();
+	void BlankBlock(int Length, const TYPECPX* pInData, TYPECPX* pOutData);
+	void ResyncMagSum();
 	bool m_On;
 	TYPEREAL m_Threshold;
 	TYPEREAL m_Width;
 	TYPEREAL m_SampleRate;
 
-	TYPECPX* m_DelayBuf;
+	TYPECPX* m_DelayBuf;	//power of 2 sized rings indexed with masks
 	TYPEREAL* m_MagBuf;
-	TYPECPX* m_TestBenchDataBuf;
-	int m_Dptr;
+	int m_Dptr;				//next write positions
 	int m_Mptr;
 	int m_BlankCounter;
 	int m_DelaySamples;
 	int m_MagSamples;
 	int m_WidthSamples;
+	int m_ResyncCount;
 	TYPEREAL m_Ratio;
 	TYPEREAL m_MagAveSum;
+	TYPEREAL m_Mag[NB_BLOCK];
+	TYPEREAL m_Sum[NB_BLOCK];
+	TYPEREAL m_Gain[NB_BLOCK];
 
-	QMutex m_Mutex;		//for keeping threads from stomping on each other
+	CParamSnapshot<tNB_PARAMS> m_Params;
 
 };
 #endif //  NOISEPROC_H
@@ -0,0 +1,270 @@
+//////////////////////////////////////////////////////////////////////
+// noisereduce.cpp: implementation of the CNoiseReduce class.
+//
+//  Spectral noise reduction with minimum statistics noise tracking
+// and a decision directed Wiener gain.
+//
+// History:
+//	2026-10-18  Initial creation
+//////////////////////////////////////////////////////////////////////
+//==========================================================================================
+// + + +   This Software is released under the "Simplified BSD License"  + + +
+//Copyright 2010 Moe Wheatley. All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification, are
+//permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice, this list of
+//	  conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice, this list
+//	  of conditions and the following disclaimer in the documentation and/or other materials
+//	  provided with the distribution.
+//
+//THIS SOFTWARE IS PROVIDED BY Moe Wheatley ``AS IS'' AND ANY EXPRESS OR IMPLIED
+//WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+//FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Moe Wheatley OR
+//CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+//ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+//ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//The views and conclusions contained in the software and documentation are those of the
+//authors and should not be interpreted as representing official policies, either expressed
+//or implied, of Moe Wheatley.
+//==========================================================================================
+#include "dsp/noisereduce.h"
+#include <string.h>
+#include <QDebug>
+
+#define NR_MINSTAT_BIAS 2.0		//the minimum of the smoothed power is about this much below the mean
+#define NR_DD_BETA 0.98			//decision directed a priori SNR weight
+#define NR_HUGE 1e30
+
+//////////////////////////////////////////////////////////////////////
+// Construction/Destruction
+//////////////////////////////////////////////////////////////////////
+CNoiseReduce::CNoiseReduce()
+{
+	m_On = false;
+	m_Level = 0.0;
+	m_SampleRate = 0.0;
+	Setup(false, 15.0, 8000.0);
+}
+
+//////////////////////////////////////////////////////////////////////
+//	Sets the noise reduction parameters. The filter state is only
+//cleared if it is turned on or the sample rate changes.
+//////////////////////////////////////////////////////////////////////
+void CNoiseReduce::Setup(bool On, TYPEREAL Level, TYPEREAL SampleRate)
+{
+	if( (On == m_On) && (Level == m_Level) && (SampleRate == m_SampleRate) )
+		return;
+	bool reset = (On && !m_On) || (SampleRate != m_SampleRate);
+	m_On = On;
+	m_Level = Level;
+	if(m_Level < 0.0)
+		m_Level = 0.0;
+	else if(m_Level > NR_MAX_LEVEL)
+		m_Level = NR_MAX_LEVEL;
+	m_SampleRate = SampleRate;
+	m_GainMin = MPOW(10.0, -m_Level/20.0);
+	m_SmoothAlpha = MEXP( -(TYPEREAL)NR_HOP/(m_SampleRate*NR_SMOOTH_TIME) );
+	m_SubWinFrames = (int)(NR_MINSTAT_TIME*m_SampleRate/(NR_HOP*NR_MINSTAT_SUBWIN));
+	if(m_SubWinFrames < 1)
+		m_SubWinFrames = 1;
+	if(reset)
+		Reset();
+}
+
+//////////////////////////////////////////////////////////////////////
+//	Clears the frame buffers and noise estimates
+//////////////////////////////////////////////////////////////////////
+void CNoiseReduce::Reset()
+{
+	m_Fft.SetFFTParams(NR_FFT_SIZE, false, 0.0, m_SampleRate);
+	//sqrt of a periodic Hann window so analysis times synthesis windows
+	// overlap-add to 1 at 50% overlap
+	for(int i=0; i<NR_FFT_SIZE; i++)
+		m_Window[i] = MSIN(K_PI*i/NR_FFT_SIZE);
+	memset(m_InFrame, 0, sizeof(m_InFrame));
+	memset(m_OutBuf, 0, sizeof(m_OutBuf));
+	memset(m_Overlap, 0, sizeof(m_Overlap));
+	for(int k=0; k<NR_BINS; k++)
+	{
+		m_MinPast[k] = NR_HUGE;
+		m_LastGain2[k] = 1.0;
+		m_LastSnr[k] = 1.0;
+		for(int j=0; j<NR_MINSTAT_SUBWIN; j++)
+			m_MinSub[j][k] = NR_HUGE;
+	}
+	m_InPos = 0;
+	m_NumFrames = 0;
+	m_FrameCount = 0;
+	m_SubWinPos = 0;
+}
+
+//////////////////////////////////////////////////////////////////////
+//	Process mono audio in place
+//////////////////////////////////////////////////////////////////////
+void CNoiseReduce::ProcessData(int InLength, TYPEREAL* pData)
+{
+	if(!m_On)
+		return;
+	int i = 0;
+	while(i < InLength)
+	{
+		int n = NR_HOP - m_InPos;
+		if(n > InLength-i)
+			n = InLength-i;
+		TYPECPX* pIn = &m_InFrame[NR_FFT_SIZE-NR_HOP+m_InPos];
+		TYPECPX* pOut = &m_OutBuf[m_InPos];
+		for(int j=0; j<n; j++)
+		{
+			pIn[j].re = pData[i+j];
+			pIn[j].im = 0.0;
+			pData[i+j] = pOut[j].re;
+		}
+		i += n;
+		m_InPos += n;
+		if(NR_HOP == m_InPos)
+		{
+			ProcessFrame();
+			m_InPos = 0;
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+//	Process stereo audio in place
+//////////////////////////////////////////////////////////////////////
+void CNoiseReduce::ProcessData(int InLength, TYPECPX* pData)
+{
+	if(!m_On)
+		return;
+	int i = 0;
+	while(i < InLength)
+	{
+		int n = NR_HOP - m_InPos;
+		if(n > InLength-i)
+			n = InLength-i;
+		TYPECPX* pIn = &m_InFrame[NR_FFT_SIZE-NR_HOP+m_InPos];
+		TYPECPX* pOut = &m_OutBuf[m_InPos];
+		for(int j=0; j<n; j++)
+		{
+			pIn[j] = pData[i+j];
+			pData[i+j] = pOut[j];
+		}
+		i += n;
+		m_InPos += n;
+		if(NR_HOP == m_InPos)
+		{
+			ProcessFrame();
+			m_InPos = 0;
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+//	Runs one frame of NR_FFT_SIZE samples, producing the next NR_HOP
+//output samples in m_OutBuf
+//////////////////////////////////////////////////////////////////////
+void CNoiseReduce::ProcessFrame()
+{
+	for(int i=0; i<NR_FFT_SIZE; i++)
+	{
+		m_FftBuf[i].re = m_InFrame[i].re*m_Window[i];
+		m_FftBuf[i].im = m_InFrame[i].im*m_Window[i];
+	}
+	memmove(m_InFrame, &m_InFrame[NR_HOP], (NR_FFT_SIZE-NR_HOP)*sizeof(TYPECPX));
+	m_Fft.FwdFFT(m_FftBuf);
+
+	//bin power of the real signal(s) from bins k and N-k
+	m_Power[0] = m_FftBuf[0].re*m_FftBuf[0].re + m_FftBuf[0].im*m_FftBuf[0].im;
+	m_Power[NR_BINS-1] = m_FftBuf[NR_HOP].re*m_FftBuf[NR_HOP].re + m_FftBuf[NR_HOP].im*m_FftBuf[NR_HOP].im;
+	for(int k=1; k<NR_BINS-1; k++)
+	{
+		TYPECPX a = m_FftBuf[k];
+		TYPECPX b = m_FftBuf[NR_FFT_SIZE-k];
+		m_Power[k] = 0.5*(a.re*a.re + a.im*a.im + b.re*b.re + b.im*b.im);
+	}
+	UpdateNoise();
+
+	//decision directed Wiener gain
+	for(int k=0; k<NR_BINS; k++)
+	{
+		TYPEREAL snr = m_Power[k]/(m_Noise[k] + 1e-20);
+		TYPEREAL x = snr - 1.0;
+		if(x < 0.0)
+			x = 0.0;
+		TYPEREAL xi = NR_DD_BETA*m_LastGain2[k]*m_LastSnr[k] + (1.0-NR_DD_BETA)*x;
+		TYPEREAL gain = xi/(1.0 + xi);
+		if(gain < m_GainMin)
+			gain = m_GainMin;
+		m_LastGain2[k] = gain*gain;
+		m_LastSnr[k] = snr;
+		m_FftBuf[k].re *= gain;
+		m_FftBuf[k].im *= gain;
+		if( (k > 0) && (k < NR_BINS-1) )
+		{
+			m_FftBuf[NR_FFT_SIZE-k].re *= gain;
+			m_FftBuf[NR_FFT_SIZE-k].im *= gain;
+		}
+	}
+
+	m_Fft.RevFFT(m_FftBuf);
+	//overlap-add with the synthesis window. The inverse FFT gain is N
+	const TYPEREAL scale = 1.0/NR_FFT_SIZE;
+	for(int i=0; i<NR_HOP; i++)
+	{
+		TYPEREAL w = m_Window[i]*scale;
+		m_OutBuf[i].re = m_Overlap[i].re + m_FftBuf[i].re*w;
+		m_OutBuf[i].im = m_Overlap[i].im + m_FftBuf[i].im*w;
+		w = m_Window[i+NR_HOP]*scale;
+		m_Overlap[i].re = m_FftBuf[i+NR_HOP].re*w;
+		m_Overlap[i].im = m_FftBuf[i+NR_HOP].im*w;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+//	Minimum statistics noise estimate from m_Power.
+// The minimum of the smoothed power is kept for NR_MINSTAT_SUBWIN
+//sub-windows so the estimate follows a rising noise floor within
+//NR_MINSTAT_TIME seconds.
+//////////////////////////////////////////////////////////////////////
+void CNoiseReduce::UpdateNoise()
+{
+	if(0 == m_NumFrames++)
+		memcpy(m_Smooth, m_Power, sizeof(m_Smooth));
+	const TYPEREAL a = m_SmoothAlpha;
+	for(int k=0; k<NR_BINS; k++)
+	{
+		TYPEREAL s = a*m_Smooth[k] + (1.0-a)*m_Power[k];
+		m_Smooth[k] = s;
+		if( (0 == m_FrameCount) || (s < m_MinCur[k]) )
+			m_MinCur[k] = s;
+		TYPEREAL min = m_MinCur[k];
+		if(m_MinPast[k] < min)
+			min = m_MinPast[k];
+		m_Noise[k] = NR_MINSTAT_BIAS*min;
+	}
+	if(++m_FrameCount >= m_SubWinFrames)
+	{	//end of sub-window so save its minimum and update the past minimum
+		memcpy(m_MinSub[m_SubWinPos], m_MinCur, sizeof(m_MinCur));
+		if(++m_SubWinPos >= NR_MINSTAT_SUBWIN)
+			m_SubWinPos = 0;
+		for(int k=0; k<NR_BINS; k++)
+		{
+			TYPEREAL min = m_MinSub[0][k];
+			for(int j=1; j<NR_MINSTAT_SUBWIN; j++)
+			{
+				if(m_MinSub[j][k] < min)
+					min = m_MinSub[j][k];
+			}
+			m_MinPast[k] = min;
+		}
+		m_FrameCount = 0;
+	}
+}
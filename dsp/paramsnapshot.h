@@ -0,0 +1,90 @@
+/////////////////////////////////////////////////////////////////////
+// paramsnapshot.h  CParamSnapshot template class.
+//This class passes a parameter struct from a control thread to the DSP
+//thread without a lock.  It is a triple buffer.  The writer fills its own
+//slot and swaps it with the middle slot, the reader swaps its slot with the
+//middle slot only when a newer one was published.  So the reader always has
+//a complete struct that the writer never touches and a setter never waits
+//for a block of DSP to finish.
+// Only one thread at a time may call the writer functions Publish() and
+//Published(), and only one thread at a time may call the reader functions
+//Update() and Get().  Callers serialize each side with their own lock if
+//more than one thread uses it.
+// History:
+//	2026-10-18  Initial creation
+/////////////////////////////////////////////////////////////////////
+//==========================================================================================
+// + + +   This Software is released under the "Simplified BSD License"  + + +
+//Copyright 2010 Moe Wheatley. All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification, are
+//permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice, this list of
+//	  conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice, this list
+//	  of conditions and the following disclaimer in the documentation and/or other materials
+//	  provided with the distribution.
+//
+//THIS SOFTWARE IS PROVIDED BY Moe Wheatley ``AS IS'' AND ANY EXPRESS OR IMPLIED
+//WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+//FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Moe Wheatley OR
+//CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+//ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+//ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//The views and conclusions contained in the software and documentation are those of the
+//authors and should not be interpreted as representing official policies, either expressed
+//or implied, of Moe Wheatley.
+//==========================================================================================
+#ifndef PARAMSNAPSHOT_H
+#define PARAMSNAPSHOT_H
+
+#include <QAtomicInt>
+
+#define SNAP_INDEX 3	//slot index bits of m_State
+#define SNAP_NEW 4		//set in m_State when the middle slot has not been read
+
+template <class T>
+class CParamSnapshot
+{
+public:
+	//publish and Update() an initial value before the reader starts
+	CParamSnapshot(){m_Write = 0; m_State = 1; m_Read = 2;}
+
+	//Writer: makes a copy of Params the latest snapshot
+	void Publish(const T& Params)
+	{
+		m_Published = Params;
+		m_Buf[m_Write] = Params;
+		m_Write = m_State.fetchAndStoreOrdered(m_Write | SNAP_NEW) & SNAP_INDEX;
+	}
+	//Writer: the last struct passed to Publish() for read-modify-publish
+	const T& Published() const {return m_Published;}
+
+	//Reader: picks up the latest snapshot if one was published since the
+	// last call.  Returns true if Get() changed.
+	bool Update()
+	{
+		if( !(m_State.loadAcquire() & SNAP_NEW) )
+			return false;
+		m_Read = m_State.fetchAndStoreOrdered(m_Read) & SNAP_INDEX;
+		return true;
+	}
+	//Reader: the snapshot picked up by the last Update()
+	const T& Get() const {return m_Buf[m_Read];}
+
+private:
+	int m_Write;			//slot owned by the writer
+	T m_Published;
+	char m_Pad[64];			//keep the writer and reader data on separate cache lines
+	QAtomicInt m_State;		//middle slot index and SNAP_NEW
+	int m_Read;				//slot owned by the reader
+	T m_Buf[3];
+};
+
+#endif // PARAMSNAPSHOT_H
@@ -0,0 +1,678 @@
+//////////////////////////////////////////////////////////////////////
+// polyphasefir.cpp: implementation of the polyphase FIR decimator and
+//  interpolator classes.
+//
+//  The decimator keeps a flat delay line and slides a window of NumTaps
+// samples through it M samples at a time so only the kept outputs are
+// calculated. The interpolator splits the prototype filter into L
+// sub-filters so the zero stuffed input samples are never multiplied.
+// Both keep the I and Q data in separate flat arrays so the inner loop is a
+// plain dot product that runs in SIMD registers(see simdops.h).
+//
+//Filter coefficients are designed with the same Kaiser-Bessel windowed sinc
+// algorithm used by CFir.
+//
+// History:
+//	2026-10-18  Initial creation
+//	2026-10-18  Multistage Init() with unchanged parameters only resets the stages
+//	2026-10-18  Classes are templated on precision, float and double versions are built
+//	2026-10-18  Added Swap() to put stages built on another thread in use
+//////////////////////////////////////////////////////////////////////
+//==========================================================================================
+// + + +   This Software is released under the "Simplified BSD License"  + + +
+//Copyright 2010 Moe Wheatley. All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification, are
+//permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice, this list of
+//	  conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice, this list
+//	  of conditions and the following disclaimer in the documentation and/or other materials
+//	  provided with the distribution.
+//
+//THIS SOFTWARE IS PROVIDED BY Moe Wheatley ``AS IS'' AND ANY EXPRESS OR IMPLIED
+//WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+//FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Moe Wheatley OR
+//CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+//ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+//ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//The views and conclusions contained in the software and documentation are those of the
+//authors and should not be interpreted as representing official policies, either expressed
+//or implied, of Moe Wheatley.
+//==========================================================================================
+#include "dsp/polyphasefir.h"
+#include "dsp/simdops.h"
+#include <string.h>
+#include <QDebug>
+
+//////////////////////////////////////////////////////////////////////
+// Local Defines
+//////////////////////////////////////////////////////////////////////
+#define POLYPHASE_BLOCKSIZE 4096	//input samples copied into delay line per pass
+#define POLYPHASE_BUFSIZE (POLYPHASE_BLOCKSIZE + MAX_POLYPHASE_TAPS)
+
+///////////////////////////////////////////////////////////////////////////
+// helper function to Compute Modified Bessel function I0(x)
+//     using a series approximation.
+// I0(x) = 1.0 + { sum from k=1 to infinity ---->  [(x/2)^k / k!]^2 }
+///////////////////////////////////////////////////////////////////////////
+template <typename T>
+static T Izero(T x)
+{
+T x2 = x/2.0;
+T sum = 1.0;
+T ds = 1.0;
+T di = 1.0;
+T errorlimit = 1e-9;
+T tmp;
+	do
+	{
+		tmp = x2/di;
+		tmp *= tmp;
+		ds *= tmp;
+		sum += ds;
+		di += 1.0;
+	}while(ds >= errorlimit*sum);
+	return(sum);
+}
+
+////////////////////////////////////////////////////////////////////
+// Designs a Kaiser-Bessel windowed sinc Low Pass filter into pCoef[]
+// with linear amplitude 'Scale' and returns the number of taps used.
+// Same design procedure as CFir::InitLPFilter() but without its
+// MAX_NUMCOEF limit.
+////////////////////////////////////////////////////////////////////
+template <typename T>
+static int DesignLPFilter(T* pCoef, T Scale, T Astop, T Fpass,
+						  T Fstop, T Fsamprate)
+{
+T Beta;
+	int NumTaps = CMultiStageDecimateT<T>::EstimateTaps(Astop, Fpass, Fstop, Fsamprate);
+	T normFcut = ( (Fstop + Fpass)/2.0 )/Fsamprate;	//low pass filter 6dB cutoff
+
+	//calculate Kaiser-Bessel window shape factor, Beta, from stopband attenuation
+	if(Astop < 20.96)
+		Beta = 0;
+	else if(Astop >= 50.0)
+		Beta = .1102 * (Astop - 8.71);
+	else
+		Beta = .5842 * tPrecision<T>::Pow( (Astop-20.96), 0.4) + .07886 * (Astop - 20.96);
+
+	T fCenter = .5*(T)(NumTaps-1);
+	T izb = Izero(Beta);
+	for(int n=0; n<NumTaps; n++)
+	{
+		T x = (T)n - fCenter;
+		T c;
+		if( (T)n == fCenter )	//deal with odd size filter singularity where sin(0)/0==1
+			c = 2.0 * normFcut;
+		else
+			c = tPrecision<T>::Sin(K_2PI*x*normFcut)/(K_PI*x);
+		x = x/fCenter;
+		pCoef[n] = Scale * c * Izero( Beta * tPrecision<T>::Sqrt(1 - (x*x) ) ) / izb;
+	}
+	return NumTaps;
+}
+
+// *&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*
+//						Class to do decimation by M
+// *&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*
+
+template <typename T>
+CDecimateByMT<T>::CDecimateByMT()
+{
+	m_pCoef = new T[MAX_POLYPHASE_TAPS];
+	m_pZRe = new T[POLYPHASE_BUFSIZE];
+	m_pZIm = new T[POLYPHASE_BUFSIZE];
+	m_M = 1;
+	m_NumTaps = 1;
+	m_pCoef[0] = 1.0;
+	Reset();
+}
+
+template <typename T>
+CDecimateByMT<T>::~CDecimateByMT()
+{
+	delete [] m_pCoef;
+	delete [] m_pZRe;
+	delete [] m_pZIm;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Designs a Kaiser-Bessel low pass decimation filter with stopband
+//attenuation Astop(dB) and pass/stop band edges Fpass/Fstop in Hz at
+//input rate Fsamprate.  Returns the number of taps used.
+//////////////////////////////////////////////////////////////////////
+template <typename T>
+int CDecimateByMT<T>::InitLPFilter(int M, T Astop, T Fpass, T Fstop, T Fsamprate)
+{
+T Coef[MAX_POLYPHASE_TAPS];
+	int NumTaps = DesignLPFilter<T>(Coef, 1.0, Astop, Fpass, Fstop, Fsamprate);
+	InitConstFir(M, NumTaps, Coef);
+	return m_NumTaps;
+}
+
+//////////////////////////////////////////////////////////////////////
+//  Initializes the decimator with a fixed coefficient table
+//////////////////////////////////////////////////////////////////////
+template <typename T>
+void CDecimateByMT<T>::InitConstFir(int M, int NumTaps, const T* pCoef)
+{
+	if(NumTaps > MAX_POLYPHASE_TAPS)
+		NumTaps = MAX_POLYPHASE_TAPS;
+	if(M < 1)
+		M = 1;
+	m_M = M;
+	m_NumTaps = NumTaps;
+	//store time reversed so the inner loop runs forward through both arrays
+	for(int i=0; i<m_NumTaps; i++)
+		m_pCoef[i] = pCoef[m_NumTaps-1-i];
+	Reset();
+}
+
+//////////////////////////////////////////////////////////////////////
+// Clears the delay line
+//////////////////////////////////////////////////////////////////////
+template <typename T>
+void CDecimateByMT<T>::Reset()
+{
+	for(int i=0; i<m_NumTaps-1; i++)
+	{
+		m_pZRe[i] = 0.0;
+		m_pZIm[i] = 0.0;
+	}
+	m_ZLength = m_NumTaps-1;
+	m_ZPos = 0;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Moves the samples still needed by future output windows to the
+//beginning of the delay line.
+//////////////////////////////////////////////////////////////////////
+template <typename T>
+void CDecimateByMT<T>::ShiftHistory()
+{
+	int n = m_ZLength - m_ZPos;
+	if(n > 0)
+	{
+		memmove(m_pZRe, m_pZRe + m_ZPos, n*sizeof(T));
+		memmove(m_pZIm, m_pZIm + m_ZPos, n*sizeof(T));
+		m_ZLength = n;
+		m_ZPos = 0;
+	}
+	else
+	{	//next window starts past the end of the data we have
+		m_ZPos = -n;
+		m_ZLength = 0;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+// Filter and decimate by M.
+// InLength does not have to be a multiple of M, the output phase
+//is kept across calls.  Returns number of output samples.
+//REAL version
+//////////////////////////////////////////////////////////////////////
+template <typename T>
+int CDecimateByMT<T>::ProcessData(int InLength, T* pInData, T* pOutData)
+{
+int numout = 0;
+	while(InLength > 0)
+	{
+		int n = POLYPHASE_BUFSIZE - m_ZLength;
+		if(n > InLength)
+			n = InLength;
+		memcpy(m_pZRe + m_ZLength, pInData, n*sizeof(T));
+		m_ZLength += n;
+		pInData += n;
+		InLength -= n;
+		while( (m_ZPos + m_NumTaps) <= m_ZLength )
+		{
+			pOutData[numout++] = SimdDotProduct(m_pZRe + m_ZPos, m_pCoef, m_NumTaps);
+			m_ZPos += m_M;
+		}
+		ShiftHistory();
+	}
+	return numout;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Filter and decimate by M.
+// InLength does not have to be a multiple of M, the output phase
+//is kept across calls.  Returns number of output samples.
+//COMPLEX version
+//////////////////////////////////////////////////////////////////////
+template <typename T>
+int CDecimateByMT<T>::ProcessData(int InLength, Cpx* pInData, Cpx* pOutData)
+{
+int numout = 0;
+	while(InLength > 0)
+	{
+		int n = POLYPHASE_BUFSIZE - m_ZLength;
+		if(n > InLength)
+			n = InLength;
+		T* pRe = m_pZRe + m_ZLength;
+		T* pIm = m_pZIm + m_ZLength;
+		for(int i=0; i<n; i++)
+		{	//split into I and Q planes
+			pRe[i] = pInData[i].re;
+			pIm[i] = pInData[i].im;
+		}
+		m_ZLength += n;
+		pInData += n;
+		InLength -= n;
+		while( (m_ZPos + m_NumTaps) <= m_ZLength )
+		{
+			SimdDotProduct2(m_pZRe + m_ZPos, m_pZIm + m_ZPos, m_pCoef, m_NumTaps,
+							pOutData[numout].re, pOutData[numout].im);
+			numout++;
+			m_ZPos += m_M;
+		}
+		ShiftHistory();
+	}
+	return numout;
+}
+
+// *&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*
+//						Class to do interpolation by L
+// *&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*
+
+template <typename T>
+CInterpolateByLT<T>::CInterpolateByLT()
+{
+	m_pCoef = new T[MAX_POLYPHASE_TAPS];
+	m_pZRe = new T[POLYPHASE_BUFSIZE];
+	m_pZIm = new T[POLYPHASE_BUFSIZE];
+	m_L = 1;
+	m_PhaseLength = 1;
+	m_pCoef[0] = 1.0;
+	Reset();
+}
+
+template <typename T>
+CInterpolateByLT<T>::~CInterpolateByLT()
+{
+	delete [] m_pCoef;
+	delete [] m_pZRe;
+	delete [] m_pZIm;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Designs a Kaiser-Bessel low pass interpolation filter at the output
+//sample rate.  Returns the total number of prototype taps.
+//////////////////////////////////////////////////////////////////////
+template <typename T>
+int CInterpolateByLT<T>::InitLPFilter(int L, T Astop, T Fpass, T Fstop, T OutSamprate)
+{
+T Coef[MAX_POLYPHASE_TAPS];
+	int NumTaps = DesignLPFilter<T>(Coef, 1.0, Astop, Fpass, Fstop, OutSamprate);
+	InitConstFir(L, NumTaps, Coef);
+	return NumTaps;
+}
+
+//////////////////////////////////////////////////////////////////////
+//  Initializes the interpolator from a prototype low pass filter
+//designed at the output rate.  The prototype is split into L
+//sub-filters and scaled by L to make up for the zero stuffing loss.
+//////////////////////////////////////////////////////////////////////
+template <typename T>
+void CInterpolateByLT<T>::InitConstFir(int L, int NumTaps, const T* pCoef)
+{
+	if(NumTaps > MAX_POLYPHASE_TAPS)
+		NumTaps = MAX_POLYPHASE_TAPS;
+	if(L < 1)
+		L = 1;
+	m_L = L;
+	m_PhaseLength = (NumTaps + L - 1)/L;
+	if(m_PhaseLength*L > MAX_POLYPHASE_TAPS)
+		m_PhaseLength = MAX_POLYPHASE_TAPS/L;
+	for(int p=0; p<m_L; p++)
+	{	//sub-filter p uses taps p, p+L, p+2L... stored time reversed
+		for(int k=0; k<m_PhaseLength; k++)
+		{
+			int tap = p + k*m_L;
+			m_pCoef[p*m_PhaseLength + (m_PhaseLength-1-k)] =
+					(tap < NumTaps) ? (T)m_L*pCoef[tap] : 0.0;
+		}
+	}
+	Reset();
+}
+
+//////////////////////////////////////////////////////////////////////
+// Clears the delay line
+//////////////////////////////////////////////////////////////////////
+template <typename T>
+void CInterpolateByLT<T>::Reset()
+{
+	for(int i=0; i<m_PhaseLength-1; i++)
+	{
+		m_pZRe[i] = 0.0;
+		m_pZIm[i] = 0.0;
+	}
+	m_ZLength = m_PhaseLength-1;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Keeps the last m_PhaseLength-1 samples for the next block
+//////////////////////////////////////////////////////////////////////
+template <typename T>
+void CInterpolateByLT<T>::ShiftHistory()
+{
+	int n = m_PhaseLength-1;
+	int start = m_ZLength - n;
+	memmove(m_pZRe, m_pZRe + start, n*sizeof(T));
+	memmove(m_pZIm, m_pZIm + start, n*sizeof(T));
+	m_ZLength = n;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Interpolate InLength input samples by L.
+// Returns number of output samples(InLength*L)
+//REAL version
+//////////////////////////////////////////////////////////////////////
+template <typename T>
+int CInterpolateByLT<T>::ProcessData(int InLength, T* pInData, T* pOutData)
+{
+int numout = 0;
+	while(InLength > 0)
+	{
+		int n = POLYPHASE_BUFSIZE - m_ZLength;
+		if(n > InLength)
+			n = InLength;
+		memcpy(m_pZRe + m_ZLength, pInData, n*sizeof(T));
+		for(int i=0; i<n; i++)
+		{
+			const T* pZ = m_pZRe + m_ZLength - m_PhaseLength + 1 + i;
+			const T* pH = m_pCoef;
+			for(int p=0; p<m_L; p++, pH += m_PhaseLength)
+				pOutData[numout++] = SimdDotProduct(pZ, pH, m_PhaseLength);
+		}
+		m_ZLength += n;
+		pInData += n;
+		InLength -= n;
+		ShiftHistory();
+	}
+	return numout;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Interpolate InLength input samples by L.
+// Returns number of output samples(InLength*L)
+//COMPLEX version
+//////////////////////////////////////////////////////////////////////
+template <typename T>
+int CInterpolateByLT<T>::ProcessData(int InLength, Cpx* pInData, Cpx* pOutData)
+{
+int numout = 0;
+	while(InLength > 0)
+	{
+		int n = POLYPHASE_BUFSIZE - m_ZLength;
+		if(n > InLength)
+			n = InLength;
+		T* pRe = m_pZRe + m_ZLength;
+		T* pIm = m_pZIm + m_ZLength;
+		for(int i=0; i<n; i++)
+		{	//split into I and Q planes
+			pRe[i] = pInData[i].re;
+			pIm[i] = pInData[i].im;
+		}
+		for(int i=0; i<n; i++)
+		{
+			int zpos = m_ZLength - m_PhaseLength + 1 + i;
+			const T* pH = m_pCoef;
+			for(int p=0; p<m_L; p++, pH += m_PhaseLength)
+			{
+				SimdDotProduct2(m_pZRe + zpos, m_pZIm + zpos, pH, m_PhaseLength,
+								pOutData[numout].re, pOutData[numout].im);
+				numout++;
+			}
+		}
+		m_ZLength += n;
+		pInData += n;
+		InLength -= n;
+		ShiftHistory();
+	}
+	return numout;
+}
+
+// *&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*
+//						Class to do multistage decimation by M
+// *&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*
+
+template <typename T>
+CMultiStageDecimateT<T>::CMultiStageDecimateT()
+{
+	m_M = 1;
+	m_MacsPerSample = 0.0;
+	m_Fpass = 0.0;
+	m_Astop = 0.0;
+	m_Fsamprate = 0.0;
+	for(int i=0; i<=MAX_POLYPHASE_STAGES; i++)
+		m_pStages[i] = NULL;
+}
+
+template <typename T>
+void CMultiStageDecimateT<T>::DeleteStages()
+{
+	for(int i=0; i<=MAX_POLYPHASE_STAGES; i++)
+	{
+		if(m_pStages[i])
+		{
+			delete m_pStages[i];
+			m_pStages[i] = NULL;
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+// Estimate number of Kaiser-Bessel filter taps required for
+// stopband attenuation Astop and transition band Fpass to Fstop
+//////////////////////////////////////////////////////////////////////
+template <typename T>
+int CMultiStageDecimateT<T>::EstimateTaps(T Astop, T Fpass, T Fstop, T Fsamprate)
+{
+	int NumTaps = (Astop - 8.0) / (2.285*K_2PI*(Fstop - Fpass)/Fsamprate) + 1;
+	if(NumTaps < 3)
+		NumTaps = 3;
+	if(NumTaps > MAX_POLYPHASE_TAPS)
+		NumTaps = MAX_POLYPHASE_TAPS;
+	return NumTaps;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Recursive helper for PlanStages() that tries every ordered
+//factorization of M and keeps the cheapest one.
+// Each stage must keep 0 to Fpass alias free so its stopband starts
+//at (stage output rate - Fpass).
+//////////////////////////////////////////////////////////////////////
+template <typename T>
+void CMultiStageDecimateT<T>::SearchPlans(int M, int Depth, T Rate, T Scale, T Cost,
+							T Fpass, T Astop, int* pFactors,
+							int* pBestFactors, int* pBestNum, T* pBestCost)
+{
+	if(1 == M)
+	{
+		if( Cost < *pBestCost )
+		{
+			*pBestCost = Cost;
+			*pBestNum = Depth;
+			for(int i=0; i<Depth; i++)
+				pBestFactors[i] = pFactors[i];
+		}
+		return;
+	}
+	if( (Depth >= MAX_POLYPHASE_STAGES) || (Cost >= *pBestCost) )
+		return;
+	for(int f=2; f<=M; f++)
+	{
+		if(M % f)
+			continue;
+		T OutRate = Rate/f;
+		T Fstop = OutRate - Fpass;
+		if(Fstop <= Fpass)
+			break;		//larger factors will be even worse
+		T Taps = (Astop - 8.0) / (2.285*K_2PI*(Fstop - Fpass)/Rate) + 1;
+		if(Taps > MAX_POLYPHASE_TAPS)
+			continue;
+		pFactors[Depth] = f;
+		SearchPlans(M/f, Depth+1, OutRate, Scale/f, Cost + Scale*Taps/f,
+					Fpass, Astop, pFactors, pBestFactors, pBestNum, pBestCost);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+// Finds the cheapest cascade of decimation factors whose product is M
+//that keeps 0 to Fpass alias free with Astop dB of rejection.
+// Fills pFactors[] (at least MAX_POLYPHASE_STAGES long) and *pNumStages
+//and returns the estimated number of multiplies per input sample
+//or -1 if no valid plan exists.
+//////////////////////////////////////////////////////////////////////
+template <typename T>
+T CMultiStageDecimateT<T>::PlanStages(int M, T Fpass, T Astop, T Fsamprate,
+							   int* pFactors, int* pNumStages)
+{
+int Factors[MAX_POLYPHASE_STAGES];
+T BestCost = 1e30;
+	*pNumStages = 0;
+	if(M <= 1)
+		return 0.0;
+	SearchPlans(M, 0, Fsamprate, 1.0, 0.0, Fpass, Astop, Factors, pFactors, pNumStages, &BestCost);
+	if(0 == *pNumStages)
+		return -1.0;
+	return BestCost;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Swaps the stages and Init() parameters with Other.  Lets a control
+//thread Init() the stages and the DSP thread put them in use without
+//allocating.  The stages swapped out get deleted with Other.
+//////////////////////////////////////////////////////////////////////
+template <typename T>
+void CMultiStageDecimateT<T>::Swap(CMultiStageDecimateT& Other)
+{
+	for(int i=0; i<=MAX_POLYPHASE_STAGES; i++)
+	{
+		CDecimateByMT<T>* pStage = m_pStages[i];
+		m_pStages[i] = Other.m_pStages[i];
+		Other.m_pStages[i] = pStage;
+	}
+	int M = m_M;
+	m_M = Other.m_M;
+	Other.m_M = M;
+	T Tmp = m_MacsPerSample;
+	m_MacsPerSample = Other.m_MacsPerSample;
+	Other.m_MacsPerSample = Tmp;
+	Tmp = m_Fpass;
+	m_Fpass = Other.m_Fpass;
+	Other.m_Fpass = Tmp;
+	Tmp = m_Astop;
+	m_Astop = Other.m_Astop;
+	Other.m_Astop = Tmp;
+	Tmp = m_Fsamprate;
+	m_Fsamprate = Other.m_Fsamprate;
+	Other.m_Fsamprate = Tmp;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Plans and creates the decimation stages for decimating by M with
+//0 to Fpass Hz alias free by Astop dB.  If Fpass is too wide for the
+//output rate it is reduced to 40% of the output rate.
+//Returns the estimated multiplies per input sample.
+// If the parameters are unchanged the stages are only reset so
+//nothing is allocated.
+//////////////////////////////////////////////////////////////////////
+template <typename T>
+T CMultiStageDecimateT<T>::Init(int M, T Fpass, T Astop, T Fsamprate)
+{
+int Factors[MAX_POLYPHASE_STAGES];
+int NumStages;
+	if( (M == m_M) && (Fpass == m_Fpass) && (Astop == m_Astop) && (Fsamprate == m_Fsamprate) )
+	{
+		for(int i=0; m_pStages[i]; i++)
+			m_pStages[i]->Reset();
+		return m_MacsPerSample;
+	}
+	DeleteStages();
+	m_M = M;
+	m_Fpass = Fpass;
+	m_Astop = Astop;
+	m_Fsamprate = Fsamprate;
+	m_MacsPerSample = 0.0;
+	if(M <= 1)
+		return m_MacsPerSample;
+	if( Fpass > (.4*Fsamprate/M) )
+		Fpass = .4*Fsamprate/M;
+	m_MacsPerSample = PlanStages(M, Fpass, Astop, Fsamprate, Factors, &NumStages);
+	if(m_MacsPerSample < 0.0)
+	{	//can't meet spec so fall back to one long filter
+		Factors[0] = M;
+		NumStages = 1;
+	}
+	T Rate = Fsamprate;
+	T Scale = 1.0;
+	m_MacsPerSample = 0.0;
+	for(int i=0; i<NumStages; i++)
+	{
+		m_pStages[i] = new CDecimateByMT<T>;
+		T OutRate = Rate/Factors[i];
+		int taps = m_pStages[i]->InitLPFilter(Factors[i], Astop, Fpass, OutRate - Fpass, Rate);
+		m_MacsPerSample += Scale*(T)taps/(T)Factors[i];
+		Scale /= Factors[i];
+		Rate = OutRate;
+	}
+qDebug()<<"MultiStage Decimate M="<<M<<" Stages="<<NumStages<<" MACs/Samp="<<m_MacsPerSample;
+	return m_MacsPerSample;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Run all stages, returns number of output samples
+//REAL version
+//////////////////////////////////////////////////////////////////////
+template <typename T>
+int CMultiStageDecimateT<T>::ProcessData(int InLength, T* pInData, T* pOutData)
+{
+	if(NULL == m_pStages[0])
+	{
+		if(pInData != pOutData)
+			memcpy(pOutData, pInData, InLength*sizeof(T));
+		return InLength;
+	}
+	InLength = m_pStages[0]->ProcessData(InLength, pInData, pOutData);
+	for(int i=1; m_pStages[i]; i++)
+		InLength = m_pStages[i]->ProcessData(InLength, pOutData, pOutData);
+	return InLength;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Run all stages, returns number of output samples
+//COMPLEX version
+//////////////////////////////////////////////////////////////////////
+template <typename T>
+int CMultiStageDecimateT<T>::ProcessData(int InLength, Cpx* pInData, Cpx* pOutData)
+{
+	if(NULL == m_pStages[0])
+	{
+		if(pInData != pOutData)
+			memcpy(pOutData, pInData, InLength*sizeof(Cpx));
+		return InLength;
+	}
+	InLength = m_pStages[0]->ProcessData(InLength, pInData, pOutData);
+	for(int i=1; m_pStages[i]; i++)
+		InLength = m_pStages[i]->ProcessData(InLength, pOutData, pOutData);
+	return InLength;
+}
+
+
+//float and double versions of the polyphase filters
+template class CDecimateByMT<tSReal>;
+template class CDecimateByMT<tDReal>;
+template class CInterpolateByLT<tSReal>;
+template class CInterpolateByLT<tDReal>;
+template class CMultiStageDecimateT<tSReal>;
+template class CMultiStageDecimateT<tDReal>;
@@ -0,0 +1,161 @@
+//////////////////////////////////////////////////////////////////////
+// polyphasefir.h: interface for the polyphase FIR decimator and
+//  interpolator classes.
+//
+//  CDecimateByM  filters and decimates by any integer factor M computing
+//		only the output samples that are kept.
+//  CInterpolateByL  interpolates by any integer factor L using L
+//		polyphase sub-filters so the zero stuffed samples are never multiplied.
+//  CMultiStageDecimate  splits a large decimation factor into a cascade of
+//		CDecimateByM stages picked by a simple cost model.
+//
+// History:
+//	2026-10-18  Initial creation
+//	2026-10-18  Multistage Init() with unchanged parameters only resets the stages
+//	2026-10-18  Classes are templated on precision, float and double versions are built
+//	2026-10-18  Added Swap() to put stages built on another thread in use
+//////////////////////////////////////////////////////////////////////
+//==========================================================================================
+// + + +   This Software is released under the "Simplified BSD License"  + + +
+//Copyright 2010 Moe Wheatley. All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification, are
+//permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice, this list of
+//	  conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice, this list
+//	  of conditions and the following disclaimer in the documentation and/or other materials
+//	  provided with the distribution.
+//
+//THIS SOFTWARE IS PROVIDED BY Moe Wheatley ``AS IS'' AND ANY EXPRESS OR IMPLIED
+//WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+//FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Moe Wheatley OR
+//CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+//ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+//ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//The views and conclusions contained in the software and documentation are those of the
+//authors and should not be interpreted as representing official policies, either expressed
+//or implied, of Moe Wheatley.
+//=============================================================================
+#ifndef POLYPHASEFIR_H
+#define POLYPHASEFIR_H
+
+#include "dsp/datatypes.h"
+
+#define MAX_POLYPHASE_TAPS 512		//maximum FIR length of any one stage
+#define MAX_POLYPHASE_STAGES 6		//maximum number of stages a multistage decimator is split into
+
+////////////
+//class for a decimate by M FIR filter. T is the sample type, tSReal or tDReal.
+////////////
+template <typename T>
+class CDecimateByMT
+{
+public:
+	typedef typename tPrecision<T>::Cpx Cpx;
+	CDecimateByMT();
+	~CDecimateByMT();
+
+	int InitLPFilter(int M, T Astop, T Fpass, T Fstop, T Fsamprate);
+	void InitConstFir(int M, int NumTaps, const T* pCoef);
+	void Reset();
+	int GetDecimation(){return m_M;}
+	int GetNumTaps(){return m_NumTaps;}
+
+	//pOutData may be the same buffer as pInData
+	int ProcessData(int InLength, T* pInData, T* pOutData);
+	int ProcessData(int InLength, Cpx* pInData, Cpx* pOutData);
+
+private:
+	void ShiftHistory();
+	int m_M;
+	int m_NumTaps;
+	int m_ZLength;		//number of samples in m_pZRe/m_pZIm
+	int m_ZPos;			//start of next output window in m_pZRe/m_pZIm
+	T* m_pCoef;	//time reversed coefficients
+	T* m_pZRe;	//flat delay line (I or real data)
+	T* m_pZIm;	//flat delay line (Q data)
+};
+
+typedef CDecimateByMT<TYPEREAL> CDecimateByM;
+
+////////////
+//class for an interpolate by L FIR filter. T is the sample type, tSReal or tDReal.
+////////////
+template <typename T>
+class CInterpolateByLT
+{
+public:
+	typedef typename tPrecision<T>::Cpx Cpx;
+	CInterpolateByLT();
+	~CInterpolateByLT();
+
+	int InitLPFilter(int L, T Astop, T Fpass, T Fstop, T OutSamprate);
+	void InitConstFir(int L, int NumTaps, const T* pCoef);
+	void Reset();
+	int GetInterpolation(){return m_L;}
+
+	//returns InLength*L samples. pOutData must not be the same buffer as pInData
+	int ProcessData(int InLength, T* pInData, T* pOutData);
+	int ProcessData(int InLength, Cpx* pInData, Cpx* pOutData);
+
+private:
+	void ShiftHistory();
+	int m_L;
+	int m_PhaseLength;	//taps per polyphase sub-filter
+	int m_ZLength;
+	T* m_pCoef;	//L time reversed sub-filters of m_PhaseLength taps each
+	T* m_pZRe;
+	T* m_pZIm;
+};
+
+typedef CInterpolateByLT<TYPEREAL> CInterpolateByL;
+
+////////////
+//class for a multistage decimate by M FIR filter. T is the sample type, tSReal or tDReal.
+////////////
+template <typename T>
+class CMultiStageDecimateT
+{
+public:
+	typedef typename tPrecision<T>::Cpx Cpx;
+	CMultiStageDecimateT();
+	~CMultiStageDecimateT(){DeleteStages();}
+
+	T Init(int M, T Fpass, T Astop, T Fsamprate);
+	//swaps stages and Init() parameters with Other without allocating
+	void Swap(CMultiStageDecimateT& Other);
+	int GetDecimation(){return m_M;}
+	T GetMacsPerSample(){return m_MacsPerSample;}
+
+	//pOutData may be the same buffer as pInData
+	int ProcessData(int InLength, T* pInData, T* pOutData);
+	int ProcessData(int InLength, Cpx* pInData, Cpx* pOutData);
+
+	static T PlanStages(int M, T Fpass, T Astop, T Fsamprate,
+							   int* pFactors, int* pNumStages);
+	static int EstimateTaps(T Astop, T Fpass, T Fstop, T Fsamprate);
+
+private:
+	void DeleteStages();
+	static void SearchPlans(int M, int Depth, T Rate, T Scale, T Cost,
+							T Fpass, T Astop, int* pFactors,
+							int* pBestFactors, int* pBestNum, T* pBestCost);
+	int m_M;
+	T m_MacsPerSample;
+	T m_Fpass;		//Init() parameters of the current stages
+	T m_Astop;
+	T m_Fsamprate;
+	//NULL terminated array of stages
+	CDecimateByMT<T>* m_pStages[MAX_POLYPHASE_STAGES+1];
+};
+
+typedef CMultiStageDecimateT<TYPEREAL> CMultiStageDecimate;
+
+#endif // POLYPHASEFIR_H
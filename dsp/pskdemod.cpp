@@ -4,6 +4,7 @@
 // PSK demodulation
 // History:
 //	2015-02-25  Initial creation MSW
+//	2026-10-18  Split symbol decoding into CPskDecoder for multi-channel use
 //////////////////////////////////////////////////////////////////////
 //==========================================================================================
 // + + +   This Software is released under the "Simplified BSD License"  + + +
@@ -68,22 +69,13 @@ CPskDemod::~CPskDemod()
 void CPskDemod::SetPskParams(TYPEREAL InSampleRate, TYPEREAL SymbRate, int Mode)
 {
 	m_PskMode = Mode;
+	m_InSampleRate = InSampleRate;
 //calculate integer N to get close to 500Hz sample rate
 	m_DecRate = (int)(InSampleRate/500.0 + 0.5);
-	//calc actual sample rate after integer decimation
-	m_SampleRate = InSampleRate/(TYPEREAL)m_DecRate;
 	m_DecCnt = 0;
-qDebug()<<"InSample rate = "<<InSampleRate<< "PSKSample rate = "<<m_SampleRate;
-//create bit filter as LP filter with passband ~Symbol rate(not perfect but is close)
-	int taps = m_BitFir.InitLPFilter(0, 1.0, 60.0, SymbRate/2.0, SymbRate, m_SampleRate);//initialize BIT FIR filter
-qDebug()<<"PSK Bit rate, taps = "<<SymbRate << taps;
-//create AFC filter as LP filter with passband ~2*Symbol Rate
-	taps = m_FreqFir.InitLPFilter(0, 1.0, 30.0, SymbRate, SymbRate*2.0, m_SampleRate);//initialize LP AFC FIR filter
-qDebug()<<"Freq FIR taps = "<< taps;
-	m_PrevSymbol.re = 0.0;
-	m_PrevSymbol.im = 0.0;
-//create Hi-Q resonator at the symbol rate to recover bit sync position
-	m_BitSyncFilter.InitBP(SymbRate, 150, m_SampleRate);
+qDebug()<<"InSample rate = "<<InSampleRate<< "PSKSample rate = "<<InSampleRate/(TYPEREAL)m_DecRate;
+	//calc actual sample rate after integer decimation
+	m_Decoder.Init(InSampleRate/(TYPEREAL)m_DecRate, SymbRate);
 
 //create fixed digital sin/cos oscillator to shift baseband psk to soundcard audio out for monitoring
 	m_NcoInc = K_2PI*OUT_AUDIO_SHIFT/(InSampleRate);
@@ -91,20 +83,8 @@ qDebug()<<"Freq FIR taps = "<< taps;
 	m_OscSin = MSIN(m_NcoInc);
 	m_Osc1.re = 1.0;	//initialize unit vector that will get rotated
 	m_Osc1.im = 0.0;
-//init a bunch of internal variables
 	m_NcoPhase = 0.0;
-	m_WFerrAve = 0.0;
-	m_NFerrAve = 0.0;
 	m_FreqError = 0.0;
-	m_IntegralFerr = 0.0;
-	m_z1.re = 0.0; m_z1.im = 0.0;
-	m_z2.re = 0.0; m_z2.im = 0.0;
-
-	m_AveMag = 0.0;
-	m_AveEnergy =0.0;
-	m_LastBitMag = 0.0;
-	m_LastSyncSlope = 0.0;
-
 }
 
 /////////////////////////////////////////////////////////////////////////////////
@@ -153,55 +133,124 @@ int length = 0;
 		//Cpx multiply by audio output shift frequency take only real
 		pOutData[i] = ((tmp.re * Osc.re) - (tmp.im * Osc.im));
 
-		//perform decimate by m_DecRate and normalize input data to about +/- 1.0
+		//perform decimate by m_DecRate
 		// !! input has to be BW limited by main filter ~ <200Hz so just take every m_DecRate samples !!
-		// in cutesdr input values are AGC'd but not normalized to 1.0 so do it here after decimation
 		if( ++m_DecCnt >= m_DecRate )
 		{
 			m_DecCnt = 0;
-			TYPEREAL p = sqrt( (tmp.re*tmp.re)+(tmp.im*tmp.im));
-			m_AveMag = (1.0-0.01)*m_AveMag + (0.01)*p;
-			if(m_AveMag>0.0)
-			{
-				pInData[length].re = pInData[i].re / m_AveMag;
-				pInData[length].im = pInData[i].im / m_AveMag;
-			}
-			length++;
+			pInData[length++] = tmp;
+		}
+	}
+	//decode the decimated I/Q data and send any characters to the chat dialog
+	for(int i=0; i<length; i+=PSK_DEC_BLOCK)
+	{
+		int n = length - i;
+		if(n > PSK_DEC_BLOCK)
+			n = PSK_DEC_BLOCK;
+		int NumChars = m_Decoder.ProcessData(n, &pInData[i], m_Chars);
+		for(int j=0; j<NumChars; j++)
+			emit g_pChatDialog->SendChatData(m_Chars[j]);
+	}
+	//scale AFC correction to NCO phase increment units
+	m_FreqError = -(K_2PI*m_Decoder.GetFreqError())/m_InSampleRate;
+	return InLength;	//length of monitor audio output samples
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//	Construct Psk decoder object
+/////////////////////////////////////////////////////////////////////////////////
+CPskDecoder::CPskDecoder()
+{
+	Init(500.0, 31.25);
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+/// Set decimated sample rate(~500Hz) and Symbol rate and reset the decoder
+/////////////////////////////////////////////////////////////////////////////////
+void CPskDecoder::Init(TYPEREAL SampleRate, TYPEREAL SymbRate)
+{
+	m_SampleRate = SampleRate;
+//create bit filter as LP filter with passband ~Symbol rate(not perfect but is close)
+	m_BitFir.InitLPFilter(0, 1.0, 60.0, SymbRate/2.0, SymbRate, m_SampleRate);//initialize BIT FIR filter
+//create AFC filter as LP filter with passband ~2*Symbol Rate
+	m_FreqFir.InitLPFilter(0, 1.0, 30.0, SymbRate, SymbRate*2.0, m_SampleRate);//initialize LP AFC FIR filter
+	m_PrevSymbol.re = 0.0;
+	m_PrevSymbol.im = 0.0;
+	m_PrevSample.re = 0.0;
+	m_PrevSample.im = 0.0;
+//create Hi-Q resonator at the symbol rate to recover bit sync position
+	m_BitSyncFilter.InitBP(SymbRate, 150, m_SampleRate);
+
+//init a bunch of internal variables
+	m_BitAcc = 0;
+	m_VericodeAcc = 0;
+	m_WFerrAve = 0.0;
+	m_NFerrAve = 0.0;
+	m_FreqError = 0.0;
+	m_IntegralFerr = 0.0;
+	m_z1.re = 0.0; m_z1.im = 0.0;
+	m_z2.re = 0.0; m_z2.im = 0.0;
+
+	m_AveMag = 0.0;
+	m_AveEnergy =0.0;
+	m_LastBitMag = 0.0;
+	m_LastSyncSlope = 0.0;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//	Decode up to PSK_DEC_BLOCK decimated samples
+/////////////////////////////////////////////////////////////////////////////////
+int CPskDecoder::ProcessData(int Length, TYPECPX* pData, quint8* pChars)
+{
+int NumChars = 0;
+	if(Length > PSK_DEC_BLOCK)
+		Length = PSK_DEC_BLOCK;
+	//normalize input data to about +/- 1.0
+	// in cutesdr input values are AGC'd but not normalized to 1.0 so do it here after decimation
+	for(int i=0; i<Length; i++)
+	{
+		TYPEREAL p = sqrt( (pData[i].re*pData[i].re)+(pData[i].im*pData[i].im));
+		m_AveMag = (1.0-0.01)*m_AveMag + (0.01)*p;
+		if(m_AveMag>0.0)
+		{
+			pData[i].re = pData[i].re / m_AveMag;
+			pData[i].im = pData[i].im / m_AveMag;
 		}
 	}
 	//perform AFC on decimated I/Q data
-	CalcAfc(length, pInData);
+	CalcAfc(Length, pData);
 	//perform narrow bit filtering
-	m_BitFir.ProcessFilter(length, pInData, pInData);
-g_pTestBench->DisplayData(length, 10000.0, pInData, m_SampleRate, PROFILE_3);
+	m_BitFir.ProcessFilter(Length, pData, pData);
 
 	//Generate bit magnitude array for getting bit sinc position
-	for(int i=0; i<length; i++)
-		m_BitMag[i] = fabs( pInData[i].re ) + fabs( pInData[i].im );
+	for(int i=0; i<Length; i++)
+		m_BitMag[i] = fabs( pData[i].re ) + fabs( pData[i].im );
 	//run Hi-Q resonator filter on mag data that creates a sin wave that will lock to BitRate clock
-	m_BitSyncFilter.ProcessFilter(length, m_BitMag, m_BitMag);
+	m_BitSyncFilter.ProcessFilter(Length, m_BitMag, m_BitMag);
 
 	//search through sync filter output looking for positive peak of sine wave position
-	for(int i=0; i<length; i++)
+	for(int i=0; i<Length; i++)
 	{
 		//the best bit sync position is at the positive peak of the m_BitMag waveform
 		TYPEREAL CurrentSlope = m_BitMag[i] - m_LastBitMag;	//current slope
 		//see if at the top peak of the sync waveform(slope changes from pos to neg)
 		if( (CurrentSlope < 0.0) && (m_LastSyncSlope >= 0.0) )
 		{	//are at sample time so use previous sample value as we are one sample behind in sync position
-			ManageSquelch( DecodeSymb(m_PrevSample) );
+			quint8 ch = ManageSquelch( DecodeSymb(m_PrevSample) );
+			if(ch != 0)
+				pChars[NumChars++] = ch;
 		}
 		m_LastBitMag = m_BitMag[i];		//save previous states
 		m_LastSyncSlope = CurrentSlope;
-		m_PrevSample = pInData[i];
+		m_PrevSample = pData[i];
 	}
-	return InLength;	//length of monitor audio output samples
+	return NumChars;
 }
 
 //////////////////////////////////////////////////////////////////////
 //  Manage AFC logic
 //////////////////////////////////////////////////////////////////////
-void CPskDemod::CalcAfc(int InLength, TYPECPX* pInData)
+void CPskDecoder::CalcAfc(int InLength, TYPECPX* pInData)
 {
 #define K_WGN (38.5)			//gain to make error in Hz
 #define WLP_K (.002)
@@ -243,15 +292,12 @@ TYPEREAL ferror;
 		m_FreqError = 20.0;
 	else if(m_FreqError < -20.0)
 		m_FreqError = -20.0;
-
-	//scale correction error to NCO phase increment units
-	m_FreqError = -(K_2PI*m_FreqError)/(m_SampleRate*m_DecRate);
 }
 
 //////////////////////////////////////////////////////////////////////
 //  Manage Squelch
 //////////////////////////////////////////////////////////////////////
-void CPskDemod::ManageSquelch(quint8 ch)
+quint8 CPskDecoder::ManageSquelch(quint8 ch)
 {
 	if(0x0000 == m_BitAcc)	//if idle state then force sq on
 		m_AveEnergy = 5.0;
@@ -260,14 +306,18 @@ void CPskDemod::ManageSquelch(quint8 ch)
 //qDebug()<<m_AveEnergy;
 	if(m_AveEnergy<SQ_THRESHOLD)
 		ch = 0;
-	if(ch != 0)
-		emit g_pChatDialog->SendChatData(ch);
+	return ch;
+}
+
+bool CPskDecoder::IsSquelchOpen()
+{
+	return m_AveEnergy >= SQ_THRESHOLD;
 }
 
 //////////////////////////////////////////////////////////////////////
 //  Decode the new symbol
 //////////////////////////////////////////////////////////////////////
-quint8 CPskDemod::DecodeSymb(TYPECPX newsymb)
+quint8 CPskDecoder::DecodeSymb(TYPECPX newsymb)
 {
 quint8 ch = 0;
 quint8 bit;
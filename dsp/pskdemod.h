@@ -3,6 +3,7 @@
 //
 // History:
 //	2015-02-19  Initial creation MSW
+//	2026-10-18  Split symbol decoding into CPskDecoder for multi-channel use
 /////////////////////////////////////////////////////////////////////
 //==========================================================================================
 // + + +   This Software is released under the "Simplified BSD License"  + + +
@@ -40,53 +41,81 @@
 #include "dsp/fir.h"
 #include "dsp/iir.h"
 
-class CPskDemod : public QObject
+#define PSK_DEC_BLOCK 128		//max decimated samples CPskDecoder processes at once
+
+////////////
+//Symbol recovery and varicode decoding of one PSK signal that has been
+//shifted to baseband and decimated to ~500Hz. Has no GUI or thread
+//dependencies so several can run at once.
+////////////
+class CPskDecoder
 {
-	Q_OBJECT
 public:
-	explicit CPskDemod();
-	~CPskDemod();
-	void SetPskParams(TYPEREAL InSampleRate, TYPEREAL SymbRate, int Mode);
-	//overloaded functions for mono and stereo audio out
-	int ProcessData(int InLength, TYPECPX* pInData, TYPEREAL* pOutData);
-	int ProcessData(int InLength, TYPECPX* pInData, TYPECPX* pOutData);
-
+	CPskDecoder();
+	void Init(TYPEREAL SampleRate, TYPEREAL SymbRate);
+	//Processes Length decimated samples(pData is overwritten) and puts
+	//the decoded characters in pChars(needs room for Length characters).
+	//Returns the number of characters.
+	int ProcessData(int Length, TYPECPX* pData, quint8* pChars);
+	TYPEREAL GetFreqError(){return m_FreqError;}	//AFC correction in Hz
+	bool IsSquelchOpen();
 
 private:
 	void CalcAfc(int InLength, TYPECPX* pInData);
-	void ManageSquelch(quint8 ch);
+	quint8 ManageSquelch(quint8 ch);
 	quint8 DecodeSymb(TYPECPX newsymb);
 
 	quint16 m_BitAcc;
 	quint16 m_VericodeAcc;
-	int m_PskMode;
-	int m_DecRate;
-	int m_DecCnt;
+	TYPEREAL m_SampleRate;
 	TYPEREAL m_WFerrAve;
 	TYPEREAL m_NFerrAve;
 	TYPEREAL m_IntegralFerr;
 	TYPEREAL m_FreqError;
-	TYPEREAL m_NcoPhase;
-	TYPEREAL m_NcoInc;
-	TYPEREAL m_OscCos;
-	TYPEREAL m_OscSin;
 	TYPEREAL m_AveMag;
 	TYPEREAL m_AveEnergy;
 	TYPEREAL m_LastBitMag;
 	TYPEREAL m_LastSyncSlope;
-	TYPEREAL m_SampleRate;
-	TYPEREAL m_BitMag[1024];
+	TYPEREAL m_BitMag[PSK_DEC_BLOCK];
 
 	TYPECPX m_PrevSymbol;
 	TYPECPX m_z1;
 	TYPECPX m_z2;
-	TYPECPX m_Osc1;
 	TYPECPX m_PrevSample;
-	TYPECPX m_FreqErrBuf[128];
+	TYPECPX m_FreqErrBuf[PSK_DEC_BLOCK];
 
 	CFir m_BitFir;
 	CFir m_FreqFir;
 	CIir m_BitSyncFilter;
 };
 
+class CPskDemod : public QObject
+{
+	Q_OBJECT
+public:
+	explicit CPskDemod();
+	~CPskDemod();
+	void SetPskParams(TYPEREAL InSampleRate, TYPEREAL SymbRate, int Mode);
+	//overloaded functions for mono and stereo audio out
+	int ProcessData(int InLength, TYPECPX* pInData, TYPEREAL* pOutData);
+	int ProcessData(int InLength, TYPECPX* pInData, TYPECPX* pOutData);
+
+
+private:
+	int m_PskMode;
+	int m_DecRate;
+	int m_DecCnt;
+	TYPEREAL m_FreqError;
+	TYPEREAL m_NcoPhase;
+	TYPEREAL m_NcoInc;
+	TYPEREAL m_OscCos;
+	TYPEREAL m_OscSin;
+	TYPEREAL m_InSampleRate;
+
+	TYPECPX m_Osc1;
+	quint8 m_Chars[PSK_DEC_BLOCK];
+
+	CPskDecoder m_Decoder;
+};
+
 #endif // PSKDEMOD_H
@@ -0,0 +1,453 @@
+//////////////////////////////////////////////////////////////////////
+// rdsdecoder.cpp: implementation of the CRdsDecoder class.
+//
+//  Recovers RDS groups from the 57KHz RDS signal after it has been
+// shifted to baseband. The PLL, matched filter, bit sync and block
+// decoder were moved here unchanged from CWFmDemod so they can run on
+// a separate thread or offline.
+//  CRdsFrontEnd recreates the CWFmDemod chain that feeds it from raw I/Q.
+//
+// History:
+//	2026-10-18  Initial creation from the CWFmDemod RDS code
+//	2026-10-18  Added CRdsFrontEnd for offline decoding of I/Q data
+//////////////////////////////////////////////////////////////////////
+//==========================================================================================
+// + + +   This Software is released under the "Simplified BSD License"  + + +
+//Copyright 2010 Moe Wheatley. All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification, are
+//permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice, this list of
+//	  conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice, this list
+//	  of conditions and the following disclaimer in the documentation and/or other materials
+//	  provided with the distribution.
+//
+//THIS SOFTWARE IS PROVIDED BY Moe Wheatley ``AS IS'' AND ANY EXPRESS OR IMPLIED
+//WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+//FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Moe Wheatley OR
+//CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+//ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+//ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//The views and conclusions contained in the software and documentation are those of the
+//authors and should not be interpreted as representing official policies, either expressed
+//or implied, of Moe Wheatley.
+//==========================================================================================
+#include "dsp/rdsdecoder.h"
+#include "dsp/simdops.h"
+#include "dsp/fircoef.h"
+#include <QDebug>
+
+//bunch of RDS constants
+#define USE_FEC 1	//set to zero to disable FEC correction
+
+#define RDSPLL_RANGE 12.0	//maximum deviation limit of PLL
+#define RDSPLL_BW 1.0	//natural frequency ~loop bandwidth
+#define RDSPLL_ZETA .707	//PLL Loop damping factor
+
+//RDS decoder states
+#define STATE_BITSYNC 0		//looking for initial bit position in Block 1
+#define STATE_BLOCKSYNC 1	//looking for initial correct block order
+#define STATE_GROUPDECODE 2	//decode groups after achieving bit  and block sync
+#define STATE_GROUPRESYNC 3	//waiting for beginning of new group after getting a block error
+
+#define BLOCK_ERROR_LIMIT 5		//number of bad blocks before trying to resync at the bit level
+
+#define FRONTEND_FMDEMOD_GAIN 8000.0	//same discriminator gain as CWFmDemod
+#define FRONTEND_RDS_BW 8000.0		//bandwidth kept by the RDS downconverter
+
+CRdsDecoder::CRdsDecoder()
+{
+	m_pEvents = NULL;
+	m_MaxEvents = 0;
+	m_NumEvents = 0;
+	m_BitPos = 0;
+	Init(8000.0);
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//	Initialize variables for RDS PLL and matched filter
+/////////////////////////////////////////////////////////////////////////////////
+void CRdsDecoder::Init( TYPEREAL SampleRate )
+{
+	m_SampleRate = SampleRate;
+	m_SamplePos = 0;
+	m_RdsNcoPhase = 0.0;
+	m_RdsNcoFreq = 0.0;	//freq offset to bring to baseband
+
+	//Create complex LP filter of RDS signal with 2400Hz passband
+	m_RdsBPFilter.InitLPFilter(0, 1.0,40.0, 2400.0,1.3*2400.0, SampleRate);
+
+	TYPEREAL norm = K_2PI/SampleRate;	//to normalize Hz to radians
+	//initialize the PLL that is used to de-rotate the rds DSB signal
+	m_RdsNcoLLimit = (m_RdsNcoFreq-RDSPLL_RANGE) * norm;		//clamp RDS PLL NCO
+	m_RdsNcoHLimit = (m_RdsNcoFreq+RDSPLL_RANGE) * norm;
+	m_RdsPllAlpha = 2.0*RDSPLL_ZETA*RDSPLL_BW * norm;
+	m_RdsPllBeta = (m_RdsPllAlpha * m_RdsPllAlpha)/(4.0*RDSPLL_ZETA*RDSPLL_ZETA);
+	//create matched filter to extract bi-phase bits
+	// This is basically the time domain shape of a single bi-phase bit
+	// as defined for RDS and is close to a single cycle sine wave in shape
+	m_MatchCoefLength = SampleRate / RDS_BITRATE;
+	if(m_MatchCoefLength > MAX_NUMCOEF/2)
+		m_MatchCoefLength = MAX_NUMCOEF/2;
+	for(int i= 0; i<=m_MatchCoefLength; i++)
+	{
+		TYPEREAL t = (TYPEREAL)i/(SampleRate);
+		TYPEREAL x = t*RDS_BITRATE;
+		TYPEREAL x64 = 64.0*x;
+		m_RdsMatchCoef[i+m_MatchCoefLength] = .75*MCOS(2.0*K_2PI*x)*( (1.0/(1.0/x-x64)) -
+								(1.0/(9.0/x-x64)) );
+		m_RdsMatchCoef[m_MatchCoefLength-i] = -.75*MCOS(2.0*K_2PI*x)*( (1.0/(1.0/x-x64)) -
+								(1.0/(9.0/x-x64)) );
+	}
+	m_MatchCoefLength *= 2;
+	//load the matched filter coef into FIR filter
+	m_RdsMatchedFilter.InitConstFir(m_MatchCoefLength, m_RdsMatchCoef, SampleRate);
+	//create Hi-Q resonator at the bit rate to recover bit sync position Q==500
+	m_RdsBitSyncFilter.InitBP(RDS_BITRATE, 500, SampleRate);
+	//initialize a bunch of variables pertaining to the rds decoder
+	m_RdsLastSync = 0.0;
+	m_RdsLastSyncSlope = 0.0;
+	m_RdsLastBit = 0;
+	m_CurrentBitPosition = 0;
+	m_CurrentBlock = BLOCK_A;
+	m_DecodeState = STATE_BITSYNC;
+	m_BGroupOffset = 0;
+	m_BlockErrors = 0;
+	m_InBitStream = 0;
+	m_RdsLastData = 0.0;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+// Process baseband RDS data.
+// PLL the DSB RDS signal and recover the RDS DSB signal.
+// Run the RDS signal through a matched filter to recover the  biphase data.
+// Use a IIR resonator to recover the bit clock and sample the RDS data.
+// Call the RDS decoder routine with each new bit to recover the RDS data groups.
+//
+//		InLength == number of complex baseband samples in pInData
+//		pInData == pointer to callers complex input array (users input data is overwriten!!)
+//		pEvents == array of MaxEvents where decoded groups are placed
+//	returns number of groups placed in pEvents
+/////////////////////////////////////////////////////////////////////////////////
+int CRdsDecoder::ProcessData(int InLength, TYPECPX* pInData, tRDS_GROUP_EVENT* pEvents, int MaxEvents)
+{
+	m_pEvents = pEvents;
+	m_MaxEvents = MaxEvents;
+	m_NumEvents = 0;
+	while(InLength > 0)
+	{
+		int length = (InLength > RDS_BLOCK_SIZE) ? RDS_BLOCK_SIZE : InLength;
+		//filter baseband RDS signal
+		m_RdsBPFilter.ProcessFilter(length, pInData, pInData);
+
+		//PLL to remove any rotation since may not be phase locked to 19KHz Pilot or may not even have pilot
+		ProcessPll(length, pInData, m_RdsMag);
+
+		//run matched filter correlator to extract the bi-phase data bits
+		m_RdsMatchedFilter.ProcessFilter(length,m_RdsMag,m_RdsData);
+		//create bit sync signal in m_RdsMag[] by squaring data
+		for(int i=0; i<length; i++)
+			m_RdsMag[i] = m_RdsData[i]* m_RdsData[i];	//has high energy at the bit clock rate and 2x bit rate
+
+		//run Hi-Q resonator filter that create a sin wave that will lock to BitRate clock and not 2X rate
+		m_RdsBitSyncFilter.ProcessFilter(length, m_RdsMag, m_RdsMag);
+		//now loop through samples to determine where bit position is and extract binary digital data
+		for(int i=0; i<length; i++)
+		{
+			TYPEREAL Data = m_RdsData[i];
+			TYPEREAL SyncVal = m_RdsMag[i];
+			//the best bit sync position is at the positive peak of the sync sine wave
+			TYPEREAL Slope = SyncVal - m_RdsLastSync;	//current slope
+			m_RdsLastSync = SyncVal;
+			//see if at the top of the sine wave
+			if( (Slope<0.0) && (m_RdsLastSyncSlope*Slope)<0.0 )
+			{	//are at sample time so read previous bit time since we are one sample behind in sync position
+				int bit = (m_RdsLastData>=0) ? 1 : 0;
+				//need to XOR with previous bit to get actual data bit value
+				m_BitPos = m_SamplePos + i;
+				ProcessNewRdsBit(bit^m_RdsLastBit);		//go process new RDS Bit
+				m_RdsLastBit = bit;
+			}
+			m_RdsLastData = Data;		//keep last bit since is differential data
+			m_RdsLastSyncSlope = Slope;
+		}
+		m_SamplePos += length;
+		pInData += length;
+		InLength -= length;
+	}
+	return m_NumEvents;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//	Process I/Q RDS baseband stream to lock PLL
+/////////////////////////////////////////////////////////////////////////////////
+void CRdsDecoder::ProcessPll( int InLength, TYPECPX* pInData, TYPEREAL* pOutData )
+{
+TYPEREAL Sin;
+TYPEREAL Cos;
+TYPECPX tmp;
+	for(int i=0; i<InLength; i++)
+	{
+		Sin = MSIN(m_RdsNcoPhase);		//178ns for sin/cos calc
+		Cos = MCOS(m_RdsNcoPhase);
+		//complex multiply input sample by NCO's  sin and cos
+		tmp.re = Cos * pInData[i].re - Sin * pInData[i].im;
+		tmp.im = Cos * pInData[i].im + Sin * pInData[i].re;
+		//find current sample phase after being shifted by NCO frequency
+		TYPEREAL phzerror = -FastAtan2(tmp.im, tmp.re);
+		//create new NCO frequency term
+		m_RdsNcoFreq += (m_RdsPllBeta * phzerror);		//  radians per sampletime
+		//clamp NCO frequency so doesn't get out of lock range
+		if(m_RdsNcoFreq > m_RdsNcoHLimit)
+			m_RdsNcoFreq = m_RdsNcoHLimit;
+		else if(m_RdsNcoFreq < m_RdsNcoLLimit)
+			m_RdsNcoFreq = m_RdsNcoLLimit;
+		//update NCO phase with new value
+		m_RdsNcoPhase += (m_RdsNcoFreq + m_RdsPllAlpha * phzerror);
+		pOutData[i] = tmp.im;
+	}
+	m_RdsNcoPhase = MFMOD(m_RdsNcoPhase, K_2PI);	//keep radian counter bounded
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//	Places a group in the callers event array with the time of its last bit
+/////////////////////////////////////////////////////////////////////////////////
+void CRdsDecoder::PutGroup(quint16 A, quint16 B, quint16 C, quint16 D)
+{
+	if(m_NumEvents >= m_MaxEvents)
+		return;
+	tRDS_GROUP_EVENT& Event = m_pEvents[m_NumEvents++];
+	Event.Group.BlockA = A;
+	Event.Group.BlockB = B;
+	Event.Group.BlockC = C;
+	Event.Group.BlockD = D;
+	Event.SamplePos = m_BitPos;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//	Process one new bit from RDS data stream.
+//	Manages state machine to find block data bit position, runs chksum and FEC on
+// each block, recovers good groups of 4 data blocks and places them in the
+// callers event array
+/////////////////////////////////////////////////////////////////////////////////
+void CRdsDecoder::ProcessNewRdsBit(int bit)
+{
+	m_InBitStream =	(m_InBitStream<<1) | bit;	//shift in new bit
+	switch(m_DecodeState)
+	{
+		case STATE_BITSYNC:		//looking at each bit position till we find a "good" block A
+            if( 0 == CheckBlock(OFFSET_SYNDROME_BLOCK_A, false) )
+			{	//got initial good chkword on Block A not using FEC
+				m_CurrentBitPosition = 0;
+				m_BGroupOffset = 0;
+				m_BlockData[BLOCK_A] = m_InBitStream>>NUMBITS_CRC;
+				m_CurrentBlock = BLOCK_B;
+				m_DecodeState = STATE_BLOCKSYNC;	//next state is looking for blocks B,C, and D in sequence
+			}
+			break;
+		case STATE_BLOCKSYNC:	//Looking for 4 blocks in correct sequence to have good probability bit position is good
+			m_CurrentBitPosition++;
+			if(m_CurrentBitPosition >= NUMBITS_BLOCK)
+			{
+				m_CurrentBitPosition = 0;
+                if( CheckBlock(BLK_OFFSET_TBL[m_CurrentBlock+m_BGroupOffset], false ) )
+				{	//bad chkword so go look for bit sync again
+					m_DecodeState = STATE_BITSYNC;
+				}
+				else
+				{	//good chkword so save data and setup for next block
+					m_BlockData[m_CurrentBlock] = m_InBitStream>>NUMBITS_CRC;	//save msg data
+					//see if is group A or Group B
+					if( (BLOCK_B == m_CurrentBlock) && (m_BlockData[m_CurrentBlock] & GROUPB_BIT) )
+						m_BGroupOffset = 4;
+					else
+						m_BGroupOffset = 0;
+					if(m_CurrentBlock >= BLOCK_D)
+					{	//good chkword on all 4 blocks in correct sequence so are sure of bit position
+						//Place all group data into data queue
+						PutGroup(m_BlockData[BLOCK_A], m_BlockData[BLOCK_B],
+								 m_BlockData[BLOCK_C], m_BlockData[BLOCK_D]);
+						m_CurrentBlock = BLOCK_A;
+						m_BlockErrors = 0;
+						m_DecodeState = STATE_GROUPDECODE;
+qDebug()<<"RDS Blk Sync";
+					}
+					else
+						m_CurrentBlock++;
+				}
+			}
+			break;
+		case STATE_GROUPDECODE:		//here after getting a good sequence of blocks
+			m_CurrentBitPosition++;
+			if(m_CurrentBitPosition>=NUMBITS_BLOCK)
+			{
+				m_CurrentBitPosition = 0;
+				if( CheckBlock(BLK_OFFSET_TBL[m_CurrentBlock+m_BGroupOffset], USE_FEC ) )
+				{
+					m_BlockErrors++;
+					if( m_BlockErrors > BLOCK_ERROR_LIMIT  )
+					{
+						PutGroup(0, 0, 0, 0);	//all zeros indicate loss of signal
+						m_DecodeState = STATE_BITSYNC;
+					}
+					else
+					{
+						m_CurrentBlock++;
+						if(m_CurrentBlock>BLOCK_D)
+							m_CurrentBlock = BLOCK_A;
+						if( BLOCK_A != m_CurrentBlock )	//skip remaining blocks of this group if error
+							m_DecodeState = STATE_GROUPRESYNC;
+					}
+				}
+				else
+				{	//good block so save and get ready for next one
+					m_BlockData[m_CurrentBlock] = m_InBitStream>>NUMBITS_CRC;	//save msg data
+					//see if is group A or Group B
+					if( (BLOCK_B == m_CurrentBlock) && (m_BlockData[m_CurrentBlock] & GROUPB_BIT) )
+						m_BGroupOffset = 4;
+					else
+						m_BGroupOffset = 0;
+					m_CurrentBlock++;
+					if(m_CurrentBlock>BLOCK_D)
+					{
+						//Place all group data into data queue
+						PutGroup(m_BlockData[BLOCK_A], m_BlockData[BLOCK_B],
+								 m_BlockData[BLOCK_C], m_BlockData[BLOCK_D]);
+						m_CurrentBlock = BLOCK_A;
+						m_BlockErrors = 0;
+//qDebug("Grp %X %X %X %X",m_BlockData[BLOCK_A],m_BlockData[BLOCK_B],m_BlockData[BLOCK_C],m_BlockData[BLOCK_D]);
+						//here with complete good group
+					}
+				}
+			}
+			break;
+		case STATE_GROUPRESYNC:		//ignor blocks until start of next group
+			m_CurrentBitPosition++;
+			if(m_CurrentBitPosition>=NUMBITS_BLOCK)
+			{
+				m_CurrentBitPosition = 0;
+				m_CurrentBlock++;
+				if(m_CurrentBlock>BLOCK_D)
+				{
+					m_CurrentBlock = BLOCK_A;
+					m_DecodeState = STATE_GROUPDECODE;
+//qDebug()<<"Grp Resync";
+				}
+			}
+			break;
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//	Check block 'm_InBitStream' with 'BlockOffset' for errors.
+// if UseFec is false then no FEC is done else correct up to 5 bits.
+// Returns zero if no remaining errors if FEC is specified.
+/////////////////////////////////////////////////////////////////////////////////
+quint32 CRdsDecoder::CheckBlock(quint32 SyndromeOffset, int UseFec)
+{
+	//First calculate syndrome for current 26 m_InBitStream bits
+	quint32 testblock = (0x3FFFFFF & m_InBitStream);	//isolate bottom 26 bits
+	//copy top 10 bits of block into 10 syndrome bits since first 10 rows
+	//of the check matrix is just an identity matrix(diagonal one's)
+	quint32 syndrome = testblock>>16;
+	for(int i=0; i<NUMBITS_MSG; i++)
+	{	//do the 16 remaining bits of the check matrix multiply
+		if(testblock&0x8000)
+			syndrome ^= PARCKH[i];
+		testblock <<= 1;
+	}
+	syndrome ^= SyndromeOffset;		//add depending on desired block
+
+	if(syndrome && UseFec)	//if errors and can use FEC
+	{
+		quint32 correctedbits = 0;
+		quint32 correctmask = (1<<(NUMBITS_BLOCK-1));	//start pointing to msg msb
+		//Run Meggitt FEC algorithm to correct up to 5 consecutive burst errors
+		for(int i=0; i<NUMBITS_MSG; i++)
+		{
+			if(syndrome & 0x200)	//chk msbit of syndrome for error state
+			{	//is possible bit error at current position
+				if(0 == (syndrome & 0x1F) ) //bottom 5 bits == 0 tell it is correctable
+				{	// Correct i-th bit
+					m_InBitStream ^= correctmask;
+					correctedbits++;
+					syndrome <<= 1;		//shift syndrome to next msb
+				}
+				else
+				{
+					syndrome <<= 1;	//shift syndrome to next msb
+					syndrome ^= CRC_POLY;	//recalculate new syndrome if bottom 5 bits not zero
+				}							//and syndrome msb bit was a one
+			}
+			else
+			{	//no error at this bit position so just shift to next position
+				syndrome <<= 1;	//shift syndrome to next msb
+			}
+			correctmask >>= 1;	//advance correctable bit position
+		}
+		syndrome &= 0x3FF;	//isolate syndrome bits if non-zero then still an error
+		if(correctedbits && !syndrome)
+		{
+//			qDebug()<<"corrected bits "<<correctedbits;
+		}
+	}
+	return syndrome;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////////
+//	Construct CRdsFrontEnd object
+/////////////////////////////////////////////////////////////////////////////////
+CRdsFrontEnd::CRdsFrontEnd()
+{
+	m_SampleRate = 0.0;
+	m_RdsRate = 1.0;
+	m_D1.re = 0.0;
+	m_D1.im = 0.0;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//	Setup the front end for a new I/Q sample rate.
+// Returns the sample rate of the RDS baseband output
+/////////////////////////////////////////////////////////////////////////////////
+TYPEREAL CRdsFrontEnd::Init(TYPEREAL SampleRate)
+{
+	m_SampleRate = SampleRate;
+	m_D1.re = 0.0;
+	m_D1.im = 0.0;
+	//shift +/-30KHz LP filter by 42KHz to make 12 to 72KHz bandpass
+	m_HilbertFilter.InitConstFir(HILB_LENGTH, HILBLP_H, m_SampleRate);
+	m_HilbertFilter.GenerateHBFilter(42000);
+	m_RdsRate = m_RdsDownConvert.SetDataRate(m_SampleRate, FRONTEND_RDS_BW);
+	m_RdsDownConvert.SetFrequency(-RDS_FREQUENCY);
+	return m_RdsRate;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//	FM demodulate the complex I/Q data then shift the 57KHz RDS signal to
+// baseband and decimate it.  Works in RDS_BLOCK_SIZE pieces so any
+// InLength can be used.
+/////////////////////////////////////////////////////////////////////////////////
+int CRdsFrontEnd::ProcessData(int InLength, TYPECPX* pInData, TYPECPX* pOutData)
+{
+int outlength = 0;
+	while(InLength > 0)
+	{
+		int n = InLength;
+		if(n > RDS_BLOCK_SIZE)
+			n = RDS_BLOCK_SIZE;
+		SimdFmDiscriminator(pInData, n, m_D1, FRONTEND_FMDEMOD_GAIN, m_RawFm);
+		m_HilbertFilter.ProcessFilter(n, m_RawFm, m_CpxRawFm);
+		outlength += m_RdsDownConvert.ProcessData(n, m_CpxRawFm, &pOutData[outlength]);
+		pInData += n;
+		InLength -= n;
+	}
+	return outlength;
+}
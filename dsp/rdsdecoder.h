@@ -0,0 +1,141 @@
+//////////////////////////////////////////////////////////////////////
+// rdsdecoder.h: interface for the CRdsDecoder class.
+//
+//  This class takes the RDS signal already shifted from 57KHz to
+//baseband and decimated, recovers the bi-phase data bits and decodes
+//them into RDS groups.  It has no thread or GUI dependencies so it is
+//used both by CRdsThread for live WFM and by offline decoders.
+//  CRdsFrontEnd does the WFM demod and 57KHz downconvert for decoders
+//that start from raw I/Q data such as recordings.
+//
+// History:
+//	2026-10-18  Initial creation from the CWFmDemod RDS code
+//	2026-10-18  Added CRdsFrontEnd for offline decoding of I/Q data
+//////////////////////////////////////////////////////////////////////
+//==========================================================================================
+// + + +   This Software is released under the "Simplified BSD License"  + + +
+//Copyright 2010 Moe Wheatley. All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification, are
+//permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice, this list of
+//	  conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice, this list
+//	  of conditions and the following disclaimer in the documentation and/or other materials
+//	  provided with the distribution.
+//
+//THIS SOFTWARE IS PROVIDED BY Moe Wheatley ``AS IS'' AND ANY EXPRESS OR IMPLIED
+//WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+//FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Moe Wheatley OR
+//CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+//ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+//ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//The views and conclusions contained in the software and documentation are those of the
+//authors and should not be interpreted as representing official policies, either expressed
+//or implied, of Moe Wheatley.
+//=============================================================================
+#ifndef RDSDECODER_H
+#define RDSDECODER_H
+#include "dsp/datatypes.h"
+#include "dsp/fir.h"
+#include "dsp/iir.h"
+#include "dsp/downconvert.h"
+#include "dsp/rbdsconstants.h"
+
+#define RDS_BLOCK_SIZE 4096		//maximum baseband samples processed per pass
+
+//one decoded group and where it ended in the input stream
+//All zero blocks mean RDS sync was lost.
+typedef struct _RDS_GRPEVENT
+{
+	tRDS_GROUPS Group;
+	qint64 SamplePos;	//baseband sample count at the last bit of the group
+}tRDS_GROUP_EVENT;
+
+class CRdsDecoder
+{
+public:
+	CRdsDecoder();
+
+	void Init(TYPEREAL SampleRate);		//baseband sample rate, resets the decoder
+	//Processes InLength baseband samples. pInData is overwritten.
+	//Returns the number of groups placed in pEvents, extra groups are dropped.
+	int ProcessData(int InLength, TYPECPX* pInData, tRDS_GROUP_EVENT* pEvents, int MaxEvents);
+
+	//sample count used to time stamp groups
+	void SetSamplePos(qint64 Pos){m_SamplePos = Pos;}
+	qint64 GetSamplePos(){return m_SamplePos;}
+
+private:
+	void ProcessPll( int InLength, TYPECPX* pInData, TYPEREAL* pOutData );
+	void ProcessNewRdsBit(int bit);
+	quint32 CheckBlock(quint32 BlockOffset, int UseFec);
+	void PutGroup(quint16 A, quint16 B, quint16 C, quint16 D);
+
+	TYPEREAL m_SampleRate;
+	qint64 m_SamplePos;
+	qint64 m_BitPos;
+	tRDS_GROUP_EVENT* m_pEvents;
+	int m_MaxEvents;
+	int m_NumEvents;
+
+	TYPEREAL m_RdsNcoPhase;		//variables for RDS PLL
+	TYPEREAL m_RdsNcoFreq;
+	TYPEREAL m_RdsNcoLLimit;
+	TYPEREAL m_RdsNcoHLimit;
+	TYPEREAL m_RdsPllAlpha;
+	TYPEREAL m_RdsPllBeta;
+
+	TYPEREAL m_RdsMag[RDS_BLOCK_SIZE];	//variables for RDS processing
+	TYPEREAL m_RdsData[RDS_BLOCK_SIZE];
+	TYPEREAL m_RdsMatchCoef[MAX_NUMCOEF+1];
+	TYPEREAL m_RdsLastSync;
+	TYPEREAL m_RdsLastSyncSlope;
+	TYPEREAL m_RdsLastData;
+	int m_MatchCoefLength;
+	CFir m_RdsBPFilter;
+	CFir m_RdsMatchedFilter;
+	CIir m_RdsBitSyncFilter;
+	int m_RdsLastBit;
+	quint32 m_InBitStream;	//input shift register for incoming raw data
+	int m_CurrentBlock;
+	int m_CurrentBitPosition;
+	int m_DecodeState;
+	int m_BGroupOffset;
+	int m_BlockErrors;
+	quint16 m_BlockData[4];
+};
+
+////////////
+//WFM front end that turns complex I/Q samples into the decimated RDS
+//baseband used by CRdsDecoder. It is the same discriminator, Hilbert
+//filter and downconverter chain used by CWFmDemod without the audio parts.
+////////////
+class CRdsFrontEnd
+{
+public:
+	CRdsFrontEnd();
+
+	TYPEREAL Init(TYPEREAL SampleRate);	//resets state, returns the RDS baseband rate
+	TYPEREAL GetDecimation(){return m_SampleRate/m_RdsRate;}
+	//pOutData must hold at least InLength/GetDecimation()+1 samples.
+	//Returns the number of baseband samples placed in pOutData
+	int ProcessData(int InLength, TYPECPX* pInData, TYPECPX* pOutData);
+
+private:
+	TYPEREAL m_SampleRate;
+	TYPEREAL m_RdsRate;
+	TYPECPX m_D1;		//last input sample for the discriminator
+	TYPEREAL m_RawFm[RDS_BLOCK_SIZE];
+	TYPECPX m_CpxRawFm[RDS_BLOCK_SIZE];
+	CFir m_HilbertFilter;
+	CDownConvert m_RdsDownConvert;
+};
+
+#endif // RDSDECODER_H
@@ -8,6 +8,8 @@
 //	2011-03-27  Initial release
 //	2011-08-07  Modified FIR filter initialization to force fixed size
 //	2013-07-28  Added single/double precision math macros
+//	2026-10-18  PLL phase detector uses FastAtan2()
+//	2026-10-18  Added Init() so one instance can be reused
 //////////////////////////////////////////////////////////////////////
 
 //==========================================================================================
@@ -41,6 +43,7 @@
 #include "samdemod.h"
 #include "gui/testbench.h"
 #include "dsp/datatypes.h"
+#include "dsp/simdops.h"
 #include "dsp/filtercoef.h"
 #include <QDebug>
 
@@ -53,8 +56,17 @@
 /////////////////////////////////////////////////////////////////////////////////
 //	Construct SAM demod object
 /////////////////////////////////////////////////////////////////////////////////
-CSamDemod::CSamDemod(TYPEREAL samplerate) : m_SampleRate(samplerate)
+CSamDemod::CSamDemod(TYPEREAL samplerate)
 {
+	Init(samplerate);
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//	Sets the sample rate and clears the demod state
+/////////////////////////////////////////////////////////////////////////////////
+void CSamDemod::Init(TYPEREAL samplerate)
+{
+	m_SampleRate = samplerate;
 	m_y1 = 0.0;
 	m_z1 = 0.0;
 
@@ -88,7 +100,7 @@ TYPECPX tmp;
 		tmp.re = Cos * pInData[i].re - Sin * pInData[i].im;
 		tmp.im = Cos * pInData[i].im + Sin * pInData[i].re;
 		//find current sample phase after being shifted by NCO frequency
-		TYPEREAL phzerror = -MATAN2(tmp.im, tmp.re);
+		TYPEREAL phzerror = -FastAtan2(tmp.im, tmp.re);
 
 //TYPEREAL test = phzerror*100.0;
 //g_pTestBench->DisplayData(1, 1.0, &test, m_SampleRate,PROFILE_6);
@@ -125,7 +137,7 @@ TYPECPX tmp;
 		tmp.re = Cos * pInData[i].re - Sin * pInData[i].im;
 		tmp.im = Cos * pInData[i].im + Sin * pInData[i].re;
 		//find current sample phase error after being shifted by NCO frequency
-		TYPEREAL phzerror = -MATAN2(tmp.im, tmp.re);
+		TYPEREAL phzerror = -FastAtan2(tmp.im, tmp.re);
 
 //TYPEREAL test = phzerror*100.0;
 //g_pTestBench->DisplayData(1, 1.0, &test, m_SampleRate,PROFILE_6);
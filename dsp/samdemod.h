@@ -4,6 +4,7 @@
 // History:
 //	2010-09-22  Initial creation MSW
 //	2011-03-27  Initial release
+//	2026-10-18  Added Init() so one instance can be reused
 /////////////////////////////////////////////////////////////////////
 //==========================================================================================
 // + + +   This Software is released under the "Simplified BSD License"  + + +
@@ -42,6 +43,7 @@ class CSamDemod
 {
 public:
 	CSamDemod(TYPEREAL samplerate);
+	void Init(TYPEREAL samplerate);		//clears the state for a new sample rate
 	//overloaded functions for mono and stereo
 	int ProcessData(int InLength, TYPECPX* pInData, TYPEREAL* pOutData);
 	int ProcessData(int InLength, TYPECPX* pInData, TYPECPX* pOutData);
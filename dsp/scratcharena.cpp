@@ -0,0 +1,103 @@
+//////////////////////////////////////////////////////////////////////
+// scratcharena.cpp: implementation of the CScratchArena class.
+//
+//  Cache line aligned scratch buffers for one thread.
+//
+// History:
+//	2026-10-18  Initial creation
+//////////////////////////////////////////////////////////////////////
+//==========================================================================================
+// + + +   This Software is released under the "Simplified BSD License"  + + +
+//Copyright 2010 Moe Wheatley. All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification, are
+//permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice, this list of
+//	  conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice, this list
+//	  of conditions and the following disclaimer in the documentation and/or other materials
+//	  provided with the distribution.
+//
+//THIS SOFTWARE IS PROVIDED BY Moe Wheatley ``AS IS'' AND ANY EXPRESS OR IMPLIED
+//WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+//FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Moe Wheatley OR
+//CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+//ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+//ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//The views and conclusions contained in the software and documentation are those of the
+//authors and should not be interpreted as representing official policies, either expressed
+//or implied, of Moe Wheatley.
+//==========================================================================================
+#include "dsp/scratcharena.h"
+#include <QtGlobal>
+#include <QDebug>
+
+QAtomicInt CScratchArena::m_TotalSize = 0;
+
+//////////////////////////////////////////////////////////////////////
+// Construction/Destruction
+//////////////////////////////////////////////////////////////////////
+CScratchArena::CScratchArena(const char* pName)
+{
+	m_pName = pName;
+	m_pBlock = NULL;
+	m_Size = 0;
+	m_Layout = 0;
+}
+
+CScratchArena::~CScratchArena()
+{
+	if(m_pBlock)
+		qFreeAligned(m_pBlock);
+	m_TotalSize.fetchAndAddOrdered(-m_Size);
+}
+
+//////////////////////////////////////////////////////////////////////
+//	Starts a new layout
+//////////////////////////////////////////////////////////////////////
+void CScratchArena::Begin()
+{
+	m_Layout = 0;
+}
+
+//////////////////////////////////////////////////////////////////////
+//	Adds a buffer of Bytes to the layout and returns its offset
+//////////////////////////////////////////////////////////////////////
+int CScratchArena::Add(int Bytes)
+{
+	int Offset = m_Layout;
+	m_Layout += (Bytes + SCRATCH_ALIGN - 1) & ~(SCRATCH_ALIGN - 1);
+	return Offset;
+}
+
+//////////////////////////////////////////////////////////////////////
+//	Makes the block fit the new layout
+//////////////////////////////////////////////////////////////////////
+void CScratchArena::End()
+{
+	if( (m_Layout <= m_Size) && (2*m_Layout >= m_Size) )
+		return;
+	if(m_pBlock)
+		qFreeAligned(m_pBlock);
+	m_TotalSize.fetchAndAddOrdered(m_Layout - m_Size);
+	m_Size = m_Layout;
+	if(m_Size)
+		m_pBlock = (char*)qMallocAligned(m_Size, SCRATCH_ALIGN);
+	else
+		m_pBlock = NULL;		//empty layout frees the block
+qDebug()<<"Scratch "<<m_pName<<" bytes="<<m_Size<<" total="<<GetTotalSize();
+}
+
+//////////////////////////////////////////////////////////////////////
+//	Returns the bytes held by all arenas
+//////////////////////////////////////////////////////////////////////
+int CScratchArena::GetTotalSize()
+{
+	return m_TotalSize.load();
+}
@@ -0,0 +1,77 @@
+//////////////////////////////////////////////////////////////////////
+// scratcharena.h: interface for the CScratchArena class.
+//
+//  One cache line aligned block of memory split into the scratch
+//buffers that a thread's processing stages need. The owner lays the
+//buffers out again with sizes computed from the active rates whenever
+//they change so the block functions need no large stack arrays or worst
+//case fixed size buffers.
+//  An arena belongs to one thread and must not be laid out while it is
+//in use. All arenas add their size to one total for the memory report.
+//
+// History:
+//	2026-10-18  Initial creation
+//////////////////////////////////////////////////////////////////////
+//==========================================================================================
+// + + +   This Software is released under the "Simplified BSD License"  + + +
+//Copyright 2010 Moe Wheatley. All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification, are
+//permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice, this list of
+//	  conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice, this list
+//	  of conditions and the following disclaimer in the documentation and/or other materials
+//	  provided with the distribution.
+//
+//THIS SOFTWARE IS PROVIDED BY Moe Wheatley ``AS IS'' AND ANY EXPRESS OR IMPLIED
+//WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+//FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Moe Wheatley OR
+//CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+//ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+//ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//The views and conclusions contained in the software and documentation are those of the
+//authors and should not be interpreted as representing official policies, either expressed
+//or implied, of Moe Wheatley.
+//==========================================================================================
+#ifndef SCRATCHARENA_H
+#define SCRATCHARENA_H
+
+#include "dsp/datatypes.h"
+#include <QAtomicInt>
+
+#define SCRATCH_ALIGN 64	//cache line size, every buffer starts on one
+
+class CScratchArena
+{
+public:
+	CScratchArena(const char* pName);
+	~CScratchArena();
+
+	//call Begin(), Add() once per buffer then End(). Add() returns the
+	// offset of the buffer for Get(). End() only reallocates if the block is
+	// too small or more than twice the new layout. Buffer contents are
+	// undefined after End().
+	void Begin();
+	int Add(int Bytes);
+	void End();
+	void* Get(int Offset){return m_pBlock + Offset;}
+	int GetSize(){return m_Size;}
+
+	static int GetTotalSize();	//bytes held by all arenas
+
+private:
+	const char* m_pName;
+	char* m_pBlock;
+	int m_Size;			//allocated bytes
+	int m_Layout;		//bytes used by the layout being built
+	static QAtomicInt m_TotalSize;
+};
+
+#endif // SCRATCHARENA_H
@@ -0,0 +1,742 @@
+//////////////////////////////////////////////////////////////////////
+// simdops.h: Inline vector math kernels shared by the DSP classes
+//
+//  These small kernels are the inner loops of the filter classes.
+// When SSE is available they use 4 wide float (or 2 wide double)
+// registers otherwise they fall back to 4 way unrolled C code that
+// breaks the floating point add dependency chain.
+//
+// History:
+//	2026-10-18  Initial creation
+//	2026-10-18  Added polynomial atan2 and block FM discriminator
+//	2026-10-18  Added polynomial log2 and exp2
+//	2026-10-18  Added peak magnitude and prefix sum kernels
+//	2026-10-18  Added complex dot product and LMS update kernels
+//	2026-10-18  Dot products have float and double versions
+//	2026-10-18  Log2 and exp2 kernels have float and double versions
+//////////////////////////////////////////////////////////////////////
+//==========================================================================================
+// + + +   This Software is released under the "Simplified BSD License"  + + +
+//Copyright 2010 Moe Wheatley. All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification, are
+//permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice, this list of
+//	  conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice, this list
+//	  of conditions and the following disclaimer in the documentation and/or other materials
+//	  provided with the distribution.
+//
+//THIS SOFTWARE IS PROVIDED BY Moe Wheatley ``AS IS'' AND ANY EXPRESS OR IMPLIED
+//WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+//FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Moe Wheatley OR
+//CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+//ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+//ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//The views and conclusions contained in the software and documentation are those of the
+//authors and should not be interpreted as representing official policies, either expressed
+//or implied, of Moe Wheatley.
+//=============================================================================
+#ifndef SIMDOPS_H
+#define SIMDOPS_H
+
+#include "dsp/datatypes.h"
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+ #define USE_SSE 1
+ #include <emmintrin.h>
+#else
+ #define USE_SSE 0
+#endif
+
+//////////////////////////////////////////////////////////////////////
+// Returns the sum of pA[i]*pB[i] for i = 0 to N-1
+// The dot products have float and double versions so classes templated
+//on their precision can use them in either build.
+//////////////////////////////////////////////////////////////////////
+#if USE_SSE
+inline tSReal SimdDotProduct(const tSReal* pA, const tSReal* pB, int N)
+{
+int i = 0;
+	__m128 acc0 = _mm_setzero_ps();
+	__m128 acc1 = _mm_setzero_ps();
+	for( ; i<=N-8; i+=8)
+	{
+		acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(pA+i), _mm_loadu_ps(pB+i)) );
+		acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(pA+i+4), _mm_loadu_ps(pB+i+4)) );
+	}
+	acc0 = _mm_add_ps(acc0, acc1);
+	acc0 = _mm_add_ps(acc0, _mm_movehl_ps(acc0, acc0));
+	acc0 = _mm_add_ss(acc0, _mm_shuffle_ps(acc0, acc0, 1));
+	tSReal acc = _mm_cvtss_f32(acc0);
+	for( ; i<N; i++)	//pick up any leftovers
+		acc += pA[i]*pB[i];
+	return acc;
+}
+
+inline tDReal SimdDotProduct(const tDReal* pA, const tDReal* pB, int N)
+{
+int i = 0;
+	__m128d acc0 = _mm_setzero_pd();
+	__m128d acc1 = _mm_setzero_pd();
+	for( ; i<=N-4; i+=4)
+	{
+		acc0 = _mm_add_pd(acc0, _mm_mul_pd(_mm_loadu_pd(pA+i), _mm_loadu_pd(pB+i)) );
+		acc1 = _mm_add_pd(acc1, _mm_mul_pd(_mm_loadu_pd(pA+i+2), _mm_loadu_pd(pB+i+2)) );
+	}
+	acc0 = _mm_add_pd(acc0, acc1);
+	acc0 = _mm_add_sd(acc0, _mm_unpackhi_pd(acc0, acc0));
+	tDReal acc = _mm_cvtsd_f64(acc0);
+	for( ; i<N; i++)	//pick up any leftovers
+		acc += pA[i]*pB[i];
+	return acc;
+}
+#else
+template <typename T>
+inline T SimdDotProduct(const T* pA, const T* pB, int N)
+{
+int i = 0;
+	T acc0 = 0.0;
+	T acc1 = 0.0;
+	T acc2 = 0.0;
+	T acc3 = 0.0;
+	for( ; i<=N-4; i+=4)
+	{
+		acc0 += pA[i]*pB[i];
+		acc1 += pA[i+1]*pB[i+1];
+		acc2 += pA[i+2]*pB[i+2];
+		acc3 += pA[i+3]*pB[i+3];
+	}
+	T acc = (acc0 + acc1) + (acc2 + acc3);
+	for( ; i<N; i++)	//pick up any leftovers
+		acc += pA[i]*pB[i];
+	return acc;
+}
+#endif
+
+//////////////////////////////////////////////////////////////////////
+// Dot product of two real vectors (typically the I and Q planes of a
+// complex signal) with the same coefficient vector pH.
+// Sharing the coefficient loads makes this cheaper than two calls
+// to SimdDotProduct().
+//////////////////////////////////////////////////////////////////////
+#if USE_SSE
+inline void SimdDotProduct2(const tSReal* pRe, const tSReal* pIm, const tSReal* pH, int N,
+							tSReal& OutRe, tSReal& OutIm)
+{
+int i = 0;
+	__m128 accre = _mm_setzero_ps();
+	__m128 accim = _mm_setzero_ps();
+	for( ; i<=N-4; i+=4)
+	{
+		__m128 h = _mm_loadu_ps(pH+i);
+		accre = _mm_add_ps(accre, _mm_mul_ps(_mm_loadu_ps(pRe+i), h) );
+		accim = _mm_add_ps(accim, _mm_mul_ps(_mm_loadu_ps(pIm+i), h) );
+	}
+	//horizontal add of both accumulators at once
+	__m128 lo = _mm_unpacklo_ps(accre, accim);	//re0 im0 re1 im1
+	__m128 hi = _mm_unpackhi_ps(accre, accim);	//re2 im2 re3 im3
+	lo = _mm_add_ps(lo, hi);
+	lo = _mm_add_ps(lo, _mm_movehl_ps(lo, lo));
+	tSReal re = _mm_cvtss_f32(lo);
+	tSReal im = _mm_cvtss_f32(_mm_shuffle_ps(lo, lo, 1));
+	for( ; i<N; i++)	//pick up any leftovers
+	{
+		re += pRe[i]*pH[i];
+		im += pIm[i]*pH[i];
+	}
+	OutRe = re;
+	OutIm = im;
+}
+
+inline void SimdDotProduct2(const tDReal* pRe, const tDReal* pIm, const tDReal* pH, int N,
+							tDReal& OutRe, tDReal& OutIm)
+{
+int i = 0;
+	__m128d accre = _mm_setzero_pd();
+	__m128d accim = _mm_setzero_pd();
+	for( ; i<=N-2; i+=2)
+	{
+		__m128d h = _mm_loadu_pd(pH+i);
+		accre = _mm_add_pd(accre, _mm_mul_pd(_mm_loadu_pd(pRe+i), h) );
+		accim = _mm_add_pd(accim, _mm_mul_pd(_mm_loadu_pd(pIm+i), h) );
+	}
+	__m128d sum = _mm_add_pd(_mm_unpacklo_pd(accre, accim), _mm_unpackhi_pd(accre, accim));
+	tDReal re = _mm_cvtsd_f64(sum);
+	tDReal im = _mm_cvtsd_f64(_mm_unpackhi_pd(sum, sum));
+	for( ; i<N; i++)	//pick up any leftovers
+	{
+		re += pRe[i]*pH[i];
+		im += pIm[i]*pH[i];
+	}
+	OutRe = re;
+	OutIm = im;
+}
+#else
+template <typename T>
+inline void SimdDotProduct2(const T* pRe, const T* pIm, const T* pH, int N, T& OutRe, T& OutIm)
+{
+int i = 0;
+	T re0 = 0.0;
+	T re1 = 0.0;
+	T im0 = 0.0;
+	T im1 = 0.0;
+	for( ; i<=N-2; i+=2)
+	{
+		re0 += pRe[i]*pH[i];
+		im0 += pIm[i]*pH[i];
+		re1 += pRe[i+1]*pH[i+1];
+		im1 += pIm[i+1]*pH[i+1];
+	}
+	T re = re0 + re1;
+	T im = im0 + im1;
+	for( ; i<N; i++)	//pick up any leftovers
+	{
+		re += pRe[i]*pH[i];
+		im += pIm[i]*pH[i];
+	}
+	OutRe = re;
+	OutIm = im;
+}
+#endif
+
+//////////////////////////////////////////////////////////////////////
+// Polynomial atan2() approximation.
+// The angle is reduced to the first octant where atan(z), 0<=z<=1, is an
+//11th order odd minimax polynomial then mapped back using the signs and
+//relative size of x and y.  |error| < 2e-6 radians.
+//////////////////////////////////////////////////////////////////////
+#define ATAN_C1 0.99997726
+#define ATAN_C3 -0.33262347
+#define ATAN_C5 0.19354346
+#define ATAN_C7 -0.11643287
+#define ATAN_C9 0.05265332
+#define ATAN_C11 -0.01172120
+#define ATAN_TINY 1e-30		//keeps 0/0 out of the octant reduction
+
+inline TYPEREAL FastAtan2(TYPEREAL y, TYPEREAL x)
+{
+	TYPEREAL ax = MFABS(x);
+	TYPEREAL ay = MFABS(y);
+	TYPEREAL mx = (ay > ax) ? ay : ax;
+	TYPEREAL mn = (ay > ax) ? ax : ay;
+	if(mx < ATAN_TINY)
+		mx = ATAN_TINY;
+	TYPEREAL z = mn/mx;
+	TYPEREAL z2 = z*z;
+	TYPEREAL a = z*(ATAN_C1 + z2*(ATAN_C3 + z2*(ATAN_C5 + z2*(ATAN_C7 + z2*(ATAN_C9 + z2*ATAN_C11)))));
+	if(ay > ax)
+		a = K_PI2 - a;
+	if(x < 0.0)
+		a = K_PI - a;
+	if(y < 0.0)
+		a = -a;
+	return a;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Block version of FastAtan2(). pOut[i] = atan2(pY[i], pX[i])
+// The octant corrections are done with compare masks so there are no
+//branches in the SIMD loop.
+//////////////////////////////////////////////////////////////////////
+inline void SimdAtan2(const TYPEREAL* pY, const TYPEREAL* pX, TYPEREAL* pOut, int N)
+{
+int i = 0;
+#if USE_SSE && !defined(USE_DOUBLE_PRECISION)
+	const __m128 signmask = _mm_set1_ps(-0.0f);
+	const __m128 tiny = _mm_set1_ps((float)ATAN_TINY);
+	const __m128 pi = _mm_set1_ps((float)K_PI);
+	const __m128 pi2 = _mm_set1_ps((float)K_PI2);
+	for( ; i<=N-4; i+=4)
+	{
+		__m128 y = _mm_loadu_ps(pY+i);
+		__m128 x = _mm_loadu_ps(pX+i);
+		__m128 ax = _mm_andnot_ps(signmask, x);
+		__m128 ay = _mm_andnot_ps(signmask, y);
+		__m128 z = _mm_div_ps( _mm_min_ps(ax, ay), _mm_max_ps(_mm_max_ps(ax, ay), tiny) );
+		__m128 z2 = _mm_mul_ps(z, z);
+		__m128 a = _mm_add_ps(_mm_set1_ps((float)ATAN_C9), _mm_mul_ps(z2, _mm_set1_ps((float)ATAN_C11)));
+		a = _mm_add_ps(_mm_set1_ps((float)ATAN_C7), _mm_mul_ps(z2, a));
+		a = _mm_add_ps(_mm_set1_ps((float)ATAN_C5), _mm_mul_ps(z2, a));
+		a = _mm_add_ps(_mm_set1_ps((float)ATAN_C3), _mm_mul_ps(z2, a));
+		a = _mm_add_ps(_mm_set1_ps((float)ATAN_C1), _mm_mul_ps(z2, a));
+		a = _mm_mul_ps(z, a);
+		__m128 m = _mm_cmpgt_ps(ay, ax);
+		a = _mm_or_ps( _mm_and_ps(m, _mm_sub_ps(pi2, a)), _mm_andnot_ps(m, a) );
+		m = _mm_cmplt_ps(x, _mm_setzero_ps());
+		a = _mm_or_ps( _mm_and_ps(m, _mm_sub_ps(pi, a)), _mm_andnot_ps(m, a) );
+		m = _mm_cmplt_ps(y, _mm_setzero_ps());
+		a = _mm_xor_ps(a, _mm_and_ps(m, signmask));
+		_mm_storeu_ps(pOut+i, a);
+	}
+#elif USE_SSE
+	const __m128d signmask = _mm_set1_pd(-0.0);
+	const __m128d tiny = _mm_set1_pd(ATAN_TINY);
+	const __m128d pi = _mm_set1_pd(K_PI);
+	const __m128d pi2 = _mm_set1_pd(K_PI2);
+	for( ; i<=N-2; i+=2)
+	{
+		__m128d y = _mm_loadu_pd(pY+i);
+		__m128d x = _mm_loadu_pd(pX+i);
+		__m128d ax = _mm_andnot_pd(signmask, x);
+		__m128d ay = _mm_andnot_pd(signmask, y);
+		__m128d z = _mm_div_pd( _mm_min_pd(ax, ay), _mm_max_pd(_mm_max_pd(ax, ay), tiny) );
+		__m128d z2 = _mm_mul_pd(z, z);
+		__m128d a = _mm_add_pd(_mm_set1_pd(ATAN_C9), _mm_mul_pd(z2, _mm_set1_pd(ATAN_C11)));
+		a = _mm_add_pd(_mm_set1_pd(ATAN_C7), _mm_mul_pd(z2, a));
+		a = _mm_add_pd(_mm_set1_pd(ATAN_C5), _mm_mul_pd(z2, a));
+		a = _mm_add_pd(_mm_set1_pd(ATAN_C3), _mm_mul_pd(z2, a));
+		a = _mm_add_pd(_mm_set1_pd(ATAN_C1), _mm_mul_pd(z2, a));
+		a = _mm_mul_pd(z, a);
+		__m128d m = _mm_cmpgt_pd(ay, ax);
+		a = _mm_or_pd( _mm_and_pd(m, _mm_sub_pd(pi2, a)), _mm_andnot_pd(m, a) );
+		m = _mm_cmplt_pd(x, _mm_setzero_pd());
+		a = _mm_or_pd( _mm_and_pd(m, _mm_sub_pd(pi, a)), _mm_andnot_pd(m, a) );
+		m = _mm_cmplt_pd(y, _mm_setzero_pd());
+		a = _mm_xor_pd(a, _mm_and_pd(m, signmask));
+		_mm_storeu_pd(pOut+i, a);
+	}
+#endif
+	for( ; i<N; i++)	//pick up any leftovers
+		pOut[i] = FastAtan2(pY[i], pX[i]);
+}
+
+//////////////////////////////////////////////////////////////////////
+// FM discriminator: pOut[i] = Gain * arg( pIn[i] * conj(pIn[i-1]) )
+// Last holds the sample before pIn[0] and is updated with the last
+//input sample so blocks can be chained.  The conjugate products of
+//FMDISC_BLOCK samples are formed first so the angles can be found
+//with one SimdAtan2() call.  pOut may overlay the pIn buffer.
+//////////////////////////////////////////////////////////////////////
+#define FMDISC_BLOCK 16
+
+inline void SimdFmDiscriminator(const TYPECPX* pIn, int N, TYPECPX& Last, TYPEREAL Gain, TYPEREAL* pOut)
+{
+TYPEREAL y[FMDISC_BLOCK];
+TYPEREAL x[FMDISC_BLOCK];
+TYPECPX prev = Last;
+	for(int i=0; i<N; i+=FMDISC_BLOCK)
+	{
+		int n = N - i;
+		if(n > FMDISC_BLOCK)
+			n = FMDISC_BLOCK;
+		const TYPECPX* p = pIn + i;
+		y[0] = prev.re*p[0].im - p[0].re*prev.im;
+		x[0] = prev.re*p[0].re + prev.im*p[0].im;
+		for(int j=1; j<n; j++)
+		{
+			y[j] = p[j-1].re*p[j].im - p[j].re*p[j-1].im;
+			x[j] = p[j-1].re*p[j].re + p[j-1].im*p[j].im;
+		}
+		prev = p[n-1];	//save before pOut can overwrite it
+		SimdAtan2(y, x, y, n);
+		for(int j=0; j<n; j++)
+			pOut[i+j] = Gain*y[j];
+	}
+	Last = prev;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Polynomial log2() and exp2() approximations, mainly for gain math.
+// log2(x) splits a positive normal float x into its exponent and a
+//mantissa 1<=m<2 and uses a 5th order minimax polynomial for
+//log2(m).  |error| < 2e-5.
+// exp2(x) splits x into integer and fraction parts and uses a 5th order
+//polynomial for 2^f, 0<=f<1.  Relative error < 2e-7.  x is clamped to
+//+/-EXP2_LIMIT so the result is always a normal float.
+// Both work in single precision even for double data.
+//////////////////////////////////////////////////////////////////////
+#define LOG2_C1 1.44196563
+#define LOG2_C2 -0.70966326
+#define LOG2_C3 0.41759794
+#define LOG2_C4 -0.19627309
+#define LOG2_C5 0.04638711
+#define EXP2_C0 0.99999993
+#define EXP2_C1 0.69315307
+#define EXP2_C2 0.24015362
+#define EXP2_C3 0.05582631
+#define EXP2_C4 0.00898936
+#define EXP2_C5 0.00187756
+#define EXP2_LIMIT 126.0
+
+template <typename T>
+inline T FastLog2(T x)
+{
+	float f = (float)x;
+	qint32 bits;
+	memcpy(&bits, &f, sizeof(bits));
+	T e = (T)( ((bits>>23) & 0xFF) - 127 );
+	bits = (bits & 0x007FFFFF) | 0x3F800000;
+	memcpy(&f, &bits, sizeof(bits));
+	T t = f - 1.0;
+	return e + t*(LOG2_C1 + t*(LOG2_C2 + t*(LOG2_C3 + t*(LOG2_C4 + t*LOG2_C5))));
+}
+
+template <typename T>
+inline T FastExp2(T x)
+{
+	if(x > EXP2_LIMIT)
+		x = EXP2_LIMIT;
+	if(x < -EXP2_LIMIT)
+		x = -EXP2_LIMIT;
+	int i = (int)x;
+	if(i > x)
+		i--;	//floor() for negative x
+	T t = x - i;
+	qint32 bits = (i + 127)<<23;
+	float scale;
+	memcpy(&scale, &bits, sizeof(bits));
+	return scale*(EXP2_C0 + t*(EXP2_C1 + t*(EXP2_C2 + t*(EXP2_C3 + t*(EXP2_C4 + t*EXP2_C5)))));
+}
+
+#if USE_SSE
+//4 wide float cores of FastLog2() and FastExp2()
+inline __m128 Log2Ps(__m128 x)
+{
+	__m128i bits = _mm_castps_si128(x);
+	__m128 e = _mm_cvtepi32_ps( _mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(127)) );
+	bits = _mm_or_si128( _mm_and_si128(bits, _mm_set1_epi32(0x007FFFFF)), _mm_set1_epi32(0x3F800000) );
+	__m128 t = _mm_sub_ps(_mm_castsi128_ps(bits), _mm_set1_ps(1.0f));
+	__m128 p = _mm_add_ps(_mm_set1_ps((float)LOG2_C4), _mm_mul_ps(t, _mm_set1_ps((float)LOG2_C5)));
+	p = _mm_add_ps(_mm_set1_ps((float)LOG2_C3), _mm_mul_ps(t, p));
+	p = _mm_add_ps(_mm_set1_ps((float)LOG2_C2), _mm_mul_ps(t, p));
+	p = _mm_add_ps(_mm_set1_ps((float)LOG2_C1), _mm_mul_ps(t, p));
+	return _mm_add_ps(e, _mm_mul_ps(t, p));
+}
+
+inline __m128 Exp2Ps(__m128 x)
+{
+	x = _mm_min_ps(x, _mm_set1_ps((float)EXP2_LIMIT));
+	x = _mm_max_ps(x, _mm_set1_ps((float)-EXP2_LIMIT));
+	__m128i i = _mm_cvttps_epi32(x);
+	//truncation rounds negative values up so subtract 1 where needed for floor()
+	i = _mm_add_epi32(i, _mm_castps_si128(_mm_cmpgt_ps(_mm_cvtepi32_ps(i), x)) );
+	__m128 t = _mm_sub_ps(x, _mm_cvtepi32_ps(i));
+	__m128 p = _mm_add_ps(_mm_set1_ps((float)EXP2_C4), _mm_mul_ps(t, _mm_set1_ps((float)EXP2_C5)));
+	p = _mm_add_ps(_mm_set1_ps((float)EXP2_C3), _mm_mul_ps(t, p));
+	p = _mm_add_ps(_mm_set1_ps((float)EXP2_C2), _mm_mul_ps(t, p));
+	p = _mm_add_ps(_mm_set1_ps((float)EXP2_C1), _mm_mul_ps(t, p));
+	p = _mm_add_ps(_mm_set1_ps((float)EXP2_C0), _mm_mul_ps(t, p));
+	__m128 scale = _mm_castsi128_ps( _mm_slli_epi32(_mm_add_epi32(i, _mm_set1_epi32(127)), 23) );
+	return _mm_mul_ps(p, scale);
+}
+#endif
+
+//////////////////////////////////////////////////////////////////////
+// Block versions. pOut[i] = log2(pIn[i]) or exp2(pIn[i])
+// pOut may be the same buffer as pIn.
+// There are float and double versions, the double ones convert to float
+//for the SSE core.
+//////////////////////////////////////////////////////////////////////
+inline void SimdLog2(const tSReal* pIn, tSReal* pOut, int N)
+{
+int i = 0;
+#if USE_SSE
+	for( ; i<=N-4; i+=4)
+		_mm_storeu_ps(pOut+i, Log2Ps(_mm_loadu_ps(pIn+i)) );
+#endif
+	for( ; i<N; i++)	//pick up any leftovers
+		pOut[i] = FastLog2(pIn[i]);
+}
+
+inline void SimdLog2(const tDReal* pIn, tDReal* pOut, int N)
+{
+int i = 0;
+#if USE_SSE
+	for( ; i<=N-4; i+=4)
+	{
+		__m128 x = _mm_movelh_ps( _mm_cvtpd_ps(_mm_loadu_pd(pIn+i)), _mm_cvtpd_ps(_mm_loadu_pd(pIn+i+2)) );
+		__m128 y = Log2Ps(x);
+		_mm_storeu_pd(pOut+i, _mm_cvtps_pd(y));
+		_mm_storeu_pd(pOut+i+2, _mm_cvtps_pd(_mm_movehl_ps(y, y)));
+	}
+#endif
+	for( ; i<N; i++)	//pick up any leftovers
+		pOut[i] = FastLog2(pIn[i]);
+}
+
+inline void SimdExp2(const tSReal* pIn, tSReal* pOut, int N)
+{
+int i = 0;
+#if USE_SSE
+	for( ; i<=N-4; i+=4)
+		_mm_storeu_ps(pOut+i, Exp2Ps(_mm_loadu_ps(pIn+i)) );
+#endif
+	for( ; i<N; i++)	//pick up any leftovers
+		pOut[i] = FastExp2(pIn[i]);
+}
+
+inline void SimdExp2(const tDReal* pIn, tDReal* pOut, int N)
+{
+int i = 0;
+#if USE_SSE
+	for( ; i<=N-4; i+=4)
+	{
+		__m128 x = _mm_movelh_ps( _mm_cvtpd_ps(_mm_loadu_pd(pIn+i)), _mm_cvtpd_ps(_mm_loadu_pd(pIn+i+2)) );
+		__m128 y = Exp2Ps(x);
+		_mm_storeu_pd(pOut+i, _mm_cvtps_pd(y));
+		_mm_storeu_pd(pOut+i+2, _mm_cvtps_pd(_mm_movehl_ps(y, y)));
+	}
+#endif
+	for( ; i<N; i++)	//pick up any leftovers
+		pOut[i] = FastExp2(pIn[i]);
+}
+
+//////////////////////////////////////////////////////////////////////
+// Peak magnitude of complex samples. pOut[i] = max(|re|, |im|)
+//////////////////////////////////////////////////////////////////////
+inline void SimdPeakMag(const TYPECPX* pIn, TYPEREAL* pOut, int N)
+{
+int i = 0;
+const TYPEREAL* p = (const TYPEREAL*)pIn;
+#if USE_SSE && !defined(USE_DOUBLE_PRECISION)
+	const __m128 absmask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+	for( ; i<=N-4; i+=4)
+	{
+		__m128 a = _mm_and_ps(_mm_loadu_ps(p+2*i), absmask);
+		__m128 b = _mm_and_ps(_mm_loadu_ps(p+2*i+4), absmask);
+		__m128 re = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2,0,2,0));
+		__m128 im = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3,1,3,1));
+		_mm_storeu_ps(pOut+i, _mm_max_ps(re, im));
+	}
+#elif USE_SSE
+	const __m128d absmask = _mm_castsi128_pd(_mm_set_epi32(0x7FFFFFFF, -1, 0x7FFFFFFF, -1));
+	for( ; i<=N-2; i+=2)
+	{
+		__m128d a = _mm_and_pd(_mm_loadu_pd(p+2*i), absmask);
+		__m128d b = _mm_and_pd(_mm_loadu_pd(p+2*i+2), absmask);
+		_mm_storeu_pd(pOut+i, _mm_max_pd(_mm_unpacklo_pd(a, b), _mm_unpackhi_pd(a, b)) );
+	}
+#endif
+	for( ; i<N; i++)	//pick up any leftovers
+	{
+		TYPEREAL mre = MFABS(pIn[i].re);
+		TYPEREAL mim = MFABS(pIn[i].im);
+		pOut[i] = (mre>mim) ? mre : mim;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+// Running sum of differences. pOut[i] = Start + sum of (pAdd[j]-pSub[j])
+//for j = 0 to i.  This is the update of a moving sum where pAdd holds
+//the samples entering the window and pSub the samples leaving it.
+// Returns pOut[N-1](or Start if N is 0). pOut may be the same buffer as pAdd.
+// The SSE version forms the prefix sum inside each register with
+//shifted adds then adds the carry from the previous register.
+//////////////////////////////////////////////////////////////////////
+inline TYPEREAL SimdPrefixSum(const TYPEREAL* pAdd, const TYPEREAL* pSub, TYPEREAL* pOut, int N, TYPEREAL Start)
+{
+int i = 0;
+#if USE_SSE && !defined(USE_DOUBLE_PRECISION)
+	__m128 carry = _mm_set1_ps(Start);
+	for( ; i<=N-4; i+=4)
+	{
+		__m128 x = _mm_sub_ps(_mm_loadu_ps(pAdd+i), _mm_loadu_ps(pSub+i));
+		x = _mm_add_ps(x, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(x), 4)) );
+		x = _mm_add_ps(x, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(x), 8)) );
+		x = _mm_add_ps(x, carry);
+		_mm_storeu_ps(pOut+i, x);
+		carry = _mm_shuffle_ps(x, x, _MM_SHUFFLE(3,3,3,3));
+	}
+	Start = _mm_cvtss_f32(carry);
+#elif USE_SSE
+	__m128d carry = _mm_set1_pd(Start);
+	for( ; i<=N-2; i+=2)
+	{
+		__m128d x = _mm_sub_pd(_mm_loadu_pd(pAdd+i), _mm_loadu_pd(pSub+i));
+		x = _mm_add_pd(x, _mm_castsi128_pd(_mm_slli_si128(_mm_castpd_si128(x), 8)) );
+		x = _mm_add_pd(x, carry);
+		_mm_storeu_pd(pOut+i, x);
+		carry = _mm_unpackhi_pd(x, x);
+	}
+	Start = _mm_cvtsd_f64(carry);
+#endif
+	for( ; i<N; i++)	//pick up any leftovers
+	{
+		Start += (pAdd[i] - pSub[i]);
+		pOut[i] = Start;
+	}
+	return Start;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Returns the number of i for which pA[i]*Scale > pB[i]
+//////////////////////////////////////////////////////////////////////
+inline int SimdCountAbove(const TYPEREAL* pA, TYPEREAL Scale, const TYPEREAL* pB, int N)
+{
+int i = 0;
+int count = 0;
+#if USE_SSE && !defined(USE_DOUBLE_PRECISION)
+	__m128 scale = _mm_set1_ps(Scale);
+	__m128i acc = _mm_setzero_si128();
+	for( ; i<=N-4; i+=4)
+	{	//compare results are -1 where true
+		__m128 gt = _mm_cmpgt_ps(_mm_mul_ps(_mm_loadu_ps(pA+i), scale), _mm_loadu_ps(pB+i));
+		acc = _mm_sub_epi32(acc, _mm_castps_si128(gt));
+	}
+	acc = _mm_add_epi32(acc, _mm_srli_si128(acc, 8));
+	acc = _mm_add_epi32(acc, _mm_srli_si128(acc, 4));
+	count = _mm_cvtsi128_si32(acc);
+#elif USE_SSE
+	__m128d scale = _mm_set1_pd(Scale);
+	for( ; i<=N-2; i+=2)
+	{
+		int m = _mm_movemask_pd( _mm_cmpgt_pd(_mm_mul_pd(_mm_loadu_pd(pA+i), scale), _mm_loadu_pd(pB+i)) );
+		count += (m&1) + (m>>1);
+	}
+#endif
+	for( ; i<N; i++)	//pick up any leftovers
+		count += (pA[i]*Scale > pB[i]);
+	return count;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Complex dot product with the signal and coefficients held as separate
+//I and Q planes. Out = sum of (pWRe[i]+jpWIm[i])*(pXRe[i]+jpXIm[i])
+//////////////////////////////////////////////////////////////////////
+inline void SimdCpxDotProduct(const TYPEREAL* pXRe, const TYPEREAL* pXIm,
+							const TYPEREAL* pWRe, const TYPEREAL* pWIm, int N,
+							TYPEREAL& OutRe, TYPEREAL& OutIm)
+{
+int i = 0;
+TYPEREAL re;
+TYPEREAL im;
+#if USE_SSE && !defined(USE_DOUBLE_PRECISION)
+	__m128 accre = _mm_setzero_ps();
+	__m128 accim = _mm_setzero_ps();
+	for( ; i<=N-4; i+=4)
+	{
+		__m128 xr = _mm_loadu_ps(pXRe+i);
+		__m128 xi = _mm_loadu_ps(pXIm+i);
+		__m128 wr = _mm_loadu_ps(pWRe+i);
+		__m128 wi = _mm_loadu_ps(pWIm+i);
+		accre = _mm_add_ps(accre, _mm_sub_ps(_mm_mul_ps(wr, xr), _mm_mul_ps(wi, xi)) );
+		accim = _mm_add_ps(accim, _mm_add_ps(_mm_mul_ps(wr, xi), _mm_mul_ps(wi, xr)) );
+	}
+	__m128 lo = _mm_unpacklo_ps(accre, accim);	//re0 im0 re1 im1
+	__m128 hi = _mm_unpackhi_ps(accre, accim);	//re2 im2 re3 im3
+	lo = _mm_add_ps(lo, hi);
+	lo = _mm_add_ps(lo, _mm_movehl_ps(lo, lo));
+	re = _mm_cvtss_f32(lo);
+	im = _mm_cvtss_f32(_mm_shuffle_ps(lo, lo, 1));
+#elif USE_SSE
+	__m128d accre = _mm_setzero_pd();
+	__m128d accim = _mm_setzero_pd();
+	for( ; i<=N-2; i+=2)
+	{
+		__m128d xr = _mm_loadu_pd(pXRe+i);
+		__m128d xi = _mm_loadu_pd(pXIm+i);
+		__m128d wr = _mm_loadu_pd(pWRe+i);
+		__m128d wi = _mm_loadu_pd(pWIm+i);
+		accre = _mm_add_pd(accre, _mm_sub_pd(_mm_mul_pd(wr, xr), _mm_mul_pd(wi, xi)) );
+		accim = _mm_add_pd(accim, _mm_add_pd(_mm_mul_pd(wr, xi), _mm_mul_pd(wi, xr)) );
+	}
+	__m128d sum = _mm_add_pd(_mm_unpacklo_pd(accre, accim), _mm_unpackhi_pd(accre, accim));
+	re = _mm_cvtsd_f64(sum);
+	im = _mm_cvtsd_f64(_mm_unpackhi_pd(sum, sum));
+#else
+	TYPEREAL re0 = 0.0;
+	TYPEREAL re1 = 0.0;
+	TYPEREAL im0 = 0.0;
+	TYPEREAL im1 = 0.0;
+	for( ; i<=N-2; i+=2)
+	{
+		re0 += pWRe[i]*pXRe[i] - pWIm[i]*pXIm[i];
+		im0 += pWRe[i]*pXIm[i] + pWIm[i]*pXRe[i];
+		re1 += pWRe[i+1]*pXRe[i+1] - pWIm[i+1]*pXIm[i+1];
+		im1 += pWRe[i+1]*pXIm[i+1] + pWIm[i+1]*pXRe[i+1];
+	}
+	re = re0 + re1;
+	im = im0 + im1;
+#endif
+	for( ; i<N; i++)	//pick up any leftovers
+	{
+		re += pWRe[i]*pXRe[i] - pWIm[i]*pXIm[i];
+		im += pWRe[i]*pXIm[i] + pWIm[i]*pXRe[i];
+	}
+	OutRe = re;
+	OutIm = im;
+}
+
+//////////////////////////////////////////////////////////////////////
+// LMS coefficient updates.
+//  Real:    pW[i] = Leak*pW[i] + Step*pX[i]
+//  Complex: pW[i] = Leak*pW[i] + Step*conj(pX[i])
+// with Step the error times the step size.
+//////////////////////////////////////////////////////////////////////
+inline void SimdLmsUpdate(TYPEREAL* pW, const TYPEREAL* pX, int N, TYPEREAL Step, TYPEREAL Leak)
+{
+int i = 0;
+#if USE_SSE && !defined(USE_DOUBLE_PRECISION)
+	__m128 step = _mm_set1_ps(Step);
+	__m128 leak = _mm_set1_ps(Leak);
+	for( ; i<=N-4; i+=4)
+	{
+		__m128 w = _mm_mul_ps(_mm_loadu_ps(pW+i), leak);
+		_mm_storeu_ps(pW+i, _mm_add_ps(w, _mm_mul_ps(_mm_loadu_ps(pX+i), step)) );
+	}
+#elif USE_SSE
+	__m128d step = _mm_set1_pd(Step);
+	__m128d leak = _mm_set1_pd(Leak);
+	for( ; i<=N-2; i+=2)
+	{
+		__m128d w = _mm_mul_pd(_mm_loadu_pd(pW+i), leak);
+		_mm_storeu_pd(pW+i, _mm_add_pd(w, _mm_mul_pd(_mm_loadu_pd(pX+i), step)) );
+	}
+#endif
+	for( ; i<N; i++)	//pick up any leftovers
+		pW[i] = Leak*pW[i] + Step*pX[i];
+}
+
+inline void SimdCpxLmsUpdate(TYPEREAL* pWRe, TYPEREAL* pWIm, const TYPEREAL* pXRe, const TYPEREAL* pXIm,
+							int N, TYPEREAL StepRe, TYPEREAL StepIm, TYPEREAL Leak)
+{
+int i = 0;
+#if USE_SSE && !defined(USE_DOUBLE_PRECISION)
+	__m128 sr = _mm_set1_ps(StepRe);
+	__m128 si = _mm_set1_ps(StepIm);
+	__m128 leak = _mm_set1_ps(Leak);
+	for( ; i<=N-4; i+=4)
+	{
+		__m128 xr = _mm_loadu_ps(pXRe+i);
+		__m128 xi = _mm_loadu_ps(pXIm+i);
+		__m128 wr = _mm_mul_ps(_mm_loadu_ps(pWRe+i), leak);
+		__m128 wi = _mm_mul_ps(_mm_loadu_ps(pWIm+i), leak);
+		wr = _mm_add_ps(wr, _mm_add_ps(_mm_mul_ps(sr, xr), _mm_mul_ps(si, xi)) );
+		wi = _mm_add_ps(wi, _mm_sub_ps(_mm_mul_ps(si, xr), _mm_mul_ps(sr, xi)) );
+		_mm_storeu_ps(pWRe+i, wr);
+		_mm_storeu_ps(pWIm+i, wi);
+	}
+#elif USE_SSE
+	__m128d sr = _mm_set1_pd(StepRe);
+	__m128d si = _mm_set1_pd(StepIm);
+	__m128d leak = _mm_set1_pd(Leak);
+	for( ; i<=N-2; i+=2)
+	{
+		__m128d xr = _mm_loadu_pd(pXRe+i);
+		__m128d xi = _mm_loadu_pd(pXIm+i);
+		__m128d wr = _mm_mul_pd(_mm_loadu_pd(pWRe+i), leak);
+		__m128d wi = _mm_mul_pd(_mm_loadu_pd(pWIm+i), leak);
+		wr = _mm_add_pd(wr, _mm_add_pd(_mm_mul_pd(sr, xr), _mm_mul_pd(si, xi)) );
+		wi = _mm_add_pd(wi, _mm_sub_pd(_mm_mul_pd(si, xr), _mm_mul_pd(sr, xi)) );
+		_mm_storeu_pd(pWRe+i, wr);
+		_mm_storeu_pd(pWIm+i, wi);
+	}
+#endif
+	for( ; i<N; i++)	//pick up any leftovers
+	{
+		TYPEREAL xr = pXRe[i];
+		TYPEREAL xi = pXIm[i];
+		pWRe[i] = Leak*pWRe[i] + StepRe*xr + StepIm*xi;
+		pWIm[i] = Leak*pWIm[i] + StepIm*xr - StepRe*xi;
+	}
+}
+
+#endif // SIMDOPS_H
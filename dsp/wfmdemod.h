@@ -4,6 +4,14 @@
 // History:
 //	2011-07-24  Initial creation MSW
 //	2011-08-05  Initial release
+//	2026-10-18  Replaced decimate by 2 chain with polyphase decimator
+//	2026-10-18  Moved RDS decoding to CRdsThread
+//	2026-10-18  Added Init() so one instance can be reused
+//	2026-10-18  Stereo buffers are allocated on first use and sized to the blocks
+//	2026-10-18  RDS thread is created by the first stereo block
+//	2026-10-18  Split out GetAudioDecimation() so the output rate can be planned
+//	2026-10-18  RDS thread is created once by the constructor
+//	2026-10-18  Decimators can be built on a control thread in CChains and swapped in
 /////////////////////////////////////////////////////////////////////
 //==========================================================================================
 // + + +   This Software is released under the "Simplified BSD License"  + + +
@@ -37,32 +45,52 @@
 #define WFMDEMOD_H
 #include "dsp/datatypes.h"
 #include "dsp/fir.h"
+#include "dsp/polyphasefir.h"
 #include "dsp/iir.h"
 #include "dsp/downconvert.h"
-#include "dsp/rbdsconstants.h"
+#include "dsp/rdsdecoder.h"
+#include "dsp/scratcharena.h"
+#include "interface/rdsthread.h"
 #include "interface/wavefilewriter.h"
 
 
-#define PHZBUF_SIZE 16384
-
-#define RDS_Q_SIZE 100
-
 class CWFmDemod
 {
 public:
 	CWFmDemod(TYPEREAL samplerate);
 	virtual ~CWFmDemod();
 
-	TYPEREAL SetSampleRate(TYPEREAL samplerate, bool USver);
+	//decimators SetSampleRate() needs for one sample rate.  A control thread
+	//builds them so the DSP thread only swaps them in.
+	class CChains
+	{
+	public:
+		CChains() : m_SampleRate(0.0) {}
+		void Build(TYPEREAL samplerate);
+	private:
+		friend class CWFmDemod;
+		TYPEREAL m_SampleRate;
+		CMultiStageDecimate m_AudioDecimate;
+		CDownConvert::CChain m_Rds;
+	};
+
+	//pChains built for samplerate are swapped in, otherwise the decimators are built here
+	TYPEREAL SetSampleRate(TYPEREAL samplerate, bool USver, CChains* pChains = NULL);
+	TYPEREAL Init(TYPEREAL samplerate, bool USver, CChains* pChains = NULL);	//SetSampleRate() and clear the lock and RDS state
 	//overloaded functions for mono and stereo
 	int ProcessData(int InLength, TYPECPX* pInData, TYPECPX* pOutData);
 	int ProcessData(int InLength, TYPECPX* pInData, TYPEREAL* pOutData);
 	TYPEREAL GetDemodRate(){return m_OutRate;}
+	static int GetAudioDecimation(TYPEREAL samplerate);	//audio decimation SetSampleRate() uses
 
 	int GetNextRdsGroupData(tRDS_GROUPS* pGroupData);
 	int GetStereoLock(int* pPilotLock);
+	int GetMemorySize();	//bytes used by this object and its buffers
+	void Release();	//frees the stereo buffers and idles the RDS thread while WFM is not in use
 
 private:
+	void AllocBuffers(int Length);
+	void FreeBuffers();
 	void InitPll( TYPEREAL SampleRate );
 	void ProcessPll( int InLength, TYPECPX* pInData, TYPEREAL* pOutData );
 	void InitDeemphasis( TYPEREAL Time, TYPEREAL SampleRate);	//create De-emphasis LP filter
@@ -70,21 +98,17 @@ private:
 	void ProcessDeemphasisFilter(int InLength, TYPECPX* InBuf, TYPECPX* OutBuf);
 	void InitPilotPll( TYPEREAL SampleRate );
 	bool ProcessPilotPll( int InLength, TYPECPX* pInData );
-	void InitRds( TYPEREAL SampleRate );
-	void ProcessRdsPll( int InLength, TYPECPX* pInData, TYPEREAL* pOutData );
-	inline TYPEREAL arctan2(TYPEREAL y, TYPEREAL x);
-
-	void ProcessNewRdsBit(int bit);
-	quint32 CheckBlock(quint32 BlockOffset, int UseFec);
-	void CreateCallSign(quint16 PIcode);
 
 	TYPEREAL m_SampleRate;
 	TYPEREAL m_OutRate;
-	TYPEREAL m_RawFm[PHZBUF_SIZE];
-	TYPECPX m_CpxRawFm[PHZBUF_SIZE];
-	CDecimateBy2* m_pDecBy2A;
-	CDecimateBy2* m_pDecBy2B;
-	CDecimateBy2* m_pDecBy2C;
+	//stereo and RDS buffers. Only the stereo ProcessData() uses them so
+	// they are allocated by its first call and sized to its blocks
+	CScratchArena m_Scratch;
+	int m_BufLength;
+	TYPEREAL* m_pRawFm;
+	TYPECPX* m_pCpxRawFm;
+	TYPEREAL* m_pPilotPhase;
+	CMultiStageDecimate m_AudioDecimate;
 
 	TYPECPX m_D0;		//complex delay line variables
 	TYPECPX m_D1;
@@ -114,42 +138,12 @@ private:
 	TYPEREAL m_PilotPllBeta;
 	TYPEREAL m_PhaseErrorMagAve;
 	TYPEREAL m_PhaseErrorMagAlpha;
-	TYPEREAL m_PilotPhase[PHZBUF_SIZE];
 	TYPEREAL m_PilotPhaseAdjust;
 
-	TYPEREAL m_RdsNcoPhase;		//variables for RDS PLL
-	TYPEREAL m_RdsNcoFreq;
-	TYPEREAL m_RdsNcoAcc;
-	TYPEREAL m_RdsNcoLLimit;
-	TYPEREAL m_RdsNcoHLimit;
-	TYPEREAL m_RdsPllAlpha;
-	TYPEREAL m_RdsPllBeta;
-
-	TYPECPX m_RdsRaw[PHZBUF_SIZE];	//variables for RDS processing
-	TYPEREAL m_RdsMag[PHZBUF_SIZE];
-	TYPEREAL m_RdsData[PHZBUF_SIZE];
-	TYPEREAL m_RdsMatchCoef[PHZBUF_SIZE];
-	TYPEREAL m_RdsLastSync;
-	TYPEREAL m_RdsLastSyncSlope;
-	TYPEREAL m_RdsLastData;
-	int m_MatchCoefLength;
 	CDownConvert m_RdsDownConvert;
-	CFir m_RdsBPFilter;
-	CFir m_RdsMatchedFilter;
-	CIir m_RdsBitSyncFilter;
 	TYPEREAL m_RdsOutputRate;
-	int m_RdsLastBit;
-	tRDS_GROUPS m_RdsGroupQueue[RDS_Q_SIZE];
-	int m_RdsQHead;
-	int m_RdsQTail;
+	CRdsThread* m_pRdsThread;	//lives as long as this object so no thread starts or stops it
 	tRDS_GROUPS m_LastRdsGroup;
-	quint32 m_InBitStream;	//input shift register for incoming raw data
-	int m_CurrentBlock;
-	int m_CurrentBitPosition;
-	int m_DecodeState;
-	int m_BGroupOffset;
-	int m_BlockErrors;
-	quint16 m_BlockData[4];
 };
 
 #endif // WFMDEMOD_H
@@ -4,6 +4,8 @@
 //
 // History:
 //	2015-02-21  Initial creation MSW
+//	2026-10-18  Added CW skimmer enable
+//	2026-10-18  Added multi-channel DSC enable
 //////////////////////////////////////////////////////////////////////
 
 //==========================================================================================
@@ -55,6 +57,8 @@ CChatDialog::CChatDialog(QWidget *parent, Qt::WindowFlags f) :
 	setWindowTitle("PSK/FSK Text");
 	ui->comboBoxPskMode->addItem("BPSK31");
 	ui->comboBoxPskMode->addItem("BPSK63");
+	ui->comboBoxPskMode->addItem("Multi BPSK31");
+	ui->comboBoxPskMode->addItem("Multi BPSK63");
 }
 
 CChatDialog::~CChatDialog()
@@ -93,6 +97,18 @@ qDebug()<<"Mode="<<index;
 		m_pSdrInterface->SetPskMode(index);
 }
 
+void CChatDialog::OnCwSkimmer(bool On)
+{
+	if(m_pSdrInterface)
+		m_pSdrInterface->SetCwSkimmer(On);
+}
+
+void CChatDialog::OnMultiFsk(bool On)
+{
+	if(m_pSdrInterface)
+		m_pSdrInterface->SetFskMode(On);
+}
+
 void CChatDialog::OnClear()
 {
 	ui->plainTextEditRx->clear();
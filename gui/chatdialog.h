@@ -5,6 +5,8 @@
 //
 // History:
 //	2015-02-21  Initial creation MSW
+//	2026-10-18  Added CW skimmer enable
+//	2026-10-18  Added multi-channel DSC enable
 //////////////////////////////////////////////////////////////////////
 //==========================================================================================
 // + + +   This Software is released under the "Simplified BSD License"  + + +
@@ -62,6 +64,8 @@ private slots:
 	void GotChatData(quint8 ch);
 	void OnClear();
 	void OnPskModeChanged(int index);
+	void OnCwSkimmer(bool On);
+	void OnMultiFsk(bool On);
 
 private:
 	Ui::CChatDialog *ui;
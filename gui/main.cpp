@@ -1,8 +1,20 @@
 #include <QApplication>
+#include <string.h>
 #include "gui/mainwindow.h"
+#include "bench/bench.h"
 
 int main(int argc, char *argv[])
 {
+	if( (argc > 2) && (0 == strcmp(argv[1], "-rdsbatch")) )
+		return RdsBatchMain(argc, argv);
+	if( (argc > 1) && (0 == strcmp(argv[1], "-cwbench")) )
+		return CwBenchMain(argc, argv);
+	if( (argc > 1) && (0 == strcmp(argv[1], "-fskbench")) )
+		return FskBenchMain(argc, argv);
+	if( (argc > 1) && (0 == strcmp(argv[1], "-precbench")) )
+		return PrecBenchMain(argc, argv);
+	if( (argc > 1) && (0 == strcmp(argv[1], "-streamclient")) )
+		return StreamClientMain(argc, argv);
 	QApplication a(argc, argv);
 	MainWindow w;
 	w.show();
@@ -229,6 +229,9 @@ MainWindow::MainWindow(QWidget *parent) :
 										  &m_NCOSpurOffsetQ);
 
 	m_pSdrInterface->SetSoundCardSelection(m_SoundInIndex, m_SoundOutIndex, m_StereoOut);
+	m_pSdrInterface->SetSoundLatency(m_SoundLatencyMs);
+	m_pSdrInterface->SetAudioSinks(m_AudioSinks);
+	m_pSdrInterface->SetSquelchGate(m_SquelchGate);
 	m_pSdrInterface->SetSpectrumInversion(m_InvertSpectrum);
 	m_pSdrInterface->SetUSFmVersion(m_USFm);
 
@@ -343,6 +346,9 @@ void MainWindow::writeSettings()
 	settings.setValue(tr("BandwidthIndex"), m_BandwidthIndex );
 	settings.setValue(tr("SoundInIndex"),m_SoundInIndex);
 	settings.setValue(tr("SoundOutIndex"),m_SoundOutIndex);
+	settings.setValue(tr("SoundLatencyMs"),m_SoundLatencyMs);
+	settings.setValue(tr("AudioSinks"),m_AudioSinks);
+	settings.setValue(tr("SquelchGate"),m_SquelchGate);
 	settings.setValue(tr("StereoOut"),m_StereoOut);
 	settings.setValue(tr("VertScaleIndex"),m_VertScaleIndex);
 	settings.setValue(tr("MaxdB"),m_MaxdB);
@@ -388,6 +394,9 @@ void MainWindow::writeSettings()
 	settings.setValue(tr("NBOn"),m_NoiseProcSettings.NBOn);
 	settings.setValue(tr("NBThreshold"),m_NoiseProcSettings.NBThreshold);
 	settings.setValue(tr("NBWidth"),m_NoiseProcSettings.NBWidth);
+	settings.setValue(tr("NROn"),m_NoiseProcSettings.NROn);
+	settings.setValue(tr("NRLevel"),m_NoiseProcSettings.NRLevel);
+	settings.setValue(tr("NotchOn"),m_NoiseProcSettings.NotchOn);
 
 	settings.endGroup();
 
@@ -464,6 +473,9 @@ void MainWindow::readSettings()
 	m_BandwidthIndex = settings.value(tr("BandwidthIndex"), 0).toInt();
 	m_SoundInIndex = settings.value(tr("SoundInIndex"), 0).toInt();
 	m_SoundOutIndex = settings.value(tr("SoundOutIndex"), 0).toInt();
+	m_SoundLatencyMs = settings.value(tr("SoundLatencyMs"), 0).toInt();	//0 = robust mode
+	m_AudioSinks = settings.value(tr("AudioSinks")).toStringList();	//"raw:-", "wav:<file>", "udp:127.0.0.1:<port>"
+	m_SquelchGate = settings.value(tr("SquelchGate"), false).toBool();
 	m_StereoOut = settings.value(tr("StereoOut"), false).toBool();
 	m_VertScaleIndex = settings.value(tr("VertScaleIndex"), 0).toInt();
 	m_MaxdB = settings.value(tr("MaxdB"), 0).toInt();
@@ -499,6 +511,9 @@ void MainWindow::readSettings()
 
 	m_NoiseProcSettings.NBThreshold = settings.value(tr("NBThreshold"),0).toInt();
 	m_NoiseProcSettings.NBWidth = settings.value(tr("NBWidth"),50).toInt();
+	m_NoiseProcSettings.NROn = settings.value(tr("NROn"), false).toBool();
+	m_NoiseProcSettings.NRLevel = settings.value(tr("NRLevel"),15).toInt();
+	m_NoiseProcSettings.NotchOn = settings.value(tr("NotchOn"), false).toBool();
 
 	m_DemodMode = settings.value(tr("DemodMode"), DEMOD_AM).toInt();
 	m_RecordMode = settings.value(tr("RecordMode"), 0).toInt();
@@ -606,6 +621,24 @@ void MainWindow::OnTimer()
 		if(update)
 			ui->framePlot->UpdateOverlay();
 	}
+	else if(DEMOD_PSK == m_DemodMode)
+	{	//show any lines from the multi-channel PSK decoder tagged with their RF frequency
+		tPSK_TEXT PskText;
+		while( m_pSdrInterface->GetNextPskText(&PskText) )
+			emit g_pChatDialog->SendChatStr( QString("%1 Hz: %2").arg(m_DemodFrequency + PskText.Freq).arg(PskText.Text) );
+	}
+	else if(DEMOD_FSK == m_DemodMode)
+	{	//same for the multi-channel DSC decoder
+		tFSK_TEXT FskText;
+		while( m_pSdrInterface->GetNextFskText(&FskText) )
+			emit g_pChatDialog->SendChatStr( QString("%1 Hz: %2").arg(m_DemodFrequency + FskText.Freq).arg(FskText.Text) );
+	}
+	//show any CW skimmer spots tagged with their RF frequency
+	tCW_SPOT Spot;
+	while( m_pSdrInterface->GetNextCwSpot(&Spot) )
+		emit g_pChatDialog->SendChatStr( QString("CW %1 kHz  %2  %3 WPM")
+										 .arg((m_CenterFrequency + Spot.Freq)/1000.0, 0, 'f', 1)
+										 .arg(Spot.Call).arg(Spot.Wpm) );
 }
 
 /////////////////////////////////////////////////////////////////////
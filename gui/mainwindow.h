@@ -101,6 +101,9 @@ private:
 	qint32 m_BandwidthIndex;
 	qint32 m_SoundInIndex;
 	qint32 m_SoundOutIndex;
+	qint32 m_SoundLatencyMs;
+	QStringList m_AudioSinks;
+	bool m_SquelchGate;
 	qint32 m_MaxDisplayRate;
 	qint32 m_VertScaleIndex;
 	qint32 m_dBStepSize;
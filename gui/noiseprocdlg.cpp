@@ -6,6 +6,8 @@
 // History:
 //	2011-02-05  Initial creation MSW
 //	2011-03-27  Initial release
+//	2026-10-18  Added noise reduction controls
+//	2026-10-18  Added auto notch control
 /////////////////////////////////////////////////////////////////////
 
 //==========================================================================================
@@ -37,6 +39,7 @@
 //or implied, of Moe Wheatley.
 //==========================================================================================
 #include "gui/noiseprocdlg.h"
+#include "dsp/noisereduce.h"
 #include "gui/mainwindow.h"
 #include "ui_noiseprocdlg.h"
 #include <QDebug>
@@ -63,6 +66,14 @@ CNoiseProcDlg::CNoiseProcDlg(QWidget *parent) :
 	ui->frameNBWidth->setPageStep(10);
 	ui->frameNBWidth->setTickInterval(30);
 
+	connect(ui->frameNRLevel, SIGNAL(sliderValChanged(int)), this, SLOT(OnNRLevel(int)));
+	ui->frameNRLevel->SetName("Level");
+	ui->frameNRLevel->SetSuffix(" dB");
+	ui->frameNRLevel->setRange(0, NR_MAX_LEVEL);
+	ui->frameNRLevel->setSingleStep(1);
+	ui->frameNRLevel->setPageStep(3);
+	ui->frameNRLevel->setTickInterval(5);
+
 }
 
 CNoiseProcDlg::~CNoiseProcDlg()
@@ -82,6 +93,15 @@ void CNoiseProcDlg::InitDlg(tNoiseProcdInfo* pNoiseProcSettings)
 		ui->checkBoxNBOn->setChecked(false);
 	ui->frameNBThresh->SetValue(m_pNoiseProcSettings->NBThreshold);
 	ui->frameNBWidth->SetValue(m_pNoiseProcSettings->NBWidth);
+	if(m_pNoiseProcSettings->NROn)
+		ui->checkBoxNROn->setChecked(true);
+	else
+		ui->checkBoxNROn->setChecked(false);
+	ui->frameNRLevel->SetValue(m_pNoiseProcSettings->NRLevel);
+	if(m_pNoiseProcSettings->NotchOn)
+		ui->checkBoxNotchOn->setChecked(true);
+	else
+		ui->checkBoxNotchOn->setChecked(false);
 }
 
 void CNoiseProcDlg::OnNBOn(bool On)
@@ -111,4 +131,29 @@ void CNoiseProcDlg::OnNBWidth(int val)
 	}
 }
 
+void CNoiseProcDlg::OnNROn(bool On)
+{
+	if(m_pNoiseProcSettings)
+	{
+		m_pNoiseProcSettings->NROn = On;
+		((MainWindow*)this->parent())->SetupNoiseProc();
+	}
+}
+
+void CNoiseProcDlg::OnNRLevel(int val)
+{
+	if(m_pNoiseProcSettings)
+	{
+		m_pNoiseProcSettings->NRLevel = val;
+		((MainWindow*)this->parent())->SetupNoiseProc();
+	}
 
+void CNoiseProcDlg::OnNotchOn(bool On)
+{
+	if(m_pNoiseProcSettings)
+	{
+		m_pNoiseProcSettings->NotchOn = On;
+		((MainWindow*)this->parent())->SetupNoiseProc();
+	}
+}
+}
@@ -4,6 +4,8 @@
 // History:
 //	2011-02-6  Initial creation MSW
 //	2011-03-27  Initial release
+//	2026-10-18  Added noise reduction controls
+//	2026-10-18  Added auto notch control
 /////////////////////////////////////////////////////////////////////
 #ifndef NOISEPROCDLG_H
 #define NOISEPROCDLG_H
@@ -30,6 +32,9 @@ private slots:
 	void OnNBThresh(int);
 	void OnNBWidth(int);
 	void OnNBOn(bool);
+	void OnNRLevel(int);
+	void OnNROn(bool);
+	void OnNotchOn(bool);
 
 
 private:
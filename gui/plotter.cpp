@@ -8,6 +8,7 @@
 //	2010-09-15  Initial creation MSW
 //	2011-03-27  Initial release
 //	2012-02-11  Fixed compiler warning
+//	2026-10-18  Line buffers come from a scratch arena sized to the screen width
 //////////////////////////////////////////////////////////////////////
 
 //==========================================================================================
@@ -47,7 +48,6 @@
 //////////////////////////////////////////////////////////////////////
 // Local defines
 //////////////////////////////////////////////////////////////////////
-#define MAX_SCREENSIZE 4096
 #define CUR_CUT_DELTA 10		//cursor capture delta in pixels
 #define OVERLOAD_DISPLAY_LIMIT 3
 
@@ -55,8 +55,10 @@
 // Construction/Destruction
 //////////////////////////////////////////////////////////////////////
 CPlotter::CPlotter(QWidget *parent) :
-	QFrame(parent)
+	QFrame(parent), m_Scratch("Plotter")
 {
+	m_FftBufOffset = 0;
+	m_LineBufOffset = 0;
 	m_pSdrInterface = NULL;
 	setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
 	setFocusPolicy(Qt::StrongFocus);
@@ -432,6 +434,10 @@ void CPlotter::resizeEvent(QResizeEvent* )
 		m_2DPixmap = QPixmap(m_Size.width(), m_Percent2DScreen*m_Size.height()/100);
 		m_2DPixmap.fill(Qt::black);
 		m_WaterfallPixmap = QPixmap(m_Size.width(), (100-m_Percent2DScreen)*m_Size.height()/100);
+		m_Scratch.Begin();
+		m_FftBufOffset = m_Scratch.Add(m_Size.width()*sizeof(qint32));
+		m_LineBufOffset = m_Scratch.Add(m_Size.width()*sizeof(QPoint));
+		m_Scratch.End();
 	}
 	m_WaterfallPixmap.fill(Qt::black);
 	DrawOverlay();
@@ -460,8 +466,8 @@ void CPlotter::draw()
 int i;
 int w;
 int h;
-qint32 fftbuf[MAX_SCREENSIZE];
-QPoint LineBuf[MAX_SCREENSIZE];
+qint32* fftbuf = (qint32*)m_Scratch.Get(m_FftBufOffset);
+QPoint* LineBuf = (QPoint*)m_Scratch.Get(m_LineBufOffset);
 
 	if(!m_Running)
 		return;
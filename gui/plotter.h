@@ -4,6 +4,7 @@
 // History:
 //	2010-09-15  Initial creation MSW
 //	2011-03-27  Initial release
+//	2026-10-18  Line buffers come from a scratch arena sized to the screen width
 /////////////////////////////////////////////////////////////////////
 #ifndef PLOTTER_H
 #define PLOTTER_H
@@ -88,6 +89,9 @@ private:
 	QPixmap m_WaterfallPixmap;
 	QColor m_ColorTbl[256];
 	QSize m_Size;
+	CScratchArena m_Scratch;	//one screen line of FFT data and points
+	int m_FftBufOffset;
+	int m_LineBufOffset;
 	QString m_Str;
 	QString m_HDivText[HORZ_DIVS+1];
 	bool m_Running;
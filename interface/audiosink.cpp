@@ -0,0 +1,255 @@
+/////////////////////////////////////////////////////////////////////
+// audiosink.cpp: implementation of the audio sink classes.
+//
+//	These classes take the resampled audio from CSoundOut and send it
+// to a file, stdout or a UDP port so the program can run without a
+// sound device or feed other programs.
+// History:
+//	2026-10-18  Initial creation
+//	2026-10-18  Added "stream:" CAudioStreamServer sink
+//	2026-10-18  Raw and UDP PCM are written little endian on any host
+//	2026-10-18  UDP socket is created and deleted with the sink
+/////////////////////////////////////////////////////////////////////
+//==========================================================================================
+// + + +   This Software is released under the "Simplified BSD License"  + + +
+//Copyright 2010 Moe Wheatley. All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification, are
+//permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice, this list of
+//	  conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice, this list
+//	  of conditions and the following disclaimer in the documentation and/or other materials
+//	  provided with the distribution.
+//
+//THIS SOFTWARE IS PROVIDED BY Moe Wheatley ``AS IS'' AND ANY EXPRESS OR IMPLIED
+//WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+//FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Moe Wheatley OR
+//CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+//ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+//ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//The views and conclusions contained in the software and documentation are those of the
+//authors and should not be interpreted as representing official policies, either expressed
+//or implied, of Moe Wheatley.
+//==========================================================================================
+#include "interface/audiosink.h"
+#include "interface/audiostreamer.h"
+#include <QDebug>
+#include <QtEndian>
+#include <stdio.h>
+#include <string.h>
+
+/////////////////////////////////////////////////////////////////////
+// Creates a sink from a text description
+//   "raw:<file>"  raw PCM to file, "raw:-" raw PCM to stdout
+//   "wav:<file>"  WAV file(a time stamp is added to the name)
+//   "udp:<address>:<port>"  PCM datagrams
+//   "stream:<port>[:adpcm|ulaw[:<rate>]]"  compressed audio server
+/////////////////////////////////////////////////////////////////////
+CAudioSink* CAudioSink::Create(const QString& Spec)
+{
+CAudioSink* pSink = NULL;
+	QString type = Spec.section(':', 0, 0).toLower();
+	QString arg = Spec.section(':', 1);
+	if(arg.isEmpty())
+		return NULL;
+	if("raw" == type)
+	{
+		pSink = new CRawFileSink(arg);
+	}
+	else if("wav" == type)
+	{
+		pSink = new CWavFileSink(arg);
+	}
+	else if("udp" == type)
+	{
+		QHostAddress Address(arg.section(':', 0, 0));
+		bool ok;
+		quint16 Port = arg.section(':', 1, 1).toUShort(&ok);
+		if(Address.isNull() || !ok)
+			return NULL;
+		pSink = new CUdpPcmSink(Address, Port);
+	}
+	else if("stream" == type)
+	{
+		bool ok;
+		quint16 Port = arg.section(':', 0, 0).toUShort(&ok);
+		if(!ok)
+			return NULL;
+		int Codec = STREAM_CODEC_ADPCM;
+		QString CodecName = arg.section(':', 1, 1).toLower();
+		if("ulaw" == CodecName)
+			Codec = STREAM_CODEC_ULAW;
+		else if( !CodecName.isEmpty() && ("adpcm" != CodecName) )
+			return NULL;
+		int Rate = STREAM_DEF_RATE;
+		if( !arg.section(':', 2, 2).isEmpty() )
+		{
+			Rate = arg.section(':', 2, 2).toInt(&ok);
+			if(!ok)
+				return NULL;
+		}
+		pSink = new CAudioStreamServer(Port, Codec, Rate);
+	}
+	if(pSink)
+		pSink->m_Spec = Spec;
+	return pSink;
+}
+
+/////////////////////////////////////////////////////////////////////
+// Writes NumFrames frames of Channels interleaved samples.
+// Opens the sink on the first call and reopens it if the format changes.
+// Returns false if the sink could not be written.
+/////////////////////////////////////////////////////////////////////
+bool CAudioSink::Write(const qint16* pData, int NumFrames, int Channels, int Rate)
+{
+	if( !m_IsOpen || (Channels != m_Channels) || (Rate != m_Rate) )
+	{
+		Close();
+		m_Channels = Channels;
+		m_Rate = Rate;
+		m_IsOpen = OpenSink(Channels, Rate);
+		if(!m_IsOpen)
+		{
+			qDebug()<<"Audio sink open failed "<<m_Spec;
+			return false;
+		}
+	}
+	if(NumFrames <= 0)
+		return true;
+	return WriteSink(pData, NumFrames);
+}
+
+void CAudioSink::Close()
+{
+	if(m_IsOpen)
+		CloseSink();
+	m_IsOpen = false;
+}
+
+// *&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*
+
+bool CRawFileSink::OpenSink(int Channels, int Rate)
+{
+	Q_UNUSED(Channels);
+	Q_UNUSED(Rate);
+	if("-" == m_FileName)
+		return m_File.open(stdout, QIODevice::WriteOnly | QIODevice::Unbuffered);
+	m_File.setFileName(m_FileName);
+	return m_File.open(QIODevice::WriteOnly | QIODevice::Truncate);
+}
+
+/////////////////////////////////////////////////////////////////////
+// Writes little endian PCM. Big endian hosts swap the samples in
+//chunks of RAW_SWAP_SAMPLES.
+/////////////////////////////////////////////////////////////////////
+bool CRawFileSink::WriteSink(const qint16* pData, int NumFrames)
+{
+#if Q_BYTE_ORDER == Q_BIG_ENDIAN
+	int Samples = NumFrames*m_Channels;
+	while(Samples > 0)
+	{
+		int n = (Samples > RAW_SWAP_SAMPLES) ? RAW_SWAP_SAMPLES : Samples;
+		for(int i=0; i<n; i++)
+			m_Swap[i] = qToLittleEndian<qint16>(pData[i]);
+		qint64 len = (qint64)n*sizeof(qint16);
+		if(m_File.write((const char*)m_Swap, len) != len)
+			return false;
+		pData += n;
+		Samples -= n;
+	}
+	return true;
+#else
+	qint64 len = (qint64)NumFrames*m_Channels*sizeof(qint16);
+	return (m_File.write((const char*)pData, len) == len);
+#endif
+}
+
+void CRawFileSink::CloseSink()
+{
+	m_File.close();
+}
+
+// *&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*
+
+bool CWavFileSink::OpenSink(int Channels, int Rate)
+{
+	return m_Writer.open(m_FileName, (2 == Channels), Rate, false, 0);
+}
+
+bool CWavFileSink::WriteSink(const qint16* pData, int NumFrames)
+{
+	return m_Writer.Write( (qint8*)pData, NumFrames*m_Channels*sizeof(qint16) );
+}
+
+void CWavFileSink::CloseSink()
+{
+	m_Writer.close();
+}
+
+// *&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*
+
+/////////////////////////////////////////////////////////////////////
+// The socket is created and bound here and deleted by the destructor
+//so one thread owns it. Since it is already bound writeDatagram() on
+//the DSP thread never changes its state.
+/////////////////////////////////////////////////////////////////////
+CUdpPcmSink::CUdpPcmSink(const QHostAddress& Address, quint16 Port)
+{
+	m_Address = Address;
+	m_Port = Port;
+	m_SeqNum = 0;
+	m_pSocket = new QUdpSocket;
+	m_pSocket->bind();
+}
+
+CUdpPcmSink::~CUdpPcmSink()
+{
+	Close();
+	delete m_pSocket;
+}
+
+bool CUdpPcmSink::OpenSink(int Channels, int Rate)
+{
+	Q_UNUSED(Channels);
+	Q_UNUSED(Rate);
+	return true;
+}
+
+/////////////////////////////////////////////////////////////////////
+// Sends the data in datagrams of up to UDP_PCM_MAXFRAMES frames each
+//preceded by a tUdpPcmHeader. Everything is sent little endian.
+/////////////////////////////////////////////////////////////////////
+bool CUdpPcmSink::WriteSink(const qint16* pData, int NumFrames)
+{
+tUdpPcmHeader* pHdr = (tUdpPcmHeader*)m_Packet;
+qint16* pOut = (qint16*)&m_Packet[sizeof(tUdpPcmHeader)];
+	while(NumFrames > 0)
+	{
+		int n = (NumFrames > UDP_PCM_MAXFRAMES) ? UDP_PCM_MAXFRAMES : NumFrames;
+		int len = n*m_Channels*sizeof(qint16);
+		pHdr->Magic = qToLittleEndian<quint32>(UDP_PCM_MAGIC);
+		pHdr->SeqNum = qToLittleEndian<quint32>(m_SeqNum++);
+		pHdr->SampleRate = qToLittleEndian<quint32>(m_Rate);
+		pHdr->Channels = qToLittleEndian<quint16>(m_Channels);
+		pHdr->NumFrames = qToLittleEndian<quint16>(n);
+		for(int i=0; i<n*m_Channels; i++)
+			pOut[i] = qToLittleEndian<qint16>(pData[i]);
+		//a full or missing receiver just loses datagrams
+		m_pSocket->writeDatagram(m_Packet, sizeof(tUdpPcmHeader) + len, m_Address, m_Port);
+		pData += n*m_Channels;
+		NumFrames -= n;
+	}
+	return true;
+}
+
+void CUdpPcmSink::CloseSink()
+{
+	//the socket is kept until the sink is deleted
+}
@@ -0,0 +1,156 @@
+//////////////////////////////////////////////////////////////////////
+// audiosink.h: interface for the audio sink classes.
+//
+//  An audio sink receives the resampled 16 bit soundcard rate audio from
+//CSoundOut so audio can leave the program without a sound device.
+//  CRawFileSink  writes raw little endian PCM to a file or to stdout.
+//  CWavFileSink  writes a WAV file through CWaveFileWriter.
+//  CUdpPcmSink   sends PCM datagrams with a sequence number header.
+//  CAudioStreamServer(audiostreamer.h) serves compressed audio to remote clients.
+//
+// History:
+//	2026-10-18  Initial creation
+//	2026-10-18  Added "stream:" CAudioStreamServer sink
+//	2026-10-18  Raw and UDP PCM are written little endian on any host
+//////////////////////////////////////////////////////////////////////
+//==========================================================================================
+// + + +   This Software is released under the "Simplified BSD License"  + + +
+//Copyright 2010 Moe Wheatley. All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification, are
+//permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice, this list of
+//	  conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice, this list
+//	  of conditions and the following disclaimer in the documentation and/or other materials
+//	  provided with the distribution.
+//
+//THIS SOFTWARE IS PROVIDED BY Moe Wheatley ``AS IS'' AND ANY EXPRESS OR IMPLIED
+//WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+//FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Moe Wheatley OR
+//CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+//ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+//ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//The views and conclusions contained in the software and documentation are those of the
+//authors and should not be interpreted as representing official policies, either expressed
+//or implied, of Moe Wheatley.
+//=============================================================================
+#ifndef AUDIOSINK_H
+#define AUDIOSINK_H
+
+#include <QFile>
+#include <QString>
+#include <QHostAddress>
+#include <QUdpSocket>
+#include "interface/wavefilewriter.h"
+
+#define UDP_PCM_MAXFRAMES 480	//max frames per datagram(10mSec at 48000)
+#define UDP_PCM_MAGIC 0x4D435055	//"UPCM"
+
+#define RAW_SWAP_SAMPLES 1024	//samples byte swapped per write on big endian hosts
+
+//header at the start of every UDP PCM datagram. The header and the
+//samples that follow are little endian.
+typedef struct _udppcmhdr
+{
+	quint32 Magic;
+	quint32 SeqNum;		//incremented for every datagram
+	quint32 SampleRate;
+	quint16 Channels;
+	quint16 NumFrames;	//number of frames of 16 bit samples that follow
+}tUdpPcmHeader;
+
+////////////
+//base class for all audio sinks
+// Write() is called from the DSP thread with interleaved 16 bit frames
+//straight from the CSoundOut resampler buffer. The sink is (re)opened
+//whenever the rate or number of channels changes.
+////////////
+class CAudioSink
+{
+public:
+	CAudioSink(){m_Rate = 0; m_Channels = 0; m_IsOpen = false;}
+	virtual ~CAudioSink(){}
+	bool Write(const qint16* pData, int NumFrames, int Channels, int Rate);
+	void Close();
+	QString GetSpec(){return m_Spec;}
+
+	//Creates sink from a string of the form "raw:<file>" ("raw:-" for stdout),
+	//"wav:<file>", "udp:<address>:<port>" or "stream:<port>[:adpcm|ulaw[:<rate>]]".
+	//Returns NULL if not valid.
+	static CAudioSink* Create(const QString& Spec);
+
+protected:
+	virtual bool OpenSink(int Channels, int Rate) = 0;
+	virtual bool WriteSink(const qint16* pData, int NumFrames) = 0;
+	virtual void CloseSink() = 0;
+	QString m_Spec;
+	int m_Rate;
+	int m_Channels;
+	bool m_IsOpen;
+};
+
+////////////
+//raw PCM to a file or stdout
+////////////
+class CRawFileSink : public CAudioSink
+{
+public:
+	CRawFileSink(const QString& FileName){m_FileName = FileName;}
+	~CRawFileSink(){Close();}
+protected:
+	bool OpenSink(int Channels, int Rate);
+	bool WriteSink(const qint16* pData, int NumFrames);
+	void CloseSink();
+private:
+	QString m_FileName;
+	QFile m_File;
+#if Q_BYTE_ORDER == Q_BIG_ENDIAN
+	qint16 m_Swap[RAW_SWAP_SAMPLES];
+#endif
+};
+
+////////////
+//WAV file through CWaveFileWriter
+////////////
+class CWavFileSink : public CAudioSink
+{
+public:
+	CWavFileSink(const QString& FileName){m_FileName = FileName;}
+	~CWavFileSink(){Close();}
+protected:
+	bool OpenSink(int Channels, int Rate);
+	bool WriteSink(const qint16* pData, int NumFrames);
+	void CloseSink();
+private:
+	QString m_FileName;
+	CWaveFileWriter m_Writer;
+};
+
+////////////
+//PCM datagrams to a UDP address (normally localhost)
+////////////
+class CUdpPcmSink : public CAudioSink
+{
+public:
+	CUdpPcmSink(const QHostAddress& Address, quint16 Port);
+	~CUdpPcmSink();
+protected:
+	bool OpenSink(int Channels, int Rate);
+	bool WriteSink(const qint16* pData, int NumFrames);
+	void CloseSink();
+private:
+	QHostAddress m_Address;
+	quint16 m_Port;
+	quint32 m_SeqNum;
+	QUdpSocket* m_pSocket;	//created and deleted on the thread that creates the sink
+	char m_Packet[sizeof(tUdpPcmHeader) + UDP_PCM_MAXFRAMES*2*sizeof(qint16)];
+};
+
+#endif // AUDIOSINK_H
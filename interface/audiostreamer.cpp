@@ -0,0 +1,361 @@
+/////////////////////////////////////////////////////////////////////
+// audiostreamer.cpp: implementation of the CAudioStreamServer class.
+//
+//	The DSP thread only mixes the audio to mono and puts it in a lock
+// free ring. Everything else runs on the server thread every 10 mSec:
+// decimation, encoding into the frame history and sending the frames.
+//	Each client has its own position in the frame history which acts as
+// its jitter queue. A new client is first sent the last JitterFrames frames
+// so its receive buffer starts full. A TCP client whose socket backs up
+// is held until it drains and is skipped ahead if it falls more than
+// 4*JitterFrames behind so the latency of a slow link stays bounded.
+// History:
+//	2026-10-18  Initial creation
+//	2026-10-18  Frame headers and subscriptions are little endian on any host
+/////////////////////////////////////////////////////////////////////
+//==========================================================================================
+// + + +   This Software is released under the "Simplified BSD License"  + + +
+//Copyright 2010 Moe Wheatley. All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification, are
+//permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice, this list of
+//	  conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice, this list
+//	  of conditions and the following disclaimer in the documentation and/or other materials
+//	  provided with the distribution.
+//
+//THIS SOFTWARE IS PROVIDED BY Moe Wheatley ``AS IS'' AND ANY EXPRESS OR IMPLIED
+//WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+//FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Moe Wheatley OR
+//CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+//ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+//ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//The views and conclusions contained in the software and documentation are those of the
+//authors and should not be interpreted as representing official policies, either expressed
+//or implied, of Moe Wheatley.
+//==========================================================================================
+#include "interface/audiostreamer.h"
+#include <string.h>
+#include <QDebug>
+#include <QtEndian>
+
+/////////////////////////////////////////////////////////////////////
+// Local Defines
+/////////////////////////////////////////////////////////////////////
+#define STREAM_TIMER_MS 10
+#define STREAM_DECIMATION_ASTOP 60.0
+#define STREAM_PASSBAND 0.40	//fraction of the output rate kept by the decimator
+
+CAudioStreamServer::CAudioStreamServer(quint16 Port, int Codec, int Rate)
+{
+	m_Port = Port;
+	m_Codec = Codec;
+	m_RequestedRate = Rate;
+	m_Rate = 0;
+	m_CurInRate = 0;
+	m_Decimation = 1;
+	m_FrameSamples = 0;
+	m_FrameLength = 0;
+	m_NewestSeq = 0;
+	m_NumClients = 0;
+	m_InRate = 0;
+	m_InOverflowCount = 0;
+	m_pTcpServer = NULL;
+	m_pUdpSocket = NULL;
+	m_pTimer = NULL;
+	for(int i=0; i<STREAM_HISTORY; i++)
+		m_HistoryLength[i] = 0;
+}
+
+CAudioStreamServer::~CAudioStreamServer()
+{
+	Close();
+	CleanupThread();	//tell thread to cleanup after itself by calling ThreadExit()
+}
+
+////////////////////////////////////////////////////////////////////////
+//  called by server worker thread to initialize its world
+////////////////////////////////////////////////////////////////////////
+void CAudioStreamServer::ThreadInit()
+{
+	m_Clock.start();
+	m_pTcpServer = new QTcpServer;
+	connect(m_pTcpServer, SIGNAL(newConnection()), this, SLOT(NewTcpClientSlot()) );
+	if( !m_pTcpServer->listen(QHostAddress::Any, m_Port) )
+		qDebug()<<"Audio stream TCP listen failed "<<m_Port;
+	m_pUdpSocket = new QUdpSocket;
+	connect(m_pUdpSocket, SIGNAL(readyRead()), this, SLOT(UdpSubscribeSlot()) );
+	if( !m_pUdpSocket->bind(QHostAddress::Any, m_Port) )
+		qDebug()<<"Audio stream UDP bind failed "<<m_Port;
+	m_pTimer = new QTimer;
+	connect(m_pTimer, SIGNAL(timeout()), this, SLOT(ProcessSlot()) );
+	m_pTimer->start(STREAM_TIMER_MS);
+qDebug()<<"Audio stream Thread "<<this->thread()->currentThread();
+}
+
+/////////////////////////////////////////////////////////////////////
+// Called by this worker thread to cleanup after itself
+/////////////////////////////////////////////////////////////////////
+void CAudioStreamServer::ThreadExit()
+{
+	disconnect();
+	while(m_NumClients)
+		RemoveClient(0);
+	if(m_pTimer)
+		delete m_pTimer;
+	if(m_pUdpSocket)
+		delete m_pUdpSocket;
+	if(m_pTcpServer)
+		delete m_pTcpServer;
+	m_pTimer = NULL;
+	m_pUdpSocket = NULL;
+	m_pTcpServer = NULL;
+}
+
+/////////////////////////////////////////////////////////////////////
+// DSP thread: the server thread picks up the new rate in ProcessSlot()
+/////////////////////////////////////////////////////////////////////
+bool CAudioStreamServer::OpenSink(int Channels, int Rate)
+{
+	Q_UNUSED(Channels);
+	m_InRate.storeRelease(Rate);
+	return true;
+}
+
+/////////////////////////////////////////////////////////////////////
+// DSP thread: mixes the frames to mono and queues them for the server.
+// If the server thread falls behind the newest samples are dropped.
+/////////////////////////////////////////////////////////////////////
+bool CAudioStreamServer::WriteSink(const qint16* pData, int NumFrames)
+{
+	while(NumFrames > 0)
+	{
+		int n = (NumFrames > STREAM_CHUNK_SIZE) ? STREAM_CHUNK_SIZE : NumFrames;
+		const qint16* pMono = pData;
+		if(2 == m_Channels)
+		{
+			for(int i=0; i<n; i++)
+				m_MonoBuf[i] = (qint16)( ((int)pData[2*i] + (int)pData[2*i+1]) >> 1 );
+			pMono = m_MonoBuf;
+		}
+		if( m_InQueue.Put(pMono, n) < n )
+			m_InOverflowCount.fetchAndAddRelaxed(1);
+		pData += n*m_Channels;
+		NumFrames -= n;
+	}
+	return true;
+}
+
+/////////////////////////////////////////////////////////////////////
+// Sets up the decimator for a new input rate. The output rate must
+//divide the input rate, if not the input rate is streamed.
+/////////////////////////////////////////////////////////////////////
+void CAudioStreamServer::SetupDecimator(int InRate)
+{
+	m_CurInRate = InRate;
+	m_Rate = m_RequestedRate;
+	if( (m_Rate <= 0) || (m_Rate > InRate) || (InRate % m_Rate) )
+		m_Rate = InRate;
+	m_Decimation = InRate/m_Rate;
+	if(m_Decimation > 1)
+		m_Decimator.InitLPFilter(m_Decimation, STREAM_DECIMATION_ASTOP,
+								 STREAM_PASSBAND*m_Rate, 0.5*m_Rate, InRate);
+	m_FrameSamples = (m_Rate*STREAM_FRAME_MS)/1000;
+	if(m_FrameSamples > STREAM_MAX_FRAME_SAMPLES)
+		m_FrameSamples = STREAM_MAX_FRAME_SAMPLES;
+	m_FrameLength = 0;
+	m_Adpcm.Reset();
+qDebug()<<"Audio stream rate "<<m_Rate<<" decimation "<<m_Decimation;
+}
+
+/////////////////////////////////////////////////////////////////////
+// Server thread timer: decimates and encodes all queued input then
+//sends the new frames to every client.
+/////////////////////////////////////////////////////////////////////
+void CAudioStreamServer::ProcessSlot()
+{
+	int InRate = m_InRate.loadAcquire();
+	if(InRate <= 0)
+		return;
+	if(InRate != m_CurInRate)
+		SetupDecimator(InRate);
+	int n;
+	while( (n = m_InQueue.Get(m_InBuf, STREAM_CHUNK_SIZE)) > 0 )
+	{
+		for(int i=0; i<n; i++)
+			m_RealBuf[i] = (TYPEREAL)m_InBuf[i];
+		if(m_Decimation > 1)
+			n = m_Decimator.ProcessData(n, m_RealBuf, m_RealBuf);
+		for(int i=0; i<n; i++)
+		{
+			TYPEREAL x = m_RealBuf[i];
+			if(x > 32767.0)
+				x = 32767.0;
+			else if(x < -32768.0)
+				x = -32768.0;
+			m_FrameBuf[m_FrameLength++] = (qint16)x;
+			if(m_FrameLength >= m_FrameSamples)
+				EncodeFrame();
+		}
+	}
+	qint64 now = m_Clock.elapsed();
+	for(int i=m_NumClients-1; i>=0; i--)
+	{
+		if( !m_Clients[i].pTcp && ((now - m_Clients[i].LastHeard) > STREAM_UDP_TIMEOUT) )
+			RemoveClient(i);
+		else
+			SendFrames(m_Clients[i]);
+	}
+}
+
+/////////////////////////////////////////////////////////////////////
+// Encodes m_FrameBuf into the next slot of the frame history.
+// This is the only place audio is encoded no matter how many clients.
+// The header is stored little endian.
+/////////////////////////////////////////////////////////////////////
+void CAudioStreamServer::EncodeFrame()
+{
+int PayloadLength;
+	int slot = m_NewestSeq % STREAM_HISTORY;
+	tAudioStreamHeader* pHdr = (tAudioStreamHeader*)m_History[slot];
+	quint8* pPayload = (quint8*)&m_History[slot][sizeof(tAudioStreamHeader)];
+	pHdr->Magic = qToLittleEndian<quint32>(STREAM_MAGIC);
+	pHdr->SeqNum = qToLittleEndian<quint32>(m_NewestSeq);
+	pHdr->SampleRate = qToLittleEndian<quint32>(m_Rate);
+	pHdr->NumSamples = qToLittleEndian<quint16>(m_FrameLength);
+	pHdr->AdpcmPredict = qToLittleEndian<qint16>(m_Adpcm.GetPredictor());
+	pHdr->AdpcmIndex = m_Adpcm.GetStepIndex();
+	pHdr->Codec = m_Codec;
+	if(STREAM_CODEC_ULAW == m_Codec)
+		PayloadLength = MuLawEncode(m_FrameBuf, m_FrameLength, pPayload);
+	else
+		PayloadLength = m_Adpcm.Encode(m_FrameBuf, m_FrameLength, pPayload);
+	pHdr->PayloadLength = qToLittleEndian<quint16>(PayloadLength);
+	m_HistoryLength[slot] = sizeof(tAudioStreamHeader) + PayloadLength;
+	m_NewestSeq++;
+	m_FrameLength = 0;
+}
+
+/////////////////////////////////////////////////////////////////////
+// Sends a client every frame from its position up to the newest frame.
+/////////////////////////////////////////////////////////////////////
+void CAudioStreamServer::SendFrames(tStreamClient& Client)
+{
+	int maxlag = 4*Client.JitterFrames;
+	if( (m_NewestSeq - Client.NextSeq) > (quint32)maxlag )
+		Client.NextSeq = m_NewestSeq - Client.JitterFrames;	//fell too far behind so skip ahead
+	while(Client.NextSeq != m_NewestSeq)
+	{
+		int slot = Client.NextSeq % STREAM_HISTORY;
+		if(Client.pTcp)
+		{	//hold a backed up TCP client until its socket drains
+			if( Client.pTcp->bytesToWrite() > (qint64)(Client.JitterFrames*m_HistoryLength[slot]) )
+				break;
+			Client.pTcp->write(m_History[slot], m_HistoryLength[slot]);
+		}
+		else
+		{
+			m_pUdpSocket->writeDatagram(m_History[slot], m_HistoryLength[slot],
+										Client.Address, Client.Port);
+		}
+		Client.NextSeq++;
+	}
+}
+
+/////////////////////////////////////////////////////////////////////
+// Adds a client and starts it JitterFrames frames in the past so
+//its receive buffer fills immediately.
+/////////////////////////////////////////////////////////////////////
+void CAudioStreamServer::AddClient(QTcpSocket* pTcp, const QHostAddress& Address, quint16 Port,
+								   int JitterFrames)
+{
+	if(m_NumClients >= STREAM_MAX_CLIENTS)
+	{
+		qDebug()<<"Audio stream client refused "<<Address.toString();
+		if(pTcp)
+			pTcp->deleteLater();
+		return;
+	}
+	if(JitterFrames <= 0)
+		JitterFrames = STREAM_DEF_JITTER_FRAMES;
+	if(JitterFrames > STREAM_HISTORY/4)
+		JitterFrames = STREAM_HISTORY/4;
+	tStreamClient& Client = m_Clients[m_NumClients++];
+	Client.pTcp = pTcp;
+	Client.Address = Address;
+	Client.Port = Port;
+	Client.JitterFrames = JitterFrames;
+	Client.NextSeq = m_NewestSeq - ( (m_NewestSeq < (quint32)JitterFrames) ? m_NewestSeq : JitterFrames );
+	Client.LastHeard = m_Clock.elapsed();
+qDebug()<<"Audio stream client "<<Address.toString()<<Port<<(pTcp ? "TCP" : "UDP");
+}
+
+void CAudioStreamServer::RemoveClient(int Index)
+{
+	if(m_Clients[Index].pTcp)
+	{
+		m_Clients[Index].pTcp->disconnect(this);
+		m_Clients[Index].pTcp->deleteLater();
+	}
+	m_NumClients--;
+	for(int i=Index; i<m_NumClients; i++)
+		m_Clients[i] = m_Clients[i+1];
+}
+
+void CAudioStreamServer::NewTcpClientSlot()
+{
+	while(m_pTcpServer->hasPendingConnections())
+	{
+		QTcpSocket* pTcp = m_pTcpServer->nextPendingConnection();
+		connect(pTcp, SIGNAL(disconnected()), this, SLOT(TcpClientGoneSlot()) );
+		pTcp->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+		AddClient(pTcp, pTcp->peerAddress(), pTcp->peerPort(), STREAM_DEF_JITTER_FRAMES);
+	}
+}
+
+void CAudioStreamServer::TcpClientGoneSlot()
+{
+	for(int i=0; i<m_NumClients; i++)
+	{
+		if(m_Clients[i].pTcp == sender())
+		{
+			RemoveClient(i);
+			break;
+		}
+	}
+}
+
+/////////////////////////////////////////////////////////////////////
+// A UDP client subscribes by sending a tAudioStreamSubscribe datagram
+//to the server port and must repeat it within STREAM_UDP_TIMEOUT.
+/////////////////////////////////////////////////////////////////////
+void CAudioStreamServer::UdpSubscribeSlot()
+{
+tAudioStreamSubscribe Sub;
+QHostAddress Address;
+quint16 Port;
+	while(m_pUdpSocket->hasPendingDatagrams())
+	{
+		qint64 len = m_pUdpSocket->readDatagram((char*)&Sub, sizeof(Sub), &Address, &Port);
+		if( (len < (qint64)sizeof(Sub)) || (STREAM_SUBSCRIBE_MAGIC != qFromLittleEndian<quint32>(Sub.Magic)) )
+			continue;
+		int i;
+		for(i=0; i<m_NumClients; i++)
+		{
+			if( !m_Clients[i].pTcp && (m_Clients[i].Port == Port) && (m_Clients[i].Address == Address) )
+			{
+				m_Clients[i].LastHeard = m_Clock.elapsed();
+				break;
+			}
+		}
+		if(i == m_NumClients)
+			AddClient(NULL, Address, Port, qFromLittleEndian<quint16>(Sub.JitterFrames));
+	}
+}
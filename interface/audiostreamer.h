@@ -0,0 +1,171 @@
+//////////////////////////////////////////////////////////////////////
+// audiostreamer.h: interface for the CAudioStreamServer class.
+//
+//  This is an audio sink that compresses the CSoundOut audio and
+//serves it to remote listeners over TCP and UDP.
+//  The audio is mixed to mono, optionally decimated to 8 or 12 kHz and
+//encoded once into 20 mSec frames with IMA ADPCM or mu-law. The last
+//STREAM_HISTORY frames are kept and every client just keeps its own
+//position in that history so the number of clients does not change
+//the encoding load.
+//
+// History:
+//	2026-10-18  Initial creation
+//	2026-10-18  Frame headers and subscriptions are little endian on any host
+//////////////////////////////////////////////////////////////////////
+//==========================================================================================
+// + + +   This Software is released under the "Simplified BSD License"  + + +
+//Copyright 2010 Moe Wheatley. All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification, are
+//permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice, this list of
+//	  conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice, this list
+//	  of conditions and the following disclaimer in the documentation and/or other materials
+//	  provided with the distribution.
+//
+//THIS SOFTWARE IS PROVIDED BY Moe Wheatley ``AS IS'' AND ANY EXPRESS OR IMPLIED
+//WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+//FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Moe Wheatley OR
+//CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+//ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+//ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//The views and conclusions contained in the software and documentation are those of the
+//authors and should not be interpreted as representing official policies, either expressed
+//or implied, of Moe Wheatley.
+//=============================================================================
+#ifndef AUDIOSTREAMER_H
+#define AUDIOSTREAMER_H
+
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QUdpSocket>
+#include <QHostAddress>
+#include <QTimer>
+#include <QElapsedTimer>
+#include "interface/threadwrapper.h"
+#include "interface/audiosink.h"
+#include "interface/spscring.h"
+#include "dsp/audiocodec.h"
+#include "dsp/polyphasefir.h"
+
+#define STREAM_MAGIC 0x52545341				//"ASTR" at the start of every frame
+#define STREAM_SUBSCRIBE_MAGIC 0x42555341	//"ASUB" UDP subscribe datagram
+
+#define STREAM_FRAME_MS 20				//length of one encoded frame
+#define STREAM_MAX_FRAME_SAMPLES 960	//20mSec at 48000
+#define STREAM_HISTORY 64				//frames kept for the client queues(1.28 Sec)
+#define STREAM_DEF_JITTER_FRAMES 5		//default client queue depth(100 mSec)
+#define STREAM_MAX_CLIENTS 16
+#define STREAM_UDP_TIMEOUT 10000		//mSec without a subscribe before a UDP client is dropped
+#define STREAM_INQ_SIZE 16384			//mono input samples queued from the DSP thread
+#define STREAM_CHUNK_SIZE 4096			//input samples processed per pass
+#define STREAM_DEF_RATE 8000
+
+enum eStreamCodec
+{
+	STREAM_CODEC_ADPCM = 1,
+	STREAM_CODEC_ULAW = 2
+};
+
+//header at the start of every frame(little endian).
+// TCP clients receive frames back to back, UDP clients one frame per datagram.
+typedef struct _audiostreamhdr
+{
+	quint32 Magic;
+	quint32 SeqNum;			//incremented for every frame
+	quint32 SampleRate;
+	quint16 NumSamples;		//mono 16 bit samples in this frame
+	quint16 PayloadLength;	//bytes of encoded data that follow the header
+	qint16 AdpcmPredict;	//ADPCM decoder state at the first sample
+	quint8 AdpcmIndex;
+	quint8 Codec;			//eStreamCodec
+}tAudioStreamHeader;
+
+//datagram a UDP client sends to the server port to start(and keep) receiving frames(little endian)
+typedef struct _audiostreamsub
+{
+	quint32 Magic;
+	quint16 JitterFrames;	//client queue depth in frames, 0 for the server default
+	quint16 Reserved;
+}tAudioStreamSubscribe;
+
+#define STREAM_MAX_FRAME_BYTES (sizeof(tAudioStreamHeader) + STREAM_MAX_FRAME_SAMPLES)
+
+class CAudioStreamServer : public CThreadWrapper, public CAudioSink
+{
+	Q_OBJECT
+public:
+	CAudioStreamServer(quint16 Port, int Codec, int Rate);
+	~CAudioStreamServer();
+
+protected:
+	//called on the DSP thread through CAudioSink::Write()
+	bool OpenSink(int Channels, int Rate);
+	bool WriteSink(const qint16* pData, int NumFrames);
+	void CloseSink(){}
+
+private slots:
+	void ThreadInit();	//overrided function is called by new thread when started
+	void ThreadExit();	//overrided function is called by new thread when stopped
+	void ProcessSlot();
+	void NewTcpClientSlot();
+	void TcpClientGoneSlot();
+	void UdpSubscribeSlot();
+
+private:
+	typedef struct _streamclient
+	{
+		QTcpSocket* pTcp;	//NULL for a UDP client
+		QHostAddress Address;
+		quint16 Port;
+		quint32 NextSeq;	//next frame to send this client
+		int JitterFrames;	//depth of this clients queue
+		qint64 LastHeard;	//time of the last UDP subscribe
+	}tStreamClient;
+
+	void SetupDecimator(int InRate);
+	void EncodeFrame();
+	void SendFrames(tStreamClient& Client);
+	void AddClient(QTcpSocket* pTcp, const QHostAddress& Address, quint16 Port, int JitterFrames);
+	void RemoveClient(int Index);
+
+	//shared with the DSP thread
+	CSpscRing<qint16, STREAM_INQ_SIZE> m_InQueue;
+	QAtomicInt m_InRate;
+	QAtomicInt m_InOverflowCount;
+	qint16 m_MonoBuf[STREAM_CHUNK_SIZE];	//DSP thread mixdown buffer
+
+	//used only by the server thread
+	quint16 m_Port;
+	int m_Codec;
+	int m_RequestedRate;
+	int m_Rate;				//encoded sample rate
+	int m_CurInRate;
+	int m_Decimation;
+	int m_FrameSamples;
+	int m_FrameLength;		//samples collected in m_FrameBuf
+	quint32 m_NewestSeq;	//sequence number of the next frame to be encoded
+	int m_NumClients;
+	CDecimateByM m_Decimator;
+	CImaAdpcm m_Adpcm;
+	QTcpServer* m_pTcpServer;
+	QUdpSocket* m_pUdpSocket;
+	QTimer* m_pTimer;
+	QElapsedTimer m_Clock;
+	tStreamClient m_Clients[STREAM_MAX_CLIENTS];
+	qint16 m_InBuf[STREAM_CHUNK_SIZE];
+	TYPEREAL m_RealBuf[STREAM_CHUNK_SIZE];
+	qint16 m_FrameBuf[STREAM_MAX_FRAME_SAMPLES];
+	int m_HistoryLength[STREAM_HISTORY];
+	char m_History[STREAM_HISTORY][STREAM_MAX_FRAME_BYTES];
+};
+
+#endif // AUDIOSTREAMER_H
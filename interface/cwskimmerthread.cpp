@@ -0,0 +1,353 @@
+/////////////////////////////////////////////////////////////////////
+// cwskimmerthread.cpp: implementation of the CCwSkimmer and CCwWorker classes.
+//
+//	The I/Q data thread only copies samples into the input ring. The
+// skimmer thread runs the channelizer and carrier search and sends the
+// power of every channel in use to each worker once per frame. Each
+// worker runs the decoders for the channels it owns so a decoder is never
+// touched by two threads. Callsigns are sent to the GUI as spots.
+// History:
+//	2026-10-18  Initial creation
+//	2026-10-18  NewData is connected before the first signal can be sent
+/////////////////////////////////////////////////////////////////////
+//==========================================================================================
+// + + +   This Software is released under the "Simplified BSD License"  + + +
+//Copyright 2010 Moe Wheatley. All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification, are
+//permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice, this list of
+//	  conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice, this list
+//	  of conditions and the following disclaimer in the documentation and/or other materials
+//	  provided with the distribution.
+//
+//THIS SOFTWARE IS PROVIDED BY Moe Wheatley ``AS IS'' AND ANY EXPRESS OR IMPLIED
+//WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+//FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Moe Wheatley OR
+//CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+//ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+//ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//The views and conclusions contained in the software and documentation are those of the
+//authors and should not be interpreted as representing official policies, either expressed
+//or implied, of Moe Wheatley.
+//==========================================================================================
+#include "interface/cwskimmerthread.h"
+#include <string.h>
+#include <QDebug>
+
+#define CHAN_SPACING 2		//new carriers this many bins or closer to a channel are ignored
+
+/////////////////////////////////////////////////////////////////////
+// Constructor/Destructor
+/////////////////////////////////////////////////////////////////////
+CCwWorker::CCwWorker(CCwSkimmer* pParent, int Index, int NumWorkers)
+{
+	m_pParent = pParent;
+	m_Index = Index;
+	m_NumWorkers = NumWorkers;
+	m_InitRequest = 0;
+	m_Pending = 0;
+	//connect now, Init() can signal before this thread has started
+	connect(this,SIGNAL( NewData()), this, SLOT(ProcNewData()), Qt::QueuedConnection );
+	m_OverflowCount = 0;
+	m_FrameRate = 100.0;
+	m_WorkerFrameRate = 100.0;
+	for(int i=0; i<CWSK_MAX_CHANNELS; i++)
+	{
+		m_WordLength[i] = 0;
+		m_LastCall[i][0] = 0;
+	}
+}
+
+CCwWorker::~CCwWorker()
+{
+	CleanupThread();	//tell thread to cleanup after itself by calling ThreadExit()
+}
+
+////////////////////////////////////////////////////////////////////////
+//  called by worker thread to initialize its world
+////////////////////////////////////////////////////////////////////////
+void CCwWorker::ThreadInit()
+{
+qDebug()<<"CW Worker Thread "<<m_Index<<this->thread()->currentThread();
+}
+
+/////////////////////////////////////////////////////////////////////
+// Called by this worker thread to cleanup after itself
+/////////////////////////////////////////////////////////////////////
+void CCwWorker::ThreadExit()
+{
+	disconnect();
+}
+
+/////////////////////////////////////////////////////////////////////
+// Skimmer thread: asks the worker to free its channels and use a new
+//frame rate. Queued frames at the old rate are thrown away.
+/////////////////////////////////////////////////////////////////////
+void CCwWorker::Init(TYPEREAL FrameRate)
+{
+	m_Mutex.lock();
+	m_FrameRate = FrameRate;
+	m_Mutex.unlock();
+	m_InitRequest.storeRelease(1);
+	if( 0 == m_Pending.fetchAndStoreOrdered(1) )
+		emit NewData();
+}
+
+/////////////////////////////////////////////////////////////////////
+// Skimmer thread: queues one frame of channel powers.
+// If the ring is full the frame is dropped.
+/////////////////////////////////////////////////////////////////////
+void CCwWorker::PutFrame(const tCW_FRAME* pFrame)
+{
+	if( m_InQueue.Put(pFrame, 1) < 1 )
+		m_OverflowCount.fetchAndAddRelaxed(1);
+	if( 0 == m_Pending.fetchAndStoreOrdered(1) )
+		emit NewData();	//tell worker thread there's data to process
+}
+
+/////////////////////////////////////////////////////////////////////
+// Worker thread: runs the decoders it owns over the queued frames
+/////////////////////////////////////////////////////////////////////
+void CCwWorker::ProcNewData()
+{
+	m_Pending.fetchAndStoreOrdered(0);	//clear before reading so new data always gets a signal
+	if( m_InitRequest.fetchAndStoreAcquire(0) )
+	{
+		m_Mutex.lock();
+		m_WorkerFrameRate = m_FrameRate;
+		m_Mutex.unlock();
+		m_InQueue.Skip( m_InQueue.Level() );
+		for(int c=m_Index; c<CWSK_MAX_CHANNELS; c+=m_NumWorkers)
+		{
+			m_WordLength[c] = 0;
+			m_pParent->m_ChanState[c].storeRelease(CCwSkimmer::CHAN_FREE);
+		}
+	}
+	int n;
+	while( (n = m_InQueue.Get(m_Frames, CWSK_WORK_FRAMES)) > 0 )
+	{
+		for(int c=m_Index; c<CWSK_MAX_CHANNELS; c+=m_NumWorkers)
+		{
+			int state = m_pParent->m_ChanState[c].loadAcquire();
+			if(CCwSkimmer::CHAN_FREE == state)
+				continue;
+			CCwDecoder& Decoder = m_pParent->m_Decoders[c];
+			if(CCwSkimmer::CHAN_START == state)
+			{
+				Decoder.Init(m_WorkerFrameRate);
+				m_WordLength[c] = 0;
+				m_LastCall[c][0] = 0;
+				m_pParent->m_ChanState[c].storeRelease(CCwSkimmer::CHAN_ACTIVE);
+			}
+			for(int i=0; i<n; i++)
+				m_Power[i] = m_Frames[i].Power[c];
+			int num = Decoder.ProcessData(n, m_Power, m_Chars);
+			for(int i=0; i<num; i++)
+				AddChar(c, m_Chars[i]);
+			if( Decoder.IsLost() )	//keying stopped so free the channel for a new carrier
+				m_pParent->m_ChanState[c].storeRelease(CCwSkimmer::CHAN_FREE);
+		}
+	}
+}
+
+/////////////////////////////////////////////////////////////////////
+// Worker thread: adds a decoded character to the channel's word and
+//sends a spot if a finished word is a new callsign
+/////////////////////////////////////////////////////////////////////
+void CCwWorker::AddChar(int Channel, quint8 ch)
+{
+	char* pWord = m_Word[Channel];
+	if(' ' != ch)
+	{
+		if(m_WordLength[Channel] < CWSK_MAX_WORD)
+			pWord[m_WordLength[Channel]++] = ch;
+		return;
+	}
+	pWord[m_WordLength[Channel]] = 0;
+	m_WordLength[Channel] = 0;
+	if( !CCwDecoder::IsCallSign(pWord) || (0 == strcmp(pWord, m_LastCall[Channel])) )
+		return;
+	strcpy(m_LastCall[Channel], pWord);
+	tCW_SPOT Spot;
+	Spot.Freq = m_pParent->m_ChanFreq[Channel];
+	Spot.Wpm = m_pParent->m_Decoders[Channel].GetWpm();
+	Spot.Channel = Channel;
+	strcpy(Spot.Call, pWord);
+	m_pParent->m_SpotQueue.Put(Spot);	//drop spot if GUI is not reading
+}
+
+/////////////////////////////////////////////////////////////////////
+// Constructor/Destructor
+// Leaves one core for the I/Q data thread and one for the channelizer
+/////////////////////////////////////////////////////////////////////
+CCwSkimmer::CCwSkimmer()
+{
+	m_InitRequest = 0;
+	m_Pending = 0;
+	//a PutData() that beats ThreadInit() must still find the slot
+	connect(this,SIGNAL( NewData()), this, SLOT(ProcNewData()), Qt::QueuedConnection );
+	m_OverflowCount = 0;
+	m_SampleRate = 0.0;
+	m_pHopBuf = NULL;
+	for(int c=0; c<CWSK_MAX_CHANNELS; c++)
+	{
+		m_ChanState[c] = CHAN_FREE;
+		m_ChanFreq[c] = 0.0;
+		m_ChanBin[c] = 0;
+	}
+	m_NumWorkers = QThread::idealThreadCount() - 2;
+	if(m_NumWorkers < 1)
+		m_NumWorkers = 1;
+	if(m_NumWorkers > CWSK_MAX_WORKERS)
+		m_NumWorkers = CWSK_MAX_WORKERS;
+	for(int i=0; i<m_NumWorkers; i++)
+		m_pWorkers[i] = new CCwWorker(this, i, m_NumWorkers);
+qDebug()<<"CW skimmer workers="<<m_NumWorkers;
+}
+
+CCwSkimmer::~CCwSkimmer()
+{
+	CleanupThread();	//tell thread to cleanup after itself by calling ThreadExit()
+	//stop this thread before deleting the workers it sends frames to
+	m_pThread->exit();
+	m_pThread->wait();
+	for(int i=0; i<m_NumWorkers; i++)
+		delete m_pWorkers[i];
+	if(m_pHopBuf)
+		delete [] m_pHopBuf;
+}
+
+////////////////////////////////////////////////////////////////////////
+//  called by skimmer thread to initialize its world
+////////////////////////////////////////////////////////////////////////
+void CCwSkimmer::ThreadInit()
+{
+qDebug()<<"CW Skimmer Thread "<<this->thread()->currentThread();
+}
+
+/////////////////////////////////////////////////////////////////////
+// Called by this worker thread to cleanup after itself
+/////////////////////////////////////////////////////////////////////
+void CCwSkimmer::ThreadExit()
+{
+	disconnect();
+}
+
+/////////////////////////////////////////////////////////////////////
+// I/Q data thread: asks the skimmer thread to restart at a new
+//sample rate. Queued data at the old rate is thrown away.
+/////////////////////////////////////////////////////////////////////
+void CCwSkimmer::Init(TYPEREAL SampleRate)
+{
+	m_Mutex.lock();
+	m_SampleRate = SampleRate;
+	m_Mutex.unlock();
+	m_InitRequest.storeRelease(1);
+}
+
+/////////////////////////////////////////////////////////////////////
+// I/Q data thread: queues a block of I/Q samples.
+// If the ring is full the newest data is dropped.
+/////////////////////////////////////////////////////////////////////
+void CCwSkimmer::PutData(const TYPECPX* pData, int Length)
+{
+	if( m_InQueue.Put(pData, Length) < Length )
+		m_OverflowCount.fetchAndAddRelaxed(1);
+	if( 0 == m_Pending.fetchAndStoreOrdered(1) )
+		emit NewData();	//tell skimmer thread there's data to process
+}
+
+/////////////////////////////////////////////////////////////////////
+// Skimmer thread: channelizes everything in the input ring
+/////////////////////////////////////////////////////////////////////
+void CCwSkimmer::ProcNewData()
+{
+	m_Pending.fetchAndStoreOrdered(0);	//clear before reading so new data always gets a signal
+	if( m_InitRequest.fetchAndStoreAcquire(0) )
+	{
+		m_Mutex.lock();
+		TYPEREAL rate = m_SampleRate;
+		m_Mutex.unlock();
+		m_InQueue.Skip( m_InQueue.Level() );
+		m_Channelizer.Init(rate);
+		m_Detect.Init(m_Channelizer.GetFirstBin(), m_Channelizer.GetLastBin(),
+					  m_Channelizer.GetFrameRate(), m_Channelizer.GetBinWidth());
+		if(m_pHopBuf)
+			delete [] m_pHopBuf;
+		m_pHopBuf = new TYPECPX[m_Channelizer.GetHopSize()];
+		for(int i=0; i<m_NumWorkers; i++)
+			m_pWorkers[i]->Init(m_Channelizer.GetFrameRate());
+	}
+	if(!m_pHopBuf)
+	{	//not initialized yet
+		m_InQueue.Skip( m_InQueue.Level() );
+		return;
+	}
+	int hop = m_Channelizer.GetHopSize();
+	while( m_InQueue.Level() >= hop )
+	{
+		m_InQueue.Get(m_pHopBuf, hop);
+		const TYPEREAL* pPower = m_Channelizer.ProcessFrame(m_pHopBuf);
+		for(int c=0; c<CWSK_MAX_CHANNELS; c++)
+		{
+			if( CHAN_FREE == m_ChanState[c].loadAcquire() )
+				m_Frame.Power[c] = 0.0;
+			else
+				m_Frame.Power[c] = pPower[m_ChanBin[c]];
+		}
+		for(int i=0; i<m_NumWorkers; i++)
+			m_pWorkers[i]->PutFrame(&m_Frame);
+		if( m_Detect.ProcessFrame(pPower) )
+			AssignChannels();
+	}
+}
+
+/////////////////////////////////////////////////////////////////////
+// Skimmer thread: starts a free channel on each carrier that is not
+//already being decoded. Carriers are strongest first so the weakest
+//are left out when every channel is busy.
+/////////////////////////////////////////////////////////////////////
+void CCwSkimmer::AssignChannels()
+{
+	int num = m_Detect.GetCarriers(m_Carriers, CWSK_MAX_CHANNELS);
+	for(int i=0; i<num; i++)
+	{
+		int bin = (int)(m_Carriers[i] + 0.5);
+		int FreeChan = -1;
+		bool found = false;
+		for(int c=0; (c<CWSK_MAX_CHANNELS) && !found; c++)
+		{
+			if( CHAN_FREE == m_ChanState[c].loadAcquire() )
+			{
+				if(FreeChan < 0)
+					FreeChan = c;
+				continue;
+			}
+			if( abs(m_ChanBin[c] - bin) <= CHAN_SPACING )
+				found = true;
+		}
+		if(found)
+			continue;
+		if(FreeChan < 0)
+			break;		//all channels busy
+		m_ChanBin[FreeChan] = bin;
+		m_ChanFreq[FreeChan] = m_Channelizer.GetBinFreq(m_Carriers[i]);
+		m_ChanState[FreeChan].storeRelease(CHAN_START);
+	}
+}
+
+/////////////////////////////////////////////////////////////////////
+// GUI thread: gets the oldest spot
+/////////////////////////////////////////////////////////////////////
+bool CCwSkimmer::GetSpot(tCW_SPOT* pSpot)
+{
+	return m_SpotQueue.Get(*pSpot);
+}
@@ -0,0 +1,163 @@
+//////////////////////////////////////////////////////////////////////
+// cwskimmerthread.h: interface for the CCwSkimmer and CCwWorker classes.
+//
+// History:
+//	2026-10-18  Initial creation
+//////////////////////////////////////////////////////////////////////
+//==========================================================================================
+// + + +   This Software is released under the "Simplified BSD License"  + + +
+//Copyright 2010 Moe Wheatley. All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification, are
+//permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice, this list of
+//	  conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice, this list
+//	  of conditions and the following disclaimer in the documentation and/or other materials
+//	  provided with the distribution.
+//
+//THIS SOFTWARE IS PROVIDED BY Moe Wheatley ``AS IS'' AND ANY EXPRESS OR IMPLIED
+//WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+//FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Moe Wheatley OR
+//CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+//ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+//ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//The views and conclusions contained in the software and documentation are those of the
+//authors and should not be interpreted as representing official policies, either expressed
+//or implied, of Moe Wheatley.
+//=============================================================================
+#ifndef CWSKIMMERTHREAD_H
+#define CWSKIMMERTHREAD_H
+#include "interface/threadwrapper.h"
+#include "interface/spscring.h"
+#include "interface/mpscqueue.h"
+#include "dsp/cwskimmer.h"
+
+#define CWSK_MAX_WORKERS 8		//most decoder threads
+#define CWSK_INQ_SIZE 262144	//I/Q samples queued for the channelizer thread
+#define CWSK_FRAMEQ_SIZE 128	//channel frames queued for each worker(about 1 Sec)
+#define CWSK_WORK_FRAMES 16		//channel frames decoded per pass
+#define CWSK_SPOTQ_SIZE 256		//spots waiting for the GUI
+
+typedef struct _cwspot
+{
+	TYPEREAL Freq;	//offset from the I/Q center frequency in Hz
+	int Wpm;
+	int Channel;	//decoder channel that found the call
+	char Call[CWSK_MAX_WORD+1];
+}tCW_SPOT;
+
+//power of every channel for one channelizer frame
+typedef struct _cwframe
+{
+	TYPEREAL Power[CWSK_MAX_CHANNELS];
+}tCW_FRAME;
+
+class CCwSkimmer;
+
+////////////
+//class for one decoder thread. Decodes every channel c with
+// c%NumWorkers == Index
+////////////
+class CCwWorker : public CThreadWrapper
+{
+	Q_OBJECT
+public:
+	CCwWorker(CCwSkimmer* pParent, int Index, int NumWorkers);
+	~CCwWorker();
+
+	//called by the channelizer thread
+	void Init(TYPEREAL FrameRate);
+	void PutFrame(const tCW_FRAME* pFrame);
+
+signals:
+	void NewData();
+
+private slots:
+	void ThreadInit();	//overrided function is called by new thread when started
+	void ThreadExit();	//overrided function is called by new thread when stopped
+	void ProcNewData();
+
+private:
+	void AddChar(int Channel, quint8 ch);
+	CCwSkimmer* m_pParent;
+	int m_Index;
+	int m_NumWorkers;
+	CSpscRing<tCW_FRAME, CWSK_FRAMEQ_SIZE> m_InQueue;
+	QAtomicInt m_InitRequest;	//set by Init() until the worker has reinitialized
+	QAtomicInt m_Pending;		//set while a NewData signal is waiting to be processed
+	QAtomicInt m_OverflowCount;
+	TYPEREAL m_FrameRate;		//protected by m_Mutex
+
+	//used only by the worker thread
+	TYPEREAL m_WorkerFrameRate;
+	int m_WordLength[CWSK_MAX_CHANNELS];
+	char m_Word[CWSK_MAX_CHANNELS][CWSK_MAX_WORD+1];
+	char m_LastCall[CWSK_MAX_CHANNELS][CWSK_MAX_WORD+1];
+	quint8 m_Chars[CWSK_WORK_FRAMES];
+	TYPEREAL m_Power[CWSK_WORK_FRAMES];
+	tCW_FRAME m_Frames[CWSK_WORK_FRAMES];
+};
+
+////////////
+//class for the CW skimmer. Runs the channelizer and carrier search on its
+// own thread and the Morse decoders on a pool of worker threads
+////////////
+class CCwSkimmer : public CThreadWrapper
+{
+	Q_OBJECT
+public:
+	CCwSkimmer();
+	~CCwSkimmer();
+
+	//called by the I/Q data thread
+	void Init(TYPEREAL SampleRate);
+	void PutData(const TYPECPX* pData, int Length);
+
+	//called by the single consumer(GUI) thread. Returns false if no spot
+	bool GetSpot(tCW_SPOT* pSpot);
+
+signals:
+	void NewData();
+
+private slots:
+	void ThreadInit();	//overrided function is called by new thread when started
+	void ThreadExit();	//overrided function is called by new thread when stopped
+	void ProcNewData();
+
+private:
+	friend class CCwWorker;
+	enum eCHANSTATE {CHAN_FREE, CHAN_START, CHAN_ACTIVE};
+	void AssignChannels();
+
+	//a channel only moves FREE->START on the channelizer thread and
+	// START->ACTIVE->FREE on its worker thread
+	QAtomicInt m_ChanState[CWSK_MAX_CHANNELS];
+	TYPEREAL m_ChanFreq[CWSK_MAX_CHANNELS];		//written by the channelizer thread before CHAN_START
+	CCwDecoder m_Decoders[CWSK_MAX_CHANNELS];	//used only by the owning worker
+	CMpscQueue<tCW_SPOT, CWSK_SPOTQ_SIZE> m_SpotQueue;
+
+	CSpscRing<TYPECPX, CWSK_INQ_SIZE> m_InQueue;
+	QAtomicInt m_InitRequest;	//set by Init() until the channelizer thread has reinitialized
+	QAtomicInt m_Pending;		//set while a NewData signal is waiting to be processed
+	QAtomicInt m_OverflowCount;
+	TYPEREAL m_SampleRate;		//protected by m_Mutex
+
+	//used only by the channelizer thread
+	int m_NumWorkers;
+	CCwWorker* m_pWorkers[CWSK_MAX_WORKERS];
+	int m_ChanBin[CWSK_MAX_CHANNELS];
+	TYPEREAL m_Carriers[CWSK_MAX_CHANNELS];
+	TYPECPX* m_pHopBuf;
+	tCW_FRAME m_Frame;
+	CCwChannelizer m_Channelizer;
+	CCwCarrierDetect m_Detect;
+};
+
+#endif // CWSKIMMERTHREAD_H
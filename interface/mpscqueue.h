@@ -0,0 +1,107 @@
+/////////////////////////////////////////////////////////////////////
+// mpscqueue.h  CMpscQueue template class.
+//This class implements a bounded lock free multiple producer single
+//consumer queue of small items such as decoded RDS groups.
+// Any thread may call Put(), only the consumer thread may call Get().
+//Every slot has a sequence number that tells if it is free for the
+//producer that claimed it or holds an item ready for the consumer.
+//Producers claim slots by a compare and swap on the head index so
+//they never wait for each other.  SIZE must be a power of 2.
+// History:
+//	2026-10-18  Initial creation
+/////////////////////////////////////////////////////////////////////
+//==========================================================================================
+// + + +   This Software is released under the "Simplified BSD License"  + + +
+//Copyright 2013 Moe Wheatley. All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification, are
+//permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice, this list of
+//	  conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice, this list
+//	  of conditions and the following disclaimer in the documentation and/or other materials
+//	  provided with the distribution.
+//
+//THIS SOFTWARE IS PROVIDED BY Moe Wheatley ``AS IS'' AND ANY EXPRESS OR IMPLIED
+//WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+//FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Moe Wheatley OR
+//CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+//ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+//ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+#ifndef MPSCQUEUE_H
+#define MPSCQUEUE_H
+
+#include <QAtomicInt>
+
+template <class T, int SIZE>
+class CMpscQueue
+{
+public:
+	CMpscQueue(){Reset();}
+
+	//Any thread: copies Item into the queue.
+	// Returns false if the queue is full.
+	bool Put(const T& Item)
+	{
+		int pos = m_Head.load();
+		for(;;)
+		{
+			int dif = (int)( (quint32)m_Seq[pos & (SIZE-1)].loadAcquire() - (quint32)pos );
+			if(0 == dif)
+			{	//slot is free so try to claim it
+				if( m_Head.testAndSetRelaxed(pos, (int)((quint32)pos + 1)) )
+					break;
+				pos = m_Head.load();
+			}
+			else if(dif < 0)
+			{
+				return false;	//consumer has not emptied this slot yet so full
+			}
+			else
+			{
+				pos = m_Head.load();	//another producer got it first
+			}
+		}
+		m_Buf[pos & (SIZE-1)] = Item;
+		m_Seq[pos & (SIZE-1)].storeRelease( (int)((quint32)pos + 1) );
+		return true;
+	}
+
+	//Consumer: copies the oldest item into Item.
+	// Returns false if the queue is empty.
+	bool Get(T& Item)
+	{
+		int pos = m_Tail;
+		int dif = (int)( (quint32)m_Seq[pos & (SIZE-1)].loadAcquire() - ((quint32)pos + 1) );
+		if(dif < 0)
+			return false;
+		Item = m_Buf[pos & (SIZE-1)];
+		m_Seq[pos & (SIZE-1)].storeRelease( (int)((quint32)pos + SIZE) );
+		m_Tail = (int)((quint32)pos + 1);
+		return true;
+	}
+
+	//empties the queue. Only call when no thread is using it.
+	void Reset()
+	{
+		for(int i=0; i<SIZE; i++)
+			m_Seq[i].storeRelease(i);
+		m_Head.storeRelease(0);
+		m_Tail = 0;
+	}
+
+private:
+	QAtomicInt m_Head;		//next slot to claim, shared by producers
+	char m_Pad[64];			//keep the producer and consumer indexes on separate cache lines
+	int m_Tail;				//next slot to read, owned by consumer
+	QAtomicInt m_Seq[SIZE];
+	T m_Buf[SIZE];
+};
+
+#endif // MPSCQUEUE_H
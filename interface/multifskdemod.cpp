@@ -0,0 +1,283 @@
+/////////////////////////////////////////////////////////////////////
+// multifskdemod.cpp: implementation of the CMultiFskDemod and CFskWorker classes.
+//
+//	The DSP thread runs the pair search and copies the passband audio
+// into each worker's input ring. A worker makes the shared shift
+// oscillator once per block then runs the CFskDemod correlator and DSC
+// decoder kernels for each channel it owns over that block.
+// DSC traffic is bursty so a channel is kept until its pair has not
+// been seen for MFSK_LOSS_TIME.
+// History:
+//	2026-10-18  Initial creation
+//	2026-10-18  NewData is connected before the first signal can be sent
+/////////////////////////////////////////////////////////////////////
+//==========================================================================================
+// + + +   This Software is released under the "Simplified BSD License"  + + +
+//Copyright 2010 Moe Wheatley. All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification, are
+//permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice, this list of
+//	  conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice, this list
+//	  of conditions and the following disclaimer in the documentation and/or other materials
+//	  provided with the distribution.
+//
+//THIS SOFTWARE IS PROVIDED BY Moe Wheatley ``AS IS'' AND ANY EXPRESS OR IMPLIED
+//WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+//FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Moe Wheatley OR
+//CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+//ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+//ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//The views and conclusions contained in the software and documentation are those of the
+//authors and should not be interpreted as representing official policies, either expressed
+//or implied, of Moe Wheatley.
+//==========================================================================================
+#include "interface/multifskdemod.h"
+#include <QDebug>
+
+#define CHAN_SPACING (FSK_SHIFT_FREQ/2.0)	//new pairs closer than this in Hz to a channel are ignored
+
+/////////////////////////////////////////////////////////////////////
+// Constructor/Destructor
+/////////////////////////////////////////////////////////////////////
+CFskWorker::CFskWorker(CMultiFskDemod* pParent, int Index, int NumWorkers)
+{
+	m_pParent = pParent;
+	m_Index = Index;
+	m_NumWorkers = NumWorkers;
+	m_InitRequest = 0;
+	m_Pending = 0;
+	//must exist before Init() or PutData() latch m_Pending
+	connect(this,SIGNAL( NewData()), this, SLOT(ProcNewData()), Qt::QueuedConnection );
+	m_OverflowCount = 0;
+	m_SampleRate = 8000.0;
+	m_WorkerRate = 8000.0;
+	CFskDemod::InitBlock(&m_Block, m_WorkerRate);
+}
+
+CFskWorker::~CFskWorker()
+{
+	CleanupThread();	//tell thread to cleanup after itself by calling ThreadExit()
+}
+
+////////////////////////////////////////////////////////////////////////
+//  called by worker thread to initialize its world
+////////////////////////////////////////////////////////////////////////
+void CFskWorker::ThreadInit()
+{
+qDebug()<<"FSK Worker Thread "<<m_Index<<this->thread()->currentThread();
+}
+
+/////////////////////////////////////////////////////////////////////
+// Called by this worker thread to cleanup after itself
+/////////////////////////////////////////////////////////////////////
+void CFskWorker::ThreadExit()
+{
+	disconnect();
+}
+
+/////////////////////////////////////////////////////////////////////
+// DSP thread: asks the worker to free its channels and restart at a
+//new sample rate. Queued data at the old rate is thrown away.
+/////////////////////////////////////////////////////////////////////
+void CFskWorker::Init(TYPEREAL SampleRate)
+{
+	m_Mutex.lock();
+	m_SampleRate = SampleRate;
+	m_Mutex.unlock();
+	m_InitRequest.storeRelease(1);
+	if( 0 == m_Pending.fetchAndStoreOrdered(1) )
+		emit NewData();
+}
+
+/////////////////////////////////////////////////////////////////////
+// DSP thread: queues a block of passband samples.
+// If the ring is full the newest data is dropped.
+/////////////////////////////////////////////////////////////////////
+void CFskWorker::PutData(const TYPECPX* pData, int Length)
+{
+	if( m_InQueue.Put(pData, Length) < Length )
+		m_OverflowCount.fetchAndAddRelaxed(1);
+	if( 0 == m_Pending.fetchAndStoreOrdered(1) )
+		emit NewData();	//tell worker thread there's data to process
+}
+
+/////////////////////////////////////////////////////////////////////
+// Worker thread: runs every channel it owns over the input ring
+/////////////////////////////////////////////////////////////////////
+void CFskWorker::ProcNewData()
+{
+	m_Pending.fetchAndStoreOrdered(0);	//clear before reading so new data always gets a signal
+	if( m_InitRequest.fetchAndStoreAcquire(0) )
+	{
+		m_Mutex.lock();
+		m_WorkerRate = m_SampleRate;
+		m_Mutex.unlock();
+		m_InQueue.Skip( m_InQueue.Level() );
+		CFskDemod::InitBlock(&m_Block, m_WorkerRate);
+		for(int c=m_Index; c<MFSK_MAX_CHANNELS; c+=m_NumWorkers)
+			m_pParent->m_ChanState[c].storeRelease(CMultiFskDemod::CHAN_FREE);
+	}
+	int n;
+	while( (n = m_InQueue.Get(m_Buf, FSK_BLOCK)) > 0 )
+	{
+		CFskDemod::StartBlock(&m_Block, n);
+		for(int c=m_Index; c<MFSK_MAX_CHANNELS; c+=m_NumWorkers)
+		{
+			int state = m_pParent->m_ChanState[c].loadAcquire();
+			if(CMultiFskDemod::CHAN_FREE == state)
+				continue;
+			if(CMultiFskDemod::CHAN_STOP == state)
+			{	//pair has gone so free the channel for a new one
+				m_pParent->m_ChanState[c].storeRelease(CMultiFskDemod::CHAN_FREE);
+				continue;
+			}
+			tFSK_CHANNEL& Chan = m_pParent->m_Channels[c];
+			if(CMultiFskDemod::CHAN_START == state)
+			{
+				CFskDemod::InitCorrelator(&Chan.Corr, m_WorkerRate, m_pParent->m_ChanFreq[c]);
+				CFskDemod::InitDecoder(&Chan.Dsc);
+				m_pParent->m_ChanState[c].storeRelease(CMultiFskDemod::CHAN_ACTIVE);
+			}
+			int NumBits = CFskDemod::Correlate(&Chan.Corr, &m_Block, n, m_Buf, m_Bits);
+			for(int i=0; i<NumBits; i++)
+			{
+				int Status = CFskDemod::DecodeBit(&Chan.Dsc, m_Bits[i]);
+				if(FSK_MSG_NONE != Status)
+				{
+					SendMsg(c, Status);
+					CFskDemod::ResetBitSync(&Chan.Corr);
+				}
+			}
+		}
+	}
+}
+
+/////////////////////////////////////////////////////////////////////
+// Worker thread: sends a finished message to the GUI queue
+/////////////////////////////////////////////////////////////////////
+void CFskWorker::SendMsg(int Channel, int Status)
+{
+tFSK_TEXT Text;
+	Text.Freq = (int)(m_pParent->m_ChanFreq[Channel] + 0.5);
+	Text.Channel = Channel;
+	CFskDemod::FormatMsg(&m_pParent->m_Channels[Channel].Dsc, Status, Text.Text);
+	m_pParent->m_TextQueue.Put(Text);	//drop message if GUI is not reading
+}
+
+/////////////////////////////////////////////////////////////////////
+// Constructor/Destructor
+// Leaves one core for the DSP thread
+/////////////////////////////////////////////////////////////////////
+CMultiFskDemod::CMultiFskDemod()
+{
+	for(int c=0; c<MFSK_MAX_CHANNELS; c++)
+	{
+		m_ChanState[c] = CHAN_FREE;
+		m_ChanFreq[c] = 0.0;
+		m_MissCount[c] = 0;
+	}
+	m_MissLimit = (int)(MFSK_LOSS_TIME/MFSK_DETECT_TIME + 0.5);
+	m_NumWorkers = QThread::idealThreadCount() - 1;
+	if(m_NumWorkers < 1)
+		m_NumWorkers = 1;
+	if(m_NumWorkers > MFSK_MAX_WORKERS)
+		m_NumWorkers = MFSK_MAX_WORKERS;
+	for(int i=0; i<m_NumWorkers; i++)
+		m_pWorkers[i] = new CFskWorker(this, i, m_NumWorkers);
+qDebug()<<"Multi FSK workers="<<m_NumWorkers;
+}
+
+CMultiFskDemod::~CMultiFskDemod()
+{
+	for(int i=0; i<m_NumWorkers; i++)
+		delete m_pWorkers[i];
+}
+
+/////////////////////////////////////////////////////////////////////
+// DSP thread: sets the passband sample rate.
+// All channels are freed and the pair search starts over.
+/////////////////////////////////////////////////////////////////////
+void CMultiFskDemod::Init(TYPEREAL SampleRate)
+{
+	m_Detect.Init(SampleRate);
+	for(int c=0; c<MFSK_MAX_CHANNELS; c++)
+		m_MissCount[c] = 0;
+	for(int i=0; i<m_NumWorkers; i++)
+		m_pWorkers[i]->Init(SampleRate);
+}
+
+/////////////////////////////////////////////////////////////////////
+// DSP thread: passes a block of passband audio to the workers and
+//starts channels on any new pairs
+/////////////////////////////////////////////////////////////////////
+void CMultiFskDemod::PutData(int Length, const TYPECPX* pData)
+{
+	for(int i=0; i<m_NumWorkers; i++)
+		m_pWorkers[i]->PutData(pData, Length);
+	if( m_Detect.ProcessData(Length, pData) )
+		AssignChannels();
+}
+
+/////////////////////////////////////////////////////////////////////
+// DSP thread: starts a free channel on each pair that is not already
+//being decoded and stops channels whose pair has not been seen for
+//MFSK_LOSS_TIME. Pairs are strongest first so the weakest are left out
+//when every channel is busy.
+/////////////////////////////////////////////////////////////////////
+void CMultiFskDemod::AssignChannels()
+{
+bool Seen[MFSK_MAX_CHANNELS];
+	for(int c=0; c<MFSK_MAX_CHANNELS; c++)
+		Seen[c] = false;
+	int num = m_Detect.GetPairs(m_Pairs, MFSK_MAX_CHANNELS);
+	for(int i=0; i<num; i++)
+	{
+		int FreeChan = -1;
+		bool found = false;
+		for(int c=0; (c<MFSK_MAX_CHANNELS) && !found; c++)
+		{
+			if(CHAN_FREE == m_ChanState[c].loadAcquire())
+			{
+				if(FreeChan < 0)
+					FreeChan = c;
+				continue;
+			}
+			if( MFABS(m_ChanFreq[c] - m_Pairs[i]) < CHAN_SPACING )
+			{
+				Seen[c] = true;
+				found = true;
+			}
+		}
+		if(found)
+			continue;
+		if(FreeChan < 0)
+			break;		//all channels busy
+		m_ChanFreq[FreeChan] = m_Pairs[i];
+		m_MissCount[FreeChan] = 0;
+		Seen[FreeChan] = true;
+		m_ChanState[FreeChan].storeRelease(CHAN_START);
+	}
+	for(int c=0; c<MFSK_MAX_CHANNELS; c++)
+	{
+		if( Seen[c] || (CHAN_FREE == m_ChanState[c].loadAcquire()) )
+			m_MissCount[c] = 0;
+		else if(++m_MissCount[c] >= m_MissLimit)
+			m_ChanState[c].testAndSetRelease(CHAN_ACTIVE, CHAN_STOP);
+	}
+}
+
+/////////////////////////////////////////////////////////////////////
+// GUI thread: gets the oldest decoded message
+/////////////////////////////////////////////////////////////////////
+bool CMultiFskDemod::GetText(tFSK_TEXT* pText)
+{
+	return m_TextQueue.Get(*pText);
+}
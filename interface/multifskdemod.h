@@ -0,0 +1,145 @@
+//////////////////////////////////////////////////////////////////////
+// multifskdemod.h: interface for the CMultiFskDemod and CFskWorker classes.
+//
+// History:
+//	2026-10-18  Initial creation
+//	2026-10-18  Added GetMemorySize()
+//////////////////////////////////////////////////////////////////////
+//==========================================================================================
+// + + +   This Software is released under the "Simplified BSD License"  + + +
+//Copyright 2010 Moe Wheatley. All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification, are
+//permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice, this list of
+//	  conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice, this list
+//	  of conditions and the following disclaimer in the documentation and/or other materials
+//	  provided with the distribution.
+//
+//THIS SOFTWARE IS PROVIDED BY Moe Wheatley ``AS IS'' AND ANY EXPRESS OR IMPLIED
+//WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+//FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Moe Wheatley OR
+//CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+//ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+//ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//The views and conclusions contained in the software and documentation are those of the
+//authors and should not be interpreted as representing official policies, either expressed
+//or implied, of Moe Wheatley.
+//=============================================================================
+#ifndef MULTIFSKDEMOD_H
+#define MULTIFSKDEMOD_H
+#include "interface/threadwrapper.h"
+#include "interface/spscring.h"
+#include "interface/mpscqueue.h"
+#include "dsp/multifsk.h"
+
+#define MFSK_MAX_WORKERS 4		//most decoder threads
+#define MFSK_INQ_SIZE 32768		//passband samples queued for each worker thread
+#define MFSK_TEXTQ_SIZE 64		//messages waiting for the GUI
+#define MFSK_MAX_TEXT (FSK_MAX_MSG*4+32)	//longest formatted message
+
+typedef struct _fskt
+{
+	int Freq;		//audio center frequency of the signal in Hz
+	int Channel;	//decoder channel that found the message
+	char Text[MFSK_MAX_TEXT];
+}tFSK_TEXT;
+
+//decoder state for one channel
+typedef struct _fskchan
+{
+	tFSK_CORR Corr;
+	tDSC_DECODE Dsc;
+}tFSK_CHANNEL;
+
+class CMultiFskDemod;
+
+////////////
+//class for one decoder thread. Decodes every channel c with
+// c%NumWorkers == Index over the same blocks of samples
+////////////
+class CFskWorker : public CThreadWrapper
+{
+	Q_OBJECT
+public:
+	CFskWorker(CMultiFskDemod* pParent, int Index, int NumWorkers);
+	~CFskWorker();
+
+	//called by the DSP thread
+	void Init(TYPEREAL SampleRate);
+	void PutData(const TYPECPX* pData, int Length);
+
+signals:
+	void NewData();
+
+private slots:
+	void ThreadInit();	//overrided function is called by new thread when started
+	void ThreadExit();	//overrided function is called by new thread when stopped
+	void ProcNewData();
+
+private:
+	void SendMsg(int Channel, int Status);
+	CMultiFskDemod* m_pParent;
+	int m_Index;
+	int m_NumWorkers;
+	CSpscRing<TYPECPX, MFSK_INQ_SIZE> m_InQueue;
+	QAtomicInt m_InitRequest;	//set by Init() until the worker has reinitialized
+	QAtomicInt m_Pending;		//set while a NewData signal is waiting to be processed
+	QAtomicInt m_OverflowCount;
+	TYPEREAL m_SampleRate;		//protected by m_Mutex
+
+	//used only by the worker thread
+	TYPEREAL m_WorkerRate;
+	tFSK_BLOCK m_Block;
+	quint8 m_Bits[FSK_BLOCK];
+	TYPECPX m_Buf[FSK_BLOCK];
+};
+
+////////////
+//class that finds DSC FSK signals in the audio passband and runs a
+// decoder channel on a pool of worker threads for each one
+////////////
+class CMultiFskDemod
+{
+public:
+	CMultiFskDemod();
+	~CMultiFskDemod();
+
+	//called by the DSP thread
+	void Init(TYPEREAL SampleRate);
+	void PutData(int Length, const TYPECPX* pData);
+
+	int GetMemorySize(){return sizeof(CMultiFskDemod) + m_NumWorkers*sizeof(CFskWorker);}
+
+	//called by the single consumer(GUI) thread. Returns false if no message
+	bool GetText(tFSK_TEXT* pText);
+
+private:
+	friend class CFskWorker;
+	enum eCHANSTATE {CHAN_FREE, CHAN_START, CHAN_ACTIVE, CHAN_STOP};
+	void AssignChannels();
+
+	//a channel only moves FREE->START and ACTIVE->STOP on the DSP thread
+	// and START->ACTIVE and STOP->FREE on its worker thread
+	QAtomicInt m_ChanState[MFSK_MAX_CHANNELS];
+	TYPEREAL m_ChanFreq[MFSK_MAX_CHANNELS];		//written by the DSP thread before CHAN_START
+	tFSK_CHANNEL m_Channels[MFSK_MAX_CHANNELS];	//used only by the owning worker
+	CMpscQueue<tFSK_TEXT, MFSK_TEXTQ_SIZE> m_TextQueue;
+
+	//used only by the DSP thread
+	int m_NumWorkers;
+	int m_MissLimit;
+	int m_MissCount[MFSK_MAX_CHANNELS];		//pair searches since the channel's pair was seen
+	CFskWorker* m_pWorkers[MFSK_MAX_WORKERS];
+	TYPEREAL m_Pairs[MFSK_MAX_CHANNELS];
+	CFskPairDetect m_Detect;
+};
+
+#endif // MULTIFSKDEMOD_H
@@ -0,0 +1,309 @@
+/////////////////////////////////////////////////////////////////////
+// multipskdemod.cpp: implementation of the CMultiPskDemod and CPskWorker classes.
+//
+//	The DSP thread runs the carrier search and copies the passband
+// audio into each worker's input ring. Each worker runs the channels it
+// owns over the same data so a channel is never touched by two threads.
+// Decoded text is sent a line at a time through a queue the GUI reads.
+// History:
+//	2026-10-18  Initial creation
+//	2026-10-18  NewData is connected before the first signal can be sent
+/////////////////////////////////////////////////////////////////////
+//==========================================================================================
+// + + +   This Software is released under the "Simplified BSD License"  + + +
+//Copyright 2010 Moe Wheatley. All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification, are
+//permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice, this list of
+//	  conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice, this list
+//	  of conditions and the following disclaimer in the documentation and/or other materials
+//	  provided with the distribution.
+//
+//THIS SOFTWARE IS PROVIDED BY Moe Wheatley ``AS IS'' AND ANY EXPRESS OR IMPLIED
+//WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+//FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Moe Wheatley OR
+//CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+//ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+//ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//The views and conclusions contained in the software and documentation are those of the
+//authors and should not be interpreted as representing official policies, either expressed
+//or implied, of Moe Wheatley.
+//==========================================================================================
+#include "interface/multipskdemod.h"
+#include <QDebug>
+
+#define CHAN_SPACING 1.6	//new carriers closer than this many symbol rates to a channel are ignored
+
+/////////////////////////////////////////////////////////////////////
+// Constructor/Destructor
+/////////////////////////////////////////////////////////////////////
+CPskWorker::CPskWorker(CMultiPskDemod* pParent, int Index, int NumWorkers)
+{
+	m_pParent = pParent;
+	m_Index = Index;
+	m_NumWorkers = NumWorkers;
+	m_InitRequest = 0;
+	m_Pending = 0;
+	//Init() signals right after construction so the slot must be connected now
+	connect(this,SIGNAL( NewData()), this, SLOT(ProcNewData()), Qt::QueuedConnection );
+	m_OverflowCount = 0;
+	m_SampleRate = 8000.0;
+	m_SymbRate = 31.25;
+	m_IdleLimit = 1;
+	for(int i=0; i<MPSK_MAX_CHANNELS; i++)
+	{
+		m_LineLength[i] = 0;
+		m_IdleCount[i] = 0;
+	}
+}
+
+CPskWorker::~CPskWorker()
+{
+	CleanupThread();	//tell thread to cleanup after itself by calling ThreadExit()
+}
+
+////////////////////////////////////////////////////////////////////////
+//  called by worker thread to initialize its world
+////////////////////////////////////////////////////////////////////////
+void CPskWorker::ThreadInit()
+{
+qDebug()<<"PSK Worker Thread "<<m_Index<<this->thread()->currentThread();
+}
+
+/////////////////////////////////////////////////////////////////////
+// Called by this worker thread to cleanup after itself
+/////////////////////////////////////////////////////////////////////
+void CPskWorker::ThreadExit()
+{
+	disconnect();
+}
+
+/////////////////////////////////////////////////////////////////////
+// DSP thread: asks the worker to restart its channels at a new
+//sample rate. Queued data at the old rate is thrown away.
+/////////////////////////////////////////////////////////////////////
+void CPskWorker::Init(TYPEREAL SampleRate, TYPEREAL SymbRate)
+{
+	m_Mutex.lock();
+	m_SampleRate = SampleRate;
+	m_SymbRate = SymbRate;
+	m_Mutex.unlock();
+	m_InitRequest.storeRelease(1);
+	if( 0 == m_Pending.fetchAndStoreOrdered(1) )
+		emit NewData();
+}
+
+/////////////////////////////////////////////////////////////////////
+// DSP thread: queues a block of passband samples.
+// If the ring is full the newest data is dropped.
+/////////////////////////////////////////////////////////////////////
+void CPskWorker::PutData(const TYPECPX* pData, int Length)
+{
+	if( m_InQueue.Put(pData, Length) < Length )
+		m_OverflowCount.fetchAndAddRelaxed(1);
+	if( 0 == m_Pending.fetchAndStoreOrdered(1) )
+		emit NewData();	//tell worker thread there's data to process
+}
+
+/////////////////////////////////////////////////////////////////////
+// Worker thread: runs every channel it owns over the input ring
+/////////////////////////////////////////////////////////////////////
+void CPskWorker::ProcNewData()
+{
+	m_Pending.fetchAndStoreOrdered(0);	//clear before reading so new data always gets a signal
+	if( m_InitRequest.fetchAndStoreAcquire(0) )
+	{
+		m_Mutex.lock();
+		TYPEREAL rate = m_SampleRate;
+		TYPEREAL symbrate = m_SymbRate;
+		m_Mutex.unlock();
+		m_InQueue.Skip( m_InQueue.Level() );
+		m_IdleLimit = (int)(MPSK_IDLE_TIME*rate);
+		for(int c=m_Index; c<MPSK_MAX_CHANNELS; c+=m_NumWorkers)
+		{
+			m_pParent->m_Channels[c].Init(rate, symbrate);
+			m_LineLength[c] = 0;
+			m_pParent->m_ChanState[c].storeRelease(CMultiPskDemod::CHAN_FREE);
+		}
+	}
+	int n;
+	while( (n = m_InQueue.Get(m_Buf, MPSK_WORK_BLOCK)) > 0 )
+	{
+		for(int c=m_Index; c<MPSK_MAX_CHANNELS; c+=m_NumWorkers)
+		{
+			int state = m_pParent->m_ChanState[c].loadAcquire();
+			if(CMultiPskDemod::CHAN_FREE == state)
+				continue;
+			CPskChannel& Chan = m_pParent->m_Channels[c];
+			if(CMultiPskDemod::CHAN_START == state)
+			{
+				Chan.Start(m_pParent->m_StartFreq[c]);
+				m_LineLength[c] = 0;
+				m_IdleCount[c] = 0;
+				m_pParent->m_ChanState[c].storeRelease(CMultiPskDemod::CHAN_ACTIVE);
+			}
+			int num = Chan.ProcessData(n, m_Buf, m_Chars);
+			for(int i=0; i<num; i++)
+				AddChar(c, m_Chars[i]);
+			if(num > 0)
+			{
+				m_IdleCount[c] = 0;
+			}
+			else
+			{	//send partial line if station has paused
+				m_IdleCount[c] += n;
+				if( (m_IdleCount[c] >= m_IdleLimit) && (m_LineLength[c] > 0) )
+					SendLine(c);
+			}
+			m_pParent->m_ChanFreq[c].storeRelease( (int)(Chan.GetFreq() + 0.5) );
+			if( Chan.IsLost() )
+			{	//signal is gone so free the channel for a new carrier
+				SendLine(c);
+				m_pParent->m_ChanState[c].storeRelease(CMultiPskDemod::CHAN_FREE);
+			}
+		}
+	}
+}
+
+/////////////////////////////////////////////////////////////////////
+// Worker thread: adds a decoded character to the channel's line
+/////////////////////////////////////////////////////////////////////
+void CPskWorker::AddChar(int Channel, quint8 ch)
+{
+	if( ('\r' == ch) || ('\n' == ch) )
+	{
+		SendLine(Channel);
+	}
+	else if('\b' == ch)
+	{	//if backspace then delete previous character
+		if(m_LineLength[Channel] > 0)
+			m_LineLength[Channel]--;
+	}
+	else if(ch >= ' ')
+	{
+		m_Line[Channel][m_LineLength[Channel]++] = ch;
+		if(m_LineLength[Channel] >= MPSK_MAX_LINE)
+			SendLine(Channel);
+	}
+}
+
+/////////////////////////////////////////////////////////////////////
+// Worker thread: sends the channel's line of text to the GUI queue
+/////////////////////////////////////////////////////////////////////
+void CPskWorker::SendLine(int Channel)
+{
+tPSK_TEXT Text;
+	if(0 == m_LineLength[Channel])
+		return;
+	Text.Freq = m_pParent->m_ChanFreq[Channel].load();
+	Text.Channel = Channel;
+	memcpy(Text.Text, m_Line[Channel], m_LineLength[Channel]);
+	Text.Text[m_LineLength[Channel]] = 0;
+	m_LineLength[Channel] = 0;
+	m_pParent->m_TextQueue.Put(Text);	//drop text if GUI is not reading
+}
+
+/////////////////////////////////////////////////////////////////////
+// Constructor/Destructor
+// Leaves one core for the DSP thread
+/////////////////////////////////////////////////////////////////////
+CMultiPskDemod::CMultiPskDemod()
+{
+	m_SymbRate = 31.25;
+	for(int c=0; c<MPSK_MAX_CHANNELS; c++)
+	{
+		m_ChanState[c] = CHAN_FREE;
+		m_ChanFreq[c] = 0;
+		m_StartFreq[c] = 0.0;
+	}
+	m_NumWorkers = QThread::idealThreadCount() - 1;
+	if(m_NumWorkers < 1)
+		m_NumWorkers = 1;
+	if(m_NumWorkers > MPSK_MAX_WORKERS)
+		m_NumWorkers = MPSK_MAX_WORKERS;
+	for(int i=0; i<m_NumWorkers; i++)
+		m_pWorkers[i] = new CPskWorker(this, i, m_NumWorkers);
+qDebug()<<"Multi PSK workers="<<m_NumWorkers;
+}
+
+CMultiPskDemod::~CMultiPskDemod()
+{
+	for(int i=0; i<m_NumWorkers; i++)
+		delete m_pWorkers[i];
+}
+
+/////////////////////////////////////////////////////////////////////
+// DSP thread: sets the passband sample rate and symbol rate.
+// All channels are freed and the carrier search starts over.
+/////////////////////////////////////////////////////////////////////
+void CMultiPskDemod::Init(TYPEREAL SampleRate, TYPEREAL SymbRate)
+{
+	m_SymbRate = SymbRate;
+	m_Detect.Init(SampleRate, SymbRate);
+	for(int i=0; i<m_NumWorkers; i++)
+		m_pWorkers[i]->Init(SampleRate, SymbRate);
+}
+
+/////////////////////////////////////////////////////////////////////
+// DSP thread: passes a block of passband audio to the workers and
+//starts channels on any new carriers
+/////////////////////////////////////////////////////////////////////
+void CMultiPskDemod::PutData(int Length, const TYPECPX* pData)
+{
+	for(int i=0; i<m_NumWorkers; i++)
+		m_pWorkers[i]->PutData(pData, Length);
+	if( m_Detect.ProcessData(Length, pData) )
+		AssignChannels();
+}
+
+/////////////////////////////////////////////////////////////////////
+// DSP thread: starts a free channel on each carrier that is not
+//already being decoded. Carriers are strongest first so the weakest
+//are left out when every channel is busy.
+/////////////////////////////////////////////////////////////////////
+void CMultiPskDemod::AssignChannels()
+{
+	int num = m_Detect.GetCarriers(m_Carriers, MPSK_MAX_CHANNELS);
+	TYPEREAL spacing = CHAN_SPACING*m_SymbRate;
+	for(int i=0; i<num; i++)
+	{
+		int FreeChan = -1;
+		bool found = false;
+		for(int c=0; (c<MPSK_MAX_CHANNELS) && !found; c++)
+		{
+			int state = m_ChanState[c].loadAcquire();
+			if(CHAN_FREE == state)
+			{
+				if(FreeChan < 0)
+					FreeChan = c;
+				continue;
+			}
+			TYPEREAL freq = (CHAN_START == state) ? m_StartFreq[c] : (TYPEREAL)m_ChanFreq[c].load();
+			if( MFABS(freq - m_Carriers[i]) < spacing )
+				found = true;
+		}
+		if(found)
+			continue;
+		if(FreeChan < 0)
+			break;		//all channels busy
+		m_StartFreq[FreeChan] = m_Carriers[i];
+		m_ChanFreq[FreeChan].storeRelease( (int)(m_Carriers[i] + 0.5) );
+		m_ChanState[FreeChan].storeRelease(CHAN_START);
+	}
+}
+
+/////////////////////////////////////////////////////////////////////
+// GUI thread: gets the oldest line of decoded text
+/////////////////////////////////////////////////////////////////////
+bool CMultiPskDemod::GetText(tPSK_TEXT* pText)
+{
+	return m_TextQueue.Get(*pText);
+}
@@ -0,0 +1,144 @@
+//////////////////////////////////////////////////////////////////////
+// multipskdemod.h: interface for the CMultiPskDemod and CPskWorker classes.
+//
+// History:
+//	2026-10-18  Initial creation
+//	2026-10-18  Added GetMemorySize()
+//////////////////////////////////////////////////////////////////////
+//==========================================================================================
+// + + +   This Software is released under the "Simplified BSD License"  + + +
+//Copyright 2010 Moe Wheatley. All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification, are
+//permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice, this list of
+//	  conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice, this list
+//	  of conditions and the following disclaimer in the documentation and/or other materials
+//	  provided with the distribution.
+//
+//THIS SOFTWARE IS PROVIDED BY Moe Wheatley ``AS IS'' AND ANY EXPRESS OR IMPLIED
+//WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+//FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Moe Wheatley OR
+//CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+//ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+//ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//The views and conclusions contained in the software and documentation are those of the
+//authors and should not be interpreted as representing official policies, either expressed
+//or implied, of Moe Wheatley.
+//=============================================================================
+#ifndef MULTIPSKDEMOD_H
+#define MULTIPSKDEMOD_H
+#include "interface/threadwrapper.h"
+#include "interface/spscring.h"
+#include "interface/mpscqueue.h"
+#include "dsp/multipsk.h"
+
+#define MPSK_MAX_WORKERS 4		//most decoder threads
+#define MPSK_INQ_SIZE 32768		//passband samples queued for each worker thread
+#define MPSK_WORK_BLOCK 1024	//passband samples decoded per pass
+#define MPSK_TEXTQ_SIZE 256		//text lines waiting for the GUI
+#define MPSK_MAX_LINE 64		//longest line of text sent to the GUI
+#define MPSK_IDLE_TIME 2.0		//seconds without characters before a partial line is sent
+
+typedef struct _pskt
+{
+	int Freq;		//audio frequency of the signal in Hz
+	int Channel;	//decoder channel that found the text
+	char Text[MPSK_MAX_LINE+1];
+}tPSK_TEXT;
+
+class CMultiPskDemod;
+
+////////////
+//class for one decoder thread. Decodes every channel c with
+// c%NumWorkers == Index
+////////////
+class CPskWorker : public CThreadWrapper
+{
+	Q_OBJECT
+public:
+	CPskWorker(CMultiPskDemod* pParent, int Index, int NumWorkers);
+	~CPskWorker();
+
+	//called by the DSP thread
+	void Init(TYPEREAL SampleRate, TYPEREAL SymbRate);
+	void PutData(const TYPECPX* pData, int Length);
+
+signals:
+	void NewData();
+
+private slots:
+	void ThreadInit();	//overrided function is called by new thread when started
+	void ThreadExit();	//overrided function is called by new thread when stopped
+	void ProcNewData();
+
+private:
+	void AddChar(int Channel, quint8 ch);
+	void SendLine(int Channel);
+	CMultiPskDemod* m_pParent;
+	int m_Index;
+	int m_NumWorkers;
+	CSpscRing<TYPECPX, MPSK_INQ_SIZE> m_InQueue;
+	QAtomicInt m_InitRequest;	//set by Init() until the worker has reinitialized
+	QAtomicInt m_Pending;		//set while a NewData signal is waiting to be processed
+	QAtomicInt m_OverflowCount;
+	TYPEREAL m_SampleRate;		//protected by m_Mutex
+	TYPEREAL m_SymbRate;		//protected by m_Mutex
+
+	//used only by the worker thread
+	int m_IdleLimit;
+	int m_LineLength[MPSK_MAX_CHANNELS];
+	int m_IdleCount[MPSK_MAX_CHANNELS];
+	char m_Line[MPSK_MAX_CHANNELS][MPSK_MAX_LINE+1];
+	quint8 m_Chars[MPSK_WORK_BLOCK+1];
+	TYPECPX m_Buf[MPSK_WORK_BLOCK];
+};
+
+////////////
+//class that finds PSK signals in the audio passband and runs a decoder
+// channel on a pool of worker threads for each one
+////////////
+class CMultiPskDemod
+{
+public:
+	CMultiPskDemod();
+	~CMultiPskDemod();
+
+	//called by the DSP thread
+	void Init(TYPEREAL SampleRate, TYPEREAL SymbRate);
+	void PutData(int Length, const TYPECPX* pData);
+
+	int GetMemorySize(){return sizeof(CMultiPskDemod) + m_NumWorkers*sizeof(CPskWorker);}
+
+	//called by the single consumer(GUI) thread. Returns false if no text
+	bool GetText(tPSK_TEXT* pText);
+
+private:
+	friend class CPskWorker;
+	enum eCHANSTATE {CHAN_FREE, CHAN_START, CHAN_ACTIVE};
+	void AssignChannels();
+
+	//a channel only moves FREE->START on the DSP thread and
+	// START->ACTIVE->FREE on its worker thread
+	QAtomicInt m_ChanState[MPSK_MAX_CHANNELS];
+	QAtomicInt m_ChanFreq[MPSK_MAX_CHANNELS];	//current frequency in Hz set by the worker
+	TYPEREAL m_StartFreq[MPSK_MAX_CHANNELS];	//written by the DSP thread before CHAN_START
+	CPskChannel m_Channels[MPSK_MAX_CHANNELS];	//used only by the owning worker
+	CMpscQueue<tPSK_TEXT, MPSK_TEXTQ_SIZE> m_TextQueue;
+
+	//used only by the DSP thread
+	int m_NumWorkers;
+	CPskWorker* m_pWorkers[MPSK_MAX_WORKERS];
+	TYPEREAL m_SymbRate;
+	TYPEREAL m_Carriers[MPSK_MAX_CHANNELS];
+	CPskCarrierDetect m_Detect;
+};
+
+#endif // MULTIPSKDEMOD_H
@@ -9,6 +9,7 @@
 //	2013-07-28  fixed DisconnectFromServerSlot bug
 //	2015-03-26  Added  support for small MTU and UDP keepalive in case of port forwarding timeouts
 //	2015-07-13  removed winsock dependency, Changed a few threading issues
+//	2026-10-18  UDP receive buffer comes from a scratch arena sized to the datagrams
 /////////////////////////////////////////////////////////////////////
 //==========================================================================================
 // + + +   This Software is released under the "Simplified BSD License"  + + +
@@ -50,13 +51,16 @@
 #define MSGSTATE_DATA 2
 
 #define RCVBUF_SIZE_UDP 2097152
+#define MAX_UDP_DATAGRAM 20000	//larger datagrams are thrown away
 
 //*********    C U d p  I m p l e m e n t a t i o n       ***********
 /////////////////////////////////////////////////////////////////////
 // Constructor/Destructor
 /////////////////////////////////////////////////////////////////////
-CUdp::CUdp(QObject *parent) : m_pParent(parent)
+CUdp::CUdp(QObject *parent) : m_pParent(parent), m_Scratch("UDP thread")
 {
+	m_RxBufOffset = 0;
+	m_RxBufSize = 0;
 qDebug()<<"CUdp constructor";
 }
 
@@ -134,13 +138,20 @@ void CUdp::StopUdpSlot()
 ////////////////////////////////////////////////////////////////////////
 void CUdp::GotUdpData()
 {
-char pBuf[20000];
 	//loop while there are still datagrams to get
 	while( m_pUdpSocket->hasPendingDatagrams() )
 	{
 		qint64 n = m_pUdpSocket->pendingDatagramSize();
-		if(n<20000)
+		if(n<MAX_UDP_DATAGRAM)
 		{
+			if(n > m_RxBufSize)
+			{	//the radio sends one datagram size so this only runs at the start
+				m_RxBufSize = n;
+				m_Scratch.Begin();
+				m_RxBufOffset = m_Scratch.Add(m_RxBufSize);
+				m_Scratch.End();
+			}
+			char* pBuf = (char*)m_Scratch.Get(m_RxBufOffset);
 			m_UdpMutex.lock();
 			m_pUdpSocket->readDatagram(pBuf, n);
 			m_UdpMutex.unlock();
@@ -4,6 +4,7 @@
 // History:
 //	2012-12-12  Initial creation MSW
 //	2013-02-05  Modified for CuteSDR
+//	2026-10-18  UDP receive buffer comes from a scratch arena
 /////////////////////////////////////////////////////////////////////
 //==========================================================================================
 // + + +   This Software is released under the "Simplified BSD License"  + + +
@@ -38,6 +39,7 @@
 
 #include "threadwrapper.h"
 #include "ascpmsg.h"
+#include "dsp/scratcharena.h"
 #include <QTcpServer>
 #include <QUdpSocket>
 #include <QHostAddress>
@@ -74,7 +76,9 @@ private:
 	bool m_UseUdpFwd;
 	QHostAddress m_IPFwdAdr;
 	quint16 m_FwdPort;
-
+	CScratchArena m_Scratch;	//only used by the UDP thread
+	int m_RxBufOffset;
+	int m_RxBufSize;			//largest datagram received so far
 };
 
 /////////////////////////////////////////////////////
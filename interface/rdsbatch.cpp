@@ -0,0 +1,208 @@
+/////////////////////////////////////////////////////////////////////
+// rdsbatch.cpp: implementation of the CRdsBatchDecoder class.
+//
+//	Chunk N covers I/Q samples [N*m_ChunkLength, (N+1)*m_ChunkLength).
+// A worker decodes from RDSBATCH_LEADIN_TIME before the chunk to
+// RDSBATCH_TAIL_TIME after it and keeps only the groups that end inside
+// the chunk, so every group is reported once no matter how the file is
+// split. The caller holds back groups of a chunk until all earlier
+// chunks are finished.
+// History:
+//	2026-10-18  Initial creation
+/////////////////////////////////////////////////////////////////////
+//==========================================================================================
+// + + +   This Software is released under the "Simplified BSD License"  + + +
+//Copyright 2010 Moe Wheatley. All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification, are
+//permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice, this list of
+//	  conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice, this list
+//	  of conditions and the following disclaimer in the documentation and/or other materials
+//	  provided with the distribution.
+//
+//THIS SOFTWARE IS PROVIDED BY Moe Wheatley ``AS IS'' AND ANY EXPRESS OR IMPLIED
+//WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+//FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Moe Wheatley OR
+//CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+//ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+//ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//The views and conclusions contained in the software and documentation are those of the
+//authors and should not be interpreted as representing official policies, either expressed
+//or implied, of Moe Wheatley.
+//==========================================================================================
+#include "interface/rdsbatch.h"
+#include <QVector>
+#include <QDebug>
+
+CRdsBatchDecoder::CRdsBatchDecoder()
+{
+	m_SampleRate = 0.0;
+	m_NumSamples = 0;
+	m_ChunkLength = 0;
+	m_NumChunks = 0;
+}
+
+CRdsBatchDecoder::~CRdsBatchDecoder()
+{
+}
+
+/////////////////////////////////////////////////////////////////////
+// Decodes FileName on NumThreads worker threads and passes the groups
+// to pSink in file order. Blocks until the whole file is decoded.
+/////////////////////////////////////////////////////////////////////
+qint64 CRdsBatchDecoder::DecodeFile(const QString& FileName, CRdsBatchSink* pSink, int NumThreads)
+{
+	CWaveFileReader File;
+	if( !File.open(FileName) || !File.isOpen() || (File.GetSampleRate() == 0) )
+	{
+		qDebug()<<"RDS batch cannot read"<<FileName;
+		return -1;
+	}
+	m_FileName = FileName;
+	m_SampleRate = File.GetSampleRate();
+	m_NumSamples = File.GetNumberSamples();
+	File.close();
+
+	m_ChunkLength = (qint64)(RDSBATCH_CHUNK_TIME*m_SampleRate);
+	m_NumChunks = (int)( (m_NumSamples + m_ChunkLength - 1)/m_ChunkLength );
+	if(NumThreads <= 0)
+		NumThreads = QThread::idealThreadCount();
+	if(NumThreads > m_NumChunks)
+		NumThreads = m_NumChunks;
+	if(NumThreads > RDSBATCH_MAX_THREADS)
+		NumThreads = RDSBATCH_MAX_THREADS;
+	if(NumThreads < 1)
+		NumThreads = 1;
+	m_NextChunk.storeRelease(0);
+	m_Queue.Reset();
+
+	CWorker* pWorkers[RDSBATCH_MAX_THREADS];
+	for(int i=0; i<NumThreads; i++)
+	{
+		pWorkers[i] = new CWorker(this);
+		pWorkers[i]->start();
+	}
+
+	//collect groups from the workers and release them a whole chunk at a time
+	QVector< QVector<tRDS_BATCH_GROUP> > Pending(m_NumChunks);
+	QVector<bool> Done(m_NumChunks, false);
+	qint64 NumGroups = 0;
+	int NextOut = 0;
+	while(NextOut < m_NumChunks)
+	{
+		tBATCH_ITEM Item;
+		if( !m_Queue.Get(Item) )
+		{
+			QThread::msleep(1);
+			continue;
+		}
+		if(Item.Done)
+			Done[Item.Chunk] = true;
+		else
+			Pending[Item.Chunk].append(Item.Grp);
+		while( (NextOut < m_NumChunks) && Done[NextOut] )
+		{
+			for(int i=0; i<Pending[NextOut].size(); i++)
+			{
+				if(pSink)
+					pSink->PutGroup(Pending[NextOut].at(i));
+				NumGroups++;
+			}
+			Pending[NextOut].clear();
+			NextOut++;
+		}
+	}
+
+	for(int i=0; i<NumThreads; i++)
+	{
+		pWorkers[i]->wait();
+		delete pWorkers[i];
+	}
+	return NumGroups;
+}
+
+/////////////////////////////////////////////////////////////////////
+// Worker thread, keeps claiming chunks until the file is done.
+/////////////////////////////////////////////////////////////////////
+void CRdsBatchDecoder::CWorker::run()
+{
+	bool FileOk = m_File.open(m_pParent->m_FileName) && m_File.isOpen();
+	int Chunk;
+	while( (Chunk = m_pParent->m_NextChunk.fetchAndAddRelaxed(1)) < m_pParent->m_NumChunks )
+	{
+		if(FileOk)
+			DecodeChunk(Chunk);
+		tBATCH_ITEM Item;
+		Item.Chunk = Chunk;
+		Item.Done = 1;
+		PutItem(Item);
+	}
+	m_File.close();
+}
+
+/////////////////////////////////////////////////////////////////////
+// Decode one chunk plus its lead in and tail from a cold start.
+/////////////////////////////////////////////////////////////////////
+void CRdsBatchDecoder::CWorker::DecodeChunk(int Chunk)
+{
+	TYPEREAL SampleRate = m_pParent->m_SampleRate;
+	qint64 ChunkStart = (qint64)Chunk*m_pParent->m_ChunkLength;
+	qint64 ChunkEnd = ChunkStart + m_pParent->m_ChunkLength;
+	qint64 ReadStart = ChunkStart - (qint64)(RDSBATCH_LEADIN_TIME*SampleRate);
+	qint64 ReadEnd = ChunkEnd + (qint64)(RDSBATCH_TAIL_TIME*SampleRate);
+	if(ReadStart < 0)
+		ReadStart = 0;
+	if(ReadEnd > m_pParent->m_NumSamples)
+		ReadEnd = m_pParent->m_NumSamples;
+	if( !m_File.SeekToSample(ReadStart) )
+		return;
+
+	m_Decoder.Init( m_FrontEnd.Init(SampleRate) );
+	TYPEREAL Decimation = m_FrontEnd.GetDecimation();
+	qint64 Pos = ReadStart;
+	while(Pos < ReadEnd)
+	{
+		int n = RDSBATCH_READ_SIZE;
+		if( (ReadEnd - Pos) < n)
+			n = (int)(ReadEnd - Pos);
+		n = m_File.GetNextDataBlock(m_IQBuf, n);
+		if(n <= 0)
+			break;
+		Pos += n;
+		int length = m_FrontEnd.ProcessData(n, m_IQBuf, m_RdsBuf);
+		int NumEvents = m_Decoder.ProcessData(length, m_RdsBuf, m_Events, RDSBATCH_MAX_EVENTS);
+		for(int i=0; i<NumEvents; i++)
+		{
+			tRDS_GROUPS& Grp = m_Events[i].Group;
+			if( !Grp.BlockA && !Grp.BlockB && !Grp.BlockC && !Grp.BlockD )
+				continue;	//skip the loss of sync markers
+			qint64 FilePos = ReadStart + (qint64)(m_Events[i].SamplePos*Decimation);
+			if( (FilePos < ChunkStart) || (FilePos >= ChunkEnd) )
+				continue;	//belongs to a neighboring chunk
+			tBATCH_ITEM Item;
+			Item.Chunk = Chunk;
+			Item.Done = 0;
+			Item.Grp.Group = Grp;
+			Item.Grp.SamplePos = FilePos;
+			Item.Grp.Time = (double)FilePos/SampleRate;
+			PutItem(Item);
+		}
+	}
+}
+
+/////////////////////////////////////////////////////////////////////
+// Put an item in the queue, waiting for the caller if it is full.
+/////////////////////////////////////////////////////////////////////
+void CRdsBatchDecoder::CWorker::PutItem(const tBATCH_ITEM& Item)
+{
+	while( !m_pParent->m_Queue.Put(Item) )
+		QThread::yieldCurrentThread();
+}
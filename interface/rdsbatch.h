@@ -0,0 +1,129 @@
+//////////////////////////////////////////////////////////////////////
+// rdsbatch.h: interface for the CRdsBatchDecoder class.
+//
+//  Decodes all the RDS groups in a WFM I/Q recording much faster than
+//real time. The file is cut into chunks that are decoded in parallel
+//by worker threads, each with its own CWaveFileReader, CRdsFrontEnd and
+//CRdsDecoder. Each chunk starts decoding a little early so the decoder
+//is in sync by the start of the chunk. Workers put their groups in a
+//lock free queue and the calling thread hands them to a CRdsBatchSink
+//in file order.
+//
+// History:
+//	2026-10-18  Initial creation
+//////////////////////////////////////////////////////////////////////
+//==========================================================================================
+// + + +   This Software is released under the "Simplified BSD License"  + + +
+//Copyright 2010 Moe Wheatley. All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification, are
+//permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice, this list of
+//	  conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice, this list
+//	  of conditions and the following disclaimer in the documentation and/or other materials
+//	  provided with the distribution.
+//
+//THIS SOFTWARE IS PROVIDED BY Moe Wheatley ``AS IS'' AND ANY EXPRESS OR IMPLIED
+//WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+//FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Moe Wheatley OR
+//CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+//ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+//ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//The views and conclusions contained in the software and documentation are those of the
+//authors and should not be interpreted as representing official policies, either expressed
+//or implied, of Moe Wheatley.
+//=============================================================================
+#ifndef RDSBATCH_H
+#define RDSBATCH_H
+#include <QThread>
+#include <QString>
+#include <QAtomicInt>
+#include "interface/mpscqueue.h"
+#include "interface/wavefilereader.h"
+#include "dsp/rdsdecoder.h"
+
+#define RDSBATCH_CHUNK_TIME 10.0	//seconds of I/Q data decoded by a worker at a time
+#define RDSBATCH_LEADIN_TIME 1.0	//seconds decoded before a chunk to get in sync
+#define RDSBATCH_TAIL_TIME 0.25		//seconds decoded after a chunk to finish its last group
+#define RDSBATCH_READ_SIZE 1024		//I/Q samples per file read(must fit in MAX_RDDATABLK)
+#define RDSBATCH_QSIZE 1024			//groups queued between the workers and the caller
+#define RDSBATCH_MAX_THREADS 32
+#define RDSBATCH_MAX_EVENTS 16		//groups returned per decoder pass
+
+//one decoded group from the file
+typedef struct _RDS_BATCH_GROUP
+{
+	tRDS_GROUPS Group;
+	qint64 SamplePos;	//I/Q sample index in the file at the end of the group
+	double Time;		//SamplePos in seconds from the start of the file
+}tRDS_BATCH_GROUP;
+
+//interface that receives the decoded groups
+class CRdsBatchSink
+{
+public:
+	virtual ~CRdsBatchSink(){}
+	virtual void PutGroup(const tRDS_BATCH_GROUP& Group) = 0;
+};
+
+class CRdsBatchDecoder
+{
+public:
+	CRdsBatchDecoder();
+	~CRdsBatchDecoder();
+
+	//Decodes the whole file using NumThreads workers(0 uses one per core).
+	//pSink is called from the calling thread with every group in file order.
+	//Returns the number of groups found or -1 if the file could not be read.
+	qint64 DecodeFile(const QString& FileName, CRdsBatchSink* pSink, int NumThreads = 0);
+	TYPEREAL GetSampleRate(){return m_SampleRate;}
+
+private:
+	//queue entry from a worker. Done is set on the last entry of a chunk
+	typedef struct _BATCH_ITEM
+	{
+		int Chunk;
+		int Done;
+		tRDS_BATCH_GROUP Grp;
+	}tBATCH_ITEM;
+
+	////////////
+	//private worker thread class that decodes chunks until none are left
+	////////////
+	class CWorker : public QThread
+	{
+	public:
+		CWorker(CRdsBatchDecoder* pParent) : m_pParent(pParent){}
+	protected:
+		void run();
+	private:
+		void DecodeChunk(int Chunk);
+		void PutItem(const tBATCH_ITEM& Item);
+		CRdsBatchDecoder* m_pParent;
+		CWaveFileReader m_File;
+		CRdsFrontEnd m_FrontEnd;
+		CRdsDecoder m_Decoder;
+		TYPECPX m_IQBuf[RDSBATCH_READ_SIZE];
+		TYPECPX m_RdsBuf[RDSBATCH_READ_SIZE];
+		tRDS_GROUP_EVENT m_Events[RDSBATCH_MAX_EVENTS];
+	};
+
+	//set up by DecodeFile() before the workers start, then read only
+	QString m_FileName;
+	TYPEREAL m_SampleRate;
+	qint64 m_NumSamples;
+	qint64 m_ChunkLength;
+	int m_NumChunks;
+
+	QAtomicInt m_NextChunk;		//next chunk for a worker to claim
+	CMpscQueue<tBATCH_ITEM, RDSBATCH_QSIZE> m_Queue;
+};
+
+#endif // RDSBATCH_H
@@ -0,0 +1,151 @@
+/////////////////////////////////////////////////////////////////////
+// rdsthread.cpp: implementation of the CRdsThread class.
+//
+//	No locks are taken on the data path. The input ring has one
+// producer(DSP thread) and one consumer(RDS thread). The group queue
+// can take groups from any number of decoder threads and is read by
+// the GUI thread. Only the rare Init() request takes m_Mutex.
+// History:
+//	2026-10-18  Initial creation
+//	2026-10-18  NewData is connected before the first signal can be sent
+//	2026-10-18  Stops the thread before its members are destroyed, Init() drops undelivered groups
+/////////////////////////////////////////////////////////////////////
+//==========================================================================================
+// + + +   This Software is released under the "Simplified BSD License"  + + +
+//Copyright 2010 Moe Wheatley. All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification, are
+//permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice, this list of
+//	  conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice, this list
+//	  of conditions and the following disclaimer in the documentation and/or other materials
+//	  provided with the distribution.
+//
+//THIS SOFTWARE IS PROVIDED BY Moe Wheatley ``AS IS'' AND ANY EXPRESS OR IMPLIED
+//WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+//FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Moe Wheatley OR
+//CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+//ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+//ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//The views and conclusions contained in the software and documentation are those of the
+//authors and should not be interpreted as representing official policies, either expressed
+//or implied, of Moe Wheatley.
+//==========================================================================================
+#include "interface/rdsthread.h"
+#include <QDebug>
+
+/////////////////////////////////////////////////////////////////////
+// Constructor/Destructor
+/////////////////////////////////////////////////////////////////////
+CRdsThread::CRdsThread()
+{
+	m_InitRequest = 0;
+	m_FlushRequest = 0;
+	m_Pending = 0;
+	//connected here rather than in ThreadInit() so a NewData signal sent
+	// before the thread runs is queued instead of lost with m_Pending latched
+	connect(this,SIGNAL( NewData()), this, SLOT(ProcNewData()), Qt::QueuedConnection );
+	m_OverflowCount = 0;
+	m_SampleRate = 8000.0;
+}
+
+CRdsThread::~CRdsThread()
+{
+	CleanupThread();	//tell thread to cleanup after itself by calling ThreadExit()
+	//stop the thread before the decoder and rings it uses are destroyed
+	m_pThread->exit();
+	m_pThread->wait();
+}
+
+////////////////////////////////////////////////////////////////////////
+//  called by RDS worker thread to initialize its world
+////////////////////////////////////////////////////////////////////////
+void CRdsThread::ThreadInit()
+{
+qDebug()<<"RDS Thread "<<this->thread()->currentThread();
+}
+
+/////////////////////////////////////////////////////////////////////
+// Called by this worker thread to cleanup after itself
+/////////////////////////////////////////////////////////////////////
+void CRdsThread::ThreadExit()
+{
+	disconnect();
+}
+
+/////////////////////////////////////////////////////////////////////
+// DSP thread: asks the RDS thread to restart the decoder at a new
+//baseband sample rate. Queued data at the old rate is thrown away and
+//so are the groups the GUI has not read yet.
+/////////////////////////////////////////////////////////////////////
+void CRdsThread::Init(TYPEREAL SampleRate)
+{
+	m_Mutex.lock();
+	m_SampleRate = SampleRate;
+	m_Mutex.unlock();
+	m_InitRequest.storeRelease(1);
+	m_FlushRequest.storeRelease(1);
+}
+
+/////////////////////////////////////////////////////////////////////
+// DSP thread: queues a block of RDS baseband samples.
+// Only one NewData signal is kept pending so a slow RDS thread cannot
+//flood its event queue.  If the ring is full the newest data is dropped.
+/////////////////////////////////////////////////////////////////////
+void CRdsThread::PutData(const TYPECPX* pData, int Length)
+{
+	if( m_InQueue.Put(pData, Length) < Length )
+		m_OverflowCount.fetchAndAddRelaxed(1);
+	if( 0 == m_Pending.fetchAndStoreOrdered(1) )
+		emit NewData();	//tell RDS worker thread there's data to process
+}
+
+/////////////////////////////////////////////////////////////////////
+// RDS thread: decodes everything in the input ring
+/////////////////////////////////////////////////////////////////////
+void CRdsThread::ProcNewData()
+{
+	m_Pending.fetchAndStoreOrdered(0);	//clear before reading so new data always gets a signal
+	if( m_InitRequest.fetchAndStoreAcquire(0) )
+	{
+		m_Mutex.lock();
+		TYPEREAL rate = m_SampleRate;
+		m_Mutex.unlock();
+		m_InQueue.Skip( m_InQueue.Level() );
+		m_Decoder.Init(rate);
+	}
+	int n;
+	while( (n = m_InQueue.Get(m_Buf, RDS_BLOCK_SIZE)) > 0 )
+	{
+		int num = m_Decoder.ProcessData(n, m_Buf, m_Events, RDS_MAX_EVENTS);
+		for(int i=0; i<num; i++)
+		{
+			if( !m_GroupQueue.Put(m_Events[i]) )
+				break;	//GUI not reading so drop groups
+		}
+	}
+}
+
+/////////////////////////////////////////////////////////////////////
+// GUI thread: gets the oldest decoded group
+/////////////////////////////////////////////////////////////////////
+bool CRdsThread::GetGroup(tRDS_GROUPS* pGroup)
+{
+tRDS_GROUP_EVENT Event;
+	if( m_FlushRequest.fetchAndStoreAcquire(0) )
+	{
+		while( m_GroupQueue.Get(Event) )
+			;	//groups from before the last Init()
+	}
+	if( !m_GroupQueue.Get(Event) )
+		return false;
+	*pGroup = Event.Group;
+	return true;
+}
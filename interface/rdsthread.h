@@ -0,0 +1,90 @@
+//////////////////////////////////////////////////////////////////////
+// rdsthread.h: interface for the CRdsThread class.
+//
+//  Runs a CRdsDecoder on its own thread so RDS decoding does not add
+//to the WFM audio latency or DSP thread load.
+//  The DSP thread puts decimated RDS baseband blocks in a lock free
+//ring, the RDS thread decodes them and puts the groups in a lock free
+//queue that the GUI reads.
+//
+// History:
+//	2026-10-18  Initial creation
+//	2026-10-18  Init() also drops the undelivered groups
+//////////////////////////////////////////////////////////////////////
+//==========================================================================================
+// + + +   This Software is released under the "Simplified BSD License"  + + +
+//Copyright 2010 Moe Wheatley. All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification, are
+//permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice, this list of
+//	  conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice, this list
+//	  of conditions and the following disclaimer in the documentation and/or other materials
+//	  provided with the distribution.
+//
+//THIS SOFTWARE IS PROVIDED BY Moe Wheatley ``AS IS'' AND ANY EXPRESS OR IMPLIED
+//WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+//FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Moe Wheatley OR
+//CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+//ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+//ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//The views and conclusions contained in the software and documentation are those of the
+//authors and should not be interpreted as representing official policies, either expressed
+//or implied, of Moe Wheatley.
+//=============================================================================
+#ifndef RDSTHREAD_H
+#define RDSTHREAD_H
+#include "interface/threadwrapper.h"
+#include "interface/spscring.h"
+#include "interface/mpscqueue.h"
+#include "dsp/rdsdecoder.h"
+
+#define RDS_INQ_SIZE 32768		//baseband samples queued for the RDS thread(about 2 Sec)
+#define RDS_GROUPQ_SIZE 128		//decoded groups waiting for the GUI(about 10 Sec)
+#define RDS_MAX_EVENTS 16		//groups returned per decoder pass
+
+class CRdsThread : public CThreadWrapper
+{
+	Q_OBJECT
+public:
+	CRdsThread();
+	~CRdsThread();
+
+	//called by the DSP thread. Init() also drops the groups not yet read
+	void Init(TYPEREAL SampleRate);
+	void PutData(const TYPECPX* pData, int Length);
+
+	//called by the single consumer(GUI) thread. Returns false if no group
+	bool GetGroup(tRDS_GROUPS* pGroup);
+
+signals:
+	void NewData();
+
+private slots:
+	void ThreadInit();	//overrided function is called by new thread when started
+	void ThreadExit();	//overrided function is called by new thread when stopped
+	void ProcNewData();
+
+private:
+	CSpscRing<TYPECPX, RDS_INQ_SIZE> m_InQueue;
+	CMpscQueue<tRDS_GROUP_EVENT, RDS_GROUPQ_SIZE> m_GroupQueue;
+	QAtomicInt m_InitRequest;	//set by Init() until the RDS thread has reinitialized
+	QAtomicInt m_FlushRequest;	//set by Init() until GetGroup() has emptied m_GroupQueue
+	QAtomicInt m_Pending;		//set while a NewData signal is waiting to be processed
+	QAtomicInt m_OverflowCount;
+	TYPEREAL m_SampleRate;		//protected by m_Mutex
+
+	//used only by the RDS thread
+	CRdsDecoder m_Decoder;
+	TYPECPX m_Buf[RDS_BLOCK_SIZE];
+	tRDS_GROUP_EVENT m_Events[RDS_MAX_EVENTS];
+};
+
+#endif // RDSTHREAD_H
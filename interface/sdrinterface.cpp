@@ -16,6 +16,13 @@
 //	2013-04-13  Added CloudSDR support, fixed network closing bug with pending msgs
 //	2015-03-26  Added  support for small MTU and UDP keepalive in case of port forwarding timeouts
 //	2015-10-26  Added Files saving functionality
+//	2026-10-18  Added wideband CW skimmer
+//	2026-10-18  Added multi-channel FSK mode
+//	2026-10-18  Squelch gated audio goes to PutSilence()
+//	2026-10-18  Noise processing setup includes audio noise reduction
+//	2026-10-18  Noise processing setup includes the auto notch
+//	2026-10-18  Audio buffer comes from a scratch arena on the DSP thread
+//	2026-10-18  CW skimmer is handed to the DSP thread with release/acquire atomics
 /////////////////////////////////////////////////////////////////////
 
 //==========================================================================================
@@ -150,8 +157,10 @@ const TYPEREAL CLOUDSDR_SAMPLERATE[MAX_SAMPLERATES] =
 /////////////////////////////////////////////////////////////////////
 // Constructor/Destructor
 /////////////////////////////////////////////////////////////////////
-CSdrInterface::CSdrInterface()
+CSdrInterface::CSdrInterface() : m_DspScratch("DSP thread")
 {
+	m_SoundBufOffset = 0;
+	m_SoundBufLength = 0;
 	m_Running = false;
 	m_FileRecordActive = false;
 	m_RecordMode = RECORDMODE_AUDIO;
@@ -185,6 +194,10 @@ CSdrInterface::CSdrInterface()
 	m_pSoundCardOut = new CSoundOut();
 	m_pdataProcess = new CDataProcess(this);
 	m_pWaveFileWriter = new CWaveFileWriter;
+	m_pCwSkimmer = NULL;
+	m_pActiveCwSkimmer.storeRelease(NULL);
+	m_CwSkimmerReinit = 0;
+	m_CwSkimmerRate = 0.0;
 	m_Status = NOT_CONNECTED;
 	m_ChannelMode = CI_RX_CHAN_SETUP_SINGLE_1;	//default channel settings for NetSDR
 	m_Channel = CI_RX_CHAN_1;
@@ -212,6 +225,12 @@ qDebug()<<"CSdrInterface destructor";
 		delete m_pdataProcess;
 		m_pdataProcess = NULL;
 	}
+	if(m_pCwSkimmer)
+	{
+		m_pActiveCwSkimmer.storeRelease(NULL);
+		delete m_pCwSkimmer;
+		m_pCwSkimmer = NULL;
+	}
 
 }
 
@@ -913,6 +932,42 @@ qDebug()<<"UsrDataRate="<< m_Demodulator.GetOutputRate();
 void CSdrInterface::SetPskMode(int Index)
 {
 	m_Demodulator.SetPskMode(Index);
+	//multi-channel modes use a wider passband so output rate may change
+	m_pSoundCardOut->ChangeUserDataRate( m_Demodulator.GetOutputRate());
+}
+
+////////////////////////////////////////////////////////////////////////
+// Switches between single and multi-channel DSC FSK decoding
+////////////////////////////////////////////////////////////////////////
+void CSdrInterface::SetFskMode(bool Multi)
+{
+	m_Demodulator.SetFskMode(Multi);
+	m_pSoundCardOut->ChangeUserDataRate( m_Demodulator.GetOutputRate());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//called by the GUI thread to turn the CW skimmer on or off.
+// The skimmer and its threads are created the first time it is turned on
+// and kept until this object is destroyed.
+///////////////////////////////////////////////////////////////////////////////
+void CSdrInterface::SetCwSkimmer(bool On)
+{
+	if(On && !m_pCwSkimmer)
+		m_pCwSkimmer = new CCwSkimmer();
+	m_CwSkimmerReinit.storeRelease(1);		//force a reinit so old channels are dropped
+	//release so the DSP thread sees a fully constructed skimmer
+	m_pActiveCwSkimmer.storeRelease(On ? m_pCwSkimmer : NULL);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//called by the GUI thread to read the next CW skimmer spot.
+// Returns false if no spots are waiting
+///////////////////////////////////////////////////////////////////////////////
+bool CSdrInterface::GetNextCwSpot(tCW_SPOT* pSpot)
+{
+	if(!m_pCwSkimmer)
+		return false;
+	return m_pCwSkimmer->GetSpot(pSpot);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -924,6 +979,8 @@ void CSdrInterface::SetupNoiseProc(tNoiseProcdInfo* pNoiseProcSettings)
 							  pNoiseProcSettings->NBThreshold,
 							  pNoiseProcSettings->NBWidth,
 							  m_SampleRate);
+	m_Demodulator.SetNoiseReduce(pNoiseProcSettings->NROn, pNoiseProcSettings->NRLevel);
+	m_Demodulator.SetAutoNotch(pNoiseProcSettings->NotchOn);
 }
 
 
@@ -1066,14 +1123,36 @@ void CSdrInterface::ProcessIQData(TYPECPX *pIQData, int NumSamples)
 			}
 		}
 	}
-	TYPECPX SoundBuf[8192];
-	int n;
+	CCwSkimmer* pCwSkimmer = m_pActiveCwSkimmer.loadAcquire();
+	if(pCwSkimmer)
+	{
+		if( m_CwSkimmerReinit.fetchAndStoreAcquire(0) || (m_CwSkimmerRate != m_SampleRate) )
+		{
+			m_CwSkimmerRate = m_SampleRate;
+			pCwSkimmer->Init(m_SampleRate);
+		}
+		pCwSkimmer->PutData(pIQData, NumSamples);
+	}
+	//size the audio buffer for this block. The demod input rate only
+	// changes while the SDR is stopped so this normally does nothing.
+	int n = m_Demodulator.GetMaxOutputLength(NumSamples);
+	if( (n > m_SoundBufLength) || (2*n < m_SoundBufLength) )
+	{
+		m_SoundBufLength = n;
+		m_DspScratch.Begin();
+		m_SoundBufOffset = m_DspScratch.Add(m_SoundBufLength*sizeof(TYPECPX));
+		m_DspScratch.End();
+	}
+	TYPECPX* SoundBuf = (TYPECPX*)m_DspScratch.Get(m_SoundBufOffset);
 	if(m_StereoOut)
 	{
 		n = m_Demodulator.ProcessData(NumSamples, pIQData, SoundBuf);
 		if(m_pSoundCardOut)
 		{
-			n = m_pSoundCardOut->PutOutQueue(n, SoundBuf);
+			if(m_Demodulator.IsOutputSilent())
+				n = m_pSoundCardOut->PutSilence(n, true);
+			else
+				n = m_pSoundCardOut->PutOutQueue(n, SoundBuf);
 			if( m_FileRecordActive && (RECORDMODE_AUDIO == m_RecordMode) )
 			{	//write stereo audio to file if active
 				if(!m_pWaveFileWriter->Write( (qint8*)m_pSoundCardOut->m_RData, n*4 ))
@@ -1086,7 +1165,10 @@ void CSdrInterface::ProcessIQData(TYPECPX *pIQData, int NumSamples)
 		n = m_Demodulator.ProcessData(NumSamples, pIQData, (TYPEREAL*)SoundBuf);
 		if(m_pSoundCardOut)
 		{
-			n = m_pSoundCardOut->PutOutQueue(n, (TYPEREAL*)SoundBuf);
+			if(m_Demodulator.IsOutputSilent())
+				n = m_pSoundCardOut->PutSilence(n, false);
+			else
+				n = m_pSoundCardOut->PutOutQueue(n, (TYPEREAL*)SoundBuf);
 			if( m_FileRecordActive && (RECORDMODE_AUDIO == m_RecordMode) )
 			{	//write mono audio to file if active
 				if(!m_pWaveFileWriter->Write((qint8*)m_pSoundCardOut->m_RData, n*2 ))
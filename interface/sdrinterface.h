@@ -6,6 +6,11 @@
 //	2011-03-27  Initial release
 //	2011-04-16  Added Frequency range logic for optional down converter modules
 //	2011-08-07  Added WFM Support
+//	2026-10-18  Added wideband CW skimmer
+//	2026-10-18  Added multi-channel FSK mode
+//	2026-10-18  Added squelch gate and demod CPU counters
+//	2026-10-18  Audio buffer comes from a scratch arena on the DSP thread
+//	2026-10-18  CW skimmer is handed to the DSP thread with release/acquire atomics
 /////////////////////////////////////////////////////////////////////
 //==========================================================================================
 // + + +   This Software is released under the "Simplified BSD License"  + + +
@@ -46,7 +51,10 @@
 #include "interface/soundout.h"
 #include "interface/protocoldefs.h"
 #include "interface/wavefilewriter.h"
+#include "interface/cwskimmerthread.h"
 #include "dataprocess.h"
+#include <QAtomicInt>
+#include <QAtomicPointer>
 
 
 #define RECORDMODE_AUDIO 0
@@ -125,6 +133,8 @@ public:
 				{ m_pSoundCardOut->Stop(); m_SoundInIndex = SoundInIndex;
 					m_SoundOutIndex = SoundOutIndex;  m_StereoOut = StereoOut;}
 
+	void SetSoundLatency(qint32 TargetMs){ m_pSoundCardOut->SetLatencyTarget(TargetMs); }
+	int SetAudioSinks(const QStringList& Specs){ return m_pSoundCardOut->SetSinks(Specs); }
 	int GetRateError(){return m_pSoundCardOut->GetRateError();}
 	void SetVolume(qint32 vol){ m_pSoundCardOut->SetVolume(vol); }
 
@@ -165,11 +175,23 @@ public:
 	void SetUSFmVersion(bool USFm){m_USFm = USFm;}
 	bool GetUSFmVersion(){return m_USFm;}
 	void SetPskMode(int Index);
+	void SetFskMode(bool Multi);
+	void SetSquelchGate(bool On){m_Demodulator.SetSquelchGate(On);}
+	void GetDemodStats(tDEMOD_STATS* pStats, bool Reset){m_Demodulator.GetStats(pStats, Reset);}
 
 	//access to WFM mode status/data
 	int GetStereoLock(int* pPilotLock){ return m_Demodulator.GetStereoLock(pPilotLock);}
 	int GetNextRdsGroupData(tRDS_GROUPS* pGroupData){return m_Demodulator.GetNextRdsGroupData(pGroupData);}
 
+	//access to multi-channel PSK text
+	bool GetNextPskText(tPSK_TEXT* pText){return m_Demodulator.GetNextPskText(pText);}
+	//access to multi-channel FSK text
+	bool GetNextFskText(tFSK_TEXT* pText){return m_Demodulator.GetNextFskText(pText);}
+
+	//wideband CW skimmer over the whole I/Q bandwidth
+	void SetCwSkimmer(bool On);
+	bool GetNextCwSpot(tCW_SPOT* pSpot);
+
 
 signals:
 	void NewInfoData();			//emitted when sdr information is received after GetSdrInfo()
@@ -226,9 +248,16 @@ private:
 	CFft m_Fft;
 	CDemodulator m_Demodulator;
 	CNoiseProc m_NoiseProc;
+	CScratchArena m_DspScratch;	//only used by the thread calling ProcessIQData()
+	int m_SoundBufOffset;
+	int m_SoundBufLength;
 	CSoundOut* m_pSoundCardOut;
 	CDataProcess* m_pdataProcess;
 	CWaveFileWriter* m_pWaveFileWriter;
+	CCwSkimmer* m_pCwSkimmer;		//created the first time the skimmer is turned on
+	QAtomicPointer<CCwSkimmer> m_pActiveCwSkimmer;	//m_pCwSkimmer while on, else NULL
+	QAtomicInt m_CwSkimmerReinit;	//set by the GUI to drop the skimmer's old channels
+	TYPEREAL m_CwSkimmerRate;		//DSP thread only, rate the skimmer was last initialized to
 
 CIir m_Iir;
 
@@ -11,6 +11,12 @@
 //	2010-09-15  Initial creation MSW
 //	2013-01-31  Changed Threading method, removed blocking mode
 //	2015-10-26  Changed OutQueue routines to return number of resampled data
+//	2026-10-18  Added low latency mode with PI rate controller and underrun/overrun counters
+//	2026-10-18  Replaced mutex protected output queue with lock free ring
+//	2026-10-18  Added audio sinks and headless operation
+//	2026-10-18  Added PutSilence() for squelch gated channels
+//	2026-10-18  Latency target is applied on the soundcard thread by Start()
+//	2026-10-18  DSP thread reads the queue limits from a snapshot
 /////////////////////////////////////////////////////////////////////
 
 //==========================================================================================
@@ -46,6 +52,7 @@
 #include "interface/sdrinterface.h"
 #include <QDebug>
 #include <math.h>
+#include <string.h>
 
 #define SOUNDCARD_RATE 48000	//output soundcard sample rate
 //#define SOUNDCARD_RATE 44100
@@ -53,6 +60,15 @@
 #define FILTERQLEVEL_ALPHA 0.001
 #define P_GAIN 2.38e-7		//Proportional gain
 
+//low latency mode parameters
+#define MIN_LATENCY_MS 10		//range of target queue depth
+#define MAX_LATENCY_MS 150
+#define LL_FILTERQLEVEL_ALPHA 0.02
+#define LL_UPDATE_INTERVAL (SOUNDCARD_RATE/10)	//rate update every 100mS
+#define LL_P_GAIN 4.0e-6		//Proportional gain (about 5 Sec time constant)
+#define LL_INTEGRAL_TIME 20.0	//integrator time constant in Secs
+#define LL_MAX_CORRECTION 1.0e-3	//limit rate correction to +-1000ppm
+
 #define TEST_ERROR 1.0
 //#define TEST_ERROR 1.001	//use to force fixed sample rate error for testing
 //#define TEST_ERROR 0.999
@@ -69,8 +85,24 @@ CSoundOut::CSoundOut()
 	m_OutAudioFormat.setSampleRate(SOUNDCARD_RATE);
 	m_OutResampler.Init(8192);
 	m_RateCorrection = 0.0;
+	m_RateCorrectionPpb = 0;
+	m_PpmError = 0;
+	m_DropRequest = 0;
+	m_FlushRequest = 0;
+	m_NumSinks = 0;
+	for(int i=0; i<MAX_AUDIO_SINKS; i++)
+		m_pSinks[i] = NULL;
+	m_Headless = false;
+	m_StereoOut = false;
 	m_Gain = 1.0;
+	m_SilenceTime = 0.0;
 	m_Startup = true;
+	m_UnderrunCount = 0;
+	m_OverrunCount = 0;
+	m_ErrorIntegral = 0.0;
+	m_PendingTargetMs = 0;
+	ApplyLatencyTarget();
+	m_DspLimits.Update();
 //qDebug()<<"GUI Thread "<<this->thread()->currentThread();
 }
 
@@ -78,6 +110,7 @@ CSoundOut::~CSoundOut()
 {
 qDebug()<<"CSoundOut destructor";
 	CleanupThread();	//tell thread to cleanup after itself by calling ThreadExit()
+	DeleteSinks();
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -107,7 +140,17 @@ void CSoundOut::StartSlot(int OutDevIndx, bool StereoOut, double UsrDataRate)
 QAudioDeviceInfo  DeviceInfo;
 qDebug()<<"Soundout Thread "<<this->thread()->currentThread();
     m_pThread->setPriority(QThread::HighestPriority);
+	ApplyLatencyTarget();
 	m_StereoOut = StereoOut;
+	m_Headless = (OutDevIndx < 0);
+	if(m_Headless)
+	{	//no soundcard so just resample to the sinks
+		m_OutAudioFormat.setSampleRate(SOUNDCARD_RATE);
+		m_UserDataRate = 1;	//force user data rate to be changed
+		ChangeUserDataRate(UsrDataRate);
+		qDebug()<<"Soundcard output headless";
+		return;
+	}
 	//Get required soundcard from list
 	m_OutDevices = DeviceInfo.availableDevices(QAudio::AudioOutput);
 	m_OutDeviceInfo = m_OutDevices.at(OutDevIndx);
@@ -139,14 +182,26 @@ qDebug()<<"Soundout Thread "<<this->thread()->currentThread();
 		//initialize the data queue variables
 		m_UserDataRate = 1;	//force user data rate to be changed
 		ChangeUserDataRate(UsrDataRate);
+		m_UnderrunCount.storeRelease(0);
+		m_OverrunCount.storeRelease(0);
 		//operate in mode where notify() slot is called periodically to
 		// see how much data can be sent to soundcard output
 		//connect notify signal to get more soundcard output data
-		m_pAudioOutput->setBufferSize(SOUND_WRITEBUFSIZE*2);
+		if(m_LowLatency)
+		{	//size soundcard buffer to the target depth and service it often
+			m_pAudioOutput->setBufferSize(m_TargetLevel*m_OutAudioFormat.bytesPerFrame());
+		}
+		else
+		{
+			m_pAudioOutput->setBufferSize(SOUND_WRITEBUFSIZE*2);
+		}
 		//connect notify event that new output data is needed
 		connect(m_pAudioOutput,SIGNAL(notify()), this, SLOT(GetNewData()));
 		m_pIODevice = m_pAudioOutput->start(); //start Qt AudioOutput, get pointer to its QIODevice
-		m_pAudioOutput->setNotifyInterval(20);	//20mSec update interval
+		if(m_LowLatency)
+			m_pAudioOutput->setNotifyInterval( qMax(5, m_TargetMs/4) );
+		else
+			m_pAudioOutput->setNotifyInterval(20);	//20mSec update interval
 		GetNewData();	//fill buffer initially with zeros
         qDebug()<<"Soundcard output Opened ok";
         return;
@@ -175,28 +230,72 @@ qDebug()<<"Soundcard output stopped";
 
 /////////////////////////////////////////////////////////////////////
 // Sets/changes user data input rate
+// The queue itself is emptied by the soundcard thread on its next update.
 /////////////////////////////////////////////////////////////////////
 void CSoundOut::ChangeUserDataRate(TYPEREAL UsrDataRate)
 {
 	if(m_UserDataRate != UsrDataRate)
 	{
 		m_UserDataRate = UsrDataRate;
-		for(int i=0; i<OUTQSIZE ;i++)	//zero buffer for data output
-		{
-			m_OutQueueMono[i] = 0;
-			m_OutQueueStereo[i].re = 0;
-			m_OutQueueStereo[i].im = 0;
-		}
 		m_OutRatio = m_UserDataRate/m_OutAudioFormat.sampleRate();
-		m_OutQHead = 0;
-		m_OutQTail = 0;
-		m_OutQLevel = 0;
-		m_AveOutQLevel = OUTQSIZE/2;
-		m_Startup = true;
+		m_RateCorrectionPpb.storeRelease(0);
+		m_FlushRequest.storeRelease(1);
 	}
 //qDebug()<<"SoundOutRatio  Rate"<<(1.0/m_OutRatio) << m_UserDataRate;
 }
 
+/////////////////////////////////////////////////////////////////////
+// Sets output queue depth target in mSec.
+// TargetMs == 0 selects the robust mode that keeps the queue half full
+//(about 200mS) and recovers from over/underflows by jumping half a queue.
+// In low latency mode the queue is kept at TargetMs using a faster PI
+//controller on the resampler ratio, an underflow outputs silence until the
+//queue refills to the target and an overflow throws away just enough old
+//data to get back to the target.  The soundcard buffer is sized to TargetMs.
+// Takes effect the next time the soundcard output is started.
+/////////////////////////////////////////////////////////////////////
+void CSoundOut::SetLatencyTarget(int TargetMs)
+{
+	m_PendingTargetMs.storeRelease(TargetMs);
+}
+
+/////////////////////////////////////////////////////////////////////
+// Soundcard thread: sets up the queue controller for the target last
+//passed to SetLatencyTarget(). Called by StartSlot() before the soundcard
+//is opened so the controller never changes while data is flowing.
+/////////////////////////////////////////////////////////////////////
+void CSoundOut::ApplyLatencyTarget()
+{
+	int TargetMs = m_PendingTargetMs.loadAcquire();
+	if(TargetMs <= 0)
+	{
+		m_LowLatency = false;
+		m_TargetMs = 0;
+		m_TargetLevel = OUTQSIZE/2;
+		m_MaxLevel = OUTQSIZE-1;
+		m_QLevelAlpha = FILTERQLEVEL_ALPHA;
+		m_RateUpdateInterval = SOUNDCARD_RATE;		//every second
+	}
+	else
+	{
+		if(TargetMs < MIN_LATENCY_MS)
+			TargetMs = MIN_LATENCY_MS;
+		if(TargetMs > MAX_LATENCY_MS)
+			TargetMs = MAX_LATENCY_MS;
+		m_LowLatency = true;
+		m_TargetMs = TargetMs;
+		m_TargetLevel = (TargetMs*SOUNDCARD_RATE)/1000;
+		m_MaxLevel = 3*m_TargetLevel;
+		m_QLevelAlpha = LL_FILTERQLEVEL_ALPHA;
+		m_RateUpdateInterval = LL_UPDATE_INTERVAL;
+	}
+	tQUEUE_LIMITS Limits;
+	Limits.LowLatency = m_LowLatency;
+	Limits.TargetLevel = m_TargetLevel;
+	Limits.MaxLevel = m_MaxLevel;
+	m_DspLimits.Publish(Limits);
+}
+
 /////////////////////////////////////////////////////////////////////
 // Sets/changes volume control gain  0 <= vol <= 99
 //range scales to attenuation(gain) of -50dB to 0dB
@@ -260,34 +359,20 @@ int NumResamples;
 		return 0;
 
 	//Call Resampler to match sample rates between radio and sound card
-	NumResamples = m_OutResampler.Resample(numsamples, TEST_ERROR*m_OutRatio *(1.0+m_RateCorrection),
-										 pData, m_RData, m_Gain);
+	NumResamples = m_OutResampler.Resample(numsamples,
+						TEST_ERROR*m_OutRatio *(1.0 + 1.0e-9*m_RateCorrectionPpb.loadAcquire()),
+						pData, m_RData, m_Gain);
 
 g_pTestBench->DisplayData(NumResamples, 1.0, m_RData, SOUNDCARD_RATE, PROFILE_5);
 
-	m_Mutex.lock();
-	for( int i=0; i<NumResamples; i++)
-	{
-		m_OutQueueStereo[m_OutQHead++] = m_RData[i];
-		if(m_OutQHead >= OUTQSIZE)
-			m_OutQHead = 0;
-		m_OutQLevel++;
-		if(m_OutQHead==m_OutQTail)	//if full
-		{	//remove 1/2 a queue's worth of data
-			m_OutQLevel = OUTQSIZE/2;
-			m_AveOutQLevel = m_OutQLevel;
-			m_OutQTail += (OUTQSIZE/2);
-			if(m_OutQTail >= OUTQSIZE)
-				m_OutQTail = m_OutQTail - OUTQSIZE;
-			m_AveOutQLevel = m_OutQLevel;
-			qDebug()<<"Snd Overflow";
-			g_pTestBench->SendDebugTxt("Snd Overflow");
-			i = numsamples;		//force break out of for loop
-		}
-	}
-	//calculate average Queue fill level
-	m_AveOutQLevel = (1.0-FILTERQLEVEL_ALPHA)*m_AveOutQLevel + FILTERQLEVEL_ALPHA*(TYPEREAL)m_OutQLevel;
-	m_Mutex.unlock();
+	if( m_NumSinks.loadAcquire() )
+		WriteSinks((qint16*)m_RData, NumResamples, 2);
+	if(m_Headless)
+		return NumResamples;
+	if( m_OutQueueStereo.Put(m_RData, NumResamples) < NumResamples )
+		QueueOverflow();	//samples that did not fit are thrown away
+	else
+		CheckQueueLevel(m_OutQueueStereo.Level());
 	return NumResamples;
 }
 
@@ -303,112 +388,271 @@ int NumResamples;
 		return 0;
 
 	//Call Resampler to match sample rates between radio and sound card
-	NumResamples = m_OutResampler.Resample(numsamples, TEST_ERROR*m_OutRatio *(1.0+m_RateCorrection),
-										 pData, (TYPEMONO16*)m_RData, m_Gain);
+	NumResamples = m_OutResampler.Resample(numsamples,
+						TEST_ERROR*m_OutRatio *(1.0 + 1.0e-9*m_RateCorrectionPpb.loadAcquire()),
+						pData, (TYPEMONO16*)m_RData, m_Gain);
 
 g_pTestBench->DisplayData(NumResamples, 1.0, (TYPEMONO16*)m_RData, SOUNDCARD_RATE, PROFILE_5);
 
-	m_Mutex.lock();
-	for( int i=0; i<NumResamples; i++)
+	if( m_NumSinks.loadAcquire() )
+		WriteSinks((qint16*)m_RData, NumResamples, 1);
+	if(m_Headless)
+		return NumResamples;
+	if( m_OutQueueMono.Put((TYPEMONO16*)m_RData, NumResamples) < NumResamples )
+		QueueOverflow();	//samples that did not fit are thrown away
+	else
+		CheckQueueLevel(m_OutQueueMono.Level());
+	return NumResamples;
+}
+
+////////////////////////////////////////////////////////////////
+//Called by application in place of PutOutQueue() when a block of
+//numsamples input samples is all silence. Queues the same number of
+//zero soundcard samples without running the resampler.
+// Returns number of samples sent to sound card
+////////////////////////////////////////////////////////////////
+int CSoundOut::PutSilence(int numsamples, bool Stereo)
+{
+	if( 0==numsamples )
+		return 0;
+	m_SilenceTime += numsamples/(TEST_ERROR*m_OutRatio *(1.0 + 1.0e-9*m_RateCorrectionPpb.loadAcquire()));
+	int NumResamples = (int)m_SilenceTime;
+	m_SilenceTime -= NumResamples;
+	if(NumResamples > OUTQSIZE)
+		NumResamples = OUTQSIZE;
+	if(Stereo)
+		memset(m_RData, 0, NumResamples*sizeof(TYPESTEREO16));
+	else
+		memset(m_RData, 0, NumResamples*sizeof(TYPEMONO16));
+
+	if( m_NumSinks.loadAcquire() )
+		WriteSinks((qint16*)m_RData, NumResamples, Stereo ? 2 : 1);
+	if(m_Headless)
+		return NumResamples;
+	int n;
+	int Level;
+	if(Stereo)
+	{
+		n = m_OutQueueStereo.Put(m_RData, NumResamples);
+		Level = m_OutQueueStereo.Level();
+	}
+	else
+	{
+		n = m_OutQueueMono.Put((TYPEMONO16*)m_RData, NumResamples);
+		Level = m_OutQueueMono.Level();
+	}
+	if(n < NumResamples)
+		QueueOverflow();
+	else
+		CheckQueueLevel(Level);
+	return NumResamples;
+}
+
+////////////////////////////////////////////////////////////////
+//Called by the Put routines to send the resampled data in m_RData
+//to all the audio sinks.
+////////////////////////////////////////////////////////////////
+void CSoundOut::WriteSinks(const qint16* pData, int NumFrames, int Channels)
+{
+	m_SinkMutex.lock();
+	for(int i=0; i<MAX_AUDIO_SINKS; i++)
+	{
+		if(m_pSinks[i])
+			m_pSinks[i]->Write(pData, NumFrames, Channels, SOUNDCARD_RATE);
+	}
+	m_SinkMutex.unlock();
+}
+
+////////////////////////////////////////////////////////////////
+//Adds an audio sink. CSoundOut deletes it in DeleteSinks().
+// Returns false if there is no room for it.
+////////////////////////////////////////////////////////////////
+bool CSoundOut::AddSink(CAudioSink* pSink)
+{
+bool ret = false;
+	m_SinkMutex.lock();
+	for(int i=0; i<MAX_AUDIO_SINKS; i++)
+	{
+		if(NULL == m_pSinks[i])
+		{
+			m_pSinks[i] = pSink;
+			m_NumSinks.fetchAndAddRelease(1);
+			ret = true;
+			break;
+		}
+	}
+	m_SinkMutex.unlock();
+	return ret;
+}
+
+////////////////////////////////////////////////////////////////
+//Closes and deletes all the audio sinks
+////////////////////////////////////////////////////////////////
+void CSoundOut::DeleteSinks()
+{
+	m_SinkMutex.lock();
+	for(int i=0; i<MAX_AUDIO_SINKS; i++)
+	{
+		if(m_pSinks[i])
+		{
+			delete m_pSinks[i];
+			m_pSinks[i] = NULL;
+		}
+	}
+	m_NumSinks.storeRelease(0);
+	m_SinkMutex.unlock();
+}
+
+////////////////////////////////////////////////////////////////
+//Replaces all the audio sinks with ones created from Specs
+// Returns number of sinks created
+////////////////////////////////////////////////////////////////
+int CSoundOut::SetSinks(const QStringList& Specs)
+{
+int n = 0;
+	DeleteSinks();
+	for(int i=0; i<Specs.size(); i++)
 	{
-		m_OutQueueMono[m_OutQHead++] = ((TYPEMONO16*)m_RData)[i];
-		if(m_OutQHead >= OUTQSIZE)
-			m_OutQHead = 0;
-		m_OutQLevel++;
-		if(m_OutQHead==m_OutQTail)	//if full
-		{	//remove 1/2 a queue's worth of data
-			m_OutQLevel = OUTQSIZE/2;
-			m_AveOutQLevel = m_OutQLevel;
-			m_OutQTail += (OUTQSIZE/2);
-			if(m_OutQTail >= OUTQSIZE)
-				m_OutQTail = m_OutQTail - OUTQSIZE;
-			m_AveOutQLevel = m_OutQLevel;
-			qDebug()<<"Snd Overflow";
-			g_pTestBench->SendDebugTxt("Snd Overflow");
-			i = numsamples;		//force break out of for loop
+		CAudioSink* pSink = CAudioSink::Create(Specs[i]);
+		if(!pSink)
+		{
+			qDebug()<<"Invalid audio sink "<<Specs[i];
+			continue;
 		}
+		if(AddSink(pSink))
+			n++;
+		else
+			delete pSink;
+	}
+	return n;
+}
+
+////////////////////////////////////////////////////////////////
+//Called by the Put routines when the queue is full.
+// Since only the soundcard thread may move the queue tail it is
+//asked to throw away a half queue's worth of old data.
+////////////////////////////////////////////////////////////////
+void CSoundOut::QueueOverflow()
+{
+	if( m_DropRequest.testAndSetRelease(0, OUTQSIZE/2) )
+	{
+		m_OverrunCount.fetchAndAddRelaxed(1);
+		qDebug()<<"Snd Overflow";
+		g_pTestBench->SendDebugTxt("Snd Overflow");
 	}
+}
+
+////////////////////////////////////////////////////////////////
+//Called by the Put routines with the queue level after the put.
+// In low latency mode asks the soundcard thread to throw away the
+//data above the target level if the queue has grown past MaxLevel.
+// Runs on the DSP thread so it uses the m_DspLimits copy of the limits.
+////////////////////////////////////////////////////////////////
+void CSoundOut::CheckQueueLevel(int Level)
+{
+	m_DspLimits.Update();
+	const tQUEUE_LIMITS& Limits = m_DspLimits.Get();
+	if( Limits.LowLatency && (Level > Limits.MaxLevel) )
+	{
+		if( m_DropRequest.testAndSetRelease(0, Level - Limits.TargetLevel) )
+			m_OverrunCount.fetchAndAddRelaxed(1);
+	}
+}
+
+////////////////////////////////////////////////////////////////
+//Called by the Get routines before reading the queue to act on
+//requests from the other threads.  Returns the queue level.
+////////////////////////////////////////////////////////////////
+template <class T>
+int CSoundOut::ServiceRequests(CSpscRing<T, OUTQSIZE>& Queue)
+{
+	if( m_FlushRequest.fetchAndStoreAcquire(0) )
+	{	//user data rate changed so start over
+		Queue.Skip(Queue.Capacity());
+		m_AveOutQLevel = m_TargetLevel;
+		m_ErrorIntegral = 0.0;
+		m_RateCorrection = 0.0;
+		m_Startup = true;
+	}
+	int drop = m_DropRequest.fetchAndStoreAcquire(0);
+	if(drop)
+		Queue.Skip(drop);
+	return Queue.Level();
+}
+
+////////////////////////////////////////////////////////////////
+//Called by the Get routines after reading the queue to update the
+// average level and the rate error.
+////////////////////////////////////////////////////////////////
+void CSoundOut::UpdateQueueStats(int numsamples, int Level)
+{
 	//calculate average Queue fill level
-	m_AveOutQLevel = (1.0-FILTERQLEVEL_ALPHA)*m_AveOutQLevel + FILTERQLEVEL_ALPHA*(TYPEREAL)m_OutQLevel;
-	m_Mutex.unlock();
-	return NumResamples;
+	m_AveOutQLevel = (1.0-m_QLevelAlpha)*m_AveOutQLevel + m_QLevelAlpha*(TYPEREAL)Level;
+
+	// See if time to update rate error calculation routine
+	m_RateUpdateCount += numsamples;
+	if(m_RateUpdateCount >= m_RateUpdateInterval)
+	{
+		CalcError();
+		m_RateUpdateCount = 0;
+	}
 }
 
 ////////////////////////////////////////////////////////////////
 //Called by CSoundOut worker thread to get new samples from queue
 // This routine is called from a worker thread so must be careful.
+// If the queue runs empty silence is output until the queue refills
+//to the target level.
 //   MONO version
 ////////////////////////////////////////////////////////////////
 void CSoundOut::GetOutQueue(int numsamples, TYPEMONO16* pData )
 {
 int i;
-	m_Mutex.lock();
+int level = ServiceRequests(m_OutQueueMono);
 	if(m_Startup)
 	{	//if no data in queue yet just stuff in silence until something is put in queue
 		for( i=0; i<numsamples; i++)
 			pData[i] = 0;
-		if(m_OutQLevel>OUTQSIZE/2)
+		if(level>m_TargetLevel)
 		{
 			m_Startup = false;
-			m_RateUpdateCount = -5*SOUNDCARD_RATE;	//delay first error update to let settle
-			m_PpmError = 0;
-			m_AveOutQLevel = m_OutQLevel;
+			if(m_LowLatency)
+				m_RateUpdateCount = 0;	//keep controller running after an underflow
+			else
+				m_RateUpdateCount = -5*SOUNDCARD_RATE;	//delay first error update to let settle
+			m_AveOutQLevel = level;
 			m_UpdateToggle = true;
-			}
+		}
 		else
 		{
-			m_Mutex.unlock();
 			return;
 		}
 	}
 
-	for( i=0; i<numsamples; i++)
-	{
-		if(m_OutQHead!=m_OutQTail)
-		{
-			pData[i] = m_OutQueueMono[m_OutQTail++];
-			if(m_OutQTail >= OUTQSIZE)
-				m_OutQTail = 0;
-			if(m_OutQLevel>0)
-				m_OutQLevel--;
-		}
-		else	//queue went empty
-		{	//backup queue ptr and use previous data in queue
-			m_OutQTail -= (OUTQSIZE/2);
-			if(m_OutQTail < 0)
-				m_OutQTail = m_OutQTail + OUTQSIZE;
-			pData[i] = m_OutQueueMono[m_OutQTail];
-			if(m_OutQTail >= OUTQSIZE)
-				m_OutQTail = 0;
-			m_OutQLevel = OUTQSIZE/2;
-			m_AveOutQLevel = m_OutQLevel;
-			qDebug()<<"Snd Underflow";
-			g_pTestBench->SendDebugTxt("Snd Underflow");
-		}
-	}
-
-	//calculate average Queue fill level
-	m_AveOutQLevel = (1.0-FILTERQLEVEL_ALPHA)*m_AveOutQLevel + FILTERQLEVEL_ALPHA*m_OutQLevel;
-
-	// See if time to update rate error calculation routine
-	m_RateUpdateCount += numsamples;
-	if(m_RateUpdateCount >= SOUNDCARD_RATE)	//every second
-	{
-		CalcError();
-		m_RateUpdateCount = 0;
+	i = m_OutQueueMono.Get(pData, numsamples);
+	if(i < numsamples)
+	{	//queue went empty so output silence and wait for queue to refill
+		for( ; i<numsamples; i++)
+			pData[i] = 0;
+		m_Startup = true;
+		m_UnderrunCount.fetchAndAddRelaxed(1);
+		qDebug()<<"Snd Underflow";
+		g_pTestBench->SendDebugTxt("Snd Underflow");
 	}
-	m_Mutex.unlock();
+	UpdateQueueStats(numsamples, m_OutQueueMono.Level());
 }
 
 ////////////////////////////////////////////////////////////////
 //Called by CSoundOut worker thread to get new samples from queue
 // This routine is called from a worker thread so must be careful.
+// If the queue runs empty silence is output until the queue refills
+//to the target level.
 //   STEREO version
 ////////////////////////////////////////////////////////////////
 void CSoundOut::GetOutQueue(int numsamples, TYPESTEREO16* pData )
 {
 int i;
-	m_Mutex.lock();
+int level = ServiceRequests(m_OutQueueStereo);
 	if(m_Startup)
 	{	//if no data in queue yet just stuff in silence until something is put in queue
 		for( i=0; i<numsamples; i++)
@@ -416,56 +660,36 @@ int i;
 			pData[i].re = 0;
 			pData[i].im = 0;
 		}
-		if(m_OutQLevel>OUTQSIZE/2)
+		if(level>m_TargetLevel)
 		{
 			m_Startup = false;
-			m_RateUpdateCount = -5*SOUNDCARD_RATE;	//delay first error update to let settle
-			m_PpmError = 0;
-			m_AveOutQLevel = m_OutQLevel;
+			if(m_LowLatency)
+				m_RateUpdateCount = 0;	//keep controller running after an underflow
+			else
+				m_RateUpdateCount = -5*SOUNDCARD_RATE;	//delay first error update to let settle
+			m_AveOutQLevel = level;
 			m_UpdateToggle = true;
-			}
+		}
 		else
 		{
-			m_Mutex.unlock();
 			return;
 		}
 	}
 
-	for( i=0; i<numsamples; i++)
-	{
-		if(m_OutQHead!=m_OutQTail)
+	i = m_OutQueueStereo.Get(pData, numsamples);
+	if(i < numsamples)
+	{	//queue went empty so output silence and wait for queue to refill
+		for( ; i<numsamples; i++)
 		{
-			pData[i] = m_OutQueueStereo[m_OutQTail++];
-			if(m_OutQTail >= OUTQSIZE)
-				m_OutQTail = 0;
-			if(m_OutQLevel>0)
-				m_OutQLevel--;
-		}
-		else	//queue went empty
-		{	//backup queue ptr and use previous data in queue
-			m_OutQTail -= (OUTQSIZE/2);
-			if(m_OutQTail < 0)
-				m_OutQTail = m_OutQTail + OUTQSIZE;
-			pData[i] = m_OutQueueStereo[m_OutQTail++];
-			if(m_OutQTail >= OUTQSIZE)
-				m_OutQTail = 0;
-			m_OutQLevel = OUTQSIZE/2;
-			m_AveOutQLevel = m_OutQLevel;
-			qDebug()<<"Snd Underflow";
-			g_pTestBench->SendDebugTxt("Snd Underflow");
+			pData[i].re = 0;
+			pData[i].im = 0;
 		}
+		m_Startup = true;
+		m_UnderrunCount.fetchAndAddRelaxed(1);
+		qDebug()<<"Snd Underflow";
+		g_pTestBench->SendDebugTxt("Snd Underflow");
 	}
-	//calculate average Queue fill level
-	m_AveOutQLevel = (1.0-FILTERQLEVEL_ALPHA)*m_AveOutQLevel + FILTERQLEVEL_ALPHA*m_OutQLevel;
-
-	// See if time to update rate error calculation routine
-	m_RateUpdateCount += numsamples;
-	if(m_RateUpdateCount >= SOUNDCARD_RATE)	//every second
-	{
-		CalcError();
-		m_RateUpdateCount = 0;
-	}
-	m_Mutex.unlock();
+	UpdateQueueStats(numsamples, m_OutQueueStereo.Level());
 }
 
 ////////////////////////////////////////////////////////////////
@@ -475,13 +699,31 @@ int i;
 void CSoundOut::CalcError()
 {
 TYPEREAL error;
-	error = (TYPEREAL)(m_AveOutQLevel - OUTQSIZE/2 );	//neg==level is too low  pos == level is to high
-	error = error * P_GAIN;
+	error = (TYPEREAL)(m_AveOutQLevel - m_TargetLevel );	//neg==level is too low  pos == level is to high
+	if(m_LowLatency)
+	{	//PI controller, integrator tracks the clock offset between the two domains
+		m_ErrorIntegral += error*(TYPEREAL)m_RateUpdateInterval/(TYPEREAL)SOUNDCARD_RATE;
+		TYPEREAL limit = LL_INTEGRAL_TIME*LL_MAX_CORRECTION/LL_P_GAIN;
+		if(m_ErrorIntegral > limit)
+			m_ErrorIntegral = limit;
+		if(m_ErrorIntegral < -limit)
+			m_ErrorIntegral = -limit;
+		error = LL_P_GAIN*( error + m_ErrorIntegral/LL_INTEGRAL_TIME );
+		if(error > LL_MAX_CORRECTION)
+			error = LL_MAX_CORRECTION;
+		if(error < -LL_MAX_CORRECTION)
+			error = -LL_MAX_CORRECTION;
+	}
+	else
+	{
+		error = error * P_GAIN;
+	}
 	m_RateCorrection = error;
-	m_PpmError = (int)( m_RateCorrection*1e6 );
-	if( abs(m_PpmError) > 500)
+	m_RateCorrectionPpb.storeRelease( (int)(m_RateCorrection*1e9) );
+	m_PpmError.storeRelease( (int)( m_RateCorrection*1e6 ) );
+	if( abs(m_PpmError.load()) > 500)
 	{
-//		qDebug()<<"SoundOut "<<m_PpmError << m_AveOutQLevel;
+//		qDebug()<<"SoundOut "<<m_PpmError.load() << m_AveOutQLevel;
 //		g_pTestBench->SendDebugTxt("Snd error>500ppm");
 	}
 }
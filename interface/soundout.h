@@ -4,6 +4,12 @@
 // History:
 //	2010-09-15  Initial creation MSW
 //	2013-01-31  Changed Threading method, removed blocking mode
+//	2026-10-18  Added low latency mode and underrun/overrun counters
+//	2026-10-18  Replaced mutex protected output queue with lock free ring
+//	2026-10-18  Added audio sinks and headless operation
+//	2026-10-18  Added PutSilence() for squelch gated channels
+//	2026-10-18  Latency target is applied on the soundcard thread by Start()
+//	2026-10-18  DSP thread reads the queue limits from a snapshot
 /////////////////////////////////////////////////////////////////////
 //==========================================================================================
 // + + +   This Software is released under the "Simplified BSD License"  + + +
@@ -41,9 +47,22 @@
 #include <QIODevice>
 #include <QAudioOutput>
 #include "dsp/fractresampler.h"
+#include "interface/spscring.h"
+#include "interface/audiosink.h"
+#include "dsp/paramsnapshot.h"
+#include <QStringList>
 
 #define OUTQSIZE 20000	//max samples
 #define SOUND_WRITEBUFSIZE (OUTQSIZE/2)
+#define MAX_AUDIO_SINKS 8
+
+//queue limits the DSP thread checks after each put
+typedef struct _sqlimits
+{
+	bool LowLatency;
+	int TargetLevel;
+	int MaxLevel;
+}tQUEUE_LIMITS;
 
 class CSoundOut : public CThreadWrapper		//subclass a general purpose thread class
 {
@@ -53,15 +72,23 @@ public:
 	virtual ~CSoundOut();
 
 	//Exposed functions
+	//OutDevIndx < 0 runs without a sound device(audio only goes to the sinks)
     void Start(int OutDevIndx, bool StereoOut, double UsrDataRate)
 					{emit StartSig(OutDevIndx, StereoOut, UsrDataRate);}
 	void Stop(){emit StopSig();}	//stops soundcard output
 
 	int PutOutQueue(int numsamples, TYPEREAL* pData );
 	int PutOutQueue(int numsamples, TYPECPX* pData );
+	int PutSilence(int numsamples, bool Stereo);
 	void ChangeUserDataRate(TYPEREAL UsrDataRate);
 	void SetVolume(qint32 vol);
-	int GetRateError(){return (int)m_PpmError;}
+	void SetLatencyTarget(int TargetMs);	//0 = robust mode, takes effect on next Start()
+	int GetRateError(){return m_PpmError.loadAcquire();}
+	int GetUnderrunCount(){return m_UnderrunCount.loadAcquire();}
+	int GetOverrunCount(){return m_OverrunCount.loadAcquire();}
+	bool AddSink(CAudioSink* pSink);	//CSoundOut takes ownership of pSink
+	int SetSinks(const QStringList& Specs);	//replaces all sinks, see CAudioSink::Create()
+	void DeleteSinks();
 
 	TYPESTEREO16 m_RData[OUTQSIZE];	//exposed buffer holding 48ksps resampled data
 
@@ -82,24 +109,47 @@ private:
 	void GetOutQueue(int numsamples, TYPEMONO16* pData );
 	void GetOutQueue(int numsamples, TYPESTEREO16* pData );
 	void CalcError();
+	void ApplyLatencyTarget();
+	void QueueOverflow();
+	void CheckQueueLevel(int Level);
+	template <class T> int ServiceRequests(CSpscRing<T, OUTQSIZE>& Queue);
+	void UpdateQueueStats(int numsamples, int Level);
+	void WriteSinks(const qint16* pData, int NumFrames, int Channels);
 
 	bool m_Startup;
 	bool m_StereoOut;
 	bool m_UpdateToggle;
-	int m_OutQHead;
-	int m_OutQTail;
+	bool m_LowLatency;
+	bool m_Headless;
 	int m_RateUpdateCount;
-	int m_OutQLevel;
-	int m_PpmError;
+	int m_TargetMs;
+	int m_TargetLevel;		//queue level the rate controller steers to
+	int m_MaxLevel;			//queue level above which data is thrown away
+	CParamSnapshot<tQUEUE_LIMITS> m_DspLimits;	//copy of the three above for the DSP thread
+	int m_RateUpdateInterval;
+	//shared between the DSP(producer) and soundcard(consumer) threads
+	QAtomicInt m_PpmError;
+	QAtomicInt m_UnderrunCount;
+	QAtomicInt m_OverrunCount;
+	QAtomicInt m_RateCorrectionPpb;	//rate correction in parts per billion
+	QAtomicInt m_DropRequest;		//number of old samples the consumer should throw away
+	QAtomicInt m_FlushRequest;		//consumer should empty queue and restart
+	QAtomicInt m_PendingTargetMs;	//latency target for the next Start()
+	QAtomicInt m_NumSinks;
+	QMutex m_SinkMutex;				//only taken on the DSP thread when sinks exist
+	CAudioSink* m_pSinks[MAX_AUDIO_SINKS];
 	TYPEREAL m_Gain;
 	TYPEREAL m_UserDataRate;
 	TYPEREAL m_OutRatio;
+	TYPEREAL m_SilenceTime;		//fraction of an output sample left by PutSilence()
 	TYPEREAL m_RateCorrection;
 	TYPEREAL m_AveOutQLevel;
+	TYPEREAL m_QLevelAlpha;
+	TYPEREAL m_ErrorIntegral;
 
 	char m_pData[SOUND_WRITEBUFSIZE];
-	TYPEMONO16 m_OutQueueMono[OUTQSIZE];
-	TYPESTEREO16 m_OutQueueStereo[OUTQSIZE];
+	CSpscRing<TYPEMONO16, OUTQSIZE> m_OutQueueMono;
+	CSpscRing<TYPESTEREO16, OUTQSIZE> m_OutQueueStereo;
 
 	QList<QAudioDeviceInfo> m_OutDevices;
 	QAudioDeviceInfo  m_OutDeviceInfo;
@@ -0,0 +1,132 @@
+/////////////////////////////////////////////////////////////////////
+// spscring.h  CSpscRing template class.
+//This class implements a wait free single producer single consumer ring
+//buffer for passing blocks of samples between two threads.
+// Only the producer thread may call Put(), only the consumer thread may call
+//Get() and Skip().  The head index is written only by the producer and the
+//tail index only by the consumer so no lock is needed.  One slot is always
+//left empty to tell a full ring from an empty one.
+// History:
+//	2026-10-18  Initial creation
+/////////////////////////////////////////////////////////////////////
+//==========================================================================================
+// + + +   This Software is released under the "Simplified BSD License"  + + +
+//Copyright 2013 Moe Wheatley. All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without modification, are
+//permitted provided that the following conditions are met:
+//
+//   1. Redistributions of source code must retain the above copyright notice, this list of
+//	  conditions and the following disclaimer.
+//
+//   2. Redistributions in binary form must reproduce the above copyright notice, this list
+//	  of conditions and the following disclaimer in the documentation and/or other materials
+//	  provided with the distribution.
+//
+//THIS SOFTWARE IS PROVIDED BY Moe Wheatley ``AS IS'' AND ANY EXPRESS OR IMPLIED
+//WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+//FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Moe Wheatley OR
+//CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+//ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+//ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+#ifndef SPSCRING_H
+#define SPSCRING_H
+
+#include <QAtomicInt>
+#include <string.h>
+
+template <class T, int SIZE>
+class CSpscRing
+{
+public:
+	CSpscRing(){m_Head = 0; m_Tail = 0;}
+
+	//number of samples available to the consumer
+	int Level() const
+	{
+		int level = m_Head.loadAcquire() - m_Tail.loadAcquire();
+		return (level < 0) ? (level + SIZE) : level;
+	}
+	//number of samples the producer can put without overwriting
+	int Free() const {return SIZE - 1 - Level();}
+	int Capacity() const {return SIZE - 1;}
+
+	//Producer: copies up to n samples from pData into the ring.
+	// Returns the number of samples copied.
+	int Put(const T* pData, int n)
+	{
+		int head = m_Head.load();
+		int tail = m_Tail.loadAcquire();
+		int free = tail - head - 1;
+		if(free < 0)
+			free += SIZE;
+		if(n > free)
+			n = free;
+		int first = SIZE - head;	//samples before wrap
+		if(first > n)
+			first = n;
+		memcpy(&m_Buf[head], pData, first*sizeof(T));
+		if(n > first)
+			memcpy(&m_Buf[0], pData + first, (n - first)*sizeof(T));
+		head += n;
+		if(head >= SIZE)
+			head -= SIZE;
+		m_Head.storeRelease(head);
+		return n;
+	}
+
+	//Consumer: copies up to n samples from the ring into pData.
+	// Returns the number of samples copied.
+	int Get(T* pData, int n)
+	{
+		int tail = m_Tail.load();
+		int level = m_Head.loadAcquire() - tail;
+		if(level < 0)
+			level += SIZE;
+		if(n > level)
+			n = level;
+		int first = SIZE - tail;
+		if(first > n)
+			first = n;
+		memcpy(pData, &m_Buf[tail], first*sizeof(T));
+		if(n > first)
+			memcpy(pData + first, &m_Buf[0], (n - first)*sizeof(T));
+		tail += n;
+		if(tail >= SIZE)
+			tail -= SIZE;
+		m_Tail.storeRelease(tail);
+		return n;
+	}
+
+	//Consumer: throws away up to n of the oldest samples.
+	// Returns the number of samples thrown away.
+	int Skip(int n)
+	{
+		int tail = m_Tail.load();
+		int level = m_Head.loadAcquire() - tail;
+		if(level < 0)
+			level += SIZE;
+		if(n > level)
+			n = level;
+		tail += n;
+		if(tail >= SIZE)
+			tail -= SIZE;
+		m_Tail.storeRelease(tail);
+		return n;
+	}
+
+	//empties the ring. Only call when neither thread is using it.
+	void Reset(){m_Head.storeRelease(0); m_Tail.storeRelease(0);}
+
+private:
+	QAtomicInt m_Head;		//next position to write, owned by producer
+	char m_Pad[64];			//keep the two indexes on separate cache lines
+	QAtomicInt m_Tail;		//next position to read, owned by consumer
+	T m_Buf[SIZE];
+};
+
+#endif // SPSCRING_H
@@ -207,6 +207,19 @@ void CWaveFileReader::ResetToBeginning(void)
 	}
 }
 
+/////////////////////////////////////////////////////////////////////////
+/// \brief CWaveFileReader::SeekToSample
+/// \param SamplePos  sample index from the start of the data chunk
+/// \return true if the file pointer was moved
+/////////////////////////////////////////////////////////////////////////
+bool CWaveFileReader::SeekToSample(qint64 SamplePos)
+{
+	if( !isOpen() || (SamplePos < 0) || (SamplePos > m_NumSamples) )
+		return false;
+	qint64 BytesPerSample = (m_FmtSubChunk.bitsPerSample*m_FmtSubChunk.numChannels)/8;
+	return seek(m_DataStartPosition + SamplePos*BytesPerSample);
+}
+
 /////////////////////////////////////////////////////////////////////////
 /// \brief CWaveFileReader::GetNextDataBlock
 /// \param pData   pointer to callers complex float data buffer
@@ -260,7 +273,7 @@ int j = -1;
 			qint64 bytesread = read((char*)m_DataBuffer, ByteLength);
 			if(bytesread <= 0)
 				return 0;
-			for( int i=0,j=0; i<bytesread; i+=4,j++)
+			for( i=0,j=0; i<bytesread; i+=4,j++)
 			{
 				TYPECPX cpxtmp;
 				data.bytes.b0 = m_DataBuffer[i];		//combine 3 bytes into 32 bit signed int
@@ -56,6 +56,7 @@ public:
 	quint32 GetSampleRate(){return m_FmtSubChunk.sampleRate;}
 	quint32 GetNumberSamples(){return m_NumSamples;}
 	void ResetToBeginning(void);
+	bool SeekToSample(qint64 SamplePos);
 
 	QString m_FileInfoStr;
 